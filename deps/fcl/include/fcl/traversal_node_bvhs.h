@@ -239,7 +239,7 @@ public:
         for(int i = 0; i < n_contacts; ++i)
         {
           if((!exhaustive) && (num_max_contacts <= (int)pairs.size())) break;
-          pairs.push_back(BVHCollisionPair(primitive_id1, primitive_id2, contacts[i], normal, penetration));
+          pairs.push_back(BVHCollisionPair(primitive_id1, primitive_id2, normal, contacts[i], penetration));
         }
       }
     }
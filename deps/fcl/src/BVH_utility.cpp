@@ -36,7 +36,12 @@
 
 
 #include "fcl/BVH_utility.h"
+#if USE_ANN
 #include <ann/ANN.h>
+#else
+#include <algorithm>
+#include <utility>
+#endif
 
 namespace fcl
 {
@@ -104,6 +109,7 @@ void BVHExpand(BVHModel<RSS>& model, const Uncertainty* ucs, BVH_REAL r = 1.0)
 }
 
 
+#if USE_ANN
 void estimateSamplingUncertainty(Vec3f* vertices, int num_vertices, Uncertainty* ucs)
 {
   int nPts = num_vertices;
@@ -189,6 +195,64 @@ void estimateSamplingUncertainty(Vec3f* vertices, int num_vertices, Uncertainty*
   delete kdTree;
   annClose();
 }
+#else
+void estimateSamplingUncertainty(Vec3f* vertices, int num_vertices, Uncertainty* ucs)
+{
+  // Brute force k nearest neighbors, used when ANN is not available
+  int nPts = num_vertices;
+  int knn_k = 10;
+  if(knn_k > nPts) knn_k = nPts;
+
+  std::vector<std::pair<double, int> > neighbors(nPts);
+  double scale = 2;
+
+  for(int i = 0; i < nPts; ++i)
+  {
+    for(int j = 0; j < nPts; ++j)
+      neighbors[j] = std::make_pair((vertices[i] - vertices[j]).sqrLength(), j);
+    std::partial_sort(neighbors.begin(), neighbors.begin() + knn_k, neighbors.end());
+
+    float C[3][3];
+    for(int j = 0; j < 3; ++j)
+    {
+      for(int k = 0; k < 3; ++k)
+        C[j][k] = 0;
+    }
+
+    double r = sqrt(neighbors[knn_k - 1].first);
+    double sigma = scale * r;
+
+    double weight_sum = 0;
+    for(int j = 1; j < knn_k; ++j)
+    {
+      int id = neighbors[j].second;
+      Vec3f p = vertices[i] - vertices[id];
+      double norm2p = p.sqrLength();
+      double weight = exp(-norm2p / (sigma * sigma));
+
+      weight_sum += weight;
+
+      for(int k = 0; k < 3; ++k)
+      {
+        for(int l = 0; l < 3; ++l)
+          C[k][l] += p[k] * p[l] * weight;
+      }
+    }
+
+    for(int j = 0; j < 3; ++j)
+    {
+      for(int k = 0; k < 3; ++k)
+      {
+        C[j][k] /= weight_sum;
+        ucs[i].Sigma[j][k] = C[j][k];
+      }
+    }
+
+    ucs[i].preprocess();
+    ucs[i].sqrt();
+  }
+}
+#endif
 
 /** \brief Compute the covariance matrix for a set or subset of points. */
 void getCovariance(Vec3f* ps, Vec3f* ps2, unsigned int* indices, int n, Vec3f M[3])
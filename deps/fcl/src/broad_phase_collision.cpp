@@ -378,13 +378,11 @@ void SaPCollisionManager::unregisterObject(CollisionObject* obj)
       break;
   }
 
-  AABB_arr.erase(it);
-
   if(it == AABB_arr.end())
     return;
 
   SaPAABB* curr = *it;
-  *it = NULL;
+  AABB_arr.erase(it);
 
   for(int coord = 0; coord < 3; ++coord)
   {
@@ -98,7 +98,7 @@ void MeshCollisionTraversalNodeOBB::leafTesting(int b1, int b2) const
       for(int i = 0; i < n_contacts; ++i)
       {
         if((!exhaustive) && (num_max_contacts <= (int)pairs.size())) break;
-        pairs.push_back(BVHCollisionPair(primitive_id1, primitive_id2, contacts[i], normal, penetration));
+        pairs.push_back(BVHCollisionPair(primitive_id1, primitive_id2, normal, contacts[i], penetration));
       }
     }
   }
@@ -163,7 +163,7 @@ void MeshCollisionTraversalNodeRSS::leafTesting(int b1, int b2) const
       for(int i = 0; i < n_contacts; ++i)
       {
         if((!exhaustive) && (num_max_contacts <= (int)pairs.size())) break;
-        pairs.push_back(BVHCollisionPair(primitive_id1, primitive_id2, contacts[i], normal, penetration));
+        pairs.push_back(BVHCollisionPair(primitive_id1, primitive_id2, normal, contacts[i], penetration));
       }
     }
   }
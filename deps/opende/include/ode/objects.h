@@ -93,6 +93,30 @@ ODE_API void dWorldSetIslandThreads (dWorldID, int num_island_threads);
  */
 ODE_API void dWorldSetQuickStepThreads (dWorldID, int num_quickstep_threads);
 
+/**
+ * @brief Solve quickstep constraint rows in graph colored batches.
+ *
+ * Rows are greedily colored so no two rows of a color act on the same
+ * body. The rows of a color are split between the threads, and the
+ * threads wait for each other before the next color. The result doesn't
+ * depend on the number of threads, and is the same on every run.
+ *
+ * This replaces the quickstep thread pool, with num_threads - 1 pool
+ * threads plus the calling thread.
+ *
+ * @param num_threads Number of threads solving the rows. 0 uses the
+ * default chunked solver.
+ * @ingroup world
+ */
+ODE_API void dWorldSetQuickStepColoredThreads (dWorldID, int num_threads);
+
+/**
+ * @brief Get the number of threads solving graph colored rows.
+ * @returns 0 if the default chunked solver is used.
+ * @ingroup world
+ */
+ODE_API int dWorldGetQuickStepColoredThreads (dWorldID);
+
 /**
  * @brief Get the gravity vector for a given world.
  * @ingroup world
@@ -101,6 +101,7 @@ struct dxQuickStepParameters {
   dReal w;			// the SOR over-relaxation parameter
   int num_chunks;		// divide rows to these many chunks
   int num_overlap;		// divide rows but over lap this many rows
+  int num_threads;		// solve graph colored rows with these many threads (0 for chunks)
   dReal sor_lcp_tolerance;	// the stop if rms_error falls below this
   dReal rms_error;      	// rms_error for this time step
 };
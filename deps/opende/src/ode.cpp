@@ -1657,6 +1657,7 @@ dxWorld * dWorldCreate()
   w->qs.w = REAL(1.3);
   w->qs.num_chunks = 1;
   w->qs.num_overlap = 0;
+  w->qs.num_threads = 0;
   w->qs.sor_lcp_tolerance = 0;
 
   w->contactp.max_vel = dInfinity;
@@ -1784,6 +1785,20 @@ void dWorldSetQuickStepThreads (dWorldID w, int num_quickstep_threads)
   }
 }
 
+void dWorldSetQuickStepColoredThreads (dWorldID w, int num_threads)
+{
+  dAASSERT (w);
+  w->qs.num_threads = num_threads > 0 ? num_threads : 0;
+  // the calling thread solves its share of the rows too
+  dWorldSetQuickStepThreads (w, num_threads - 1);
+}
+
+int dWorldGetQuickStepColoredThreads (dWorldID w)
+{
+  dAASSERT (w);
+  return w->qs.num_threads;
+}
+
 void dWorldGetGravity (dWorldID w, dVector3 g)
 {
   dAASSERT (w);
@@ -34,6 +34,7 @@
 #include "util.h"
 
 #include <sys/time.h>
+#include <stdint.h>
 
 #ifdef SSE
 #include <xmmintrin.h>
@@ -57,6 +58,7 @@
 #ifdef USE_TPROW
 // added for threading per constraint rows
 #include <boost/thread/recursive_mutex.hpp>
+#include <boost/thread/barrier.hpp>
 #include <boost/bind.hpp>
 #include "ode/odeinit.h"
 #endif
@@ -93,6 +95,19 @@ typedef dReal *dRealMutablePtr;
 #undef LOCK_WHILE_RANDOMLY_REORDER_CONSTRAINTS
 
 
+// for the graph colored SOR method (qs->num_threads > 0):
+// number of colors tracked per body. rows that don't fit in these
+// colors go to one more color, which is solved by a single thread.
+
+#define MAX_ROW_COLORS 64
+
+// for the graph colored SOR method:
+// threads wait for each other after every color, so small islands are
+// solved by fewer threads. this doesn't change the result.
+
+#define MIN_ROWS_PER_THREAD 64
+
+
 // structure for passing variable pointers in SOR_LCP
 struct dxSORLCPParameters {
     dxQuickStepParameters *qs;
@@ -127,6 +142,13 @@ struct dxSORLCPParameters {
     dRealMutablePtr last_lambda ;
     dRealMutablePtr last_lambda_erp ;
 #endif
+    // for graph colored rows, colorStart[c] is the first row of color c
+    // in order, NULL for chunks
+    const int *colorStart;
+    int numColors;
+    int threadIndex;
+    int numThreads;
+    boost::barrier *barrier;
 };
 
 
@@ -394,6 +416,61 @@ static int compare_index_error (const void *a, const void *b)
 
 #endif
 
+// greedily color the constraint rows, in the order given, so that no two
+// rows of a color act on the same body. a friction row always gets a
+// higher color than its normal row, or the overflow color when its normal
+// row has it, so the normal force is updated first.
+// the rows are then stably sorted by color: the rows of color c are
+// order[colorStart[c]] to order[colorStart[c+1]-1]. rows that don't fit
+// in MAX_ROW_COLORS colors get color MAX_ROW_COLORS.
+// returns the number of colors.
+
+static int ColorRows (dxWorldProcessContext *context, const int m,
+  const int nb, const int *jb, const int *findex, IndexError *order,
+  int *colorStart)
+{
+  int *rowColor = context->AllocateArray<int> (m);
+  uint64_t *bodyColors = context->AllocateArray<uint64_t> (nb);
+  for (int i=0; i<nb; i++) bodyColors[i] = 0;
+
+  for (int c=0; c<MAX_ROW_COLORS+2; c++) colorStart[c] = 0;
+
+  int numColors = 0;
+  for (int i=0; i<m; i++) {
+    int index = order[i].index;
+    int b1 = jb[index*2];
+    int b2 = jb[index*2+1];
+    uint64_t used = bodyColors[b1] | (b2 >= 0 ? bodyColors[b2] : 0);
+
+    // rows with findex < 0 come first, so the normal row is colored.
+    // a friction row of an overflow normal row stays in the overflow
+    // color, which is solved serially after its normal row
+    int color = findex[index] >= 0 ? rowColor[findex[index]] + 1 : 0;
+    if (color > MAX_ROW_COLORS) color = MAX_ROW_COLORS;
+    while (color < MAX_ROW_COLORS && (used & ((uint64_t)1 << color)))
+      color++;
+
+    rowColor[index] = color;
+    if (color < MAX_ROW_COLORS) {
+      bodyColors[b1] |= (uint64_t)1 << color;
+      if (b2 >= 0) bodyColors[b2] |= (uint64_t)1 << color;
+    }
+    colorStart[color+1]++;
+    if (color >= numColors) numColors = color+1;
+  }
+
+  for (int c=0; c<=MAX_ROW_COLORS; c++) colorStart[c+1] += colorStart[c];
+
+  IndexError *sorted = context->AllocateArray<IndexError> (m);
+  int *next = context->AllocateArray<int> (MAX_ROW_COLORS+1);
+  for (int c=0; c<=MAX_ROW_COLORS; c++) next[c] = colorStart[c];
+  for (int i=0; i<m; i++)
+    sorted[next[rowColor[order[i].index]]++] = order[i];
+  memcpy (order,sorted,m*sizeof(IndexError));
+
+  return numColors;
+}
+
 void computeRHSPrecon(dxWorldProcessContext *context, const int m, const int nb,
                       dRealPtr I, dxBody * const *body,
                       const dReal /*stepsize1*/, dRealMutablePtr /*c*/, dRealMutablePtr J,
@@ -502,9 +579,7 @@ static void ComputeRows(
   dxQuickStepParameters *qs    = params.qs;
   int startRow                 = params.nStart;   // 0
   int nRows                    = params.nChunkSize; // m
-#ifdef USE_1NORM
   int m                        = params.m; // m used for rms error computation
-#endif
   // int nb                       = params.nb;
 #ifdef PENETRATION_JVERROR_CORRECTION
   dReal stepsize               = params.stepsize;
@@ -524,9 +599,7 @@ static void ComputeRows(
   dRealMutablePtr lambda       = params.lambda;
   dRealMutablePtr lambda_erp   = params.lambda_erp;
   dRealMutablePtr iMJ          = params.iMJ;
-#ifdef RECOMPUTE_RMS
   dRealMutablePtr delta_error  = params.delta_error;
-#endif
   dRealMutablePtr rhs_precon   = params.rhs_precon;
   dRealMutablePtr J_precon     = params.J_precon;
   dRealMutablePtr J_orig       = params.J_orig;
@@ -535,6 +608,11 @@ static void ComputeRows(
   dRealMutablePtr last_lambda  = params.last_lambda;
   dRealMutablePtr last_lambda_erp  = params.last_lambda_erp;
 #endif
+  const int* colorStart        = params.colorStart;
+  int numColors                = params.numColors;
+  int threadIndex              = params.threadIndex;
+  int numThreads               = params.numThreads;
+  boost::barrier* barrier      = params.barrier;
 
   //printf("iiiiiiiii %d %d %d\n",thread_id,jb[0],jb[1]);
   //for (int i=startRow; i<startRow+nRows; i++) // swap within boundary of our own segment
@@ -647,7 +725,8 @@ static void ComputeRows(
 
 #endif
 #ifdef RANDOMLY_REORDER_CONSTRAINTS
-    if ((iteration & 7) == 0) {
+    // graph colored rows are solved in a fixed order
+    if (!colorStart && (iteration & 7) == 0) {
       #ifdef LOCK_WHILE_RANDOMLY_REORDER_CONSTRAINTS
         boost::recursive_mutex::scoped_lock lock(*mutex); // lock for every swap
       #endif
@@ -687,7 +766,24 @@ static void ComputeRows(
 #endif
     dRealMutablePtr cforce_ptr1;
     dRealMutablePtr cforce_ptr2;
-    for (int i=startRow; i<startRow+nRows; i++) {
+    for (int color=0; color<numColors; color++) {
+    int rowStart = startRow;
+    int rowEnd = startRow+nRows;
+    if (colorStart) {
+      // the rows of a color share no body, so each thread solves a slice
+      int colorRows = colorStart[color+1] - colorStart[color];
+      if (colorRows == 0) continue;
+      if (color == MAX_ROW_COLORS) {
+        // overflow rows may share bodies
+        rowStart = colorStart[color];
+        rowEnd = threadIndex == 0 ? colorStart[color+1] : rowStart;
+      }
+      else {
+        rowStart = colorStart[color] + colorRows*threadIndex/numThreads;
+        rowEnd = colorStart[color] + colorRows*(threadIndex+1)/numThreads;
+      }
+    }
+    for (int i=rowStart; i<rowEnd; i++) {
       //boost::recursive_mutex::scoped_lock lock(*mutex); // lock for every row
 
       // @@@ potential optimization: we could pre-sort J and iMJ, thereby
@@ -790,9 +886,7 @@ static void ComputeRows(
 
         // record error (for the non-erp version)
         rms_error += delta_precon*delta_precon;
-#ifdef RECOMPUTE_RMS
         delta_error[index] = dFabs(delta_precon);
-#endif
         old_lambda_erp = old_lambda;
         lambda_erp[index] = lambda[index];
       }
@@ -900,9 +994,7 @@ static void ComputeRows(
         }
         // record error (for the non-erp version)
         rms_error += delta*delta;
-#ifdef RECOMPUTE_RMS
         delta_error[index] = dFabs(delta);
-#endif
         {
           // FOR erp != 0
           // for rhs_erp  note: Adcfm does not have erp because it is on the lhs
@@ -972,6 +1064,9 @@ static void ComputeRows(
       //delta *= ramp;
 
     } // end of for loop on m
+    // the next color reads what this one wrote
+    if (barrier) barrier->wait();
+    } // end of for loop on colors
 #ifdef PENETRATION_JVERROR_CORRECTION
     Jvnew_final = Jvnew*stepsize1;
     Jvnew_final = Jvnew_final > 1.0 ? 1.0 : ( Jvnew_final < -1.0 ? -1.0 : Jvnew_final );
@@ -979,6 +1074,17 @@ static void ComputeRows(
 
     // DO WE NEED TO COMPUTE NORM ACROSS ENTIRE SOLUTION SPACE (0,m)?
     // since local convergence might produce errors in other nodes?
+    if (colorStart) {
+      // every thread sums the errors of all rows in the same order, so
+      // all threads agree on convergence
+      rms_error = 0;
+      for (int i=0; i<m; i++)
+        rms_error += delta_error[i]*delta_error[i];
+      rms_error = sqrt(rms_error/(dReal)m);
+      // don't overwrite delta_error before every thread is done with it
+      if (barrier) barrier->wait();
+    }
+    else {
 #ifdef RECOMPUTE_RMS
     // recompute rms_error to be sure swap is not corrupting arrays
     rms_error = 0;
@@ -997,6 +1103,7 @@ static void ComputeRows(
 #else
     rms_error = sqrt(rms_error/(dReal)nRows);
 #endif
+    }
 
     //printf("------ %d %d %20.18f\n",thread_id,iteration,rms_error);
 
@@ -1045,7 +1152,8 @@ static void ComputeRows(
 
 
 
-  qs->rms_error          = rms_error;
+  if (!colorStart || threadIndex == 0)
+    qs->rms_error          = rms_error;
 
   #ifdef REPORT_THREAD_TIMING
   gettimeofday(&tv,NULL);
@@ -1233,18 +1341,45 @@ static void SOR_LCP (dxWorldProcessContext *context,
 
   boost::recursive_mutex* mutex = new boost::recursive_mutex();
 
-  // number of chunks must be at least 1
-  // (single iteration, through all the constraints)
-  int num_chunks = qs->num_chunks > 0 ? qs->num_chunks : 1; // min is 1
-
-  // prepare pointers for threads
-  dxSORLCPParameters *params = new dxSORLCPParameters [num_chunks];
-
-  // divide into chunks sequentially
-  int chunk = m / num_chunks+1;
-  chunk = chunk > 0 ? chunk : 1;
-  int thread_id = 0;
-
+  // parameters shared by all chunks or threads
+  dxSORLCPParameters base;
+  base.qs  = qs ;
+  base.nStart = 0;   // 0
+  base.nChunkSize = m; // m
+  base.m = m; // m
+  base.nb = nb;
+  base.stepsize = stepsize;
+  base.jb = jb;
+  base.findex = findex;
+  base.hi = hi;
+  base.lo = lo;
+  base.invI = invI;
+  base.I= I;
+  base.Adcfm = Adcfm;
+  base.Adcfm_precon = Adcfm_precon;
+  base.rhs = rhs;
+  base.rhs_erp = rhs_erp;
+  base.J = J;
+  base.caccel = caccel;
+  base.caccel_erp = caccel_erp;
+  base.lambda = lambda;
+  base.lambda_erp = lambda_erp;
+  base.iMJ = iMJ;
+  base.delta_error  = delta_error ;
+  base.rhs_precon  = rhs_precon ;
+  base.J_precon  = J_precon ;
+  base.J_orig  = J_orig ;
+  base.cforce  = cforce ;
+  base.vnew  = vnew ;
+#ifdef REORDER_CONSTRAINTS
+  base.last_lambda  = last_lambda ;
+  base.last_lambda_erp  = last_lambda_erp ;
+#endif
+  base.colorStart = NULL;
+  base.numColors = 1;
+  base.threadIndex = 0;
+  base.numThreads = 1;
+  base.barrier = NULL;
 
   #ifdef REPORT_THREAD_TIMING
   // timing
@@ -1255,6 +1390,54 @@ static void SOR_LCP (dxWorldProcessContext *context,
   //printf("    quickstep start threads at time %f\n",cur_time);
   #endif
 
+  dxSORLCPParameters *params = NULL;
+
+  if (qs->num_threads > 0)
+  {
+    // graph colored rows, solved by the calling thread and the pool
+    int *colorStart = context->AllocateArray<int> (MAX_ROW_COLORS+2);
+    base.colorStart = colorStart;
+    base.numColors = ColorRows (context,m,nb,jb,findex,order,colorStart);
+
+#ifdef USE_TPROW
+    if (row_threadpool)
+      base.numThreads += row_threadpool->size();
+#endif
+    if (base.numThreads > m / MIN_ROWS_PER_THREAD)
+      base.numThreads = m / MIN_ROWS_PER_THREAD > 1 ? m / MIN_ROWS_PER_THREAD : 1;
+    if (base.numThreads > 1)
+      base.barrier = new boost::barrier(base.numThreads);
+
+    params = new dxSORLCPParameters [base.numThreads];
+
+    IFTIMING (dTimerNow ("start colored pgs rows"));
+    for (int thread_id = base.numThreads-1; thread_id >= 0; thread_id--)
+    {
+      params[thread_id] = base;
+      params[thread_id].threadIndex = thread_id;
+#ifdef USE_TPROW
+      if (thread_id > 0)
+        row_threadpool->schedule(boost::bind(ComputeRows,thread_id,order, body, params[thread_id], mutex));
+      else
+        ComputeRows(thread_id,order, body, params[thread_id], mutex);
+#else
+      ComputeRows(thread_id,order, body, params[thread_id], mutex);
+#endif
+    }
+  }
+  else
+  {
+  // number of chunks must be at least 1
+  // (single iteration, through all the constraints)
+  int num_chunks = qs->num_chunks > 0 ? qs->num_chunks : 1; // min is 1
+
+  // prepare pointers for threads
+  params = new dxSORLCPParameters [num_chunks];
+
+  // divide into chunks sequentially
+  int chunk = m / num_chunks+1;
+  chunk = chunk > 0 ? chunk : 1;
+  int thread_id = 0;
 
   IFTIMING (dTimerNow ("start pgs rows"));
   for (int i=0; i<m; i+= chunk,thread_id++)
@@ -1266,38 +1449,9 @@ static void SOR_LCP (dxWorldProcessContext *context,
     if (nEnd > m) nEnd = m;
     // if every one reorders constraints, this might just work
     // comment out below if using defaults (0 and m) so every thread runs through all joints
-    params[thread_id].qs  = qs ;
+    params[thread_id] = base;
     params[thread_id].nStart = nStart;   // 0
     params[thread_id].nChunkSize = nEnd - nStart; // m
-    params[thread_id].m = m; // m
-    params[thread_id].nb = nb;
-    params[thread_id].stepsize = stepsize;
-    params[thread_id].jb = jb;
-    params[thread_id].findex = findex;
-    params[thread_id].hi = hi;
-    params[thread_id].lo = lo;
-    params[thread_id].invI = invI;
-    params[thread_id].I= I;
-    params[thread_id].Adcfm = Adcfm;
-    params[thread_id].Adcfm_precon = Adcfm_precon;
-    params[thread_id].rhs = rhs;
-    params[thread_id].rhs_erp = rhs_erp;
-    params[thread_id].J = J;
-    params[thread_id].caccel = caccel;
-    params[thread_id].caccel_erp = caccel_erp;
-    params[thread_id].lambda = lambda;
-    params[thread_id].lambda_erp = lambda_erp;
-    params[thread_id].iMJ = iMJ;
-    params[thread_id].delta_error  = delta_error ;
-    params[thread_id].rhs_precon  = rhs_precon ;
-    params[thread_id].J_precon  = J_precon ;
-    params[thread_id].J_orig  = J_orig ;
-    params[thread_id].cforce  = cforce ;
-    params[thread_id].vnew  = vnew ;
-#ifdef REORDER_CONSTRAINTS
-    params[thread_id].last_lambda  = last_lambda ;
-    params[thread_id].last_lambda_erp  = last_lambda_erp ;
-#endif
 
 #ifdef REPORT_MONITOR
     printf("thread summary: id %d i %d m %d chunk %d start %d end %d \n",thread_id,i,m,chunk,nStart,nEnd);
@@ -1311,6 +1465,7 @@ static void SOR_LCP (dxWorldProcessContext *context,
     ComputeRows(thread_id,order, body, params[thread_id], mutex);
 #endif
   }
+  }
 
 
   // check time for scheduling, this is usually very quick
@@ -1333,6 +1488,7 @@ static void SOR_LCP (dxWorldProcessContext *context,
   printf("    quickstep threads start time %f stopped time %f duration %f\n",cur_time,end_time,end_time - cur_time);
   #endif
 
+  delete base.barrier;
   delete [] params;
   delete mutex;
 }
@@ -1737,7 +1893,10 @@ void dxQuickStepper (dxWorldProcessContext *context,
                lo,hi,cfm,findex,
                &world->qs,
 #ifdef USE_TPROW
-               world->row_threadpool,
+               // colored rows wait for each other, so they can't share
+               // the pool between islands solved at the same time
+               (world->qs.num_threads > 0 && world->threadpool) ?
+                 NULL : world->row_threadpool,
 #endif
                stepsize);
 
@@ -2015,7 +2174,7 @@ static size_t EstimateGR_LCPMemoryRequirements(int m)
 }
 #endif
 
-static size_t EstimateSOR_LCPMemoryRequirements(int m,int /*nb*/)
+static size_t EstimateSOR_LCPMemoryRequirements(int m,int nb)
 {
   size_t res = dEFFICIENT_SIZE(sizeof(dReal) * 12 * m); // for iMJ
   res += dEFFICIENT_SIZE(sizeof(dReal) * m); // for Ad
@@ -2024,6 +2183,12 @@ static size_t EstimateSOR_LCPMemoryRequirements(int m,int /*nb*/)
   res += dEFFICIENT_SIZE(sizeof(dReal) * m); // for Adcfm_precon
   res += dEFFICIENT_SIZE(sizeof(dReal) * m); // for delta_error
   res += dEFFICIENT_SIZE(sizeof(IndexError) * m); // for order
+  // for graph colored rows
+  res += dEFFICIENT_SIZE(sizeof(int) * (MAX_ROW_COLORS+2)); // for colorStart
+  res += dEFFICIENT_SIZE(sizeof(int) * m); // for rowColor
+  res += dEFFICIENT_SIZE(sizeof(uint64_t) * nb); // for bodyColors
+  res += dEFFICIENT_SIZE(sizeof(IndexError) * m); // for sorted order
+  res += dEFFICIENT_SIZE(sizeof(int) * (MAX_ROW_COLORS+1)); // for next
 #ifdef REORDER_CONSTRAINTS
   res += dEFFICIENT_SIZE(sizeof(dReal) * m); // for last_lambda
   res += dEFFICIENT_SIZE(sizeof(dReal) * m); // for last_lambda_erp
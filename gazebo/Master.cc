@@ -14,6 +14,7 @@
  * limitations under the License.
  *
 */
+#include <vector>
 #include <google/protobuf/descriptor.h>
 #include "transport/IOManager.hh"
 
@@ -23,6 +24,10 @@
 
 using namespace gazebo;
 
+/// \brief Longest time the master sleeps without a message, so closed
+/// connections are still removed.
+static const unsigned int MasterIdleMs = 100;
+
 /////////////////////////////////////////////////
 Master::Master()
   : connection(new transport::Connection())
@@ -74,6 +79,10 @@ void Master::Init(uint16_t _port)
 //////////////////////////////////////////////////
 void Master::OnAccept(const transport::ConnectionPtr &_newConnection)
 {
+  // The lock keeps pending updates from being sent between the initial
+  // state below and adding the connection, which would send them twice.
+  boost::recursive_mutex::scoped_lock lock(*this->connectionMutex);
+
   // Send the gazebo version string
   msgs::GzString versionMsg;
   versionMsg.set_data(std::string("gazebo ") + GAZEBO_VERSION);
@@ -92,28 +101,29 @@ void Master::OnAccept(const transport::ConnectionPtr &_newConnection)
 
   // Send all the publishers
   msgs::Publishers publishersMsg;
-  PubList::iterator pubiter;
-  for (pubiter = this->publishers.begin();
-       pubiter != this->publishers.end(); ++pubiter)
+  for (PubMap::iterator topicIter = this->publishers.begin();
+       topicIter != this->publishers.end(); ++topicIter)
   {
-    msgs::Publish *pub = publishersMsg.add_publisher();
-    pub->CopyFrom(pubiter->first);
+    PubList::iterator pubiter;
+    for (pubiter = topicIter->second.begin();
+         pubiter != topicIter->second.end(); ++pubiter)
+    {
+      msgs::Publish *pub = publishersMsg.add_publisher();
+      pub->CopyFrom(pubiter->first);
+    }
   }
   _newConnection->EnqueueMsg(
       msgs::Package("publishers_init", publishersMsg), true);
 
-
   // Add the connection to our list
-  {
-    boost::recursive_mutex::scoped_lock lock(*this->connectionMutex);
-    int index = this->connections.size();
+  int index = this->connections.size();
 
-    this->connections[index] = _newConnection;
+  this->connections[index] = _newConnection;
+  this->batchConnections.erase(index);
 
-    // Start reading from the connection
-    _newConnection->AsyncRead(
-        boost::bind(&Master::OnRead, this, index, _1));
-  }
+  // Start reading from the connection
+  _newConnection->AsyncRead(
+      boost::bind(&Master::OnRead, this, index, _1));
 }
 
 //////////////////////////////////////////////////
@@ -139,6 +149,7 @@ void Master::OnRead(const unsigned int _connectionIndex,
   {
     boost::recursive_mutex::scoped_lock lock(*this->msgsMutex);
     this->msgs.push_back(std::make_pair(_connectionIndex, _data));
+    this->msgsCondition.notify_one();
   }
   else
   {
@@ -151,11 +162,12 @@ void Master::OnRead(const unsigned int _connectionIndex,
 void Master::ProcessMessage(const unsigned int _connectionIndex,
                             const std::string &_data)
 {
-  if (!this->connections[_connectionIndex] ||
-      !this->connections[_connectionIndex]->IsOpen())
+  Connection_M::iterator connIter = this->connections.find(_connectionIndex);
+  if (connIter == this->connections.end() || !connIter->second ||
+      !connIter->second->IsOpen())
     return;
 
-  transport::ConnectionPtr conn = this->connections[_connectionIndex];
+  transport::ConnectionPtr conn = connIter->second;
 
   msgs::Packet packet;
   packet.ParseFromString(_data);
@@ -170,42 +182,27 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
         worldNameMsg.data());
     if (iter == this->worldNames.end())
     {
-      boost::recursive_mutex::scoped_lock lock(*this->connectionMutex);
       this->worldNames.push_back(worldNameMsg.data());
-
-      Connection_M::iterator iter2;
-      for (iter2 = this->connections.begin();
-          iter2 != this->connections.end(); ++iter2)
-      {
-        iter2->second->EnqueueMsg(
-            msgs::Package("topic_namespace_add", worldNameMsg));
-      }
+      this->pendingNamespaces.add_data(worldNameMsg.data());
     }
   }
   else if (packet.type() == "advertise")
   {
-    boost::recursive_mutex::scoped_lock lock(*this->connectionMutex);
     msgs::Publish pub;
     pub.ParseFromString(packet.serialized_data());
 
-    Connection_M::iterator iter2;
-    for (iter2 = this->connections.begin();
-         iter2 != this->connections.end(); ++iter2)
-    {
-      iter2->second->EnqueueMsg(msgs::Package("publisher_add", pub));
-    }
-
-    this->publishers.push_back(std::make_pair(pub, conn));
+    this->pendingPublishers.push_back(std::make_pair(true, pub));
+    this->publishers[pub.topic()].push_back(std::make_pair(pub, conn));
 
-    SubList::iterator iter;
-
-    // Find all subscribers of the topic
-    for (iter = this->subscribers.begin();
-         iter != this->subscribers.end(); ++iter)
+    // Tell all subscribers of the topic
+    SubMap::iterator subIter = this->subscribers.find(pub.topic());
+    if (subIter != this->subscribers.end())
     {
-      if (iter->first.topic() == pub.topic())
+      std::string update = msgs::Package("publisher_update", pub);
+      for (SubList::iterator iter = subIter->second.begin();
+           iter != subIter->second.end(); ++iter)
       {
-        iter->second->EnqueueMsg(msgs::Package("publisher_update", pub));
+        iter->second->EnqueueMsg(update);
       }
     }
   }
@@ -226,15 +223,14 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
     msgs::Subscribe sub;
     sub.ParseFromString(packet.serialized_data());
 
-    this->subscribers.push_back(std::make_pair(sub, conn));
-
-    PubList::iterator iter;
+    this->subscribers[sub.topic()].push_back(std::make_pair(sub, conn));
 
     // Find all publishers of the topic
-    for (iter = this->publishers.begin();
-        iter != this->publishers.end(); ++iter)
+    PubMap::iterator pubIter = this->publishers.find(sub.topic());
+    if (pubIter != this->publishers.end())
     {
-      if (iter->first.topic() == sub.topic())
+      for (PubList::iterator iter = pubIter->second.begin();
+           iter != pubIter->second.end(); ++iter)
       {
         conn->EnqueueMsg(msgs::Package("publisher_update", iter->first));
       }
@@ -245,15 +241,24 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
     msgs::Request req;
     req.ParseFromString(packet.serialized_data());
 
-    if (req.request() == "get_publishers")
+    if (req.request() == "enable_batch_updates")
+    {
+      // Clients that don't ask get one message per change, as before
+      this->batchConnections.insert(_connectionIndex);
+    }
+    else if (req.request() == "get_publishers")
     {
       msgs::Publishers msg;
-      PubList::iterator iter;
-      for (iter = this->publishers.begin();
-          iter != this->publishers.end(); ++iter)
+      for (PubMap::iterator topicIter = this->publishers.begin();
+           topicIter != this->publishers.end(); ++topicIter)
       {
-        msgs::Publish *pub = msg.add_publisher();
-        pub->CopyFrom(iter->first);
+        PubList::iterator iter;
+        for (iter = topicIter->second.begin();
+             iter != topicIter->second.end(); ++iter)
+        {
+          msgs::Publish *pub = msg.add_publisher();
+          pub->CopyFrom(iter->first);
+        }
       }
       conn->EnqueueMsg(msgs::Package("publisher_list", msg), true);
     }
@@ -263,14 +268,12 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
       msgs::TopicInfo ti;
       ti.set_msg_type(pub.msg_type());
 
-      PubList::iterator piter;
-      SubList::iterator siter;
-
       // Find all publishers of the topic
-      for (piter = this->publishers.begin();
-          piter != this->publishers.end(); ++piter)
+      PubMap::iterator pubIter = this->publishers.find(req.data());
+      if (pubIter != this->publishers.end())
       {
-        if (piter->first.topic() == req.data())
+        for (PubList::iterator piter = pubIter->second.begin();
+             piter != pubIter->second.end(); ++piter)
         {
           msgs::Publish *pubPtr = ti.add_publisher();
           pubPtr->CopyFrom(piter->first);
@@ -278,10 +281,11 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
       }
 
       // Find all subscribers of the topic
-      for (siter = this->subscribers.begin();
-          siter != this->subscribers.end(); ++siter)
+      SubMap::iterator subIter = this->subscribers.find(req.data());
+      if (subIter != this->subscribers.end())
       {
-        if (siter->first.topic() == req.data())
+        for (SubList::iterator siter = subIter->second.begin();
+             siter != subIter->second.end(); ++siter)
         {
           msgs::Subscribe *sub = ti.add_subscriber();
           sub->CopyFrom(siter->first);
@@ -316,8 +320,16 @@ void Master::Run()
 {
   while (!this->stop)
   {
+    {
+      boost::recursive_mutex::scoped_lock lock(*this->msgsMutex);
+      if (this->msgs.empty() && !this->stop)
+      {
+        this->msgsCondition.timed_wait(lock,
+            boost::posix_time::milliseconds(MasterIdleMs));
+      }
+    }
+
     this->RunOnce();
-    common::Time::MSleep(10);
   }
 }
 
@@ -332,32 +344,101 @@ void Master::RunOnce()
 {
   Connection_M::iterator iter;
 
-  // Process the incoming message queue
+  // Take the incoming messages, so connections can keep queuing while
+  // they are processed
+  std::list<std::pair<unsigned int, std::string> > incoming;
   {
     boost::recursive_mutex::scoped_lock lock(*this->msgsMutex);
-    while (this->msgs.size() > 0)
+    incoming.swap(this->msgs);
+  }
+
+  boost::recursive_mutex::scoped_lock lock(*this->connectionMutex);
+
+  // Process the incoming message queue
+  while (!incoming.empty())
+  {
+    this->ProcessMessage(incoming.front().first, incoming.front().second);
+    incoming.pop_front();
+  }
+
+  // Process all the connections
+  for (iter = this->connections.begin();
+      iter != this->connections.end();)
+  {
+    if (iter->second->IsOpen())
+      ++iter;
+    else
+      this->RemoveConnection(iter++);
+  }
+
+  this->SendPendingUpdates();
+
+  for (iter = this->connections.begin();
+      iter != this->connections.end(); ++iter)
+  {
+    iter->second->ProcessWriteQueue();
+  }
+}
+
+//////////////////////////////////////////////////
+void Master::SendPendingUpdates()
+{
+  if (this->pendingNamespaces.data_size() == 0 &&
+      this->pendingPublishers.empty())
+  {
+    return;
+  }
+
+  // Clients that asked for batched updates get them, the others get one
+  // message per change
+  std::vector<std::string> updates, singleUpdates;
+
+  if (this->pendingNamespaces.data_size() > 0)
+  {
+    updates.push_back(msgs::Package("topic_namespaces_add",
+                                    this->pendingNamespaces));
+
+    for (int i = 0; i < this->pendingNamespaces.data_size(); ++i)
     {
-      this->ProcessMessage(this->msgs.front().first,
-                           this->msgs.front().second);
-      this->msgs.pop_front();
+      msgs::GzString ns;
+      ns.set_data(this->pendingNamespaces.data(i));
+      singleUpdates.push_back(msgs::Package("topic_namespace_add", ns));
     }
+    this->pendingNamespaces.Clear();
   }
 
-  // Process all the connections
+  // Consecutive additions and removals are sent together, and the order
+  // between them is kept
+  std::list<std::pair<bool, msgs::Publish> >::iterator iter =
+    this->pendingPublishers.begin();
+  while (iter != this->pendingPublishers.end())
   {
-    boost::recursive_mutex::scoped_lock lock(*this->connectionMutex);
-    for (iter = this->connections.begin();
-        iter != this->connections.end();)
+    bool add = iter->first;
+    msgs::Publishers batch;
+    for (; iter != this->pendingPublishers.end() && iter->first == add;
+         ++iter)
     {
-      if (iter->second->IsOpen())
-      {
-        iter->second->ProcessWriteQueue();
-        ++iter;
-      }
-      else
-      {
-        this->RemoveConnection(iter++);
-      }
+      batch.add_publisher()->CopyFrom(iter->second);
+      singleUpdates.push_back(msgs::Package(
+            add ? "publisher_add" : "publisher_del", iter->second));
+    }
+
+    updates.push_back(msgs::Package(add ? "publishers_add" : "publishers_del",
+                                    batch));
+  }
+  this->pendingPublishers.clear();
+
+  for (Connection_M::iterator connIter = this->connections.begin();
+       connIter != this->connections.end(); ++connIter)
+  {
+    std::vector<std::string> &connUpdates =
+      this->batchConnections.find(connIter->first) !=
+      this->batchConnections.end() ? updates : singleUpdates;
+
+    for (std::vector<std::string>::iterator updateIter = connUpdates.begin();
+         updateIter != connUpdates.end(); ++updateIter)
+    {
+      connIter->second->EnqueueMsg(*updateIter);
     }
   }
 }
@@ -383,113 +464,119 @@ void Master::RemoveConnection(Connection_M::iterator _connIter)
     }
   }
 
-  // Remove all publishers for this connection
-  bool done = false;
-  while (!done)
+  unsigned int id = _connIter->second->GetId();
+
+  // Find all publishers and subscribers for this connection, and then
+  // remove them, since removing changes the indices
+  std::vector<msgs::Publish> pubs;
+  for (PubMap::iterator topicIter = this->publishers.begin();
+       topicIter != this->publishers.end(); ++topicIter)
   {
-    done = true;
-    PubList::iterator pubIter = this->publishers.begin();
-    while (pubIter != this->publishers.end())
+    for (PubList::iterator pubIter = topicIter->second.begin();
+         pubIter != topicIter->second.end(); ++pubIter)
     {
-      if ((*pubIter).second->GetId() == _connIter->second->GetId())
-      {
-        this->RemovePublisher((*pubIter).first);
-        done = false;
-        break;
-      }
-      else
-        ++pubIter;
+      if (pubIter->second->GetId() == id)
+        pubs.push_back(pubIter->first);
     }
   }
 
-
-  done = false;
-  while (!done)
+  std::vector<msgs::Subscribe> subs;
+  for (SubMap::iterator topicIter = this->subscribers.begin();
+       topicIter != this->subscribers.end(); ++topicIter)
   {
-    done = true;
-
-    // Remove all subscribers for this connection
-    SubList::iterator subIter = this->subscribers.begin();
-    while (subIter != this->subscribers.end())
+    for (SubList::iterator subIter = topicIter->second.begin();
+         subIter != topicIter->second.end(); ++subIter)
     {
-      if ((*subIter).second->GetId() == _connIter->second->GetId())
-      {
-        this->RemoveSubscriber((*subIter).first);
-        done = false;
-        break;
-      }
-      else
-        ++subIter;
+      if (subIter->second->GetId() == id)
+        subs.push_back(subIter->first);
     }
   }
 
+  for (unsigned int i = 0; i < pubs.size(); ++i)
+    this->RemovePublisher(pubs[i]);
+
+  for (unsigned int i = 0; i < subs.size(); ++i)
+    this->RemoveSubscriber(subs[i]);
+
+  this->batchConnections.erase(_connIter->first);
   this->connections.erase(_connIter);
 }
 
 /////////////////////////////////////////////////
 void Master::RemovePublisher(const msgs::Publish _pub)
 {
-  {
-    boost::recursive_mutex::scoped_lock lock(*this->connectionMutex);
-    Connection_M::iterator iter2;
-    for (iter2 = this->connections.begin();
-        iter2 != this->connections.end(); ++iter2)
-    {
-      iter2->second->EnqueueMsg(msgs::Package("publisher_del", _pub));
-    }
-  }
+  boost::recursive_mutex::scoped_lock lock(*this->connectionMutex);
+
+  this->pendingPublishers.push_back(std::make_pair(false, _pub));
 
-  SubList::iterator iter;
   // Find all subscribers of the topic
-  for (iter = this->subscribers.begin();
-      iter != this->subscribers.end(); ++iter)
+  SubMap::iterator subIter = this->subscribers.find(_pub.topic());
+  if (subIter != this->subscribers.end())
   {
-    if (iter->first.topic() == _pub.topic())
+    std::string unadvertise = msgs::Package("unadvertise", _pub);
+    for (SubList::iterator iter = subIter->second.begin();
+         iter != subIter->second.end(); ++iter)
     {
-      iter->second->EnqueueMsg(msgs::Package("unadvertise", _pub));
+      iter->second->EnqueueMsg(unadvertise);
     }
   }
 
-  PubList::iterator pubIter = this->publishers.begin();
-  while (pubIter != this->publishers.end())
+  PubMap::iterator topicIter = this->publishers.find(_pub.topic());
+  if (topicIter == this->publishers.end())
+    return;
+
+  PubList::iterator pubIter = topicIter->second.begin();
+  while (pubIter != topicIter->second.end())
   {
-    if (pubIter->first.topic() == _pub.topic() &&
-        pubIter->first.host() == _pub.host() &&
+    if (pubIter->first.host() == _pub.host() &&
         pubIter->first.port() == _pub.port())
     {
-      pubIter = this->publishers.erase(pubIter);
+      pubIter = topicIter->second.erase(pubIter);
     }
     else
       ++pubIter;
   }
+
+  if (topicIter->second.empty())
+    this->publishers.erase(topicIter);
 }
 
 /////////////////////////////////////////////////
 void Master::RemoveSubscriber(const msgs::Subscribe _sub)
 {
+  boost::recursive_mutex::scoped_lock lock(*this->connectionMutex);
+
   // Find all publishers of the topic, and remove the subscriptions
-  for (PubList::iterator iter = this->publishers.begin();
-      iter != this->publishers.end(); ++iter)
+  PubMap::iterator pubIter = this->publishers.find(_sub.topic());
+  if (pubIter != this->publishers.end())
   {
-    if (iter->first.topic() == _sub.topic())
+    std::string unsubscribe = msgs::Package("unsubscribe", _sub);
+    for (PubList::iterator iter = pubIter->second.begin();
+         iter != pubIter->second.end(); ++iter)
     {
-      iter->second->EnqueueMsg(msgs::Package("unsubscribe", _sub));
+      iter->second->EnqueueMsg(unsubscribe);
     }
   }
 
   // Remove the subscribers from our list
-  SubList::iterator subiter = this->subscribers.begin();
-  while (subiter != this->subscribers.end())
+  SubMap::iterator topicIter = this->subscribers.find(_sub.topic());
+  if (topicIter == this->subscribers.end())
+    return;
+
+  SubList::iterator subiter = topicIter->second.begin();
+  while (subiter != topicIter->second.end())
   {
-    if (subiter->first.topic() == _sub.topic() &&
-        subiter->first.host() == _sub.host() &&
+    if (subiter->first.host() == _sub.host() &&
         subiter->first.port() == _sub.port())
     {
-      subiter = this->subscribers.erase(subiter);
+      subiter = topicIter->second.erase(subiter);
     }
     else
       ++subiter;
   }
+
+  if (topicIter->second.empty())
+    this->subscribers.erase(topicIter);
 }
 
 //////////////////////////////////////////////////
@@ -497,6 +584,11 @@ void Master::Stop()
 {
   this->stop = true;
 
+  {
+    boost::recursive_mutex::scoped_lock lock(*this->msgsMutex);
+    this->msgsCondition.notify_all();
+  }
+
   if (this->runThread)
   {
     this->runThread->join();
@@ -516,18 +608,9 @@ msgs::Publish Master::GetPublisher(const std::string &_topic)
 {
   msgs::Publish msg;
 
-  PubList::iterator iter;
-
-  // Find all publishers of the topic
-  for (iter = this->publishers.begin();
-       iter != this->publishers.end(); ++iter)
-  {
-    if (iter->first.topic() == _topic)
-    {
-      msg = iter->first;
-      break;
-    }
-  }
+  PubMap::iterator iter = this->publishers.find(_topic);
+  if (iter != this->publishers.end() && !iter->second.empty())
+    msg = iter->second.front().first;
 
   return msg;
 }
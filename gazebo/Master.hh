@@ -22,7 +22,10 @@
 #include <deque>
 #include <utility>
 #include <map>
+#include <set>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/unordered_map.hpp>
 
 #include "msgs/msgs.hh"
 #include "transport/Connection.hh"
@@ -33,6 +36,14 @@ namespace gazebo
   /// \brief A ROS Master-like manager that directs gztopic connections, enables
   ///        each gazebo network client to locate one another for peer-to-peer
   ///        communication.
+  ///
+  /// Publishers and subscribers are indexed by topic. The master sleeps
+  /// until a message arrives, processes every queued message, and then
+  /// sends the publisher and namespace changes to all the clients in as
+  /// few messages as possible. Batched changes are only sent to clients
+  /// that asked for them with an "enable_batch_updates" request, older
+  /// clients get one publisher_add, publisher_del or topic_namespace_add
+  /// message per change.
   class Master
   {
     /// \def Map of unique id's to connections.
@@ -49,7 +60,7 @@ namespace gazebo
     /// \param[in] _port The master's port
     public: void Init(uint16_t _port);
 
-    /// \brief Run the master.
+    /// \brief Run the master, processing messages as they arrive.
     public: void Run();
 
     /// \brief Run the master in a new thread
@@ -110,6 +121,10 @@ namespace gazebo
     /// remove a subscriber.
     private: void RemoveSubscriber(const msgs::Subscribe _sub);
 
+    /// \brief Send the publisher and namespace changes of the processed
+    /// messages to all the connections.
+    private: void SendPendingUpdates();
+
     /// \def Map of publish messages to connections.
     typedef std::list< std::pair<msgs::Publish, transport::ConnectionPtr> >
       PubList;
@@ -118,15 +133,31 @@ namespace gazebo
     typedef std::list< std::pair<msgs::Subscribe, transport::ConnectionPtr> >
       SubList;
 
+    /// \def Publishers by topic name.
+    typedef boost::unordered_map<std::string, PubList> PubMap;
+
+    /// \def Subscribers by topic name.
+    typedef boost::unordered_map<std::string, SubList> SubMap;
+
     /// \brief All the known publishers.
-    private: PubList publishers;
+    private: PubMap publishers;
 
     /// \brief All the known subscribers.
-    private: SubList subscribers;
+    private: SubMap subscribers;
+
+    /// \brief Publishers added (true) and removed (false) since the
+    /// changes were last sent, in order.
+    private: std::list<std::pair<bool, msgs::Publish> > pendingPublishers;
+
+    /// \brief Namespaces added since the changes were last sent.
+    private: msgs::GzString_V pendingNamespaces;
 
     /// \brief All the known connections.
     private: Connection_M connections;
 
+    /// \brief Indices of the connections that get batched updates.
+    private: std::set<unsigned int> batchConnections;
+
     /// \brief All th worlds.
     private: std::list<std::string> worldNames;
 
@@ -147,6 +178,9 @@ namespace gazebo
 
     /// \brief Mutex to protect msg bufferes.
     private: boost::recursive_mutex *msgsMutex;
+
+    /// \brief Signaled when a message arrives or the master stops.
+    private: boost::condition_variable_any msgsCondition;
   };
 }
 #endif
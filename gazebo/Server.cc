@@ -28,6 +28,8 @@
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Plugin.hh"
 #include "gazebo/common/Common.hh"
+#include "gazebo/common/ModelDatabase.hh"
+#include "gazebo/common/Trace.hh"
 
 #include "gazebo/sdf/sdf.hh"
 
@@ -96,7 +98,10 @@ bool Server::ParseArgs(int argc, char **argv)
     ("seed",  po::value<double>(),
      "Start with a given random number seed.")
     ("server-plugin,s", po::value<std::vector<std::string> >(),
-     "Load a plugin.");
+     "Load a plugin.")
+    ("trace", po::value<std::string>(),
+     "On exit, write the most recent timing events of each thread to a "
+     "Chrome trace file.");
 
   po::options_description h_desc("Hidden options");
   h_desc.add_options()
@@ -240,6 +245,10 @@ bool Server::LoadFile(const std::string &_filename,
   }
   fclose(test);
 
+  // Download the models used by the world while it is parsed
+  common::ModelDatabase::Instance()->PrefetchFile(
+      common::find_file(_filename));
+
   // Load the world file
   sdf::SDFPtr sdf(new sdf::SDF);
   if (!sdf::init(sdf))
@@ -381,6 +390,9 @@ void Server::Fini()
 {
   this->Stop();
 
+  if (this->vm.count("trace"))
+    common::Trace::Export(this->vm["trace"].as<std::string>());
+
   gazebo::fini();
 
   physics::fini();
@@ -511,6 +523,9 @@ void Server::ProcessControlMsgs()
 /////////////////////////////////////////////////
 bool Server::OpenWorld(const std::string &_filename)
 {
+  common::ModelDatabase::Instance()->PrefetchFile(
+      common::find_file(_filename));
+
   sdf::SDFPtr sdf(new sdf::SDF);
   if (!sdf::init(sdf))
   {
@@ -39,6 +39,64 @@
 using namespace gazebo;
 using namespace common;
 
+/////////////////////////////////////////////////
+/// \brief Read the next _count integers from a whitespace separated list
+/// \param[in,out] _p Pointer into the list, moved past the integers read
+/// \param[out] _values Array of at least _count integers
+/// \param[in] _count Number of integers to read
+/// \return True if all _count integers were read
+static bool parseNextInts(const char *&_p, int *_values, unsigned int _count)
+{
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    if (!math::parseNextInt(_p, _values[i]))
+      return false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+/// \brief Parse the text of an array element, such as <float_array>, in
+/// place. The output is reserved from the element's count attribute.
+/// \param[in] _xml Pointer to the array XML element
+/// \param[out] _values Holds the parsed values
+static void readFloatArray(TiXmlElement *_xml, std::vector<double> &_values)
+{
+  int count = 0;
+  if (_xml->Attribute("count", &count) && count > 0)
+    _values.reserve(_values.size() + count);
+
+  const char *p = _xml->GetText();
+  if (!p)
+    return;
+
+  double value;
+  while (math::parseNextFloat(p, value))
+    _values.push_back(value);
+
+  if (*p)
+    gzerr << "Invalid number in <" << _xml->Value() << "> near[" << p << "]\n";
+}
+
+/////////////////////////////////////////////////
+/// \brief Parse the text of an integer list element, such as <vcount> or
+/// <v>, in place.
+/// \param[in] _xml Pointer to the XML element
+/// \param[out] _values Holds the parsed values
+static void readIntArray(TiXmlElement *_xml, std::vector<int> &_values)
+{
+  const char *p = _xml->GetText();
+  if (!p)
+    return;
+
+  int value;
+  while (math::parseNextInt(p, value))
+    _values.push_back(value);
+
+  if (*p)
+    gzerr << "Invalid number in <" << _xml->Value() << "> near[" << p << "]\n";
+}
+
 //////////////////////////////////////////////////
   ColladaLoader::ColladaLoader()
 : MeshLoader(), meter(1.0)
@@ -350,23 +408,24 @@ void ColladaLoader::LoadController(TiXmlElement *_contrXml,
     gzthrow("Faild to parse skinning information in Collada file.");
   }
 
-  std::string posesStr = invBMXml->FirstChildElement("float_array")->GetText();
+  std::vector<double> poses;
+  readFloatArray(invBMXml->FirstChildElement("float_array"), poses);
 
-  std::vector<std::string> strs;
-  boost::split(strs, posesStr, boost::is_any_of("   "));
+  if (poses.size() < joints.size() * 16)
+  {
+    gzerr << "Not enough inverse bind matrices in node["
+          << invBindMatURL << "]\n";
+    gzthrow("Faild to parse skinning information in Collada file.");
+  }
 
   for (unsigned int i = 0; i < joints.size(); i++)
   {
-    unsigned int id = i * 16;
+    const double *m = &poses[i * 16];
     math::Matrix4 mat;
-    mat.Set(math::parseFloat(strs[id +  0]), math::parseFloat(strs[id +  1]),
-            math::parseFloat(strs[id +  2]), math::parseFloat(strs[id +  3]),
-            math::parseFloat(strs[id +  4]), math::parseFloat(strs[id +  5]),
-            math::parseFloat(strs[id +  6]), math::parseFloat(strs[id +  7]),
-            math::parseFloat(strs[id +  8]), math::parseFloat(strs[id +  9]),
-            math::parseFloat(strs[id + 10]), math::parseFloat(strs[id + 11]),
-            math::parseFloat(strs[id + 12]), math::parseFloat(strs[id + 13]),
-            math::parseFloat(strs[id + 14]), math::parseFloat(strs[id + 15]));
+    mat.Set(m[0], m[1], m[2], m[3],
+            m[4], m[5], m[6], m[7],
+            m[8], m[9], m[10], m[11],
+            m[12], m[13], m[14], m[15]);
 
     skeleton->GetNodeByName(joints[i])->SetInverseBindTransform(mat);
   }
@@ -397,37 +456,25 @@ void ColladaLoader::LoadController(TiXmlElement *_contrXml,
 
   TiXmlElement *weightsXml = this->GetElementId("source", weightsURL);
 
-  std::string wString = weightsXml->FirstChildElement("float_array")->GetText();
-  std::vector<std::string> wStrs;
-  boost::split(wStrs, wString, boost::is_any_of("   "));
+  std::vector<double> weights;
+  readFloatArray(weightsXml->FirstChildElement("float_array"), weights);
 
-  std::vector<float> weights;
-  for (unsigned int i = 0; i < wStrs.size(); i++)
-    weights.push_back(math::parseFloat(wStrs[i]));
+  std::vector<int> vCount;
+  std::vector<int> v;
 
-  std::string cString = vertWeightsXml->FirstChildElement("vcount")->GetText();
-  std::string vString = vertWeightsXml->FirstChildElement("v")->GetText();
-  std::vector<std::string> vCountStrs;
-  std::vector<std::string> vStrs;
+  int vertCount = 0;
+  if (vertWeightsXml->Attribute("count", &vertCount) && vertCount > 0)
+    vCount.reserve(vertCount);
 
-  boost::split(vCountStrs, cString, boost::is_any_of("   "));
-  boost::split(vStrs, vString, boost::is_any_of("   "));
-
-  std::vector<unsigned int> vCount;
-  std::vector<unsigned int> v;
-
-  for (unsigned int i = 0; i < vCountStrs.size(); i++)
-    vCount.push_back(math::parseInt(vCountStrs[i]));
-
-  for (unsigned int i = 0; i < vStrs.size(); i++)
-    v.push_back(math::parseInt(vStrs[i]));
+  readIntArray(vertWeightsXml->FirstChildElement("vcount"), vCount);
+  readIntArray(vertWeightsXml->FirstChildElement("v"), v);
 
   skeleton->SetNumVertAttached(vCount.size());
 
   unsigned int vIndex = 0;
   for (unsigned int i = 0; i < vCount.size(); i++)
   {
-    for (unsigned int j = 0; j < vCount[i]; j++)
+    for (int j = 0; j < vCount[i]; j++)
     {
       skeleton->AddVertNodeWeight(i, joints[v[vIndex + jOffset]],
                                     weights[v[vIndex + wOffset]]);
@@ -532,23 +579,11 @@ void ColladaLoader::LoadAnimationSet(TiXmlElement *_xml, Skeleton *_skel)
 
         inputXml = inputXml->NextSiblingElement("input");
       }
-      TiXmlElement *timeArray = frameTimesXml->FirstChildElement("float_array");
-      std::string timeStr = timeArray->GetText();
-      std::vector<std::string> timeStrs;
-      boost::split(timeStrs, timeStr, boost::is_any_of("   "));
-
       std::vector<double> times;
-      for (unsigned int i = 0; i < timeStrs.size(); i++)
-        times.push_back(math::parseFloat(timeStrs[i]));
-
-      TiXmlElement *output = frameTransXml->FirstChildElement("float_array");
-      std::string outputStr = output->GetText();
-      std::vector<std::string> outputStrs;
-      boost::split(outputStrs, outputStr, boost::is_any_of("   "));
+      readFloatArray(frameTimesXml->FirstChildElement("float_array"), times);
 
       std::vector<double> values;
-      for (unsigned int i = 0; i < outputStrs.size(); i++)
-        values.push_back(math::parseFloat(outputStrs[i]));
+      readFloatArray(frameTransXml->FirstChildElement("float_array"), values);
 
       TiXmlElement *accessor =
         frameTransXml->FirstChildElement("technique_common");
@@ -839,20 +874,25 @@ void ColladaLoader::LoadPositions(const std::string &_id,
     gzerr << "Vertex source missing float_array element\n";
     return;
   }
-  std::string valueStr = floatArrayXml->GetText();
 
-  std::vector<std::string> strs;
-  std::vector<std::string>::iterator iter, end;
-  boost::split(strs, valueStr, boost::is_any_of("   "));
+  const char *p = floatArrayXml->GetText();
+  if (!p)
+    return;
+
+  // Parse the text in place, straight into the vertex buffer
+  int count = 0;
+  if (floatArrayXml->Attribute("count", &count) && count > 0)
+    _values.reserve(_values.size() + count / 3);
 
-  end = strs.end();
-  for (iter = strs.begin(); iter != end; iter += 3)
+  math::Vector3 vec;
+  while (math::parseNextFloat(p, vec.x) && math::parseNextFloat(p, vec.y) &&
+         math::parseNextFloat(p, vec.z))
   {
-    math::Vector3 vec(math::parseFloat(*iter), math::parseFloat(*(iter+1)),
-        math::parseFloat(*(iter+2)));
-    vec = _transform * vec;
-    _values.push_back(vec);
+    _values.push_back(_transform * vec);
   }
+
+  if (*p)
+    gzerr << "Invalid vertex position in source[" << _id << "]\n";
 }
 
 /////////////////////////////////////////////////
@@ -874,19 +914,26 @@ void ColladaLoader::LoadNormals(const std::string &_id,
     return;
   }
 
-  std::string valueStr = floatArrayXml->GetText();
-  std::istringstream iss(valueStr);
-  do
+  const char *p = floatArrayXml->GetText();
+  if (!p)
+    return;
+
+  // Parse the text in place, straight into the normal buffer
+  int count = 0;
+  if (floatArrayXml->Attribute("count", &count) && count > 0)
+    _values.reserve(_values.size() + count / 3);
+
+  math::Vector3 vec;
+  while (math::parseNextFloat(p, vec.x) && math::parseNextFloat(p, vec.y) &&
+         math::parseNextFloat(p, vec.z))
   {
-    math::Vector3 vec;
-    iss >> vec.x >> vec.y >> vec.z;
-    if (iss)
-    {
-      vec = _transform * vec;
-      vec.Normalize();
-      _values.push_back(vec);
-    }
-  } while (iss);
+    math::Vector3 norm = _transform * vec;
+    norm.Normalize();
+    _values.push_back(norm);
+  }
+
+  if (*p)
+    gzerr << "Invalid normal in source[" << _id << "]\n";
 }
 
 /////////////////////////////////////////////////
@@ -975,17 +1022,35 @@ void ColladaLoader::LoadTexCoords(const std::string &_id,
     return;
   }
 
-  // Read the raw texture values, and split them on spaces.
-  std::string valueStr = floatArrayXml->GetText();
-  std::vector<std::string> values;
-  boost::split(values, valueStr, boost::is_any_of(" "));
+  if (stride < 2)
+  {
+    gzerr << "Texture coordinates with id[" << _id << "] must have a stride "
+          << "of at least 2\n";
+    return;
+  }
+
+  const char *p = floatArrayXml->GetText();
+  if (!p)
+    return;
+
+  _values.reserve(_values.size() + texCount);
 
-  // Read in all the texture coordinates.
-  for (int i = 0; i < totCount; i += stride)
+  // Read in all the texture coordinates, parsing the raw values in place.
+  for (int i = 0; i < texCount; ++i)
   {
     // We only handle 2D texture coordinates right now.
-    _values.push_back(math::Vector2d(boost::lexical_cast<double>(values[i]),
-          1.0 - boost::lexical_cast<double>(values[i+1])));
+    double u, v, unused;
+    if (!math::parseNextFloat(p, u) || !math::parseNextFloat(p, v))
+    {
+      gzerr << "Invalid texture coordinate in element with id["
+            << _id << "]\n";
+      return;
+    }
+
+    for (int j = 2; j < stride; ++j)
+      math::parseNextFloat(p, unused);
+
+    _values.push_back(math::Vector2d(u, 1.0 - v));
   }
 }
 
@@ -1214,34 +1279,47 @@ void ColladaLoader::LoadPolylist(TiXmlElement *_polylistXml,
   // break poly into triangles
   // if vcount >= 4, anchor around 0 (note this is bad for concave elements)
   //   e.g. if vcount = 4, break into triangle 1: [0,1,2], triangle 2: [0,2,3]
-  std::vector<std::string> vcountStrs;
   TiXmlElement *vcountXml = _polylistXml->FirstChildElement("vcount");
-  std::string vcountStr = vcountXml->GetText();
-  boost::split(vcountStrs, vcountStr, boost::is_any_of("   "));
-  std::vector<int> vcounts;
-  for (unsigned int j = 0; j < vcountStrs.size(); ++j)
-    vcounts.push_back(math::parseInt(vcountStrs[j]));
-
-  // read p
   TiXmlElement *pXml = _polylistXml->FirstChildElement("p");
-  std::string pStr = pXml->GetText();
+  if (!vcountXml || !pXml || !pXml->GetText())
+  {
+    gzerr << "Collada file[" << this->filename
+          << "] is invalid. Loading what we can...\n";
+    delete subMesh;
+    return;
+  }
+
+  std::vector<int> vcounts;
+  int polyCount = 0;
+  if (_polylistXml->Attribute("count", &polyCount) && polyCount > 0)
+    vcounts.reserve(polyCount);
+  readIntArray(vcountXml, vcounts);
 
-  std::vector<math::Vector3> vertNorms(verts.size());
-  std::vector<int> vertNormsCounts(verts.size());
-  std::fill(vertNormsCounts.begin(), vertNormsCounts.end(), 0);
+  // read p, one polygon at a time
+  const char *p = pXml->GetText();
 
   int *values = new int[inputs.size()];
   std::map<std::string, int>::iterator end = inputs.end();
   std::map<std::string, int>::iterator iter;
-  math::Vector2d vec;
 
-  std::vector<std::string> strs;
-  boost::split(strs, pStr, boost::is_any_of("   "));
-  std::vector<std::string>::iterator strs_iter = strs.begin();
+  // Indices of the current polygon. Only grows, so this allocates once per
+  // distinct polygon size at most.
+  std::vector<int> polyValues;
   for (unsigned int l = 0; l < vcounts.size(); ++l)
   {
-    // put us at the beginning of the polygon list
-    if (l > 0) strs_iter += inputs.size()*vcounts[l-1];
+    unsigned int polySize = inputs.size() * vcounts[l];
+    if (polySize == 0)
+      continue;
+
+    if (polyValues.size() < polySize)
+      polyValues.resize(polySize);
+
+    if (!parseNextInts(p, &polyValues[0], polySize))
+    {
+      gzerr << "Collada file[" << this->filename
+            << "] has an invalid <p> element. Loading what we can...\n";
+      break;
+    }
 
     for (unsigned int k = 2; k < (unsigned int)vcounts[l]; ++k)
     {
@@ -1262,7 +1340,7 @@ void ColladaLoader::LoadPolylist(TiXmlElement *_polylistXml,
 
         for (unsigned int i = 0; i < inputs.size(); i++)
         {
-          values[i] = math::parseInt(strs_iter[triangle_index+i]);
+          values[i] = polyValues[triangle_index+i];
           /*gzerr << "debug parsing "
                 << " poly-i[" << l
                 << "] tri-end-index[" << k
@@ -1384,25 +1462,17 @@ void ColladaLoader::LoadTriangles(TiXmlElement *_trianglesXml,
           << "] is invalid. Loading what we can...\n";
     return;
   }
-  std::string pStr = pXml->GetText();
 
-  std::vector<math::Vector3> vertNorms(verts.size());
-  std::vector<int> vertNormsCounts(verts.size());
-  std::fill(vertNormsCounts.begin(), vertNormsCounts.end(), 0);
+  // Parse the <p> element in place, one vertex's worth of indices at a time
+  const char *p = pXml->GetText();
+  unsigned int inputCount = inputs.size();
 
-  int *values = new int[inputs.size()];
+  int *values = new int[inputCount];
   std::list<std::pair<std::string, int> >::iterator end = inputs.end();
   std::list<std::pair<std::string, int> >::iterator iter;
-  math::Vector2d vec;
 
-  std::vector<std::string> strs;
-  boost::split(strs, pStr, boost::is_any_of("   "));
-
-  for (unsigned int j = 0; j < strs.size(); j += inputs.size())
+  while (inputCount > 0 && parseNextInts(p, values, inputCount))
   {
-    for (unsigned int i = 0; i < inputs.size(); i++)
-      values[i] = math::parseInt(strs[j+i]);
-
     bool already = false;
     for (iter = inputs.begin(); iter != end; ++iter)
     {
@@ -1443,6 +1513,12 @@ void ColladaLoader::LoadTriangles(TiXmlElement *_trianglesXml,
   }
   delete [] values;
 
+  if (*p)
+  {
+    gzerr << "Collada file[" << this->filename
+          << "] has an invalid <p> element. Loading what we can...\n";
+  }
+
   _mesh->AddSubMesh(subMesh);
 }
 
@@ -1464,21 +1540,16 @@ void ColladaLoader::LoadLines(TiXmlElement *_xml,
   this->LoadVertices(source, _transform, verts, norms);
 
   TiXmlElement *pXml = _xml->FirstChildElement("p");
-  std::string pStr = pXml->GetText();
-  std::istringstream iss(pStr);
+  const char *p = pXml ? pXml->GetText() : NULL;
 
-  do
+  int line[2];
+  while (p && parseNextInts(p, line, 2))
   {
-    int a, b;
-    iss >> a >> b;
-
-    if (!iss)
-      break;
-    subMesh->AddVertex(verts[a]);
+    subMesh->AddVertex(verts[line[0]]);
     subMesh->AddIndex(subMesh->GetVertexCount() - 1);
-    subMesh->AddVertex(verts[b]);
+    subMesh->AddVertex(verts[line[1]]);
     subMesh->AddIndex(subMesh->GetVertexCount() - 1);
-  } while (iss);
+  }
 
   _mesh->AddSubMesh(subMesh);
 }
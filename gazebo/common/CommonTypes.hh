@@ -96,6 +96,7 @@ namespace gazebo
     class Param;
     class PoseAnimation;
     class SkeletonAnimation;
+    class SnapshotBuffer;
     class Time;
 
     template <typename T>
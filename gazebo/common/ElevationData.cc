@@ -0,0 +1,264 @@
+/*
+ * Copyright 2012 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/math/Helpers.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Image.hh"
+#include "gazebo/common/ElevationData.hh"
+
+using namespace gazebo;
+using namespace common;
+
+//////////////////////////////////////////////////
+/// \brief Return true if this machine is little endian
+static bool isLittleEndian()
+{
+  uint16_t value = 1;
+  return *reinterpret_cast<unsigned char*>(&value) == 1;
+}
+
+//////////////////////////////////////////////////
+ElevationData::ElevationData()
+  : size(0), sampleBytes(0), minValue(0), maxValue(0)
+{
+}
+
+//////////////////////////////////////////////////
+ElevationData::~ElevationData()
+{
+}
+
+//////////////////////////////////////////////////
+bool ElevationData::IsRawFile(const std::string &_filename)
+{
+  std::string extension = boost::filesystem::extension(_filename);
+  std::transform(extension.begin(), extension.end(),
+                 extension.begin(), ::tolower);
+  return extension == ".r16" || extension == ".r32";
+}
+
+//////////////////////////////////////////////////
+bool ElevationData::Load(const std::string &_filename)
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+
+  this->size = 0;
+  this->sampleBytes = 0;
+  this->imageValues.clear();
+  if (this->file.is_open())
+    this->file.close();
+
+  if (!IsRawFile(_filename))
+  {
+    Image img;
+    if (img.Load(_filename) != 0)
+      return false;
+
+    if (img.GetWidth() != img.GetHeight())
+    {
+      gzerr << "Elevation image[" << _filename << "] must be square\n";
+      return false;
+    }
+
+    this->size = img.GetWidth();
+
+    // Bytes per row and per pixel
+    unsigned int pitch = img.GetPitch();
+    unsigned int bpp = pitch / this->size;
+
+    unsigned char *data = NULL;
+    unsigned int count;
+    img.GetData(&data, count);
+
+    this->imageValues.resize(this->size * this->size);
+    this->minValue = GZ_FLT_MAX;
+    this->maxValue = -GZ_FLT_MAX;
+    for (unsigned int y = 0; y < this->size; ++y)
+    {
+      for (unsigned int x = 0; x < this->size; ++x)
+      {
+        float value = data[y * pitch + x * bpp] / 255.0f;
+        this->imageValues[y * this->size + x] = value;
+        this->minValue = std::min(this->minValue, value);
+        this->maxValue = std::max(this->maxValue, value);
+      }
+    }
+
+    delete [] data;
+    return true;
+  }
+
+  std::string extension = boost::filesystem::extension(_filename);
+  std::transform(extension.begin(), extension.end(),
+                 extension.begin(), ::tolower);
+  this->sampleBytes = extension == ".r16" ? 2 : 4;
+
+  this->file.open(_filename.c_str(), std::ios::in | std::ios::binary);
+  if (!this->file.is_open())
+  {
+    gzerr << "Unable to open elevation file[" << _filename << "]\n";
+    return false;
+  }
+
+  // The grid is square, so the number of samples along a side is the
+  // square root of the number of samples in the file.
+  this->file.seekg(0, std::ios::end);
+  uint64_t sampleCount =
+    static_cast<uint64_t>(this->file.tellg()) / this->sampleBytes;
+  this->size = static_cast<unsigned int>(sqrt(static_cast<double>(
+          sampleCount)) + 0.5);
+
+  if (this->size < 2 ||
+      static_cast<uint64_t>(this->size) * this->size != sampleCount)
+  {
+    gzerr << "Elevation file[" << _filename << "] does not hold a square "
+          << "grid of samples\n";
+    this->size = 0;
+    this->file.close();
+    return false;
+  }
+
+  // Find the range of the samples, one row at a time
+  this->rowBuffer.resize(this->size * this->sampleBytes);
+  std::vector<float> row(this->size);
+  this->minValue = GZ_FLT_MAX;
+  this->maxValue = -GZ_FLT_MAX;
+
+  this->file.seekg(0, std::ios::beg);
+  for (unsigned int y = 0; y < this->size; ++y)
+  {
+    if (!this->file.read(&this->rowBuffer[0], this->rowBuffer.size()))
+    {
+      gzerr << "Unable to read elevation file[" << _filename << "]\n";
+      this->size = 0;
+      this->file.close();
+      return false;
+    }
+
+    this->ConvertSamples(&this->rowBuffer[0], this->size, &row[0]);
+    for (unsigned int x = 0; x < this->size; ++x)
+    {
+      this->minValue = std::min(this->minValue, row[x]);
+      this->maxValue = std::max(this->maxValue, row[x]);
+    }
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void ElevationData::ConvertSamples(const char *_data, unsigned int _count,
+                                   float *_values) const
+{
+  bool swap = !isLittleEndian();
+
+  if (this->sampleBytes == 2)
+  {
+    for (unsigned int i = 0; i < _count; ++i)
+    {
+      uint16_t sample;
+      memcpy(&sample, _data + i * 2, 2);
+      if (swap)
+        sample = static_cast<uint16_t>((sample << 8) | (sample >> 8));
+      _values[i] = sample / 65535.0f;
+    }
+  }
+  else
+  {
+    for (unsigned int i = 0; i < _count; ++i)
+    {
+      char bytes[4];
+      memcpy(bytes, _data + i * 4, 4);
+      if (swap)
+      {
+        std::swap(bytes[0], bytes[3]);
+        std::swap(bytes[1], bytes[2]);
+      }
+      memcpy(&_values[i], bytes, 4);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int ElevationData::GetSize() const
+{
+  return this->size;
+}
+
+//////////////////////////////////////////////////
+float ElevationData::GetMinValue() const
+{
+  return this->minValue;
+}
+
+//////////////////////////////////////////////////
+float ElevationData::GetMaxValue() const
+{
+  return this->maxValue;
+}
+
+//////////////////////////////////////////////////
+bool ElevationData::HasMetricValues() const
+{
+  return this->sampleBytes == 4;
+}
+
+//////////////////////////////////////////////////
+bool ElevationData::GetValues(unsigned int _x, unsigned int _y,
+    unsigned int _width, unsigned int _height, float *_values) const
+{
+  if (_x + _width > this->size || _y + _height > this->size)
+    return false;
+
+  if (_width == 0 || _height == 0)
+    return true;
+
+  if (!this->imageValues.empty())
+  {
+    for (unsigned int y = 0; y < _height; ++y)
+    {
+      memcpy(_values + y * _width,
+             &this->imageValues[(_y + y) * this->size + _x],
+             _width * sizeof(float));
+    }
+    return true;
+  }
+
+  boost::mutex::scoped_lock lock(this->mutex);
+
+  this->rowBuffer.resize(_width * this->sampleBytes);
+  for (unsigned int y = 0; y < _height; ++y)
+  {
+    uint64_t offset = (static_cast<uint64_t>(_y + y) * this->size + _x) *
+      this->sampleBytes;
+    this->file.seekg(offset, std::ios::beg);
+    if (!this->file.read(&this->rowBuffer[0], this->rowBuffer.size()))
+    {
+      this->file.clear();
+      return false;
+    }
+    this->ConvertSamples(&this->rowBuffer[0], _width, _values + y * _width);
+  }
+
+  return true;
+}
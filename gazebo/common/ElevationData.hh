@@ -0,0 +1,127 @@
+/*
+ * Copyright 2012 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _ELEVATIONDATA_HH_
+#define _ELEVATIONDATA_HH_
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \class ElevationData ElevationData.hh common/common.hh
+    /// \brief Square grid of elevation samples, read from a file.
+    ///
+    /// The following formats are supported:
+    /// - .r16: Headerless grid of unsigned 16 bit little endian samples.
+    /// - .r32: Headerless grid of 32 bit little endian floats, in meters.
+    /// - Any image format supported by common::Image. The first channel
+    /// is used.
+    ///
+    /// Raw files are not loaded into memory. Samples are read from the
+    /// file when they are requested, so very large grids can be used. The
+    /// number of samples along a side of a raw grid is computed from the
+    /// file size.
+    class ElevationData
+    {
+      /// \brief Constructor
+      public: ElevationData();
+
+      /// \brief Destructor
+      public: virtual ~ElevationData();
+
+      /// \brief Check if a file is a raw elevation file.
+      /// \param[in] _filename Name of the file.
+      /// \return True if the file has a .r16 or .r32 extension.
+      public: static bool IsRawFile(const std::string &_filename);
+
+      /// \brief Load elevation data.
+      /// \param[in] _filename Full path to the file.
+      /// \return True on success.
+      public: bool Load(const std::string &_filename);
+
+      /// \brief Get the number of samples along each side of the grid.
+      /// \return Number of samples along each side.
+      public: unsigned int GetSize() const;
+
+      /// \brief Get the smallest sample value.
+      /// \return The smallest sample value.
+      public: float GetMinValue() const;
+
+      /// \brief Get the largest sample value.
+      /// \return The largest sample value.
+      public: float GetMaxValue() const;
+
+      /// \brief Return true if the samples are heights in meters. If false,
+      /// the samples are normalized to the range [0, 1].
+      /// \return True for 32 bit float data.
+      public: bool HasMetricValues() const;
+
+      /// \brief Read a rectangular block of samples.
+      /// \param[in] _x Column of the first sample.
+      /// \param[in] _y Row of the first sample.
+      /// \param[in] _width Number of columns to read.
+      /// \param[in] _height Number of rows to read.
+      /// \param[out] _values Array of _width * _height values, filled in
+      /// row major order.
+      /// \return False if the block is outside the grid, or the file could
+      /// not be read.
+      public: bool GetValues(unsigned int _x, unsigned int _y,
+                             unsigned int _width, unsigned int _height,
+                             float *_values) const;
+
+      /// \brief Convert raw samples from the file to floats.
+      /// \param[in] _data Raw samples.
+      /// \param[in] _count Number of samples.
+      /// \param[out] _values Converted values.
+      private: void ConvertSamples(const char *_data, unsigned int _count,
+                                   float *_values) const;
+
+      /// \brief Number of samples along each side.
+      private: unsigned int size;
+
+      /// \brief Number of bytes of a raw sample, 0 for images.
+      private: unsigned int sampleBytes;
+
+      /// \brief Smallest sample value.
+      private: float minValue;
+
+      /// \brief Largest sample value.
+      private: float maxValue;
+
+      /// \brief Samples of an image, empty for raw files.
+      private: std::vector<float> imageValues;
+
+      /// \brief Raw elevation file.
+      private: mutable std::ifstream file;
+
+      /// \brief Buffer used to read rows of raw samples.
+      private: mutable std::vector<char> rowBuffer;
+
+      /// \brief Protects the file and the row buffer.
+      private: mutable boost::mutex mutex;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <fstream>
+
+#include "gazebo/common/ElevationData.hh"
+
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+TEST(ElevationDataTest, Raw16)
+{
+  // 5x5 grid where each sample is its index
+  std::ofstream out("/tmp/gazebo_elevation_test.r16",
+                    std::ios::out | std::ios::binary);
+  for (uint16_t i = 0; i < 25; ++i)
+  {
+    unsigned char bytes[2] = {static_cast<unsigned char>(i * 100 & 0xff),
+                              static_cast<unsigned char>(i * 100 >> 8)};
+    out.write(reinterpret_cast<char*>(bytes), 2);
+  }
+  out.close();
+
+  EXPECT_TRUE(common::ElevationData::IsRawFile("a.r16"));
+  EXPECT_TRUE(common::ElevationData::IsRawFile("a.R32"));
+  EXPECT_FALSE(common::ElevationData::IsRawFile("a.png"));
+
+  common::ElevationData data;
+  EXPECT_TRUE(data.Load("/tmp/gazebo_elevation_test.r16"));
+  EXPECT_EQ(5u, data.GetSize());
+  EXPECT_FALSE(data.HasMetricValues());
+  EXPECT_FLOAT_EQ(0.0f, data.GetMinValue());
+  EXPECT_FLOAT_EQ(2400 / 65535.0f, data.GetMaxValue());
+
+  // Read a 2x3 block starting at column 1, row 2
+  float values[6];
+  EXPECT_TRUE(data.GetValues(1, 2, 2, 3, values));
+  EXPECT_FLOAT_EQ(1100 / 65535.0f, values[0]);
+  EXPECT_FLOAT_EQ(1200 / 65535.0f, values[1]);
+  EXPECT_FLOAT_EQ(1600 / 65535.0f, values[2]);
+  EXPECT_FLOAT_EQ(2200 / 65535.0f, values[5]);
+
+  // Blocks outside the grid are rejected
+  EXPECT_FALSE(data.GetValues(4, 0, 2, 1, values));
+}
+
+/////////////////////////////////////////////////
+TEST(ElevationDataTest, Raw32)
+{
+  std::ofstream out("/tmp/gazebo_elevation_test.r32",
+                    std::ios::out | std::ios::binary);
+  for (int i = 0; i < 9; ++i)
+  {
+    float value = -10.0f + i * 2.5f;
+    out.write(reinterpret_cast<char*>(&value), sizeof(value));
+  }
+  out.close();
+
+  common::ElevationData data;
+  EXPECT_TRUE(data.Load("/tmp/gazebo_elevation_test.r32"));
+  EXPECT_EQ(3u, data.GetSize());
+  EXPECT_TRUE(data.HasMetricValues());
+  EXPECT_FLOAT_EQ(-10.0f, data.GetMinValue());
+  EXPECT_FLOAT_EQ(10.0f, data.GetMaxValue());
+
+  float values[9];
+  EXPECT_TRUE(data.GetValues(0, 0, 3, 3, values));
+  for (int i = 0; i < 9; ++i)
+    EXPECT_FLOAT_EQ(-10.0f + i * 2.5f, values[i]);
+
+  // A file that does not hold a square grid fails to load
+  out.open("/tmp/gazebo_elevation_test.r32",
+           std::ios::out | std::ios::binary | std::ios::app);
+  out.write(reinterpret_cast<char*>(values), sizeof(float));
+  out.close();
+  EXPECT_FALSE(data.Load("/tmp/gazebo_elevation_test.r32"));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Histogram.hh"
+
+using namespace gazebo;
+using namespace common;
+
+//////////////////////////////////////////////////
+Histogram::Histogram(unsigned int _precision)
+  : precision(_precision), count(0), min(0), max(0), sum(0)
+{
+  if (this->precision < 1 || this->precision > 16)
+  {
+    gzerr << "Histogram precision[" << _precision
+          << "] must be between 1 and 16, using 7\n";
+    this->precision = 7;
+  }
+
+  // Values below 2^precision have a bucket each, then each power of two
+  // above is split in 2^(precision-1) buckets.
+  uint64_t exact = 1ull << this->precision;
+  this->counts.resize(exact + (64 - this->precision) * (exact / 2), 0);
+}
+
+//////////////////////////////////////////////////
+Histogram::~Histogram()
+{
+}
+
+//////////////////////////////////////////////////
+unsigned int Histogram::GetBucket(uint64_t _value) const
+{
+  uint64_t exact = 1ull << this->precision;
+  if (_value < exact)
+    return static_cast<unsigned int>(_value);
+
+  // Keep the highest precision bits of the value
+  unsigned int highBit = 63 - __builtin_clzll(_value);
+  unsigned int shift = highBit - this->precision + 1;
+  uint64_t sub = _value >> shift;
+
+  return static_cast<unsigned int>(exact + (shift - 1) * (exact / 2) +
+                                   (sub - exact / 2));
+}
+
+//////////////////////////////////////////////////
+uint64_t Histogram::GetBucketMax(unsigned int _bucket) const
+{
+  uint64_t exact = 1ull << this->precision;
+  if (_bucket < exact)
+    return _bucket;
+
+  uint64_t index = _bucket - exact;
+  unsigned int shift = static_cast<unsigned int>(index / (exact / 2)) + 1;
+  uint64_t sub = index % (exact / 2) + exact / 2;
+
+  // Wraps to the largest 64 bit value for the last bucket
+  return ((sub + 1) << shift) - 1;
+}
+
+//////////////////////////////////////////////////
+void Histogram::Add(uint64_t _value)
+{
+  this->counts[this->GetBucket(_value)]++;
+
+  if (this->count == 0 || _value < this->min)
+    this->min = _value;
+  if (this->count == 0 || _value > this->max)
+    this->max = _value;
+
+  this->count++;
+  this->sum += static_cast<double>(_value);
+}
+
+//////////////////////////////////////////////////
+void Histogram::Add(const Histogram &_other)
+{
+  if (_other.precision != this->precision)
+  {
+    gzerr << "Unable to add histograms of different precisions\n";
+    return;
+  }
+
+  if (_other.count == 0)
+    return;
+
+  for (unsigned int i = 0; i < this->counts.size(); ++i)
+    this->counts[i] += _other.counts[i];
+
+  if (this->count == 0 || _other.min < this->min)
+    this->min = _other.min;
+  if (this->count == 0 || _other.max > this->max)
+    this->max = _other.max;
+
+  this->count += _other.count;
+  this->sum += _other.sum;
+}
+
+//////////////////////////////////////////////////
+void Histogram::Reset()
+{
+  if (this->count == 0)
+    return;
+
+  std::fill(this->counts.begin(), this->counts.end(), 0);
+  this->count = 0;
+  this->min = 0;
+  this->max = 0;
+  this->sum = 0;
+}
+
+//////////////////////////////////////////////////
+uint64_t Histogram::GetCount() const
+{
+  return this->count;
+}
+
+//////////////////////////////////////////////////
+uint64_t Histogram::GetMin() const
+{
+  return this->min;
+}
+
+//////////////////////////////////////////////////
+uint64_t Histogram::GetMax() const
+{
+  return this->max;
+}
+
+//////////////////////////////////////////////////
+double Histogram::GetMean() const
+{
+  if (this->count == 0)
+    return 0;
+  return this->sum / this->count;
+}
+
+//////////////////////////////////////////////////
+uint64_t Histogram::GetPercentile(double _percent) const
+{
+  if (this->count == 0)
+    return 0;
+
+  _percent = std::max(0.0, std::min(100.0, _percent));
+
+  // Rank of the value at the percentile, starting at 1
+  uint64_t rank = static_cast<uint64_t>(_percent / 100.0 * this->count + 0.5);
+  rank = std::max(static_cast<uint64_t>(1), std::min(this->count, rank));
+
+  uint64_t seen = 0;
+  for (unsigned int i = 0; i < this->counts.size(); ++i)
+  {
+    seen += this->counts[i];
+    if (seen >= rank)
+      return std::max(this->min, std::min(this->max, this->GetBucketMax(i)));
+  }
+
+  return this->max;
+}
+
+//////////////////////////////////////////////////
+unsigned int Histogram::GetPrecision() const
+{
+  return this->precision;
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _HISTOGRAM_HH_
+#define _HISTOGRAM_HH_
+
+#include <stdint.h>
+#include <vector>
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \class Histogram Histogram.hh common/common.hh
+    /// \brief Histogram of non-negative integer values with a bounded
+    /// relative error, used to compute percentiles of timings.
+    ///
+    /// Values below 2^precision are counted exactly. Larger values fall
+    /// in buckets whose width doubles with every power of two, so each
+    /// bucket covers values within 2^(1-precision) of each other. Adding
+    /// a value takes constant time and never allocates memory.
+    class Histogram
+    {
+      /// \brief Constructor
+      /// \param[in] _precision Number of significant bits kept for each
+      /// value, between 1 and 16.
+      public: explicit Histogram(unsigned int _precision = 7);
+
+      /// \brief Destructor
+      public: virtual ~Histogram();
+
+      /// \brief Count a value.
+      /// \param[in] _value Value to count.
+      public: void Add(uint64_t _value);
+
+      /// \brief Count all the values of another histogram. Both
+      /// histograms must have the same precision.
+      /// \param[in] _other Histogram to add.
+      public: void Add(const Histogram &_other);
+
+      /// \brief Remove all the values.
+      public: void Reset();
+
+      /// \brief Get the number of values.
+      /// \return Number of values counted since the last reset.
+      public: uint64_t GetCount() const;
+
+      /// \brief Get the smallest value.
+      /// \return Smallest value, 0 if the histogram is empty.
+      public: uint64_t GetMin() const;
+
+      /// \brief Get the largest value.
+      /// \return Largest value, 0 if the histogram is empty.
+      public: uint64_t GetMax() const;
+
+      /// \brief Get the mean of the values.
+      /// \return Mean value, 0 if the histogram is empty.
+      public: double GetMean() const;
+
+      /// \brief Get a percentile of the values. The result is the largest
+      /// value of the bucket that holds the percentile, limited to the
+      /// range of the counted values.
+      /// \param[in] _percent Percentile, between 0 and 100.
+      /// \return Value at the percentile, 0 if the histogram is empty.
+      public: uint64_t GetPercentile(double _percent) const;
+
+      /// \brief Get the precision given to the constructor.
+      /// \return Number of significant bits.
+      public: unsigned int GetPrecision() const;
+
+      /// \brief Get the bucket that holds a value.
+      /// \param[in] _value A value.
+      /// \return Index of the bucket.
+      private: unsigned int GetBucket(uint64_t _value) const;
+
+      /// \brief Get the largest value that falls in a bucket.
+      /// \param[in] _bucket Index of the bucket.
+      /// \return Largest value of the bucket.
+      private: uint64_t GetBucketMax(unsigned int _bucket) const;
+
+      /// \brief Number of significant bits.
+      private: unsigned int precision;
+
+      /// \brief Number of values counted in each bucket.
+      private: std::vector<uint64_t> counts;
+
+      /// \brief Number of values.
+      private: uint64_t count;
+
+      /// \brief Smallest value.
+      private: uint64_t min;
+
+      /// \brief Largest value.
+      private: uint64_t max;
+
+      /// \brief Sum of the values, used for the mean.
+      private: double sum;
+    };
+    /// \}
+  }
+}
+#endif
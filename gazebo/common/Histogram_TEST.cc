@@ -0,0 +1,112 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "gazebo/common/Histogram.hh"
+
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+TEST(HistogramTest, Empty)
+{
+  common::Histogram hist;
+  EXPECT_EQ(0u, hist.GetCount());
+  EXPECT_EQ(0u, hist.GetMin());
+  EXPECT_EQ(0u, hist.GetMax());
+  EXPECT_DOUBLE_EQ(0.0, hist.GetMean());
+  EXPECT_EQ(0u, hist.GetPercentile(50));
+}
+
+/////////////////////////////////////////////////
+TEST(HistogramTest, ExactValues)
+{
+  // Values below 2^precision are exact
+  common::Histogram hist(7);
+  for (uint64_t i = 1; i <= 100; ++i)
+    hist.Add(i);
+
+  EXPECT_EQ(100u, hist.GetCount());
+  EXPECT_EQ(1u, hist.GetMin());
+  EXPECT_EQ(100u, hist.GetMax());
+  EXPECT_DOUBLE_EQ(50.5, hist.GetMean());
+  EXPECT_EQ(50u, hist.GetPercentile(50));
+  EXPECT_EQ(95u, hist.GetPercentile(95));
+  EXPECT_EQ(99u, hist.GetPercentile(99));
+  EXPECT_EQ(100u, hist.GetPercentile(100));
+  EXPECT_EQ(1u, hist.GetPercentile(0));
+
+  hist.Reset();
+  EXPECT_EQ(0u, hist.GetCount());
+  EXPECT_EQ(0u, hist.GetPercentile(50));
+}
+
+/////////////////////////////////////////////////
+TEST(HistogramTest, RelativeError)
+{
+  // One millisecond to one second in nanoseconds
+  common::Histogram hist(7);
+  for (uint64_t i = 1; i <= 1000; ++i)
+    hist.Add(i * 1000000);
+
+  EXPECT_EQ(1000000u, hist.GetMin());
+  EXPECT_EQ(1000000000u, hist.GetMax());
+
+  // Percentiles are within the bucket width of the exact value
+  double percents[] = {10, 50, 90, 99, 99.9};
+  for (unsigned int i = 0; i < sizeof(percents) / sizeof(percents[0]); ++i)
+  {
+    double expected = percents[i] * 10 * 1e6;
+    double value = static_cast<double>(hist.GetPercentile(percents[i]));
+    EXPECT_GE(value, expected);
+    EXPECT_LE(value, expected * (1 + 1.0 / 64));
+  }
+
+  // The largest values still work
+  hist.Add(0xffffffffffffffffull);
+  EXPECT_EQ(0xffffffffffffffffull, hist.GetPercentile(100));
+}
+
+/////////////////////////////////////////////////
+TEST(HistogramTest, Merge)
+{
+  common::Histogram a, b, c(5);
+  for (uint64_t i = 0; i < 10; ++i)
+  {
+    a.Add(i);
+    b.Add(i + 1000);
+  }
+
+  a.Add(b);
+  EXPECT_EQ(20u, a.GetCount());
+  EXPECT_EQ(0u, a.GetMin());
+  EXPECT_EQ(1009u, a.GetMax());
+  EXPECT_EQ(9u, a.GetPercentile(50));
+
+  // Different precisions are not merged
+  a.Add(c);
+  c.Add(1);
+  a.Add(c);
+  EXPECT_EQ(20u, a.GetCount());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
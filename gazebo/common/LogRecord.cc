@@ -389,6 +389,15 @@ bool LogRecord::GetFirstUpdate() const
   return this->firstUpdate;
 }
 
+//////////////////////////////////////////////////
+bool LogRecord::GetFirstUpdate(const std::string &_name) const
+{
+  // The write mutex is already held by Update, which runs the log
+  // callbacks
+  Log_M::const_iterator iter = this->logs.find(_name);
+  return iter != this->logs.end() && iter->second->firstUpdate;
+}
+
 //////////////////////////////////////////////////
 void LogRecord::Update(const common::UpdateInfo &_info)
 {
@@ -399,11 +408,21 @@ void LogRecord::Update(const common::UpdateInfo &_info)
     {
       boost::mutex::scoped_lock lock(this->writeMutex);
 
-      // Collect all the new log data. This will not write data to disk.
+      // Collect all the new log data of the world that is updated. This
+      // will not write data to disk.
       for (this->updateIter = this->logs.begin();
           this->updateIter != this->logsEnd; ++this->updateIter)
       {
+        const std::string &name = this->updateIter->first;
+        if (name != _info.worldName &&
+            name.compare(0, _info.worldName.size() + 2,
+                         _info.worldName + "::") != 0)
+        {
+          continue;
+        }
+
         size += this->updateIter->second->Update();
+        this->updateIter->second->firstUpdate = false;
       }
     }
 
@@ -463,6 +482,7 @@ LogRecord::Log::Log(LogRecord *_parent, const std::string &_relativeFilename,
 {
   this->parent = _parent;
   this->logCB = _logCB;
+  this->firstUpdate = true;
 
   this->relativeFilename = _relativeFilename;
   std::ostringstream stream;
@@ -480,6 +500,20 @@ LogRecord::Log::Log(LogRecord *_parent, const std::string &_relativeFilename,
 //////////////////////////////////////////////////
 LogRecord::Log::~Log()
 {
+  // Write the data collected since the last pass of the write thread, so
+  // that stopping a recording doesn't lose its end
+  if (!this->completePath.empty() && !this->buffer.empty())
+  {
+    try
+    {
+      this->Write();
+    }
+    catch(common::Exception &_e)
+    {
+      gzerr << "Unable to write the end of a log: " << _e << "\n";
+    }
+  }
+
   std::string xmlEnd = "</gazebo_log>";
   this->logFile.write(xmlEnd.c_str(), xmlEnd.size());
 
@@ -563,6 +597,7 @@ void LogRecord::Log::Start(const boost::filesystem::path &_path)
 {
   // Make the full path for the log file
   this->completePath = _path / this->relativeFilename;
+  this->firstUpdate = true;
 
   // Make sure the file does not exist
   if (boost::filesystem::exists(this->completePath))
@@ -59,7 +59,9 @@ namespace gazebo
     /// specifying different filenames for the LogRecord::Add function.
     ///
     /// The LogRecord is updated at the start of each simulation step. This
-    /// guarantees that all data is stored.
+    /// guarantees that all data is stored. A step of a world only updates
+    /// the logs named after that world, or scoped in it, such as
+    /// "world_name::model_name".
     ///
     /// \sa Logplay, State
     class LogRecord : public SingletonT<LogRecord>
@@ -159,6 +161,13 @@ namespace gazebo
       /// \return True if an Update has not yet been completed.
       public: bool GetFirstUpdate() const;
 
+      /// \brief Return true if a log has not been updated since it was
+      /// started. This may only be called from the log callbacks, while
+      /// the logs are updated.
+      /// \param[in] _name Name of the log object.
+      /// \return True if the log named _name has not been updated yet.
+      public: bool GetFirstUpdate(const std::string &_name) const;
+
       /// \brief Update the log files
       ///
       /// Captures the current state of all registered entities, and outputs
@@ -231,6 +240,9 @@ namespace gazebo
         /// \brief Relative log filename.
         public: std::string relativeFilename;
 
+        /// \brief True until the log is updated for the first time.
+        public: bool firstUpdate;
+
         private: boost::filesystem::path completePath;
       };
       /// \endcond
@@ -17,6 +17,8 @@
 #include <float.h>
 #include <string.h>
 #include <algorithm>
+#include <boost/functional/hash.hpp>
+#include <boost/unordered_map.hpp>
 
 #include "gazebo/math/Helpers.hh"
 
@@ -30,6 +32,34 @@
 using namespace gazebo;
 using namespace common;
 
+/// \brief Position, normal and texture coordinate of a vertex, used to
+/// find duplicate vertices.
+struct WeldKey
+{
+  /// \brief The attributes, zero when missing.
+  double values[8];
+
+  /// \brief Equality operator.
+  /// \param[in] _key Key to compare to.
+  /// \return True if all the attributes are equal.
+  bool operator==(const WeldKey &_key) const
+  {
+    for (int i = 0; i < 8; ++i)
+    {
+      if (this->values[i] != _key.values[i])
+        return false;
+    }
+    return true;
+  }
+};
+
+/// \brief Hash of a WeldKey, equal for values that compare equal.
+/// \param[in] _key The key.
+/// \return The hash.
+static size_t hash_value(const WeldKey &_key)
+{
+  return boost::hash_range(_key.values, _key.values + 8);
+}
 
 //////////////////////////////////////////////////
 Mesh::Mesh()
@@ -391,6 +421,15 @@ void Mesh::Translate(const math::Vector3 &_vec)
   }
 }
 
+//////////////////////////////////////////////////
+void Mesh::Weld()
+{
+  std::vector<SubMesh*>::iterator iter;
+
+  for (iter = this->submeshes.begin(); iter != this->submeshes.end(); ++iter)
+    (*iter)->Weld();
+}
+
 //////////////////////////////////////////////////
 //////////////////////////////////////////////////
 
@@ -896,6 +935,79 @@ void SubMesh::Translate(const math::Vector3 &_vec)
   }
 }
 
+//////////////////////////////////////////////////
+void SubMesh::Weld()
+{
+  if (this->indices.empty() || !this->nodeAssignments.empty())
+    return;
+
+  bool hasNormals = this->normals.size() == this->vertices.size();
+  bool hasTexCoords = this->texCoords.size() == this->vertices.size();
+
+  // Per vertex attributes that don't line up with the vertices can't be
+  // merged safely.
+  if ((!this->normals.empty() && !hasNormals) ||
+      (!this->texCoords.empty() && !hasTexCoords))
+    return;
+
+  boost::unordered_map<WeldKey, unsigned int, boost::hash<WeldKey> > unique;
+  unique.rehash(this->vertices.size());
+  std::vector<unsigned int> remap(this->vertices.size());
+  WeldKey key;
+  memset(key.values, 0, sizeof(key.values));
+
+  std::vector<math::Vector3> newVerts;
+  std::vector<math::Vector3> newNorms;
+  std::vector<math::Vector2d> newTexCoords;
+
+  for (unsigned int i = 0; i < this->vertices.size(); ++i)
+  {
+    key.values[0] = this->vertices[i].x;
+    key.values[1] = this->vertices[i].y;
+    key.values[2] = this->vertices[i].z;
+    if (hasNormals)
+    {
+      key.values[3] = this->normals[i].x;
+      key.values[4] = this->normals[i].y;
+      key.values[5] = this->normals[i].z;
+    }
+    if (hasTexCoords)
+    {
+      key.values[6] = this->texCoords[i].x;
+      key.values[7] = this->texCoords[i].y;
+    }
+
+    std::pair<boost::unordered_map<WeldKey, unsigned int,
+      boost::hash<WeldKey> >::iterator, bool> result =
+      unique.insert(std::make_pair(key, newVerts.size()));
+
+    if (result.second)
+    {
+      newVerts.push_back(this->vertices[i]);
+      if (hasNormals)
+        newNorms.push_back(this->normals[i]);
+      if (hasTexCoords)
+        newTexCoords.push_back(this->texCoords[i]);
+    }
+
+    remap[i] = result.first->second;
+  }
+
+  if (newVerts.size() == this->vertices.size())
+    return;
+
+  for (std::vector<unsigned int>::iterator iter = this->indices.begin();
+       iter != this->indices.end(); ++iter)
+  {
+    if (*iter < remap.size())
+      *iter = remap[*iter];
+  }
+
+  this->vertices.swap(newVerts);
+  this->normals.swap(newNorms);
+  this->texCoords.swap(newTexCoords);
+}
+
 //////////////////////////////////////////////////
 void SubMesh::SetName(const std::string &_n)
 {
@@ -166,6 +166,10 @@ namespace gazebo
       /// \param[in] _vec Amount to translate vertices.
       public: void Translate(const math::Vector3 &_vec);
 
+      /// \brief Merge duplicate vertices in all submeshes.
+      /// \sa SubMesh::Weld
+      public: void Weld();
+
       /// \brief The name of the mesh
       private: std::string name;
 
@@ -398,6 +402,12 @@ namespace gazebo
       /// \param[in] _vec Amount to translate vertices.
       public: void Translate(const math::Vector3 &_vec);
 
+      /// \brief Merge vertices that have the same position, normal and
+      /// texture coordinate, and update the index array to match. Submeshes
+      /// with skeleton node assignments, or without an index array, are
+      /// left unchanged.
+      public: void Weld();
+
       /// \brief Scale all vertices by the _factor vector
       /// \param[in] _factor Scaling vector
       public: void SetScale(const math::Vector3 &_factor);
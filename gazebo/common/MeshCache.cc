@@ -0,0 +1,703 @@
+/*
+ * Copyright 2012 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gazebo/math/Matrix4.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Material.hh"
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/Skeleton.hh"
+#include "gazebo/common/SkeletonAnimation.hh"
+#include "gazebo/common/MeshCache.hh"
+
+using namespace gazebo;
+using namespace common;
+
+/// \brief Identifies a mesh cache file
+static const char MESH_CACHE_MAGIC[4] = {'G', 'Z', 'M', 'C'};
+
+/// \brief Version of the cache file format. Increment this whenever the
+/// layout changes, so that old cache files are ignored.
+static const uint32_t MESH_CACHE_VERSION = 1;
+
+/// \brief Written in native byte order, used to reject cache files that
+/// were produced on a machine with a different endianness.
+static const uint32_t MESH_CACHE_BYTE_ORDER = 0x01020304;
+
+/// \cond
+/// \brief Appends binary data to a cache file.
+class MeshCacheWriter
+{
+  public: explicit MeshCacheWriter(std::ostream &_out) : out(_out) {}
+
+  public: void Write(const void *_data, size_t _size)
+          {
+            this->out.write(static_cast<const char*>(_data), _size);
+          }
+
+  public: template<typename T> void Write(const T &_value)
+          {
+            this->Write(&_value, sizeof(T));
+          }
+
+  public: void WriteString(const std::string &_str)
+          {
+            this->Write(static_cast<uint32_t>(_str.size()));
+            this->Write(_str.data(), _str.size());
+          }
+
+  public: void WriteMatrix(const math::Matrix4 &_mat)
+          {
+            for (int i = 0; i < 4; ++i)
+              this->Write(_mat[i], sizeof(double) * 4);
+          }
+
+  public: void WriteColor(const Color &_clr)
+          {
+            this->Write(_clr.r);
+            this->Write(_clr.g);
+            this->Write(_clr.b);
+            this->Write(_clr.a);
+          }
+
+  private: std::ostream &out;
+};
+
+/// \brief Reads binary data from a memory mapped cache file. Reads past
+/// the end of the buffer set a failure flag instead of throwing.
+class MeshCacheReader
+{
+  public: MeshCacheReader(const char *_data, size_t _size)
+          : cur(_data), end(_data + _size), ok(true) {}
+
+  public: bool Read(void *_data, size_t _size)
+          {
+            if (!this->ok || static_cast<size_t>(this->end - this->cur) < _size)
+            {
+              this->ok = false;
+              return false;
+            }
+            memcpy(_data, this->cur, _size);
+            this->cur += _size;
+            return true;
+          }
+
+  public: template<typename T> T Read()
+          {
+            T value = T();
+            this->Read(&value, sizeof(T));
+            return value;
+          }
+
+  public: std::string ReadString()
+          {
+            uint32_t size = this->Read<uint32_t>();
+            if (!this->ok || static_cast<size_t>(this->end - this->cur) < size)
+            {
+              this->ok = false;
+              return std::string();
+            }
+            std::string result(this->cur, size);
+            this->cur += size;
+            return result;
+          }
+
+  public: math::Matrix4 ReadMatrix()
+          {
+            math::Matrix4 mat;
+            for (int i = 0; i < 4; ++i)
+              this->Read(mat[i], sizeof(double) * 4);
+            return mat;
+          }
+
+  public: Color ReadColor()
+          {
+            Color clr;
+            clr.r = this->Read<float>();
+            clr.g = this->Read<float>();
+            clr.b = this->Read<float>();
+            clr.a = this->Read<float>();
+            return clr;
+          }
+
+  /// \brief True if the number of elements of the given size can still be
+  /// read. Used to validate counts before allocating.
+  public: bool CanRead(uint32_t _count, size_t _elemSize) const
+          {
+            return this->ok && static_cast<size_t>(this->end - this->cur) /
+              _elemSize >= _count;
+          }
+
+  public: const char *cur;
+  public: const char *end;
+  public: bool ok;
+};
+/// \endcond
+
+//////////////////////////////////////////////////
+/// \brief Get the modification time and size of a file
+/// \return False if the file could not be stat'ed
+static bool statFile(const std::string &_filename, int64_t &_mtime,
+                     uint64_t &_size)
+{
+  struct stat st;
+  if (stat(_filename.c_str(), &st) != 0)
+    return false;
+
+  _mtime = static_cast<int64_t>(st.st_mtime);
+  _size = static_cast<uint64_t>(st.st_size);
+  return true;
+}
+
+//////////////////////////////////////////////////
+MeshCache::MeshCache()
+{
+  char *cachePath = getenv("GAZEBO_MESH_CACHE_PATH");
+  if (cachePath)
+    this->path = cachePath;
+  else
+  {
+    char *homePath = getenv("HOME");
+    if (homePath)
+      this->path = std::string(homePath) + "/.gazebo/mesh_cache";
+  }
+}
+
+//////////////////////////////////////////////////
+MeshCache::~MeshCache()
+{
+}
+
+//////////////////////////////////////////////////
+void MeshCache::SetPath(const std::string &_path)
+{
+  this->path = _path;
+}
+
+//////////////////////////////////////////////////
+std::string MeshCache::GetPath() const
+{
+  return this->path;
+}
+
+//////////////////////////////////////////////////
+std::string MeshCache::GetCacheFilename(const std::string &_filename) const
+{
+  // 64 bit FNV-1a hash of the full path
+  uint64_t hash = 14695981039346656037ULL;
+  for (std::string::const_iterator iter = _filename.begin();
+       iter != _filename.end(); ++iter)
+  {
+    hash ^= static_cast<unsigned char>(*iter);
+    hash *= 1099511628211ULL;
+  }
+
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%016llx.gzmesh",
+           static_cast<unsigned long long>(hash));
+
+  return this->path + "/" + buf;
+}
+
+//////////////////////////////////////////////////
+Mesh *MeshCache::Load(const std::string &_filename)
+{
+  if (this->path.empty())
+    return NULL;
+
+  int64_t mtime;
+  uint64_t size;
+  if (!statFile(_filename, mtime, size))
+    return NULL;
+
+  std::string cacheFilename = this->GetCacheFilename(_filename);
+  if (!boost::filesystem::exists(cacheFilename))
+    return NULL;
+
+  boost::iostreams::mapped_file_source file;
+  try
+  {
+    file.open(cacheFilename);
+  }
+  catch(std::exception &_e)
+  {
+    gzwarn << "Unable to open mesh cache file[" << cacheFilename << "]: "
+           << _e.what() << "\n";
+    return NULL;
+  }
+
+  MeshCacheReader reader(file.data(), file.size());
+
+  // Check the header. Any mismatch means the entry is stale, and will be
+  // overwritten by the next Save.
+  char magic[4];
+  reader.Read(magic, sizeof(magic));
+  if (!reader.ok || memcmp(magic, MESH_CACHE_MAGIC, sizeof(magic)) != 0 ||
+      reader.Read<uint32_t>() != MESH_CACHE_VERSION ||
+      reader.Read<uint32_t>() != MESH_CACHE_BYTE_ORDER ||
+      reader.ReadString() != _filename ||
+      reader.Read<int64_t>() != mtime ||
+      reader.Read<uint64_t>() != size)
+  {
+    return NULL;
+  }
+
+  Mesh *mesh = new Mesh();
+  mesh->SetName(reader.ReadString());
+  mesh->SetPath(reader.ReadString());
+
+  // Materials
+  uint32_t materialCount = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < materialCount && reader.ok; ++i)
+  {
+    Material *mat = new Material();
+    mat->SetTextureImage(reader.ReadString());
+    mat->SetAmbient(reader.ReadColor());
+    mat->SetDiffuse(reader.ReadColor());
+    mat->SetSpecular(reader.ReadColor());
+    mat->SetEmissive(reader.ReadColor());
+    mat->SetTransparency(reader.Read<double>());
+    mat->SetShininess(reader.Read<double>());
+    mat->SetPointSize(reader.Read<double>());
+    double srcFactor = reader.Read<double>();
+    double dstFactor = reader.Read<double>();
+    mat->SetBlendFactors(srcFactor, dstFactor);
+    mat->SetBlendMode(static_cast<Material::BlendMode>(
+          reader.Read<uint32_t>() % Material::BLEND_COUNT));
+    mat->SetShadeMode(static_cast<Material::ShadeMode>(
+          reader.Read<uint32_t>() % Material::SHADE_COUNT));
+    mat->SetDepthWrite(reader.Read<uint8_t>() != 0);
+    mat->SetLighting(reader.Read<uint8_t>() != 0);
+    mesh->AddMaterial(mat);
+  }
+
+  // Submeshes
+  uint32_t subMeshCount = reader.Read<uint32_t>();
+  std::vector<double> buffer;
+  for (uint32_t i = 0; i < subMeshCount && reader.ok; ++i)
+  {
+    SubMesh *subMesh = new SubMesh();
+    mesh->AddSubMesh(subMesh);
+
+    subMesh->SetName(reader.ReadString());
+    subMesh->SetPrimitiveType(
+        static_cast<SubMesh::PrimitiveType>(reader.Read<uint32_t>()));
+    int32_t materialIndex = reader.Read<int32_t>();
+    if (materialIndex >= 0)
+      subMesh->SetMaterialIndex(materialIndex);
+
+    uint32_t vertCount = reader.Read<uint32_t>();
+    uint32_t normCount = reader.Read<uint32_t>();
+    uint32_t texCount = reader.Read<uint32_t>();
+    uint32_t indexCount = reader.Read<uint32_t>();
+    uint32_t assignCount = reader.Read<uint32_t>();
+
+    if (!reader.CanRead(vertCount, sizeof(double) * 3))
+      break;
+    buffer.resize(vertCount * 3);
+    if (vertCount > 0)
+      reader.Read(&buffer[0], buffer.size() * sizeof(double));
+    subMesh->SetVertexCount(vertCount);
+    for (uint32_t j = 0; j < vertCount; ++j)
+    {
+      subMesh->SetVertex(j, math::Vector3(buffer[j*3], buffer[j*3+1],
+                                          buffer[j*3+2]));
+    }
+
+    if (!reader.CanRead(normCount, sizeof(double) * 3))
+      break;
+    buffer.resize(normCount * 3);
+    if (normCount > 0)
+      reader.Read(&buffer[0], buffer.size() * sizeof(double));
+    subMesh->SetNormalCount(normCount);
+    for (uint32_t j = 0; j < normCount; ++j)
+    {
+      subMesh->SetNormal(j, math::Vector3(buffer[j*3], buffer[j*3+1],
+                                          buffer[j*3+2]));
+    }
+
+    if (!reader.CanRead(texCount, sizeof(double) * 2))
+      break;
+    buffer.resize(texCount * 2);
+    if (texCount > 0)
+      reader.Read(&buffer[0], buffer.size() * sizeof(double));
+    subMesh->SetTexCoordCount(texCount);
+    for (uint32_t j = 0; j < texCount; ++j)
+      subMesh->SetTexCoord(j, math::Vector2d(buffer[j*2], buffer[j*2+1]));
+
+    if (!reader.CanRead(indexCount, sizeof(uint32_t)))
+      break;
+    for (uint32_t j = 0; j < indexCount; ++j)
+      subMesh->AddIndex(reader.Read<uint32_t>());
+
+    if (!reader.CanRead(assignCount, sizeof(uint32_t) * 2 + sizeof(float)))
+      break;
+    for (uint32_t j = 0; j < assignCount; ++j)
+    {
+      uint32_t vertex = reader.Read<uint32_t>();
+      uint32_t node = reader.Read<uint32_t>();
+      float weight = reader.Read<float>();
+      subMesh->AddNodeAssignment(vertex, node, weight);
+    }
+  }
+
+  // Skeleton
+  if (reader.ok && reader.Read<uint8_t>())
+  {
+    Skeleton *skel = new Skeleton();
+    skel->SetBindShapeTransform(reader.ReadMatrix());
+
+    // Nodes are stored in handle order, which is a pre-order traversal, so
+    // a node's parent is always created before the node itself.
+    uint32_t nodeCount = reader.Read<uint32_t>();
+    std::vector<SkeletonNode*> nodes;
+    for (uint32_t i = 0; i < nodeCount && reader.ok; ++i)
+    {
+      std::string name = reader.ReadString();
+      std::string id = reader.ReadString();
+      SkeletonNode::SkeletonNodeType type =
+        reader.Read<uint8_t>() ? SkeletonNode::JOINT : SkeletonNode::NODE;
+      int32_t parentHandle = reader.Read<int32_t>();
+
+      SkeletonNode *parent = NULL;
+      if (parentHandle >= 0 &&
+          parentHandle < static_cast<int32_t>(nodes.size()))
+        parent = nodes[parentHandle];
+      else if (!nodes.empty())
+      {
+        reader.ok = false;
+        break;
+      }
+
+      SkeletonNode *node = new SkeletonNode(parent, name, id, type);
+      nodes.push_back(node);
+
+      node->SetInitialTransform(reader.ReadMatrix());
+      node->SetInverseBindTransform(reader.ReadMatrix());
+
+      uint32_t rawCount = reader.Read<uint32_t>();
+      for (uint32_t j = 0; j < rawCount && reader.ok; ++j)
+      {
+        std::string sid = reader.ReadString();
+        NodeTransform::TransformType rawType =
+          static_cast<NodeTransform::TransformType>(reader.Read<uint32_t>());
+        node->AddRawTransform(NodeTransform(reader.ReadMatrix(), sid,
+                                            rawType));
+      }
+    }
+
+    if (!nodes.empty())
+      skel->SetRootNode(nodes[0]);
+
+    uint32_t vertAttached = reader.Read<uint32_t>();
+    if (reader.CanRead(vertAttached, sizeof(uint32_t)))
+    {
+      skel->SetNumVertAttached(vertAttached);
+      for (uint32_t i = 0; i < vertAttached && reader.ok; ++i)
+      {
+        uint32_t weightCount = reader.Read<uint32_t>();
+        for (uint32_t j = 0; j < weightCount && reader.ok; ++j)
+        {
+          std::string nodeName = reader.ReadString();
+          skel->AddVertNodeWeight(i, nodeName, reader.Read<double>());
+        }
+      }
+    }
+    else
+      reader.ok = false;
+
+    uint32_t animCount = reader.Read<uint32_t>();
+    for (uint32_t i = 0; i < animCount && reader.ok; ++i)
+    {
+      SkeletonAnimation *anim = new SkeletonAnimation(reader.ReadString());
+      skel->AddAnimation(anim);
+
+      uint32_t nodeAnimCount = reader.Read<uint32_t>();
+      for (uint32_t j = 0; j < nodeAnimCount && reader.ok; ++j)
+      {
+        std::string nodeName = reader.ReadString();
+        uint32_t frameCount = reader.Read<uint32_t>();
+        for (uint32_t k = 0; k < frameCount && reader.ok; ++k)
+        {
+          double time = reader.Read<double>();
+          anim->AddKeyFrame(nodeName, time, reader.ReadMatrix());
+        }
+      }
+    }
+
+    mesh->SetSkeleton(skel);
+  }
+
+  if (!reader.ok)
+  {
+    gzwarn << "Mesh cache file[" << cacheFilename << "] is corrupt\n";
+    delete mesh;
+    return NULL;
+  }
+
+  return mesh;
+}
+
+//////////////////////////////////////////////////
+bool MeshCache::Save(const std::string &_filename, const Mesh *_mesh)
+{
+  if (this->path.empty() || !_mesh)
+    return false;
+
+  int64_t mtime;
+  uint64_t size;
+  if (!statFile(_filename, mtime, size))
+    return false;
+
+  try
+  {
+    if (!boost::filesystem::exists(this->path))
+      boost::filesystem::create_directories(this->path);
+  }
+  catch(boost::filesystem::filesystem_error &_e)
+  {
+    gzwarn << "Unable to create mesh cache directory[" << this->path
+           << "]: " << _e.what() << "\n";
+    return false;
+  }
+
+  // Write to a temporary file first, then rename it. This keeps readers in
+  // other processes from seeing a partially written file.
+  std::string cacheFilename = this->GetCacheFilename(_filename);
+  std::ostringstream tmpFilename;
+  tmpFilename << cacheFilename << ".tmp" << getpid();
+
+  std::ofstream out(tmpFilename.str().c_str(),
+                    std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out.is_open())
+  {
+    gzwarn << "Unable to write mesh cache file[" << tmpFilename.str()
+           << "]\n";
+    return false;
+  }
+
+  MeshCacheWriter writer(out);
+
+  writer.Write(MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC));
+  writer.Write(MESH_CACHE_VERSION);
+  writer.Write(MESH_CACHE_BYTE_ORDER);
+  writer.WriteString(_filename);
+  writer.Write(mtime);
+  writer.Write(size);
+
+  writer.WriteString(_mesh->GetName());
+  writer.WriteString(_mesh->GetPath());
+
+  // Materials. NULL materials can't be added to a mesh, so every index is
+  // valid.
+  writer.Write(static_cast<uint32_t>(_mesh->GetMaterialCount()));
+  for (unsigned int i = 0; i < _mesh->GetMaterialCount(); ++i)
+  {
+    const Material *mat = _mesh->GetMaterial(i);
+    double srcFactor, dstFactor;
+    mat->GetBlendFactors(srcFactor, dstFactor);
+
+    writer.WriteString(mat->GetTextureImage());
+    writer.WriteColor(mat->GetAmbient());
+    writer.WriteColor(mat->GetDiffuse());
+    writer.WriteColor(mat->GetSpecular());
+    writer.WriteColor(mat->GetEmissive());
+    writer.Write(mat->GetTransparency());
+    writer.Write(mat->GetShininess());
+    writer.Write(mat->GetPointSize());
+    writer.Write(srcFactor);
+    writer.Write(dstFactor);
+    writer.Write(static_cast<uint32_t>(mat->GetBlendMode()));
+    writer.Write(static_cast<uint32_t>(mat->GetShadeMode()));
+    writer.Write(static_cast<uint8_t>(mat->GetDepthWrite()));
+    writer.Write(static_cast<uint8_t>(mat->GetLighting()));
+  }
+
+  // Submeshes, with each buffer stored as a flat array
+  writer.Write(static_cast<uint32_t>(_mesh->GetSubMeshCount()));
+  std::vector<double> buffer;
+  for (unsigned int i = 0; i < _mesh->GetSubMeshCount(); ++i)
+  {
+    const SubMesh *subMesh = _mesh->GetSubMesh(i);
+    unsigned int vertCount = subMesh->GetVertexCount();
+    unsigned int normCount = subMesh->GetNormalCount();
+    unsigned int texCount = subMesh->GetTexCoordCount();
+    unsigned int indexCount = subMesh->GetIndexCount();
+    unsigned int assignCount = subMesh->GetNodeAssignmentsCount();
+
+    writer.WriteString(subMesh->GetName());
+    writer.Write(static_cast<uint32_t>(subMesh->GetPrimitiveType()));
+
+    // The material index is stored as unsigned, with -1 meaning none
+    writer.Write(static_cast<int32_t>(subMesh->GetMaterialIndex()));
+    writer.Write(static_cast<uint32_t>(vertCount));
+    writer.Write(static_cast<uint32_t>(normCount));
+    writer.Write(static_cast<uint32_t>(texCount));
+    writer.Write(static_cast<uint32_t>(indexCount));
+    writer.Write(static_cast<uint32_t>(assignCount));
+
+    buffer.resize(vertCount * 3);
+    for (unsigned int j = 0; j < vertCount; ++j)
+    {
+      math::Vector3 v = subMesh->GetVertex(j);
+      buffer[j*3] = v.x;
+      buffer[j*3+1] = v.y;
+      buffer[j*3+2] = v.z;
+    }
+    if (!buffer.empty())
+      writer.Write(&buffer[0], buffer.size() * sizeof(double));
+
+    buffer.resize(normCount * 3);
+    for (unsigned int j = 0; j < normCount; ++j)
+    {
+      math::Vector3 n = subMesh->GetNormal(j);
+      buffer[j*3] = n.x;
+      buffer[j*3+1] = n.y;
+      buffer[j*3+2] = n.z;
+    }
+    if (!buffer.empty())
+      writer.Write(&buffer[0], buffer.size() * sizeof(double));
+
+    buffer.resize(texCount * 2);
+    for (unsigned int j = 0; j < texCount; ++j)
+    {
+      math::Vector2d t = subMesh->GetTexCoord(j);
+      buffer[j*2] = t.x;
+      buffer[j*2+1] = t.y;
+    }
+    if (!buffer.empty())
+      writer.Write(&buffer[0], buffer.size() * sizeof(double));
+
+    for (unsigned int j = 0; j < indexCount; ++j)
+      writer.Write(static_cast<uint32_t>(subMesh->GetIndex(j)));
+
+    for (unsigned int j = 0; j < assignCount; ++j)
+    {
+      NodeAssignment na = subMesh->GetNodeAssignment(j);
+      writer.Write(static_cast<uint32_t>(na.vertexIndex));
+      writer.Write(static_cast<uint32_t>(na.nodeIndex));
+      writer.Write(na.weight);
+    }
+  }
+
+  // Skeleton
+  Skeleton *skel = _mesh->GetSkeleton();
+  writer.Write(static_cast<uint8_t>(skel != NULL));
+  if (skel)
+  {
+    writer.WriteMatrix(skel->GetBindShapeTransform());
+
+    unsigned int nodeCount = skel->GetNumNodes();
+    writer.Write(static_cast<uint32_t>(nodeCount));
+    for (unsigned int i = 0; i < nodeCount; ++i)
+    {
+      SkeletonNode *node = skel->GetNodeByHandle(i);
+      writer.WriteString(node->GetName());
+      writer.WriteString(node->GetId());
+      writer.Write(static_cast<uint8_t>(node->IsJoint()));
+      writer.Write(static_cast<int32_t>(
+            node->GetParent() ? node->GetParent()->GetHandle() : -1));
+      writer.WriteMatrix(node->GetTransform());
+      writer.WriteMatrix(node->GetInverseBindTransform());
+
+      // Raw transforms are stored as matrices, the source values they
+      // were built from are only needed while parsing animations.
+      writer.Write(static_cast<uint32_t>(node->GetNumRawTrans()));
+      for (unsigned int j = 0; j < node->GetNumRawTrans(); ++j)
+      {
+        NodeTransform nt = node->GetRawTransform(j);
+        writer.WriteString(nt.GetSID());
+        writer.Write(static_cast<uint32_t>(NodeTransform::MATRIX));
+        writer.WriteMatrix(nt.Get());
+      }
+    }
+
+    writer.Write(static_cast<uint32_t>(skel->GetNumVertAttached()));
+    for (unsigned int i = 0; i < skel->GetNumVertAttached(); ++i)
+    {
+      writer.Write(static_cast<uint32_t>(skel->GetNumVertNodeWeights(i)));
+      for (unsigned int j = 0; j < skel->GetNumVertNodeWeights(i); ++j)
+      {
+        std::pair<std::string, double> nw = skel->GetVertNodeWeight(i, j);
+        writer.WriteString(nw.first);
+        writer.Write(nw.second);
+      }
+    }
+
+    writer.Write(static_cast<uint32_t>(skel->GetNumAnimations()));
+    for (unsigned int i = 0; i < skel->GetNumAnimations(); ++i)
+    {
+      SkeletonAnimation *anim = skel->GetAnimation(i);
+      writer.WriteString(anim->GetName());
+
+      // Only the animations of the skeleton's nodes are stored, which may
+      // be fewer than the animation has
+      std::vector<std::pair<std::string, const NodeAnimation*> > nodeAnims;
+      for (unsigned int j = 0; j < nodeCount; ++j)
+      {
+        std::string nodeName = skel->GetNodeByHandle(j)->GetName();
+        const NodeAnimation *nodeAnim = anim->GetNodeAnimation(nodeName);
+        if (nodeAnim)
+          nodeAnims.push_back(std::make_pair(nodeName, nodeAnim));
+      }
+
+      writer.Write(static_cast<uint32_t>(nodeAnims.size()));
+      for (unsigned int j = 0; j < nodeAnims.size(); ++j)
+      {
+        const std::string &nodeName = nodeAnims[j].first;
+        const NodeAnimation *nodeAnim = nodeAnims[j].second;
+
+        writer.WriteString(nodeName);
+        writer.Write(static_cast<uint32_t>(nodeAnim->GetFrameCount()));
+        for (unsigned int k = 0; k < nodeAnim->GetFrameCount(); ++k)
+        {
+          std::pair<double, math::Matrix4> frame = nodeAnim->GetKeyFrame(k);
+          writer.Write(frame.first);
+          writer.WriteMatrix(frame.second);
+        }
+      }
+    }
+  }
+
+  out.close();
+  if (!out)
+  {
+    gzwarn << "Failed to write mesh cache file[" << tmpFilename.str()
+           << "]\n";
+    boost::filesystem::remove(tmpFilename.str());
+    return false;
+  }
+
+  if (rename(tmpFilename.str().c_str(), cacheFilename.c_str()) != 0)
+  {
+    boost::filesystem::remove(tmpFilename.str());
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2012 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _MESHCACHE_HH_
+#define _MESHCACHE_HH_
+
+#include <string>
+
+namespace gazebo
+{
+  namespace common
+  {
+    class Mesh;
+
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \class MeshCache MeshCache.hh common/common.hh
+    /// \brief On-disk cache of parsed meshes.
+    ///
+    /// Each mesh file is stored in a compact binary file that holds the
+    /// vertex, normal, texture coordinate and index buffers of every
+    /// submesh, along with the materials and the skeleton. Buffers are
+    /// stored as flat arrays, and cache files are memory mapped when read.
+    /// A cache entry is keyed by the full path of the source file, and is
+    /// only used if the modification time and size of the source file
+    /// still match.
+    class MeshCache
+    {
+      /// \brief Constructor. The cache directory is taken from the
+      /// GAZEBO_MESH_CACHE_PATH environment variable, and defaults to
+      /// ~/.gazebo/mesh_cache.
+      public: MeshCache();
+
+      /// \brief Destructor
+      public: virtual ~MeshCache();
+
+      /// \brief Set the directory that holds the cache files.
+      /// \param[in] _path The cache directory. An empty string disables
+      /// the cache.
+      public: void SetPath(const std::string &_path);
+
+      /// \brief Get the directory that holds the cache files.
+      /// \return The cache directory, empty if the cache is disabled.
+      public: std::string GetPath() const;
+
+      /// \brief Load a mesh from the cache.
+      /// \param[in] _filename Full path to the source mesh file.
+      /// \return A new mesh, or NULL if the mesh is not in the cache or
+      /// the source file has changed since the mesh was cached.
+      public: Mesh *Load(const std::string &_filename);
+
+      /// \brief Store a mesh in the cache.
+      /// \param[in] _filename Full path to the source mesh file.
+      /// \param[in] _mesh The mesh that was loaded from _filename.
+      /// \return True if the cache file was written.
+      public: bool Save(const std::string &_filename, const Mesh *_mesh);
+
+      /// \brief Get the name of the cache file for a source mesh file.
+      /// \param[in] _filename Full path to the source mesh file.
+      /// \return Full path to the cache file.
+      private: std::string GetCacheFilename(const std::string &_filename) const;
+
+      /// \brief Directory that holds the cache files
+      private: std::string path;
+    };
+    /// \}
+  }
+}
+#endif
@@ -25,6 +25,7 @@
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshCache.hh"
 #include "gazebo/common/ColladaLoader.hh"
 #include "gazebo/common/STLLoader.hh"
 #include "gazebo_config.h"
@@ -43,6 +44,7 @@ MeshManager::MeshManager()
 {
   this->colladaLoader = new ColladaLoader();
   this->stlLoader = new STLLoader();
+  this->meshCache = new MeshCache();
 
   // Create some basic shapes
   this->CreatePlane("unit_plane",
@@ -74,6 +76,7 @@ MeshManager::~MeshManager()
 {
   delete this->colladaLoader;
   delete this->stlLoader;
+  delete this->meshCache;
   std::map<std::string, Mesh*>::iterator iter;
   for (iter = this->meshes.begin(); iter != this->meshes.end(); ++iter)
     delete iter->second;
@@ -132,7 +135,19 @@ const Mesh *MeshManager::Load(const std::string &_filename)
       boost::mutex::scoped_lock lock(this->mutex);
       if (!this->HasMesh(_filename))
       {
-        if ((mesh = loader->Load(fullname)) != NULL)
+        // Try the cache first. When the cache is enabled, meshes are
+        // welded before they are cached, so that a mesh has the same
+        // layout whether or not it came from the cache. Otherwise meshes
+        // are used as they were loaded.
+        if ((mesh = this->meshCache->Load(fullname)) == NULL &&
+            (mesh = loader->Load(fullname)) != NULL &&
+            !this->meshCache->GetPath().empty())
+        {
+          mesh->Weld();
+          this->meshCache->Save(fullname, mesh);
+        }
+
+        if (mesh)
         {
           mesh->SetName(_filename);
           this->meshes.insert(std::make_pair(_filename, mesh));
@@ -158,6 +173,19 @@ const Mesh *MeshManager::Load(const std::string &_filename)
   return mesh;
 }
 
+//////////////////////////////////////////////////
+void MeshManager::SetCachePath(const std::string &_path)
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+  this->meshCache->SetPath(_path);
+}
+
+//////////////////////////////////////////////////
+std::string MeshManager::GetCachePath() const
+{
+  return this->meshCache->GetPath();
+}
+
 //////////////////////////////////////////////////
 bool MeshManager::IsValidFilename(const std::string &_filename)
 {
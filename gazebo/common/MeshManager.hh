@@ -35,6 +35,7 @@ namespace gazebo
     class ColladaLoader;
     class STLLoader;
     class Mesh;
+    class MeshCache;
     class Plane;
     class SubMesh;
 
@@ -58,6 +59,17 @@ namespace gazebo
       /// \return a pointer to the created mesh
       public: const Mesh *Load(const std::string &_filename);
 
+      /// \brief Set the directory of the on-disk mesh cache. Meshes loaded
+      /// from files are stored in the cache, which makes loading the same
+      /// file faster the next time gazebo runs.
+      /// \param[in] _path The cache directory. An empty string disables
+      /// the cache.
+      public: void SetCachePath(const std::string &_path);
+
+      /// \brief Get the directory of the on-disk mesh cache.
+      /// \return The cache directory, empty if the cache is disabled.
+      public: std::string GetCachePath() const;
+
       /// \brief Checks a path extension against the list of valid extensions.
       /// \return true if the file extension is loadable
       public: bool IsValidFilename(const std::string &_filename);
@@ -209,6 +221,9 @@ namespace gazebo
       /// \brief 3D mesh loader for STL files
       private: STLLoader *stlLoader;
 
+      /// \brief On-disk cache of meshes loaded from files.
+      private: MeshCache *meshCache;
+
       /// \brief Dictionary of meshes, indexed by name
       private: std::map<std::string, Mesh*> meshes;
 
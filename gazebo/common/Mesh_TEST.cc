@@ -16,13 +16,16 @@
 */
 
 #include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
 
 #include "test_config.h"
 #include "gazebo/math/Vector3.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/MeshManager.hh"
 #include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshCache.hh"
 #include "gazebo/common/ColladaLoader.hh"
+#include "gazebo/common/STLLoader.hh"
 
 using namespace gazebo;
 
@@ -283,6 +286,84 @@ TEST(MeshTest, SubMeshCenter)
   EXPECT_EQ(math::Vector3(3.46555, 0.180391, 2.8431), mesh->GetMin());
 }
 
+/////////////////////////////////////////////////
+// Test storing a mesh in the mesh cache and loading it back.
+TEST(MeshTest, MeshCache)
+{
+  std::string filename =
+    std::string(PROJECT_SOURCE_PATH) + "/test/data/box.dae";
+
+  common::ColladaLoader loader;
+  common::Mesh *mesh = loader.Load(filename);
+  ASSERT_TRUE(mesh != NULL);
+  mesh->Weld();
+
+  // Files of the test go in a directory of their own
+  boost::filesystem::path testDir = boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("gazebo_mesh_cache_%%%%-%%%%-%%%%");
+  ASSERT_TRUE(boost::filesystem::create_directories(testDir));
+  std::string cacheDir = (testDir / "cache").string();
+  std::string stlFilename = (testDir / "box.stl").string();
+
+  common::MeshCache cache;
+
+  // Nothing should be loaded while the cache is disabled
+  cache.SetPath("");
+  EXPECT_FALSE(cache.Save(filename, mesh));
+  EXPECT_TRUE(cache.Load(filename) == NULL);
+
+  cache.SetPath(cacheDir);
+  EXPECT_TRUE(cache.Save(filename, mesh));
+
+  common::Mesh *cached = cache.Load(filename);
+  ASSERT_TRUE(cached != NULL);
+
+  EXPECT_EQ(mesh->GetSubMeshCount(), cached->GetSubMeshCount());
+  EXPECT_EQ(mesh->GetMaterialCount(), cached->GetMaterialCount());
+  EXPECT_EQ(mesh->GetVertexCount(), cached->GetVertexCount());
+  EXPECT_EQ(mesh->GetNormalCount(), cached->GetNormalCount());
+  EXPECT_EQ(mesh->GetTexCoordCount(), cached->GetTexCoordCount());
+  EXPECT_EQ(mesh->GetIndexCount(), cached->GetIndexCount());
+  EXPECT_EQ(mesh->GetMax(), cached->GetMax());
+  EXPECT_EQ(mesh->GetMin(), cached->GetMin());
+
+  for (unsigned int i = 0; i < mesh->GetSubMeshCount(); ++i)
+  {
+    const common::SubMesh *subMesh = mesh->GetSubMesh(i);
+    const common::SubMesh *cachedSubMesh = cached->GetSubMesh(i);
+    EXPECT_EQ(subMesh->GetMaterialIndex(), cachedSubMesh->GetMaterialIndex());
+    for (unsigned int j = 0; j < subMesh->GetVertexCount(); ++j)
+      EXPECT_EQ(subMesh->GetVertex(j), cachedSubMesh->GetVertex(j));
+    for (unsigned int j = 0; j < subMesh->GetIndexCount(); ++j)
+      EXPECT_EQ(subMesh->GetIndex(j), cachedSubMesh->GetIndex(j));
+  }
+
+  delete cached;
+  delete mesh;
+
+  // A cache entry is stale once the source file changes
+  std::ofstream stlFile(stlFilename.c_str(), std::ios::out);
+  stlFile << asciiSTLBox;
+  stlFile.close();
+
+  common::STLLoader stlLoader;
+  mesh = stlLoader.Load(stlFilename);
+  ASSERT_TRUE(mesh != NULL);
+  EXPECT_TRUE(cache.Save(stlFilename, mesh));
+  delete mesh;
+
+  cached = cache.Load(stlFilename);
+  EXPECT_TRUE(cached != NULL);
+  delete cached;
+
+  stlFile.open(stlFilename.c_str(), std::ios::app);
+  stlFile << "\n";
+  stlFile.close();
+  EXPECT_TRUE(cache.Load(stlFilename) == NULL);
+
+  boost::filesystem::remove_all(testDir);
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
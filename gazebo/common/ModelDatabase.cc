@@ -20,8 +20,12 @@
 #include <curl/curl.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
@@ -29,7 +33,6 @@
 #include <boost/iostreams/filter/gzip.hpp>
 
 #include "gazebo/sdf/sdf.hh"
-#include "gazebo/common/Time.hh"
 #include "gazebo/common/SystemPaths.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/ModelDatabase.hh"
@@ -58,10 +61,39 @@ size_t get_models_cb(void *_buffer, size_t _size, size_t _nmemb, void *_userp)
   return _size;
 }
 
+/////////////////////////////////////////////////
+/// \brief Collect the model:// URIs of all <uri> elements.
+/// \param[in] _elem Element to search recursively.
+/// \param[out] _uris URIs found.
+static void collectModelURIs(TiXmlElement *_elem,
+                             std::vector<std::string> &_uris)
+{
+  for (TiXmlElement *child = _elem->FirstChildElement(); child;
+       child = child->NextSiblingElement())
+  {
+    if (child->ValueStr() == "uri")
+    {
+      if (child->GetText() &&
+          std::string(child->GetText()).find("model://") == 0)
+      {
+        _uris.push_back(child->GetText());
+      }
+    }
+    else
+      collectModelURIs(child, _uris);
+  }
+}
+
 /////////////////////////////////////////////////
 ModelDatabase::ModelDatabase()
 {
   this->stop = false;
+  this->updateRequested = false;
+  this->updateCount = 0;
+  this->maxDownloads = 4;
+
+  // libcurl must be initialized before it is used by several threads.
+  curl_global_init(CURL_GLOBAL_ALL);
 
   // Create the thread that is used to update the model cache. This
   // retreives online data in the background to improve startup times.
@@ -72,12 +104,32 @@ ModelDatabase::ModelDatabase()
 /////////////////////////////////////////////////
 ModelDatabase::~ModelDatabase()
 {
-  // Stop the update thread.
+  // Stop the update thread. The flag is set before locking so that an
+  // update in progress stops early.
   this->stop = true;
-  this->updateCacheCondition.notify_one();
+  {
+    boost::mutex::scoped_lock lock(this->updateMutex);
+    this->updateCacheCondition.notify_one();
+    this->updateDoneCondition.notify_all();
+  }
   this->updateCacheThread->join();
-
   delete this->updateCacheThread;
+
+  // Stop the download threads. Downloads in progress are finished.
+  {
+    boost::mutex::scoped_lock lock(this->downloadMutex);
+    this->downloadQueue.clear();
+    this->downloadCondition.notify_all();
+  }
+
+  for (std::vector<boost::thread*>::iterator iter =
+       this->downloadThreads.begin(); iter != this->downloadThreads.end();
+       ++iter)
+  {
+    (*iter)->join();
+    delete *iter;
+  }
+  this->downloadThreads.clear();
 }
 
 /////////////////////////////////////////////////
@@ -96,6 +148,26 @@ std::string ModelDatabase::GetURI()
   return result;
 }
 
+/////////////////////////////////////////////////
+std::string ModelDatabase::GetIndexFilename()
+{
+  char *homeStr = getenv("HOME");
+  if (!homeStr)
+    return std::string();
+
+  return std::string(homeStr) + "/.gazebo/model_database.index";
+}
+
+/////////////////////////////////////////////////
+std::string ModelDatabase::GetInstallPath()
+{
+  char *homeStr = getenv("HOME");
+  if (!homeStr)
+    return std::string();
+
+  return std::string(homeStr) + "/.gazebo/models";
+}
+
 /////////////////////////////////////////////////
 bool ModelDatabase::HasModel(const std::string &_modelURI)
 {
@@ -113,14 +185,7 @@ bool ModelDatabase::HasModel(const std::string &_modelURI)
   boost::replace_first(uri, "model://", ModelDatabase::GetURI());
 
   std::map<std::string, std::string> models = ModelDatabase::GetModels();
-
-  for (std::map<std::string, std::string>::iterator iter = models.begin();
-       iter != models.end(); ++iter)
-  {
-    if (iter->first == uri)
-      return true;
-  }
-  return false;
+  return models.find(uri) != models.end();
 }
 
 /////////////////////////////////////////////////
@@ -187,7 +252,9 @@ std::string ModelDatabase::GetManifestImpl(const std::string &_uri)
 }
 
 /////////////////////////////////////////////////
-bool ModelDatabase::UpdateModelCacheImpl()
+bool ModelDatabase::UpdateModelCacheImpl(
+    const std::map<std::string, std::string> &_known,
+    std::map<std::string, std::string> &_models)
 {
   std::string xmlString = ModelDatabase::GetDBConfig(ModelDatabase::GetURI());
 
@@ -229,75 +296,174 @@ bool ModelDatabase::UpdateModelCacheImpl()
       }
 
       std::string fullURI = ModelDatabase::GetURI() + suffix;
-      std::string modelName = ModelDatabase::GetModelName(fullURI);
 
-      this->modelCache[fullURI] = modelName;
+      // Only get the manifest of models that are new since the last update
+      std::map<std::string, std::string>::const_iterator known =
+        _known.find(fullURI);
+      if (known != _known.end() && !known->second.empty())
+        _models[fullURI] = known->second;
+      else
+        _models[fullURI] = ModelDatabase::GetModelName(fullURI);
     }
   }
+  else
+    return false;
 
-  return true;
+  return !this->stop;
+}
+
+/////////////////////////////////////////////////
+void ModelDatabase::LoadIndex()
+{
+  std::string uri = ModelDatabase::GetURI();
+  if (this->modelCacheURI == uri)
+    return;
+
+  // Models of another database are useless
+  this->modelCache.clear();
+  this->modelCacheURI = uri;
+
+  std::ifstream in(ModelDatabase::GetIndexFilename().c_str());
+  if (!in.is_open())
+    return;
+
+  // The first line is the URI of the database the index was saved for,
+  // then each line is a model URI and a model name separated by a tab.
+  std::string line;
+  if (!std::getline(in, line) || line != uri)
+    return;
+
+  while (std::getline(in, line))
+  {
+    size_t tab = line.find('\t');
+    if (tab != std::string::npos)
+      this->modelCache[line.substr(0, tab)] = line.substr(tab + 1);
+  }
+}
+
+/////////////////////////////////////////////////
+void ModelDatabase::SaveIndex()
+{
+  std::string filename = ModelDatabase::GetIndexFilename();
+  if (filename.empty())
+    return;
+
+  // Write to a temporary file first, so that other processes never read
+  // a partial index.
+  std::ostringstream tmpFilename;
+  tmpFilename << filename << "." << getpid();
+
+  try
+  {
+    boost::filesystem::create_directories(
+        boost::filesystem::path(filename).parent_path());
+
+    std::ofstream out(tmpFilename.str().c_str());
+    out << this->modelCacheURI << "\n";
+    for (std::map<std::string, std::string>::iterator iter =
+         this->modelCache.begin(); iter != this->modelCache.end(); ++iter)
+    {
+      out << iter->first << "\t" << iter->second << "\n";
+    }
+    out.close();
+
+    if (!out)
+    {
+      gzwarn << "Unable to write model database index["
+             << tmpFilename.str() << "]\n";
+      boost::filesystem::remove(tmpFilename.str());
+      return;
+    }
+
+    boost::filesystem::rename(tmpFilename.str(), filename);
+  }
+  catch(...)
+  {
+    gzwarn << "Unable to save model database index[" << filename << "]\n";
+  }
+}
+
+/////////////////////////////////////////////////
+void ModelDatabase::RunCallbacks()
+{
+  for (std::list<CallbackFunc>::iterator iter = this->callbacks.begin();
+       iter != this->callbacks.end(); ++iter)
+  {
+    (*iter)(this->modelCache);
+  }
+  this->callbacks.clear();
 }
 
 /////////////////////////////////////////////////
 void ModelDatabase::UpdateModelCache()
 {
+  boost::mutex::scoped_lock lock(this->updateMutex);
+
   // Continually update the model cache when requested.
   while (!this->stop)
   {
     // Wait for an update request.
-    boost::mutex::scoped_lock lock(this->updateMutex);
-    this->updateCacheCondition.wait(lock);
+    while (!this->updateRequested && !this->stop)
+      this->updateCacheCondition.wait(lock);
 
     // Exit if notified and stopped.
     if (this->stop)
       break;
 
-    // Update the model cache.
-    if (!this->UpdateModelCacheImpl())
-      gzerr << "Unable to download model manifests\n";
-    else
+    this->updateRequested = false;
+
+    // Models from the index are available right away, the update below
+    // refreshes them.
+    this->LoadIndex();
+    if (!this->modelCache.empty())
+      this->RunCallbacks();
+
+    std::string uri = this->modelCacheURI;
+    std::map<std::string, std::string> known = this->modelCache;
+    std::map<std::string, std::string> models;
+
+    // Download without holding the lock, so readers use the index.
+    lock.unlock();
+    bool success = this->UpdateModelCacheImpl(known, models);
+    lock.lock();
+
+    if (!success)
     {
-      for (std::list<CallbackFunc>::iterator iter = this->callbacks.begin();
-           iter != this->callbacks.end(); ++iter)
-      {
-        (*iter)(this->modelCache);
-      }
-      this->callbacks.clear();
+      if (!this->stop)
+        gzerr << "Unable to download model manifests\n";
+    }
+    else if (this->modelCacheURI == uri)
+    {
+      this->modelCache = models;
+      this->SaveIndex();
+      this->RunCallbacks();
     }
+
+    this->updateCount++;
+    this->updateDoneCondition.notify_all();
   }
 }
 
 /////////////////////////////////////////////////
 std::map<std::string, std::string> ModelDatabase::GetModels()
 {
-  size_t size = 0;
+  boost::mutex::scoped_lock lock(this->updateMutex);
 
-  {
-    {
-      boost::mutex::scoped_try_lock tryLock(this->updateMutex);
-      if (!tryLock)
-        gzmsg << "Waiting for model database update to complete...\n";
-    }
-    boost::mutex::scoped_lock lock(this->updateMutex);
-
-    size = this->modelCache.size();
-  }
+  this->LoadIndex();
 
-  if (size != 0)
-    return this->modelCache;
-  else
+  if (this->modelCache.empty() && !this->stop)
   {
     gzwarn << "Getting models from[" << GetURI()
            << "]. This may take a few seconds.\n";
 
-    // Tell the background thread to grab the models from online.
+    // Tell the background thread to grab the models from online, and wait
+    // for it to finish.
+    unsigned int count = this->updateCount;
+    this->updateRequested = true;
     this->updateCacheCondition.notify_one();
 
-    // Let the other thread start downloading.
-    common::Time::MSleep(100);
-
-    // Wait for the thread to finish.
-    boost::mutex::scoped_lock lock(this->updateMutex);
+    while (this->updateCount == count && !this->stop)
+      this->updateDoneCondition.wait(lock);
   }
 
   return this->modelCache;
@@ -307,7 +473,9 @@ std::map<std::string, std::string> ModelDatabase::GetModels()
 void ModelDatabase::GetModels(
     boost::function<void (const std::map<std::string, std::string> &)> _func)
 {
+  boost::mutex::scoped_lock lock(this->updateMutex);
   this->callbacks.push_back(_func);
+  this->updateRequested = true;
   this->updateCacheCondition.notify_one();
 }
 
@@ -346,6 +514,57 @@ std::string ModelDatabase::GetModelName(const std::string &_uri)
   return result;
 }
 
+/////////////////////////////////////////////////
+bool ModelDatabase::SplitURI(const std::string &_uri, std::string &_modelName,
+                             std::string &_suffix)
+{
+  if (_uri.find("://") == std::string::npos)
+  {
+    gzerr << "URI[" << _uri << "] is missing ://\n";
+    return false;
+  }
+
+  std::string name = _uri;
+  boost::replace_first(name, "model://", "");
+  boost::replace_first(name, ModelDatabase::GetURI(), "");
+
+  size_t startIndex = !name.empty() && name[0] == '/' ? 1 : 0;
+  size_t endIndex = name.find_first_of("/", startIndex);
+  size_t modelNameLen = endIndex == std::string::npos ? std::string::npos :
+    endIndex - startIndex;
+
+  _modelName = name.substr(startIndex, modelNameLen);
+  _suffix.clear();
+  if (endIndex != std::string::npos)
+    _suffix = name.substr(endIndex, std::string::npos);
+
+  if (_modelName.empty())
+  {
+    gzerr << "URI[" << _uri << "] has no model name\n";
+    return false;
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::string ModelDatabase::FindInstalled(const std::string &_modelName)
+{
+  std::list<std::string> paths = SystemPaths::Instance()->GetModelPaths();
+  paths.push_back(ModelDatabase::GetInstallPath());
+
+  for (std::list<std::string>::iterator iter = paths.begin();
+       iter != paths.end(); ++iter)
+  {
+    boost::filesystem::path path = boost::filesystem::path(*iter) /
+      _modelName;
+    if (boost::filesystem::exists(path))
+      return path.string();
+  }
+
+  return std::string();
+}
+
 /////////////////////////////////////////////////
 std::string ModelDatabase::GetModelPath(const std::string &_uri,
                                         bool _forceDownload)
@@ -359,137 +578,330 @@ std::string ModelDatabase::GetModelPath(const std::string &_uri,
 
   if (path.empty() || stat(path.c_str(), &st) != 0 )
   {
-    if (!ModelDatabase::HasModel(_uri))
-    {
-      gzerr << "Unable to download model[" << _uri << "]\n";
+    // Get the model name from the uri
+    std::string modelName;
+    if (!this->SplitURI(_uri, modelName, suffix))
       return std::string();
+
+    // Wait for the download if another thread already started it,
+    // otherwise claim it. A queued download is taken over, since the
+    // download threads may all be waiting on this one.
+    bool waited = false;
+    {
+      boost::mutex::scoped_lock lock(this->downloadMutex);
+      std::deque<std::string>::iterator queued = std::find(
+          this->downloadQueue.begin(), this->downloadQueue.end(), modelName);
+      if (queued != this->downloadQueue.end())
+        this->downloadQueue.erase(queued);
+      else if (this->downloads.find(modelName) != this->downloads.end())
+      {
+        while (this->downloads.find(modelName) != this->downloads.end())
+          this->downloadCondition.wait(lock);
+        waited = true;
+      }
+      else
+        this->downloads.insert(modelName);
     }
 
-    // DEBUG output
-    // std::cout << "Getting uri[" << _uri << "] path[" << path << "]\n";
+    if (waited)
+      path = this->FindInstalled(modelName);
+    else
+    {
+      if (ModelDatabase::HasModel(_uri))
+        path = this->DownloadModel(_uri, modelName);
 
-    // Get the model name from the uri
-    size_t startIndex = _uri.find_first_of("://");
-    if (startIndex == std::string::npos)
+      // Finish the download before getting the dependencies, so that
+      // models which depend on each other don't wait forever.
+      std::list<std::pair<std::string, FetchFunc> > waiting =
+        this->FinishDownload(modelName);
+
+      if (!path.empty())
+        ModelDatabase::DownloadDependencies(path);
+
+      for (std::list<std::pair<std::string, FetchFunc> >::iterator iter =
+           waiting.begin(); iter != waiting.end(); ++iter)
+      {
+        std::string name, fetchSuffix;
+        this->SplitURI(iter->first, name, fetchSuffix);
+        iter->second(path.empty() ? path : path + fetchSuffix);
+      }
+    }
+
+    if (path.empty())
     {
-      gzerr << "URI[" << _uri << "] is missing ://\n";
+      gzerr << "Unable to download model[" << _uri << "]\n";
       return std::string();
     }
+  }
 
-    std::string modelName = _uri;
-    boost::replace_first(modelName, "model://", "");
-    boost::replace_first(modelName, ModelDatabase::GetURI(), "");
+  return path + suffix;
+}
+
+/////////////////////////////////////////////////
+std::string ModelDatabase::DownloadModel(const std::string &_uri,
+                                         const std::string &_modelName)
+{
+  std::string path;
 
-    startIndex = modelName[0] == '/' ? 1 : 0;
-    size_t endIndex = modelName.find_first_of("/", startIndex);
-    size_t modelNameLen = endIndex == std::string::npos ? std::string::npos :
-      endIndex - startIndex;
+  // Store downloaded .tar.gz and intermediate .tar files in temp location
+  boost::filesystem::path tmppath = boost::filesystem::temp_directory_path();
+  tmppath /= boost::filesystem::unique_path("gz_model-%%%%-%%%%-%%%%-%%%%");
+  std::string tarfilename = tmppath.string() + ".tar";
+  std::string tgzfilename = tarfilename + ".gz";
 
-    modelName = modelName.substr(startIndex, modelNameLen);
-    if (endIndex != std::string::npos)
-      suffix = _uri.substr(endIndex, std::string::npos);
+  CURL *curl = curl_easy_init();
+  if (!curl)
+  {
+    gzerr << "Unable to initialize libcurl\n";
+    return std::string();
+  }
 
-    // Store downloaded .tar.gz and intermediate .tar files in temp location
-    boost::filesystem::path tmppath = boost::filesystem::temp_directory_path();
-    tmppath /= boost::filesystem::unique_path("gz_model-%%%%-%%%%-%%%%-%%%%");
-    std::string tarfilename = tmppath.string() + ".tar";
-    std::string tgzfilename = tarfilename + ".gz";
+  curl_easy_setopt(curl, CURLOPT_URL,
+      (ModelDatabase::GetURI() + "/" +
+       _modelName + "/model.tar.gz").c_str());
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_data);
 
-    CURL *curl = curl_easy_init();
-    if (!curl)
+  bool retry = true;
+  int iterations = 0;
+  while (retry && iterations < 4 && !this->stop)
+  {
+    retry = false;
+    iterations++;
+
+    FILE *fp = fopen(tgzfilename.c_str(), "wb");
+    if (!fp)
     {
-      gzerr << "Unable to initialize libcurl\n";
+      gzerr << "Could not download model[" << _uri << "] because we were"
+        << "unable to write to file[" << tgzfilename << "]."
+        << "Please fix file permissions.";
+      curl_easy_cleanup(curl);
       return std::string();
     }
 
-    curl_easy_setopt(curl, CURLOPT_URL,
-        (ModelDatabase::GetURI() + "/" +
-         modelName + "/model.tar.gz").c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_data);
+    /// Download the model tarball
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, fp);
+    CURLcode success = curl_easy_perform(curl);
+    fclose(fp);
 
-    bool retry = true;
-    int iterations = 0;
-    while (retry && iterations < 4)
+    if (success != CURLE_OK)
     {
-      retry = false;
-      iterations++;
+      gzwarn << "Unable to connect to model database using ["
+             << _uri << "]\n";
+      retry = true;
+      continue;
+    }
 
-      FILE *fp = fopen(tgzfilename.c_str(), "wb");
-      if (!fp)
-      {
-        gzerr << "Could not download model[" << _uri << "] because we were"
-          << "unable to write to file[" << tgzfilename << "]."
-          << "Please fix file permissions.";
-        return std::string();
-      }
+    try
+    {
+      // Unzip model tarball
+      std::ifstream file(tgzfilename.c_str(),
+          std::ios_base::in | std::ios_base::binary);
+      std::ofstream out(tarfilename.c_str(),
+          std::ios_base::out | std::ios_base::binary);
+      boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
+      in.push(boost::iostreams::gzip_decompressor());
+      in.push(file);
+      boost::iostreams::copy(in, out);
+    }
+    catch(...)
+    {
+      gzerr << "Failed to unzip model tarball. Trying again...\n";
+      retry = true;
+      continue;
+    }
 
-      /// Download the model tarball
-      curl_easy_setopt(curl, CURLOPT_WRITEDATA, fp);
-      CURLcode success = curl_easy_perform(curl);
+    TAR *tar;
+    if (tar_open(&tar, const_cast<char*>(tarfilename.c_str()),
+          NULL, O_RDONLY, 0644, TAR_GNU) != 0)
+    {
+      gzerr << "Failed to open model tarball. Trying again...\n";
+      retry = true;
+      continue;
+    }
 
-      if (success != CURLE_OK)
-      {
-        gzwarn << "Unable to connect to model database using ["
-               << _uri << "]\n";
-        retry = true;
-        continue;
-      }
+    std::string outputPath = ModelDatabase::GetInstallPath();
+    tar_extract_all(tar, const_cast<char*>(outputPath.c_str()));
+    tar_close(tar);
+    path = outputPath + "/" + _modelName;
 
-      fclose(fp);
+    // Searches that failed before the download are stale
+    SystemPaths::Instance()->ClearFileCache();
+  }
 
-      try
-      {
-        // Unzip model tarball
-        std::ifstream file(tgzfilename.c_str(),
-            std::ios_base::in | std::ios_base::binary);
-        std::ofstream out(tarfilename.c_str(),
-            std::ios_base::out | std::ios_base::binary);
-        boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
-        in.push(boost::iostreams::gzip_decompressor());
-        in.push(file);
-        boost::iostreams::copy(in, out);
-      }
-      catch(...)
-      {
-        gzerr << "Failed to unzip model tarball. Trying again...\n";
-        retry = true;
-        continue;
-      }
+  curl_easy_cleanup(curl);
+  if (retry)
+  {
+    gzerr << "Could not download model[" << _uri << "]."
+      << "The model may be corrupt.\n";
+    path.clear();
+  }
+
+  // Clean up
+  try
+  {
+    boost::filesystem::remove(tarfilename);
+    boost::filesystem::remove(tgzfilename);
+  }
+  catch(...)
+  {
+    gzwarn << "Failed to remove temporary model files after download.";
+  }
+
+  return path;
+}
+
+/////////////////////////////////////////////////
+std::list<std::pair<std::string, ModelDatabase::FetchFunc> >
+ModelDatabase::FinishDownload(const std::string &_modelName)
+{
+  std::list<std::pair<std::string, FetchFunc> > result;
+
+  boost::mutex::scoped_lock lock(this->downloadMutex);
+  this->downloads.erase(_modelName);
+
+  std::map<std::string, std::list<std::pair<std::string, FetchFunc> > >::
+    iterator iter = this->fetchCallbacks.find(_modelName);
+  if (iter != this->fetchCallbacks.end())
+  {
+    result.swap(iter->second);
+    this->fetchCallbacks.erase(iter);
+  }
+
+  this->downloadCondition.notify_all();
+  return result;
+}
+
+/////////////////////////////////////////////////
+bool ModelDatabase::QueueDownload(const std::string &_modelName)
+{
+  if (!this->downloads.insert(_modelName).second)
+    return false;
 
-      TAR *tar;
-      tar_open(&tar, const_cast<char*>(tarfilename.c_str()),
-          NULL, O_RDONLY, 0644, TAR_GNU);
+  this->downloadQueue.push_back(_modelName);
 
-      std::string outputPath = getenv("HOME");
-      outputPath += "/.gazebo/models";
+  // Start another thread if all of them may be busy
+  if (this->downloadThreads.size() < this->maxDownloads &&
+      this->downloadThreads.size() < this->downloads.size())
+  {
+    this->downloadThreads.push_back(new boost::thread(
+          boost::bind(&ModelDatabase::RunDownloads, this)));
+  }
+
+  this->downloadCondition.notify_all();
+  return true;
+}
 
-      tar_extract_all(tar, const_cast<char*>(outputPath.c_str()));
-      path = outputPath + "/" + modelName;
+/////////////////////////////////////////////////
+void ModelDatabase::RunDownloads()
+{
+  boost::mutex::scoped_lock lock(this->downloadMutex);
+  while (true)
+  {
+    while (!this->stop && this->downloadQueue.empty())
+      this->downloadCondition.wait(lock);
 
+    if (this->stop)
+      break;
+
+    std::string modelName = this->downloadQueue.front();
+    this->downloadQueue.pop_front();
+    lock.unlock();
+
+    std::string uri = "model://" + modelName;
+    std::string path = this->FindInstalled(modelName);
+    if (path.empty() && ModelDatabase::HasModel(uri))
+      path = this->DownloadModel(uri, modelName);
+
+    std::list<std::pair<std::string, FetchFunc> > waiting =
+      this->FinishDownload(modelName);
+
+    if (!path.empty())
       ModelDatabase::DownloadDependencies(path);
-    }
 
-    curl_easy_cleanup(curl);
-    if (retry)
+    for (std::list<std::pair<std::string, FetchFunc> >::iterator iter =
+         waiting.begin(); iter != waiting.end(); ++iter)
     {
-      gzerr << "Could not download model[" << _uri << "]."
-        << "The model may be corrupt.\n";
-      path.clear();
+      std::string name, suffix;
+      this->SplitURI(iter->first, name, suffix);
+      iter->second(path.empty() ? path : path + suffix);
     }
 
-    // Clean up
-    try
-    {
-      boost::filesystem::remove(tarfilename);
-      boost::filesystem::remove(tgzfilename);
-    }
-    catch(...)
+    lock.lock();
+  }
+}
+
+/////////////////////////////////////////////////
+void ModelDatabase::FetchModel(const std::string &_uri,
+    boost::function<void (const std::string &)> _func)
+{
+  std::string modelName, suffix;
+  if (!this->SplitURI(_uri, modelName, suffix))
+  {
+    _func(std::string());
+    return;
+  }
+
+  std::string path = this->FindInstalled(modelName);
+  if (!path.empty())
+  {
+    _func(path + suffix);
+    return;
+  }
+
+  boost::mutex::scoped_lock lock(this->downloadMutex);
+  this->fetchCallbacks[modelName].push_back(std::make_pair(_uri, _func));
+  this->QueueDownload(modelName);
+}
+
+/////////////////////////////////////////////////
+unsigned int ModelDatabase::Prefetch(const std::vector<std::string> &_uris)
+{
+  unsigned int count = 0;
+  for (std::vector<std::string>::const_iterator iter = _uris.begin();
+       iter != _uris.end(); ++iter)
+  {
+    std::string modelName, suffix;
+    if (!this->SplitURI(*iter, modelName, suffix) ||
+        !this->FindInstalled(modelName).empty())
     {
-      gzwarn << "Failed to remove temporary model files after download.";
+      continue;
     }
+
+    boost::mutex::scoped_lock lock(this->downloadMutex);
+    if (this->QueueDownload(modelName))
+      count++;
   }
 
-  return path + suffix;
+  return count;
+}
+
+/////////////////////////////////////////////////
+unsigned int ModelDatabase::PrefetchFile(const std::string &_filename)
+{
+  TiXmlDocument xmlDoc;
+  if (_filename.empty() || !xmlDoc.LoadFile(_filename))
+    return 0;
+
+  std::vector<std::string> uris;
+  if (xmlDoc.RootElement())
+    collectModelURIs(xmlDoc.RootElement(), uris);
+
+  return this->Prefetch(uris);
+}
+
+/////////////////////////////////////////////////
+void ModelDatabase::WaitForDownloads()
+{
+  boost::mutex::scoped_lock lock(this->downloadMutex);
+  while (!this->downloads.empty() && !this->stop)
+    this->downloadCondition.wait(lock);
+}
+
+/////////////////////////////////////////////////
+void ModelDatabase::SetMaxDownloads(unsigned int _count)
+{
+  boost::mutex::scoped_lock lock(this->downloadMutex);
+  this->maxDownloads = std::max(1u, _count);
 }
 
 /////////////////////////////////////////////////
@@ -20,6 +20,9 @@
 #include <string>
 #include <map>
 #include <list>
+#include <deque>
+#include <set>
+#include <vector>
 #include <boost/thread.hpp>
 #include <boost/thread/mutex.hpp>
 #include "gazebo/common/SingletonT.hh"
@@ -40,6 +43,13 @@ namespace gazebo
     /// \class ModelDatabase ModelDatabase.hh common/common.hh
     /// \brief Connects to model database, and has utility functions to find
     /// models.
+    ///
+    /// The list of models in the database is saved to an index file in
+    /// ~/.gazebo, so later runs know which models exist without querying
+    /// the database. Models can be downloaded in the background by a
+    /// bounded number of threads, see FetchModel and Prefetch. A blocking
+    /// request for a model that is already being downloaded waits for
+    /// that download instead of starting another one.
     class ModelDatabase : public SingletonT<ModelDatabase>
     {
       /// \brief Constructor. This will update the model cache
@@ -116,6 +126,48 @@ namespace gazebo
       /// \param[in] _path Path to a model.
       public: void DownloadDependencies(const std::string &_path);
 
+      /// \brief Get the local path to a model without blocking.
+      ///
+      /// If the model is not installed locally it is downloaded by one of
+      /// the download threads.
+      /// \param[in] _uri the model uri
+      /// \param[in] _func Called with the path to the model, or an empty
+      /// string on failure. It may be called from a download thread, or
+      /// from the calling thread if the model is already installed.
+      public: void FetchModel(const std::string &_uri,
+                  boost::function<void (const std::string &)> _func);
+
+      /// \brief Start downloading models in the background.
+      ///
+      /// Models that are installed locally, or already being downloaded,
+      /// are skipped.
+      /// \param[in] _uris URIs of the models, such as model://box.
+      /// \return Number of models that will be downloaded.
+      public: unsigned int Prefetch(const std::vector<std::string> &_uris);
+
+      /// \brief Start downloading every model referenced by a world or
+      /// model file in the background.
+      ///
+      /// All <uri> elements that start with model:// are prefetched, so
+      /// that the models download in parallel while the file is parsed.
+      /// \param[in] _filename SDF file to scan.
+      /// \return Number of models that will be downloaded.
+      public: unsigned int PrefetchFile(const std::string &_filename);
+
+      /// \brief Wait for all queued and running downloads to finish.
+      public: void WaitForDownloads();
+
+      /// \brief Set the maximum number of models that are downloaded at
+      /// the same time. The default is 4. Threads that are already running
+      /// are kept.
+      /// \param[in] _count Number of download threads, at least 1.
+      public: void SetMaxDownloads(unsigned int _count);
+
+      /// \brief Get the path of the file that stores the list of models
+      /// in the database.
+      /// \return Path of the index file.
+      public: static std::string GetIndexFilename();
+
       /// \brief Returns true if the model exists on the database.
       ///
       /// \param[in] _modelName URI of the model (eg:
@@ -123,6 +175,60 @@ namespace gazebo
       /// \return True if the model was found.
       public: bool HasModel(const std::string &_modelName);
 
+      /// \brief Get the name of the model directory in a URI, and the path
+      /// that follows it.
+      /// \param[in] _uri URI of a model or of a file inside a model.
+      /// \param[out] _modelName Name of the model directory.
+      /// \param[out] _suffix Rest of the path, starting with '/' if not
+      /// empty.
+      /// \return False if the URI is invalid.
+      private: bool SplitURI(const std::string &_uri, std::string &_modelName,
+                             std::string &_suffix);
+
+      /// \brief Get the directory where downloaded models are installed.
+      /// \return Path of the directory.
+      private: static std::string GetInstallPath();
+
+      /// \brief Find a model that is installed in one of the model paths.
+      /// Never downloads the model.
+      /// \param[in] _modelName Name of the model directory.
+      /// \return Path to the model, empty if it is not installed.
+      private: std::string FindInstalled(const std::string &_modelName);
+
+      /// \brief Queue the download of a model, unless it is already
+      /// queued or running. The downloadMutex must be locked.
+      /// \param[in] _modelName Name of the model directory.
+      /// \return True if the model was queued.
+      private: bool QueueDownload(const std::string &_modelName);
+
+      /// \brief Download and install a model. Dependencies are not
+      /// downloaded.
+      /// \param[in] _uri URI used in error messages.
+      /// \param[in] _modelName Name of the model directory.
+      /// \return Path to the installed model, empty on failure.
+      private: std::string DownloadModel(const std::string &_uri,
+                                         const std::string &_modelName);
+
+      /// \brief Used by the download threads to process the queue.
+      private: void RunDownloads();
+
+      /// \brief Mark a download as finished and wake anyone waiting on
+      /// it.
+      /// \param[in] _modelName Name of the model directory.
+      /// \return Callbacks waiting on the model, with the URI they asked
+      /// for.
+      private: std::list<std::pair<std::string,
+               boost::function<void (const std::string &)> > >
+               FinishDownload(const std::string &_modelName);
+
+      /// \brief Load the index file into the model cache, if it was saved
+      /// for the current database URI. The updateMutex must be locked.
+      private: void LoadIndex();
+
+      /// \brief Save the model cache to the index file. The updateMutex
+      /// must be locked.
+      private: void SaveIndex();
+
       /// \brief A helper function that uses CURL to get a manifest file.
       /// \param[in] _uri URI of a manifest XML file.
       /// \return The contents of the manifest file.
@@ -133,11 +239,35 @@ namespace gazebo
 
       /// \brief Used by ModelDatabase::UpdateModelCache,
       /// no one else should use this function.
-      private: bool UpdateModelCacheImpl();
+      /// \param[in] _known Models already known, whose names are not
+      /// downloaded again.
+      /// \param[out] _models All the models in the database.
+      /// \return True on success.
+      private: bool UpdateModelCacheImpl(
+                   const std::map<std::string, std::string> &_known,
+                   std::map<std::string, std::string> &_models);
+
+      /// \brief Call and clear the pending GetModels callbacks. The
+      /// updateMutex must be locked.
+      private: void RunCallbacks();
 
       /// \brief A dictionary of all model names indexed by their uri.
       private: std::map<std::string, std::string> modelCache;
 
+      /// \brief Database URI the model cache was loaded or downloaded
+      /// from.
+      private: std::string modelCacheURI;
+
+      /// \brief True when an update of the model cache was requested.
+      private: bool updateRequested;
+
+      /// \brief Number of updates of the model cache that finished,
+      /// successfully or not.
+      private: unsigned int updateCount;
+
+      /// \brief Signaled when an update of the model cache finishes.
+      private: boost::condition_variable updateDoneCondition;
+
       /// \brief True to stop the background thread
       private: bool stop;
 
@@ -159,6 +289,33 @@ namespace gazebo
       /// ModelDatabase::GetModels function.
       private: std::list<CallbackFunc> callbacks;
 
+      /// \def FetchFunc
+      /// \brief Boost function that is used to passback a model path.
+      private: typedef boost::function<void (const std::string &)> FetchFunc;
+
+      /// \brief Protects the download queue and the download threads.
+      private: boost::mutex downloadMutex;
+
+      /// \brief Signaled when a model is queued or a download finishes.
+      private: boost::condition_variable downloadCondition;
+
+      /// \brief Names of the models waiting for a download thread.
+      private: std::deque<std::string> downloadQueue;
+
+      /// \brief Names of the models that are queued or being downloaded.
+      private: std::set<std::string> downloads;
+
+      /// \brief Callbacks waiting on a download, with the URI they asked
+      /// for, indexed by model name.
+      private: std::map<std::string,
+               std::list<std::pair<std::string, FetchFunc> > > fetchCallbacks;
+
+      /// \brief Threads that download the queued models.
+      private: std::vector<boost::thread*> downloadThreads;
+
+      /// \brief Maximum number of download threads.
+      private: unsigned int maxDownloads;
+
       /// \brief Handy trick to automatically call a singleton's
       /// constructor.
       private: static ModelDatabase *myself;
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include <fstream>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/ModelDatabase.hh"
+
+using namespace gazebo;
+
+/// \brief Path of the model fetched by FetchModel
+static std::string fetchedPath;
+
+/////////////////////////////////////////////////
+/// \brief Write a file, creating its directory.
+static void writeFile(const boost::filesystem::path &_path,
+                      const std::string &_content)
+{
+  boost::filesystem::create_directories(_path.parent_path());
+  std::ofstream out(_path.string().c_str());
+  out << _content;
+}
+
+/////////////////////////////////////////////////
+/// \brief Callback of FetchModel
+static void onFetch(const std::string &_path)
+{
+  fetchedPath = _path;
+}
+
+/////////////////////////////////////////////////
+TEST(ModelDatabaseTest, LocalDatabase)
+{
+  // A database served from the file system, and an empty home directory
+  boost::filesystem::path root = boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("gz_model_db-%%%%-%%%%");
+  boost::filesystem::path db = root / "db";
+  boost::filesystem::path home = root / "home";
+  boost::filesystem::create_directories(home);
+
+  writeFile(db / "database.config",
+      "<database><name>test</name><models>"
+      "<uri>file://box</uri></models></database>");
+  writeFile(db / "box" / "model.config",
+      "<model><name>Box</name><sdf>model.sdf</sdf></model>");
+  writeFile(root / "src" / "box" / "model.config",
+      "<model><name>Box</name><sdf>model.sdf</sdf></model>");
+  writeFile(root / "src" / "box" / "model.sdf", "<sdf version='1.3'/>");
+  ASSERT_EQ(0, system(("tar czf " + (db / "box" / "model.tar.gz").string() +
+          " -C " + (root / "src").string() + " box").c_str()));
+
+  setenv("HOME", home.string().c_str(), 1);
+  setenv("GAZEBO_MODEL_DATABASE_URI", ("file://" + db.string()).c_str(), 1);
+
+  common::ModelDatabase *database = common::ModelDatabase::Instance();
+
+  // The model list is downloaded once, then saved to the index
+  std::map<std::string, std::string> models = database->GetModels();
+  ASSERT_EQ(1u, models.size());
+  EXPECT_EQ("Box", models.begin()->second);
+  EXPECT_TRUE(database->HasModel("model://box"));
+  EXPECT_FALSE(database->HasModel("model://sphere"));
+
+  std::ifstream index(common::ModelDatabase::GetIndexFilename().c_str());
+  std::string line;
+  ASSERT_TRUE(std::getline(index, line));
+  EXPECT_EQ(database->GetURI(), line);
+  ASSERT_TRUE(std::getline(index, line));
+  EXPECT_EQ(models.begin()->first + "\tBox", line);
+
+  // Download in the background
+  std::string installed = (home / ".gazebo" / "models" / "box").string();
+  std::vector<std::string> uris;
+  uris.push_back("model://box");
+  uris.push_back("model://box/model.sdf");
+  EXPECT_EQ(1u, database->Prefetch(uris));
+  database->WaitForDownloads();
+  EXPECT_TRUE(boost::filesystem::exists(installed + "/model.sdf"));
+
+  // Installed models are not downloaded again
+  EXPECT_EQ(0u, database->Prefetch(uris));
+  database->FetchModel("model://box/model.sdf", &onFetch);
+  EXPECT_EQ(installed + "/model.sdf", fetchedPath);
+  EXPECT_EQ(installed + "/model.sdf",
+            database->GetModelPath("model://box/model.sdf"));
+
+  boost::filesystem::remove_all(root);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
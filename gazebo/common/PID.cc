@@ -174,3 +174,26 @@ void PID::GetErrors(double &_pe, double &_ie, double &_de)
   _ie = this->iErr;
   _de = this->dErr;
 }
+
+/////////////////////////////////////////////////
+void PID::Snapshot(SnapshotBuffer &_buffer) const
+{
+  double values[5] = {this->pErrLast, this->pErr, this->iErr, this->dErr,
+                      this->cmd};
+  _buffer.WriteBytes(values, sizeof(values));
+}
+
+/////////////////////////////////////////////////
+bool PID::Restore(SnapshotBuffer &_buffer)
+{
+  double values[5];
+  if (!_buffer.ReadBytes(values, sizeof(values)))
+    return false;
+
+  this->pErrLast = values[0];
+  this->pErr = values[1];
+  this->iErr = values[2];
+  this->dErr = values[3];
+  this->cmd = values[4];
+  return true;
+}
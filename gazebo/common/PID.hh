@@ -19,6 +19,7 @@
 #define _GAZEBO_PID_HH_
 
 #include "common/Time.hh"
+#include "common/SnapshotBuffer.hh"
 
 namespace gazebo
 {
@@ -132,6 +133,15 @@ namespace gazebo
       /// \brief Reset the errors and command.
       public: void Reset();
 
+      /// \brief Write the errors and command, but not the gains.
+      /// \param[in] _buffer Buffer to write to.
+      public: void Snapshot(SnapshotBuffer &_buffer) const;
+
+      /// \brief Read the errors and command written by Snapshot.
+      /// \param[in] _buffer Buffer to read from.
+      /// \return False if the buffer is too short.
+      public: bool Restore(SnapshotBuffer &_buffer);
+
       /// \brief Error at a previous step.
       private: double pErrLast;
 
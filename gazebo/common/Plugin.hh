@@ -35,6 +35,7 @@
 #include "common/SystemPaths.hh"
 #include "common/Console.hh"
 #include "common/Exception.hh"
+#include "common/SnapshotBuffer.hh"
 
 #include "physics/PhysicsTypes.hh"
 #include "sensors/SensorTypes.hh"
@@ -241,6 +242,16 @@ namespace gazebo
 
     public: virtual void Init() {}
     public: virtual void Reset() {}
+
+    /// \brief Override this method to save the state of the plugin in a
+    /// world snapshot.
+    /// \param[in] _buffer Buffer to write the state to.
+    public: virtual void Snapshot(common::SnapshotBuffer &/*_buffer*/) {}
+
+    /// \brief Override this method to read back the state written by
+    /// Snapshot, when the world is restored.
+    /// \param[in] _buffer Buffer to read the state from.
+    public: virtual void Restore(common::SnapshotBuffer &/*_buffer*/) {}
   };
 
   /// \brief A plugin with access to physics::Model.  See
@@ -269,6 +280,16 @@ namespace gazebo
 
     /// \brief Override this method for custom plugin reset behavior.
     public: virtual void Reset() {}
+
+    /// \brief Override this method to save the state of the plugin in a
+    /// world snapshot.
+    /// \param[in] _buffer Buffer to write the state to.
+    public: virtual void Snapshot(common::SnapshotBuffer &/*_buffer*/) {}
+
+    /// \brief Override this method to read back the state written by
+    /// Snapshot, when the world is restored.
+    /// \param[in] _buffer Buffer to read the state from.
+    public: virtual void Restore(common::SnapshotBuffer &/*_buffer*/) {}
   };
 
   /// \class SensorPlugin Plugin.hh common/common.hh
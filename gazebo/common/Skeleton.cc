@@ -202,6 +202,12 @@ void Skeleton::SetNumVertAttached(unsigned int _vertices)
   this->rawNW.resize(_vertices);
 }
 
+//////////////////////////////////////////////////
+unsigned int Skeleton::GetNumVertAttached() const
+{
+  return this->rawNW.size();
+}
+
 //////////////////////////////////////////////////
 void Skeleton::AddVertNodeWeight(unsigned int _vertex, std::string _node,
                        double _weight)
@@ -111,6 +111,10 @@ namespace gazebo
       /// \param[in] _vertices the new size
       public: void SetNumVertAttached(unsigned int _vertices);
 
+      /// \brief Returns the size of the raw node weight array
+      /// \return the number of vertices with node weights
+      public: unsigned int GetNumVertAttached() const;
+
       /// \brief Add a new weight to a node (bone)
       /// \param[in] _vertex index of the vertex
       /// \param[in] _node name of the bone
@@ -14,6 +14,9 @@
  * limitations under the License.
  *
 */
+#include <math.h>
+#include <algorithm>
+
 #include <common/SkeletonAnimation.hh>
 #include <common/Console.hh>
 
@@ -131,13 +134,13 @@ math::Matrix4 NodeAnimation::GetFrameAt(double _time, bool _loop) const
 
   std::map<double, math::Matrix4>::const_iterator it2 = it1--;
 
-  if (it1 == this->keyFrames.begin() || math::equal(it1->first, time))
+  if (math::equal(it1->first, time))
     return it1->second;
 
   double nextKey = it2->first;
   math::Matrix4 nextTrans = it2->second;
   double prevKey = it1->first;
-  math::Matrix4 prevTrans = it2->second;
+  math::Matrix4 prevTrans = it1->second;
 
   double t = (time - prevKey) / (nextKey - prevKey);
   assert(t >= 0.0 && t <= 1.0);
@@ -194,6 +197,7 @@ double NodeAnimation::GetTimeAtX(const double _x) const
 SkeletonAnimation::SkeletonAnimation(const std::string& _name)
 {
   this->name = _name;
+  this->length = 0.0;
 }
 
 //////////////////////////////////////////////////
@@ -226,6 +230,19 @@ bool SkeletonAnimation::HasNode(const std::string& _node) const
   return (this->animations.find(_node) != this->animations.end());
 }
 
+//////////////////////////////////////////////////
+const NodeAnimation *SkeletonAnimation::GetNodeAnimation(
+    const std::string& _node) const
+{
+  std::map<std::string, NodeAnimation*>::const_iterator iter =
+    this->animations.find(_node);
+
+  if (iter == this->animations.end())
+    return NULL;
+
+  return iter->second;
+}
+
 //////////////////////////////////////////////////
 void SkeletonAnimation::AddKeyFrame(const std::string& _node,
     const double _time, const math::Matrix4 _mat)
@@ -323,3 +340,194 @@ double SkeletonAnimation::GetLength() const
 {
   return this->length;
 }
+
+//////////////////////////////////////////////////
+CompiledSkeletonAnimation::CompiledSkeletonAnimation(
+    const SkeletonAnimation &_animation,
+    const std::vector<std::string> &_nodeNames)
+{
+  this->length = _animation.GetLength();
+  this->frameStart.push_back(0);
+
+  for (unsigned int i = 0; i < _nodeNames.size(); ++i)
+  {
+    const NodeAnimation *node = _animation.GetNodeAnimation(_nodeNames[i]);
+
+    if (node && !node->keyFrames.empty())
+    {
+      for (std::map<double, math::Matrix4>::const_iterator iter =
+           node->keyFrames.begin(); iter != node->keyFrames.end(); ++iter)
+      {
+        this->times.push_back(iter->first);
+        this->positions.push_back(iter->second.GetTranslation());
+        this->rotations.push_back(iter->second.GetRotation());
+        this->transforms.push_back(iter->second);
+      }
+      this->nodeLengths.push_back(node->GetLength());
+    }
+    else
+      this->nodeLengths.push_back(0.0);
+
+    this->frameStart.push_back(this->times.size());
+  }
+
+  this->cursors.resize(_nodeNames.size(), 0);
+}
+
+//////////////////////////////////////////////////
+CompiledSkeletonAnimation::~CompiledSkeletonAnimation()
+{
+}
+
+//////////////////////////////////////////////////
+unsigned int CompiledSkeletonAnimation::GetNodeCount() const
+{
+  return this->nodeLengths.size();
+}
+
+//////////////////////////////////////////////////
+bool CompiledSkeletonAnimation::IsAnimated(unsigned int _node) const
+{
+  return _node < this->nodeLengths.size() &&
+    this->frameStart[_node + 1] > this->frameStart[_node];
+}
+
+//////////////////////////////////////////////////
+double CompiledSkeletonAnimation::GetLength() const
+{
+  return this->length;
+}
+
+//////////////////////////////////////////////////
+void CompiledSkeletonAnimation::GetFrameAt(unsigned int _node, double _time,
+    bool _loop, math::Matrix4 &_frame)
+{
+  unsigned int start = this->frameStart[_node];
+  unsigned int count = this->frameStart[_node + 1] - start;
+  double nodeLength = this->nodeLengths[_node];
+
+  double time = _time;
+  if (time > nodeLength)
+  {
+    // Wrap into (0, length], like the loop in NodeAnimation::GetFrameAt
+    if (_loop && nodeLength > 0)
+    {
+      time = fmod(time, nodeLength);
+      if (time <= 0)
+        time = nodeLength;
+    }
+    else
+      time = nodeLength;
+  }
+
+  if (math::equal(time, nodeLength))
+  {
+    _frame = this->transforms[start + count - 1];
+    return;
+  }
+
+  const double *keys = &this->times[start];
+
+  // Find the last key frame at or before the time, starting from the key
+  // frame of the previous evaluation
+  unsigned int cursor = this->cursors[_node];
+  if (cursor >= count || keys[cursor] > time)
+  {
+    cursor = std::upper_bound(keys, keys + count, time) - keys;
+    cursor = cursor > 0 ? cursor - 1 : 0;
+  }
+  else
+  {
+    while (cursor + 1 < count && keys[cursor + 1] <= time)
+      ++cursor;
+  }
+  this->cursors[_node] = cursor;
+
+  unsigned int prev = start + cursor;
+  if (time <= keys[cursor] || math::equal(keys[cursor], time) ||
+      cursor + 1 >= count)
+  {
+    _frame = this->transforms[prev];
+    return;
+  }
+
+  unsigned int next = prev + 1;
+  if (math::equal(this->times[next], time))
+  {
+    _frame = this->transforms[next];
+    return;
+  }
+
+  double t = (time - this->times[prev]) /
+    (this->times[next] - this->times[prev]);
+
+  const math::Vector3 &prevPos = this->positions[prev];
+  const math::Vector3 &nextPos = this->positions[next];
+  math::Quaternion rot = math::Quaternion::Slerp(t, this->rotations[prev],
+      this->rotations[next], true);
+
+  _frame = rot.GetAsMatrix4();
+  _frame.SetTranslate(prevPos + (nextPos - prevPos) * t);
+}
+
+//////////////////////////////////////////////////
+void CompiledSkeletonAnimation::GetPoseAt(double _time, bool _loop,
+    math::Matrix4 *_pose)
+{
+  for (unsigned int i = 0; i < this->nodeLengths.size(); ++i)
+  {
+    if (this->frameStart[i + 1] > this->frameStart[i])
+      this->GetFrameAt(i, _time, _loop, _pose[i]);
+  }
+}
+
+//////////////////////////////////////////////////
+double CompiledSkeletonAnimation::GetTimeAtX(unsigned int _node,
+    double _x) const
+{
+  unsigned int first = this->frameStart[_node];
+  unsigned int last = this->frameStart[_node + 1] - 1;
+
+  unsigned int i = first;
+  while (i < last && this->positions[i].x < _x)
+    ++i;
+
+  if (i == first || math::equal(this->positions[i].x, _x))
+    return this->times[i];
+
+  double x1 = this->positions[i - 1].x;
+  double x2 = this->positions[i].x;
+  double t1 = this->times[i - 1];
+  double t2 = this->times[i];
+
+  return t1 + ((t2 - t1) * (_x - x1) / (x2 - x1));
+}
+
+//////////////////////////////////////////////////
+void CompiledSkeletonAnimation::GetPoseAtX(double _x, unsigned int _node,
+    bool _loop, math::Matrix4 *_pose)
+{
+  if (!this->IsAnimated(_node))
+  {
+    gzerr << "Node " << _node << " is not animated\n";
+    return;
+  }
+
+  double firstX = this->positions[this->frameStart[_node]].x;
+  double lastX = this->positions[this->frameStart[_node + 1] - 1].x;
+
+  double x = _x;
+  if (x < firstX)
+    x = firstX;
+
+  if (x > lastX && !_loop)
+    x = lastX;
+  if (x > lastX && lastX > 0)
+  {
+    x = fmod(x, lastX);
+    if (x <= 0)
+      x = lastX;
+  }
+
+  this->GetPoseAt(this->GetTimeAtX(_node, x), _loop, _pose);
+}
@@ -23,6 +23,7 @@
 #include <map>
 #include <utility>
 #include <string>
+#include <vector>
 
 namespace gazebo
 {
@@ -114,6 +115,9 @@ namespace gazebo
 
       /// \brief the duration of the animations (time of last key frame)
       protected: double length;
+
+      /// \brief Reads the key frames when compiling an animation.
+      private: friend class CompiledSkeletonAnimation;
     };
 
     /// \brief Skeleton animation
@@ -144,6 +148,12 @@ namespace gazebo
       /// \return true if the node exits
       public: bool HasNode(const std::string& _node) const;
 
+      /// \brief Returns the animation of a node
+      /// \param[in] _node the name of the node
+      /// \return the node animation, or NULL if the node is not animated
+      public: const NodeAnimation *GetNodeAnimation(
+                      const std::string& _node) const;
+
       /// \brief Adds or replaces a named key frame at a specific time
       /// \param[in] _node the name of the new or existing node
       /// \param[in] _time the time
@@ -209,6 +219,103 @@ namespace gazebo
       /// \brief a dictionary of node animations
       protected: std::map<std::string, NodeAnimation*> animations;
     };
+
+    /// \class CompiledSkeletonAnimation SkeletonAnimation.hh
+    /// common/common.hh
+    /// \brief A skeleton animation flattened into arrays for fast
+    /// evaluation.
+    ///
+    /// Nodes are addressed by index instead of name, and the key frames of
+    /// all the nodes are stored in contiguous time, position and rotation
+    /// arrays. The key frame used by the previous evaluation of each node
+    /// is kept, so evaluating an animation that plays forward does not
+    /// search the key frames. Poses are written to a buffer owned by the
+    /// caller, so an evaluation allocates no memory.
+    class CompiledSkeletonAnimation
+    {
+      /// \brief Constructor
+      /// \param[in] _animation Animation to compile. Later changes to the
+      /// animation are not seen by the compiled animation.
+      /// \param[in] _nodeNames Name of the animation node evaluated in each
+      /// slot of a pose. Names that are not animated leave their slot
+      /// unchanged.
+      public: CompiledSkeletonAnimation(const SkeletonAnimation &_animation,
+                  const std::vector<std::string> &_nodeNames);
+
+      /// \brief Destructor
+      public: ~CompiledSkeletonAnimation();
+
+      /// \brief Returns the number of slots in a pose
+      /// \return the number of node names given to the constructor
+      public: unsigned int GetNodeCount() const;
+
+      /// \brief Returns true if a slot is animated
+      /// \param[in] _node the slot index
+      /// \return true if the slot has key frames
+      public: bool IsAnimated(unsigned int _node) const;
+
+      /// \brief Returns the duration of the animation
+      /// \return the duration in seconds
+      public: double GetLength() const;
+
+      /// \brief Evaluates every animated slot at a specific time. See
+      /// SkeletonAnimation::GetPoseAt.
+      /// \param[in] _time the time
+      /// \param[in] _loop when true, the time is divided by the duration
+      /// \param[out] _pose GetNodeCount() transformations, one per slot
+      public: void GetPoseAt(double _time, bool _loop, math::Matrix4 *_pose);
+
+      /// \brief Evaluates every animated slot at the time where a slot's
+      /// translational value along the X axis is equal to _x. See
+      /// SkeletonAnimation::GetPoseAtX.
+      /// \param[in] _x the value along x
+      /// \param[in] _node the slot that drives the time
+      /// \param[in] _loop when true, the time is divided by the duration
+      /// \param[out] _pose GetNodeCount() transformations, one per slot
+      public: void GetPoseAtX(double _x, unsigned int _node, bool _loop,
+                              math::Matrix4 *_pose);
+
+      /// \brief Evaluates one slot at a specific time
+      /// \param[in] _node the slot index, which must be animated
+      /// \param[in] _time the time
+      /// \param[in] _loop when true, the time is divided by the duration
+      /// \param[out] _frame the transformation
+      private: void GetFrameAt(unsigned int _node, double _time, bool _loop,
+                               math::Matrix4 &_frame);
+
+      /// \brief Returns the time where a slot's translational value along
+      /// the X axis is equal to _x. See NodeAnimation::GetTimeAtX.
+      /// \param[in] _node the slot index, which must be animated
+      /// \param[in] _x the value along x
+      /// \return the time
+      private: double GetTimeAtX(unsigned int _node, double _x) const;
+
+      /// \brief Index of the first key frame of each slot, plus the total
+      /// number of key frames.
+      private: std::vector<unsigned int> frameStart;
+
+      /// \brief Duration of the key frames of each slot.
+      private: std::vector<double> nodeLengths;
+
+      /// \brief Key frame used by the last evaluation of each slot,
+      /// relative to the first key frame of the slot.
+      private: std::vector<unsigned int> cursors;
+
+      /// \brief Time of every key frame.
+      private: std::vector<double> times;
+
+      /// \brief Translation of every key frame.
+      private: std::vector<math::Vector3> positions;
+
+      /// \brief Rotation of every key frame.
+      private: std::vector<math::Quaternion> rotations;
+
+      /// \brief Transformation of every key frame.
+      private: std::vector<math::Matrix4> transforms;
+
+      /// \brief The duration of the longest node animation.
+      private: double length;
+    };
     /// \}
   }
 }
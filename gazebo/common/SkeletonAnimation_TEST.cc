@@ -0,0 +1,119 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "gazebo/common/SkeletonAnimation.hh"
+
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+/// \brief Expect two transformations to be equal
+static void expectEqual(const math::Matrix4 &_a, const math::Matrix4 &_b)
+{
+  for (int i = 0; i < 4; ++i)
+    for (int j = 0; j < 4; ++j)
+      EXPECT_NEAR(_a[i][j], _b[i][j], 1e-9);
+}
+
+/////////////////////////////////////////////////
+/// \brief Build an animation with two nodes walking along x
+static common::SkeletonAnimation *makeAnimation()
+{
+  common::SkeletonAnimation *anim = new common::SkeletonAnimation("walk");
+  for (int i = 0; i <= 10; ++i)
+  {
+    anim->AddKeyFrame("hip", i * 0.1,
+        math::Pose(i * 0.2, 0, 1, 0, 0, i * 0.05));
+    anim->AddKeyFrame("knee", i * 0.2,
+        math::Pose(0, 0.1 * i, 0.5, i * 0.1, 0, 0));
+  }
+  return anim;
+}
+
+/////////////////////////////////////////////////
+TEST(SkeletonAnimationTest, NodeInterpolation)
+{
+  common::NodeAnimation node("node");
+  node.AddKeyFrame(0.0, math::Pose(0, 0, 0, 0, 0, 0));
+  node.AddKeyFrame(1.0, math::Pose(2, 0, 0, 0, 0, 1));
+
+  // Half way between the two key frames
+  math::Matrix4 mat = node.GetFrameAt(0.5);
+  EXPECT_NEAR(1.0, mat.GetTranslation().x, 1e-9);
+  EXPECT_NEAR(0.5, mat.GetRotation().GetAsEuler().z, 1e-9);
+
+  // Exact key frames
+  EXPECT_NEAR(0.0, node.GetFrameAt(0.0).GetTranslation().x, 1e-9);
+  EXPECT_NEAR(2.0, node.GetFrameAt(1.0).GetTranslation().x, 1e-9);
+}
+
+/////////////////////////////////////////////////
+TEST(SkeletonAnimationTest, CompiledMatchesMap)
+{
+  common::SkeletonAnimation *anim = makeAnimation();
+
+  std::vector<std::string> names;
+  names.push_back("knee");
+  names.push_back("missing");
+  names.push_back("hip");
+
+  common::CompiledSkeletonAnimation compiled(*anim, names);
+  EXPECT_EQ(3u, compiled.GetNodeCount());
+  EXPECT_TRUE(compiled.IsAnimated(0));
+  EXPECT_FALSE(compiled.IsAnimated(1));
+  EXPECT_TRUE(compiled.IsAnimated(2));
+  EXPECT_DOUBLE_EQ(anim->GetLength(), compiled.GetLength());
+
+  std::vector<math::Matrix4> pose(3, math::Matrix4::IDENTITY);
+  math::Matrix4 marker(math::Matrix4::IDENTITY);
+  marker.SetTranslate(math::Vector3(7, 7, 7));
+
+  // Forward, backward, looped and exact key frame times
+  double times[] = {0.0, 0.05, 0.13, 0.2, 0.57, 0.99, 1.0, 0.31, 1.45, 3.7};
+  for (unsigned int i = 0; i < sizeof(times) / sizeof(times[0]); ++i)
+  {
+    pose[1] = marker;
+    compiled.GetPoseAt(times[i], true, &pose[0]);
+
+    std::map<std::string, math::Matrix4> expected =
+      anim->GetPoseAt(times[i], true);
+    expectEqual(expected["knee"], pose[0]);
+    expectEqual(expected["hip"], pose[2]);
+
+    // Slots that are not animated are left unchanged
+    expectEqual(marker, pose[1]);
+  }
+
+  // Without looping the last key frame is held
+  compiled.GetPoseAt(5.0, false, &pose[0]);
+  expectEqual(anim->GetPoseAt(5.0, false)["hip"], pose[2]);
+
+  // Driven by the hip translation along x
+  compiled.GetPoseAtX(0.7, 2, true, &pose[0]);
+  expectEqual(anim->GetPoseAtX(0.7, "hip", true)["knee"], pose[0]);
+  expectEqual(anim->GetPoseAtX(0.7, "hip", true)["hip"], pose[2]);
+
+  delete anim;
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
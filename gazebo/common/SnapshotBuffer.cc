@@ -0,0 +1,221 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <string.h>
+
+#include "common/SnapshotBuffer.hh"
+
+using namespace gazebo;
+using namespace common;
+
+//////////////////////////////////////////////////
+SnapshotBuffer::SnapshotBuffer()
+  : position(0)
+{
+}
+
+//////////////////////////////////////////////////
+SnapshotBuffer::~SnapshotBuffer()
+{
+}
+
+//////////////////////////////////////////////////
+void SnapshotBuffer::Clear()
+{
+  this->data.clear();
+  this->position = 0;
+}
+
+//////////////////////////////////////////////////
+void SnapshotBuffer::Rewind()
+{
+  this->position = 0;
+}
+
+//////////////////////////////////////////////////
+const char *SnapshotBuffer::GetData() const
+{
+  return this->data.empty() ? NULL : &this->data[0];
+}
+
+//////////////////////////////////////////////////
+size_t SnapshotBuffer::GetSize() const
+{
+  return this->data.size();
+}
+
+//////////////////////////////////////////////////
+void SnapshotBuffer::SetData(const char *_data, size_t _size)
+{
+  this->data.assign(_data, _data + _size);
+  this->position = 0;
+}
+
+//////////////////////////////////////////////////
+size_t SnapshotBuffer::GetPosition() const
+{
+  return this->position;
+}
+
+//////////////////////////////////////////////////
+bool SnapshotBuffer::Seek(size_t _position)
+{
+  if (_position > this->data.size())
+    return false;
+
+  this->position = _position;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SnapshotBuffer::WriteBytes(const void *_data, size_t _size)
+{
+  if (_size == 0)
+    return;
+
+  size_t offset = this->data.size();
+  this->data.resize(offset + _size);
+  memcpy(&this->data[offset], _data, _size);
+}
+
+//////////////////////////////////////////////////
+bool SnapshotBuffer::ReadBytes(void *_data, size_t _size)
+{
+  if (_size > this->data.size() - this->position)
+    return false;
+
+  if (_size > 0)
+    memcpy(_data, &this->data[this->position], _size);
+  this->position += _size;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SnapshotBuffer::Write(const std::string &_value)
+{
+  this->Write(static_cast<uint32_t>(_value.size()));
+  this->WriteBytes(_value.data(), _value.size());
+}
+
+//////////////////////////////////////////////////
+bool SnapshotBuffer::Read(std::string &_value)
+{
+  uint32_t size = 0;
+  if (!this->Read(size) || size > this->data.size() - this->position)
+    return false;
+
+  _value.assign(&this->data[0] + this->position, size);
+  this->position += size;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SnapshotBuffer::Write(const math::Vector3 &_value)
+{
+  double values[3] = {_value.x, _value.y, _value.z};
+  this->WriteBytes(values, sizeof(values));
+}
+
+//////////////////////////////////////////////////
+bool SnapshotBuffer::Read(math::Vector3 &_value)
+{
+  double values[3];
+  if (!this->ReadBytes(values, sizeof(values)))
+    return false;
+
+  _value.Set(values[0], values[1], values[2]);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SnapshotBuffer::Write(const math::Quaternion &_value)
+{
+  double values[4] = {_value.w, _value.x, _value.y, _value.z};
+  this->WriteBytes(values, sizeof(values));
+}
+
+//////////////////////////////////////////////////
+bool SnapshotBuffer::Read(math::Quaternion &_value)
+{
+  double values[4];
+  if (!this->ReadBytes(values, sizeof(values)))
+    return false;
+
+  // Set the members directly, since Quaternion::Set normalizes
+  _value.w = values[0];
+  _value.x = values[1];
+  _value.y = values[2];
+  _value.z = values[3];
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SnapshotBuffer::Write(const math::Pose &_value)
+{
+  this->Write(_value.pos);
+  this->Write(_value.rot);
+}
+
+//////////////////////////////////////////////////
+bool SnapshotBuffer::Read(math::Pose &_value)
+{
+  return this->Read(_value.pos) && this->Read(_value.rot);
+}
+
+//////////////////////////////////////////////////
+void SnapshotBuffer::Write(const Time &_value)
+{
+  int32_t values[2] = {_value.sec, _value.nsec};
+  this->WriteBytes(values, sizeof(values));
+}
+
+//////////////////////////////////////////////////
+bool SnapshotBuffer::Read(Time &_value)
+{
+  int32_t values[2];
+  if (!this->ReadBytes(values, sizeof(values)))
+    return false;
+
+  _value.sec = values[0];
+  _value.nsec = values[1];
+  return true;
+}
+
+//////////////////////////////////////////////////
+size_t SnapshotBuffer::BeginBlock()
+{
+  size_t handle = this->data.size();
+  this->Write(static_cast<uint32_t>(0));
+  return handle;
+}
+
+//////////////////////////////////////////////////
+void SnapshotBuffer::EndBlock(size_t _handle)
+{
+  uint32_t size = this->data.size() - _handle - sizeof(uint32_t);
+  memcpy(&this->data[_handle], &size, sizeof(size));
+}
+
+//////////////////////////////////////////////////
+bool SnapshotBuffer::ReadBlock(size_t &_end)
+{
+  uint32_t size = 0;
+  if (!this->Read(size) || size > this->data.size() - this->position)
+    return false;
+
+  _end = this->position + size;
+  return true;
+}
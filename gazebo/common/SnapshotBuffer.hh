@@ -0,0 +1,183 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _SNAPSHOTBUFFER_HH_
+#define _SNAPSHOTBUFFER_HH_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_pod.hpp>
+
+#include "math/Pose.hh"
+#include "math/Vector3.hh"
+#include "math/Quaternion.hh"
+#include "common/Time.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \class SnapshotBuffer SnapshotBuffer.hh common/common.hh
+    /// \brief Flat binary buffer that holds the state of a simulation,
+    /// see physics::World::Snapshot.
+    ///
+    /// Values are stored in the native byte order with no type
+    /// information, so a buffer can only be read back by the same build,
+    /// in the order it was written. The memory is kept by Clear, so a
+    /// buffer that is reused doesn't allocate.
+    class SnapshotBuffer
+    {
+      /// \brief Constructor
+      public: SnapshotBuffer();
+
+      /// \brief Destructor
+      public: virtual ~SnapshotBuffer();
+
+      /// \brief Remove all the data and go back to the start.
+      public: void Clear();
+
+      /// \brief Go back to the start, to read the data again.
+      public: void Rewind();
+
+      /// \brief Get the data.
+      /// \return Pointer to GetSize() bytes.
+      public: const char *GetData() const;
+
+      /// \brief Get the size of the data.
+      /// \return Number of bytes written.
+      public: size_t GetSize() const;
+
+      /// \brief Replace the data, for example with a buffer saved to a
+      /// file, and go back to the start.
+      /// \param[in] _data Data to copy.
+      /// \param[in] _size Number of bytes.
+      public: void SetData(const char *_data, size_t _size);
+
+      /// \brief Get the read position.
+      /// \return Offset of the next byte to read.
+      public: size_t GetPosition() const;
+
+      /// \brief Set the read position.
+      /// \param[in] _position New offset, at most GetSize().
+      /// \return False if the position is past the end.
+      public: bool Seek(size_t _position);
+
+      /// \brief Append bytes.
+      /// \param[in] _data Bytes to append.
+      /// \param[in] _size Number of bytes.
+      public: void WriteBytes(const void *_data, size_t _size);
+
+      /// \brief Read bytes.
+      /// \param[out] _data Where to copy the bytes.
+      /// \param[in] _size Number of bytes.
+      /// \return False if fewer than _size bytes are left.
+      public: bool ReadBytes(void *_data, size_t _size);
+
+      /// \brief Append a value of a plain old data type.
+      /// \param[in] _value Value to append.
+      public: template<typename T>
+              void Write(const T &_value)
+              {
+                BOOST_STATIC_ASSERT(boost::is_pod<T>::value);
+                this->WriteBytes(&_value, sizeof(T));
+              }
+
+      /// \brief Read a value of a plain old data type.
+      /// \param[out] _value Value read.
+      /// \return False if the end of the data was reached.
+      public: template<typename T>
+              bool Read(T &_value)
+              {
+                BOOST_STATIC_ASSERT(boost::is_pod<T>::value);
+                return this->ReadBytes(&_value, sizeof(T));
+              }
+
+      /// \brief Append a string.
+      /// \param[in] _value String to append.
+      public: void Write(const std::string &_value);
+
+      /// \brief Read a string.
+      /// \param[out] _value String read.
+      /// \return False if the end of the data was reached.
+      public: bool Read(std::string &_value);
+
+      /// \brief Append a vector.
+      /// \param[in] _value Vector to append.
+      public: void Write(const math::Vector3 &_value);
+
+      /// \brief Read a vector.
+      /// \param[out] _value Vector read.
+      /// \return False if the end of the data was reached.
+      public: bool Read(math::Vector3 &_value);
+
+      /// \brief Append a quaternion.
+      /// \param[in] _value Quaternion to append.
+      public: void Write(const math::Quaternion &_value);
+
+      /// \brief Read a quaternion.
+      /// \param[out] _value Quaternion read.
+      /// \return False if the end of the data was reached.
+      public: bool Read(math::Quaternion &_value);
+
+      /// \brief Append a pose.
+      /// \param[in] _value Pose to append.
+      public: void Write(const math::Pose &_value);
+
+      /// \brief Read a pose.
+      /// \param[out] _value Pose read.
+      /// \return False if the end of the data was reached.
+      public: bool Read(math::Pose &_value);
+
+      /// \brief Append a time.
+      /// \param[in] _value Time to append.
+      public: void Write(const Time &_value);
+
+      /// \brief Read a time.
+      /// \param[out] _value Time read.
+      /// \return False if the end of the data was reached.
+      public: bool Read(Time &_value);
+
+      /// \brief Start a block of data, written by code that the reader
+      /// may not trust to read back exactly what it wrote, like a plugin.
+      /// \return Handle to give to EndBlock.
+      public: size_t BeginBlock();
+
+      /// \brief Finish a block started by BeginBlock.
+      /// \param[in] _handle Value returned by BeginBlock.
+      public: void EndBlock(size_t _handle);
+
+      /// \brief Start reading a block.
+      /// \param[out] _end Position after the block, to give to Seek once
+      /// the block is read.
+      /// \return False if the block is truncated.
+      public: bool ReadBlock(size_t &_end);
+
+      /// \brief The data.
+      private: std::vector<char> data;
+
+      /// \brief Read position.
+      private: size_t position;
+    };
+    /// \}
+  }
+}
+#endif
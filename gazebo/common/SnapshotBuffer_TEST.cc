@@ -0,0 +1,106 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "gazebo/common/SnapshotBuffer.hh"
+
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+TEST(SnapshotBufferTest, RoundTrip)
+{
+  common::SnapshotBuffer buffer;
+  EXPECT_EQ(0u, buffer.GetSize());
+
+  buffer.Write(static_cast<uint32_t>(42));
+  buffer.Write(-1.5);
+  buffer.Write(std::string("gazebo"));
+  buffer.Write(math::Pose(1, 2, 3, 0.1, 0.2, 0.3));
+  buffer.Write(common::Time(5, 600));
+
+  uint32_t u = 0;
+  double d = 0;
+  std::string s;
+  math::Pose p;
+  common::Time t;
+  EXPECT_TRUE(buffer.Read(u));
+  EXPECT_TRUE(buffer.Read(d));
+  EXPECT_TRUE(buffer.Read(s));
+  EXPECT_TRUE(buffer.Read(p));
+  EXPECT_TRUE(buffer.Read(t));
+  EXPECT_EQ(42u, u);
+  EXPECT_DOUBLE_EQ(-1.5, d);
+  EXPECT_EQ("gazebo", s);
+  EXPECT_EQ(math::Pose(1, 2, 3, 0.1, 0.2, 0.3), p);
+  EXPECT_EQ(common::Time(5, 600), t);
+  EXPECT_EQ(buffer.GetSize(), buffer.GetPosition());
+
+  // Nothing is left to read
+  EXPECT_FALSE(buffer.Read(u));
+
+  // Copies read the same data
+  common::SnapshotBuffer copy;
+  copy.SetData(buffer.GetData(), buffer.GetSize());
+  EXPECT_TRUE(copy.Read(u));
+  EXPECT_EQ(42u, u);
+
+  // The data is kept until Clear
+  buffer.Rewind();
+  EXPECT_TRUE(buffer.Read(u));
+  EXPECT_EQ(42u, u);
+  buffer.Clear();
+  EXPECT_EQ(0u, buffer.GetSize());
+  EXPECT_FALSE(buffer.Read(u));
+}
+
+/////////////////////////////////////////////////
+TEST(SnapshotBufferTest, Blocks)
+{
+  common::SnapshotBuffer buffer;
+
+  size_t handle = buffer.BeginBlock();
+  buffer.Write(1.0);
+  buffer.Write(2.0);
+  buffer.EndBlock(handle);
+  buffer.Write(static_cast<int32_t>(7));
+
+  // Skip the end of a block that was only partly read
+  size_t end = 0;
+  double d = 0;
+  ASSERT_TRUE(buffer.ReadBlock(end));
+  EXPECT_TRUE(buffer.Read(d));
+  EXPECT_DOUBLE_EQ(1.0, d);
+  EXPECT_TRUE(buffer.Seek(end));
+
+  int32_t i = 0;
+  EXPECT_TRUE(buffer.Read(i));
+  EXPECT_EQ(7, i);
+  EXPECT_FALSE(buffer.Seek(buffer.GetSize() + 1));
+
+  // A truncated block is an error
+  common::SnapshotBuffer truncated;
+  truncated.SetData(buffer.GetData(), 8);
+  EXPECT_FALSE(truncated.ReadBlock(end));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
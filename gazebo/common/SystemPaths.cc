@@ -42,6 +42,7 @@ using namespace common;
 //////////////////////////////////////////////////
 SystemPaths::SystemPaths()
 {
+  this->snapshotMode = false;
   this->gazeboPaths.clear();
   this->ogrePaths.clear();
   this->pluginPaths.clear();
@@ -261,21 +262,30 @@ std::string SystemPaths::FindFileURI(const std::string &_uri)
   // .gazebo/models
   if (prefix == "model")
   {
-    boost::filesystem::path path;
-    for (std::list<std::string>::iterator iter = this->modelPaths.begin();
-         iter != this->modelPaths.end(); ++iter)
+    if (!this->GetCachedFile(_uri, filename))
     {
-      path = boost::filesystem::path(*iter) / suffix;
-      if (boost::filesystem::exists(path))
+      boost::filesystem::path path;
+      for (std::list<std::string>::iterator iter = this->modelPaths.begin();
+           iter != this->modelPaths.end(); ++iter)
       {
-        filename = path.string();
-        break;
+        path = boost::filesystem::path(*iter) / suffix;
+        if (this->Exists(path.string()))
+        {
+          filename = path.string();
+          break;
+        }
       }
+
+      this->SetCachedFile(_uri, filename);
     }
 
     // Try to download the model if it wasn't found.
     if (filename.empty())
+    {
       filename = ModelDatabase::Instance()->GetModelPath(_uri, true);
+      if (!filename.empty())
+        this->SetCachedFile(_uri, filename);
+    }
   }
   else if (prefix.empty() || prefix == "file")
   {
@@ -308,11 +318,12 @@ std::string SystemPaths::FindFile(const std::string &_filename,
   else
   {
     bool found = false;
+    boost::filesystem::path currentPath;
 
     try
     {
-      path = boost::filesystem::operator/(boost::filesystem::current_path(),
-          _filename);
+      currentPath = boost::filesystem::current_path();
+      path = boost::filesystem::operator/(currentPath, _filename);
     }
     catch(boost::filesystem3::filesystem_error &_e)
     {
@@ -320,26 +331,34 @@ std::string SystemPaths::FindFile(const std::string &_filename,
       return std::string();
     }
 
-    if (_searchLocalPath && boost::filesystem::exists(path))
+    // Reading the paths first clears the cache if they changed.
+    std::list<std::string> paths = this->GetGazeboPaths();
+
+    // Relative file names depend on the working directory
+    std::string key = std::string(_searchLocalPath ? "1" : "0") +
+      currentPath.string() + "\n" + _filename;
+    std::string result;
+    if (this->GetCachedFile(key, result))
+      return result;
+
+    if (_searchLocalPath && this->Exists(path.string()))
     {
       found = true;
     }
     else if ((_filename[0] == '/' || _filename[0] == '.' || _searchLocalPath)
-             && boost::filesystem::exists(boost::filesystem::path(_filename)))
+             && this->Exists(_filename))
     {
       path = boost::filesystem::path(_filename);
       found = true;
     }
     else
     {
-      std::list<std::string> paths = this->GetGazeboPaths();
-
       for (std::list<std::string>::const_iterator iter = paths.begin();
           iter != paths.end() && !found; ++iter)
       {
         path = boost::filesystem::path((*iter));
         path = boost::filesystem::operator/(path, _filename);
-        if (boost::filesystem::exists(path))
+        if (this->Exists(path.string()))
         {
           found = true;
           break;
@@ -352,7 +371,7 @@ std::string SystemPaths::FindFile(const std::string &_filename,
           path = boost::filesystem::path(*iter);
           path = boost::filesystem::operator/(path, *suffixIter);
           path = boost::filesystem::operator/(path, _filename);
-          if (boost::filesystem::exists(path))
+          if (this->Exists(path.string()))
           {
             found = true;
             break;
@@ -361,40 +380,137 @@ std::string SystemPaths::FindFile(const std::string &_filename,
       }
     }
 
-    if (!found)
-      return std::string();
+    if (found)
+      result = path.string();
+    this->SetCachedFile(key, result);
+    return result;
   }
 
-  if (!boost::filesystem::exists(path))
+  std::string result;
+  if (!this->GetCachedFile(path.string(), result))
   {
+    if (this->Exists(path.string()))
+      result = path.string();
+    this->SetCachedFile(path.string(), result);
+  }
+
+  if (result.empty())
     gzerr << "File or path does not exist[" << path << "]\n";
-    return std::string();
+
+  return result;
+}
+
+/////////////////////////////////////////////////
+bool SystemPaths::Exists(const std::string &_path)
+{
+  boost::mutex::scoped_lock lock(this->cacheMutex);
+  if (!this->snapshotMode)
+    return boost::filesystem::exists(_path);
+
+  // Paths with . or .. are not in the listings
+  boost::filesystem::path path(_path);
+  for (boost::filesystem::path::iterator iter = path.begin();
+       iter != path.end(); ++iter)
+  {
+    if (*iter == "." || *iter == "..")
+      return boost::filesystem::exists(path);
+  }
+
+  std::string parent = path.parent_path().string();
+  if (parent.empty())
+    parent = ".";
+
+  std::map<std::string, std::set<std::string> >::iterator listing =
+    this->dirListings.find(parent);
+  if (listing == this->dirListings.end())
+  {
+    // List the directory once. A missing directory has no entries.
+    listing = this->dirListings.insert(
+        std::make_pair(parent, std::set<std::string>())).first;
+
+    boost::system::error_code ec;
+    boost::filesystem::directory_iterator end;
+    for (boost::filesystem::directory_iterator dirIter(parent, ec);
+         !ec && dirIter != end; dirIter.increment(ec))
+    {
+      listing->second.insert(dirIter->path().filename().string());
+    }
   }
 
-  return path.string();
+  return listing->second.find(path.filename().string()) !=
+    listing->second.end();
+}
+
+/////////////////////////////////////////////////
+bool SystemPaths::GetCachedFile(const std::string &_key,
+                                std::string &_result)
+{
+  boost::mutex::scoped_lock lock(this->cacheMutex);
+  std::map<std::string, std::string>::iterator iter =
+    this->fileCache.find(_key);
+  if (iter == this->fileCache.end())
+    return false;
+
+  _result = iter->second;
+  return true;
+}
+
+/////////////////////////////////////////////////
+void SystemPaths::SetCachedFile(const std::string &_key,
+                                const std::string &_result)
+{
+  boost::mutex::scoped_lock lock(this->cacheMutex);
+  this->fileCache[_key] = _result;
+}
+
+/////////////////////////////////////////////////
+void SystemPaths::ClearFileCache()
+{
+  boost::mutex::scoped_lock lock(this->cacheMutex);
+  this->fileCache.clear();
+  this->dirListings.clear();
+}
+
+/////////////////////////////////////////////////
+void SystemPaths::SetSnapshotMode(bool _enable)
+{
+  boost::mutex::scoped_lock lock(this->cacheMutex);
+  this->snapshotMode = _enable;
+  this->dirListings.clear();
+}
+
+/////////////////////////////////////////////////
+bool SystemPaths::GetSnapshotMode()
+{
+  boost::mutex::scoped_lock lock(this->cacheMutex);
+  return this->snapshotMode;
 }
 
 /////////////////////////////////////////////////
 void SystemPaths::ClearGazeboPaths()
 {
+  this->ClearFileCache();
   this->gazeboPaths.clear();
 }
 
 /////////////////////////////////////////////////
 void SystemPaths::ClearOgrePaths()
 {
+  this->ClearFileCache();
   this->ogrePaths.clear();
 }
 
 /////////////////////////////////////////////////
 void SystemPaths::ClearPluginPaths()
 {
+  this->ClearFileCache();
   this->pluginPaths.clear();
 }
 
 /////////////////////////////////////////////////
 void SystemPaths::ClearModelPaths()
 {
+  this->ClearFileCache();
   this->modelPaths.clear();
 }
 
@@ -464,7 +580,10 @@ void SystemPaths::InsertUnique(const std::string &_path,
                                std::list<std::string> &_list)
 {
   if (std::find(_list.begin(), _list.end(), _path) == _list.end())
+  {
     _list.push_back(_path);
+    this->ClearFileCache();
+  }
 }
 
 /////////////////////////////////////////////////
@@ -481,4 +600,5 @@ void SystemPaths::AddSearchPathSuffix(const std::string &_suffix)
     s += "/";
 
   this->suffixPaths.push_back(s);
+  this->ClearFileCache();
 }
@@ -34,6 +34,10 @@
 
 #include <string>
 #include <list>
+#include <map>
+#include <set>
+
+#include <boost/thread/mutex.hpp>
 
 #include "common/CommonTypes.hh"
 #include "common/SingletonT.hh"
@@ -54,6 +58,10 @@ namespace gazebo
     ///            Should point to Ogre RenderSystem_GL.so et. al.
     ///        \li SystemPaths#pluginPaths - plugin library paths
     ///            for common::WorldPlugin
+    ///
+    /// The results of FindFile and FindFileURI are cached, including files
+    /// that were not found. The cache is cleared when search paths are
+    /// added or cleared, and by ClearFileCache.
     class SystemPaths : public SingletonT<SystemPaths>
     {
       /// Constructor for SystemPaths
@@ -125,6 +133,20 @@ namespace gazebo
       /// \param[in] _suffix The suffix to add
       public: void AddSearchPathSuffix(const std::string &_suffix);
 
+      /// \brief Forget the results of previous file searches. Call this
+      /// after creating or removing files in the search paths.
+      public: void ClearFileCache();
+
+      /// \brief Enable or disable the snapshot mode. In snapshot mode each
+      /// searched directory is listed once, and later searches are
+      /// resolved from the listing without accessing the file system.
+      /// \param[in] _enable True to enable the snapshot mode.
+      public: void SetSnapshotMode(bool _enable);
+
+      /// \brief Get whether the snapshot mode is enabled.
+      /// \return True if the snapshot mode is enabled.
+      public: bool GetSnapshotMode();
+
       /// \brief re-read SystemPaths#gazeboPaths from environment variable
       private: void UpdateModelPaths();
       /// \brief re-read SystemPaths#gazeboPaths from environment variable
@@ -134,6 +156,25 @@ namespace gazebo
       /// \brief re-read SystemPaths#ogrePaths from environment variable
       private: void UpdateOgrePaths();
 
+      /// \brief Check whether a file or directory exists, using the
+      /// directory listings in snapshot mode.
+      /// \param[in] _path Path to check.
+      /// \return True if the path exists.
+      private: bool Exists(const std::string &_path);
+
+      /// \brief Get the result of a previous file search.
+      /// \param[in] _key Key of the search.
+      /// \param[out] _result Path found, empty if it was not found.
+      /// \return True if the search is in the cache.
+      private: bool GetCachedFile(const std::string &_key,
+                                  std::string &_result);
+
+      /// \brief Store the result of a file search.
+      /// \param[in] _key Key of the search.
+      /// \param[in] _result Path found, empty if it was not found.
+      private: void SetCachedFile(const std::string &_key,
+                                  const std::string &_result);
+
       /// \brief adds a path to the list if not already present
       /// \param[in]_path the path
       /// \param[in]_list the list
@@ -155,6 +196,20 @@ namespace gazebo
 
       private: std::string logPath;
 
+      /// \brief Results of file searches, empty when the file was not
+      /// found.
+      private: std::map<std::string, std::string> fileCache;
+
+      /// \brief Names of the entries of each directory listed in snapshot
+      /// mode.
+      private: std::map<std::string, std::set<std::string> > dirListings;
+
+      /// \brief True when the snapshot mode is enabled.
+      private: bool snapshotMode;
+
+      /// \brief Protects the file cache and the directory listings.
+      private: boost::mutex cacheMutex;
+
       /// \brief if true, call UpdateGazeboPaths() within GetGazeboPaths()
       public: bool modelPathsFromEnv;
 
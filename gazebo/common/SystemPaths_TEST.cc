@@ -16,6 +16,9 @@
 */
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <boost/filesystem.hpp>
+
 #include "gazebo/common/SystemPaths.hh"
 
 using namespace gazebo;
@@ -103,6 +106,49 @@ TEST(SystemPathsTest, SystemPaths)
   putenv(const_cast<char*>(pluginPathBackup.c_str()));
 }
 
+/////////////////////////////////////////////////
+TEST(SystemPathsTest, FileCache)
+{
+  boost::filesystem::path dir = boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("gz_paths-%%%%-%%%%");
+  boost::filesystem::create_directories(dir / "a");
+  boost::filesystem::create_directories(dir / "b");
+  std::ofstream((dir / "a" / "first.txt").string().c_str()) << "first";
+
+  common::SystemPaths *paths = common::SystemPaths::Instance();
+  paths->AddGazeboPaths((dir / "a").string());
+
+  std::string first = (dir / "a" / "first.txt").string();
+  EXPECT_EQ(first, paths->FindFile("first.txt", false));
+  EXPECT_EQ("", paths->FindFile("second.txt", false));
+
+  // Results are remembered until the cache is cleared
+  std::ofstream((dir / "a" / "second.txt").string().c_str()) << "second";
+  EXPECT_EQ("", paths->FindFile("second.txt", false));
+  paths->ClearFileCache();
+  std::string second = (dir / "a" / "second.txt").string();
+  EXPECT_EQ(second, paths->FindFile("second.txt", false));
+
+  // Adding a path clears the cache
+  std::ofstream((dir / "b" / "third.txt").string().c_str()) << "third";
+  EXPECT_EQ("", paths->FindFile("third.txt", false));
+  paths->AddGazeboPaths((dir / "b").string());
+  EXPECT_EQ((dir / "b" / "third.txt").string(),
+            paths->FindFile("third.txt", false));
+
+  // Snapshot mode resolves files from the directory listings
+  paths->SetSnapshotMode(true);
+  EXPECT_TRUE(paths->GetSnapshotMode());
+  paths->ClearFileCache();
+  EXPECT_EQ(first, paths->FindFile("first.txt", false));
+  EXPECT_EQ(first, paths->FindFile(first));
+  EXPECT_EQ("", paths->FindFile("fourth.txt", false));
+  paths->SetSnapshotMode(false);
+
+  paths->ClearGazeboPaths();
+  boost::filesystem::remove_all(dir);
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
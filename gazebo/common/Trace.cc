@@ -0,0 +1,393 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Trace.hh"
+
+using namespace gazebo;
+using namespace common;
+
+const unsigned int Trace::BufferSize;
+
+/// \brief Event types
+enum TraceEventType
+{
+  TRACE_BEGIN = 0,
+  TRACE_END = 1
+};
+
+/// \brief A recorded event
+struct TraceEvent
+{
+  /// \brief Monotonic time in nanoseconds
+  uint64_t time;
+
+  /// \brief Section id
+  uint32_t id;
+
+  /// \brief One of TraceEventType
+  uint32_t type;
+};
+
+/// \brief Ring buffer of the events of one thread. Only the owning thread
+/// writes to the buffer.
+class TraceBuffer
+{
+  /// \brief Constructor
+  /// \param[in] _index Index of the thread, used as the trace thread id.
+  public: explicit TraceBuffer(unsigned int _index)
+          : head(0), start(0), index(_index)
+          {
+          }
+
+  /// \brief Events, indexed by count modulo the buffer size. Allocated
+  /// when the first event is recorded.
+  public: std::vector<TraceEvent> events;
+
+  /// \brief Number of events ever written. Only the owning thread
+  /// modifies it.
+  public: volatile uint32_t head;
+
+  /// \brief Value of head when the buffer was last cleared.
+  public: volatile uint32_t start;
+
+  /// \brief Index of the thread.
+  public: unsigned int index;
+
+  /// \brief Name of the thread.
+  public: std::string name;
+};
+
+/// \brief Section names and thread buffers. Buffers are never freed, so
+/// threads that are still running during static destruction can keep
+/// recording. The buffer of a finished thread is kept, so its history can
+/// still be exported, until a new thread reuses it. There are thus never
+/// more buffers than threads that ever ran at the same time.
+struct TraceRegistry
+{
+  /// \brief Constructor
+  TraceRegistry();
+
+  /// \brief Protects everything but the contents of the buffers.
+  boost::mutex mutex;
+
+  /// \brief Key whose destructor releases the buffer of a finished
+  /// thread.
+  pthread_key_t threadKey;
+
+  /// \brief Buffers of finished threads, which new threads reuse.
+  std::vector<TraceBuffer*> freeBuffers;
+
+  /// \brief Index of the next thread.
+  unsigned int nextIndex;
+
+  /// \brief Section names, indexed by id.
+  std::vector<std::string> names;
+
+  /// \brief Section ids, indexed by name.
+  std::map<std::string, uint32_t> ids;
+
+  /// \brief All thread buffers.
+  std::vector<TraceBuffer*> buffers;
+};
+
+/// \brief True when events are recorded.
+static volatile bool traceEnabled = true;
+
+/// \brief Buffer of the current thread, owned by the registry.
+static __thread TraceBuffer *currentBuffer = NULL;
+
+//////////////////////////////////////////////////
+/// \brief Get the registry. It is created on first use, so sections can be
+/// traced during static initialization.
+static TraceRegistry &getRegistry()
+{
+  static TraceRegistry *registry = new TraceRegistry;
+  return *registry;
+}
+
+//////////////////////////////////////////////////
+/// \brief Release the buffer of a finished thread, so that a new thread
+/// can reuse it.
+/// \param[in] _buffer The buffer.
+static void releaseThreadBuffer(void *_buffer)
+{
+  TraceRegistry &registry = getRegistry();
+  boost::mutex::scoped_lock lock(registry.mutex);
+  registry.freeBuffers.push_back(static_cast<TraceBuffer*>(_buffer));
+  currentBuffer = NULL;
+}
+
+//////////////////////////////////////////////////
+TraceRegistry::TraceRegistry()
+  : nextIndex(0)
+{
+  pthread_key_create(&this->threadKey, releaseThreadBuffer);
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the buffer of the current thread, creating it if needed.
+static TraceBuffer *getThreadBuffer()
+{
+  if (currentBuffer)
+    return currentBuffer;
+
+  TraceRegistry &registry = getRegistry();
+  boost::mutex::scoped_lock lock(registry.mutex);
+  if (registry.freeBuffers.empty())
+  {
+    currentBuffer = new TraceBuffer(registry.nextIndex++);
+    registry.buffers.push_back(currentBuffer);
+  }
+  else
+  {
+    // The history of the finished thread is dropped
+    currentBuffer = registry.freeBuffers.back();
+    registry.freeBuffers.pop_back();
+    currentBuffer->start = currentBuffer->head;
+    currentBuffer->index = registry.nextIndex++;
+    currentBuffer->name.clear();
+  }
+
+  pthread_setspecific(registry.threadKey, currentBuffer);
+  return currentBuffer;
+}
+
+//////////////////////////////////////////////////
+/// \brief Add an event to the buffer of the current thread.
+static void record(uint32_t _id, uint32_t _type)
+{
+  if (!traceEnabled)
+    return;
+
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  TraceBuffer *buffer = getThreadBuffer();
+  if (buffer->events.empty())
+    buffer->events.resize(Trace::BufferSize);
+
+  uint32_t head = buffer->head;
+  TraceEvent &event = buffer->events[head % Trace::BufferSize];
+  event.time = static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+  event.id = _id;
+  event.type = _type;
+
+  // Make the event visible before it is counted.
+  __sync_synchronize();
+  buffer->head = head + 1;
+}
+
+//////////////////////////////////////////////////
+/// \brief Write a string as a JSON string literal.
+static void writeJSONString(std::ostream &_out, const std::string &_str)
+{
+  _out << '"';
+  for (std::string::const_iterator iter = _str.begin(); iter != _str.end();
+       ++iter)
+  {
+    if (*iter == '"' || *iter == '\\')
+      _out << '\\' << *iter;
+    else if (static_cast<unsigned char>(*iter) < 0x20)
+    {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", *iter);
+      _out << escaped;
+    }
+    else
+      _out << *iter;
+  }
+  _out << '"';
+}
+
+//////////////////////////////////////////////////
+uint32_t Trace::GetId(const std::string &_name)
+{
+  TraceRegistry &registry = getRegistry();
+  boost::mutex::scoped_lock lock(registry.mutex);
+
+  std::map<std::string, uint32_t>::iterator iter = registry.ids.find(_name);
+  if (iter != registry.ids.end())
+    return iter->second;
+
+  uint32_t id = registry.names.size();
+  registry.names.push_back(_name);
+  registry.ids[_name] = id;
+  return id;
+}
+
+//////////////////////////////////////////////////
+std::string Trace::GetName(uint32_t _id)
+{
+  TraceRegistry &registry = getRegistry();
+  boost::mutex::scoped_lock lock(registry.mutex);
+
+  if (_id >= registry.names.size())
+    return std::string();
+  return registry.names[_id];
+}
+
+//////////////////////////////////////////////////
+void Trace::Begin(uint32_t _id)
+{
+  record(_id, TRACE_BEGIN);
+}
+
+//////////////////////////////////////////////////
+void Trace::End(uint32_t _id)
+{
+  record(_id, TRACE_END);
+}
+
+//////////////////////////////////////////////////
+void Trace::SetThreadName(const std::string &_name)
+{
+  TraceBuffer *buffer = getThreadBuffer();
+  boost::mutex::scoped_lock lock(getRegistry().mutex);
+  buffer->name = _name;
+}
+
+//////////////////////////////////////////////////
+void Trace::SetEnabled(bool _enable)
+{
+  traceEnabled = _enable;
+}
+
+//////////////////////////////////////////////////
+bool Trace::GetEnabled()
+{
+  return traceEnabled;
+}
+
+//////////////////////////////////////////////////
+void Trace::Clear()
+{
+  TraceRegistry &registry = getRegistry();
+  boost::mutex::scoped_lock lock(registry.mutex);
+
+  for (std::vector<TraceBuffer*>::iterator iter = registry.buffers.begin();
+       iter != registry.buffers.end(); ++iter)
+  {
+    (*iter)->start = (*iter)->head;
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int Trace::GetEventCount()
+{
+  TraceRegistry &registry = getRegistry();
+  boost::mutex::scoped_lock lock(registry.mutex);
+
+  unsigned int count = 0;
+  for (std::vector<TraceBuffer*>::iterator iter = registry.buffers.begin();
+       iter != registry.buffers.end(); ++iter)
+  {
+    uint32_t used = (*iter)->head - (*iter)->start;
+    count += std::min(used, static_cast<uint32_t>(BufferSize));
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+bool Trace::Export(const std::string &_filename)
+{
+  std::ofstream out(_filename.c_str(), std::ios::out);
+  if (!out.is_open())
+  {
+    gzerr << "Unable to open trace file[" << _filename << "]\n";
+    return false;
+  }
+
+  Export(out);
+  return out.good();
+}
+
+//////////////////////////////////////////////////
+void Trace::Export(std::ostream &_out)
+{
+  TraceRegistry &registry = getRegistry();
+  boost::mutex::scoped_lock lock(registry.mutex);
+
+  int pid = getpid();
+  bool first = true;
+
+  _out << "{\"traceEvents\":[\n";
+
+  std::vector<TraceEvent> events;
+  for (std::vector<TraceBuffer*>::iterator iter = registry.buffers.begin();
+       iter != registry.buffers.end(); ++iter)
+  {
+    TraceBuffer *buffer = *iter;
+
+    if (!buffer->name.empty())
+    {
+      _out << (first ? "" : ",\n")
+           << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+           << ",\"tid\":" << buffer->index << ",\"args\":{\"name\":";
+      writeJSONString(_out, buffer->name);
+      _out << "}}";
+      first = false;
+    }
+
+    // Copy the events without stopping the writer. Events that the
+    // writer may have overwritten during the copy are dropped afterwards.
+    uint32_t head = buffer->head;
+    __sync_synchronize();
+    uint32_t count = std::min(head - buffer->start,
+                              static_cast<uint32_t>(BufferSize));
+    uint32_t begin = head - count;
+
+    events.resize(count);
+    for (uint32_t i = 0; i < count; ++i)
+      events[i] = buffer->events[(begin + i) % BufferSize];
+
+    __sync_synchronize();
+    uint32_t newHead = buffer->head;
+    uint32_t overwritten = newHead - head > BufferSize - count ?
+      std::min(count, newHead - head - (BufferSize - count)) : 0;
+
+    for (uint32_t i = overwritten; i < count; ++i)
+    {
+      const TraceEvent &event = events[i];
+      if (event.id >= registry.names.size())
+        continue;
+
+      _out << (first ? "" : ",\n") << "{\"name\":";
+      writeJSONString(_out, registry.names[event.id]);
+
+      char ts[32];
+      snprintf(ts, sizeof(ts), "%.3f", event.time / 1000.0);
+      _out << ",\"ph\":\"" << (event.type == TRACE_BEGIN ? 'B' : 'E')
+           << "\",\"ts\":" << ts << ",\"pid\":" << pid
+           << ",\"tid\":" << buffer->index << "}";
+      first = false;
+    }
+  }
+
+  _out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
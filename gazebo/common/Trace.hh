@@ -0,0 +1,159 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _TRACE_HH_
+#define _TRACE_HH_
+
+#include <stdint.h>
+#include <iostream>
+#include <string>
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \brief Concatenate two tokens, after expanding them.
+    #define GZ_TRACE_CONCAT_IMPL(_a, _b) _a##_b
+    #define GZ_TRACE_CONCAT(_a, _b) GZ_TRACE_CONCAT_IMPL(_a, _b)
+
+    /// \brief Trace the rest of the enclosing scope. The name is interned
+    /// once, the first time the line is reached.
+    /// \param[in] _name Name of the traced section, a string literal.
+    #define GZ_TRACE_SCOPE(_name) \
+      static const uint32_t GZ_TRACE_CONCAT(gzTraceId, __LINE__) = \
+        gazebo::common::Trace::GetId(_name); \
+      gazebo::common::TraceScope GZ_TRACE_CONCAT(gzTraceScope, __LINE__)( \
+        GZ_TRACE_CONCAT(gzTraceId, __LINE__))
+
+    /// \brief Start a traced section. Must be matched by a GZ_TRACE_END
+    /// with the same name on the same thread.
+    /// \param[in] _name Name of the traced section.
+    #define GZ_TRACE_BEGIN(_name) \
+      do { \
+        static const uint32_t gzTraceId = \
+          gazebo::common::Trace::GetId(_name); \
+        gazebo::common::Trace::Begin(gzTraceId); \
+      } while (0)
+
+    /// \brief End a section started with GZ_TRACE_BEGIN.
+    /// \param[in] _name Name of the traced section.
+    #define GZ_TRACE_END(_name) \
+      do { \
+        static const uint32_t gzTraceId = \
+          gazebo::common::Trace::GetId(_name); \
+        gazebo::common::Trace::End(gzTraceId); \
+      } while (0)
+
+    /// \class Trace Trace.hh common/common.hh
+    /// \brief Low overhead tracing of timed sections.
+    ///
+    /// Each thread records begin and end events in its own fixed size ring
+    /// buffer, so recording takes no lock and, after the first event,
+    /// allocates no memory. When a buffer is full the oldest events are
+    /// overwritten, so the buffers always hold the most recent history of
+    /// every thread. The buffer of a finished thread is reused by the next
+    /// new thread. Use Export to write the buffers in the Chrome trace
+    /// format, which can be viewed in chrome://tracing or Perfetto.
+    ///
+    /// Recording is enabled by default and is cheap enough to leave on in
+    /// production. Only exporting costs anything, which gzserver does on
+    /// exit when given --trace.
+    ///
+    /// Section names are interned to ids. The GZ_TRACE_SCOPE macro does
+    /// this once per call site.
+    class Trace
+    {
+      /// \brief Get the id of a section name, creating it if needed.
+      /// \param[in] _name Name of the section.
+      /// \return Id of the section.
+      public: static uint32_t GetId(const std::string &_name);
+
+      /// \brief Get the name of a section.
+      /// \param[in] _id Id of the section.
+      /// \return Name of the section, empty for an invalid id.
+      public: static std::string GetName(uint32_t _id);
+
+      /// \brief Record the start of a section in the current thread.
+      /// \param[in] _id Id of the section.
+      public: static void Begin(uint32_t _id);
+
+      /// \brief Record the end of a section in the current thread.
+      /// \param[in] _id Id of the section.
+      public: static void End(uint32_t _id);
+
+      /// \brief Name the current thread in exported traces.
+      /// \param[in] _name Name of the thread.
+      public: static void SetThreadName(const std::string &_name);
+
+      /// \brief Enable or disable recording. Recording is enabled by
+      /// default.
+      /// \param[in] _enable True to record events.
+      public: static void SetEnabled(bool _enable);
+
+      /// \brief Return true if events are recorded.
+      /// \return True if recording is enabled.
+      public: static bool GetEnabled();
+
+      /// \brief Discard all recorded events.
+      public: static void Clear();
+
+      /// \brief Get the number of events currently held in all the thread
+      /// buffers.
+      /// \return Number of events.
+      public: static unsigned int GetEventCount();
+
+      /// \brief Write all recorded events as Chrome trace JSON.
+      /// \param[in] _filename File to write.
+      /// \return True on success.
+      public: static bool Export(const std::string &_filename);
+
+      /// \brief Write all recorded events as Chrome trace JSON.
+      /// \param[out] _out Stream to write to.
+      public: static void Export(std::ostream &_out);
+
+      /// \brief Number of events held by each thread buffer.
+      public: static const unsigned int BufferSize = 32768;
+    };
+
+    /// \class TraceScope Trace.hh common/common.hh
+    /// \brief Records a section from construction to destruction. Use
+    /// the GZ_TRACE_SCOPE macro rather than this class directly.
+    class TraceScope
+    {
+      /// \brief Constructor, records the start of the section.
+      /// \param[in] _id Id of the section.
+      public: explicit TraceScope(uint32_t _id)
+              : id(_id)
+              {
+                Trace::Begin(this->id);
+              }
+
+      /// \brief Destructor, records the end of the section.
+      public: ~TraceScope()
+              {
+                Trace::End(this->id);
+              }
+
+      /// \brief Id of the section.
+      private: uint32_t id;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <boost/thread.hpp>
+
+#include "gazebo/common/Trace.hh"
+
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+void tracedThread()
+{
+  common::Trace::SetThreadName("worker");
+  for (int i = 0; i < 10; ++i)
+  {
+    GZ_TRACE_SCOPE("TraceTest::worker");
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(TraceTest, Ids)
+{
+  uint32_t id = common::Trace::GetId("TraceTest::a");
+  EXPECT_EQ(id, common::Trace::GetId("TraceTest::a"));
+  EXPECT_NE(id, common::Trace::GetId("TraceTest::b"));
+  EXPECT_EQ("TraceTest::a", common::Trace::GetName(id));
+  EXPECT_EQ("", common::Trace::GetName(1000000));
+}
+
+/////////////////////////////////////////////////
+TEST(TraceTest, Record)
+{
+  EXPECT_TRUE(common::Trace::GetEnabled());
+  common::Trace::Clear();
+  EXPECT_EQ(0u, common::Trace::GetEventCount());
+
+  common::Trace::SetThreadName("main \"test\"");
+  {
+    GZ_TRACE_SCOPE("TraceTest::outer");
+    GZ_TRACE_BEGIN("TraceTest::inner");
+    GZ_TRACE_END("TraceTest::inner");
+  }
+  EXPECT_EQ(4u, common::Trace::GetEventCount());
+
+  boost::thread thread(&tracedThread);
+  thread.join();
+  EXPECT_EQ(24u, common::Trace::GetEventCount());
+
+  std::ostringstream out;
+  common::Trace::Export(out);
+  std::string json = out.str();
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"TraceTest::outer\","
+        "\"ph\":\"B\""));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"TraceTest::inner\","
+        "\"ph\":\"E\""));
+  EXPECT_NE(std::string::npos, json.find("\"args\":{\"name\":\"worker\"}"));
+  EXPECT_NE(std::string::npos, json.find("main \\\"test\\\""));
+
+  // Nothing is recorded while tracing is disabled
+  common::Trace::SetEnabled(false);
+  {
+    GZ_TRACE_SCOPE("TraceTest::disabled");
+  }
+  common::Trace::SetEnabled(true);
+  EXPECT_EQ(24u, common::Trace::GetEventCount());
+
+  // A new thread reuses the buffer of the finished one
+  boost::thread other(&tracedThread);
+  other.join();
+  EXPECT_EQ(24u, common::Trace::GetEventCount());
+
+  common::Trace::Clear();
+  EXPECT_EQ(0u, common::Trace::GetEventCount());
+}
+
+/////////////////////////////////////////////////
+TEST(TraceTest, Wrap)
+{
+  common::Trace::Clear();
+  for (unsigned int i = 0; i < common::Trace::BufferSize; ++i)
+  {
+    GZ_TRACE_SCOPE("TraceTest::wrap");
+  }
+
+  // Only the most recent events are kept
+  EXPECT_EQ(common::Trace::BufferSize, common::Trace::GetEventCount());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
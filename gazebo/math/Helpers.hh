@@ -247,6 +247,132 @@ namespace gazebo
       }
       return s * acc;
     }
+
+    /// \brief Is the character a whitespace separator in a list of numbers
+    /// \param[in] _c the character
+    /// \return true if _c is a space, tab, newline or carriage return
+    inline bool isNumberSeparator(char _c)
+    {
+      return _c == ' ' || _c == '\t' || _c == '\n' || _c == '\r';
+    }
+
+    /// \brief Parse the next number of a whitespace separated list of
+    /// floating point numbers. No memory is allocated, which makes this
+    /// suitable for very large lists such as mesh vertex arrays.
+    /// \param[in,out] _p Pointer into a null terminated buffer. On success
+    /// it is moved past the number that was read.
+    /// \param[out] _value The number that was read.
+    /// \return true if a number was read, false at the end of the buffer or
+    /// if the next token is not a valid number.
+    inline bool parseNextFloat(const char *&_p, double &_value)
+    {
+      const char *p = _p;
+      while (isNumberSeparator(*p))
+        p++;
+
+      double s = 1.0;
+      if (*p == '-')
+      {
+        s = -1.0;
+        p++;
+      }
+      else if (*p == '+')
+        p++;
+
+      // Accumulate all the digits as an integer, and keep track of the
+      // decimal exponent separately. This is more accurate than scaling
+      // each fractional digit.
+      bool hasDigits = false;
+      int exp10 = 0;
+      double acc = 0;
+      while (*p >= '0' && *p <= '9')
+      {
+        acc = acc * 10 + (*p++ - '0');
+        hasDigits = true;
+      }
+
+      if (*p == '.')
+      {
+        p++;
+        while (*p >= '0' && *p <= '9')
+        {
+          acc = acc * 10 + (*p++ - '0');
+          exp10--;
+          hasDigits = true;
+        }
+      }
+
+      if (!hasDigits)
+        return false;
+
+      if (*p == 'e' || *p == 'E')
+      {
+        int es = 1;
+        int f = 0;
+        p++;
+        if (*p == '-')
+        {
+          es = -1;
+          p++;
+        }
+        else if (*p == '+')
+          p++;
+
+        while (*p >= '0' && *p <= '9')
+          f = f * 10 + *p++ - '0';
+
+        exp10 += es * f;
+      }
+
+      if (*p && !isNumberSeparator(*p))
+        return false;
+
+      if (exp10 < 0)
+        acc /= pow(10.0, -exp10);
+      else if (exp10 > 0)
+        acc *= pow(10.0, exp10);
+
+      _value = s * acc;
+      _p = p;
+      return true;
+    }
+
+    /// \brief Parse the next number of a whitespace separated list of
+    /// integers. No memory is allocated.
+    /// \param[in,out] _p Pointer into a null terminated buffer. On success
+    /// it is moved past the number that was read.
+    /// \param[out] _value The number that was read.
+    /// \return true if a number was read, false at the end of the buffer or
+    /// if the next token is not a valid integer.
+    inline bool parseNextInt(const char *&_p, int &_value)
+    {
+      const char *p = _p;
+      while (isNumberSeparator(*p))
+        p++;
+
+      int s = 1;
+      if (*p == '-')
+      {
+        s = -1;
+        p++;
+      }
+      else if (*p == '+')
+        p++;
+
+      if (*p < '0' || *p > '9')
+        return false;
+
+      int acc = 0;
+      while (*p >= '0' && *p <= '9')
+        acc = acc * 10 + *p++ - '0';
+
+      if (*p && !isNumberSeparator(*p))
+        return false;
+
+      _value = s * acc;
+      _p = p;
+      return true;
+    }
     /// \}
   }
 }
@@ -30,3 +30,42 @@ TEST(HelpersTest, Helpers)
   EXPECT_FLOAT_EQ(-12.345, math::parseFloat("-12.345"));
   EXPECT_TRUE(math::equal(123.45, math::parseFloat("1.2345e2"), 1e-2));
 }
+
+/////////////////////////////////////////////////
+TEST(HelpersTest, ParseNext)
+{
+  const char *str = "  1.5 -2\n3e2\t-4.25E-1 +0.125 ";
+  const char *p = str;
+  double d = 0;
+
+  EXPECT_TRUE(math::parseNextFloat(p, d));
+  EXPECT_DOUBLE_EQ(1.5, d);
+  EXPECT_TRUE(math::parseNextFloat(p, d));
+  EXPECT_DOUBLE_EQ(-2.0, d);
+  EXPECT_TRUE(math::parseNextFloat(p, d));
+  EXPECT_DOUBLE_EQ(300.0, d);
+  EXPECT_TRUE(math::parseNextFloat(p, d));
+  EXPECT_DOUBLE_EQ(-0.425, d);
+  EXPECT_TRUE(math::parseNextFloat(p, d));
+  EXPECT_DOUBLE_EQ(0.125, d);
+  EXPECT_FALSE(math::parseNextFloat(p, d));
+
+  // A bad token stops parsing and leaves the pointer at the bad token
+  p = "1.0 abc";
+  EXPECT_TRUE(math::parseNextFloat(p, d));
+  EXPECT_FALSE(math::parseNextFloat(p, d));
+  EXPECT_STREQ(" abc", p);
+
+  int i = 0;
+  p = "12 -3  45\n";
+  EXPECT_TRUE(math::parseNextInt(p, i));
+  EXPECT_EQ(12, i);
+  EXPECT_TRUE(math::parseNextInt(p, i));
+  EXPECT_EQ(-3, i);
+  EXPECT_TRUE(math::parseNextInt(p, i));
+  EXPECT_EQ(45, i);
+  EXPECT_FALSE(math::parseNextInt(p, i));
+
+  p = "1.5";
+  EXPECT_FALSE(math::parseNextInt(p, i));
+}
@@ -0,0 +1,313 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+/* Desc: Microbenchmarks for the math kernels that are used in the
+ * physics and sensor update loops.
+ *
+ * Usage: Math_BENCHMARK [filter]
+ * Only benchmarks whose name contains the filter string are run.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+#include "gazebo/math/Matrix4.hh"
+#include "gazebo/math/Pose.hh"
+#include "gazebo/math/Quaternion.hh"
+#include "gazebo/math/Rand.hh"
+#include "gazebo/math/RandStream.hh"
+#include "gazebo/math/Vector3.hh"
+
+using namespace gazebo;
+
+/// \brief Number of points used by the array benchmarks
+static const unsigned int pointCount = 1024;
+
+/// \brief Written by each benchmark so the compiler can't discard the work
+static volatile double sink;
+
+/// \brief A benchmark runs its kernel _iterations times
+typedef void (*BenchmarkFunc)(unsigned int _iterations);
+
+/// \brief A named benchmark
+struct Benchmark
+{
+  const char *name;
+  BenchmarkFunc func;
+
+  /// \brief Number of items processed per iteration
+  unsigned int items;
+};
+
+//////////////////////////////////////////////////
+/// \brief Get a monotonic time in seconds
+static double getTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get an array of points that are spread around the origin
+static const std::vector<math::Vector3> &getPoints()
+{
+  static std::vector<math::Vector3> points;
+  if (points.empty())
+  {
+    for (unsigned int i = 0; i < pointCount; ++i)
+      points.push_back(math::Vector3(i * 0.01, 1.0 - i * 0.02, i % 7));
+  }
+  return points;
+}
+
+//////////////////////////////////////////////////
+static void vector3Dot(unsigned int _iterations)
+{
+  math::Vector3 a(0.1, 0.2, 0.3), b(1.1, -0.7, 0.4);
+  double sum = 0;
+  for (unsigned int i = 0; i < _iterations; ++i)
+  {
+    sum += a.Dot(b);
+    a.x += 1e-9;
+  }
+  sink = sum;
+}
+
+//////////////////////////////////////////////////
+static void vector3Distance(unsigned int _iterations)
+{
+  math::Vector3 a(0.1, 0.2, 0.3), b(1.1, -0.7, 0.4);
+  double sum = 0;
+  for (unsigned int i = 0; i < _iterations; ++i)
+  {
+    sum += a.Distance(b);
+    a.x += 1e-9;
+  }
+  sink = sum;
+}
+
+//////////////////////////////////////////////////
+static void quaternionRotateVector(unsigned int _iterations)
+{
+  math::Quaternion q(0.1, 0.2, 0.3);
+  math::Vector3 v(1, 2, 3);
+  for (unsigned int i = 0; i < _iterations; ++i)
+    v = q.RotateVector(v);
+  sink = v.x;
+}
+
+//////////////////////////////////////////////////
+static void quaternionRotateVectorReverse(unsigned int _iterations)
+{
+  math::Quaternion q(0.1, 0.2, 0.3);
+  math::Vector3 v(1, 2, 3);
+  for (unsigned int i = 0; i < _iterations; ++i)
+    v = q.RotateVectorReverse(v);
+  sink = v.x;
+}
+
+//////////////////////////////////////////////////
+static void quaternionMultiply(unsigned int _iterations)
+{
+  math::Quaternion q(0.1, 0.2, 0.3), r(1, 0, 0, 0);
+  for (unsigned int i = 0; i < _iterations; ++i)
+    r = r * q;
+  sink = r.w;
+}
+
+//////////////////////////////////////////////////
+static void poseAdd(unsigned int _iterations)
+{
+  math::Pose a(1, 2, 3, 0.1, 0.2, 0.3), b(0.1, 0, 0, 0, 0, 0.01);
+  for (unsigned int i = 0; i < _iterations; ++i)
+    b = b + a;
+  sink = b.pos.x;
+}
+
+//////////////////////////////////////////////////
+static void matrix4Multiply(unsigned int _iterations)
+{
+  math::Matrix4 a = math::Pose(1, 2, 3, 0.1, 0.2, 0.3).rot.GetAsMatrix4();
+  math::Matrix4 b(math::Matrix4::IDENTITY);
+  for (unsigned int i = 0; i < _iterations; ++i)
+    b = b * a;
+  sink = b[0][0];
+}
+
+//////////////////////////////////////////////////
+static void matrix4TransformPoint(unsigned int _iterations)
+{
+  math::Matrix4 a = math::Pose(1, 2, 3, 0.1, 0.2, 0.3).rot.GetAsMatrix4();
+  math::Vector3 v(1, 2, 3);
+  for (unsigned int i = 0; i < _iterations; ++i)
+    v = a * v;
+  sink = v.x;
+}
+
+//////////////////////////////////////////////////
+static void posePointsLoop(unsigned int _iterations)
+{
+  const std::vector<math::Vector3> &points = getPoints();
+  std::vector<math::Vector3> result(points.size());
+  math::Pose pose(1, 2, 3, 0.1, 0.2, 0.3);
+
+  for (unsigned int i = 0; i < _iterations; ++i)
+  {
+    for (unsigned int j = 0; j < points.size(); ++j)
+      result[j] = pose.CoordPositionAdd(points[j]);
+    pose.pos.x += 1e-9;
+  }
+  sink = result[0].x;
+}
+
+//////////////////////////////////////////////////
+static void posePointsArray(unsigned int _iterations)
+{
+  const std::vector<math::Vector3> &points = getPoints();
+  std::vector<math::Vector3> result(points.size());
+  math::Pose pose(1, 2, 3, 0.1, 0.2, 0.3);
+
+  for (unsigned int i = 0; i < _iterations; ++i)
+  {
+    pose.CoordPositionAdd(&points[0], &result[0], points.size());
+    pose.pos.x += 1e-9;
+  }
+  sink = result[0].x;
+}
+
+//////////////////////////////////////////////////
+static void rotateVectorsLoop(unsigned int _iterations)
+{
+  const std::vector<math::Vector3> &points = getPoints();
+  std::vector<math::Vector3> result(points.size());
+  math::Quaternion q(0.1, 0.2, 0.3);
+
+  for (unsigned int i = 0; i < _iterations; ++i)
+  {
+    for (unsigned int j = 0; j < points.size(); ++j)
+      result[j] = q.RotateVectorReverse(points[j]);
+  }
+  sink = result[0].x;
+}
+
+//////////////////////////////////////////////////
+static void rotateVectorsArray(unsigned int _iterations)
+{
+  const std::vector<math::Vector3> &points = getPoints();
+  std::vector<math::Vector3> result(points.size());
+  math::Quaternion q(0.1, 0.2, 0.3);
+
+  for (unsigned int i = 0; i < _iterations; ++i)
+    q.RotateVectorsReverse(&points[0], &result[0], points.size());
+  sink = result[0].x;
+}
+
+//////////////////////////////////////////////////
+static void randNormalLoop(unsigned int _iterations)
+{
+  std::vector<double> result(pointCount);
+
+  for (unsigned int i = 0; i < _iterations; ++i)
+  {
+    for (unsigned int j = 0; j < pointCount; ++j)
+      result[j] = math::Rand::GetDblNormal(0, 1);
+  }
+  sink = result[0];
+}
+
+//////////////////////////////////////////////////
+static void randStreamNormalArray(unsigned int _iterations)
+{
+  std::vector<double> result(pointCount);
+  math::RandStream stream(1, "benchmark");
+
+  for (unsigned int i = 0; i < _iterations; ++i)
+    stream.GetNormal(i, &result[0], pointCount);
+  sink = result[0];
+}
+
+//////////////////////////////////////////////////
+static void randStreamUniformArray(unsigned int _iterations)
+{
+  std::vector<double> result(pointCount);
+  math::RandStream stream(1, "benchmark");
+
+  for (unsigned int i = 0; i < _iterations; ++i)
+    stream.GetUniform(i, &result[0], pointCount);
+  sink = result[0];
+}
+
+//////////////////////////////////////////////////
+static const Benchmark benchmarks[] =
+{
+  {"Vector3::Dot", vector3Dot, 1},
+  {"Vector3::Distance", vector3Distance, 1},
+  {"Quaternion::RotateVector", quaternionRotateVector, 1},
+  {"Quaternion::RotateVectorReverse", quaternionRotateVectorReverse, 1},
+  {"Quaternion::operator*", quaternionMultiply, 1},
+  {"Pose::operator+", poseAdd, 1},
+  {"Matrix4::operator*(Matrix4)", matrix4Multiply, 1},
+  {"Matrix4::operator*(Vector3)", matrix4TransformPoint, 1},
+  {"Pose::CoordPositionAdd/loop", posePointsLoop, pointCount},
+  {"Pose::CoordPositionAdd/array", posePointsArray, pointCount},
+  {"Quaternion::RotateVectorReverse/loop", rotateVectorsLoop, pointCount},
+  {"Quaternion::RotateVectorsReverse/array", rotateVectorsArray, pointCount},
+  {"Rand::GetDblNormal/loop", randNormalLoop, pointCount},
+  {"RandStream::GetNormal/array", randStreamNormalArray, pointCount},
+  {"RandStream::GetUniform/array", randStreamUniformArray, pointCount}
+};
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  const char *filter = argc > 1 ? argv[1] : "";
+
+  printf("%-42s %12s %14s\n", "Benchmark", "Iterations", "ns/item");
+
+  for (unsigned int b = 0; b < sizeof(benchmarks) / sizeof(benchmarks[0]);
+       ++b)
+  {
+    const Benchmark &bench = benchmarks[b];
+    if (strstr(bench.name, filter) == NULL)
+      continue;
+
+    // Grow the iteration count until the run takes long enough to give a
+    // stable time.
+    unsigned int iterations = 1;
+    double elapsed = 0;
+    while (true)
+    {
+      double start = getTime();
+      bench.func(iterations);
+      elapsed = getTime() - start;
+
+      if (elapsed > 0.2 || iterations >= (1u << 30))
+        break;
+      iterations *= elapsed < 0.02 ? 10 : 2;
+    }
+
+    printf("%-42s %12u %14.3f\n", bench.name, iterations,
+           elapsed * 1e9 / (static_cast<double>(iterations) * bench.items));
+  }
+
+  return 0;
+}
@@ -17,6 +17,10 @@
 #include <string.h>
 #include <math.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "math/Helpers.hh"
 #include "math/Matrix3.hh"
 
@@ -112,3 +116,47 @@ bool Matrix3::operator==(const Matrix3 &_m) const
          math::equal(this->m[2][1], _m[2][1]) &&
          math::equal(this->m[2][2], _m[2][2]);
 }
+
+//////////////////////////////////////////////////
+void Matrix3::Transform(const Vector3 *_in, Vector3 *_out,
+                        unsigned int _count, const Vector3 &_offset) const
+{
+#ifdef __SSE2__
+  // The x and y results are computed together, one per lane. This relies
+  // on x and y being adjacent members of Vector3.
+  __m128d col0 = _mm_set_pd(this->m[1][0], this->m[0][0]);
+  __m128d col1 = _mm_set_pd(this->m[1][1], this->m[0][1]);
+  __m128d col2 = _mm_set_pd(this->m[1][2], this->m[0][2]);
+  __m128d offsetXY = _mm_set_pd(_offset.y, _offset.x);
+
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    double vx = _in[i].x;
+    double vy = _in[i].y;
+    double vz = _in[i].z;
+
+    __m128d xy = _mm_add_pd(
+        _mm_add_pd(_mm_mul_pd(col0, _mm_set1_pd(vx)),
+                   _mm_mul_pd(col1, _mm_set1_pd(vy))),
+        _mm_add_pd(_mm_mul_pd(col2, _mm_set1_pd(vz)), offsetXY));
+
+    _out[i].z = this->m[2][0]*vx + this->m[2][1]*vy + this->m[2][2]*vz +
+                _offset.z;
+    _mm_storeu_pd(&_out[i].x, xy);
+  }
+#else
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    double vx = _in[i].x;
+    double vy = _in[i].y;
+    double vz = _in[i].z;
+
+    _out[i].x = this->m[0][0]*vx + this->m[0][1]*vy + this->m[0][2]*vz +
+                _offset.x;
+    _out[i].y = this->m[1][0]*vx + this->m[1][1]*vy + this->m[1][2]*vz +
+                _offset.y;
+    _out[i].z = this->m[2][0]*vx + this->m[2][1]*vy + this->m[2][2]*vz +
+                _offset.z;
+  }
+#endif
+}
@@ -133,6 +133,28 @@ namespace gazebo
           this->m[2][0]*_m[0][2]+this->m[2][1]*_m[1][2]+this->m[2][2]*_m[2][2]);
       }
 
+      /// \brief Multiply a vector by this matrix
+      /// \param[in] _v Vector to multiply
+      /// \return product of this * _v
+      public: inline Vector3 operator*(const Vector3 &_v) const
+              {
+                return Vector3(
+                  this->m[0][0]*_v.x + this->m[0][1]*_v.y + this->m[0][2]*_v.z,
+                  this->m[1][0]*_v.x + this->m[1][1]*_v.y + this->m[1][2]*_v.z,
+                  this->m[2][0]*_v.x + this->m[2][1]*_v.y + this->m[2][2]*_v.z);
+              }
+
+      /// \brief Multiply an array of vectors by this matrix and add an
+      /// offset to each result, _out[i] = this * _in[i] + _offset. SSE2 is
+      /// used when it is available.
+      /// \param[in] _in Vectors to transform.
+      /// \param[out] _out Transformed vectors, may be the same array as _in.
+      /// \param[in] _count Number of vectors.
+      /// \param[in] _offset Offset added to each result.
+      public: void Transform(const Vector3 *_in, Vector3 *_out,
+                             unsigned int _count,
+                             const Vector3 &_offset) const;
+
       /// \brief Equality test operator
       /// \param[in] _m Matrix3 to test
       /// \return True if equal (using the default tolerance of 1e-6)
@@ -44,12 +44,6 @@ Matrix4::Matrix4()
   memset(this->m, 0, sizeof(this->m[0][0])*16);
 }
 
-//////////////////////////////////////////////////
-Matrix4::Matrix4(const Matrix4 &_m)
-{
-  memcpy(this->m, _m.m, sizeof(this->m[0][0])*16);
-}
-
 //////////////////////////////////////////////////
 Matrix4::Matrix4(double _v00, double _v01, double _v02, double _v03,
                  double _v10, double _v11, double _v12, double _v13,
@@ -94,20 +88,6 @@ void Matrix4::Set(double _v00, double _v01, double _v02, double _v03,
   this->m[3][3] = _v33;
 }
 
-//////////////////////////////////////////////////
-void Matrix4::SetTranslate(const Vector3 &_t)
-{
-  this->m[0][3] = _t.x;
-  this->m[1][3] = _t.y;
-  this->m[2][3] = _t.z;
-}
-
-//////////////////////////////////////////////////
-Vector3 Matrix4::GetTranslation() const
-{
-  return Vector3(this->m[0][3], this->m[1][3], this->m[2][3]);
-}
-
 //////////////////////////////////////////////////
 Quaternion Matrix4::GetRotation() const
 {
@@ -210,13 +190,6 @@ void Matrix4::SetScale(const Vector3 &_s)
 }
 
 
-//////////////////////////////////////////////////
-Matrix4 &Matrix4::operator =(const Matrix4 &_mat)
-{
-  memcpy(this->m, _mat.m, sizeof(this->m[0][0])*16);
-  return *this;
-}
-
 //////////////////////////////////////////////////
 const Matrix4 &Matrix4::operator =(const Matrix3 &mat)
 {
@@ -257,107 +230,6 @@ Matrix4 Matrix4::operator*(const Matrix3 &m2) const
   return r;
 }
 
-//////////////////////////////////////////////////
-Matrix4 Matrix4::operator*(const Matrix4 &m2) const
-{
-  Matrix4 r;
-
-  r.m[0][0] = this->m[0][0] * m2.m[0][0] +
-              this->m[0][1] * m2.m[1][0] +
-              this->m[0][2] * m2.m[2][0] +
-              this->m[0][3] * m2.m[3][0];
-
-  r.m[0][1] = this->m[0][0] * m2.m[0][1] +
-              this->m[0][1] * m2.m[1][1] +
-              this->m[0][2] * m2.m[2][1] +
-              this->m[0][3] * m2.m[3][1];
-
-  r.m[0][2] = this->m[0][0] * m2.m[0][2] +
-              this->m[0][1] * m2.m[1][2] +
-              this->m[0][2] * m2.m[2][2] +
-              this->m[0][3] * m2.m[3][2];
-
-  r.m[0][3] = this->m[0][0] * m2.m[0][3] +
-              this->m[0][1] * m2.m[1][3] +
-              this->m[0][2] * m2.m[2][3] +
-              this->m[0][3] * m2.m[3][3];
-
-  r.m[1][0] = this->m[1][0] * m2.m[0][0] +
-              this->m[1][1] * m2.m[1][0] +
-              this->m[1][2] * m2.m[2][0] +
-              this->m[1][3] * m2.m[3][0];
-
-  r.m[1][1] = this->m[1][0] * m2.m[0][1] +
-              this->m[1][1] * m2.m[1][1] +
-              this->m[1][2] * m2.m[2][1] +
-              this->m[1][3] * m2.m[3][1];
-
-  r.m[1][2] = this->m[1][0] * m2.m[0][2] +
-              this->m[1][1] * m2.m[1][2] +
-              this->m[1][2] * m2.m[2][2] +
-              this->m[1][3] * m2.m[3][2];
-
-  r.m[1][3] = this->m[1][0] * m2.m[0][3] +
-              this->m[1][1] * m2.m[1][3] +
-              this->m[1][2] * m2.m[2][3] +
-              this->m[1][3] * m2.m[3][3];
-
-  r.m[2][0] = this->m[2][0] * m2.m[0][0] +
-              this->m[2][1] * m2.m[1][0] +
-              this->m[2][2] * m2.m[2][0] +
-              this->m[2][3] * m2.m[3][0];
-
-  r.m[2][1] = this->m[2][0] * m2.m[0][1] +
-              this->m[2][1] * m2.m[1][1] +
-              this->m[2][2] * m2.m[2][1] +
-              this->m[2][3] * m2.m[3][1];
-
-  r.m[2][2] = this->m[2][0] * m2.m[0][2] +
-              this->m[2][1] * m2.m[1][2] +
-              this->m[2][2] * m2.m[2][2] +
-              this->m[2][3] * m2.m[3][2];
-
-  r.m[2][3] = this->m[2][0] * m2.m[0][3] +
-              this->m[2][1] * m2.m[1][3] +
-              this->m[2][2] * m2.m[2][3] +
-              this->m[2][3] * m2.m[3][3];
-
-  r.m[3][0] = this->m[3][0] * m2.m[0][0] +
-              this->m[3][1] * m2.m[1][0] +
-              this->m[3][2] * m2.m[2][0] +
-              this->m[3][3] * m2.m[3][0];
-
-  r.m[3][1] = this->m[3][0] * m2.m[0][1] +
-              this->m[3][1] * m2.m[1][1] +
-              this->m[3][2] * m2.m[2][1] +
-              this->m[3][3] * m2.m[3][1];
-
-  r.m[3][2] = this->m[3][0] * m2.m[0][2] +
-              this->m[3][1] * m2.m[1][2] +
-              this->m[3][2] * m2.m[2][2] +
-              this->m[3][3] * m2.m[3][2];
-
-  r.m[3][3] = this->m[3][0] * m2.m[0][3] +
-              this->m[3][1] * m2.m[1][3] +
-              this->m[3][2] * m2.m[2][3] +
-              this->m[3][3] * m2.m[3][3];
-
-  return r;
-}
-
-//////////////////////////////////////////////////
-Vector3 Matrix4::operator*(const Vector3 &_vec) const
-{
-  Vector3 result;
-  result.x = this->m[0][0]*_vec.x + this->m[0][1]*_vec.y +
-             this->m[0][2]*_vec.z + this->m[0][3];
-  result.y = this->m[1][0]*_vec.x + this->m[1][1]*_vec.y +
-             this->m[1][2]*_vec.z + this->m[1][3];
-  result.z = this->m[2][0]*_vec.x + this->m[2][1]*_vec.y +
-             this->m[2][2]*_vec.z + this->m[2][3];
-  return result;
-}
-
 //////////////////////////////////////////////////
 bool Matrix4::IsAffine() const
 {
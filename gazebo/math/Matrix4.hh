@@ -18,6 +18,7 @@
 #define _MATRIX4_HH_
 
 #include <assert.h>
+#include <string.h>
 #include <iostream>
 
 #include "math/Vector3.hh"
@@ -42,7 +43,10 @@ namespace gazebo
 
       /// \brief Copy constructor
       /// \param _m Matrix to copy
-      public: Matrix4(const Matrix4 &_m);
+      public: inline Matrix4(const Matrix4 &_m)
+              {
+                memcpy(this->m, _m.m, sizeof(this->m[0][0])*16);
+              }
 
       /// \brief Constructor
       /// \param[in] _v00 Row 0, Col 0 value
@@ -95,11 +99,19 @@ namespace gazebo
 
       /// \brief Set the translational values [ (0, 3) (1, 3) (2, 3) ]
       /// \param[in] _t Values to set
-      public: void SetTranslate(const Vector3 &_t);
+      public: inline void SetTranslate(const Vector3 &_t)
+              {
+                this->m[0][3] = _t.x;
+                this->m[1][3] = _t.y;
+                this->m[2][3] = _t.z;
+              }
 
       /// \brief Get the translational values as a Vector3
       /// \return x,y,z
-      public: Vector3 GetTranslation() const;
+      public: inline Vector3 GetTranslation() const
+              {
+                return Vector3(this->m[0][3], this->m[1][3], this->m[2][3]);
+              }
 
       /// \brief Get the rotation as a quaternion
       /// \return the rotation
@@ -132,7 +144,11 @@ namespace gazebo
       /// \brief Equal operator. this = _mat
       /// \param _mat Incoming matrix
       /// \return itself
-      public: Matrix4 &operator =(const Matrix4 &_mat);
+      public: inline Matrix4 &operator =(const Matrix4 &_mat)
+              {
+                memcpy(this->m, _mat.m, sizeof(this->m[0][0])*16);
+                return *this;
+              }
 
       /// \brief Equal operator for 3x3 matrix
       /// \param _mat Incoming matrix
@@ -142,7 +158,21 @@ namespace gazebo
       /// \brief Multiplication operator
       /// \param _mat Incoming matrix
       /// \return This matrix * _mat
-      public: Matrix4 operator*(const Matrix4 &_mat) const;
+      public: inline Matrix4 operator*(const Matrix4 &_mat) const
+              {
+                Matrix4 r;
+                for (int i = 0; i < 4; ++i)
+                {
+                  for (int j = 0; j < 4; ++j)
+                  {
+                    r.m[i][j] = this->m[i][0] * _mat.m[0][j] +
+                                this->m[i][1] * _mat.m[1][j] +
+                                this->m[i][2] * _mat.m[2][j] +
+                                this->m[i][3] * _mat.m[3][j];
+                  }
+                }
+                return r;
+              }
 
       /// \brief Multiplication operator
       /// \param _mat Incoming matrix
@@ -153,7 +183,15 @@ namespace gazebo
       /// \brief Multiplication operator
       /// \param _vec Vector3
       /// \return Resulting vector from multiplication
-      public: Vector3 operator*(const Vector3 &_vec) const;
+      public: inline Vector3 operator*(const Vector3 &_vec) const
+              {
+                return Vector3(this->m[0][0]*_vec.x + this->m[0][1]*_vec.y +
+                               this->m[0][2]*_vec.z + this->m[0][3],
+                               this->m[1][0]*_vec.x + this->m[1][1]*_vec.y +
+                               this->m[1][2]*_vec.z + this->m[1][3],
+                               this->m[2][0]*_vec.x + this->m[2][1]*_vec.y +
+                               this->m[2][2]*_vec.z + this->m[2][3]);
+              }
 
       /// \brief Array subscript operator
       /// \param[in] _row the row index
@@ -26,18 +26,6 @@ using namespace math;
 
 const Pose Pose::Zero = math::Pose(0, 0, 0, 0, 0, 0);
 
-//////////////////////////////////////////////////
-Pose::Pose()
-  : pos(0, 0, 0), rot(1, 0, 0, 0)
-{
-}
-
-//////////////////////////////////////////////////
-Pose::Pose(const Vector3 &_pos, const Quaternion &_rot)
-  : pos(_pos), rot(_rot)
-{
-}
-
 //////////////////////////////////////////////////
 Pose::Pose(double _x, double _y, double _z,
            double _roll, double _pitch, double _yaw)
@@ -45,12 +33,6 @@ Pose::Pose(double _x, double _y, double _z,
 {
 }
 
-//////////////////////////////////////////////////
-Pose::Pose(const Pose &_pose)
-  : pos(_pose.pos), rot(_pose.rot)
-{
-}
-
 //////////////////////////////////////////////////
 Pose::~Pose()
 {
@@ -84,26 +66,6 @@ Pose Pose::GetInverse() const
   return Pose(inv * (this->pos*-1), inv);
 }
 
-//////////////////////////////////////////////////
-Pose Pose::operator+(const Pose &_obj) const
-{
-  Pose result;
-
-  result.pos = this->CoordPositionAdd(_obj);
-  result.rot = this->CoordRotationAdd(_obj.rot);
-
-  return result;
-}
-
-//////////////////////////////////////////////////
-const Pose &Pose::operator+=(const Pose &obj)
-{
-  this->pos = this->CoordPositionAdd(obj);
-  this->rot = this->CoordRotationAdd(obj.rot);
-
-  return *this;
-}
-
 //////////////////////////////////////////////////
 const Pose &Pose::operator-=(const Pose &_obj)
 {
@@ -132,50 +94,10 @@ Pose Pose::operator*(const Pose &pose)
 }
 
 //////////////////////////////////////////////////
-Vector3 Pose::CoordPositionAdd(const Vector3 &_pos) const
-{
-  Quaternion tmp;
-  Vector3 result;
-
-  // result = pose.rot + pose.rot * this->_pos * pose.rot!
-  tmp.w = 0.0;
-  tmp.x = _pos.x;
-  tmp.y = _pos.y;
-  tmp.z = _pos.z;
-
-  tmp = this->rot * (tmp * this->rot.GetInverse());
-  result.x = this->pos.x + tmp.x;
-  result.y = this->pos.y + tmp.y;
-  result.z = this->pos.z + tmp.z;
-
-  return result;
-}
-
-//////////////////////////////////////////////////
-Vector3 Pose::CoordPositionAdd(const Pose &_pose) const
-{
-  Quaternion tmp;
-  Vector3 result;
-
-  // result = _pose.rot + _pose.rot * this->pos * _pose.rot!
-  tmp.w = 0.0;
-  tmp.x = this->pos.x;
-  tmp.y = this->pos.y;
-  tmp.z = this->pos.z;
-
-  tmp = _pose.rot * (tmp * _pose.rot.GetInverse());
-
-  result.x = _pose.pos.x + tmp.x;
-  result.y = _pose.pos.y + tmp.y;
-  result.z = _pose.pos.z + tmp.z;
-
-  return result;
-}
-
-//////////////////////////////////////////////////
-Quaternion Pose::CoordRotationAdd(const Quaternion &_rot) const
+void Pose::CoordPositionAdd(const Vector3 *_in, Vector3 *_out,
+                            unsigned int _count) const
 {
-  return Quaternion(_rot * this->rot);
+  this->rot.GetAsMatrix3().Transform(_in, _out, _count, this->pos);
 }
 
 //////////////////////////////////////////////////
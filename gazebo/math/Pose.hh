@@ -42,12 +42,18 @@ namespace gazebo
       public: static const Pose Zero;
 
       /// \brief Default constructors
-      public: Pose();
+      public: inline Pose()
+              : pos(0, 0, 0), rot(1, 0, 0, 0)
+              {
+              }
 
       /// \brief Constructor
       /// \param[in] _pos A position
       /// \param[in] _rot A rotation
-      public: Pose(const Vector3 &_pos, const Quaternion &_rot);
+      public: inline Pose(const Vector3 &_pos, const Quaternion &_rot)
+              : pos(_pos), rot(_rot)
+              {
+              }
 
       /// \brief Constructor
       /// \param[in] _x x position in meters.
@@ -61,7 +67,10 @@ namespace gazebo
 
       /// \brief Copy constructor
       /// \param[in] _pose Pose to copy
-      public: Pose(const Pose &_pose);
+      public: inline Pose(const Pose &_pose)
+              : pos(_pose.pos), rot(_pose.rot)
+              {
+              }
 
       /// \brief Destructor
       public: virtual ~Pose();
@@ -98,12 +107,21 @@ namespace gazebo
       /// \brief Addition operator
       /// \param[in] _pose Pose to add to this pose
       /// \return The resulting pose
-      public: Pose operator+(const Pose &_pose) const;
+      public: inline Pose operator+(const Pose &_pose) const
+              {
+                return Pose(this->CoordPositionAdd(_pose),
+                            this->CoordRotationAdd(_pose.rot));
+              }
 
       /// \brief Add-Equals operator
       /// \param[in] _pose Pose to add to this pose
       /// \return The resulting pose
-      public: const Pose &operator+=(const Pose &_pose);
+      public: inline const Pose &operator+=(const Pose &_pose)
+              {
+                this->pos = this->CoordPositionAdd(_pose);
+                this->rot = this->CoordRotationAdd(_pose.rot);
+                return *this;
+              }
 
       /// \brief Negation operator
       /// \return The resulting pose
@@ -144,12 +162,35 @@ namespace gazebo
       /// \brief Add one point to a vector: result = this + pos
       /// \param[in] _pos Position to add to this pose
       /// \return the resulting position
-      public: Vector3 CoordPositionAdd(const Vector3 &_pos) const;
+      public: inline Vector3 CoordPositionAdd(const Vector3 &_pos) const
+              {
+                // result = pose.rot + pose.rot * this->_pos * pose.rot!
+                Quaternion tmp(0.0, _pos.x, _pos.y, _pos.z);
+                tmp = this->rot * (tmp * this->rot.GetInverse());
+                return Vector3(this->pos.x + tmp.x, this->pos.y + tmp.y,
+                               this->pos.z + tmp.z);
+              }
+
+      /// \brief Add this pose to an array of points: _out[i] = this +
+      /// _in[i]. This is faster than calling CoordPositionAdd for each
+      /// point.
+      /// \param[in] _in Points to transform.
+      /// \param[out] _out Transformed points, may be the same array as _in.
+      /// \param[in] _count Number of points.
+      public: void CoordPositionAdd(const Vector3 *_in, Vector3 *_out,
+                                    unsigned int _count) const;
 
       /// \brief Add one point to another: result = this + pose
       /// \param[in] _pose The Pose to add
       /// \return The resulting position
-      public: Vector3 CoordPositionAdd(const Pose &_pose) const;
+      public: inline Vector3 CoordPositionAdd(const Pose &_pose) const
+              {
+                // result = _pose.rot + _pose.rot * this->pos * _pose.rot!
+                Quaternion tmp(0.0, this->pos.x, this->pos.y, this->pos.z);
+                tmp = _pose.rot * (tmp * _pose.rot.GetInverse());
+                return Vector3(_pose.pos.x + tmp.x, _pose.pos.y + tmp.y,
+                               _pose.pos.z + tmp.z);
+              }
 
       /// \brief Subtract one position from another: result = this - pose
       /// \param[in] _pose Pose to subtract
@@ -168,7 +209,10 @@ namespace gazebo
       /// \brief Add one rotation to another: result =  this->rot + rot
       /// \param[in] _rot Rotation to add
       /// \return The resulting rotation
-      public: Quaternion CoordRotationAdd(const Quaternion &_rot) const;
+      public: inline Quaternion CoordRotationAdd(const Quaternion &_rot) const
+              {
+                return Quaternion(_rot * this->rot);
+              }
 
       /// \brief Subtract one rotation from another: result = this->rot - rot
       /// \param[in] _rot The rotation to subtract
@@ -130,3 +130,23 @@ TEST(PoseTest, Pose)
   EXPECT_TRUE(pose.rot == math::Quaternion(0, 0, 0));
 }
 
+/////////////////////////////////////////////////
+TEST(PoseTest, CoordPositionAddArray)
+{
+  math::Pose pose(5, 6, 7, 0.4, 0.6, -1.2);
+
+  std::vector<math::Vector3> points;
+  for (int i = 0; i < 17; ++i)
+    points.push_back(math::Vector3(i * 0.5, -i, 3.0 - i * 0.25));
+
+  std::vector<math::Vector3> result(points.size());
+  pose.CoordPositionAdd(&points[0], &result[0], points.size());
+  for (unsigned int i = 0; i < points.size(); ++i)
+    EXPECT_TRUE(result[i] == pose.CoordPositionAdd(points[i]));
+
+  // Transform in place
+  std::vector<math::Vector3> inPlace = points;
+  pose.CoordPositionAdd(&inPlace[0], &inPlace[0], inPlace.size());
+  for (unsigned int i = 0; i < points.size(); ++i)
+    EXPECT_TRUE(inPlace[i] == result[i]);
+}
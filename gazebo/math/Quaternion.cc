@@ -25,21 +25,6 @@
 using namespace gazebo;
 using namespace math;
 
-//////////////////////////////////////////////////
-Quaternion::Quaternion()
-    : w(1), x(0), y(0), z(0)
-{
-  // quaternion not normalized, because that breaks
-  // Pose::CoordPositionAdd(...)
-}
-
-//////////////////////////////////////////////////
-Quaternion::Quaternion(const double &_w, const double &_x,
-                       const double &_y, const double &_z)
-    : w(_w), x(_x), y(_y), z(_z)
-{
-}
-
 //////////////////////////////////////////////////
 Quaternion::Quaternion(const double &_roll, const double &_pitch,
                        const double &_yaw)
@@ -59,31 +44,11 @@ Quaternion::Quaternion(const Vector3 &_axis, const double &_angle)
   this->SetFromAxis(_axis, _angle);
 }
 
-//////////////////////////////////////////////////
-Quaternion::Quaternion(const Quaternion &_qt)
-{
-  this->w = _qt.w;
-  this->x = _qt.x;
-  this->y = _qt.y;
-  this->z = _qt.z;
-}
-
 //////////////////////////////////////////////////
 Quaternion::~Quaternion()
 {
 }
 
-//////////////////////////////////////////////////
-Quaternion &Quaternion::operator =(const Quaternion &qt)
-{
-  this->w = qt.w;
-  this->x = qt.x;
-  this->y = qt.y;
-  this->z = qt.z;
-
-  return *this;
-}
-
 //////////////////////////////////////////////////
 void Quaternion::SetToIdentity()
 {
@@ -386,45 +351,20 @@ Quaternion Quaternion::operator*=(const Quaternion &qt)
 }
 
 //////////////////////////////////////////////////
-Vector3 Quaternion::operator*(const Vector3 &v) const
-{
-  Vector3 uv, uuv;
-  Vector3 qvec(this->x, this->y, this->z);
-  uv = qvec.Cross(v);
-  uuv = qvec.Cross(uv);
-  uv *= (2.0f * this->w);
-  uuv *= 2.0f;
-
-  return v + uv + uuv;
-}
-
-//////////////////////////////////////////////////
-Quaternion Quaternion::operator*(const double &_f) const
+void Quaternion::RotateVectors(const Vector3 *_in, Vector3 *_out,
+                               unsigned int _count) const
 {
-  return Quaternion(this->w*_f, this->x*_f, this->y*_f, this->z*_f);
+  this->GetAsMatrix3().Transform(_in, _out, _count, Vector3::Zero);
 }
 
 //////////////////////////////////////////////////
-Vector3 Quaternion::RotateVectorReverse(Vector3 _vec) const
+void Quaternion::RotateVectorsReverse(const Vector3 *_in, Vector3 *_out,
+                                      unsigned int _count) const
 {
-  Quaternion tmp;
-  Vector3 result;
-
-  tmp.w = 0.0;
-  tmp.x = _vec.x;
-  tmp.y = _vec.y;
-  tmp.z = _vec.z;
-
-  tmp =  this->GetInverse() * (tmp * (*this));
-
-  result.x = tmp.x;
-  result.y = tmp.y;
-  result.z = tmp.z;
-
-  return result;
+  this->GetInverse().GetAsMatrix3().Transform(_in, _out, _count,
+                                              Vector3::Zero);
 }
 
-
 //////////////////////////////////////////////////
 bool Quaternion::IsFinite() const
 {
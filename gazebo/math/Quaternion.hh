@@ -44,15 +44,23 @@ namespace gazebo
   class Quaternion
   {
     /// \brief Default Constructor
-    public: Quaternion();
+    public: inline Quaternion()
+            : w(1), x(0), y(0), z(0)
+            {
+              // quaternion not normalized, because that breaks
+              // Pose::CoordPositionAdd(...)
+            }
 
     /// \brief Constructor
     /// \param[in] _w W param
     /// \param[in] _x X param
     /// \param[in] _y Y param
     /// \param[in] _z Z param
-    public: Quaternion(const double &_w, const double &_x, const double &_y,
-                        const double &_z);
+    public: inline Quaternion(const double &_w, const double &_x,
+                              const double &_y, const double &_z)
+            : w(_w), x(_x), y(_y), z(_z)
+            {
+            }
 
     /// \brief Constructor from Euler angles in radians
     /// \param[in] _roll  roll
@@ -72,14 +80,24 @@ namespace gazebo
 
     /// \brief Copy constructor
     /// \param qt Quaternion to copy
-    public: Quaternion(const Quaternion &_qt);
+    public: inline Quaternion(const Quaternion &_qt)
+            : w(_qt.w), x(_qt.x), y(_qt.y), z(_qt.z)
+            {
+            }
 
     /// \brief Destructor
     public: ~Quaternion();
 
     /// \brief Equal operator
     /// \param[in] _qt Quaternion to copy
-    public: Quaternion &operator =(const Quaternion &_qt);
+    public: inline Quaternion &operator =(const Quaternion &_qt)
+            {
+              this->w = _qt.w;
+              this->x = _qt.x;
+              this->y = _qt.y;
+              this->z = _qt.z;
+              return *this;
+            }
 
     /// \brief Invert the quaternion
     public: void Invert();
@@ -228,7 +246,10 @@ namespace gazebo
     /// \brief Multiplication operator
     /// \param[in] _f factor
     /// \return quaternion multiplied by _f
-    public: Quaternion operator*(const double &_f) const;
+    public: inline Quaternion operator*(const double &_f) const
+            {
+              return Quaternion(this->w*_f, this->x*_f, this->y*_f, this->z*_f);
+            }
 
     /// \brief Multiplication operator
     /// \param[in] _qt Quaternion for multiplication
@@ -237,7 +258,15 @@ namespace gazebo
 
     /// \brief Vector3 multiplication operator
     /// \param[in] _v vector to multiply
-    public: Vector3 operator*(const Vector3 &_v) const;
+    public: inline Vector3 operator*(const Vector3 &_v) const
+            {
+              Vector3 qvec(this->x, this->y, this->z);
+              Vector3 uv = qvec.Cross(_v);
+              Vector3 uuv = qvec.Cross(uv);
+              uv *= (2.0f * this->w);
+              uuv *= 2.0f;
+              return _v + uv + uuv;
+            }
 
     /// \brief Equal to operator
     /// \param[in] _qt Quaternion for comparison
@@ -266,7 +295,27 @@ namespace gazebo
     /// \brief Do the reverse rotation of a vector by this quaternion
     /// \param[in] _vec the vector
     /// \return the
-    public: Vector3 RotateVectorReverse(Vector3 _vec) const;
+    public: inline Vector3 RotateVectorReverse(Vector3 _vec) const
+            {
+              Quaternion tmp(0.0, _vec.x, _vec.y, _vec.z);
+              tmp = this->GetInverse() * (tmp * (*this));
+              return Vector3(tmp.x, tmp.y, tmp.z);
+            }
+
+    /// \brief Rotate an array of vectors using the quaternion. This is
+    /// faster than calling RotateVector for each vector.
+    /// \param[in] _in Vectors to rotate.
+    /// \param[out] _out Rotated vectors, may be the same array as _in.
+    /// \param[in] _count Number of vectors.
+    public: void RotateVectors(const Vector3 *_in, Vector3 *_out,
+                               unsigned int _count) const;
+
+    /// \brief Do the reverse rotation of an array of vectors.
+    /// \param[in] _in Vectors to rotate.
+    /// \param[out] _out Rotated vectors, may be the same array as _in.
+    /// \param[in] _count Number of vectors.
+    public: void RotateVectorsReverse(const Vector3 *_in, Vector3 *_out,
+                                      unsigned int _count) const;
 
     /// \brief See if a quatern is finite (e.g., not nan)
     /// \return True if quatern is finite
@@ -254,3 +254,22 @@ TEST(QuaternionTest, Quaternion)
                 0, 0, 0, 1));
   }
 }
+
+/////////////////////////////////////////////////
+TEST(QuaternionTest, RotateVectors)
+{
+  math::Quaternion q(0.1, -0.3, 2.4);
+
+  std::vector<math::Vector3> vecs;
+  for (int i = 0; i < 9; ++i)
+    vecs.push_back(math::Vector3(1.0 - i, i * 0.5, i * i * 0.1));
+
+  std::vector<math::Vector3> rotated(vecs.size());
+  q.RotateVectors(&vecs[0], &rotated[0], vecs.size());
+  for (unsigned int i = 0; i < vecs.size(); ++i)
+    EXPECT_TRUE(rotated[i] == q.RotateVector(vecs[i]));
+
+  q.RotateVectorsReverse(&rotated[0], &rotated[0], rotated.size());
+  for (unsigned int i = 0; i < vecs.size(); ++i)
+    EXPECT_TRUE(rotated[i] == vecs[i]);
+}
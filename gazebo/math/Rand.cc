@@ -49,6 +49,18 @@ uint32_t Rand::GetSeed()
   return seed;
 }
 
+//////////////////////////////////////////////////
+const GeneratorType &Rand::GetGenerator()
+{
+  return *randGenerator;
+}
+
+//////////////////////////////////////////////////
+void Rand::SetGenerator(const GeneratorType &_generator)
+{
+  *randGenerator = _generator;
+}
+
 //////////////////////////////////////////////////
 double Rand::GetDblUniform(double _min, double _max)
 {
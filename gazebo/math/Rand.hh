@@ -68,6 +68,15 @@ namespace gazebo
       /// generator.
       public: static uint32_t GetSeed();
 
+      /// \brief Get the generator, to save its state.
+      /// \return The random number generator.
+      public: static const GeneratorType &GetGenerator();
+
+      /// \brief Set the state of the generator, to repeat the numbers it
+      /// gave after a call to GetGenerator. The seed isn't changed.
+      /// \param[in] _generator Copy of a generator.
+      public: static void SetGenerator(const GeneratorType &_generator);
+
       /// \brief Get a double from a uniform distribution
       /// \param[in] _min Minimum bound for the random number
       /// \param[in] _max Maximum bound for the random number
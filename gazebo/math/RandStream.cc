@@ -0,0 +1,515 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "math/RandStream.hh"
+
+using namespace gazebo;
+using namespace math;
+
+/// \brief Multipliers of the Philox4x32 rounds.
+static const uint32_t PhiloxM0 = 0xD2511F53;
+static const uint32_t PhiloxM1 = 0xCD9E8D57;
+
+/// \brief Increments of the key between the rounds.
+static const uint32_t PhiloxW0 = 0x9E3779B9;
+static const uint32_t PhiloxW1 = 0xBB67AE85;
+
+/// \brief Number of rounds.
+static const int PhiloxRounds = 10;
+
+/// \brief Blocks generated at once by GetUniform and GetNormal.
+static const unsigned int RandStreamChunk = 64;
+
+/// \brief Blocks transformed at once by the SSE2 version of GetNormal.
+static const unsigned int NormalBlocks = 4;
+
+/// \brief 2^-32, scales a word to [0, 1).
+static const double WordScale = 1.0 / 4294967296.0;
+
+/// \brief Coefficients of the series of atanh(f) / f in f^2, highest
+/// power first, for log(m) = 2 atanh((m - 1) / (m + 1)).
+static const double LogCoefs[] =
+{
+  1.0 / 17, 1.0 / 15, 1.0 / 13, 1.0 / 11, 1.0 / 9, 1.0 / 7,
+  1.0 / 5, 1.0 / 3, 1.0
+};
+
+/// \brief Taylor coefficients of sin(x) / x in x^2, highest power first.
+static const double SinCoefs[] =
+{
+  1.0 / 6227020800.0, -1.0 / 39916800.0,
+  1.0 / 362880.0, -1.0 / 5040.0, 1.0 / 120.0, -1.0 / 6.0, 1.0
+};
+
+/// \brief Taylor coefficients of cos(x) in x^2, highest power first.
+static const double CosCoefs[] =
+{
+  -1.0 / 87178291200.0, 1.0 / 479001600.0,
+  -1.0 / 3628800.0, 1.0 / 40320.0, -1.0 / 720.0, 1.0 / 24.0, -1.0 / 2.0,
+  1.0
+};
+
+/// \brief Number of coefficients of each series.
+static const int LogCoefCount = sizeof(LogCoefs) / sizeof(LogCoefs[0]);
+static const int SinCoefCount = sizeof(SinCoefs) / sizeof(SinCoefs[0]);
+static const int CosCoefCount = sizeof(CosCoefs) / sizeof(CosCoefs[0]);
+
+//////////////////////////////////////////////////
+/// \brief Run the Philox4x32-10 rounds on one block.
+/// \param[in,out] _ctr Counter as input, random words as output.
+/// \param[in] _key0 First word of the key.
+/// \param[in] _key1 Second word of the key.
+static inline void philox(uint32_t _ctr[4], uint32_t _key0, uint32_t _key1)
+{
+  for (int round = 0; round < PhiloxRounds; ++round)
+  {
+    uint64_t prod0 = static_cast<uint64_t>(PhiloxM0) * _ctr[0];
+    uint64_t prod1 = static_cast<uint64_t>(PhiloxM1) * _ctr[2];
+
+    uint32_t r0 = static_cast<uint32_t>(prod1 >> 32) ^ _ctr[1] ^ _key0;
+    uint32_t r2 = static_cast<uint32_t>(prod0 >> 32) ^ _ctr[3] ^ _key1;
+    _ctr[0] = r0;
+    _ctr[1] = static_cast<uint32_t>(prod1);
+    _ctr[2] = r2;
+    _ctr[3] = static_cast<uint32_t>(prod0);
+
+    _key0 += PhiloxW0;
+    _key1 += PhiloxW1;
+  }
+}
+
+#ifdef __SSE2__
+//////////////////////////////////////////////////
+/// \brief Run the Philox4x32-10 rounds on two blocks, one per 64 bit lane.
+/// Each word of the blocks is in the low half of its lane. The high
+/// halves are left with garbage, ignored by the multiplications.
+/// \param[in,out] _r0 First words of the blocks.
+/// \param[in,out] _r1 Second words of the blocks.
+/// \param[in,out] _r2 Third words of the blocks.
+/// \param[in,out] _r3 Fourth words of the blocks.
+/// \param[in] _key0 First word of the key.
+/// \param[in] _key1 Second word of the key.
+static inline void philox2(__m128i &_r0, __m128i &_r1, __m128i &_r2,
+                           __m128i &_r3, uint32_t _key0, uint32_t _key1)
+{
+  const __m128i m0 = _mm_set1_epi32(PhiloxM0);
+  const __m128i m1 = _mm_set1_epi32(PhiloxM1);
+  __m128i key0 = _mm_set1_epi32(_key0);
+  __m128i key1 = _mm_set1_epi32(_key1);
+
+  for (int round = 0; round < PhiloxRounds; ++round)
+  {
+    __m128i prod0 = _mm_mul_epu32(_r0, m0);
+    __m128i prod1 = _mm_mul_epu32(_r2, m1);
+
+    _r0 = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi64(prod1, 32), _r1),
+                        key0);
+    _r1 = prod1;
+    _r2 = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi64(prod0, 32), _r3),
+                        key1);
+    _r3 = prod0;
+
+    key0 = _mm_add_epi32(key0, _mm_set1_epi32(PhiloxW0));
+    key1 = _mm_add_epi32(key1, _mm_set1_epi32(PhiloxW1));
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Store the two blocks computed by philox2.
+/// \param[in] _r0 First words of the blocks.
+/// \param[in] _r1 Second words of the blocks.
+/// \param[in] _r2 Third words of the blocks.
+/// \param[in] _r3 Fourth words of the blocks.
+/// \param[out] _out The 8 words.
+static inline void storeBlocks2(__m128i _r0, __m128i _r1, __m128i _r2,
+                                __m128i _r3, uint32_t *_out)
+{
+  __m128i *out = reinterpret_cast<__m128i *>(_out);
+  _mm_storeu_si128(out, _mm_unpacklo_epi64(
+        _mm_unpacklo_epi32(_r0, _r1), _mm_unpacklo_epi32(_r2, _r3)));
+  _mm_storeu_si128(out + 1, _mm_unpacklo_epi64(
+        _mm_unpackhi_epi32(_r0, _r1), _mm_unpackhi_epi32(_r2, _r3)));
+}
+#endif
+
+//////////////////////////////////////////////////
+/// \brief Convert two words to a number in [0, 1) with 53 bits.
+/// \param[in] _a Word giving the high bits.
+/// \param[in] _b Word giving the low bits.
+/// \return The number.
+static inline double toUniform(uint32_t _a, uint32_t _b)
+{
+  return ((_a >> 5) * 67108864.0 + (_b >> 6)) * (1.0 / 9007199254740992.0);
+}
+
+//////////////////////////////////////////////////
+/// \brief Natural logarithm of a number in (0, 1]. The SSE2 version below
+/// does the same operations in the same order, so both give the same
+/// result.
+/// \param[in] _u The number.
+/// \return The logarithm.
+static inline double logUnit(double _u)
+{
+  uint64_t bits;
+  memcpy(&bits, &_u, sizeof(bits));
+
+  // _u = m * 2^e with m in [sqrt(1/2), sqrt(2))
+  double e = static_cast<int>(bits >> 52) - 1023.0;
+  bits = (bits & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL;
+  double m;
+  memcpy(&m, &bits, sizeof(m));
+  if (m > M_SQRT2)
+  {
+    m = m * 0.5;
+    e = e + 1.0;
+  }
+
+  double f = (m - 1.0) / (m + 1.0);
+  double f2 = f * f;
+  double p = LogCoefs[0];
+  for (int i = 1; i < LogCoefCount; ++i)
+    p = p * f2 + LogCoefs[i];
+
+  return e * M_LN2 + (2.0 * f) * p;
+}
+
+//////////////////////////////////////////////////
+/// \brief Sine and cosine of an angle given in turns, in [0, 1).
+/// \param[in] _turns The angle.
+/// \param[out] _sin The sine.
+/// \param[out] _cos The cosine.
+static inline void sinCosTurns(double _turns, double &_sin, double &_cos)
+{
+  // Nearest quarter turn, and the rest in [-pi/4, pi/4]
+  int quarter = static_cast<int>(_turns * 4.0 + 0.5);
+  double x = (_turns - quarter * 0.25) * (2.0 * M_PI);
+  double x2 = x * x;
+
+  double s = SinCoefs[0];
+  for (int i = 1; i < SinCoefCount; ++i)
+    s = s * x2 + SinCoefs[i];
+  s = s * x;
+
+  double c = CosCoefs[0];
+  for (int i = 1; i < CosCoefCount; ++i)
+    c = c * x2 + CosCoefs[i];
+
+  if (quarter & 1)
+    std::swap(s, c);
+  _sin = (quarter & 2) ? -s : s;
+  _cos = ((quarter + 1) & 2) ? -c : c;
+}
+
+#ifdef __SSE2__
+//////////////////////////////////////////////////
+/// \brief logUnit on 2 numbers.
+/// \param[in] _u The numbers.
+/// \return The logarithms.
+static inline __m128d logUnit2(__m128d _u)
+{
+  __m128i bits = _mm_castpd_si128(_u);
+
+  // Exponents of both lanes in the two low words
+  __m128i exps = _mm_shuffle_epi32(_mm_srli_epi64(bits, 52),
+      _MM_SHUFFLE(3, 3, 2, 0));
+  __m128d e = _mm_sub_pd(_mm_cvtepi32_pd(exps), _mm_set1_pd(1023.0));
+
+  bits = _mm_or_si128(
+      _mm_and_si128(bits, _mm_set1_epi64x(0x000FFFFFFFFFFFFFLL)),
+      _mm_set1_epi64x(0x3FF0000000000000LL));
+  __m128d m = _mm_castsi128_pd(bits);
+
+  __m128d big = _mm_cmpgt_pd(m, _mm_set1_pd(M_SQRT2));
+  m = _mm_or_pd(_mm_and_pd(big, _mm_mul_pd(m, _mm_set1_pd(0.5))),
+                _mm_andnot_pd(big, m));
+  e = _mm_add_pd(e, _mm_and_pd(big, _mm_set1_pd(1.0)));
+
+  const __m128d one = _mm_set1_pd(1.0);
+  __m128d f = _mm_div_pd(_mm_sub_pd(m, one), _mm_add_pd(m, one));
+  __m128d f2 = _mm_mul_pd(f, f);
+  __m128d p = _mm_set1_pd(LogCoefs[0]);
+  for (int i = 1; i < LogCoefCount; ++i)
+    p = _mm_add_pd(_mm_mul_pd(p, f2), _mm_set1_pd(LogCoefs[i]));
+
+  return _mm_add_pd(_mm_mul_pd(e, _mm_set1_pd(M_LN2)),
+                    _mm_mul_pd(_mm_mul_pd(_mm_set1_pd(2.0), f), p));
+}
+
+//////////////////////////////////////////////////
+/// \brief sinCosTurns on 2 angles.
+/// \param[in] _turns The angles.
+/// \param[out] _sin The sines.
+/// \param[out] _cos The cosines.
+static inline void sinCosTurns2(__m128d _turns, __m128d &_sin,
+                                __m128d &_cos)
+{
+  __m128i quarter = _mm_cvttpd_epi32(_mm_add_pd(
+      _mm_mul_pd(_turns, _mm_set1_pd(4.0)), _mm_set1_pd(0.5)));
+  __m128d x = _mm_mul_pd(_mm_sub_pd(_turns,
+      _mm_mul_pd(_mm_cvtepi32_pd(quarter), _mm_set1_pd(0.25))),
+      _mm_set1_pd(2.0 * M_PI));
+  __m128d x2 = _mm_mul_pd(x, x);
+
+  __m128d s = _mm_set1_pd(SinCoefs[0]);
+  for (int i = 1; i < SinCoefCount; ++i)
+    s = _mm_add_pd(_mm_mul_pd(s, x2), _mm_set1_pd(SinCoefs[i]));
+  s = _mm_mul_pd(s, x);
+
+  __m128d c = _mm_set1_pd(CosCoefs[0]);
+  for (int i = 1; i < CosCoefCount; ++i)
+    c = _mm_add_pd(_mm_mul_pd(c, x2), _mm_set1_pd(CosCoefs[i]));
+
+  // One mask per lane from the quarter of the lane
+  __m128i lanes = _mm_shuffle_epi32(quarter, _MM_SHUFFLE(1, 1, 0, 0));
+  __m128d swap = _mm_castsi128_pd(_mm_cmpeq_epi32(
+      _mm_and_si128(lanes, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+  __m128d sinNeg = _mm_castsi128_pd(_mm_cmpeq_epi32(
+      _mm_and_si128(lanes, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+  __m128d cosNeg = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(
+      _mm_add_epi32(lanes, _mm_set1_epi32(1)), _mm_set1_epi32(2)),
+      _mm_set1_epi32(2)));
+
+  __m128d sign = _mm_set1_pd(-0.0);
+  _sin = _mm_or_pd(_mm_and_pd(swap, c), _mm_andnot_pd(swap, s));
+  _cos = _mm_or_pd(_mm_and_pd(swap, s), _mm_andnot_pd(swap, c));
+  _sin = _mm_xor_pd(_sin, _mm_and_pd(sinNeg, sign));
+  _cos = _mm_xor_pd(_cos, _mm_and_pd(cosNeg, sign));
+}
+
+//////////////////////////////////////////////////
+/// \brief Convert the 4 words of a block to doubles, exactly. Each word
+/// is put in the mantissa of 2^52, which is then subtracted.
+/// \param[in] _words The words.
+/// \param[out] _even The first and third words.
+/// \param[out] _odd The second and fourth words.
+static inline void wordsToDoubles2(__m128i _words, __m128d &_even,
+                                   __m128d &_odd)
+{
+  const __m128i high = _mm_set1_epi32(0x43300000);
+  const __m128d bias = _mm_set1_pd(4503599627370496.0);
+
+  __m128i words = _mm_shuffle_epi32(_words, _MM_SHUFFLE(3, 1, 2, 0));
+  _even = _mm_sub_pd(_mm_castsi128_pd(_mm_unpacklo_epi32(words, high)),
+                     bias);
+  _odd = _mm_sub_pd(_mm_castsi128_pd(_mm_unpackhi_epi32(words, high)),
+                    bias);
+}
+#endif
+
+//////////////////////////////////////////////////
+RandStream::RandStream()
+  : seed(0), stream(0)
+{
+}
+
+//////////////////////////////////////////////////
+RandStream::RandStream(uint32_t _seed, uint32_t _stream)
+  : seed(_seed), stream(_stream)
+{
+}
+
+//////////////////////////////////////////////////
+RandStream::RandStream(uint32_t _seed, const std::string &_name)
+  : seed(_seed), stream(Hash(_name))
+{
+}
+
+//////////////////////////////////////////////////
+uint32_t RandStream::GetSeed() const
+{
+  return this->seed;
+}
+
+//////////////////////////////////////////////////
+uint32_t RandStream::GetStream() const
+{
+  return this->stream;
+}
+
+//////////////////////////////////////////////////
+void RandStream::GetBlock(uint64_t _counter, uint64_t _block,
+                          uint32_t _out[4]) const
+{
+  _out[0] = static_cast<uint32_t>(_block);
+  _out[1] = static_cast<uint32_t>(_block >> 32);
+  _out[2] = static_cast<uint32_t>(_counter);
+  _out[3] = static_cast<uint32_t>(_counter >> 32);
+  philox(_out, this->seed, this->stream);
+}
+
+//////////////////////////////////////////////////
+void RandStream::GetBlocks(uint64_t _counter, uint64_t _first,
+                           unsigned int _count, uint32_t *_out) const
+{
+  unsigned int i = 0;
+
+#ifdef __SSE2__
+  const __m128i ctr2 = _mm_set1_epi32(static_cast<uint32_t>(_counter));
+  const __m128i ctr3 = _mm_set1_epi32(static_cast<uint32_t>(_counter >> 32));
+
+  // Four blocks at once, two per register
+  for (; i + 4 <= _count; i += 4)
+  {
+    uint64_t b = _first + i;
+    __m128i a0 = _mm_set_epi32(0, static_cast<uint32_t>(b + 1), 0,
+                               static_cast<uint32_t>(b));
+    __m128i a1 = _mm_set_epi32(0, static_cast<uint32_t>((b + 1) >> 32), 0,
+                               static_cast<uint32_t>(b >> 32));
+    __m128i c0 = _mm_set_epi32(0, static_cast<uint32_t>(b + 3), 0,
+                               static_cast<uint32_t>(b + 2));
+    __m128i c1 = _mm_set_epi32(0, static_cast<uint32_t>((b + 3) >> 32), 0,
+                               static_cast<uint32_t>((b + 2) >> 32));
+    __m128i a2 = ctr2, a3 = ctr3, c2 = ctr2, c3 = ctr3;
+
+    philox2(a0, a1, a2, a3, this->seed, this->stream);
+    philox2(c0, c1, c2, c3, this->seed, this->stream);
+
+    storeBlocks2(a0, a1, a2, a3, _out + i * 4);
+    storeBlocks2(c0, c1, c2, c3, _out + i * 4 + 8);
+  }
+#endif
+
+  for (; i < _count; ++i)
+    this->GetBlock(_counter, _first + i, _out + i * 4);
+}
+
+//////////////////////////////////////////////////
+void RandStream::GetUniform(uint64_t _counter, double *_out,
+                            unsigned int _count) const
+{
+  uint32_t words[RandStreamChunk * 4];
+
+  // Two numbers per block
+  for (unsigned int start = 0; start < _count; start += RandStreamChunk * 2)
+  {
+    unsigned int count = std::min(_count - start, RandStreamChunk * 2);
+    this->GetBlocks(_counter, start / 2, (count + 1) / 2, words);
+
+    double *out = _out + start;
+    for (unsigned int i = 0; i < count; ++i)
+      out[i] = toUniform(words[i * 2], words[i * 2 + 1]);
+  }
+}
+
+//////////////////////////////////////////////////
+void RandStream::GetNormal(uint64_t _counter, double *_out,
+                           unsigned int _count, double _mean,
+                           double _sigma) const
+{
+  uint32_t words[RandStreamChunk * 4];
+
+  // Box-Muller, four numbers per block
+  for (unsigned int start = 0; start < _count; start += RandStreamChunk * 4)
+  {
+    unsigned int count = std::min(_count - start, RandStreamChunk * 4);
+    unsigned int blocks = (count + 3) / 4;
+    this->GetBlocks(_counter, start / 4, blocks, words);
+
+    double *out = _out + start;
+    unsigned int i = 0;
+
+#ifdef __SSE2__
+    // Several blocks at once, so that the polynomial chains of the blocks
+    // overlap
+    const __m128d mean = _mm_set1_pd(_mean);
+    const __m128d sigma = _mm_set1_pd(_sigma);
+    for (; (i + NormalBlocks) * 4 <= count; i += NormalBlocks)
+    {
+      __m128d u1[NormalBlocks], turns[NormalBlocks];
+      __m128d r[NormalBlocks], s[NormalBlocks], c[NormalBlocks];
+      for (unsigned int b = 0; b < NormalBlocks; ++b)
+      {
+        wordsToDoubles2(_mm_loadu_si128(
+              reinterpret_cast<const __m128i *>(words + (i + b) * 4)),
+            u1[b], turns[b]);
+        u1[b] = _mm_mul_pd(_mm_add_pd(u1[b], _mm_set1_pd(1.0)),
+                           _mm_set1_pd(WordScale));
+        turns[b] = _mm_mul_pd(turns[b], _mm_set1_pd(WordScale));
+      }
+
+      for (unsigned int b = 0; b < NormalBlocks; ++b)
+      {
+        r[b] = _mm_mul_pd(sigma, _mm_sqrt_pd(
+            _mm_mul_pd(_mm_set1_pd(-2.0), logUnit2(u1[b]))));
+      }
+
+      for (unsigned int b = 0; b < NormalBlocks; ++b)
+        sinCosTurns2(turns[b], s[b], c[b]);
+
+      for (unsigned int b = 0; b < NormalBlocks; ++b)
+      {
+        c[b] = _mm_add_pd(mean, _mm_mul_pd(r[b], c[b]));
+        s[b] = _mm_add_pd(mean, _mm_mul_pd(r[b], s[b]));
+        _mm_storeu_pd(out + (i + b) * 4, _mm_unpacklo_pd(c[b], s[b]));
+        _mm_storeu_pd(out + (i + b) * 4 + 2, _mm_unpackhi_pd(c[b], s[b]));
+      }
+    }
+#endif
+
+    // Two pairs per block
+    for (unsigned int pair = i * 2; pair * 2 < count; ++pair)
+    {
+      // In (0, 1], so the log is finite
+      double u1 = (words[pair * 2] + 1.0) * WordScale;
+      double r = _sigma * sqrt(-2.0 * logUnit(u1));
+      double s, c;
+      sinCosTurns(words[pair * 2 + 1] * WordScale, s, c);
+
+      out[pair * 2] = _mean + r * c;
+      if (pair * 2 + 1 < count)
+        out[pair * 2 + 1] = _mean + r * s;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+double RandStream::GetDblUniform(uint64_t _counter, double _min,
+                                 double _max) const
+{
+  double value;
+  this->GetUniform(_counter, &value, 1);
+  return _min + (_max - _min) * value;
+}
+
+//////////////////////////////////////////////////
+double RandStream::GetDblNormal(uint64_t _counter, double _mean,
+                                double _sigma) const
+{
+  double value;
+  this->GetNormal(_counter, &value, 1, _mean, _sigma);
+  return value;
+}
+
+//////////////////////////////////////////////////
+uint32_t RandStream::Hash(const std::string &_name)
+{
+  uint32_t hash = 2166136261u;
+  for (std::string::const_iterator iter = _name.begin();
+       iter != _name.end(); ++iter)
+  {
+    hash ^= static_cast<unsigned char>(*iter);
+    hash *= 16777619u;
+  }
+  return hash;
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _RANDSTREAM_HH_
+#define _RANDSTREAM_HH_
+
+#include <stdint.h>
+#include <string>
+
+namespace gazebo
+{
+  namespace math
+  {
+    /// \addtogroup gazebo_math
+    /// \{
+
+    /// \class RandStream RandStream.hh math/gzmath.hh
+    /// \brief Counter based random number generator.
+    ///
+    /// Numbers are a function of the seed, the stream and a counter, given
+    /// by the Philox4x32-10 generator of Salmon et al. Unlike Rand, which
+    /// has one generator for the process, a stream has no state: the same
+    /// counter always gives the same numbers, whatever the thread or the
+    /// order of the calls. Each call fills its values from the counter
+    /// alone, so different counters give independent sequences of any
+    /// length.
+    class RandStream
+    {
+      /// \brief Constructor, with a seed and stream of 0.
+      public: RandStream();
+
+      /// \brief Constructor.
+      /// \param[in] _seed Seed, usually Rand::GetSeed.
+      /// \param[in] _stream Number of the stream.
+      public: RandStream(uint32_t _seed, uint32_t _stream);
+
+      /// \brief Constructor, with a stream named after its user.
+      /// \param[in] _seed Seed, usually Rand::GetSeed.
+      /// \param[in] _name Name hashed to get the number of the stream.
+      public: RandStream(uint32_t _seed, const std::string &_name);
+
+      /// \brief Get the seed.
+      /// \return The seed.
+      public: uint32_t GetSeed() const;
+
+      /// \brief Get the number of the stream.
+      /// \return The number of the stream.
+      public: uint32_t GetStream() const;
+
+      /// \brief Get the raw output for a counter.
+      /// \param[in] _counter The counter.
+      /// \param[in] _block Index of the block of 4 words.
+      /// \param[out] _out The 4 words.
+      public: void GetBlock(uint64_t _counter, uint64_t _block,
+                            uint32_t _out[4]) const;
+
+      /// \brief Get numbers from a uniform distribution in [0, 1).
+      /// \param[in] _counter The counter.
+      /// \param[out] _out The numbers.
+      /// \param[in] _count Number of numbers.
+      public: void GetUniform(uint64_t _counter, double *_out,
+                              unsigned int _count) const;
+
+      /// \brief Get numbers from a normal distribution. Each block gives
+      /// four numbers, from uniforms of 32 bits, so values are within
+      /// 6.66 standard deviations of the mean.
+      /// \param[in] _counter The counter.
+      /// \param[out] _out The numbers.
+      /// \param[in] _count Number of numbers.
+      /// \param[in] _mean Mean of the distribution.
+      /// \param[in] _sigma Standard deviation of the distribution.
+      public: void GetNormal(uint64_t _counter, double *_out,
+                             unsigned int _count, double _mean = 0,
+                             double _sigma = 1) const;
+
+      /// \brief Get a number from a uniform distribution.
+      /// \param[in] _counter The counter.
+      /// \param[in] _min Minimum bound for the random number
+      /// \param[in] _max Maximum bound for the random number
+      /// \return The number, the first one GetUniform gives.
+      public: double GetDblUniform(uint64_t _counter, double _min = 0,
+                                   double _max = 1) const;
+
+      /// \brief Get a number from a normal distribution.
+      /// \param[in] _counter The counter.
+      /// \param[in] _mean Mean value for the distribution
+      /// \param[in] _sigma Sigma value for the distribution
+      /// \return The number, the first one GetNormal gives.
+      public: double GetDblNormal(uint64_t _counter, double _mean = 0,
+                                  double _sigma = 1) const;
+
+      /// \brief Hash a name into a stream number, the same on every
+      /// platform.
+      /// \param[in] _name The name.
+      /// \return FNV-1a hash of the name.
+      public: static uint32_t Hash(const std::string &_name);
+
+      /// \brief Fill blocks of 4 words, 4 blocks at a time when SSE2 is
+      /// available.
+      /// \param[in] _counter The counter.
+      /// \param[in] _first Index of the first block.
+      /// \param[in] _count Number of blocks.
+      /// \param[out] _out 4 words per block.
+      private: void GetBlocks(uint64_t _counter, uint64_t _first,
+                              unsigned int _count, uint32_t *_out) const;
+
+      /// \brief Seed, first word of the key.
+      private: uint32_t seed;
+
+      /// \brief Stream, second word of the key.
+      private: uint32_t stream;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include <vector>
+
+#include "gazebo/math/RandStream.hh"
+
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+TEST(RandStreamTest, KnownAnswers)
+{
+  // Test vectors of the Random123 library for Philox4x32-10
+  uint32_t out[4];
+
+  math::RandStream(0, 0).GetBlock(0, 0, out);
+  EXPECT_EQ(out[0], 0x6627e8d5u);
+  EXPECT_EQ(out[1], 0xe169c58du);
+  EXPECT_EQ(out[2], 0xbc57ac4cu);
+  EXPECT_EQ(out[3], 0x9b00dbd8u);
+
+  math::RandStream(0xffffffff, 0xffffffff).GetBlock(
+      0xffffffffffffffffULL, 0xffffffffffffffffULL, out);
+  EXPECT_EQ(out[0], 0x408f276du);
+  EXPECT_EQ(out[1], 0x41c83b0eu);
+  EXPECT_EQ(out[2], 0xa20bc7c6u);
+  EXPECT_EQ(out[3], 0x6d5451fdu);
+
+  math::RandStream(0xa4093822, 0x299f31d0).GetBlock(
+      0x0370734413198a2eULL, 0x85a308d3243f6a88ULL, out);
+  EXPECT_EQ(out[0], 0xd16cfe09u);
+  EXPECT_EQ(out[1], 0x94fdccebu);
+  EXPECT_EQ(out[2], 0x5001e420u);
+  EXPECT_EQ(out[3], 0x24126ea1u);
+}
+
+/////////////////////////////////////////////////
+TEST(RandStreamTest, Reproducible)
+{
+  math::RandStream stream(1001, "model::link::sensor");
+  EXPECT_EQ(stream.GetSeed(), 1001u);
+  EXPECT_EQ(stream.GetStream(), math::RandStream::Hash("model::link::sensor"));
+  EXPECT_NE(stream.GetStream(), math::RandStream::Hash("model::link::other"));
+
+  std::vector<double> a(1001), b(1001);
+
+  // Shorter runs give the start of longer ones, whatever the batching
+  stream.GetNormal(7, &a[0], a.size());
+  stream.GetNormal(7, &b[0], 333);
+  for (unsigned int i = 0; i < 333; ++i)
+    EXPECT_DOUBLE_EQ(a[i], b[i]);
+  EXPECT_DOUBLE_EQ(stream.GetDblNormal(7), a[0]);
+
+  stream.GetUniform(7, &a[0], a.size());
+  stream.GetUniform(7, &b[0], 5);
+  for (unsigned int i = 0; i < 5; ++i)
+    EXPECT_DOUBLE_EQ(a[i], b[i]);
+  EXPECT_DOUBLE_EQ(stream.GetDblUniform(7, 1, 3), 1 + 2 * a[0]);
+
+  // The same stream from another object
+  math::RandStream copy(1001, "model::link::sensor");
+  copy.GetUniform(7, &b[0], b.size());
+  for (unsigned int i = 0; i < b.size(); ++i)
+    EXPECT_DOUBLE_EQ(a[i], b[i]);
+
+  // Other counters, streams and seeds give other numbers
+  copy.GetUniform(8, &b[0], 1);
+  EXPECT_NE(a[0], b[0]);
+  math::RandStream(1001, "other").GetUniform(7, &b[0], 1);
+  EXPECT_NE(a[0], b[0]);
+  math::RandStream(1002, "model::link::sensor").GetUniform(7, &b[0], 1);
+  EXPECT_NE(a[0], b[0]);
+}
+
+/////////////////////////////////////////////////
+TEST(RandStreamTest, Distributions)
+{
+  math::RandStream stream(1, 2);
+  const unsigned int count = 100000;
+  std::vector<double> values(count);
+
+  stream.GetUniform(3, &values[0], count);
+  double sum = 0;
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    EXPECT_GE(values[i], 0.0);
+    EXPECT_LT(values[i], 1.0);
+    sum += values[i];
+  }
+  EXPECT_NEAR(sum / count, 0.5, 0.01);
+
+  stream.GetNormal(3, &values[0], count, 2.0, 0.5);
+  sum = 0;
+  double sumSq = 0;
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    sum += values[i];
+    sumSq += values[i] * values[i];
+  }
+  double mean = sum / count;
+  EXPECT_NEAR(mean, 2.0, 0.01);
+  EXPECT_NEAR(sqrt(sumSq / count - mean * mean), 0.5, 0.01);
+}
+
+/////////////////////////////////////////////////
+TEST(RandStreamTest, Normal)
+{
+  // Compare the polynomial logarithm, sine and cosine to the C library
+  math::RandStream stream(5, 6);
+  const unsigned int count = 1000;
+  std::vector<double> values(count);
+  stream.GetNormal(9, &values[0], count);
+
+  // Each block gives two pairs, one word per uniform
+  for (unsigned int i = 0; i < count / 2; ++i)
+  {
+    uint32_t w[4];
+    stream.GetBlock(9, i / 2, w);
+    double u1 = (w[(i % 2) * 2] + 1.0) / 4294967296.0;
+    double u2 = w[(i % 2) * 2 + 1] / 4294967296.0;
+    double r = sqrt(-2.0 * log(u1));
+
+    EXPECT_NEAR(values[i * 2], r * cos(2.0 * M_PI * u2), 1e-12);
+    EXPECT_NEAR(values[i * 2 + 1], r * sin(2.0 * M_PI * u2), 1e-12);
+  }
+}
@@ -31,61 +31,17 @@ const Vector3 Vector3::UnitX = math::Vector3(1, 0, 0);
 const Vector3 Vector3::UnitY = math::Vector3(0, 1, 0);
 const Vector3 Vector3::UnitZ = math::Vector3(0, 0, 1);
 
-//////////////////////////////////////////////////
-Vector3::Vector3()
-    : x(0.0), y(0.0), z(0.0)
-{
-}
-
-//////////////////////////////////////////////////
-Vector3::Vector3(const double &_x, const double &_y, const double &_z)
-    : x(_x), y(_y), z(_z)
-{
-}
-
-//////////////////////////////////////////////////
-Vector3::Vector3(const Vector3 &_pt)
-    : x(_pt.x), y(_pt.y), z(_pt.z)
-{
-}
-
 //////////////////////////////////////////////////
 Vector3::~Vector3()
 {
 }
 
-//////////////////////////////////////////////////
-double Vector3::Distance(const Vector3 &_pt) const
-{
-  return sqrt((this->x-_pt.x)*(this->x-_pt.x) +
-              (this->y-_pt.y)*(this->y-_pt.y) +
-              (this->z-_pt.z)*(this->z-_pt.z));
-}
-
 //////////////////////////////////////////////////
 double Vector3::Distance(double _x, double _y, double _z) const
 {
   return this->Distance(Vector3(_x, _y, _z));
 }
 
-//////////////////////////////////////////////////
-double Vector3::GetSum() const
-{
-  return this->x + this->y + this->z;
-}
-
-//////////////////////////////////////////////////
-double Vector3::GetLength() const
-{
-  return sqrt(this->x * this->x + this->y * this->y + this->z * this->z);
-}
-
-//////////////////////////////////////////////////
-double Vector3::GetSquaredLength() const
-{
-  return this->x * this->x + this->y * this->y + this->z * this->z;
-}
-
 //////////////////////////////////////////////////
 Vector3 Vector3::Normalize()
 {
@@ -118,24 +74,6 @@ Vector3 Vector3::GetRounded() const
   return result;
 }
 
-//////////////////////////////////////////////////
-Vector3 Vector3::Cross(const Vector3 &_pt) const
-{
-  Vector3 c(0, 0, 0);
-
-  c.x = this->y * _pt.z - this->z * _pt.y;
-  c.y = this->z * _pt.x - this->x * _pt.z;
-  c.z = this->x * _pt.y - this->y * _pt.x;
-
-  return c;
-}
-
-//////////////////////////////////////////////////
-double Vector3::Dot(const Vector3 &_pt) const
-{
-  return this->x * _pt.x + this->y * _pt.y + this->z * _pt.z;
-}
-
 //////////////////////////////////////////////////
 Vector3 Vector3::GetAbs() const
 {
@@ -204,16 +142,6 @@ double Vector3::GetMin() const
   return std::min(std::min(this->x, this->y), this->z);
 }
 
-//////////////////////////////////////////////////
-Vector3 &Vector3::operator =(const Vector3 &_pt)
-{
-  this->x = _pt.x;
-  this->y = _pt.y;
-  this->z = _pt.z;
-
-  return *this;
-}
-
 //////////////////////////////////////////////////
 Vector3 &Vector3::operator =(double value)
 {
@@ -224,32 +152,6 @@ Vector3 &Vector3::operator =(double value)
   return *this;
 }
 
-//////////////////////////////////////////////////
-Vector3 Vector3::operator+(const Vector3 &pt) const
-{
-  return Vector3(this->x + pt.x, this->y + pt.y, this->z + pt.z);
-}
-
-//////////////////////////////////////////////////
-const Vector3 &Vector3::operator+=(const Vector3 &pt)
-{
-  this->x += pt.x;
-  this->y += pt.y;
-  this->z += pt.z;
-
-  return *this;
-}
-
-//////////////////////////////////////////////////
-const Vector3 &Vector3::operator-=(const Vector3 &pt)
-{
-  this->x -= pt.x;
-  this->y -= pt.y;
-  this->z -= pt.z;
-
-  return *this;
-}
-
 //////////////////////////////////////////////////
 const Vector3 Vector3::operator/(const Vector3 &pt) const
 {
@@ -266,54 +168,6 @@ const Vector3 &Vector3::operator/=(const Vector3 &pt)
   return *this;
 }
 
-//////////////////////////////////////////////////
-const Vector3 Vector3::operator/(double v) const
-{
-  return Vector3(this->x / v, this->y / v, this->z / v);
-}
-
-//////////////////////////////////////////////////
-const Vector3 &Vector3::operator/=(double v)
-{
-  this->x /= v;
-  this->y /= v;
-  this->z /= v;
-
-  return *this;
-}
-
-//////////////////////////////////////////////////
-Vector3 Vector3::operator*(const Vector3 &pt) const
-{
-  return Vector3(this->x * pt.x, this->y * pt.y, this->z * pt.z);
-}
-
-//////////////////////////////////////////////////
-const Vector3 &Vector3::operator*=(const Vector3 &pt)
-{
-  this->x *= pt.x;
-  this->y *= pt.y;
-  this->z *= pt.z;
-
-  return *this;
-}
-
-//////////////////////////////////////////////////
-Vector3 Vector3::operator*(double v) const
-{
-  return Vector3(this->x * v, this->y * v, this->z * v);
-}
-
-//////////////////////////////////////////////////
-const Vector3 &Vector3::operator*=(double v)
-{
-  this->x *= v;
-  this->y *= v;
-  this->z *= v;
-
-  return *this;
-}
-
 //////////////////////////////////////////////////
 bool Vector3::operator ==(const Vector3 &_pt) const
 {
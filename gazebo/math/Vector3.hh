@@ -58,29 +58,47 @@ namespace gazebo
       public: static const Vector3 UnitZ;
 
       /// \brief Constructor
-      public: Vector3();
+      public: inline Vector3()
+              : x(0.0), y(0.0), z(0.0)
+              {
+              }
 
       /// \brief Constructor
       /// \param[in] _x value along x
       /// \param[in] _y value along y
       /// \param[in] _z value along z
-      public: Vector3(const double &_x, const double &_y, const double &_z);
+      public: inline Vector3(const double &_x, const double &_y,
+                             const double &_z)
+              : x(_x), y(_y), z(_z)
+              {
+              }
 
       /// \brief Copy constructor
       /// \param[in] _v a vector
-      public: Vector3(const Vector3 &_v);
+      public: inline Vector3(const Vector3 &_v)
+              : x(_v.x), y(_v.y), z(_v.z)
+              {
+              }
 
       /// \brief Destructor
       public: virtual ~Vector3();
 
       /// \brief Return the sum of the values
       /// \return the sum
-      public: double GetSum() const;
+      public: inline double GetSum() const
+              {
+                return this->x + this->y + this->z;
+              }
 
       /// \brief Calc distance to the given point
       /// \param[in] _pt the point
       /// \return the distance
-      public: double Distance(const Vector3 &_pt) const;
+      public: inline double Distance(const Vector3 &_pt) const
+              {
+                return sqrt((this->x-_pt.x)*(this->x-_pt.x) +
+                            (this->y-_pt.y)*(this->y-_pt.y) +
+                            (this->z-_pt.z)*(this->z-_pt.z));
+              }
 
       /// \brief Calc distance to the given point
       /// \param[in] _x value along x
@@ -91,11 +109,19 @@ namespace gazebo
 
       /// \brief Returns the length (magnitude) of the vector
       /// \ return the length
-      public: double GetLength() const;
+      public: inline double GetLength() const
+              {
+                return sqrt(this->x * this->x + this->y * this->y +
+                            this->z * this->z);
+              }
 
       /// \brief Return the square of the length (magnitude) of the vector
       /// \return the squared length
-      public: double GetSquaredLength() const;
+      public: inline double GetSquaredLength() const
+              {
+                return this->x * this->x + this->y * this->y +
+                       this->z * this->z;
+              }
 
       /// \brief Normalize the vector length
       /// \return unit length vector
@@ -122,11 +148,19 @@ namespace gazebo
 
       /// \brief Return the cross product of this vector and pt
       /// \return the product
-      public: Vector3 Cross(const Vector3 &_pt) const;
+      public: inline Vector3 Cross(const Vector3 &_pt) const
+              {
+                return Vector3(this->y * _pt.z - this->z * _pt.y,
+                               this->z * _pt.x - this->x * _pt.z,
+                               this->x * _pt.y - this->y * _pt.x);
+              }
 
       /// \brief Return the dot product of this vector and pt
       /// \return the product
-      public: double Dot(const Vector3 &_pt) const;
+      public: inline double Dot(const Vector3 &_pt) const
+              {
+                return this->x * _pt.x + this->y * _pt.y + this->z * _pt.z;
+              }
 
       /// \brief Get the absolute value of the vector
       /// \return a vector with positive elements
@@ -171,7 +205,13 @@ namespace gazebo
       /// \brief Assignment operator
       /// \param[in] _v a new value
       /// \return this
-      public: Vector3 &operator =(const Vector3 &_v);
+      public: inline Vector3 &operator =(const Vector3 &_v)
+              {
+                this->x = _v.x;
+                this->y = _v.y;
+                this->z = _v.z;
+                return *this;
+              }
 
       /// \brief Assignment operator
       /// \param[in] _value assigned to all elements
@@ -181,11 +221,20 @@ namespace gazebo
       /// \brief Addition operator
       /// \param[in] _v vector to add
       /// \return the sum vector
-      public: Vector3 operator+(const Vector3 &_v) const;
+      public: inline Vector3 operator+(const Vector3 &_v) const
+              {
+                return Vector3(this->x + _v.x, this->y + _v.y, this->z + _v.z);
+              }
 
       /// \brief Addition assignment operator
       /// \param[in] _v vector to add
-      public: const Vector3 &operator+=(const Vector3 &_v);
+      public: inline const Vector3 &operator+=(const Vector3 &_v)
+              {
+                this->x += _v.x;
+                this->y += _v.y;
+                this->z += _v.z;
+                return *this;
+              }
 
       /// \brief Negation operator
       /// \return negative of this vector
@@ -206,7 +255,13 @@ namespace gazebo
 
       /// \brief Subtraction operators
       /// \param[in] _pt subtrahend
-      public: const Vector3 &operator-=(const Vector3 &_pt);
+      public: inline const Vector3 &operator-=(const Vector3 &_pt)
+              {
+                this->x -= _pt.x;
+                this->y -= _pt.y;
+                this->z -= _pt.z;
+                return *this;
+              }
 
       /// \brief Division operator
       /// \brief[in] _pt the vector divisor
@@ -223,23 +278,41 @@ namespace gazebo
       /// \brief Division operator
       /// \remarks this is an element wise division
       /// \return a vector
-      public: const Vector3 operator/(double _v) const;
+      public: inline const Vector3 operator/(double _v) const
+              {
+                return Vector3(this->x / _v, this->y / _v, this->z / _v);
+              }
 
       /// \brief Division operator
       /// \remarks this is an element wise division
       /// \return this
-      public: const Vector3 &operator/=(double _v);
+      public: inline const Vector3 &operator/=(double _v)
+              {
+                this->x /= _v;
+                this->y /= _v;
+                this->z /= _v;
+                return *this;
+              }
 
       /// \brief Multiplication operator
       /// \remarks this is an element wise multiplication, not a cross product
       /// \param[in] _v
-      public: Vector3 operator*(const Vector3 &_p) const;
+      public: inline Vector3 operator*(const Vector3 &_p) const
+              {
+                return Vector3(this->x * _p.x, this->y * _p.y, this->z * _p.z);
+              }
 
       /// \brief Multiplication operators
       /// \remarks this is an element wise multiplication, not a cross product
       /// \param[in] _v a vector
       /// \return this
-      public: const Vector3 &operator*=(const Vector3 &_v);
+      public: inline const Vector3 &operator*=(const Vector3 &_v)
+              {
+                this->x *= _v.x;
+                this->y *= _v.y;
+                this->z *= _v.z;
+                return *this;
+              }
 
       /// \brief Multiplication operators
       /// \param[in] _s the scaling factor
@@ -252,12 +325,21 @@ namespace gazebo
       /// \brief Multiplication operators
       /// \param[in] _v the scaling factor
       /// \return a scaled vector
-      public: Vector3 operator*(double _v) const;
+      public: inline Vector3 operator*(double _v) const
+              {
+                return Vector3(this->x * _v, this->y * _v, this->z * _v);
+              }
 
       /// \brief Multiplication operator
       /// \param[in] _v scaling factor
       /// \return this
-      public: const Vector3 &operator*=(double _v);
+      public: inline const Vector3 &operator*=(double _v)
+              {
+                this->x *= _v;
+                this->y *= _v;
+                this->z *= _v;
+                return *this;
+              }
 
       /// \brief Equal to operator
       /// \param[in] _pt The vector to compare against
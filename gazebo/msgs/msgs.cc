@@ -146,6 +146,30 @@ namespace gazebo
       Set(_p->mutable_orientation(), _v.rot);
     }
 
+    void Add(msgs::CompactPoses *_msg, unsigned int _id,
+             const math::Pose &_v)
+    {
+      double posRes = _msg->position_resolution();
+      double rotRes = _msg->orientation_resolution();
+
+      _msg->add_id(_id);
+      _msg->add_position(static_cast<int64_t>(floor(_v.pos.x / posRes + 0.5)));
+      _msg->add_position(static_cast<int64_t>(floor(_v.pos.y / posRes + 0.5)));
+      _msg->add_position(static_cast<int64_t>(floor(_v.pos.z / posRes + 0.5)));
+
+      // q and -q are the same rotation, so w is sent as a positive value
+      // computed from the other components
+      math::Quaternion rot = _v.rot;
+      rot.Normalize();
+      double sign = rot.w < 0 ? -1.0 : 1.0;
+      _msg->add_orientation(
+          static_cast<int32_t>(floor(sign * rot.x / rotRes + 0.5)));
+      _msg->add_orientation(
+          static_cast<int32_t>(floor(sign * rot.y / rotRes + 0.5)));
+      _msg->add_orientation(
+          static_cast<int32_t>(floor(sign * rot.z / rotRes + 0.5)));
+    }
+
     void Set(msgs::Color *_c, const common::Color &_v)
     {
       _c->set_r(_v.r);
@@ -266,6 +290,26 @@ namespace gazebo
           Convert(_p.orientation()));
     }
 
+    math::Pose Convert(const msgs::CompactPoses &_msg, int _index)
+    {
+      double posRes = _msg.position_resolution();
+      double rotRes = _msg.orientation_resolution();
+
+      math::Pose result;
+      result.pos.Set(_msg.position(_index * 3) * posRes,
+                     _msg.position(_index * 3 + 1) * posRes,
+                     _msg.position(_index * 3 + 2) * posRes);
+
+      double x = _msg.orientation(_index * 3) * rotRes;
+      double y = _msg.orientation(_index * 3 + 1) * rotRes;
+      double z = _msg.orientation(_index * 3 + 2) * rotRes;
+      double w = sqrt(std::max(0.0, 1.0 - x*x - y*y - z*z));
+      result.rot.Set(w, x, y, z);
+      result.rot.Normalize();
+
+      return result;
+    }
+
     common::Color Convert(const msgs::Color &_c)
     {
       return common::Color(_c.r(), _c.g(), _c.b(), _c.a());
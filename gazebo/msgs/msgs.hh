@@ -111,6 +111,12 @@ namespace gazebo
     /// \return A math::Pose object
     math::Pose       Convert(const msgs::Pose &_p);
 
+    /// \brief Get a pose from a msgs::CompactPoses
+    /// \param[in] _msg The message
+    /// \param[in] _index Index of the pose, less than _msg.id_size()
+    /// \return A math::Pose object
+    math::Pose       Convert(const msgs::CompactPoses &_msg, int _index);
+
     /// \brief Convert a msgs::Image to a common::Image
     /// \param[out] _img The common::Image container
     /// \param[in] _msg The Image message to convert
@@ -156,6 +162,14 @@ namespace gazebo
     /// \param[in] _v A math::Pose reference
     void Set(msgs::Pose *_p, const math::Pose &_v);
 
+    /// \brief Add a pose to a msgs::CompactPoses, quantized with the
+    /// resolutions set in the message
+    /// \param[out] _msg A msgs::CompactPoses pointer
+    /// \param[in] _id Id of the entity
+    /// \param[in] _v A math::Pose reference
+    void Add(msgs::CompactPoses *_msg, unsigned int _id,
+             const math::Pose &_v);
+
     /// \brief Set a msgs::Color from a common::Color
     /// \param[out] _p A msgs::Color pointer
     /// \param[in] _v A common::Color reference
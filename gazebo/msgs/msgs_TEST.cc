@@ -819,3 +819,36 @@ TEST(MsgsTest, MeshFromSDF)
   EXPECT_TRUE(msg.has_center_submesh());
   EXPECT_TRUE(msg.center_submesh());
 }
+
+TEST(MsgsTest, CompactPoses)
+{
+  msgs::CompactPoses msg;
+  msg.set_position_resolution(1e-4);
+  msg.set_orientation_resolution(1.0 / 32767);
+
+  math::Pose poses[] =
+  {
+    math::Pose(0, 0, 0, 0, 0, 0),
+    math::Pose(1.23456, -20.5, 0.00004, 0.1, -0.2, 3.1),
+    math::Pose(-1000, 3, 2, 3.14159, 0, 0),
+    math::Pose(5, 5, 5, 0, 1.5707, 0)
+  };
+  unsigned int count = sizeof(poses) / sizeof(poses[0]);
+
+  for (unsigned int i = 0; i < count; ++i)
+    msgs::Add(&msg, 100 + i, poses[i]);
+
+  ASSERT_EQ(static_cast<int>(count), msg.id_size());
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    EXPECT_EQ(100 + i, msg.id(i));
+
+    math::Pose pose = msgs::Convert(msg, i);
+    EXPECT_NEAR(0.0, pose.pos.Distance(poses[i].pos), 1e-4);
+
+    // The same rotation, up to the sign of the quaternion
+    math::Vector3 v(1, 2, 3);
+    EXPECT_NEAR(0.0, pose.rot.RotateVector(v).Distance(
+          poses[i].rot.RotateVector(v)), 1e-3);
+  }
+}
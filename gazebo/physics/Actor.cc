@@ -57,11 +57,20 @@ Actor::Actor(BasePtr _parent)
   this->skeleton = NULL;
   this->pathLength = 0.0;
   this->lastTraj = 1e+5;
+  this->rootHandle = 0;
 }
 
 //////////////////////////////////////////////////
 Actor::~Actor()
 {
+  for (std::map<std::string, CompiledSkeletonAnimation*>::iterator iter =
+       this->compiledAnimations.begin();
+       iter != this->compiledAnimations.end(); ++iter)
+  {
+    delete iter->second;
+  }
+  this->compiledAnimations.clear();
+
   this->skelAnimation.clear();
   this->bonePosePub.reset();
 }
@@ -322,6 +331,7 @@ void Actor::LoadAnimation(sdf::ElementPtr _sdf)
         this->skeleton->GetNodeByHandle(i)->GetName();
     this->skelNodesMap[this->skinFile] = skelMap;
     this->interpolateX[this->skinFile] = false;
+    this->CompileAnimation(this->skinFile);
   }
   else
   {
@@ -383,11 +393,27 @@ void Actor::LoadAnimation(sdf::ElementPtr _sdf)
             skel->GetAnimation(0);
         this->interpolateX[animName] = _sdf->GetValueBool("interpolate_x");
         this->skelNodesMap[animName] = skelMap;
+        this->CompileAnimation(animName);
       }
     }
   }
 }
 
+//////////////////////////////////////////////////
+void Actor::CompileAnimation(const std::string &_type)
+{
+  std::map<std::string, std::string> &skelMap = this->skelNodesMap[_type];
+
+  // The animation node that drives each bone, in bone handle order
+  std::vector<std::string> nodeNames;
+  for (unsigned int i = 0; i < this->skeleton->GetNumNodes(); ++i)
+    nodeNames.push_back(skelMap[this->skeleton->GetNodeByHandle(i)->GetName()]);
+
+  delete this->compiledAnimations[_type];
+  this->compiledAnimations[_type] =
+    new CompiledSkeletonAnimation(*this->skelAnimation[_type], nodeNames);
+}
+
 //////////////////////////////////////////////////
 void Actor::Init()
 {
@@ -395,6 +421,23 @@ void Actor::Init()
   if (this->autoStart)
     this->Play();
   this->mainLink = this->GetChildLink(this->GetName() + "_pose");
+
+  // Resolve the bone hierarchy once, so updates don't look up names
+  this->boneLinks.clear();
+  this->boneParents.clear();
+  if (this->skeleton)
+  {
+    for (unsigned int i = 0; i < this->skeleton->GetNumNodes(); ++i)
+    {
+      SkeletonNode *bone = this->skeleton->GetNodeByHandle(i);
+      this->boneLinks.push_back(this->GetChildLink(bone->GetName()));
+      this->boneParents.push_back(bone->GetParent() ?
+          static_cast<int>(bone->GetParent()->GetHandle()) : -1);
+    }
+    this->rootHandle = this->skeleton->GetRootNode()->GetHandle();
+    this->framePose.resize(this->skeleton->GetNumNodes(),
+                           math::Matrix4::IDENTITY);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -462,11 +505,13 @@ void Actor::Update()
 
   scriptTime = scriptTime - tinfo.startTime;
 
-  SkeletonAnimation *skelAnim = this->skelAnimation[tinfo.type];
-  std::map<std::string, std::string> skelMap = this->skelNodesMap[tinfo.type];
+  std::map<std::string, CompiledSkeletonAnimation*>::iterator animIter =
+    this->compiledAnimations.find(tinfo.type);
+  if (animIter == this->compiledAnimations.end() || this->boneLinks.empty())
+    return;
+  CompiledSkeletonAnimation *skelAnim = animIter->second;
 
   math::Pose modelPose;
-  std::map<std::string, math::Matrix4> frame;
   if (this->trajectories.find(tinfo.id) != this->trajectories.end())
   {
     common::PoseKeyFrame posFrame(0.0);
@@ -485,19 +530,26 @@ void Actor::Update()
     }
     this->lastPos = modelPose.pos;
   }
+
+  // Bones without key frames keep their rest transform
+  for (unsigned int i = 0; i < this->framePose.size(); ++i)
+  {
+    if (!skelAnim->IsAnimated(i))
+      this->framePose[i] = this->skeleton->GetNodeByHandle(i)->GetTransform();
+  }
+
   if (this->interpolateX[tinfo.type] &&
         this->trajectories.find(tinfo.id) != this->trajectories.end())
   {
-    frame = skelAnim->GetPoseAtX(this->pathLength,
-              skelMap[this->skeleton->GetRootNode()->GetName()]);
+    skelAnim->GetPoseAtX(this->pathLength, this->rootHandle, true,
+                         &this->framePose[0]);
   }
   else
-    frame = skelAnim->GetPoseAt(scriptTime);
+    skelAnim->GetPoseAt(scriptTime, true, &this->framePose[0]);
 
   this->lastTraj = tinfo.id;
 
-  math::Matrix4 rootTrans =
-                  frame[skelMap[this->skeleton->GetRootNode()->GetName()]];
+  const math::Matrix4 &rootTrans = this->framePose[this->rootHandle];
 
   math::Vector3 rootPos = rootTrans.GetTranslation();
   math::Quaternion rootRot = rootTrans.GetRotation();
@@ -511,83 +563,91 @@ void Actor::Update()
   math::Matrix4 rootM(actorPose.rot.GetAsMatrix4());
   rootM.SetTranslate(actorPose.pos);
 
-  frame[skelMap[this->skeleton->GetRootNode()->GetName()]] = rootM;
+  this->framePose[this->rootHandle] = rootM;
 
-  this->SetPose(frame, skelMap, currentTime.Double());
+  this->SetPose(this->framePose, currentTime.Double());
 
   this->lastScriptTime = scriptTime;
 }
 
 //////////////////////////////////////////////////
-void Actor::SetPose(std::map<std::string, math::Matrix4> _frame,
-      std::map<std::string, std::string> _skelMap, double _time)
+void Actor::SetPose(const std::vector<math::Matrix4> &_frame, double _time)
 {
+  // The bone pose message is only built when someone listens to it
+  bool publish = this->bonePosePub && this->bonePosePub->HasConnections();
+
   msgs::PoseAnimation msg;
-  msg.set_model_name(this->visualName);
+  if (publish)
+    msg.set_model_name(this->visualName);
 
-  math::Matrix4 modelTrans(math::Matrix4::IDENTITY);
   math::Pose mainLinkPose;
 
-  for (unsigned int i = 0; i < this->skeleton->GetNumNodes(); i++)
+  for (unsigned int i = 0; i < _frame.size(); i++)
   {
-    SkeletonNode *bone = this->skeleton->GetNodeByHandle(i);
-    SkeletonNode *parentBone = bone->GetParent();
-    math::Matrix4 transform(math::Matrix4::IDENTITY);
-    if (_frame.find(_skelMap[bone->GetName()]) != _frame.end())
-      transform = _frame[_skelMap[bone->GetName()]];
-    else
-      transform = bone->GetTransform();
-
-    LinkPtr currentLink = this->GetChildLink(bone->GetName());
+    math::Matrix4 transform = _frame[i];
+    LinkPtr currentLink = this->boneLinks[i];
     math::Pose bonePose = transform.GetAsPose();
 
     if (!bonePose.IsFinite())
     {
-      std::cerr << "ACTOR: " << _time << " " << bone->GetName()
+      std::cerr << "ACTOR: " << _time << " "
+                << this->skeleton->GetNodeByHandle(i)->GetName()
                 << " " << bonePose << "\n";
       bonePose.Correct();
     }
 
-    msgs::Pose *bone_pose = msg.add_pose();
-    bone_pose->set_name(bone->GetName());
-
-    if (!parentBone)
-    {
-      bone_pose->mutable_position()->CopyFrom(msgs::Convert(math::Vector3()));
-      bone_pose->mutable_orientation()->CopyFrom(msgs::Convert(
-                                                    math::Quaternion()));
+    int parentHandle = this->boneParents[i];
+    if (parentHandle < 0)
       mainLinkPose = bonePose;
-    }
     else
     {
-      bone_pose->mutable_position()->CopyFrom(msgs::Convert(bonePose.pos));
-      bone_pose->mutable_orientation()->CopyFrom(msgs::Convert(bonePose.rot));
-      LinkPtr parentLink = this->GetChildLink(parentBone->GetName());
-      math::Pose parentPose = parentLink->GetWorldPose();
+      math::Pose parentPose = this->boneLinks[parentHandle]->GetWorldPose();
       math::Matrix4 parentTrans(parentPose.rot.GetAsMatrix4());
       parentTrans.SetTranslate(parentPose.pos);
       transform = parentTrans * transform;
     }
 
-    msgs::Pose *link_pose = msg.add_pose();
-    link_pose->set_name(currentLink->GetScopedName());
-    math::Pose linkPose = transform.GetAsPose() - mainLinkPose;
-    link_pose->mutable_position()->CopyFrom(msgs::Convert(linkPose.pos));
-    link_pose->mutable_orientation()->CopyFrom(msgs::Convert(linkPose.rot));
+    if (publish)
+    {
+      msgs::Pose *bone_pose = msg.add_pose();
+      bone_pose->set_name(this->skeleton->GetNodeByHandle(i)->GetName());
+      if (parentHandle < 0)
+      {
+        bone_pose->mutable_position()->CopyFrom(
+            msgs::Convert(math::Vector3()));
+        bone_pose->mutable_orientation()->CopyFrom(msgs::Convert(
+                                                      math::Quaternion()));
+      }
+      else
+      {
+        bone_pose->mutable_position()->CopyFrom(msgs::Convert(bonePose.pos));
+        bone_pose->mutable_orientation()->CopyFrom(
+            msgs::Convert(bonePose.rot));
+      }
+
+      msgs::Pose *link_pose = msg.add_pose();
+      link_pose->set_name(currentLink->GetScopedName());
+      math::Pose linkPose = transform.GetAsPose() - mainLinkPose;
+      link_pose->mutable_position()->CopyFrom(msgs::Convert(linkPose.pos));
+      link_pose->mutable_orientation()->CopyFrom(msgs::Convert(linkPose.rot));
+    }
 
     currentLink->SetWorldPose(transform.GetAsPose(), true, false);
   }
 
-  msgs::Time *stamp = msg.add_time();
-  stamp->CopyFrom(msgs::Convert(_time));
+  if (publish)
+  {
+    msgs::Time *stamp = msg.add_time();
+    stamp->CopyFrom(msgs::Convert(_time));
 
-  msgs::Pose *model_pose = msg.add_pose();
-  model_pose->set_name(this->GetScopedName());
-  model_pose->mutable_position()->CopyFrom(msgs::Convert(mainLinkPose.pos));
-  model_pose->mutable_orientation()->CopyFrom(msgs::Convert(mainLinkPose.rot));
+    msgs::Pose *model_pose = msg.add_pose();
+    model_pose->set_name(this->GetScopedName());
+    model_pose->mutable_position()->CopyFrom(msgs::Convert(mainLinkPose.pos));
+    model_pose->mutable_orientation()->CopyFrom(
+        msgs::Convert(mainLinkPose.rot));
 
-  if (this->bonePosePub && this->bonePosePub->HasConnections())
     this->bonePosePub->Publish(msg);
+  }
   this->SetWorldPose(mainLinkPose, true, false);
 }
 
@@ -32,6 +32,7 @@ namespace gazebo
   {
     class Mesh;
     class Color;
+    class CompiledSkeletonAnimation;
   }
 
   namespace physics
@@ -154,12 +155,16 @@ namespace gazebo
       /// \param[in] _sdf SDF element containing the animation script.
       private: void LoadScript(sdf::ElementPtr _sdf);
 
+      /// \brief Compile a loaded skeleton animation, so that its pose is
+      /// evaluated in bone handle order.
+      /// \param[in] _type Name of the animation.
+      private: void CompileAnimation(const std::string &_type);
+
       /// \brief Set the actor's pose.
-      /// \param[in] _frame Each frame name and transform.
-      /// \param[in] _skelMap Map of bone relationships.
+      /// \param[in] _frame Transform of each bone, indexed by bone handle.
       /// \param[in] _time Time over which to animate the set pose.
-      private: void SetPose(std::map<std::string, math::Matrix4> _frame,
-                     std::map<std::string, std::string> _skelMap, double _time);
+      private: void SetPose(const std::vector<math::Matrix4> &_frame,
+                            double _time);
 
       /// \brief Pointer to the actor's mesh.
       protected: const common::Mesh *mesh;
@@ -217,6 +222,24 @@ namespace gazebo
       /// \brief True to interpolate along x direction.
       protected: std::map<std::string, bool> interpolateX;
 
+      /// \brief Compiled skeleton animations, indexed like skelAnimation.
+      /// Slot i of their poses is the bone with handle i.
+      protected: std::map<std::string, common::CompiledSkeletonAnimation*>
+                                                        compiledAnimations;
+
+      /// \brief Pose evaluated in place every frame, one transform per
+      /// bone handle.
+      protected: std::vector<math::Matrix4> framePose;
+
+      /// \brief Link of each bone, indexed by bone handle.
+      protected: std::vector<LinkPtr> boneLinks;
+
+      /// \brief Handle of the parent of each bone, -1 for the root.
+      protected: std::vector<int> boneParents;
+
+      /// \brief Handle of the root bone.
+      protected: unsigned int rootHandle;
+
       /// \brief Last position of the actor
       protected: math::Vector3 lastPos;
 
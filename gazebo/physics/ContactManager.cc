@@ -67,7 +67,7 @@ Contact *ContactManager::NewContact(Collision *_collision1,
   // If no one is listening, then don't create any contact information.
   // This is a signal to the Physics engine that it can skip the extra
   // processing necessary to get back contact information.
-  if (!this->contactPub->HasConnections())
+  if (!this->HasListeners())
     return result;
 
   // Get or create a contact feedback object.
@@ -91,6 +91,12 @@ Contact *ContactManager::NewContact(Collision *_collision1,
   return result;
 }
 
+/////////////////////////////////////////////////
+bool ContactManager::HasListeners() const
+{
+  return this->contactPub && this->contactPub->HasConnections();
+}
+
 /////////////////////////////////////////////////
 unsigned int ContactManager::GetContactCount() const
 {
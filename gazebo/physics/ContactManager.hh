@@ -66,6 +66,12 @@ namespace gazebo
                                   Collision *_collision2,
                                   const common::Time &_time);
 
+      /// \brief Get whether anyone subscribes to the contacts. NewContact
+      /// returns NULL when no one does, so a physics engine can check this
+      /// once per step instead of for every pair of collisions.
+      /// \return True if the contacts are published to a subscriber.
+      public: bool HasListeners() const;
+
       /// \brief Return the number of valid contacts.
       public: unsigned int GetContactCount() const;
 
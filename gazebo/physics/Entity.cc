@@ -39,6 +39,7 @@
 #include "gazebo/physics/Link.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/SpatialIndex.hh"
 #include "gazebo/physics/Entity.hh"
 
 using namespace gazebo;
@@ -406,6 +407,16 @@ void Entity::SetWorldPose(const math::Pose &_pose, bool _notify, bool _publish)
     boost::mutex::scoped_lock lock(*this->GetWorld()->GetSetWorldPoseMutex());
     (*this.*setWorldPoseFunc)(_pose, _notify, _publish);
   }
+
+  // Moving links are indexed again periodically, static ones only when
+  // told to
+  if (this->IsStatic() && this->world)
+  {
+    SpatialIndexPtr index = this->world->GetSpatialIndex();
+    if (index)
+      index->StaticMoved();
+  }
+
   if (_publish)
     this->PublishPose();
 }
@@ -547,6 +558,9 @@ void Entity::UpdateParameters(sdf::ElementPtr _sdf)
 //////////////////////////////////////////////////
 void Entity::UpdateAnimation(const common::UpdateInfo &_info)
 {
+  if (_info.worldName != this->world->GetName())
+    return;
+
   common::PoseKeyFrame kf(0);
 
   this->animation->AddTime((_info.simTime - this->prevAnimationTime).Double());
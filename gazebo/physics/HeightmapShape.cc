@@ -22,26 +22,58 @@
 #include <string.h>
 #include <math.h>
 
+#include <set>
+
 #include "common/Image.hh"
 #include "common/Common.hh"
+#include "common/Events.hh"
 #include "common/Exception.hh"
 
+#include "physics/World.hh"
+#include "physics/Model.hh"
+#include "physics/Link.hh"
+#include "physics/Collision.hh"
 #include "physics/HeightmapShape.hh"
 
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Number of tiles kept for GetHeight outside of the loaded tiles.
+static const unsigned int g_maxSampledTiles = 4;
+
 
 //////////////////////////////////////////////////
 HeightmapShape::HeightmapShape(CollisionPtr _parent)
     : Shape(_parent)
 {
   this->AddType(Base::HEIGHTMAP_SHAPE);
+  this->useElevation = false;
+  this->tileSize = 0;
+  this->tileCount = 0;
+  this->tileRadius = 0;
 }
 
 //////////////////////////////////////////////////
 HeightmapShape::~HeightmapShape()
 {
+  if (this->updateConnection)
+    event::Events::DisconnectWorldUpdateBegin(this->updateConnection);
+
+  // Physics engines release the collision data of their tiles in their own
+  // destructors, so only the memory is freed here.
+  for (std::map<unsigned int, HeightmapTile*>::iterator iter =
+       this->tiles.begin(); iter != this->tiles.end(); ++iter)
+  {
+    delete iter->second;
+  }
+  this->tiles.clear();
+
+  for (std::list<HeightmapTile*>::iterator iter = this->sampledTiles.begin();
+       iter != this->sampledTiles.end(); ++iter)
+  {
+    delete *iter;
+  }
+  this->sampledTiles.clear();
 }
 
 //////////////////////////////////////////////////
@@ -56,6 +88,32 @@ void HeightmapShape::Load(sdf::ElementPtr _sdf)
             this->sdf->GetValueString("uri") + "]\n");
   }
 
+  this->tileSize = this->sdf->GetValueUInt("tile_size");
+  this->tileRadius = this->sdf->GetValueDouble("tile_radius");
+
+  // Raw elevation files and tiled heightmaps are read through the
+  // elevation data, which doesn't load raw files into memory.
+  this->useElevation = this->tileSize > 0 ||
+    common::ElevationData::IsRawFile(filename);
+
+  if (this->useElevation)
+  {
+    if (!this->elevation.Load(filename))
+      gzthrow("Unable to load heightmap[" + filename + "]\n");
+
+    if (!math::isPowerOfTwo(this->elevation.GetSize()-1))
+      gzthrow("Heightmap size must be square, with a size of 2^n+1\n");
+
+    if (this->tileSize > 0 && (!math::isPowerOfTwo(this->tileSize-1) ||
+          this->tileSize > this->elevation.GetSize()))
+    {
+      gzthrow("Heightmap tile size must be 2^n+1, and not larger than "
+              "the heightmap\n");
+    }
+
+    return;
+  }
+
   // Use the image to get the size of the heightmap
   this->img.Load(filename);
 
@@ -79,6 +137,38 @@ void HeightmapShape::Init()
 
   math::Vector3 terrainSize = this->GetSize();
 
+  if (this->useElevation)
+  {
+    this->vertSize = this->elevation.GetSize();
+    this->scale.x = terrainSize.x / this->vertSize;
+    this->scale.y = terrainSize.y / this->vertSize;
+
+    // Metric elevation data is used as is. Other data is normalized, and
+    // scaled so that the highest sample is at the height of the terrain.
+    if (this->elevation.HasMetricValues())
+      this->scale.z = 1.0;
+    else if (math::equal(this->elevation.GetMaxValue(), 0.0f))
+      this->scale.z = fabs(terrainSize.z);
+    else
+      this->scale.z = fabs(terrainSize.z) / this->elevation.GetMaxValue();
+
+    if (this->tileSize == 0)
+    {
+      this->FillHeightMapFromElevation();
+      return;
+    }
+
+    // Tiles are loaded as links move around, in the physics thread.
+    this->tileCount = (this->vertSize - 1) / (this->tileSize - 1);
+    this->lastTileUpdate = common::Time();
+    if (!this->updateConnection)
+    {
+      this->updateConnection = event::Events::ConnectWorldUpdateBegin(
+          boost::bind(&HeightmapShape::OnWorldUpdate, this, _1));
+    }
+    return;
+  }
+
   // sampling size along image width and height
   this->vertSize = this->img.GetWidth() * this->subSampling;
   this->scale.x = terrainSize.x / this->vertSize;
@@ -165,6 +255,213 @@ void HeightmapShape::FillHeightMap()
   delete [] data;
 }
 
+//////////////////////////////////////////////////
+float HeightmapShape::GetScaledHeight(float _value) const
+{
+  float h = _value * this->scale.z;
+
+  // invert pixel definition so 1=ground, 0=full height,
+  //   if the terrain size has a negative z component
+  //   this is mainly for backward compatibility
+  if (!this->elevation.HasMetricValues() && this->GetSize().z < 0)
+    h = 1.0 - h;
+
+  return h;
+}
+
+//////////////////////////////////////////////////
+void HeightmapShape::FillHeightMapFromElevation()
+{
+  this->heights.resize(this->vertSize * this->vertSize);
+
+  if (!this->elevation.GetValues(0, 0, this->vertSize, this->vertSize,
+                                 &this->heights[0]))
+  {
+    gzthrow("Unable to read heightmap[" + this->GetURI() + "]\n");
+  }
+
+  for (unsigned int i = 0; i < this->heights.size(); ++i)
+    this->heights[i] = this->GetScaledHeight(this->heights[i]);
+}
+
+//////////////////////////////////////////////////
+bool HeightmapShape::IsTiled() const
+{
+  return this->tileSize > 0;
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapShape::GetTileSize() const
+{
+  return this->tileSize;
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapShape::GetLoadedTileCount() const
+{
+  return this->tiles.size();
+}
+
+//////////////////////////////////////////////////
+HeightmapTile *HeightmapShape::LoadTile(unsigned int _x, unsigned int _y)
+{
+  HeightmapTile *tile = new HeightmapTile;
+  tile->x = _x;
+  tile->y = _y;
+  tile->heights.resize(this->tileSize * this->tileSize);
+
+  // Neighboring tiles share a row or column of samples
+  if (!this->elevation.GetValues(_x * (this->tileSize - 1),
+        _y * (this->tileSize - 1), this->tileSize, this->tileSize,
+        &tile->heights[0]))
+  {
+    gzerr << "Unable to read heightmap tile[" << _x << " " << _y << "]\n";
+    delete tile;
+    return NULL;
+  }
+
+  tile->minHeight = GZ_FLT_MAX;
+  tile->maxHeight = -GZ_FLT_MAX;
+  for (unsigned int i = 0; i < tile->heights.size(); ++i)
+  {
+    tile->heights[i] = this->GetScaledHeight(tile->heights[i]);
+    tile->minHeight = std::min(tile->minHeight, tile->heights[i]);
+    tile->maxHeight = std::max(tile->maxHeight, tile->heights[i]);
+  }
+
+  // Columns go along +x, and rows go along -y, starting from the corner
+  // of the heightmap.
+  math::Vector3 size = this->GetSize();
+  double tileWidth = size.x / this->tileCount;
+  double tileDepth = size.y / this->tileCount;
+  tile->center.Set(-size.x * 0.5 + (_x + 0.5) * tileWidth,
+                   size.y * 0.5 - (_y + 0.5) * tileDepth, 0);
+
+  return tile;
+}
+
+//////////////////////////////////////////////////
+void HeightmapShape::UpdateTiles(const std::vector<math::Vector3> &_points)
+{
+  if (this->tileSize == 0)
+    return;
+
+  math::Vector3 size = this->GetSize();
+  math::Vector3 origin = this->collisionParent->GetWorldPose().pos +
+    this->GetPos();
+  double tileWidth = size.x / this->tileCount;
+  double tileDepth = size.y / this->tileCount;
+
+  // Tiles within the radius are loaded. Loaded tiles are kept until they
+  // are further than twice the radius, so that a link moving along the
+  // edge of the radius doesn't load and unload the same tile over and
+  // over.
+  std::set<unsigned int> needed, keep;
+  for (std::vector<math::Vector3>::const_iterator iter = _points.begin();
+       iter != _points.end(); ++iter)
+  {
+    double px = iter->x - origin.x + size.x * 0.5;
+    double py = size.y * 0.5 - (iter->y - origin.y);
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+      double radius = this->tileRadius * (pass + 1);
+      int x0 = static_cast<int>(floor((px - radius) / tileWidth));
+      int x1 = static_cast<int>(floor((px + radius) / tileWidth));
+      int y0 = static_cast<int>(floor((py - radius) / tileDepth));
+      int y1 = static_cast<int>(floor((py + radius) / tileDepth));
+
+      x0 = std::max(x0, 0);
+      y0 = std::max(y0, 0);
+      x1 = std::min(x1, static_cast<int>(this->tileCount) - 1);
+      y1 = std::min(y1, static_cast<int>(this->tileCount) - 1);
+
+      for (int y = y0; y <= y1; ++y)
+      {
+        for (int x = x0; x <= x1; ++x)
+        {
+          if (pass == 0)
+            needed.insert(y * this->tileCount + x);
+          else
+            keep.insert(y * this->tileCount + x);
+        }
+      }
+    }
+  }
+
+  // Unload the tiles that are far from every point
+  std::map<unsigned int, HeightmapTile*>::iterator iter;
+  for (iter = this->tiles.begin(); iter != this->tiles.end();)
+  {
+    if (keep.find(iter->first) == keep.end())
+    {
+      this->OnTileUnloaded(iter->second);
+      delete iter->second;
+      this->tiles.erase(iter++);
+    }
+    else
+      ++iter;
+  }
+
+  // Load the missing tiles
+  for (std::set<unsigned int>::iterator nIter = needed.begin();
+       nIter != needed.end(); ++nIter)
+  {
+    if (this->tiles.find(*nIter) != this->tiles.end())
+      continue;
+
+    HeightmapTile *tile = this->LoadTile(*nIter % this->tileCount,
+                                         *nIter / this->tileCount);
+    if (tile)
+    {
+      this->tiles[*nIter] = tile;
+      this->OnTileLoaded(tile);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void HeightmapShape::OnWorldUpdate(const common::UpdateInfo &_info)
+{
+  if (_info.worldName != this->GetWorld()->GetName())
+    return;
+
+  // Links can't move far in a tenth of a second, so there's no need to
+  // check every step.
+  if (!this->tiles.empty() &&
+      _info.simTime - this->lastTileUpdate < common::Time(0.1))
+    return;
+  this->lastTileUpdate = _info.simTime;
+
+  std::vector<math::Vector3> points;
+  Model_V models = this->GetWorld()->GetModels();
+  for (Model_V::iterator mIter = models.begin(); mIter != models.end();
+       ++mIter)
+  {
+    if ((*mIter)->IsStatic())
+      continue;
+
+    Link_V links = (*mIter)->GetLinks();
+    for (Link_V::iterator lIter = links.begin(); lIter != links.end();
+         ++lIter)
+    {
+      points.push_back((*lIter)->GetWorldPose().pos);
+    }
+  }
+
+  this->UpdateTiles(points);
+}
+
+//////////////////////////////////////////////////
+void HeightmapShape::OnTileLoaded(HeightmapTile * /*_tile*/)
+{
+}
+
+//////////////////////////////////////////////////
+void HeightmapShape::OnTileUnloaded(HeightmapTile * /*_tile*/)
+{
+}
+
 //////////////////////////////////////////////////
 std::string HeightmapShape::GetURI() const
 {
@@ -208,6 +505,55 @@ math::Vector2i HeightmapShape::GetVertexCount() const
 /////////////////////////////////////////////////
 float HeightmapShape::GetHeight(int _x, int _y)
 {
+  if (this->tileSize > 0)
+  {
+    // Read from a loaded tile if possible, and from the elevation data
+    // otherwise.
+    unsigned int tileX = std::min(_x / (this->tileSize - 1),
+                                  this->tileCount - 1);
+    unsigned int tileY = std::min(_y / (this->tileSize - 1),
+                                  this->tileCount - 1);
+    unsigned int index = (_y - tileY * (this->tileSize - 1)) *
+      this->tileSize + (_x - tileX * (this->tileSize - 1));
+
+    std::map<unsigned int, HeightmapTile*>::const_iterator iter =
+      this->tiles.find(tileY * this->tileCount + tileX);
+    if (iter != this->tiles.end())
+      return iter->second->heights[index];
+
+    // Reading samples one by one from a raw file is slow, and callers
+    // usually sample nearby points, so the last tiles read are kept.
+    boost::mutex::scoped_lock lock(this->sampleMutex);
+    std::list<HeightmapTile*>::iterator sIter;
+    for (sIter = this->sampledTiles.begin();
+         sIter != this->sampledTiles.end(); ++sIter)
+    {
+      if ((*sIter)->x == tileX && (*sIter)->y == tileY)
+        break;
+    }
+
+    if (sIter != this->sampledTiles.end())
+    {
+      this->sampledTiles.splice(this->sampledTiles.begin(),
+                                this->sampledTiles, sIter);
+    }
+    else
+    {
+      HeightmapTile *tile = this->LoadTile(tileX, tileY);
+      if (!tile)
+        return 0;
+
+      this->sampledTiles.push_front(tile);
+      if (this->sampledTiles.size() > g_maxSampledTiles)
+      {
+        delete this->sampledTiles.back();
+        this->sampledTiles.pop_back();
+      }
+    }
+
+    return this->sampledTiles.front()->heights[index];
+  }
+
   return this->heights[(_y * this->subSampling) * this->vertSize +
                        (_x * this->subSampling)];
 }
@@ -215,6 +561,12 @@ float HeightmapShape::GetHeight(int _x, int _y)
 /////////////////////////////////////////////////
 float HeightmapShape::GetMaxHeight() const
 {
+  if (this->tileSize > 0)
+  {
+    return std::max(this->GetScaledHeight(this->elevation.GetMinValue()),
+                    this->GetScaledHeight(this->elevation.GetMaxValue()));
+  }
+
   float max = GZ_FLT_MIN;
   for (unsigned int i = 0; i < this->heights.size(); ++i)
   {
@@ -228,6 +580,12 @@ float HeightmapShape::GetMaxHeight() const
 /////////////////////////////////////////////////
 float HeightmapShape::GetMinHeight() const
 {
+  if (this->tileSize > 0)
+  {
+    return std::min(this->GetScaledHeight(this->elevation.GetMinValue()),
+                    this->GetScaledHeight(this->elevation.GetMaxValue()));
+  }
+
   float min = GZ_FLT_MAX;
   for (unsigned int i = 0; i < this->heights.size(); ++i)
   {
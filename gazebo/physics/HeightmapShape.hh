@@ -22,10 +22,17 @@
 #ifndef _HEIGHTMAPSHAPE_HH_
 #define _HEIGHTMAPSHAPE_HH_
 
+#include <list>
+#include <map>
 #include <string>
 #include <vector>
+#include <boost/thread/mutex.hpp>
 
+#include "gazebo/common/ElevationData.hh"
+#include "gazebo/common/Event.hh"
 #include "gazebo/common/Image.hh"
+#include "gazebo/common/Time.hh"
+#include "gazebo/common/UpdateInfo.hh"
 #include "gazebo/math/Vector3.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/Shape.hh"
@@ -37,10 +44,40 @@ namespace gazebo
     /// \addtogroup gazebo_physics
     /// \{
 
+    /// \class HeightmapTile HeightmapShape.hh physics/physics.hh
+    /// \brief A square block of heights that is part of a tiled
+    /// heightmap. Neighboring tiles share their border samples.
+    class HeightmapTile
+    {
+      /// \brief Column of the tile.
+      public: unsigned int x;
+
+      /// \brief Row of the tile.
+      public: unsigned int y;
+
+      /// \brief Heights of the tile, in row major order.
+      public: std::vector<float> heights;
+
+      /// \brief Center of the tile, relative to the heightmap origin.
+      public: math::Vector3 center;
+
+      /// \brief Smallest height in the tile.
+      public: float minHeight;
+
+      /// \brief Largest height in the tile.
+      public: float maxHeight;
+    };
+
     /// \class HeightmapShape HeightmapShape.hh physics/physics.hh
     /// \brief HeightmapShape collision shape builds a heightmap from
-    /// an image.  The supplied image must be square with
-    /// N*N+1 pixels per side, where N is an integer.
+    /// an image or a raw elevation file. The heightmap must be square with
+    /// 2^N+1 samples per side, where N is an integer.
+    ///
+    /// A heightmap with a tile size is split into tiles of
+    /// tile_size * tile_size samples. Only the tiles that are within
+    /// tile_radius of a link of a non-static model are kept in memory, so
+    /// memory use depends on the active region instead of the size of the
+    /// map.
     class HeightmapShape : public Shape
     {
       /// \brief Constructor.
@@ -101,12 +138,69 @@ namespace gazebo
       /// \return Amount of subsampling.
       public: int GetSubSampling() const;
 
+      /// \brief Return true if the heightmap is split into tiles.
+      /// \return True if a tile size was set.
+      public: bool IsTiled() const;
+
+      /// \brief Get the number of samples along a side of a tile.
+      /// \return Tile size, 0 if the heightmap is not tiled.
+      public: unsigned int GetTileSize() const;
+
+      /// \brief Get the number of tiles that are in memory.
+      /// \return Number of loaded tiles.
+      public: unsigned int GetLoadedTileCount() const;
+
+      /// \brief Load the tiles that are within tile_radius of a point,
+      /// and unload tiles that are far from every point. This is called
+      /// periodically with the positions of the links of all non-static
+      /// models.
+      /// \param[in] _points Positions in the world frame.
+      public: void UpdateTiles(const std::vector<math::Vector3> &_points);
+
+      /// \brief Called after a tile has been loaded. Physics engines
+      /// create the collision data of the tile here.
+      /// \param[in] _tile The tile that was loaded.
+      protected: virtual void OnTileLoaded(HeightmapTile *_tile);
+
+      /// \brief Called before a tile is unloaded.
+      /// \param[in] _tile The tile that will be unloaded.
+      protected: virtual void OnTileUnloaded(HeightmapTile *_tile);
+
       /// \brief Create a lookup table of the terrain's height.
       private: void FillHeightMap();
 
-      /// \brief Lookup table of heights.
+      /// \brief Create a lookup table of the terrain's height from
+      /// elevation data.
+      private: void FillHeightMapFromElevation();
+
+      /// \brief Convert an elevation sample to a height.
+      /// \param[in] _value The sample.
+      /// \return The height in meters.
+      private: float GetScaledHeight(float _value) const;
+
+      /// \brief Load a tile.
+      /// \param[in] _x Column of the tile.
+      /// \param[in] _y Row of the tile.
+      /// \return The new tile, or NULL if it could not be read.
+      private: HeightmapTile *LoadTile(unsigned int _x, unsigned int _y);
+
+      /// \brief Update the tiles around moving links.
+      /// \param[in] _info World update information.
+      private: void OnWorldUpdate(const common::UpdateInfo &_info);
+
+      /// \brief Lookup table of heights. Empty if the heightmap is tiled.
       protected: std::vector<float> heights;
 
+      /// \brief Tiles that are in memory, indexed by y * tileCount + x.
+      protected: std::map<unsigned int, HeightmapTile*> tiles;
+
+      /// \brief Tiles read by GetHeight outside of the loaded tiles, most
+      /// recently used first.
+      private: std::list<HeightmapTile*> sampledTiles;
+
+      /// \brief Protects the sampled tiles.
+      private: boost::mutex sampleMutex;
+
       /// \brief Image used to generate the heights.
       protected: common::Image img;
 
@@ -118,6 +212,30 @@ namespace gazebo
 
       /// \brief Level of subsampling.
       protected: int subSampling;
+
+      /// \brief Elevation data, used for raw elevation files and tiled
+      /// heightmaps.
+      private: common::ElevationData elevation;
+
+      /// \brief True if the heights come from the elevation data instead
+      /// of the image.
+      private: bool useElevation;
+
+      /// \brief Number of samples along a side of a tile, 0 if the
+      /// heightmap is not tiled.
+      private: unsigned int tileSize;
+
+      /// \brief Number of tiles along a side of the heightmap.
+      private: unsigned int tileCount;
+
+      /// \brief Tiles within this distance of a moving link are loaded.
+      private: double tileRadius;
+
+      /// \brief Sim time of the last tile update.
+      private: common::Time lastTileUpdate;
+
+      /// \brief Connection to the world update event.
+      private: event::ConnectionPtr updateConnection;
     };
     /// \}
   }
@@ -15,6 +15,8 @@
  *
 */
 
+#include <algorithm>
+
 #include "transport/Node.hh"
 #include "transport/Subscriber.hh"
 #include "physics/Model.hh"
@@ -29,7 +31,7 @@ using namespace physics;
 
 /////////////////////////////////////////////////
 JointController::JointController(ModelPtr _model)
-  : model(_model)
+  : model(_model), activeJointsDirty(false)
 {
   this->node = transport::NodePtr(new transport::Node());
   this->node->Init(this->model->GetWorld()->GetName());
@@ -42,21 +44,193 @@ JointController::JointController(ModelPtr _model)
 /////////////////////////////////////////////////
 void JointController::AddJoint(JointPtr _joint)
 {
-  this->joints[_joint->GetScopedName()] = _joint;
-  this->posPids[_joint->GetScopedName()].Init(1, 0.1, 0.01, 1, -1);
-  this->velPids[_joint->GetScopedName()].Init(1, 0.1, 0.01, 1, -1);
+  boost::mutex::scoped_lock lock(this->mutex);
+
+  unsigned int index;
+  std::map<std::string, unsigned int>::iterator iter =
+    this->jointIndices.find(_joint->GetScopedName());
+
+  if (iter != this->jointIndices.end())
+  {
+    index = iter->second;
+    this->joints[index] = _joint;
+  }
+  else
+  {
+    index = this->joints.size();
+    this->jointIndices[_joint->GetScopedName()] = index;
+    this->joints.push_back(_joint);
+    this->posPids.push_back(common::PID());
+    this->velPids.push_back(common::PID());
+    this->forces.push_back(0);
+    this->positions.push_back(0);
+    this->velocities.push_back(0);
+    this->commandFlags.push_back(0);
+  }
+
+  this->posPids[index].Init(1, 0.1, 0.01, 1, -1);
+  this->velPids[index].Init(1, 0.1, 0.01, 1, -1);
 }
 
 /////////////////////////////////////////////////
 void JointController::Reset()
 {
+  boost::mutex::scoped_lock lock(this->mutex);
+
   // Reset setpoints and feed-forward.
-  this->positions.clear();
-  this->velocities.clear();
-  this->forces.clear();
+  std::fill(this->commandFlags.begin(), this->commandFlags.end(), 0);
+  this->activeJoints.clear();
+  this->activeJointsDirty = false;
   // Should the PID's be reset as well?
 }
 
+/////////////////////////////////////////////////
+void JointController::Snapshot(common::SnapshotBuffer &_buffer)
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+
+  uint32_t count = this->joints.size();
+  _buffer.Write(count);
+  _buffer.Write(this->prevUpdateTime);
+  if (count == 0)
+    return;
+
+  _buffer.WriteBytes(&this->forces[0], count * sizeof(double));
+  _buffer.WriteBytes(&this->positions[0], count * sizeof(double));
+  _buffer.WriteBytes(&this->velocities[0], count * sizeof(double));
+  _buffer.WriteBytes(&this->commandFlags[0], count);
+
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    this->posPids[i].Snapshot(_buffer);
+    this->velPids[i].Snapshot(_buffer);
+  }
+}
+
+/////////////////////////////////////////////////
+bool JointController::Restore(common::SnapshotBuffer &_buffer)
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+
+  uint32_t count = 0;
+  if (!_buffer.Read(count) || count != this->joints.size() ||
+      !_buffer.Read(this->prevUpdateTime))
+  {
+    return false;
+  }
+
+  if (count == 0)
+    return true;
+
+  if (!_buffer.ReadBytes(&this->forces[0], count * sizeof(double)) ||
+      !_buffer.ReadBytes(&this->positions[0], count * sizeof(double)) ||
+      !_buffer.ReadBytes(&this->velocities[0], count * sizeof(double)) ||
+      !_buffer.ReadBytes(&this->commandFlags[0], count))
+  {
+    return false;
+  }
+
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    if (!this->posPids[i].Restore(_buffer) ||
+        !this->velPids[i].Restore(_buffer))
+    {
+      return false;
+    }
+  }
+
+  this->activeJointsDirty = true;
+  return true;
+}
+
+/////////////////////////////////////////////////
+int JointController::GetJointIndex(const std::string &_name) const
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+  std::map<std::string, unsigned int>::const_iterator iter =
+    this->jointIndices.find(_name);
+  if (iter == this->jointIndices.end())
+    return -1;
+  return iter->second;
+}
+
+/////////////////////////////////////////////////
+unsigned int JointController::GetJointCount() const
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+  return this->joints.size();
+}
+
+/////////////////////////////////////////////////
+JointPtr JointController::GetJoint(unsigned int _index) const
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+  if (_index >= this->joints.size())
+    return JointPtr();
+  return this->joints[_index];
+}
+
+/////////////////////////////////////////////////
+void JointController::SetCommandFlags(unsigned int _index,
+                                      unsigned char _flags)
+{
+  if ((this->commandFlags[_index] == 0) != (_flags == 0))
+    this->activeJointsDirty = true;
+  this->commandFlags[_index] = _flags;
+}
+
+/////////////////////////////////////////////////
+void JointController::SetForce(unsigned int _index, double _force)
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+  if (_index >= this->joints.size())
+  {
+    gzerr << "Invalid joint index[" << _index << "]\n";
+    return;
+  }
+
+  this->forces[_index] = _force;
+  this->SetCommandFlags(_index, this->commandFlags[_index] | COMMAND_FORCE);
+}
+
+/////////////////////////////////////////////////
+void JointController::SetPositionTarget(unsigned int _index, double _target)
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+  if (_index >= this->joints.size())
+  {
+    gzerr << "Invalid joint index[" << _index << "]\n";
+    return;
+  }
+
+  this->positions[_index] = _target;
+  this->SetCommandFlags(_index,
+      this->commandFlags[_index] | COMMAND_POSITION);
+}
+
+/////////////////////////////////////////////////
+void JointController::SetVelocityTarget(unsigned int _index, double _target)
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+  if (_index >= this->joints.size())
+  {
+    gzerr << "Invalid joint index[" << _index << "]\n";
+    return;
+  }
+
+  this->velocities[_index] = _target;
+  this->SetCommandFlags(_index,
+      this->commandFlags[_index] | COMMAND_VELOCITY);
+}
+
+/////////////////////////////////////////////////
+void JointController::ClearCommands(unsigned int _index)
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+  if (_index < this->joints.size())
+    this->SetCommandFlags(_index, 0);
+}
+
 /////////////////////////////////////////////////
 void JointController::Update()
 {
@@ -70,41 +244,44 @@ void JointController::Update()
   // TODO: fix this when World::ResetTime is improved
   if (stepTime > 0)
   {
-    if (this->forces.size() > 0)
-    {
-      std::map<std::string, double>::iterator iter;
-      for (iter = this->forces.begin(); iter != this->forces.end(); ++iter)
-        this->joints[iter->first]->SetForce(0, iter->second);
-    }
+    boost::mutex::scoped_lock lock(this->mutex);
 
-    if (this->positions.size() > 0)
+    if (this->activeJointsDirty)
     {
-      double cmd;
-      std::map<std::string, double>::iterator iter;
-
-      for (iter = this->positions.begin(); iter != this->positions.end();
-           ++iter)
+      this->activeJoints.clear();
+      for (unsigned int i = 0; i < this->commandFlags.size(); ++i)
       {
-        cmd = this->posPids[iter->first].Update(
-            this->joints[iter->first]->GetAngle(0).Radian() - iter->second,
-            stepTime);
-        this->joints[iter->first]->SetForce(0, cmd);
+        if (this->commandFlags[i])
+          this->activeJoints.push_back(i);
       }
+      this->activeJointsDirty = false;
     }
 
-    if (this->velocities.size() > 0)
+    // Sum the commands of each joint, then apply them at once
+    for (std::vector<unsigned int>::const_iterator iter =
+         this->activeJoints.begin(); iter != this->activeJoints.end(); ++iter)
     {
-      double cmd;
-      std::map<std::string, double>::iterator iter;
+      unsigned int i = *iter;
+      unsigned char flags = this->commandFlags[i];
+      const JointPtr &joint = this->joints[i];
+      double cmd = 0;
+
+      if (flags & COMMAND_FORCE)
+        cmd += this->forces[i];
 
-      for (iter = this->velocities.begin();
-           iter != this->velocities.end(); ++iter)
+      if (flags & COMMAND_POSITION)
       {
-        cmd = this->velPids[iter->first].Update(
-            this->joints[iter->first]->GetVelocity(0) - iter->second,
-            stepTime);
-        this->joints[iter->first]->SetForce(0, cmd);
+        cmd += this->posPids[i].Update(
+            joint->GetAngle(0).Radian() - this->positions[i], stepTime);
       }
+
+      if (flags & COMMAND_VELOCITY)
+      {
+        cmd += this->velPids[i].Update(
+            joint->GetVelocity(0) - this->velocities[i], stepTime);
+      }
+
+      joint->SetForce(0, cmd);
     }
   }
 
@@ -125,67 +302,76 @@ void JointController::Update()
 /////////////////////////////////////////////////
 void JointController::OnJointCmd(ConstJointCmdPtr &_msg)
 {
-  std::map<std::string, JointPtr>::iterator iter;
-  iter = this->joints.find(_msg->name());
-  if (iter != this->joints.end())
+  int index = this->GetJointIndex(_msg->name());
+  if (index < 0)
   {
-    if (_msg->has_reset() && _msg->reset())
-    {
-      if (this->forces.find(_msg->name()) != this->forces.end())
-        this->forces.erase(this->forces.find(_msg->name()));
-      if (this->positions.find(_msg->name()) != this->positions.end())
-        this->positions.erase(this->positions.find(_msg->name()));
-      if (this->velocities.find(_msg->name()) != this->velocities.end())
-        this->velocities.erase(this->velocities.find(_msg->name()));
-    }
+    gzerr << "Unable to find joint[" << _msg->name() << "]\n";
+    return;
+  }
+
+  boost::mutex::scoped_lock lock(this->mutex);
 
-    if (_msg->has_force())
-      this->forces[_msg->name()] = _msg->force();
+  unsigned char flags = this->commandFlags[index];
 
+  if (_msg->has_reset() && _msg->reset())
+    flags = 0;
+
+  if (_msg->has_force())
+  {
+    this->forces[index] = _msg->force();
+    flags |= COMMAND_FORCE;
+  }
 
-    if (_msg->has_position())
+  if (_msg->has_position())
+  {
+    common::PID &pid = this->posPids[index];
+    if (_msg->position().has_target())
     {
-      if (_msg->position().has_target())
-        this->positions[_msg->name()] = _msg->position().target();
-      if (_msg->position().has_p_gain())
-        this->posPids[_msg->name()].SetPGain(_msg->position().p_gain());
-      if (_msg->position().has_i_gain())
-        this->posPids[_msg->name()].SetIGain(_msg->position().i_gain());
-      if (_msg->position().has_d_gain())
-        this->posPids[_msg->name()].SetDGain(_msg->position().d_gain());
-      if (_msg->position().has_i_max())
-        this->posPids[_msg->name()].SetIMax(_msg->position().i_max());
-      if (_msg->position().has_i_min())
-        this->posPids[_msg->name()].SetIMax(_msg->position().i_min());
+      this->positions[index] = _msg->position().target();
+      flags |= COMMAND_POSITION;
     }
+    if (_msg->position().has_p_gain())
+      pid.SetPGain(_msg->position().p_gain());
+    if (_msg->position().has_i_gain())
+      pid.SetIGain(_msg->position().i_gain());
+    if (_msg->position().has_d_gain())
+      pid.SetDGain(_msg->position().d_gain());
+    if (_msg->position().has_i_max())
+      pid.SetIMax(_msg->position().i_max());
+    if (_msg->position().has_i_min())
+      pid.SetIMin(_msg->position().i_min());
+  }
 
-    if (_msg->has_velocity())
+  if (_msg->has_velocity())
+  {
+    common::PID &pid = this->velPids[index];
+    if (_msg->velocity().has_target())
     {
-      if (_msg->velocity().has_target())
-        this->velocities[_msg->name()] = _msg->velocity().target();
-      if (_msg->velocity().has_p_gain())
-        this->velPids[_msg->name()].SetPGain(_msg->velocity().p_gain());
-      if (_msg->velocity().has_i_gain())
-        this->velPids[_msg->name()].SetIGain(_msg->velocity().i_gain());
-      if (_msg->velocity().has_d_gain())
-        this->velPids[_msg->name()].SetDGain(_msg->velocity().d_gain());
-      if (_msg->velocity().has_i_max())
-        this->velPids[_msg->name()].SetIMax(_msg->velocity().i_max());
-      if (_msg->velocity().has_i_min())
-        this->velPids[_msg->name()].SetIMax(_msg->velocity().i_min());
+      this->velocities[index] = _msg->velocity().target();
+      flags |= COMMAND_VELOCITY;
     }
+    if (_msg->velocity().has_p_gain())
+      pid.SetPGain(_msg->velocity().p_gain());
+    if (_msg->velocity().has_i_gain())
+      pid.SetIGain(_msg->velocity().i_gain());
+    if (_msg->velocity().has_d_gain())
+      pid.SetDGain(_msg->velocity().d_gain());
+    if (_msg->velocity().has_i_max())
+      pid.SetIMax(_msg->velocity().i_max());
+    if (_msg->velocity().has_i_min())
+      pid.SetIMin(_msg->velocity().i_min());
   }
-  else
-    gzerr << "Unable to find joint[" << _msg->name() << "]\n";
+
+  this->SetCommandFlags(index, flags);
 }
 
 //////////////////////////////////////////////////
 void JointController::SetJointPosition(const std::string &_name,
                                        double _position)
 {
-  std::map<std::string, JointPtr>::iterator jiter = this->joints.find(_name);
-  if (jiter != this->joints.end())
-    this->SetJointPosition(jiter->second, _position);
+  int index = this->GetJointIndex(_name);
+  if (index >= 0)
+    this->SetJointPosition(this->GetJoint(index), _position);
   else
     gzwarn << "SetJointPosition [" << _name << "] not found\n";
 }
@@ -196,14 +382,14 @@ void JointController::SetJointPositions(
 {
   // go through all joints in this model and update each one
   //   for each joint update, recursively update all children
-  std::map<std::string, JointPtr>::iterator iter;
   std::map<std::string, double>::const_iterator jiter;
 
-  for (iter = this->joints.begin(); iter != this->joints.end(); ++iter)
+  for (std::vector<JointPtr>::iterator iter = this->joints.begin();
+       iter != this->joints.end(); ++iter)
   {
-    jiter = _jointPositions.find(iter->second->GetScopedName());
+    jiter = _jointPositions.find((*iter)->GetScopedName());
     if (jiter != _jointPositions.end())
-      this->SetJointPosition(iter->second, jiter->second);
+      this->SetJointPosition(*iter, jiter->second);
   }
 }
 
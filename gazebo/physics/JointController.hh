@@ -20,8 +20,10 @@
 #include <map>
 #include <string>
 #include <vector>
+#include <boost/thread/mutex.hpp>
 
 #include "gazebo/common/PID.hh"
+#include "gazebo/common/SnapshotBuffer.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/transport/TransportTypes.hh"
@@ -36,6 +38,12 @@ namespace gazebo
 
     /// \class JointController JointController.hh physics/physics.hh
     /// \brief A class for manipulating physics::Joint
+    ///
+    /// Each controlled joint has an index, which can be found once with
+    /// GetJointIndex and then used to command the joint without looking up
+    /// its name. Targets and PID states are kept in arrays indexed by joint,
+    /// and Update applies the sum of the commands of each joint in a single
+    /// pass.
     class JointController
     {
       /// \brief Constructor
@@ -52,6 +60,50 @@ namespace gazebo
       /// \brief Reset all commands
       public: void Reset();
 
+      /// \brief Write the commands and PID states of the joints.
+      /// \param[in] _buffer Buffer to write to.
+      public: void Snapshot(common::SnapshotBuffer &_buffer);
+
+      /// \brief Read the state written by Snapshot.
+      /// \param[in] _buffer Buffer to read from.
+      /// \return False if the buffer is too short, or was written with a
+      /// different number of joints.
+      public: bool Restore(common::SnapshotBuffer &_buffer);
+
+      /// \brief Get the index of a controlled joint.
+      /// \param[in] _name Scoped name of the joint.
+      /// \return Index of the joint, -1 if the joint is not controlled.
+      public: int GetJointIndex(const std::string &_name) const;
+
+      /// \brief Get the number of controlled joints.
+      /// \return Number of joints, one more than the largest index.
+      public: unsigned int GetJointCount() const;
+
+      /// \brief Get a controlled joint.
+      /// \param[in] _index Index of the joint.
+      /// \return The joint, NULL if the index is invalid.
+      public: JointPtr GetJoint(unsigned int _index) const;
+
+      /// \brief Apply a force to a joint at every update.
+      /// \param[in] _index Index of the joint.
+      /// \param[in] _force Force or torque to apply.
+      public: void SetForce(unsigned int _index, double _force);
+
+      /// \brief Drive a joint to a position with its position PID.
+      /// \param[in] _index Index of the joint.
+      /// \param[in] _target Target position, in radians or meters.
+      public: void SetPositionTarget(unsigned int _index, double _target);
+
+      /// \brief Drive a joint to a velocity with its velocity PID.
+      /// \param[in] _index Index of the joint.
+      /// \param[in] _target Target velocity.
+      public: void SetVelocityTarget(unsigned int _index, double _target);
+
+      /// \brief Remove the force, position and velocity commands of a
+      /// joint.
+      /// \param[in] _index Index of the joint.
+      public: void ClearCommands(unsigned int _index);
+
       /// \brief Set the positions of a Joint by name.
       /// \sa JointController::SetJointPosition(JointPtr, double)
       public: void SetJointPosition(const std::string &_name, double _position);
@@ -83,6 +135,11 @@ namespace gazebo
       /// \param[in] _position Position of the joint.
       public: void SetJointPosition(JointPtr _joint, double _position);
 
+      /// \brief Set the command flags of a joint. The mutex must be locked.
+      /// \param[in] _index Index of the joint.
+      /// \param[in] _flags New combination of CommandFlag values.
+      private: void SetCommandFlags(unsigned int _index, unsigned char _flags);
+
       /// \brief Helper for SetJointPositions.
       /// \param[in] _joint Joint to move.
       /// \param[in] _link Link to move.
@@ -126,23 +183,52 @@ namespace gazebo
       /// \brief List of links that have been updated.
       private: Link_V updatedLinks;
 
-      /// \brief Map of joint names to the joint pointer.
-      private: std::map<std::string, JointPtr> joints;
+      /// \brief Commands that can be active on a joint.
+      private: enum CommandFlag
+               {
+                 /// \brief A force is applied.
+                 COMMAND_FORCE = 1,
+
+                 /// \brief The position PID is active.
+                 COMMAND_POSITION = 2,
+
+                 /// \brief The velocity PID is active.
+                 COMMAND_VELOCITY = 4
+               };
+
+      /// \brief Map of joint names to joint indices.
+      private: std::map<std::string, unsigned int> jointIndices;
+
+      /// \brief Controlled joints, indexed by joint index.
+      private: std::vector<JointPtr> joints;
+
+      /// \brief Position PID controllers, indexed by joint index.
+      private: std::vector<common::PID> posPids;
+
+      /// \brief Velocity PID controllers, indexed by joint index.
+      private: std::vector<common::PID> velPids;
+
+      /// \brief Forces applied to joints, indexed by joint index.
+      private: std::vector<double> forces;
+
+      /// \brief Joint position targets, indexed by joint index.
+      private: std::vector<double> positions;
 
-      /// \brief Position PID controllers.
-      private: std::map<std::string, common::PID> posPids;
+      /// \brief Joint velocity targets, indexed by joint index.
+      private: std::vector<double> velocities;
 
-      /// \brief Velocity PID controllers.
-      private: std::map<std::string, common::PID> velPids;
+      /// \brief Active CommandFlag values, indexed by joint index.
+      private: std::vector<unsigned char> commandFlags;
 
-      /// \brief Forces applied to joints.
-      private: std::map<std::string, double> forces;
+      /// \brief Indices of the joints that have a command.
+      private: std::vector<unsigned int> activeJoints;
 
-      /// \brief Joint positions.
-      private: std::map<std::string, double> positions;
+      /// \brief True when activeJoints must be rebuilt.
+      private: bool activeJointsDirty;
 
-      /// \brief Joint velocities.
-      private: std::map<std::string, double> velocities;
+      /// \brief Protects the commands, which are set from the transport
+      /// thread and applied in the world thread.
+      private: mutable boost::mutex mutex;
 
       /// \brief Node for communication.
       private: transport::NodePtr node;
@@ -29,6 +29,7 @@
 #include "gazebo/common/KeyFrame.hh"
 #include "gazebo/common/Animation.hh"
 #include "gazebo/common/Plugin.hh"
+#include "gazebo/common/SnapshotBuffer.hh"
 #include "gazebo/common/Events.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Console.hh"
@@ -955,6 +956,125 @@ void Model::SetState(const ModelState &_state)
   }
 }
 
+//////////////////////////////////////////////////
+void Model::Snapshot(common::SnapshotBuffer &_buffer)
+{
+  _buffer.Write(static_cast<uint32_t>(this->GetId()));
+  _buffer.Write(this->GetWorldPose());
+
+  // The links are in a block, so a model whose links changed is detected
+  size_t linksHandle = _buffer.BeginBlock();
+  for (Base_V::iterator iter = this->children.begin();
+       iter != this->childrenEnd; ++iter)
+  {
+    if (!(*iter)->HasType(Base::LINK))
+      continue;
+
+    Link *link = static_cast<Link*>(iter->get());
+    _buffer.Write(link->GetWorldPose());
+    if (!link->IsStatic())
+    {
+      _buffer.Write(link->GetWorldCoGLinearVel());
+      _buffer.Write(link->GetWorldAngularVel());
+      _buffer.Write(static_cast<uint8_t>(link->GetEnabled()));
+    }
+  }
+  _buffer.EndBlock(linksHandle);
+
+  _buffer.Write(static_cast<uint8_t>(this->jointController ? 1 : 0));
+  if (this->jointController)
+    this->jointController->Snapshot(_buffer);
+
+  _buffer.Write(static_cast<uint32_t>(this->plugins.size()));
+  for (std::vector<ModelPluginPtr>::iterator iter = this->plugins.begin();
+       iter != this->plugins.end(); ++iter)
+  {
+    size_t handle = _buffer.BeginBlock();
+    (*iter)->Snapshot(_buffer);
+    _buffer.EndBlock(handle);
+  }
+}
+
+//////////////////////////////////////////////////
+bool Model::Restore(common::SnapshotBuffer &_buffer)
+{
+  uint32_t modelId = 0;
+  math::Pose pose;
+  size_t linksEnd = 0;
+  if (!_buffer.Read(modelId) || modelId != this->GetId() ||
+      !_buffer.Read(pose) || !_buffer.ReadBlock(linksEnd))
+  {
+    return false;
+  }
+
+  // Links are set one by one, so only move the entities of the model
+  // here, without touching the physics engine.
+  this->SetWorldPose(pose, false, false);
+
+  for (Base_V::iterator iter = this->children.begin();
+       iter != this->childrenEnd; ++iter)
+  {
+    if (!(*iter)->HasType(Base::LINK))
+      continue;
+
+    Link *link = static_cast<Link*>(iter->get());
+    if (!_buffer.Read(pose))
+      return false;
+    link->SetWorldPose(pose, true, false);
+
+    if (!link->IsStatic())
+    {
+      math::Vector3 linearVel, angularVel;
+      uint8_t enabled = 0;
+      if (!_buffer.Read(linearVel) || !_buffer.Read(angularVel) ||
+          !_buffer.Read(enabled))
+      {
+        return false;
+      }
+      link->SetLinearVel(linearVel);
+      link->SetAngularVel(angularVel);
+      link->SetEnabled(enabled != 0);
+    }
+
+    if (_buffer.GetPosition() > linksEnd)
+      return false;
+  }
+
+  if (_buffer.GetPosition() != linksEnd)
+    return false;
+
+  uint8_t hasController = 0;
+  if (!_buffer.Read(hasController) ||
+      hasController != (this->jointController ? 1 : 0))
+  {
+    return false;
+  }
+  if (this->jointController && !this->jointController->Restore(_buffer))
+    return false;
+
+  uint32_t pluginCount = 0;
+  if (!_buffer.Read(pluginCount) || pluginCount != this->plugins.size())
+    return false;
+
+  for (std::vector<ModelPluginPtr>::iterator iter = this->plugins.begin();
+       iter != this->plugins.end(); ++iter)
+  {
+    size_t end = 0;
+    if (!_buffer.ReadBlock(end))
+      return false;
+
+    (*iter)->Restore(_buffer);
+    if (_buffer.GetPosition() != end)
+    {
+      gzwarn << "Plugin[" << (*iter)->GetHandle() << "] of model["
+             << this->GetName() << "] didn't read back its snapshot\n";
+      _buffer.Seek(end);
+    }
+  }
+
+  return true;
+}
+
 /////////////////////////////////////////////////
 void Model::SetEnabled(bool _enabled)
 {
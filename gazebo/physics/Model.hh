@@ -244,6 +244,19 @@ namespace gazebo
       /// \param[in] _state State to set the model to.
       public: void SetState(const ModelState &_state);
 
+      /// \brief Write the dynamic state of the model: the poses and
+      /// velocities of its links, its joint controller, and the state of
+      /// its plugins.
+      /// \param[in] _buffer Buffer to write to.
+      /// \sa World::Snapshot
+      public: void Snapshot(common::SnapshotBuffer &_buffer);
+
+      /// \brief Read back the state written by Snapshot.
+      /// \param[in] _buffer Buffer to read from.
+      /// \return False if the buffer is too short, or was written by
+      /// another model.
+      public: bool Restore(common::SnapshotBuffer &_buffer);
+
       /// \brief Enable all the links in all the models.
       /// \param[in] _enabled True to enable all the links.
       public: void SetEnabled(bool _enabled);
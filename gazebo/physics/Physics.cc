@@ -15,6 +15,10 @@
  *
 */
 
+#include <algorithm>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
 #include "common/Console.hh"
 #include "common/Exception.hh"
 #include "physics/World.hh"
@@ -26,6 +30,24 @@ using namespace gazebo;
 
 std::vector<physics::WorldPtr> g_worlds;
 
+/// \brief Steps a range of worlds in a batch.
+class WorldBatch_TBB
+{
+  public: WorldBatch_TBB(std::vector<physics::WorldPtr> *_worlds,
+                         unsigned int _steps, std::vector<char> *_results)
+          : worlds(_worlds), steps(_steps), results(_results) {}
+
+  public: void operator() (const tbb::blocked_range<size_t> &_r) const
+  {
+    for (size_t i = _r.begin(); i != _r.end(); i++)
+      (*this->results)[i] = (*this->worlds)[i]->RunBatch(this->steps);
+  }
+
+  private: std::vector<physics::WorldPtr> *worlds;
+  private: unsigned int steps;
+  private: std::vector<char> *results;
+};
+
 /////////////////////////////////////////////////
 bool physics::load()
 {
@@ -55,6 +77,12 @@ physics::WorldPtr physics::get_world(const std::string &_name)
   {
     if (g_worlds.empty())
       gzerr << "no worlds\n";
+    else if (g_worlds.size() > 1)
+    {
+      gzerr << "physics::get_world() called without a name while "
+        << g_worlds.size() << " worlds are loaded\n";
+      gzthrow("More than one world is loaded, get a world by its name");
+    }
     else
       return *(g_worlds.begin());
   }
@@ -156,4 +184,16 @@ void physics::remove_worlds()
   g_worlds.clear();
 }
 
+/////////////////////////////////////////////////
+bool physics::step_worlds(unsigned int _steps)
+{
+  // Worlds created while stepping are left for the next batch
+  std::vector<WorldPtr> worlds = g_worlds;
+  std::vector<char> results(worlds.size(), 0);
+
+  // One world per task, so the pool balances worlds of different costs
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, worlds.size(), 1),
+      WorldBatch_TBB(&worlds, _steps, &results));
 
+  return std::find(results.begin(), results.end(), 0) == results.end();
+}
@@ -43,7 +43,8 @@ namespace gazebo
     WorldPtr create_world(const std::string &_name ="");
 
     /// \brief Returns a pointer to a world by name.
-    /// \param[in] _name Name of the world to get.
+    /// \param[in] _name Name of the world to get. An empty name returns
+    /// the only loaded world, and throws if more than one world is loaded.
     /// \return Pointer to the world.
     WorldPtr get_world(const std::string &_name = "");
 
@@ -90,6 +91,17 @@ namespace gazebo
     /// \param[in] _pause True to pause, False to unpause.
     void pause_worlds(bool pause);
 
+    /// \brief Step all the worlds in parallel with World::RunBatch, and
+    /// wait until all of them are done. The worlds must not be running in
+    /// their own threads.
+    ///
+    /// Listeners of the global world update events are called by all the
+    /// worlds, one world at a time, and must check
+    /// common::UpdateInfo::worldName.
+    /// \param[in] _steps Number of steps each world takes.
+    /// \return False if a world could not be stepped.
+    bool step_worlds(unsigned int _steps);
+
     /// \brief remove multiple worlds stored in static variable
     /// gazebo::g_worlds
     void remove_worlds();
@@ -24,6 +24,7 @@
 #include <boost/thread/recursive_mutex.hpp>
 #include <string>
 
+#include "gazebo/common/SnapshotBuffer.hh"
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/msgs/msgs.hh"
 
@@ -76,6 +77,18 @@ namespace gazebo
       /// \param[in] _seed The random number seed.
       public: virtual void SetSeed(uint32_t _seed) = 0;
 
+      /// \brief Save the state of the engine that isn't held by the links
+      /// and joints, like the random number generator of the solver.
+      /// \param[in] _buffer Buffer to write the state to.
+      /// \sa World::Snapshot
+      public: virtual void Snapshot(common::SnapshotBuffer &/*_buffer*/) {}
+
+      /// \brief Read back the state written by Snapshot.
+      /// \param[in] _buffer Buffer to read the state from.
+      /// \return False if the buffer is too short.
+      public: virtual bool Restore(common::SnapshotBuffer &/*_buffer*/)
+              {return true;}
+
       /// \brief Set the simulation update rate.
       /// This funciton is deprecated, use PhysicsEngine::SetRealTimeUpdateRate.
       /// \param[in] _value Value of the update rate.
@@ -51,6 +51,7 @@ namespace gazebo
     class SphereShape;
     class MeshShape;
     class HeightmapShape;
+    class SpatialIndex;
 
     /// \def BasePtr
     /// \brief Boost shared pointer to a Base object
@@ -140,6 +141,10 @@ namespace gazebo
     /// \brief Boost shared pointer to a MeshShape object
     typedef boost::shared_ptr<MeshShape> MeshShapePtr;
 
+    /// \def SpatialIndexPtr
+    /// \brief Boost shared pointer to a SpatialIndex object
+    typedef boost::shared_ptr<SpatialIndex> SpatialIndexPtr;
+
     /// \def Base_V
     /// \brief Vector of BasePtr
     typedef std::vector<BasePtr> Base_V;
@@ -0,0 +1,1077 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <float.h>
+#include <math.h>
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/BoxShape.hh"
+#include "gazebo/physics/SphereShape.hh"
+#include "gazebo/physics/CylinderShape.hh"
+#include "gazebo/physics/PlaneShape.hh"
+#include "gazebo/physics/TrimeshShape.hh"
+#include "gazebo/physics/HeightmapShape.hh"
+#include "gazebo/physics/RayTracer.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Largest number of items in a leaf of a hierarchy.
+static const unsigned int RayTracerLeafSize = 4;
+
+/// \brief Size of the traversal stack. Hierarchies are balanced, so this
+/// is enough for any number of items that fits in memory.
+static const int RayTracerStackSize = 64;
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief Triangles of a mesh or heightmap with their hierarchy.
+    class RayTracerMesh
+    {
+      /// \brief Array of x, y, z vertex values.
+      public: std::vector<float> vertices;
+
+      /// \brief Vertex indices, three per triangle, in the order of the
+      /// leaves of the hierarchy.
+      public: std::vector<int> indices;
+
+      /// \brief Hierarchy over the triangles.
+      public: std::vector<RayTracerNode> nodes;
+    };
+  }
+}
+
+/// \brief Bounds of an item while a hierarchy is built.
+struct RayTracerItem
+{
+  /// \brief Lower corner.
+  float min[3];
+
+  /// \brief Upper corner.
+  float max[3];
+
+  /// \brief Center of the bounds.
+  float center[3];
+};
+
+/// \brief Orders items by the center of their bounds along an axis.
+class RayTracerCompare
+{
+  /// \brief Constructor.
+  /// \param[in] _items The items.
+  /// \param[in] _axis Axis to compare along.
+  public: RayTracerCompare(const std::vector<RayTracerItem> &_items,
+                           int _axis)
+          : items(_items), axis(_axis) {}
+
+  /// \brief Compare two items.
+  /// \param[in] _a Index of the first item.
+  /// \param[in] _b Index of the second item.
+  /// \return True if the first item is before the second one.
+  public: bool operator()(unsigned int _a, unsigned int _b) const
+          {
+            return this->items[_a].center[this->axis] <
+                   this->items[_b].center[this->axis];
+          }
+
+  /// \brief The items.
+  private: const std::vector<RayTracerItem> &items;
+
+  /// \brief Axis to compare along.
+  private: int axis;
+};
+
+//////////////////////////////////////////////////
+/// \brief Set the bounds of an item, rounded outwards to floats.
+/// \param[out] _item The item.
+/// \param[in] _min Lower corner.
+/// \param[in] _max Upper corner.
+static void setItemBounds(RayTracerItem &_item, const double _min[3],
+                          const double _max[3])
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    _item.min[i] = static_cast<float>(_min[i]);
+    _item.max[i] = static_cast<float>(_max[i]);
+    _item.min[i] -= 1e-6f * (1.0f + fabsf(_item.min[i]));
+    _item.max[i] += 1e-6f * (1.0f + fabsf(_item.max[i]));
+    _item.center[i] = 0.5f * (_item.min[i] + _item.max[i]);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Build a node of a hierarchy and its children.
+/// \param[in] _items Bounds of all the items.
+/// \param[in,out] _order Item indices, sorted by the function.
+/// \param[in,out] _nodes The nodes.
+/// \param[in] _node Index of the node to build.
+/// \param[in] _begin First position in _order of the items of the node.
+/// \param[in] _end Position after the last item of the node.
+static void buildNode(const std::vector<RayTracerItem> &_items,
+    std::vector<unsigned int> &_order, std::vector<RayTracerNode> &_nodes,
+    unsigned int _node, unsigned int _begin, unsigned int _end)
+{
+  float bmin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+  float bmax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+  float cmin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+  float cmax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+  for (unsigned int i = _begin; i < _end; ++i)
+  {
+    const RayTracerItem &item = _items[_order[i]];
+    for (int j = 0; j < 3; ++j)
+    {
+      bmin[j] = std::min(bmin[j], item.min[j]);
+      bmax[j] = std::max(bmax[j], item.max[j]);
+      cmin[j] = std::min(cmin[j], item.center[j]);
+      cmax[j] = std::max(cmax[j], item.center[j]);
+    }
+  }
+
+  for (int j = 0; j < 3; ++j)
+  {
+    _nodes[_node].min[j] = bmin[j];
+    _nodes[_node].max[j] = bmax[j];
+  }
+
+  if (_end - _begin <= RayTracerLeafSize)
+  {
+    _nodes[_node].start = _begin;
+    _nodes[_node].count = _end - _begin;
+    return;
+  }
+
+  // Split at the median along the longest axis of the centers, which
+  // keeps the tree balanced
+  int axis = 0;
+  for (int j = 1; j < 3; ++j)
+  {
+    if (cmax[j] - cmin[j] > cmax[axis] - cmin[axis])
+      axis = j;
+  }
+
+  unsigned int mid = (_begin + _end) / 2;
+  std::nth_element(_order.begin() + _begin, _order.begin() + mid,
+                   _order.begin() + _end, RayTracerCompare(_items, axis));
+
+  unsigned int left = _nodes.size();
+  _nodes.resize(left + 2);
+  _nodes[_node].start = left;
+  _nodes[_node].count = 0;
+
+  buildNode(_items, _order, _nodes, left, _begin, mid);
+  buildNode(_items, _order, _nodes, left + 1, mid, _end);
+}
+
+//////////////////////////////////////////////////
+/// \brief Build a hierarchy.
+/// \param[in] _items Bounds of the items.
+/// \param[out] _order Item indices in the order of the leaves.
+/// \param[out] _nodes The nodes, the root first.
+static void buildHierarchy(const std::vector<RayTracerItem> &_items,
+    std::vector<unsigned int> &_order, std::vector<RayTracerNode> &_nodes)
+{
+  _nodes.clear();
+  _order.resize(_items.size());
+  for (unsigned int i = 0; i < _order.size(); ++i)
+    _order[i] = i;
+
+  if (_items.empty())
+    return;
+
+  _nodes.reserve(2 * _items.size());
+  _nodes.resize(1);
+  buildNode(_items, _order, _nodes, 0, 0, _items.size());
+}
+
+//////////////////////////////////////////////////
+/// \brief Intersect a ray with a box.
+/// \param[in] _min Lower corner of the box.
+/// \param[in] _max Upper corner of the box.
+/// \param[in] _origin Start of the ray.
+/// \param[in] _invDir Inverse of each component of the ray direction.
+/// \param[in] _minDist Smallest distance.
+/// \param[in] _maxDist Largest distance.
+/// \param[out] _enter Distance at which the ray enters the box.
+/// \return True if the ray crosses the box between the distances.
+static bool intersectBounds(const float _min[3], const float _max[3],
+    const double _origin[3], const double _invDir[3], double _minDist,
+    double _maxDist, double &_enter)
+{
+  double t0 = _minDist;
+  double t1 = _maxDist;
+  for (int i = 0; i < 3; ++i)
+  {
+    double tNear = (_min[i] - _origin[i]) * _invDir[i];
+    double tFar = (_max[i] - _origin[i]) * _invDir[i];
+    if (tNear > tFar)
+      std::swap(tNear, tFar);
+
+    // Written so NaN, from a ray in the plane of a face, is ignored
+    t0 = tNear > t0 ? tNear : t0;
+    t1 = tFar < t1 ? tFar : t1;
+    if (t0 > t1)
+      return false;
+  }
+
+  _enter = t0;
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Go through the leaves of a hierarchy hit by a ray, nearest
+/// first.
+/// \param[in] _nodes The hierarchy.
+/// \param[in] _origin Start of the ray.
+/// \param[in] _dir Direction of the ray.
+/// \param[in] _minDist Smallest distance.
+/// \param[in,out] _dist Largest distance, then distance of the hit.
+/// \param[in] _test Function that intersects the ray with an item.
+/// \return True if an item is hit.
+template<typename T>
+static bool traverse(const std::vector<RayTracerNode> &_nodes,
+    const double _origin[3], const double _dir[3], double _minDist,
+    double &_dist, const T &_test)
+{
+  if (_nodes.empty())
+    return false;
+
+  double invDir[3] = {1.0 / _dir[0], 1.0 / _dir[1], 1.0 / _dir[2]};
+  unsigned int stack[RayTracerStackSize];
+  int top = 0;
+  stack[top++] = 0;
+
+  bool hit = false;
+  double enter;
+  while (top > 0)
+  {
+    const RayTracerNode &node = _nodes[stack[--top]];
+    if (!intersectBounds(node.min, node.max, _origin, invDir, _minDist,
+                         _dist, enter))
+    {
+      continue;
+    }
+
+    if (node.count > 0)
+    {
+      for (unsigned int i = node.start; i < node.start + node.count; ++i)
+      {
+        if (_test(i, _origin, _dir, _minDist, _dist))
+          hit = true;
+      }
+      continue;
+    }
+
+    // Push the far child first, so the near one is visited first and
+    // shortens the ray for the other
+    double enter0, enter1;
+    bool hit0 = intersectBounds(_nodes[node.start].min,
+        _nodes[node.start].max, _origin, invDir, _minDist, _dist, enter0);
+    bool hit1 = intersectBounds(_nodes[node.start + 1].min,
+        _nodes[node.start + 1].max, _origin, invDir, _minDist, _dist, enter1);
+
+    if (hit0 && hit1)
+    {
+      if (enter0 <= enter1)
+      {
+        stack[top++] = node.start + 1;
+        stack[top++] = node.start;
+      }
+      else
+      {
+        stack[top++] = node.start;
+        stack[top++] = node.start + 1;
+      }
+    }
+    else if (hit0)
+      stack[top++] = node.start;
+    else if (hit1)
+      stack[top++] = node.start + 1;
+  }
+
+  return hit;
+}
+
+#ifdef __SSE2__
+//////////////////////////////////////////////////
+/// \brief Intersect four rays from one origin with a box, two rays per
+/// register. The arithmetic is the one of intersectBounds, so the same
+/// rays cross the box.
+/// \param[in] _node The box.
+/// \param[in] _origin Start of the rays.
+/// \param[in] _invDir Inverse of the ray directions along each axis, of
+/// rays 0 and 1, then of rays 2 and 3.
+/// \param[in] _minDist Smallest distances, in the same layout.
+/// \param[in] _dist Largest distances.
+/// \param[out] _enter Distances at which the rays enter the box.
+/// \return Bit i set if ray i crosses the box between the distances.
+static int intersectBoundsPacket(const RayTracerNode &_node,
+    const double _origin[3], const __m128d _invDir[3][2],
+    const __m128d _minDist[2], const double _dist[4], double _enter[4])
+{
+  int mask = 0;
+  for (int r = 0; r < 2; ++r)
+  {
+    __m128d t0 = _minDist[r];
+    __m128d t1 = _mm_loadu_pd(_dist + r * 2);
+    for (int i = 0; i < 3; ++i)
+    {
+      __m128d tNear = _mm_mul_pd(_mm_set1_pd(_node.min[i] - _origin[i]),
+                                 _invDir[i][r]);
+      __m128d tFar = _mm_mul_pd(_mm_set1_pd(_node.max[i] - _origin[i]),
+                                _invDir[i][r]);
+      __m128d swap = _mm_cmpgt_pd(tNear, tFar);
+      __m128d lo = _mm_or_pd(_mm_and_pd(swap, tFar),
+                             _mm_andnot_pd(swap, tNear));
+      __m128d hi = _mm_or_pd(_mm_and_pd(swap, tNear),
+                             _mm_andnot_pd(swap, tFar));
+
+      // The second operand is returned when the first one is NaN
+      t0 = _mm_max_pd(lo, t0);
+      t1 = _mm_min_pd(hi, t1);
+    }
+
+    _mm_storeu_pd(_enter + r * 2, t0);
+    mask |= _mm_movemask_pd(_mm_cmple_pd(t0, t1)) << (r * 2);
+  }
+
+  return mask;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the smallest entering distance of the rays of a packet.
+/// \param[in] _enter Entering distance of each ray.
+/// \param[in] _mask Rays to look at.
+/// \return The distance.
+static double packetEnter(const double _enter[4], int _mask)
+{
+  double enter = DBL_MAX;
+  for (int r = 0; r < 4; ++r)
+  {
+    if (_mask & (1 << r))
+      enter = std::min(enter, _enter[r]);
+  }
+  return enter;
+}
+
+//////////////////////////////////////////////////
+/// \brief Go through the leaves of a hierarchy hit by any of four rays
+/// from one origin. Same as traverse, with the bounds tested for the four
+/// rays at once and the items for each ray that crosses the leaf.
+/// \param[in] _nodes The hierarchy.
+/// \param[in] _origin Start of the rays.
+/// \param[in] _dirs Directions of the rays.
+/// \param[in] _minDist Smallest distances.
+/// \param[in,out] _dist Largest distances, then distances of the hits.
+/// \param[in] _test Function that intersects a ray with an item.
+template<typename T>
+static void traversePacket(const std::vector<RayTracerNode> &_nodes,
+    const double _origin[3], const double _dirs[12],
+    const double _minDist[4], double _dist[4], const T &_test)
+{
+  if (_nodes.empty())
+    return;
+
+  __m128d invDir[3][2];
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int r = 0; r < 2; ++r)
+    {
+      invDir[i][r] = _mm_div_pd(_mm_set1_pd(1.0),
+          _mm_set_pd(_dirs[(r * 2 + 1) * 3 + i], _dirs[r * 2 * 3 + i]));
+    }
+  }
+  __m128d minDist[2] = {_mm_loadu_pd(_minDist), _mm_loadu_pd(_minDist + 2)};
+
+  // The rays that crossed a node when it was pushed. Hits found since
+  // then only make a few of them useless, so the node isn't tested again.
+  unsigned int stack[RayTracerStackSize];
+  int masks[RayTracerStackSize];
+  int top = 0;
+
+  double enter0[4], enter1[4];
+  int rootMask = intersectBoundsPacket(_nodes[0], _origin, invDir, minDist,
+                                       _dist, enter0);
+  if (rootMask)
+  {
+    stack[top] = 0;
+    masks[top++] = rootMask;
+  }
+
+  while (top > 0)
+  {
+    --top;
+    const RayTracerNode &node = _nodes[stack[top]];
+    int mask = masks[top];
+
+    if (node.count > 0)
+    {
+      for (unsigned int i = node.start; i < node.start + node.count; ++i)
+      {
+        for (int r = 0; r < 4; ++r)
+        {
+          if (mask & (1 << r))
+            _test(i, _origin, _dirs + r * 3, _minDist[r], _dist[r]);
+        }
+      }
+      continue;
+    }
+
+    // The far child first, as in traverse, by the nearest ray
+    int mask0 = intersectBoundsPacket(_nodes[node.start], _origin, invDir,
+                                      minDist, _dist, enter0);
+    int mask1 = intersectBoundsPacket(_nodes[node.start + 1], _origin,
+                                      invDir, minDist, _dist, enter1);
+
+    bool nearFirst = !mask0 || !mask1 ||
+      packetEnter(enter0, mask0) <= packetEnter(enter1, mask1);
+    unsigned int far = nearFirst ? node.start + 1 : node.start;
+    int farMask = nearFirst ? mask1 : mask0;
+    int nearMask = nearFirst ? mask0 : mask1;
+    if (farMask)
+    {
+      stack[top] = far;
+      masks[top++] = farMask;
+    }
+    if (nearMask)
+    {
+      stack[top] = nearFirst ? node.start : node.start + 1;
+      masks[top++] = nearMask;
+    }
+  }
+}
+#endif
+
+//////////////////////////////////////////////////
+/// \brief Keep the nearest of two distances within a range.
+/// \param[in] _t0 Smaller distance.
+/// \param[in] _t1 Larger distance.
+/// \param[in] _minDist Smallest distance.
+/// \param[in,out] _dist Largest distance, then the distance kept.
+/// \return True if a distance is within the range.
+static bool nearestRoot(double _t0, double _t1, double _minDist,
+                        double &_dist)
+{
+  double t = _t0 >= _minDist ? _t0 : _t1;
+  if (t < _minDist || t > _dist)
+    return false;
+
+  _dist = t;
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Intersect a ray with a triangle, from either side.
+/// \param[in] _v0 First vertex.
+/// \param[in] _v1 Second vertex.
+/// \param[in] _v2 Third vertex.
+/// \param[in] _origin Start of the ray.
+/// \param[in] _dir Direction of the ray.
+/// \param[in] _minDist Smallest distance.
+/// \param[in,out] _dist Largest distance, then distance of the hit.
+/// \return True if the triangle is hit.
+static bool intersectTriangle(const float *_v0, const float *_v1,
+    const float *_v2, const double _origin[3], const double _dir[3],
+    double _minDist, double &_dist)
+{
+  double e1[3] = {_v1[0] - _v0[0], _v1[1] - _v0[1], _v1[2] - _v0[2]};
+  double e2[3] = {_v2[0] - _v0[0], _v2[1] - _v0[1], _v2[2] - _v0[2]};
+  double p[3] = {_dir[1] * e2[2] - _dir[2] * e2[1],
+                 _dir[2] * e2[0] - _dir[0] * e2[2],
+                 _dir[0] * e2[1] - _dir[1] * e2[0]};
+
+  double det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+  if (fabs(det) < 1e-15)
+    return false;
+  double invDet = 1.0 / det;
+
+  double s[3] = {_origin[0] - _v0[0], _origin[1] - _v0[1],
+                 _origin[2] - _v0[2]};
+  double u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * invDet;
+  if (u < 0 || u > 1)
+    return false;
+
+  double q[3] = {s[1] * e1[2] - s[2] * e1[1],
+                 s[2] * e1[0] - s[0] * e1[2],
+                 s[0] * e1[1] - s[1] * e1[0]};
+  double v = (_dir[0] * q[0] + _dir[1] * q[1] + _dir[2] * q[2]) * invDet;
+  if (v < 0 || u + v > 1)
+    return false;
+
+  double t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * invDet;
+  if (t < _minDist || t > _dist)
+    return false;
+
+  _dist = t;
+  return true;
+}
+
+/// \brief Intersects a ray with the triangles of a leaf of a mesh.
+class RayTracerMeshTest
+{
+  /// \brief Constructor.
+  /// \param[in] _mesh The mesh.
+  public: explicit RayTracerMeshTest(const RayTracerMesh *_mesh)
+          : mesh(_mesh) {}
+
+  /// \brief Intersect a ray with a triangle.
+  /// \param[in] _index Index of the triangle.
+  /// \param[in] _origin Start of the ray.
+  /// \param[in] _dir Direction of the ray.
+  /// \param[in] _minDist Smallest distance.
+  /// \param[in,out] _dist Largest distance, then distance of the hit.
+  /// \return True if the triangle is hit.
+  public: bool operator()(unsigned int _index, const double _origin[3],
+              const double _dir[3], double _minDist, double &_dist) const
+          {
+            const int *tri = &this->mesh->indices[_index * 3];
+            const float *v = &this->mesh->vertices[0];
+            return intersectTriangle(v + tri[0] * 3, v + tri[1] * 3,
+                v + tri[2] * 3, _origin, _dir, _minDist, _dist);
+          }
+
+  /// \brief The mesh.
+  private: const RayTracerMesh *mesh;
+};
+
+//////////////////////////////////////////////////
+/// \brief Intersect a ray with a shape.
+/// \param[in] _object The shape.
+/// \param[in] _origin Start of the ray in the world frame.
+/// \param[in] _dir Direction of the ray in the world frame.
+/// \param[in] _minDist Smallest distance.
+/// \param[in,out] _dist Largest distance, then distance of the hit.
+/// \return True if the shape is hit.
+static bool intersectObject(const RayTracerObject &_object,
+    const double _origin[3], const double _dir[3], double _minDist,
+    double &_dist)
+{
+  // Move the ray to the frame of the shape. Rotations keep lengths, so
+  // distances are the same in both frames.
+  const double *r = _object.rot;
+  double rel[3] = {_origin[0] - _object.pos[0], _origin[1] - _object.pos[1],
+                   _origin[2] - _object.pos[2]};
+  double o[3], d[3];
+  for (int i = 0; i < 3; ++i)
+  {
+    o[i] = r[i] * rel[0] + r[3 + i] * rel[1] + r[6 + i] * rel[2];
+    d[i] = r[i] * _dir[0] + r[3 + i] * _dir[1] + r[6 + i] * _dir[2];
+  }
+
+  const double *size = _object.size;
+  switch (_object.type)
+  {
+    case Base::BOX_SHAPE:
+    {
+      double t0 = -DBL_MAX;
+      double t1 = DBL_MAX;
+      for (int i = 0; i < 3; ++i)
+      {
+        if (fabs(d[i]) < 1e-15)
+        {
+          if (fabs(o[i]) > size[i])
+            return false;
+          continue;
+        }
+        double tNear = (-size[i] - o[i]) / d[i];
+        double tFar = (size[i] - o[i]) / d[i];
+        if (tNear > tFar)
+          std::swap(tNear, tFar);
+        t0 = std::max(t0, tNear);
+        t1 = std::min(t1, tFar);
+      }
+      return t0 <= t1 && nearestRoot(t0, t1, _minDist, _dist);
+    }
+
+    case Base::SPHERE_SHAPE:
+    {
+      double b = o[0] * d[0] + o[1] * d[1] + o[2] * d[2];
+      double c = o[0] * o[0] + o[1] * o[1] + o[2] * o[2] - size[0] * size[0];
+      double disc = b * b - c;
+      if (disc < 0)
+        return false;
+      double s = sqrt(disc);
+      return nearestRoot(-b - s, -b + s, _minDist, _dist);
+    }
+
+    case Base::CYLINDER_SHAPE:
+    {
+      double radius2 = size[0] * size[0];
+      double best = _dist;
+      bool hit = false;
+
+      // Side
+      double a = d[0] * d[0] + d[1] * d[1];
+      if (a > 1e-15)
+      {
+        double b = o[0] * d[0] + o[1] * d[1];
+        double c = o[0] * o[0] + o[1] * o[1] - radius2;
+        double disc = b * b - a * c;
+        if (disc >= 0)
+        {
+          double s = sqrt(disc);
+          double roots[2] = {(-b - s) / a, (-b + s) / a};
+          for (int i = 0; i < 2; ++i)
+          {
+            double z = o[2] + roots[i] * d[2];
+            if (roots[i] >= _minDist && roots[i] <= best &&
+                fabs(z) <= size[1])
+            {
+              best = roots[i];
+              hit = true;
+            }
+          }
+        }
+      }
+
+      // Caps
+      if (fabs(d[2]) > 1e-15)
+      {
+        for (int i = 0; i < 2; ++i)
+        {
+          double t = ((i == 0 ? -size[1] : size[1]) - o[2]) / d[2];
+          double x = o[0] + t * d[0];
+          double y = o[1] + t * d[1];
+          if (t >= _minDist && t <= best && x * x + y * y <= radius2)
+          {
+            best = t;
+            hit = true;
+          }
+        }
+      }
+
+      if (hit)
+        _dist = best;
+      return hit;
+    }
+
+    case Base::PLANE_SHAPE:
+    {
+      double denom = size[0] * d[0] + size[1] * d[1] + size[2] * d[2];
+      if (fabs(denom) < 1e-15)
+        return false;
+      double t = -(size[0] * o[0] + size[1] * o[1] + size[2] * o[2]) / denom;
+      return nearestRoot(t, t, _minDist, _dist);
+    }
+
+    case Base::TRIMESH_SHAPE:
+    case Base::HEIGHTMAP_SHAPE:
+      return traverse(_object.mesh->nodes, o, d, _minDist, _dist,
+                      RayTracerMeshTest(_object.mesh));
+
+    default:
+      return false;
+  }
+}
+
+/// \brief Intersects a ray with the shapes of a leaf of the world
+/// hierarchy.
+class RayTracerObjectTest
+{
+  /// \brief Constructor.
+  /// \param[in] _objects The shapes.
+  /// \param[in] _order Shapes in the order of the leaves.
+  /// \param[out] _collision Set to the collision that is hit, may be
+  /// NULL.
+  public: RayTracerObjectTest(const std::vector<RayTracerObject> &_objects,
+              const std::vector<unsigned int> &_order,
+              Collision **_collision)
+          : objects(_objects), order(_order), collision(_collision) {}
+
+  /// \brief Intersect a ray with a shape.
+  /// \param[in] _index Position of the shape in the leaves.
+  /// \param[in] _origin Start of the ray.
+  /// \param[in] _dir Direction of the ray.
+  /// \param[in] _minDist Smallest distance.
+  /// \param[in,out] _dist Largest distance, then distance of the hit.
+  /// \return True if the shape is hit.
+  public: bool operator()(unsigned int _index, const double _origin[3],
+              const double _dir[3], double _minDist, double &_dist) const
+          {
+            const RayTracerObject &object =
+              this->objects[this->order[_index]];
+            if (!intersectObject(object, _origin, _dir, _minDist, _dist))
+              return false;
+
+            if (this->collision)
+              *this->collision = object.collision;
+            return true;
+          }
+
+  /// \brief The shapes.
+  private: const std::vector<RayTracerObject> &objects;
+
+  /// \brief Shapes in the order of the leaves.
+  private: const std::vector<unsigned int> &order;
+
+  /// \brief Collision that was hit.
+  private: Collision **collision;
+};
+
+//////////////////////////////////////////////////
+/// \brief Build the hierarchy of a mesh.
+/// \param[in] _vertices Array of x, y, z vertex values.
+/// \param[in] _indices Vertex indices, three per triangle.
+/// \return The mesh, NULL if it has no triangles.
+static RayTracerMesh *buildMesh(const std::vector<float> &_vertices,
+                                const std::vector<int> &_indices)
+{
+  unsigned int triCount = _indices.size() / 3;
+  if (triCount == 0)
+    return NULL;
+
+  std::vector<RayTracerItem> items(triCount);
+  for (unsigned int i = 0; i < triCount; ++i)
+  {
+    double min[3] = {DBL_MAX, DBL_MAX, DBL_MAX};
+    double max[3] = {-DBL_MAX, -DBL_MAX, -DBL_MAX};
+    for (int j = 0; j < 3; ++j)
+    {
+      const float *v = &_vertices[_indices[i * 3 + j] * 3];
+      for (int k = 0; k < 3; ++k)
+      {
+        min[k] = std::min(min[k], static_cast<double>(v[k]));
+        max[k] = std::max(max[k], static_cast<double>(v[k]));
+      }
+    }
+    setItemBounds(items[i], min, max);
+  }
+
+  RayTracerMesh *mesh = new RayTracerMesh();
+  std::vector<unsigned int> order;
+  buildHierarchy(items, order, mesh->nodes);
+
+  // Store the triangles in the order of the leaves
+  mesh->vertices = _vertices;
+  mesh->indices.resize(triCount * 3);
+  for (unsigned int i = 0; i < triCount; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+      mesh->indices[i * 3 + j] = _indices[order[i] * 3 + j];
+  }
+
+  return mesh;
+}
+
+//////////////////////////////////////////////////
+RayTracer::RayTracer(WorldPtr _world)
+  : world(_world)
+{
+}
+
+//////////////////////////////////////////////////
+RayTracer::~RayTracer()
+{
+}
+
+//////////////////////////////////////////////////
+void RayTracer::Update()
+{
+  this->objects.clear();
+  this->planes.clear();
+
+  std::map<std::string, bool> usedMeshes;
+
+  Model_V models = this->world->GetModels();
+  for (Model_V::iterator model = models.begin(); model != models.end();
+       ++model)
+  {
+    Link_V links = (*model)->GetLinks();
+    for (Link_V::iterator link = links.begin(); link != links.end(); ++link)
+    {
+      Collision_V collisions = (*link)->GetCollisions();
+      for (Collision_V::iterator collision = collisions.begin();
+           collision != collisions.end(); ++collision)
+      {
+        this->AddCollision(*collision, usedMeshes);
+      }
+    }
+  }
+
+  // Forget the meshes of removed collisions
+  for (std::map<std::string, boost::shared_ptr<RayTracerMesh> >::iterator
+       iter = this->meshes.begin(); iter != this->meshes.end();)
+  {
+    if (usedMeshes.find(iter->first) == usedMeshes.end())
+      this->meshes.erase(iter++);
+    else
+      ++iter;
+  }
+
+  // World bounds of the shapes
+  std::vector<RayTracerItem> items(this->objects.size());
+  for (unsigned int i = 0; i < this->objects.size(); ++i)
+  {
+    const RayTracerObject &object = this->objects[i];
+    double local[3], center[3] = {0, 0, 0};
+    switch (object.type)
+    {
+      case Base::SPHERE_SHAPE:
+        local[0] = local[1] = local[2] = object.size[0];
+        break;
+      case Base::CYLINDER_SHAPE:
+        local[0] = local[1] = object.size[0];
+        local[2] = object.size[1];
+        break;
+      case Base::TRIMESH_SHAPE:
+      case Base::HEIGHTMAP_SHAPE:
+        for (int j = 0; j < 3; ++j)
+        {
+          center[j] = 0.5 * (object.mesh->nodes[0].min[j] +
+                             object.mesh->nodes[0].max[j]);
+          local[j] = 0.5 * (object.mesh->nodes[0].max[j] -
+                            object.mesh->nodes[0].min[j]);
+        }
+        break;
+      default:
+        local[0] = object.size[0];
+        local[1] = object.size[1];
+        local[2] = object.size[2];
+        break;
+    }
+
+    double min[3], max[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      const double *row = object.rot + j * 3;
+      double c = object.pos[j] + row[0] * center[0] + row[1] * center[1] +
+        row[2] * center[2];
+      double e = fabs(row[0]) * local[0] + fabs(row[1]) * local[1] +
+        fabs(row[2]) * local[2];
+      min[j] = c - e;
+      max[j] = c + e;
+    }
+    setItemBounds(items[i], min, max);
+  }
+
+  buildHierarchy(items, this->order, this->nodes);
+}
+
+//////////////////////////////////////////////////
+void RayTracer::AddCollision(CollisionPtr _collision,
+                             std::map<std::string, bool> &_usedMeshes)
+{
+  ShapePtr shape = _collision->GetShape();
+  if (!shape)
+    return;
+
+  RayTracerObject object;
+  object.collision = _collision.get();
+  object.mesh = NULL;
+
+  math::Pose pose = _collision->GetWorldPose();
+  math::Matrix3 rot = pose.rot.GetAsMatrix3();
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+      object.rot[i * 3 + j] = rot[i][j];
+  }
+  object.pos[0] = pose.pos.x;
+  object.pos[1] = pose.pos.y;
+  object.pos[2] = pose.pos.z;
+
+  if (shape->HasType(Base::BOX_SHAPE))
+  {
+    math::Vector3 size =
+      boost::static_pointer_cast<BoxShape>(shape)->GetSize() * 0.5;
+    object.type = Base::BOX_SHAPE;
+    object.size[0] = size.x;
+    object.size[1] = size.y;
+    object.size[2] = size.z;
+  }
+  else if (shape->HasType(Base::SPHERE_SHAPE))
+  {
+    object.type = Base::SPHERE_SHAPE;
+    object.size[0] = boost::static_pointer_cast<SphereShape>(
+        shape)->GetRadius();
+  }
+  else if (shape->HasType(Base::CYLINDER_SHAPE))
+  {
+    CylinderShapePtr cylinder =
+      boost::static_pointer_cast<CylinderShape>(shape);
+    object.type = Base::CYLINDER_SHAPE;
+    object.size[0] = cylinder->GetRadius();
+    object.size[1] = cylinder->GetLength() * 0.5;
+  }
+  else if (shape->HasType(Base::PLANE_SHAPE))
+  {
+    math::Vector3 normal =
+      boost::static_pointer_cast<PlaneShape>(shape)->GetNormal();
+    normal.Normalize();
+    object.type = Base::PLANE_SHAPE;
+    object.size[0] = normal.x;
+    object.size[1] = normal.y;
+    object.size[2] = normal.z;
+    this->planes.push_back(object);
+    return;
+  }
+  else if (shape->HasType(Base::TRIMESH_SHAPE))
+  {
+    boost::shared_ptr<TrimeshShape> trimesh =
+      boost::static_pointer_cast<TrimeshShape>(shape);
+    std::string key = trimesh->GetMeshKey();
+    if (key.empty())
+      return;
+
+    boost::shared_ptr<RayTracerMesh> &mesh = this->meshes[key];
+    if (!mesh && _usedMeshes.find(key) == _usedMeshes.end())
+    {
+      std::vector<float> vertices;
+      std::vector<int> indices;
+      trimesh->FillTriangles(vertices, indices);
+      mesh.reset(buildMesh(vertices, indices));
+    }
+    _usedMeshes[key] = true;
+
+    if (!mesh)
+      return;
+    object.type = Base::TRIMESH_SHAPE;
+    object.mesh = mesh.get();
+  }
+  else if (shape->HasType(Base::HEIGHTMAP_SHAPE))
+  {
+    HeightmapShapePtr heightmap =
+      boost::static_pointer_cast<HeightmapShape>(shape);
+
+    // Tiles are loaded and unloaded as links move, so only heightmaps
+    // held in memory as a whole are traced
+    if (heightmap->IsTiled())
+      return;
+
+    std::string key = _collision->GetScopedName() + "::heightmap";
+    boost::shared_ptr<RayTracerMesh> &mesh = this->meshes[key];
+    if (!mesh && _usedMeshes.find(key) == _usedMeshes.end())
+    {
+      // Same layout as the heightfield of the physics engine: centered
+      // on the collision, rows going towards -y
+      int count = heightmap->GetVertexCount().x;
+      math::Vector3 size = heightmap->GetSize();
+      double offset = heightmap->GetPos().z;
+
+      std::vector<float> vertices;
+      std::vector<int> indices;
+      if (count > 1)
+      {
+        vertices.resize(count * count * 3);
+        for (int y = 0; y < count; ++y)
+        {
+          for (int x = 0; x < count; ++x)
+          {
+            float *v = &vertices[(y * count + x) * 3];
+            v[0] = -0.5 * size.x + x * size.x / (count - 1);
+            v[1] = 0.5 * size.y - y * size.y / (count - 1);
+            v[2] = heightmap->GetHeight(x, y) + offset;
+          }
+        }
+
+        indices.reserve((count - 1) * (count - 1) * 6);
+        for (int y = 0; y < count - 1; ++y)
+        {
+          for (int x = 0; x < count - 1; ++x)
+          {
+            int a = y * count + x;
+            int tris[6] = {a, a + count, a + 1, a + 1, a + count,
+                           a + count + 1};
+            indices.insert(indices.end(), tris, tris + 6);
+          }
+        }
+      }
+      mesh.reset(buildMesh(vertices, indices));
+    }
+    _usedMeshes[key] = true;
+
+    if (!mesh)
+      return;
+    object.type = Base::HEIGHTMAP_SHAPE;
+    object.mesh = mesh.get();
+  }
+  else
+  {
+    // Rays and maps have no surface to hit
+    return;
+  }
+
+  this->objects.push_back(object);
+}
+
+//////////////////////////////////////////////////
+unsigned int RayTracer::GetShapeCount() const
+{
+  return this->objects.size() + this->planes.size();
+}
+
+//////////////////////////////////////////////////
+bool RayTracer::Intersect(const double _origin[3], const double _dir[3],
+                          double _minDist, double &_dist,
+                          Collision **_collision) const
+{
+  bool hit = traverse(this->nodes, _origin, _dir, _minDist, _dist,
+      RayTracerObjectTest(this->objects, this->order, _collision));
+
+  for (std::vector<RayTracerObject>::const_iterator iter =
+       this->planes.begin(); iter != this->planes.end(); ++iter)
+  {
+    if (intersectObject(*iter, _origin, _dir, _minDist, _dist))
+    {
+      if (_collision)
+        *_collision = iter->collision;
+      hit = true;
+    }
+  }
+
+  return hit;
+}
+
+//////////////////////////////////////////////////
+void RayTracer::IntersectPacket(const double _origin[3],
+                                const double _dirs[12],
+                                const double _minDist[4],
+                                double _dist[4]) const
+{
+#ifdef __SSE2__
+  traversePacket(this->nodes, _origin, _dirs, _minDist, _dist,
+      RayTracerObjectTest(this->objects, this->order, NULL));
+
+  for (std::vector<RayTracerObject>::const_iterator iter =
+       this->planes.begin(); iter != this->planes.end(); ++iter)
+  {
+    for (int r = 0; r < 4; ++r)
+      intersectObject(*iter, _origin, _dirs + r * 3, _minDist[r], _dist[r]);
+  }
+#else
+  for (int r = 0; r < 4; ++r)
+    this->Intersect(_origin, _dirs + r * 3, _minDist[r], _dist[r]);
+#endif
+}
+
+//////////////////////////////////////////////////
+bool RayTracer::Intersect(const math::Vector3 &_origin,
+                          const math::Vector3 &_dir,
+                          double _minDist, double &_dist) const
+{
+  double origin[3] = {_origin.x, _origin.y, _origin.z};
+  double dir[3] = {_dir.x, _dir.y, _dir.z};
+  return this->Intersect(origin, dir, _minDist, _dist);
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _RAYTRACER_HH_
+#define _RAYTRACER_HH_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "gazebo/math/Vector3.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \brief Node of a bounding volume hierarchy used by RayTracer.
+    class RayTracerNode
+    {
+      /// \brief Lower corner of the bounding box.
+      public: float min[3];
+
+      /// \brief Upper corner of the bounding box.
+      public: float max[3];
+
+      /// \brief Index of the first item of a leaf, or of the first child
+      /// of an inner node. The second child follows the first one.
+      public: unsigned int start;
+
+      /// \brief Number of items of a leaf, 0 for an inner node.
+      public: unsigned int count;
+    };
+
+    /// \brief Triangles of a mesh or heightmap with their hierarchy.
+    class RayTracerMesh;
+
+    /// \brief A collision shape placed in the world, in the form used
+    /// by RayTracer.
+    class RayTracerObject
+    {
+      /// \brief Type of the shape, a Base::EntityType value.
+      public: unsigned int type;
+
+      /// \brief Rotation from the shape frame to the world frame, row
+      /// major.
+      public: double rot[9];
+
+      /// \brief Position of the shape in the world frame.
+      public: double pos[3];
+
+      /// \brief Box half sizes, sphere radius, or cylinder radius and
+      /// half length, plane normal, depending on the type.
+      public: double size[3];
+
+      /// \brief Triangles of a trimesh or heightmap, NULL otherwise.
+      public: const RayTracerMesh *mesh;
+
+      /// \brief Collision of the shape.
+      public: Collision *collision;
+    };
+
+    /// \class RayTracer RayTracer.hh physics/physics.hh
+    /// \brief Intersects rays with the collision geometry of a world,
+    /// without the physics engine or a renderer.
+    ///
+    /// Update copies the shapes and their poses, and builds a bounding
+    /// volume hierarchy over them. Triangle meshes and heightmaps have
+    /// their own hierarchy, built once per mesh and kept across updates.
+    /// Intersect only reads this copy, so many threads can cast rays at
+    /// once, while the world keeps running.
+    class RayTracer
+    {
+      /// \brief Constructor.
+      /// \param[in] _world World whose collisions are traced.
+      public: explicit RayTracer(WorldPtr _world);
+
+      /// \brief Destructor.
+      public: virtual ~RayTracer();
+
+      /// \brief Copy the current shapes and poses of the collisions.
+      /// Must not be called while rays are being cast.
+      public: void Update();
+
+      /// \brief Get the number of shapes found by the last Update.
+      /// \return Number of shapes, including planes.
+      public: unsigned int GetShapeCount() const;
+
+      /// \brief Find the nearest intersection of a ray.
+      /// \param[in] _origin Start of the ray in the world frame.
+      /// \param[in] _dir Unit direction of the ray in the world frame.
+      /// \param[in] _minDist Intersections closer than this are ignored.
+      /// \param[in,out] _dist Maximum distance as input, distance of the
+      /// intersection as output.
+      /// \param[out] _collision Collision that was hit, may be NULL.
+      /// \return True if the ray hits a shape within the distances.
+      public: bool Intersect(const double _origin[3], const double _dir[3],
+                             double _minDist, double &_dist,
+                             Collision **_collision = NULL) const;
+
+      /// \brief Find the nearest intersection of a ray.
+      /// \param[in] _origin Start of the ray in the world frame.
+      /// \param[in] _dir Unit direction of the ray in the world frame.
+      /// \param[in] _minDist Intersections closer than this are ignored.
+      /// \param[in,out] _dist Maximum distance as input, distance of the
+      /// intersection as output.
+      /// \return True if the ray hits a shape within the distances.
+      public: bool Intersect(const math::Vector3 &_origin,
+                             const math::Vector3 &_dir,
+                             double _minDist, double &_dist) const;
+
+      /// \brief Find the nearest intersections of four rays from one
+      /// origin. The distances are the same as those of Intersect. With
+      /// SSE2, the bounds of the hierarchy are tested for the four rays at
+      /// once, which is faster when the rays are close together, like
+      /// neighbor pixels of a camera.
+      /// \param[in] _origin Start of the rays in the world frame.
+      /// \param[in] _dirs Unit directions of the rays in the world frame,
+      /// three values per ray.
+      /// \param[in] _minDist Intersections closer than this are ignored,
+      /// one value per ray.
+      /// \param[in,out] _dist Maximum distance of each ray as input,
+      /// distance of its intersection as output.
+      public: void IntersectPacket(const double _origin[3],
+                                   const double _dirs[12],
+                                   const double _minDist[4],
+                                   double _dist[4]) const;
+
+      /// \brief Add a collision to the shapes.
+      /// \param[in] _collision The collision.
+      /// \param[in] _usedMeshes Keys of the meshes used by the shapes.
+      private: void AddCollision(CollisionPtr _collision,
+                                 std::map<std::string, bool> &_usedMeshes);
+
+      /// \brief World whose collisions are traced.
+      private: WorldPtr world;
+
+      /// \brief Shapes with a bounded size.
+      private: std::vector<RayTracerObject> objects;
+
+      /// \brief Planes, which have no bounds and are always tested.
+      private: std::vector<RayTracerObject> planes;
+
+      /// \brief Hierarchy over the shapes.
+      private: std::vector<RayTracerNode> nodes;
+
+      /// \brief Shapes in the order of the leaves of the hierarchy.
+      private: std::vector<unsigned int> order;
+
+      /// \brief Triangle data, by mesh key.
+      private: std::map<std::string,
+               boost::shared_ptr<RayTracerMesh> > meshes;
+    };
+    /// \}
+  }
+}
+#endif
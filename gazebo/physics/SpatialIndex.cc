@@ -0,0 +1,436 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <math.h>
+#include <algorithm>
+#include <utility>
+
+#include <ann/ANN.h>
+
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/PlaneShape.hh"
+#include "gazebo/physics/SpatialIndex.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Collisions with a larger horizontal half diagonal are not put
+/// in a tree, so they don't widen the searches below a point.
+static const double SpatialIndexLargeSize = 50.0;
+
+/// \brief Default simulation time between the builds of the moving trees.
+static const double SpatialIndexRebuildPeriod = 0.1;
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief kd-tree over points of 2 or 3 dimensions.
+    ///
+    /// The searches of ANN share global state, so the searches of all the
+    /// trees are serialized by one mutex.
+    class SpatialTree
+    {
+      /// \brief Constructor.
+      /// \param[in] _dim 2 to only use the x and y of the points.
+      /// \param[in] _points The points, copied.
+      public: SpatialTree(int _dim, const std::vector<math::Vector3> &_points)
+              : dim(_dim), count(_points.size()), points(NULL), tree(NULL)
+              {
+                if (this->count == 0)
+                  return;
+
+                this->points = annAllocPts(this->count, this->dim);
+                for (int i = 0; i < this->count; ++i)
+                {
+                  this->points[i][0] = _points[i].x;
+                  this->points[i][1] = _points[i].y;
+                  if (this->dim > 2)
+                    this->points[i][2] = _points[i].z;
+                }
+                this->tree = new ANNkd_tree(this->points, this->count,
+                                            this->dim);
+              }
+
+      /// \brief Destructor.
+      public: ~SpatialTree()
+              {
+                delete this->tree;
+                if (this->points)
+                  annDeallocPts(this->points);
+              }
+
+      /// \brief Get the points within a distance of a point.
+      /// \param[in] _pt The point.
+      /// \param[in] _radius The distance.
+      /// \param[out] _indices Indices of the points, appended.
+      public: void GetInRadius(const math::Vector3 &_pt, double _radius,
+                               std::vector<int> &_indices)
+              {
+                if (!this->tree)
+                  return;
+
+                ANNcoord query[3] = {_pt.x, _pt.y, _pt.z};
+                ANNdist sqRadius = _radius * _radius;
+                boost::mutex::scoped_lock lock(searchMutex);
+
+                // Count first, then get them all
+                int found = this->tree->annkFRSearch(query, sqRadius, 0);
+                if (found == 0)
+                  return;
+
+                std::vector<ANNidx> indices(found);
+                std::vector<ANNdist> dists(found);
+                this->tree->annkFRSearch(query, sqRadius, found,
+                                         &indices[0], &dists[0]);
+                for (int i = 0; i < found; ++i)
+                {
+                  if (indices[i] != ANN_NULL_IDX)
+                    _indices.push_back(indices[i]);
+                }
+              }
+
+      /// \brief Get the points nearest to a point.
+      /// \param[in] _pt The point.
+      /// \param[in] _count Maximum number of points.
+      /// \param[out] _result Squared distances and indices of the points,
+      /// appended.
+      public: void GetNearest(const math::Vector3 &_pt, unsigned int _count,
+                              std::vector<std::pair<double, int> > &_result)
+              {
+                int k = std::min(static_cast<int>(_count), this->count);
+                if (!this->tree || k == 0)
+                  return;
+
+                ANNcoord query[3] = {_pt.x, _pt.y, _pt.z};
+                std::vector<ANNidx> indices(k);
+                std::vector<ANNdist> dists(k);
+                boost::mutex::scoped_lock lock(searchMutex);
+                this->tree->annkSearch(query, k, &indices[0], &dists[0]);
+                for (int i = 0; i < k; ++i)
+                  _result.push_back(std::make_pair(dists[i], indices[i]));
+              }
+
+      /// \brief Number of dimensions.
+      private: int dim;
+
+      /// \brief Number of points.
+      private: int count;
+
+      /// \brief The points, which the tree doesn't copy.
+      private: ANNpointArray points;
+
+      /// \brief The tree, NULL if there are no points.
+      private: ANNkd_tree *tree;
+
+      /// \brief Serializes the searches of all the trees.
+      private: static boost::mutex searchMutex;
+    };
+
+    boost::mutex SpatialTree::searchMutex;
+  }
+}
+
+//////////////////////////////////////////////////
+SpatialIndex::SpatialIndex(World *_world)
+  : world(_world), rebuildPeriod(SpatialIndexRebuildPeriod), invalid(true),
+    staticMoved(false), built(false),
+    staticLinkTree(NULL), movingLinkTree(NULL), staticCollisionTree(NULL),
+    staticCollisionRadius(0.0), movingCollisionTree(NULL),
+    movingCollisionRadius(0.0)
+{
+}
+
+//////////////////////////////////////////////////
+SpatialIndex::~SpatialIndex()
+{
+  delete this->staticLinkTree;
+  delete this->movingLinkTree;
+  delete this->staticCollisionTree;
+  delete this->movingCollisionTree;
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::SetRebuildPeriod(double _period)
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+  this->rebuildPeriod = std::max(_period, 0.0);
+}
+
+//////////////////////////////////////////////////
+double SpatialIndex::GetRebuildPeriod() const
+{
+  return this->rebuildPeriod;
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::Invalidate()
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+  this->invalid = true;
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::StaticMoved()
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+  this->staticMoved = true;
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::GetNearestLinks(const math::Vector3 &_pt,
+                                   unsigned int _count, Link_V &_links)
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+  this->Update(this->rebuildPeriod);
+
+  _links.clear();
+
+  std::vector<std::pair<double, int> > staticResult, movingResult;
+  this->staticLinkTree->GetNearest(_pt, _count, staticResult);
+  this->movingLinkTree->GetNearest(_pt, _count, movingResult);
+
+  // Merge the two lists, using the current positions of the links
+  std::vector<std::pair<double, LinkPtr> > merged;
+  for (unsigned int i = 0; i < staticResult.size(); ++i)
+  {
+    LinkPtr link = this->staticLinks[staticResult[i].second];
+    merged.push_back(std::make_pair(
+          link->GetWorldPose().pos.Distance(_pt), link));
+  }
+  for (unsigned int i = 0; i < movingResult.size(); ++i)
+  {
+    LinkPtr link = this->movingLinks[movingResult[i].second];
+    merged.push_back(std::make_pair(
+          link->GetWorldPose().pos.Distance(_pt), link));
+  }
+  std::sort(merged.begin(), merged.end());
+
+  for (unsigned int i = 0; i < merged.size() && i < _count; ++i)
+    _links.push_back(merged[i].second);
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::GetLinksInRadius(const math::Vector3 &_pt, double _radius,
+                                    Link_V &_links)
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+  this->Update(this->rebuildPeriod);
+
+  _links.clear();
+
+  std::vector<int> indices;
+  this->staticLinkTree->GetInRadius(_pt, _radius, indices);
+  for (unsigned int i = 0; i < indices.size(); ++i)
+    _links.push_back(this->staticLinks[indices[i]]);
+
+  indices.clear();
+  this->movingLinkTree->GetInRadius(_pt, _radius, indices);
+  for (unsigned int i = 0; i < indices.size(); ++i)
+  {
+    LinkPtr link = this->movingLinks[indices[i]];
+    if (link->GetWorldPose().pos.Distance(_pt) <= _radius)
+      _links.push_back(link);
+  }
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::GetCollisionsBelowPoint(const math::Vector3 &_pt,
+                                           Collision_V &_collisions)
+{
+  // A collision must not be missed, see World::GetEntityBelowPoint
+  boost::mutex::scoped_lock lock(this->mutex);
+  this->Update(0.0);
+
+  _collisions.clear();
+
+  Collision_V candidates;
+  std::vector<int> indices;
+  this->staticCollisionTree->GetInRadius(_pt, this->staticCollisionRadius,
+                                         indices);
+  for (unsigned int i = 0; i < indices.size(); ++i)
+    candidates.push_back(this->staticCollisions[indices[i]]);
+
+  indices.clear();
+  this->movingCollisionTree->GetInRadius(_pt, this->movingCollisionRadius,
+                                         indices);
+  for (unsigned int i = 0; i < indices.size(); ++i)
+    candidates.push_back(this->movingCollisions[indices[i]]);
+
+  candidates.insert(candidates.end(), this->staticLargeCollisions.begin(),
+                    this->staticLargeCollisions.end());
+  candidates.insert(candidates.end(), this->movingLargeCollisions.begin(),
+                    this->movingLargeCollisions.end());
+
+  // Highest first
+  std::vector<std::pair<double, unsigned int> > below;
+  for (unsigned int i = 0; i < candidates.size(); ++i)
+  {
+    double height;
+    if (GetHeightBelowPoint(candidates[i], _pt, height))
+      below.push_back(std::make_pair(-height, i));
+  }
+  std::sort(below.begin(), below.end());
+
+  for (unsigned int i = 0; i < below.size(); ++i)
+    _collisions.push_back(candidates[below[i].second]);
+}
+
+//////////////////////////////////////////////////
+CollisionPtr SpatialIndex::GetCollisionBelowPoint(const math::Vector3 &_pt)
+{
+  Collision_V collisions;
+  this->GetCollisionsBelowPoint(_pt, collisions);
+  if (collisions.empty())
+    return CollisionPtr();
+
+  return collisions[0];
+}
+
+//////////////////////////////////////////////////
+unsigned int SpatialIndex::GetLinkCount()
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+  this->Update(this->rebuildPeriod);
+
+  return this->staticLinks.size() + this->movingLinks.size();
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::Update(double _period)
+{
+  common::Time simTime = this->world->GetSimTime();
+
+  if (this->invalid || this->staticMoved)
+  {
+    this->Build(true);
+    this->staticMoved = false;
+  }
+
+  // The time goes back when the world is reset
+  double age = (simTime - this->buildTime).Double();
+  if (this->invalid || !this->built ||
+      (simTime != this->buildTime && (age >= _period || age < 0)))
+  {
+    this->Build(false);
+    this->buildTime = simTime;
+    this->built = true;
+  }
+
+  this->invalid = false;
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::Build(bool _static)
+{
+  Link_V &links = _static ? this->staticLinks : this->movingLinks;
+  Collision_V &collisions =
+    _static ? this->staticCollisions : this->movingCollisions;
+  Collision_V &largeCollisions =
+    _static ? this->staticLargeCollisions : this->movingLargeCollisions;
+  SpatialTree *&linkTree = _static ? this->staticLinkTree :
+    this->movingLinkTree;
+  SpatialTree *&collisionTree =
+    _static ? this->staticCollisionTree : this->movingCollisionTree;
+  double &collisionRadius =
+    _static ? this->staticCollisionRadius : this->movingCollisionRadius;
+
+  links.clear();
+  collisions.clear();
+  largeCollisions.clear();
+  collisionRadius = 0;
+
+  std::vector<math::Vector3> linkPositions;
+  std::vector<math::Vector3> collisionCenters;
+
+  Model_V models = this->world->GetModels();
+  for (Model_V::iterator modelIter = models.begin();
+       modelIter != models.end(); ++modelIter)
+  {
+    if ((*modelIter)->IsStatic() != _static)
+      continue;
+
+    Link_V modelLinks = (*modelIter)->GetLinks();
+    for (Link_V::iterator linkIter = modelLinks.begin();
+         linkIter != modelLinks.end(); ++linkIter)
+    {
+      links.push_back(*linkIter);
+      linkPositions.push_back((*linkIter)->GetWorldPose().pos);
+
+      Collision_V linkCollisions = (*linkIter)->GetCollisions();
+      for (Collision_V::iterator iter = linkCollisions.begin();
+           iter != linkCollisions.end(); ++iter)
+      {
+        // Planes have infinite bounds
+        math::Box box = (*iter)->GetBoundingBox();
+        double halfDiagonal = 0.5 * sqrt(
+            box.GetXLength() * box.GetXLength() +
+            box.GetYLength() * box.GetYLength());
+
+        if ((*iter)->GetShape()->HasType(Base::PLANE_SHAPE) ||
+            !(halfDiagonal <= SpatialIndexLargeSize))
+        {
+          largeCollisions.push_back(*iter);
+        }
+        else
+        {
+          collisions.push_back(*iter);
+          collisionCenters.push_back(box.GetCenter());
+          collisionRadius = std::max(collisionRadius, halfDiagonal);
+        }
+      }
+    }
+  }
+
+  delete linkTree;
+  linkTree = new SpatialTree(3, linkPositions);
+  delete collisionTree;
+  collisionTree = new SpatialTree(2, collisionCenters);
+}
+
+//////////////////////////////////////////////////
+bool SpatialIndex::GetHeightBelowPoint(CollisionPtr _collision,
+                                       const math::Vector3 &_pt,
+                                       double &_height)
+{
+  ShapePtr shape = _collision->GetShape();
+  if (shape->HasType(Base::PLANE_SHAPE))
+  {
+    math::Pose pose = _collision->GetWorldPose();
+    math::Vector3 normal = pose.rot.RotateVector(
+        boost::static_pointer_cast<PlaneShape>(shape)->GetNormal());
+    if (fabs(normal.z) < 1e-6)
+      return false;
+
+    _height = pose.pos.z - (normal.x * (_pt.x - pose.pos.x) +
+                            normal.y * (_pt.y - pose.pos.y)) / normal.z;
+    return _height <= _pt.z;
+  }
+
+  // The highest point of the box that isn't above the point
+  math::Box box = _collision->GetBoundingBox();
+  if (_pt.x < box.min.x || _pt.x > box.max.x ||
+      _pt.y < box.min.y || _pt.y > box.max.y || box.min.z > _pt.z)
+  {
+    return false;
+  }
+
+  _height = std::min(box.max.z, _pt.z);
+  return true;
+}
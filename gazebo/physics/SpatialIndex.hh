@@ -0,0 +1,199 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _SPATIALINDEX_HH_
+#define _SPATIALINDEX_HH_
+
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/math/Box.hh"
+#include "gazebo/math/Vector3.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief kd-tree over points, defined in SpatialIndex.cc.
+    class SpatialTree;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class SpatialIndex SpatialIndex.hh physics/physics.hh
+    /// \brief Proximity queries on the links and collisions of a world.
+    ///
+    /// Link positions and the horizontal centers of the collision
+    /// bounding boxes are kept in kd-trees. Static models have their own
+    /// trees, only built again when models are added or removed, or when
+    /// a static entity is moved with Entity::SetWorldPose. The trees of
+    /// the other models are built again by the first query made after the
+    /// rebuild period, so a world nobody queries pays nothing. Results are
+    /// taken from the positions of the last build, then checked against
+    /// the current ones, so a link that moved close to a point since then
+    /// may be missed.
+    ///
+    /// Queries can be made from any thread.
+    class SpatialIndex
+    {
+      /// \brief Constructor.
+      /// \param[in] _world World whose entities are indexed.
+      public: explicit SpatialIndex(World *_world);
+
+      /// \brief Destructor.
+      public: virtual ~SpatialIndex();
+
+      /// \brief Set how long the positions of moving links are kept.
+      /// \param[in] _period Simulation time in seconds, 0 to build the
+      /// trees again whenever the simulation time has changed. The
+      /// default is 0.1.
+      public: void SetRebuildPeriod(double _period);
+
+      /// \brief Get how long the positions of moving links are kept.
+      /// \return Simulation time in seconds.
+      public: double GetRebuildPeriod() const;
+
+      /// \brief Build all the trees again on the next query. Called by
+      /// the world when models are added or removed.
+      public: void Invalidate();
+
+      /// \brief Build the trees of the static models again on the next
+      /// query. Called when a static entity is moved.
+      public: void StaticMoved();
+
+      /// \brief Get the links nearest to a point.
+      /// \param[in] _pt Point in the world frame.
+      /// \param[in] _count Maximum number of links.
+      /// \param[out] _links The links, nearest first.
+      public: void GetNearestLinks(const math::Vector3 &_pt,
+                                   unsigned int _count, Link_V &_links);
+
+      /// \brief Get the links whose origin is within a distance of a point.
+      /// \param[in] _pt Point in the world frame.
+      /// \param[in] _radius The distance.
+      /// \param[out] _links The links, in no particular order.
+      public: void GetLinksInRadius(const math::Vector3 &_pt, double _radius,
+                                    Link_V &_links);
+
+      /// \brief Get the collisions that may be below a point.
+      ///
+      /// These are the collisions whose bounding box is under the point
+      /// or around it, highest box first. Planes are intersected exactly.
+      /// The rebuild period doesn't apply: the trees of the moving models
+      /// are built again whenever the simulation time has changed.
+      /// The shapes are not tested, so a collision may be listed even if
+      /// a ray cast down from the point would miss it, but a collision
+      /// that isn't listed is not below the point.
+      /// \param[in] _pt Point in the world frame.
+      /// \param[out] _collisions The collisions.
+      public: void GetCollisionsBelowPoint(const math::Vector3 &_pt,
+                                           Collision_V &_collisions);
+
+      /// \brief Get the collision below a point.
+      ///
+      /// The collision is the first one of GetCollisionsBelowPoint, whose
+      /// bounding box is the highest.
+      /// \param[in] _pt Point in the world frame.
+      /// \return The collision, NULL if there is none.
+      public: CollisionPtr GetCollisionBelowPoint(const math::Vector3 &_pt);
+
+      /// \brief Get the number of indexed links.
+      /// \return Number of links.
+      public: unsigned int GetLinkCount();
+
+      /// \brief Build the trees that are out of date. The mutex must be
+      /// locked.
+      /// \param[in] _period How long the positions of moving links are
+      /// kept, in seconds of simulation time.
+      private: void Update(double _period);
+
+      /// \brief Fill the trees of the static or of the moving entities.
+      /// \param[in] _static True for the static entities.
+      private: void Build(bool _static);
+
+      /// \brief Get the height of a collision below a point.
+      /// \param[in] _collision The collision.
+      /// \param[in] _pt Point in the world frame.
+      /// \param[out] _height Height of the collision under the point.
+      /// \return False if the collision is not below the point.
+      private: static bool GetHeightBelowPoint(CollisionPtr _collision,
+                   const math::Vector3 &_pt, double &_height);
+
+      /// \brief World whose entities are indexed.
+      private: World *world;
+
+      /// \brief Simulation time between the builds of the moving trees.
+      private: double rebuildPeriod;
+
+      /// \brief True if all the trees must be built again.
+      private: bool invalid;
+
+      /// \brief True if the trees of the static models must be built
+      /// again.
+      private: bool staticMoved;
+
+      /// \brief Simulation time of the last build of the moving trees.
+      private: common::Time buildTime;
+
+      /// \brief True if the moving trees were built at least once.
+      private: bool built;
+
+      /// \brief Links of static models.
+      private: Link_V staticLinks;
+
+      /// \brief Tree over staticPositions.
+      private: SpatialTree *staticLinkTree;
+
+      /// \brief Links of the other models.
+      private: Link_V movingLinks;
+
+      /// \brief Tree over the origins of movingLinks.
+      private: SpatialTree *movingLinkTree;
+
+      /// \brief Static collisions of a bounded size.
+      private: Collision_V staticCollisions;
+
+      /// \brief Tree over the horizontal centers of staticCollisions.
+      private: SpatialTree *staticCollisionTree;
+
+      /// \brief Largest horizontal half diagonal of staticCollisions.
+      private: double staticCollisionRadius;
+
+      /// \brief Moving collisions of a bounded size.
+      private: Collision_V movingCollisions;
+
+      /// \brief Tree over the horizontal centers of movingCollisions.
+      private: SpatialTree *movingCollisionTree;
+
+      /// \brief Largest horizontal half diagonal of movingCollisions.
+      private: double movingCollisionRadius;
+
+      /// \brief Static planes and very large collisions, always tested.
+      private: Collision_V staticLargeCollisions;
+
+      /// \brief Moving planes and very large collisions, always tested.
+      private: Collision_V movingLargeCollisions;
+
+      /// \brief Protects the trees.
+      private: boost::mutex mutex;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "test/ServerFixture.hh"
+#include "gazebo/transport/Transport.hh"
+#include "gazebo/physics/SpatialIndex.hh"
+
+using namespace gazebo;
+
+class SpatialIndexTest : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(SpatialIndexTest, Queries)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  physics::SpatialIndexPtr index = world->GetSpatialIndex();
+  ASSERT_TRUE(index != NULL);
+
+  // The ground plane
+  EXPECT_EQ(index->GetLinkCount(), 1u);
+
+  // A grid of static boxes, 2 m apart
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      std::ostringstream name;
+      name << "box_" << i << "_" << j;
+      SpawnBox(name.str(), math::Vector3(0.5, 0.5, 0.5),
+               math::Vector3(10 + 2 * i, 10 + 2 * j, 0.25),
+               math::Vector3(0, 0, 0), true);
+    }
+  }
+  SpawnBox("moving", math::Vector3(0.5, 0.5, 0.5),
+           math::Vector3(20, 20, 0.25), math::Vector3(0, 0, 0));
+
+  EXPECT_EQ(index->GetLinkCount(), 11u);
+
+  // Nearest links
+  physics::Link_V links;
+  index->GetNearestLinks(math::Vector3(12.2, 11.9, 0.25), 2, links);
+  ASSERT_EQ(links.size(), 2u);
+  EXPECT_EQ(links[0]->GetModel()->GetName(), "box_1_1");
+
+  // The center box and its four neighbors
+  index->GetLinksInRadius(math::Vector3(12, 12, 0.25), 2.1, links);
+  EXPECT_EQ(links.size(), 5u);
+
+  index->GetLinksInRadius(math::Vector3(30, 30, 0.25), 1.0, links);
+  EXPECT_TRUE(links.empty());
+
+  // Below point
+  physics::ModelPtr model = world->GetModelBelowPoint(
+      math::Vector3(12, 12, 5));
+  ASSERT_TRUE(model != NULL);
+  EXPECT_EQ(model->GetName(), "box_1_1");
+
+  model = world->GetModelBelowPoint(math::Vector3(50, 50, 5));
+  ASSERT_TRUE(model != NULL);
+  EXPECT_EQ(model->GetName(), "ground_plane");
+
+  // Moved links are found once the rebuild period has passed
+  world->GetModel("moving")->SetWorldPose(math::Pose(30, 30, 0.25, 0, 0, 0));
+  world->GetModel("box_0_0")->SetWorldPose(math::Pose(40, 40, 0.25, 0, 0, 0));
+  world->StepWorld(200);
+
+  index->GetLinksInRadius(math::Vector3(30, 30, 0.25), 1.0, links);
+  ASSERT_EQ(links.size(), 1u);
+  EXPECT_EQ(links[0]->GetModel()->GetName(), "moving");
+
+  index->GetLinksInRadius(math::Vector3(40, 40, 0.25), 1.0, links);
+  ASSERT_EQ(links.size(), 1u);
+  EXPECT_EQ(links[0]->GetModel()->GetName(), "box_0_0");
+
+  // Removed models are no longer found
+  transport::requestNoReply(world->GetName(), "entity_delete", "moving");
+  int waitCount = 0;
+  while (HasEntity("moving") && ++waitCount < 500)
+    common::Time::MSleep(10);
+  ASSERT_FALSE(HasEntity("moving"));
+
+  EXPECT_EQ(index->GetLinkCount(), 10u);
+  index->GetLinksInRadius(math::Vector3(30, 30, 0.25), 1.0, links);
+  EXPECT_TRUE(links.empty());
+
+  // Above the corner of the bounding box of a sphere, but not above the
+  // sphere: the index lists the sphere, and the ray cast misses it
+  SpawnSphere("ball", math::Vector3(30, 10, 1), math::Vector3(0, 0, 0),
+              math::Vector3(0, 0, 0), 1.0, true, true);
+  physics::Collision_V collisions;
+  index->GetCollisionsBelowPoint(math::Vector3(30.9, 10.9, 5), collisions);
+  ASSERT_EQ(collisions.size(), 2u);
+  EXPECT_EQ(collisions[0]->GetModel()->GetName(), "ball");
+  EXPECT_EQ(collisions[1]->GetModel()->GetName(), "ground_plane");
+
+  model = world->GetModelBelowPoint(math::Vector3(30.9, 10.9, 5));
+  ASSERT_TRUE(model != NULL);
+  EXPECT_EQ(model->GetName(), "ground_plane");
+
+  model = world->GetModelBelowPoint(math::Vector3(30, 10, 5));
+  ASSERT_TRUE(model != NULL);
+  EXPECT_EQ(model->GetName(), "ball");
+}
+
+/////////////////////////////////////////////////
+TEST_F(SpatialIndexTest, RebuildPeriod)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  physics::SpatialIndexPtr index = world->GetSpatialIndex();
+  ASSERT_TRUE(index != NULL);
+  EXPECT_DOUBLE_EQ(index->GetRebuildPeriod(), 0.1);
+
+  SpawnBox("moving", math::Vector3(0.5, 0.5, 0.5),
+           math::Vector3(0, 5, 0.25), math::Vector3(0, 0, 0));
+  SpawnBox("wall", math::Vector3(0.5, 0.5, 0.5),
+           math::Vector3(10, 10, 0.25), math::Vector3(0, 0, 0), true);
+
+  physics::Link_V links;
+  index->GetLinksInRadius(math::Vector3(20, 20, 0.25), 1.0, links);
+  EXPECT_TRUE(links.empty());
+
+  // A query between rebuilds uses the positions of the last build, and
+  // checks them against the current ones
+  world->GetModel("moving")->SetWorldPose(math::Pose(20, 20, 0.25, 0, 0, 0));
+  world->StepWorld(1);
+  index->GetLinksInRadius(math::Vector3(20, 20, 0.25), 1.0, links);
+  EXPECT_TRUE(links.empty());
+  index->GetLinksInRadius(math::Vector3(0, 5, 0.25), 1.0, links);
+  EXPECT_TRUE(links.empty());
+
+  // Moving a static model builds the static trees again, and only them
+  world->GetModel("wall")->SetWorldPose(math::Pose(25, 25, 0.25, 0, 0, 0));
+  index->GetLinksInRadius(math::Vector3(25, 25, 0.25), 1.0, links);
+  ASSERT_EQ(links.size(), 1u);
+  EXPECT_EQ(links[0]->GetModel()->GetName(), "wall");
+  index->GetLinksInRadius(math::Vector3(20, 20, 0.25), 1.0, links);
+  EXPECT_TRUE(links.empty());
+
+  // Once the period has passed
+  world->StepWorld(100);
+  index->GetLinksInRadius(math::Vector3(20, 20, 0.25), 1.0, links);
+  ASSERT_EQ(links.size(), 1u);
+  EXPECT_EQ(links[0]->GetModel()->GetName(), "moving");
+
+  // Without a period, every change of the simulation time
+  index->SetRebuildPeriod(0);
+  world->GetModel("moving")->SetWorldPose(math::Pose(0, -5, 0.25, 0, 0, 0));
+  world->StepWorld(1);
+  index->GetLinksInRadius(math::Vector3(0, -5, 0.25), 1.0, links);
+  ASSERT_EQ(links.size(), 1u);
+  EXPECT_EQ(links[0]->GetModel()->GetName(), "moving");
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -19,6 +19,9 @@
  * Date: 16 Oct 2009
  */
 
+#include <iomanip>
+#include <sstream>
+
 #include "common/Common.hh"
 #include "common/MeshManager.hh"
 #include "common/Mesh.hh"
@@ -133,6 +136,65 @@ void TrimeshShape::SetMesh(const std::string &_uri,
   this->Init();
 }
 
+//////////////////////////////////////////////////
+std::string TrimeshShape::GetMeshKey() const
+{
+  if (!this->mesh)
+    return std::string();
+
+  std::ostringstream stream;
+  stream << this->mesh->GetName();
+
+  if (this->sdf->HasElement("submesh"))
+  {
+    sdf::ElementPtr submeshElem = this->sdf->GetElement("submesh");
+    stream << "::" << submeshElem->GetValueString("name");
+    if (submeshElem->HasElement("center"))
+      stream << "::center";
+  }
+
+  math::Vector3 scale = this->sdf->GetValueVector3("scale");
+  stream << "::" << std::setprecision(17) << scale.x << " " << scale.y
+         << " " << scale.z;
+
+  return stream.str();
+}
+
+//////////////////////////////////////////////////
+void TrimeshShape::FillTriangles(std::vector<float> &_vertices,
+                                 std::vector<int> &_indices) const
+{
+  _vertices.clear();
+  _indices.clear();
+  if (!this->mesh)
+    return;
+
+  unsigned int numVertices = this->submesh ?
+    this->submesh->GetVertexCount() : this->mesh->GetVertexCount();
+  unsigned int numIndices = this->submesh ?
+    this->submesh->GetIndexCount() : this->mesh->GetIndexCount();
+
+  float *vertices = NULL;
+  int *indices = NULL;
+  if (this->submesh)
+    this->submesh->FillArrays(&vertices, &indices);
+  else
+    this->mesh->FillArrays(&vertices, &indices);
+
+  math::Vector3 scale = this->sdf->GetValueVector3("scale");
+  _vertices.resize(numVertices * 3);
+  for (unsigned int i = 0; i < numVertices; ++i)
+  {
+    _vertices[i*3+0] = vertices[i*3+0] * scale.x;
+    _vertices[i*3+1] = vertices[i*3+1] * scale.y;
+    _vertices[i*3+2] = vertices[i*3+2] * scale.z;
+  }
+  _indices.assign(indices, indices + numIndices);
+
+  delete [] vertices;
+  delete [] indices;
+}
+
 //////////////////////////////////////////////////
 void TrimeshShape::FillMsg(msgs::Geometry &_msg)
 {
@@ -23,6 +23,7 @@
 #define _TRIMESHSHAPE_HH_
 
 #include <string>
+#include <vector>
 
 #include "gazebo/common/CommonTypes.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
@@ -92,6 +93,18 @@ namespace gazebo
       /// \param[in] _msg Message that contains triangle mesh info.
       public: virtual void ProcessMsg(const msgs::Geometry &_msg);
 
+      /// \brief Get a key that identifies the triangle data used by this
+      /// shape. Shapes with the same key use the same mesh, submesh and
+      /// scale, so physics engines can share their collision data.
+      /// \return The key, empty if no mesh is loaded.
+      public: std::string GetMeshKey() const;
+
+      /// \brief Get the triangles of the mesh, scaled.
+      /// \param[out] _vertices Array of x, y, z vertex values.
+      /// \param[out] _indices Array of vertex indices, three per triangle.
+      public: void FillTriangles(std::vector<float> &_vertices,
+                                 std::vector<int> &_indices) const;
+
       /// \brief Pointer to the mesh data.
       protected: const common::Mesh *mesh;
 
@@ -20,6 +20,8 @@
 
 #include <time.h>
 
+#include <algorithm>
+
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range.h>
 
@@ -44,6 +46,8 @@
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Plugin.hh"
+#include "gazebo/common/SnapshotBuffer.hh"
+#include "gazebo/common/Trace.hh"
 
 #include "gazebo/util/Diagnostics.hh"
 
@@ -54,6 +58,7 @@
 #include "gazebo/physics/PhysicsFactory.hh"
 #include "gazebo/physics/Model.hh"
 #include "gazebo/physics/Actor.hh"
+#include "gazebo/physics/SpatialIndex.hh"
 #include "gazebo/physics/World.hh"
 
 #include "physics/Collision.hh"
@@ -62,6 +67,38 @@
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Start of a world snapshot, changed when its layout changes.
+static const uint32_t SnapshotMagic = 0x475a5301;
+
+boost::mutex World::updateEventMutex;
+
+/// \brief Names of the step phases, in World::StepPhase order.
+static const char *StepPhaseNames[] =
+  {"models", "collision", "solver", "contacts", "logging", "messages"};
+
+//////////////////////////////////////////////////
+/// \brief Get a monotonic wall time in nanoseconds, used to time the steps.
+static uint64_t getMonotonicTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+//////////////////////////////////////////////////
+/// \brief Fill a timing message from a histogram of nanoseconds.
+static void fillTiming(msgs::WorldStatistics::Timing *_msg,
+                       const std::string &_name,
+                       const common::Histogram &_histogram)
+{
+  _msg->set_name(_name);
+  _msg->set_count(_histogram.GetCount());
+  _msg->set_mean(_histogram.GetMean() * 1e-9);
+  _msg->set_p50(_histogram.GetPercentile(50) * 1e-9);
+  _msg->set_p95(_histogram.GetPercentile(95) * 1e-9);
+  _msg->set_p99(_histogram.GetPercentile(99) * 1e-9);
+  _msg->set_max(_histogram.GetMax() * 1e-9);
+}
 
 class ModelUpdate_TBB
 {
@@ -115,9 +152,17 @@ World::World(const std::string &_name)
 
   this->sleepOffset = common::Time(0);
 
+  this->stepOverruns = 0;
+  this->prevStepStart = 0;
+
   this->prevStatTime = common::Time::GetWallTime();
   this->prevProcessMsgsTime = common::Time::GetWallTime();
 
+  this->compactPositionResolution = 1e-4;
+  this->compactOrientationResolution = 1.0 / 32767;
+  this->compactLinearThreshold = 1e-4;
+  this->compactAngularThreshold = 1e-4;
+
   this->connections.push_back(
      event::Events::ConnectStep(boost::bind(&World::OnStep, this)));
   this->connections.push_back(
@@ -172,6 +217,8 @@ void World::Load(sdf::ElementPtr _sdf)
   this->node->Init(this->GetName());
 
   this->posePub = this->node->Advertise<msgs::Pose_V>("~/pose/info", 10, 60.0);
+  this->compactPosePub =
+    this->node->Advertise<msgs::CompactPoses>("~/pose/compact", 10);
 
   this->guiPub = this->node->Advertise<msgs::GUI>("~/gui");
   if (this->sdf->HasElement("gui"))
@@ -289,6 +336,8 @@ void World::Init()
   this->testRay = boost::dynamic_pointer_cast<RayShape>(
       this->GetPhysicsEngine()->CreateShape("ray", CollisionPtr()));
 
+  this->spatialIndex.reset(new SpatialIndex(this));
+
   common::LogRecord::Instance()->Add(this->GetName(), "state.log",
       boost::bind(&World::OnLog, this, _1));
 
@@ -333,6 +382,8 @@ void World::Stop()
 //////////////////////////////////////////////////
 void World::RunLoop()
 {
+  common::Trace::SetThreadName("world " + this->GetName());
+
   this->physicsEngine->InitForThread();
 
   this->startTime = common::Time::GetWallTime();
@@ -425,7 +476,7 @@ void World::LogStep()
 //////////////////////////////////////////////////
 void World::Step()
 {
-  DIAG_TIMER_START("World::Step");
+  GZ_TRACE_SCOPE("World::Step");
 
   /// need this because ODE does not call dxReallocateWorldProcessContext()
   /// until dWorld.*Step
@@ -438,16 +489,13 @@ void World::Step()
     this->pluginsLoaded = true;
   }
 
-  DIAG_TIMER_LAP("World::Step", "loadPlugins");
-
   // Send statistics about the world simulation
   if (common::Time::GetWallTime() - this->prevStatTime > this->statPeriod)
   {
+    GZ_TRACE_SCOPE("World::PublishWorldStats");
     this->PublishWorldStats();
   }
 
-  DIAG_TIMER_LAP("World::Step", "publishWorldStats");
-
   double updatePeriod = this->physicsEngine->GetUpdatePeriod();
   // sleep here to get the correct update rate
   common::Time tmpTime = common::Time::GetWallTime();
@@ -457,6 +505,7 @@ void World::Step()
   common::Time actualSleep = 0;
   if (sleepTime > 0)
   {
+    GZ_TRACE_SCOPE("World::Step::sleep");
     common::Time::Sleep(sleepTime);
     actualSleep = common::Time::GetWallTime() - tmpTime;
   }
@@ -467,39 +516,57 @@ void World::Step()
   this->sleepOffset = (actualSleep - sleepTime) * 0.01 +
                       this->sleepOffset * 0.99;
 
-  DIAG_TIMER_LAP("World::Step", "sleepOffset");
+  // Start of the step, zero if the world does not step
+  uint64_t stepStart = 0;
 
   // throttling update rate, with sleepOffset as tolerance
   // the tolerance is needed as the sleep time is not exact
   if (common::Time::GetWallTime() - this->prevStepWallTime + this->sleepOffset
          >= common::Time(updatePeriod))
   {
+    GZ_TRACE_BEGIN("World::Step::worldUpdateMutex");
     boost::recursive_mutex::scoped_lock lock(*this->worldUpdateMutex);
-
-    DIAG_TIMER_LAP("World::Step", "worldUpdateMutex");
+    GZ_TRACE_END("World::Step::worldUpdateMutex");
 
     this->prevStepWallTime = common::Time::GetWallTime();
 
     double stepTime = this->physicsEngine->GetMaxStepSize();
     if (!this->IsPaused() || this->stepInc > 0)
     {
+      stepStart = getMonotonicTime();
+
+      // Only steps of a running world have a meaningful period
+      if (this->prevStepStart > 0 && !this->IsPaused())
+        this->stepPeriods.Add(stepStart - this->prevStepStart);
+      this->prevStepStart = this->IsPaused() ? 0 : stepStart;
+
       // query timestep to allow dynamic time step size updates
       this->simTime += stepTime;
       this->iterations++;
       this->Update();
 
-      DIAG_TIMER_LAP("World::Step", "update");
-
       if (this->IsPaused() && this->stepInc > 0)
         this->stepInc--;
     }
     else
+    {
       this->pauseTime += stepTime;
+      this->prevStepStart = 0;
+    }
   }
 
+  uint64_t messagesStart = getMonotonicTime();
   this->ProcessMessages();
 
-  DIAG_TIMER_STOP("World::Step");
+  if (stepStart > 0)
+  {
+    uint64_t stepEnd = getMonotonicTime();
+    this->phaseTimes[PHASE_MESSAGES].Add(stepEnd - messagesStart);
+    this->stepTimes.Add(stepEnd - stepStart);
+
+    if (updatePeriod > 0 && (stepEnd - stepStart) * 1e-9 > updatePeriod)
+      this->stepOverruns++;
+  }
 }
 
 //////////////////////////////////////////////////
@@ -527,10 +594,52 @@ void World::StepWorld(int _steps)
   }
 }
 
+//////////////////////////////////////////////////
+bool World::RunBatch(unsigned int _steps)
+{
+  if (this->thread)
+  {
+    gzerr << "World[" << this->GetName() << "] is running in its own "
+          << "thread, unable to step it in a batch\n";
+    return false;
+  }
+
+  boost::recursive_mutex::scoped_lock lock(*this->worldUpdateMutex);
+
+  // A world stopped to leave its own thread can still be stepped in a
+  // batch
+  this->stop = false;
+
+  // The calling thread may be a pool thread that never stepped a world
+  this->physicsEngine->InitForThread();
+
+  if (this->startTime == common::Time::Zero)
+  {
+    this->startTime = common::Time::GetWallTime();
+    this->prevStates[0] = WorldState(shared_from_this());
+    this->stateToggle = 0;
+  }
+
+  if (!this->pluginsLoaded)
+  {
+    this->LoadPlugins();
+    this->pluginsLoaded = true;
+  }
+
+  for (unsigned int i = 0; i < _steps && !this->stop; ++i)
+  {
+    this->simTime += this->physicsEngine->GetMaxStepSize();
+    this->iterations++;
+    this->Update();
+  }
+
+  return true;
+}
+
 //////////////////////////////////////////////////
 void World::Update()
 {
-  DIAG_TIMER_START("World::Update");
+  GZ_TRACE_SCOPE("World::Update");
 
   if (this->needsReset)
   {
@@ -543,24 +652,32 @@ void World::Update()
     this->needsReset = false;
   }
 
-  DIAG_TIMER_LAP("World::Update", "needsReset");
-
-  event::Events::worldUpdateStart();
+  GZ_TRACE_BEGIN("Events::worldUpdateBegin");
   this->updateInfo.simTime = this->GetSimTime();
   this->updateInfo.realTime = this->GetRealTime();
-  event::Events::worldUpdateBegin(this->updateInfo);
-
-  DIAG_TIMER_LAP("World::Update", "Events::worldUpdateBegin");
+  {
+    boost::mutex::scoped_lock lock(World::updateEventMutex);
+    event::Events::worldUpdateStart();
+    event::Events::worldUpdateBegin(this->updateInfo);
+  }
+  GZ_TRACE_END("Events::worldUpdateBegin");
 
   // Update all the models
+  uint64_t phaseStart = getMonotonicTime();
+  GZ_TRACE_BEGIN("Model::Update");
   (*this.*modelUpdateFunc)();
+  GZ_TRACE_END("Model::Update");
 
-  DIAG_TIMER_LAP("World::Update", "Model::Update");
+  uint64_t phaseEnd = getMonotonicTime();
+  this->phaseTimes[PHASE_MODELS].Add(phaseEnd - phaseStart);
+  phaseStart = phaseEnd;
 
   // This must be called before PhysicsEngine::UpdatePhysics.
   this->physicsEngine->UpdateCollision();
 
-  DIAG_TIMER_LAP("World::Update", "PhysicsEngine::UpdateCollision");
+  phaseEnd = getMonotonicTime();
+  this->phaseTimes[PHASE_COLLISION].Add(phaseEnd - phaseStart);
+  phaseStart = phaseEnd;
 
   // Update the physics engine
   if (this->enablePhysicsEngine && this->physicsEngine)
@@ -568,11 +685,10 @@ void World::Update()
     // This must be called directly after PhysicsEngine::UpdateCollision.
     this->physicsEngine->UpdatePhysics();
 
-    DIAG_TIMER_LAP("World::Update", "PhysicsEngine::UpdatePhysics");
-
     // do this after physics update as
     //   ode --> MoveCallback sets the dirtyPoses
     //           and we need to propagate it into Entity::worldPose
+    GZ_TRACE_BEGIN("World::Update::dirtyPoses");
     for (std::list<Entity*>::iterator iter = this->dirtyPoses.begin();
         iter != this->dirtyPoses.end(); ++iter)
     {
@@ -580,18 +696,27 @@ void World::Update()
     }
 
     this->dirtyPoses.clear();
+    GZ_TRACE_END("World::Update::dirtyPoses");
 
-    DIAG_TIMER_LAP("World::Update", "SetWorldPose(dirtyPoses)");
+    phaseEnd = getMonotonicTime();
+    this->phaseTimes[PHASE_SOLVER].Add(phaseEnd - phaseStart);
+    phaseStart = phaseEnd;
   }
 
   // Output the contact information
+  GZ_TRACE_BEGIN("ContactManager::PublishContacts");
   this->physicsEngine->GetContactManager()->PublishContacts();
+  GZ_TRACE_END("ContactManager::PublishContacts");
 
-  DIAG_TIMER_LAP("World::Update", "ContactManager::PublishContacts");
+  phaseEnd = getMonotonicTime();
+  this->phaseTimes[PHASE_CONTACTS].Add(phaseEnd - phaseStart);
 
   // Only update state informatin if logging data.
   if (common::LogRecord::Instance()->GetRunning())
   {
+    GZ_TRACE_SCOPE("World::Update::logState");
+    phaseStart = phaseEnd;
+
     int currState = (this->stateToggle + 1) % 2;
     this->prevStates[currState] = WorldState(shared_from_this());
 
@@ -608,13 +733,12 @@ void World::Update()
       /// Publish a log status message if the logger is running.
       this->PublishLogStatus();
     }
-  }
 
-  DIAG_TIMER_LAP("World::Update", "LogRecord");
+    this->phaseTimes[PHASE_LOGGING].Add(getMonotonicTime() - phaseStart);
+  }
 
+  boost::mutex::scoped_lock lock(World::updateEventMutex);
   event::Events::worldUpdateEnd();
-
-  DIAG_TIMER_STOP("World::Update");
 }
 
 //////////////////////////////////////////////////
@@ -624,9 +748,13 @@ void World::Fini()
   this->plugins.clear();
 
   this->publishModelPoses.clear();
+  this->compactPoseModels.clear();
 
   this->node->Fini();
 
+  // The index holds the links
+  this->spatialIndex.reset();
+
   if (this->rootElement)
   {
     this->rootElement->Fini();
@@ -705,6 +833,9 @@ ModelPtr World::LoadModel(sdf::ElementPtr _sdf , BasePtr _parent)
     this->modelPub->Publish(msg);
 
     this->EnableAllModels();
+
+    if (this->spatialIndex)
+      this->spatialIndex->Invalidate();
   }
   else
   {
@@ -954,6 +1085,35 @@ void World::SetSimTime(const common::Time &_t)
   this->simTime = _t;
 }
 
+//////////////////////////////////////////////////
+uint64_t World::GetIterations() const
+{
+  return this->iterations;
+}
+
+//////////////////////////////////////////////////
+void World::GetPhaseTimes(
+    std::map<std::string, common::Histogram> &_phases) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->worldUpdateMutex);
+
+  _phases.clear();
+  for (unsigned int i = 0; i < PHASE_COUNT; ++i)
+  {
+    if (this->phaseTimes[i].GetCount() > 0)
+      _phases[StepPhaseNames[i]] = this->phaseTimes[i];
+  }
+}
+
+//////////////////////////////////////////////////
+void World::ResetPhaseTimes()
+{
+  boost::recursive_mutex::scoped_lock lock(*this->worldUpdateMutex);
+
+  for (unsigned int i = 0; i < PHASE_COUNT; ++i)
+    this->phaseTimes[i].Reset();
+}
+
 //////////////////////////////////////////////////
 gazebo::common::Time World::GetPauseTime() const
 {
@@ -1261,6 +1421,9 @@ void World::ProcessEntityMsgs()
   {
     this->EnableAllModels();
     this->deleteEntity.clear();
+
+    if (this->spatialIndex)
+      this->spatialIndex->Invalidate();
   }
 }
 
@@ -1585,6 +1748,16 @@ ModelPtr World::GetModelBelowPoint(const math::Vector3 &_pt)
 //////////////////////////////////////////////////
 EntityPtr World::GetEntityBelowPoint(const math::Vector3 &_pt)
 {
+  // The index only compares bounding boxes, so it can rule out a ray cast
+  // but not replace it
+  if (this->spatialIndex)
+  {
+    Collision_V collisions;
+    this->spatialIndex->GetCollisionsBelowPoint(_pt, collisions);
+    if (collisions.empty())
+      return EntityPtr();
+  }
+
   std::string entityName;
   double dist;
   math::Vector3 end;
@@ -1598,6 +1771,12 @@ EntityPtr World::GetEntityBelowPoint(const math::Vector3 &_pt)
   return this->GetEntity(entityName);
 }
 
+//////////////////////////////////////////////////
+SpatialIndexPtr World::GetSpatialIndex() const
+{
+  return this->spatialIndex;
+}
+
 //////////////////////////////////////////////////
 void World::SetState(const WorldState &_state)
 {
@@ -1614,6 +1793,120 @@ void World::SetState(const WorldState &_state)
   }
 }
 
+//////////////////////////////////////////////////
+void World::Snapshot(common::SnapshotBuffer &_buffer)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->worldUpdateMutex);
+
+  _buffer.Clear();
+  _buffer.Write(SnapshotMagic);
+  _buffer.Write(this->simTime);
+  _buffer.Write(this->iterations);
+
+  // The generator holds no pointers, so its bytes are its state
+  const math::GeneratorType &generator = math::Rand::GetGenerator();
+  _buffer.WriteBytes(&generator, sizeof(generator));
+
+  size_t handle = _buffer.BeginBlock();
+  this->physicsEngine->Snapshot(_buffer);
+  _buffer.EndBlock(handle);
+
+  _buffer.Write(static_cast<uint32_t>(this->GetModelCount()));
+  for (unsigned int i = 0; i < this->rootElement->GetChildCount(); ++i)
+  {
+    if (this->rootElement->GetChild(i)->HasType(Base::MODEL))
+    {
+      boost::static_pointer_cast<Model>(
+          this->rootElement->GetChild(i))->Snapshot(_buffer);
+    }
+  }
+
+  _buffer.Write(static_cast<uint32_t>(this->plugins.size()));
+  for (std::vector<WorldPluginPtr>::iterator iter = this->plugins.begin();
+       iter != this->plugins.end(); ++iter)
+  {
+    handle = _buffer.BeginBlock();
+    (*iter)->Snapshot(_buffer);
+    _buffer.EndBlock(handle);
+  }
+}
+
+//////////////////////////////////////////////////
+bool World::Restore(common::SnapshotBuffer &_buffer)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->worldUpdateMutex);
+
+  _buffer.Rewind();
+
+  uint32_t magic = 0;
+  common::Time time;
+  uint64_t iters = 0;
+  math::GeneratorType generator;
+  size_t end = 0;
+  uint32_t modelCount = 0;
+  if (!_buffer.Read(magic) || magic != SnapshotMagic ||
+      !_buffer.Read(time) || !_buffer.Read(iters) ||
+      !_buffer.ReadBytes(&generator, sizeof(generator)) ||
+      !_buffer.ReadBlock(end) || !this->physicsEngine->Restore(_buffer) ||
+      _buffer.GetPosition() != end || !_buffer.Read(modelCount) ||
+      modelCount != this->GetModelCount())
+  {
+    gzerr << "Invalid snapshot of world[" << this->GetName() << "]\n";
+    return false;
+  }
+
+  for (unsigned int i = 0; i < this->rootElement->GetChildCount(); ++i)
+  {
+    if (!this->rootElement->GetChild(i)->HasType(Base::MODEL))
+      continue;
+
+    ModelPtr model = boost::static_pointer_cast<Model>(
+        this->rootElement->GetChild(i));
+    if (!model->Restore(_buffer))
+    {
+      gzerr << "Unable to restore model[" << model->GetName()
+            << "] from a snapshot of world[" << this->GetName() << "]\n";
+      return false;
+    }
+  }
+
+  uint32_t pluginCount = 0;
+  if (!_buffer.Read(pluginCount) || pluginCount != this->plugins.size())
+  {
+    gzerr << "Invalid snapshot of world[" << this->GetName() << "]\n";
+    return false;
+  }
+
+  for (std::vector<WorldPluginPtr>::iterator iter = this->plugins.begin();
+       iter != this->plugins.end(); ++iter)
+  {
+    if (!_buffer.ReadBlock(end))
+      return false;
+
+    (*iter)->Restore(_buffer);
+    if (_buffer.GetPosition() != end)
+    {
+      gzwarn << "Plugin[" << (*iter)->GetHandle() << "] of world["
+             << this->GetName() << "] didn't read back its snapshot\n";
+      _buffer.Seek(end);
+    }
+  }
+
+  math::Rand::SetGenerator(generator);
+
+  // Contacts of the current step don't exist in the restored state
+  this->physicsEngine->GetContactManager()->Clear();
+
+  // Sensors wait for the sim time to pass their last update
+  if (time < this->simTime)
+    sensors::SensorManager::Instance()->ResetLastUpdateTimes();
+
+  this->simTime = time;
+  this->iterations = iters;
+
+  return true;
+}
+
 //////////////////////////////////////////////////
 void World::InsertModelFile(const std::string &_sdfFilename)
 {
@@ -1678,7 +1971,7 @@ void World::UpdateStateSDF()
 bool World::OnLog(std::ostringstream &_stream)
 {
   // Save the entire state when its the first call to OnLog.
-  if (common::LogRecord::Instance()->GetFirstUpdate())
+  if (common::LogRecord::Instance()->GetFirstUpdate(this->GetName()))
   {
     this->UpdateStateSDF();
     _stream << "<sdf version ='";
@@ -1733,6 +2026,8 @@ void World::ProcessMessages()
   }
   this->publishModelPoses.clear();
 
+  this->PublishCompactPoses();
+
 
   if (common::Time::GetWallTime() - this->prevProcessMsgsTime >
       this->processMsgsPeriod)
@@ -1754,6 +2049,38 @@ void World::PublishWorldStats()
   this->worldStatsMsg.set_iterations(this->iterations);
   this->worldStatsMsg.set_paused(this->IsPaused());
 
+  // Step timings since the previous message
+  fillTiming(this->worldStatsMsg.mutable_step_time(), "step",
+             this->stepTimes);
+  fillTiming(this->worldStatsMsg.mutable_step_period(), "period",
+             this->stepPeriods);
+  this->worldStatsMsg.set_step_overruns(this->stepOverruns);
+
+  // The real time factor decreases as the period grows, so its low
+  // percentiles come from the high percentiles of the period.
+  double stepSize = this->physicsEngine->GetMaxStepSize();
+  uint64_t periodP50 = this->stepPeriods.GetPercentile(50);
+  uint64_t periodP95 = this->stepPeriods.GetPercentile(95);
+  this->worldStatsMsg.set_real_time_factor_p50(
+      periodP50 > 0 ? stepSize / (periodP50 * 1e-9) : 0);
+  this->worldStatsMsg.set_real_time_factor_p5(
+      periodP95 > 0 ? stepSize / (periodP95 * 1e-9) : 0);
+
+  this->worldStatsMsg.clear_phase();
+  for (unsigned int i = 0; i < PHASE_COUNT; ++i)
+  {
+    if (this->phaseTimes[i].GetCount() > 0)
+    {
+      fillTiming(this->worldStatsMsg.add_phase(), StepPhaseNames[i],
+                 this->phaseTimes[i]);
+    }
+    this->phaseTimes[i].Reset();
+  }
+
+  this->stepTimes.Reset();
+  this->stepPeriods.Reset();
+  this->stepOverruns = 0;
+
   this->statPub->Publish(this->worldStatsMsg);
   this->prevStatTime = common::Time::GetWallTime();
 }
@@ -1771,6 +2098,131 @@ void World::PublishModelPose(physics::ModelPtr _model)
 
   // Only add if the model name is not in the list
   this->publishModelPoses.insert(_model);
+  this->compactPoseModels.insert(_model);
+}
+
+//////////////////////////////////////////////////
+void World::SetCompactPoseOptions(double _positionResolution,
+                                  double _orientationResolution,
+                                  double _linearThreshold,
+                                  double _angularThreshold)
+{
+  if (_positionResolution <= 0 || _orientationResolution <= 0)
+  {
+    gzerr << "Compact pose resolutions must be positive\n";
+    return;
+  }
+
+  boost::recursive_mutex::scoped_lock lock(*this->receiveMutex);
+  this->compactPositionResolution = _positionResolution;
+  this->compactOrientationResolution = _orientationResolution;
+  this->compactLinearThreshold = std::max(0.0, _linearThreshold);
+  this->compactAngularThreshold = std::max(0.0, _angularThreshold);
+
+  // Subscribers need the poses at the new resolution
+  this->prevCompactKeyFrameTime = common::Time::Zero;
+}
+
+//////////////////////////////////////////////////
+void World::PublishCompactPoses()
+{
+  if (!this->compactPosePub || !this->compactPosePub->HasConnections())
+  {
+    // Start with a key frame once there is a subscriber
+    this->compactPoseModels.clear();
+    this->prevCompactKeyFrameTime = common::Time::Zero;
+    return;
+  }
+
+  // Publish at most 60 times a second. Models that moved in between are
+  // kept for the next message.
+  common::Time now = common::Time::GetWallTime();
+  if ((now - this->prevCompactPoseTime).Double() < 1.0 / 60.0)
+    return;
+  this->prevCompactPoseTime = now;
+
+  msgs::CompactPoses msg;
+  msg.set_position_resolution(this->compactPositionResolution);
+  msg.set_orientation_resolution(this->compactOrientationResolution);
+
+  // Key frames let new subscribers learn the names, and replace poses
+  // dropped by subscribers that only keep the latest messages
+  bool keyFrame = (now - this->prevCompactKeyFrameTime).Double() >= 1.0;
+  if (keyFrame)
+  {
+    this->prevCompactKeyFrameTime = now;
+    this->compactPoses.clear();
+    msg.set_key_frame(true);
+
+    Model_V models = this->GetModels();
+    for (Model_V::iterator iter = models.begin(); iter != models.end();
+         ++iter)
+    {
+      this->AddCompactPose(msg, *iter, true);
+
+      Link_V links = (*iter)->GetLinks();
+      for (Link_V::iterator linkIter = links.begin();
+           linkIter != links.end(); ++linkIter)
+      {
+        this->AddCompactPose(msg, *linkIter, true);
+      }
+    }
+  }
+  else
+  {
+    for (std::set<ModelPtr>::iterator iter = this->compactPoseModels.begin();
+         iter != this->compactPoseModels.end(); ++iter)
+    {
+      this->AddCompactPose(msg, *iter, false);
+
+      Link_V links = (*iter)->GetLinks();
+      for (Link_V::iterator linkIter = links.begin();
+           linkIter != links.end(); ++linkIter)
+      {
+        this->AddCompactPose(msg, *linkIter, false);
+      }
+    }
+  }
+  this->compactPoseModels.clear();
+
+  if (keyFrame || msg.id_size() > 0)
+    this->compactPosePub->Publish(msg);
+}
+
+//////////////////////////////////////////////////
+void World::AddCompactPose(msgs::CompactPoses &_msg, EntityPtr _entity,
+                           bool _keyFrame)
+{
+  unsigned int id = _entity->GetId();
+  math::Pose pose = _entity->GetRelativePose();
+
+  std::map<unsigned int, math::Pose>::iterator iter =
+    this->compactPoses.find(id);
+
+  if (!_keyFrame && iter != this->compactPoses.end())
+  {
+    // Angle between the orientations
+    double dot = fabs(pose.rot.w * iter->second.rot.w +
+        pose.rot.x * iter->second.rot.x + pose.rot.y * iter->second.rot.y +
+        pose.rot.z * iter->second.rot.z);
+    double angle = 2.0 * acos(std::min(1.0, dot));
+
+    if (pose.pos.Distance(iter->second.pos) <= this->compactLinearThreshold &&
+        angle <= this->compactAngularThreshold)
+    {
+      return;
+    }
+  }
+
+  // Entities are named when first published
+  if (iter == this->compactPoses.end())
+  {
+    _msg.add_name_id(id);
+    _msg.add_name(_entity->GetScopedName());
+  }
+
+  msgs::Add(&_msg, id, pose);
+  this->compactPoses[id] = pose;
 }
 
 //////////////////////////////////////////////////
@@ -24,6 +24,7 @@
 
 #include <vector>
 #include <list>
+#include <map>
 #include <set>
 #include <deque>
 #include <string>
@@ -37,6 +38,7 @@
 #include "gazebo/common/CommonTypes.hh"
 #include "gazebo/common/UpdateInfo.hh"
 #include "gazebo/common/Event.hh"
+#include "gazebo/common/Histogram.hh"
 
 #include "gazebo/physics/Base.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
@@ -170,6 +172,21 @@ namespace gazebo
       /// \param[in] _t The new simulation time
       public: void SetSimTime(const common::Time &_t);
 
+      /// \brief Get the number of steps taken since the world was loaded
+      /// or reset.
+      /// \return The number of iterations.
+      public: uint64_t GetIterations() const;
+
+      /// \brief Get the wall time of each phase of the steps, since the
+      /// last world statistics message or call to ResetPhaseTimes.
+      /// \param[out] _phases Histogram of each phase in nanoseconds, by
+      /// phase name. Phases that didn't run are left out.
+      public: void GetPhaseTimes(
+                  std::map<std::string, common::Histogram> &_phases) const;
+
+      /// \brief Forget the phase timings collected so far.
+      public: void ResetPhaseTimes();
+
       /// \brief Get the amount of time simulation has been paused.
       /// \return The pause time.
       public: common::Time GetPauseTime() const;
@@ -223,16 +240,36 @@ namespace gazebo
 
       /// \brief Get the nearest entity below a point.
       ///
-      /// Projects a Ray down (-Z axis) starting at the given point. The
-      /// first entity hit by the Ray is returned.
+      /// Projects a Ray down (-Z axis) starting at the given point, and
+      /// returns the first entity hit by the Ray. The Ray is not cast when
+      /// SpatialIndex::GetCollisionsBelowPoint finds no collision.
       /// \param[in] _pt The 3D point to search below
       /// \return A pointer to nearest Entity, NULL if none is found.
       public: EntityPtr GetEntityBelowPoint(const math::Vector3 &_pt);
 
+      /// \brief Get the proximity queries on the entities of the world.
+      /// \return The spatial index, NULL before the world is initialized.
+      public: SpatialIndexPtr GetSpatialIndex() const;
+
       /// \brief Set the current world state.
       /// \param _state The state to set the World to.
       public: void SetState(const WorldState &_state);
 
+      /// \brief Save the dynamic state of the world in a binary buffer:
+      /// sim time, poses and velocities of the links, joint controllers,
+      /// random number generators, and the state of the plugins. Unlike
+      /// WorldState, the buffer can be restored exactly and quickly, but
+      /// only in this process and while the same entities exist.
+      /// \param[out] _buffer Buffer to fill. Its memory is reused.
+      public: void Snapshot(common::SnapshotBuffer &_buffer);
+
+      /// \brief Restore a state saved by Snapshot. The world may be
+      /// partly restored if the call fails.
+      /// \param[in] _buffer Buffer filled by Snapshot.
+      /// \return False if models were added or removed since the
+      /// snapshot, or the buffer is invalid.
+      public: bool Restore(common::SnapshotBuffer &_buffer);
+
       /// \brief Insert a model from an SDF file.
       ///
       /// Spawns a model into the world base on and SDF file.
@@ -272,6 +309,25 @@ namespace gazebo
       /// \param[in] _steps The number of steps the World should take.
       public: void StepWorld(int _steps);
 
+      /// \brief Step the world in the calling thread, as fast as possible.
+      /// Unlike StepWorld, the world must not be running in its own thread,
+      /// the steps are not paced by the update rate, and messages are not
+      /// processed. Several worlds may be stepped this way in parallel, see
+      /// physics::step_worlds. A world that was stopped with Stop can be
+      /// stepped this way.
+      ///
+      /// The world update events, such as event::Events::worldUpdateBegin
+      /// and event::Events::worldUpdateEnd, are global: when worlds are
+      /// stepped in parallel, their listeners are called from the threads
+      /// that step the worlds, one world at a time. Listeners must be
+      /// connected before the worlds are stepped, and should check
+      /// common::UpdateInfo::worldName to only handle their own world.
+      /// worldUpdateEnd carries no world, so its listeners are called once
+      /// per world and step.
+      /// \param[in] _steps The number of steps the World should take.
+      /// \return False if the world is running in its own thread.
+      public: bool RunBatch(unsigned int _steps);
+
       /// \brief Load a plugin
       /// \param[in] _filename The filename of the plugin.
       /// \param[in] _name A unique name for the plugin.
@@ -312,6 +368,20 @@ namespace gazebo
       /// \param[in] _model Pointer to the model to publish.
       public: void PublishModelPose(physics::ModelPtr _model);
 
+      /// \brief Set how poses are published on ~/pose/compact. Poses are
+      /// quantized, and an entity is only published again once it moved
+      /// or turned more than a threshold. The poses and names of all the
+      /// entities are published in a key frame every second.
+      /// \param[in] _positionResolution Meters per unit of position.
+      /// \param[in] _orientationResolution Quaternion component per unit
+      /// of orientation.
+      /// \param[in] _linearThreshold Distance in meters.
+      /// \param[in] _angularThreshold Angle in radians.
+      public: void SetCompactPoseOptions(double _positionResolution,
+                                         double _orientationResolution,
+                                         double _linearThreshold,
+                                         double _angularThreshold);
+
       /// \cond
       /// This is an internal function.
       /// \brief Get a model by id.
@@ -441,6 +511,17 @@ namespace gazebo
       /// \brief Process all incoming messages.
       private: void ProcessMessages();
 
+      /// \brief Publish the poses that changed on ~/pose/compact.
+      private: void PublishCompactPoses();
+
+      /// \brief Add the pose of an entity to a compact poses message, if
+      /// it changed more than the thresholds.
+      /// \param[out] _msg The message.
+      /// \param[in] _entity The entity.
+      /// \param[in] _keyFrame True to add the pose and the name anyway.
+      private: void AddCompactPose(msgs::CompactPoses &_msg,
+                                   EntityPtr _entity, bool _keyFrame);
+
       /// \brief Publish the world stats message.
       private: void PublishWorldStats();
 
@@ -516,6 +597,9 @@ namespace gazebo
       /// \brief Publisher for pose messages.
       private: transport::PublisherPtr posePub;
 
+      /// \brief Publisher for compact pose messages.
+      private: transport::PublisherPtr compactPosePub;
+
       /// \brief Subscriber to world control messages.
       private: transport::SubscriberPtr controlSub;
 
@@ -578,6 +662,10 @@ namespace gazebo
       /// World::SetPaused to assign world::pause
       private: boost::recursive_mutex *worldUpdateMutex;
 
+      /// \brief Serializes the global world update events, which all the
+      /// worlds in the process fire, possibly from several threads.
+      private: static boost::mutex updateEventMutex;
+
       /// \brief THe world's SDF values.
       private: sdf::ElementPtr sdf;
 
@@ -625,6 +713,9 @@ namespace gazebo
       /// \brief Ray used to test for collisions when placing entities.
       private: RayShapePtr testRay;
 
+      /// \brief Proximity queries on the entities.
+      private: SpatialIndexPtr spatialIndex;
+
       /// \brief True if the plugins have been loaded.
       private: bool pluginsLoaded;
 
@@ -652,11 +743,81 @@ namespace gazebo
       /// \brief The list of models that need to publish their pose.
       private: std::set<ModelPtr> publishModelPoses;
 
+      /// \brief Models that moved since compact poses were last published.
+      private: std::set<ModelPtr> compactPoseModels;
+
+      /// \brief Last published compact pose of each entity, by id.
+      private: std::map<unsigned int, math::Pose> compactPoses;
+
+      /// \brief Wall time compact poses were last published.
+      private: common::Time prevCompactPoseTime;
+
+      /// \brief Wall time of the last compact pose key frame.
+      private: common::Time prevCompactKeyFrameTime;
+
+      /// \brief Meters per unit of the compact positions.
+      private: double compactPositionResolution;
+
+      /// \brief Quaternion component per unit of the compact orientations.
+      private: double compactOrientationResolution;
+
+      /// \brief Distance an entity moves before its compact pose is
+      /// published again.
+      private: double compactLinearThreshold;
+
+      /// \brief Angle an entity turns before its compact pose is
+      /// published again.
+      private: double compactAngularThreshold;
+
       /// \brief Info passed through the WorldUpdateBegin event.
       private: common::UpdateInfo updateInfo;
 
       /// \brief The number of simulation iterations.
       private: uint64_t iterations;
+
+      /// \brief Phases of a step that are timed for the world statistics.
+      private: enum StepPhase
+               {
+                 /// \brief Model and plugin updates.
+                 PHASE_MODELS,
+
+                 /// \brief Collision detection.
+                 PHASE_COLLISION,
+
+                 /// \brief Constraint solver and pose propagation.
+                 PHASE_SOLVER,
+
+                 /// \brief Contact publication.
+                 PHASE_CONTACTS,
+
+                 /// \brief State logging.
+                 PHASE_LOGGING,
+
+                 /// \brief Message processing.
+                 PHASE_MESSAGES,
+
+                 /// \brief Number of phases.
+                 PHASE_COUNT
+               };
+
+      /// \brief Wall time of each step, in nanoseconds, since the last
+      /// world statistics message.
+      private: common::Histogram stepTimes;
+
+      /// \brief Wall time between the starts of consecutive steps, in
+      /// nanoseconds, since the last world statistics message.
+      private: common::Histogram stepPeriods;
+
+      /// \brief Wall time of each phase of the steps, in nanoseconds.
+      private: common::Histogram phaseTimes[PHASE_COUNT];
+
+      /// \brief Number of steps that took longer than the update period
+      /// since the last world statistics message.
+      private: uint64_t stepOverruns;
+
+      /// \brief Monotonic time of the start of the previous step, in
+      /// nanoseconds. Zero when the previous loop did not step.
+      private: uint64_t prevStepStart;
     };
     /// \}
   }
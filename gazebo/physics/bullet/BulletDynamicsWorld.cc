@@ -0,0 +1,329 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include "gazebo/physics/bullet/bullet_inc.h"
+#if BT_BULLET_VERSION >= 282
+#include <BulletDynamics/MLCPSolvers/btMLCPSolver.h>
+#include <BulletDynamics/MLCPSolvers/btDantzigSolver.h>
+#endif
+#if BT_BULLET_VERSION >= 283
+#include <BulletDynamics/ConstraintSolver/btNNCGConstraintSolver.h>
+#endif
+
+#include "gazebo/common/Trace.hh"
+#include "gazebo/physics/bullet/BulletDynamicsWorld.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+#if BT_BULLET_VERSION >= 282
+/// \brief MLCP solver that owns its Dantzig solver.
+class DantzigMLCPSolver : public btMLCPSolver
+{
+  /// \brief Constructor. The base only keeps the pointer to the Dantzig
+  /// solver, which is constructed right after it.
+  public: DantzigMLCPSolver() : btMLCPSolver(&this->dantzig) {}
+
+  /// \brief Solves the mixed linear complementarity problems.
+  private: btDantzigSolver dantzig;
+};
+#endif
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief Solves the islands of a range of batches.
+    class IslandBatch_TBB
+    {
+      /// \brief Constructor.
+      /// \param[in] _world World of the islands.
+      /// \param[in] _info Solver parameters.
+      public: IslandBatch_TBB(BulletDynamicsWorld *_world,
+                  const btContactSolverInfo *_info)
+              : world(_world), info(_info) {}
+
+      /// \brief Solve the batches.
+      /// \param[in] _r Range of batches.
+      public: void operator() (const tbb::blocked_range<size_t> &_r) const
+              {
+                for (size_t i = _r.begin(); i != _r.end(); ++i)
+                  this->world->SolveBatch(i, *this->info);
+              }
+
+      /// \brief World of the islands.
+      private: BulletDynamicsWorld *world;
+
+      /// \brief Solver parameters.
+      private: const btContactSolverInfo *info;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+BulletDynamicsWorld::BulletDynamicsWorld(btDispatcher *_dispatcher,
+    btBroadphaseInterface *_broadphase,
+    btCollisionConfiguration *_collisionConfig)
+  : btDiscreteDynamicsWorld(_dispatcher, _broadphase,
+      CreateSolver("sequential_impulse"), _collisionConfig),
+    solverType("sequential_impulse"), threads(0), islandCount(0)
+{
+  // The base doesn't own a solver it is given
+  this->mainSolver = this->getConstraintSolver();
+}
+
+//////////////////////////////////////////////////
+BulletDynamicsWorld::~BulletDynamicsWorld()
+{
+  for (unsigned int i = 0; i < this->threadSolvers.size(); ++i)
+    delete this->threadSolvers[i];
+  this->threadSolvers.clear();
+
+  delete this->mainSolver;
+  this->mainSolver = NULL;
+}
+
+//////////////////////////////////////////////////
+btConstraintSolver *BulletDynamicsWorld::CreateSolver(
+    const std::string &_type)
+{
+  if (_type == "sequential_impulse")
+    return new btSequentialImpulseConstraintSolver;
+#if BT_BULLET_VERSION >= 283
+  else if (_type == "nncg")
+    return new btNNCGConstraintSolver;
+#endif
+#if BT_BULLET_VERSION >= 282
+  else if (_type == "dantzig")
+    return new DantzigMLCPSolver;
+#endif
+
+  return NULL;
+}
+
+//////////////////////////////////////////////////
+bool BulletDynamicsWorld::SetSolverType(const std::string &_type)
+{
+  if (_type == this->solverType)
+    return true;
+
+  btConstraintSolver *solver = CreateSolver(_type);
+  if (!solver)
+    return false;
+
+  this->setConstraintSolver(solver);
+  delete this->mainSolver;
+  this->mainSolver = solver;
+  this->solverType = _type;
+
+  // Thread solvers are created again on the next step
+  for (unsigned int i = 0; i < this->threadSolvers.size(); ++i)
+    delete this->threadSolvers[i];
+  this->threadSolvers.clear();
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+std::string BulletDynamicsWorld::GetSolverType() const
+{
+  return this->solverType;
+}
+
+//////////////////////////////////////////////////
+void BulletDynamicsWorld::SetThreads(unsigned int _threads)
+{
+  this->threads = _threads;
+}
+
+//////////////////////////////////////////////////
+unsigned int BulletDynamicsWorld::GetThreads() const
+{
+  return this->threads;
+}
+
+//////////////////////////////////////////////////
+void BulletDynamicsWorld::solveConstraints(btContactSolverInfo &_solverInfo)
+{
+  GZ_TRACE_SCOPE("BulletDynamicsWorld::solveConstraints");
+
+  if (this->threads < 2 || !this->BuildIslands())
+  {
+    btDiscreteDynamicsWorld::solveConstraints(_solverInfo);
+    return;
+  }
+
+  // Biggest islands first, each given to the thread with the least work
+  std::vector<std::pair<size_t, unsigned int> > order;
+  for (unsigned int i = 0; i < this->islandCount; ++i)
+  {
+    const Island &island = this->islands[i];
+    if (island.active)
+    {
+      order.push_back(std::make_pair(island.bodies.size() +
+            island.manifolds.size() + island.constraints.size(), i));
+    }
+  }
+  std::sort(order.begin(), order.end(),
+            std::greater<std::pair<size_t, unsigned int> >());
+
+  unsigned int batchCount = std::min(this->threads,
+      static_cast<unsigned int>(order.size()));
+  this->batches.resize(batchCount);
+  std::vector<size_t> work(batchCount, 0);
+  for (unsigned int i = 0; i < batchCount; ++i)
+    this->batches[i].clear();
+
+  for (unsigned int i = 0; i < order.size(); ++i)
+  {
+    unsigned int batch = std::min_element(work.begin(), work.end()) -
+      work.begin();
+    this->batches[batch].push_back(order[i].second);
+    work[batch] += order[i].first;
+  }
+
+  while (this->threadSolvers.size() < batchCount)
+    this->threadSolvers.push_back(CreateSolver(this->solverType));
+
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, batchCount, 1),
+      IslandBatch_TBB(this, &_solverInfo));
+}
+
+//////////////////////////////////////////////////
+bool BulletDynamicsWorld::BuildIslands()
+{
+  btCollisionObjectArray &objects = this->getCollisionObjectArray();
+
+  // Kinematic bodies are in no island, and the solvers write to them, so
+  // they can't be shared by islands solved at the same time
+  for (int i = 0; i < objects.size(); ++i)
+  {
+    if (objects[i]->isKinematicObject())
+      return false;
+  }
+
+  // Same islands, and the same bodies put to sleep, as
+  // btSimulationIslandManager::buildAndProcessIslands
+  btSimulationIslandManager *manager = this->getSimulationIslandManager();
+  btDispatcher *dispatcher = this->getDispatcher();
+  manager->buildIslands(dispatcher, this);
+
+  btUnionFind &unionFind = manager->getUnionFind();
+  int numElements = unionFind.getNumElements();
+  this->islandIndex.assign(objects.size(), -1);
+  this->islandCount = 0;
+
+  int end = 0;
+  for (int start = 0; start < numElements; start = end)
+  {
+    int islandId = unionFind.getElement(start).m_id;
+
+    if (this->islandCount == this->islands.size())
+      this->islands.push_back(Island());
+    Island &island = this->islands[this->islandCount];
+    island.bodies.clear();
+    island.manifolds.clear();
+    island.constraints.clear();
+    island.active = false;
+
+    for (end = start; end < numElements &&
+         unionFind.getElement(end).m_id == islandId; ++end)
+    {
+      btCollisionObject *object = objects[unionFind.getElement(end).m_sz];
+      island.bodies.push_back(object);
+      if (object->isActive())
+        island.active = true;
+    }
+
+    if (islandId >= 0 && islandId < static_cast<int>(this->islandIndex.size()))
+      this->islandIndex[islandId] = this->islandCount;
+    this->islandCount++;
+  }
+
+  for (int i = 0; i < dispatcher->getNumManifolds(); ++i)
+  {
+    btPersistentManifold *manifold = dispatcher->getManifoldByIndexInternal(i);
+    const btCollisionObject *object0 =
+      static_cast<const btCollisionObject *>(manifold->getBody0());
+    const btCollisionObject *object1 =
+      static_cast<const btCollisionObject *>(manifold->getBody1());
+
+    if ((object0->getActivationState() == ISLAND_SLEEPING &&
+         object1->getActivationState() == ISLAND_SLEEPING) ||
+        !dispatcher->needsResponse(object0, object1))
+    {
+      continue;
+    }
+
+    int islandId = object0->getIslandTag() >= 0 ?
+      object0->getIslandTag() : object1->getIslandTag();
+    if (islandId >= 0 && islandId < static_cast<int>(this->islandIndex.size())
+        && this->islandIndex[islandId] >= 0)
+    {
+      this->islands[this->islandIndex[islandId]].manifolds.push_back(
+          manifold);
+    }
+  }
+
+  for (int i = 0; i < this->getNumConstraints(); ++i)
+  {
+    btTypedConstraint *constraint = this->getConstraint(i);
+    const btRigidBody &bodyA = constraint->getRigidBodyA();
+    const btRigidBody &bodyB = constraint->getRigidBodyB();
+
+    int islandId = bodyA.getIslandTag() >= 0 ?
+      bodyA.getIslandTag() : bodyB.getIslandTag();
+    if (islandId >= 0 && islandId < static_cast<int>(this->islandIndex.size())
+        && this->islandIndex[islandId] >= 0)
+    {
+      this->islands[this->islandIndex[islandId]].constraints.push_back(
+          constraint);
+    }
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void BulletDynamicsWorld::SolveBatch(unsigned int _batch,
+                                     const btContactSolverInfo &_info)
+{
+  btConstraintSolver *solver = this->threadSolvers[_batch];
+  const std::vector<unsigned int> &batch = this->batches[_batch];
+
+  for (unsigned int i = 0; i < batch.size(); ++i)
+  {
+    Island &island = this->islands[batch[i]];
+    solver->solveGroup(
+        island.bodies.empty() ? NULL : &island.bodies[0],
+        island.bodies.size(),
+        island.manifolds.empty() ? NULL : &island.manifolds[0],
+        island.manifolds.size(),
+        island.constraints.empty() ? NULL : &island.constraints[0],
+        island.constraints.size(), _info, NULL,
+#if BT_BULLET_VERSION < 282
+        NULL,
+#endif
+        this->getDispatcher());
+  }
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _BULLETDYNAMICSWORLD_HH_
+#define _BULLETDYNAMICSWORLD_HH_
+
+#include <string>
+#include <vector>
+
+#include "gazebo/physics/bullet/bullet_inc.h"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \ingroup gazebo_physics_bullet
+    /// \{
+
+    /// \brief Discrete dynamics world that can solve its simulation islands
+    /// in parallel.
+    ///
+    /// Bodies of different islands share no contact or constraint, so each
+    /// island is solved on its own by a solver of the same type as the main
+    /// one. Islands are given to the threads in a fixed order, so the
+    /// result doesn't depend on the number of threads or their timing.
+    class BulletDynamicsWorld : public btDiscreteDynamicsWorld
+    {
+      /// \brief Constructor.
+      /// \param[in] _dispatcher Collision dispatcher.
+      /// \param[in] _broadphase Broadphase of the collision objects.
+      /// \param[in] _collisionConfig Collision configuration.
+      public: BulletDynamicsWorld(btDispatcher *_dispatcher,
+                  btBroadphaseInterface *_broadphase,
+                  btCollisionConfiguration *_collisionConfig);
+
+      /// \brief Destructor, deletes the solvers.
+      public: virtual ~BulletDynamicsWorld();
+
+      /// \brief Create a constraint solver.
+      /// \param[in] _type sequential_impulse, nncg or dantzig. The last two
+      /// depend on the version of bullet.
+      /// \return The solver, NULL if the type is not available.
+      public: static btConstraintSolver *CreateSolver(
+                  const std::string &_type);
+
+      /// \brief Set the type of the constraint solvers.
+      /// \param[in] _type A type accepted by CreateSolver.
+      /// \return False if the type is not available.
+      public: bool SetSolverType(const std::string &_type);
+
+      /// \brief Get the type of the constraint solvers.
+      /// \return The type.
+      public: std::string GetSolverType() const;
+
+      /// \brief Set the number of threads solving the islands.
+      /// \param[in] _threads Number of threads, 0 or 1 to solve all the
+      /// islands together like btDiscreteDynamicsWorld.
+      public: void SetThreads(unsigned int _threads);
+
+      /// \brief Get the number of threads solving the islands.
+      /// \return Number of threads.
+      public: unsigned int GetThreads() const;
+
+      // Documentation inherited
+      protected: virtual void solveConstraints(
+                     btContactSolverInfo &_solverInfo);
+
+      /// \brief Collect the active islands in this->islands.
+      /// \return False if they can't be solved separately.
+      private: bool BuildIslands();
+
+      /// \brief Solve the islands given to a thread.
+      /// \param[in] _batch Index of the thread.
+      /// \param[in] _info Solver parameters.
+      private: void SolveBatch(unsigned int _batch,
+                               const btContactSolverInfo &_info);
+
+      /// \brief Bodies, contacts and constraints of an island.
+      private: class Island
+               {
+                 /// \brief Bodies of the island.
+                 public: std::vector<btCollisionObject *> bodies;
+
+                 /// \brief Contacts of the bodies.
+                 public: std::vector<btPersistentManifold *> manifolds;
+
+                 /// \brief Constraints between the bodies.
+                 public: std::vector<btTypedConstraint *> constraints;
+
+                 /// \brief False if all the bodies are sleeping.
+                 public: bool active;
+               };
+
+      /// \brief Solves the islands of a batch.
+      private: friend class IslandBatch_TBB;
+
+      /// \brief Type of the solvers.
+      private: std::string solverType;
+
+      /// \brief Main solver, used when the islands are solved together.
+      private: btConstraintSolver *mainSolver;
+
+      /// \brief One solver per thread.
+      private: std::vector<btConstraintSolver *> threadSolvers;
+
+      /// \brief Number of threads solving the islands.
+      private: unsigned int threads;
+
+      /// \brief Islands of the last step, the used ones first.
+      private: std::vector<Island> islands;
+
+      /// \brief Number of used islands.
+      private: unsigned int islandCount;
+
+      /// \brief Island index of each union find island id.
+      private: std::vector<int> islandIndex;
+
+      /// \brief Indices of the islands solved by each thread.
+      private: std::vector<std::vector<unsigned int> > batches;
+    };
+    /// \}
+  }
+}
+#endif
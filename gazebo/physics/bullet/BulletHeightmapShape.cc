@@ -19,6 +19,7 @@
  * Date: 8 May 2003
  */
 
+#include "common/Console.hh"
 #include "common/Exception.hh"
 
 #include "physics/bullet/bullet_inc.h"
@@ -33,6 +34,7 @@ using namespace physics;
 BulletHeightmapShape::BulletHeightmapShape(CollisionPtr _parent)
     : HeightmapShape(_parent)
 {
+  this->heightFieldShape = NULL;
 }
 
 //////////////////////////////////////////////////
@@ -45,6 +47,16 @@ void BulletHeightmapShape::Init()
 {
   HeightmapShape::Init();
 
+  // Tiled heightmaps keep no lookup table of heights, and Bullet doesn't
+  // load the tiles as links move.
+  if (this->IsTiled())
+  {
+    gzerr << "Tiled heightmaps are not supported by Bullet, heightmap["
+          << this->GetURI() << "] will not collide. Remove the tile_size "
+          << "to load it as a whole.\n";
+    return;
+  }
+
   float maxHeight = this->GetMaxHeight();
   float minHeight = this->GetMinHeight();
 
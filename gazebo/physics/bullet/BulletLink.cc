@@ -19,6 +19,8 @@
  * Date: 13 Feb 2006
  */
 
+#include <algorithm>
+
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
@@ -128,10 +130,24 @@ void BulletLink::Init()
       btCollisionObject::CF_CUSTOM_MATERIAL_CALLBACK);
 
 
-  // Setup motion clamping to prevent objects from moving too fast.
-  // this->rigidLink->setCcdMotionThreshold(1);
-  // math::Vector3 size = this->GetBoundingBox().GetSize();
-  // this->rigidLink->setCcdSweptSphereRadius(size.GetMax()*0.8);
+  // Setup motion clamping to prevent fast links from passing through thin
+  // objects. Bullet disables it with a zero motion threshold, so a tiny
+  // threshold is used to sweep every step.
+  if (this->sdf->HasElement("ccd"))
+  {
+    sdf::ElementPtr ccdElem = this->sdf->GetElement("ccd");
+    double radius = ccdElem->GetValueDouble("swept_sphere_radius");
+    if (radius <= 0)
+    {
+      math::Vector3 size = this->GetBoundingBox().GetSize();
+      radius = 0.5 * std::min(size.x, std::min(size.y, size.z));
+    }
+
+    double threshold = ccdElem->GetValueDouble("velocity_threshold") *
+      this->bulletPhysics->GetMaxStepSize();
+    this->rigidLink->setCcdMotionThreshold(std::max(threshold, 1e-6));
+    this->rigidLink->setCcdSweptSphereRadius(radius);
+  }
 
   if (mass <= 0.0)
     this->rigidLink->setCollisionFlags(btCollisionObject::CF_KINEMATIC_OBJECT);
@@ -54,6 +54,7 @@
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/Trace.hh"
 #include "gazebo/math/Vector3.hh"
 #include "gazebo/math/Rand.hh"
 
@@ -112,11 +113,27 @@ struct CollisionFilter : public btOverlapFilterCallback
 //////////////////////////////////////////////////
 void InternalTickCallback(btDynamicsWorld *_world, btScalar _timeStep)
 {
+  BulletPhysics *bulletPhysics =
+    static_cast<BulletPhysics *>(_world->getWorldUserInfo());
+  GZ_ASSERT(bulletPhysics != NULL, "Bullet world has no physics engine");
+
+  // Converting the manifolds is only needed when someone listens to the
+  // contacts, which is checked once per step instead of for every pair.
+  ContactManager *contactManager = bulletPhysics->GetContactManager();
+  if (!contactManager->HasListeners())
+    return;
+
   int numManifolds = _world->getDispatcher()->getNumManifolds();
   for (int i = 0; i < numManifolds; ++i)
   {
     btPersistentManifold *contactManifold =
         _world->getDispatcher()->getManifoldByIndexInternal(i);
+
+    // Pairs whose bounding boxes overlap keep a manifold without points
+    int numContacts = contactManifold->getNumContacts();
+    if (numContacts == 0)
+      continue;
+
     const btCollisionObject *obA =
         static_cast<const btCollisionObject *>(contactManifold->getBody0());
     const btCollisionObject *obB =
@@ -138,15 +155,11 @@ void InternalTickCallback(btDynamicsWorld *_world, btScalar _timeStep)
     CollisionPtr collisionPtr2 = link2->GetCollision(colIndex);
 
     if (!collisionPtr1 || !collisionPtr2)
-      return;
-
-    PhysicsEnginePtr engine = collisionPtr1->GetWorld()->GetPhysicsEngine();
-    BulletPhysicsPtr bulletPhysics =
-          boost::static_pointer_cast<BulletPhysics>(engine);
+      continue;
 
     // Add a new contact to the manager. This will return NULL if no one is
     // listening for contact information.
-    Contact *contactFeedback = bulletPhysics->GetContactManager()->NewContact(
+    Contact *contactFeedback = contactManager->NewContact(
         collisionPtr1.get(), collisionPtr2.get(),
         collisionPtr1->GetWorld()->GetSimTime());
 
@@ -162,7 +175,6 @@ void InternalTickCallback(btDynamicsWorld *_world, btScalar _timeStep)
     math::Vector3 localTorque1;
     math::Vector3 localTorque2;
 
-    int numContacts = contactManifold->getNumContacts();
     for (int j = 0; j < numContacts; ++j)
     {
       btManifoldPoint &pt = contactManifold->getContactPoint(j);
@@ -189,18 +201,22 @@ void InternalTickCallback(btDynamicsWorld *_world, btScalar _timeStep)
         localTorque2 = body2Pose.rot.RotateVectorReverse(
             BulletTypes::ConvertVector3(torqueB));
 
-        contactFeedback->positions[j] = BulletTypes::ConvertVector3(ptB);
-        contactFeedback->normals[j] = BulletTypes::ConvertVector3(normalOnB);
-        contactFeedback->depths[j] = -pt.getDistance();
+        // Points that don't penetrate are skipped, so the index of the
+        // contact is its count rather than the index of the point
+        int index = contactFeedback->count;
+        contactFeedback->positions[index] = BulletTypes::ConvertVector3(ptB);
+        contactFeedback->normals[index] =
+          BulletTypes::ConvertVector3(normalOnB);
+        contactFeedback->depths[index] = -pt.getDistance();
         if (!link1->IsStatic())
         {
-          contactFeedback->wrench[j].body1Force = localForce1;
-          contactFeedback->wrench[j].body1Torque = localTorque1;
+          contactFeedback->wrench[index].body1Force = localForce1;
+          contactFeedback->wrench[index].body1Torque = localTorque1;
         }
         if (!link2->IsStatic())
         {
-          contactFeedback->wrench[j].body2Force = localForce2;
-          contactFeedback->wrench[j].body2Torque = localTorque2;
+          contactFeedback->wrench[index].body2Force = localForce2;
+          contactFeedback->wrench[index].body2Torque = localTorque2;
         }
         contactFeedback->count++;
       }
@@ -233,7 +249,8 @@ BulletPhysics::BulletPhysics(WorldPtr _world)
   // Default setup for memory and collisions
   this->collisionConfig = new btDefaultCollisionConfiguration();
 
-  // Default collision dispatcher, a multi-threaded dispatcher may be available
+  // Default collision dispatcher. The narrow phase stays sequential, the
+  // convex pair algorithms of bullet share one simplex solver.
   this->dispatcher = new btCollisionDispatcher(this->collisionConfig);
 
   // Broadphase collision detection uses axis-aligned bounding boxes (AABB)
@@ -244,25 +261,22 @@ BulletPhysics::BulletPhysics(WorldPtr _world)
   // AABB tree" according to Bullet_User_Manual.pdf
   // "btAxis3Sweep and bt32BitAxisSweep3 implement incremental 3d sweep and
   // prune" also according to the user manual.
-  // btCudaBroadphase can be used if GPU hardware is available
-  // Here we are using btDbvtBroadphase.
+  // btDbvtBroadphase is used until Load reads the <broadphase> element.
   this->broadPhase = new btDbvtBroadphase();
 
-  // Create btSequentialImpulseConstraintSolver, the default constraint solver.
-  // Note that a multi-threaded solver may be available.
-  this->solver = new btSequentialImpulseConstraintSolver;
-
-  // Create a btDiscreteDynamicsWorld, which is used for discrete rigid bodies.
+  // A btDiscreteDynamicsWorld, which is used for discrete rigid bodies, that
+  // can also solve its simulation islands in parallel. It creates the
+  // btSequentialImpulseConstraintSolver, the default constraint solver.
   // An alternative is btSoftRigidDynamicsWorld, which handles both soft and
   // rigid bodies.
-  this->dynamicsWorld = new btDiscreteDynamicsWorld(this->dispatcher,
-      this->broadPhase, this->solver, this->collisionConfig);
+  this->dynamicsWorld = new BulletDynamicsWorld(this->dispatcher,
+      this->broadPhase, this->collisionConfig);
 
-  btOverlapFilterCallback *filterCallback = new CollisionFilter();
+  this->filterCallback = new CollisionFilter();
   btOverlappingPairCache* pairCache = this->dynamicsWorld->getPairCache();
   GZ_ASSERT(pairCache != NULL,
       "Bullet broadphase overlapping pair cache is NULL");
-  pairCache->setOverlapFilterCallback(filterCallback);
+  pairCache->setOverlapFilterCallback(this->filterCallback);
 
   // TODO: Enable this to do custom contact setting
   gContactAddedCallback = ContactCallback;
@@ -281,13 +295,13 @@ BulletPhysics::~BulletPhysics()
 {
   // Delete in reverse-order of creation
   delete this->dynamicsWorld;
-  delete this->solver;
   delete this->broadPhase;
+  delete this->filterCallback;
   delete this->dispatcher;
   delete this->collisionConfig;
 
   this->dynamicsWorld = NULL;
-  this->solver = NULL;
+  this->filterCallback = NULL;
   this->broadPhase = NULL;
   this->dispatcher = NULL;
   this->collisionConfig = NULL;
@@ -330,6 +344,11 @@ void BulletPhysics::Load(sdf::ElementPtr _sdf)
       boost::any_cast<int>(this->GetParam(PGS_ITERS));
   info.m_sor =
       boost::any_cast<double>(this->GetParam(SOR));
+
+  // The world is still empty, so changing the broadphase is cheap
+  this->SetParam(SOLVER_TYPE, this->GetParam(SOLVER_TYPE));
+  this->SetParam(SOLVER_THREADS, this->GetParam(SOLVER_THREADS));
+  this->SetParam(BROADPHASE_TYPE, this->GetParam(BROADPHASE_TYPE));
 }
 
 //////////////////////////////////////////////////
@@ -355,7 +374,7 @@ void BulletPhysics::OnRequest(ConstRequestPtr &_msg)
   {
     msgs::Physics physicsMsg;
     physicsMsg.set_type(msgs::Physics::BULLET);
-    physicsMsg.set_solver_type(this->solverType);
+    physicsMsg.set_solver_type(this->dynamicsWorld->GetSolverType());
     // min_step_size is defined but not yet used
     physicsMsg.set_min_step_size(
         boost::any_cast<double>(this->GetParam(MIN_STEP_SIZE)));
@@ -448,6 +467,8 @@ void BulletPhysics::UpdateCollision()
 //////////////////////////////////////////////////
 void BulletPhysics::UpdatePhysics()
 {
+  GZ_TRACE_SCOPE("BulletPhysics::UpdatePhysics");
+
   // need to lock, otherwise might conflict with world resetting
   boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
 
@@ -510,14 +531,15 @@ void BulletPhysics::SetParam(BulletParam _param, const boost::any &_value)
         gzerr << "boost any_cast error:" << e.what() << "\n";
         return;
       }
-      if (value == "sequential_impulse")
-      {
+      boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+      if (this->dynamicsWorld->SetSolverType(value))
         bulletElem->GetElement("solver")->GetElement("type")->Set(value);
-        this->solverType = value;
-      }
       else
-        gzwarn << "Currently only 'sequential_impulse' solver is supported"
-            << std::endl;
+      {
+        gzwarn << "Solver type[" << value << "] is not available, the "
+          << "solvers are sequential_impulse, and nncg and dantzig with "
+          << "newer versions of bullet" << std::endl;
+      }
       break;
     }
     case GLOBAL_CFM:
@@ -631,6 +653,42 @@ void BulletPhysics::SetParam(BulletParam _param, const boost::any &_value)
       bulletElem->GetElement("solver")->GetElement("min_step_size")->Set(value);
       break;
     }
+    case SOLVER_THREADS:
+    {
+      int value;
+      try
+      {
+        value = boost::any_cast<int>(_value);
+      }
+      catch(boost::bad_any_cast &e)
+      {
+        value = boost::any_cast<unsigned int>(_value);
+      }
+      bulletElem->GetElement("solver")->GetElement("threads")->Set(value);
+      this->dynamicsWorld->SetThreads(value > 0 ? value : 0);
+      break;
+    }
+    case BROADPHASE_TYPE:
+    {
+      std::string value;
+      try
+      {
+        value = boost::any_cast<std::string>(_value);
+      }
+      catch(boost::bad_any_cast &e)
+      {
+        gzerr << "boost any_cast error:" << e.what() << "\n";
+        return;
+      }
+      if (this->SetBroadphase(value))
+        bulletElem->GetElement("broadphase")->GetElement("type")->Set(value);
+      else
+      {
+        gzwarn << "Broadphase type[" << value << "] is not supported, "
+          << "use dbvt or axis_sweep" << std::endl;
+      }
+      break;
+    }
     default:
     {
       gzwarn << "Param not supported in bullet" << std::endl;
@@ -660,6 +718,10 @@ void BulletPhysics::SetParam(const std::string &_key, const boost::any &_value)
     param = MAX_CONTACTS;
   else if (_key == "min_step_size")
     param = MIN_STEP_SIZE;
+  else if (_key == "threads")
+    param = SOLVER_THREADS;
+  else if (_key == "broadphase")
+    param = BROADPHASE_TYPE;
   else
   {
     gzwarn << _key << " is not supported in bullet" << std::endl;
@@ -719,6 +781,16 @@ boost::any BulletPhysics::GetParam(BulletParam _param) const
       value = bulletElem->GetElement("solver")->GetValueDouble("min_step_size");
       break;
     }
+    case SOLVER_THREADS:
+    {
+      value = bulletElem->GetElement("solver")->GetValueInt("threads");
+      break;
+    }
+    case BROADPHASE_TYPE:
+    {
+      value = bulletElem->GetElement("broadphase")->GetValueString("type");
+      break;
+    }
     default:
     {
       gzwarn << "Param not supported in bullet" << std::endl;
@@ -749,6 +821,10 @@ boost::any BulletPhysics::GetParam(const std::string &_key) const
     param = MAX_CONTACTS;
   else if (_key == "min_step_size")
     param = MIN_STEP_SIZE;
+  else if (_key == "threads")
+    param = SOLVER_THREADS;
+  else if (_key == "broadphase")
+    param = BROADPHASE_TYPE;
   else
   {
     gzwarn << _key << " is not supported in bullet" << std::endl;
@@ -757,6 +833,82 @@ boost::any BulletPhysics::GetParam(const std::string &_key) const
   return this->GetParam(param);
 }
 
+//////////////////////////////////////////////////
+bool BulletPhysics::SetBroadphase(const std::string &_type)
+{
+  btBroadphaseInterface *broadphase = NULL;
+  if (_type == "dbvt")
+    broadphase = new btDbvtBroadphase();
+  else if (_type == "axis_sweep")
+  {
+    // Sweep and prune along the 3 axes, which is faster than the tree when
+    // most objects rest. Objects outside the bounds are all put in the
+    // same cells at the border, so the bounds must hold the world.
+    sdf::ElementPtr elem =
+      this->sdf->GetElement("bullet")->GetElement("broadphase");
+    math::Vector3 worldMin = elem->GetValueVector3("world_min");
+    math::Vector3 worldMax = elem->GetValueVector3("world_max");
+    if (worldMin.x >= worldMax.x || worldMin.y >= worldMax.y ||
+        worldMin.z >= worldMax.z)
+    {
+      gzerr << "Broadphase world_min[" << worldMin
+        << "] must be less than world_max[" << worldMax << "]\n";
+      return false;
+    }
+
+    broadphase = new bt32BitAxisSweep3(BulletTypes::ConvertVector3(worldMin),
+        BulletTypes::ConvertVector3(worldMax), 65536);
+  }
+  else
+    return false;
+
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  // Take the collision objects out of the old broadphase, keeping their
+  // filters. Adding a body sets its gravity, so it is kept as well.
+  btCollisionObjectArray objects =
+    this->dynamicsWorld->getCollisionObjectArray();
+  std::vector<int> groups(objects.size());
+  std::vector<int> masks(objects.size());
+  std::vector<btVector3> gravities(objects.size());
+  for (int i = objects.size() - 1; i >= 0; --i)
+  {
+    btCollisionObject *object = objects[i];
+    btBroadphaseProxy *proxy = object->getBroadphaseHandle();
+    groups[i] = proxy ? proxy->m_collisionFilterGroup : 1;
+    masks[i] = proxy ? proxy->m_collisionFilterMask : -1;
+
+    btRigidBody *body = btRigidBody::upcast(object);
+    if (body)
+    {
+      gravities[i] = body->getGravity();
+      this->dynamicsWorld->removeRigidBody(body);
+    }
+    else
+      this->dynamicsWorld->removeCollisionObject(object);
+  }
+
+  this->dynamicsWorld->setBroadphase(broadphase);
+  delete this->broadPhase;
+  this->broadPhase = broadphase;
+  this->broadPhase->getOverlappingPairCache()->setOverlapFilterCallback(
+      this->filterCallback);
+
+  for (int i = 0; i < objects.size(); ++i)
+  {
+    btRigidBody *body = btRigidBody::upcast(objects[i]);
+    if (body)
+    {
+      this->dynamicsWorld->addRigidBody(body, groups[i], masks[i]);
+      body->setGravity(gravities[i]);
+    }
+    else
+      this->dynamicsWorld->addCollisionObject(objects[i], groups[i], masks[i]);
+  }
+
+  return true;
+}
+
 //////////////////////////////////////////////////
 LinkPtr BulletPhysics::CreateLink(ModelPtr _parent)
 {
@@ -898,3 +1050,30 @@ void BulletPhysics::SetSeed(uint32_t /*_seed*/)
   // It's going to be blank for now.
   /// \todo Implement this function.
 }
+
+/////////////////////////////////////////////////
+void BulletPhysics::Snapshot(common::SnapshotBuffer &_buffer)
+{
+  // Contact points cached by the dispatcher, used to warm start the
+  // solver, are not saved. All the solvers derive from the sequential
+  // impulse solver.
+  btSequentialImpulseConstraintSolver *solver =
+    dynamic_cast<btSequentialImpulseConstraintSolver *>(
+        this->dynamicsWorld->getConstraintSolver());
+  _buffer.Write(static_cast<uint64_t>(solver ? solver->getRandSeed() : 0));
+}
+
+/////////////////////////////////////////////////
+bool BulletPhysics::Restore(common::SnapshotBuffer &_buffer)
+{
+  uint64_t seed = 0;
+  if (!_buffer.Read(seed))
+    return false;
+
+  btSequentialImpulseConstraintSolver *solver =
+    dynamic_cast<btSequentialImpulseConstraintSolver *>(
+        this->dynamicsWorld->getConstraintSolver());
+  if (solver)
+    solver->setRandSeed(seed);
+  return true;
+}
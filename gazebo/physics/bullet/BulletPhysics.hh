@@ -27,6 +27,7 @@
 #include <boost/thread/mutex.hpp>
 
 #include "physics/bullet/bullet_inc.h"
+#include "physics/bullet/BulletDynamicsWorld.hh"
 #include "physics/PhysicsEngine.hh"
 #include "physics/Collision.hh"
 #include "physics/Shape.hh"
@@ -72,7 +73,13 @@ namespace gazebo
         MAX_CONTACTS,
 
         /// \brief Minimum step size
-        MIN_STEP_SIZE
+        MIN_STEP_SIZE,
+
+        /// \brief Number of threads solving simulation islands
+        SOLVER_THREADS,
+
+        /// \brief Broadphase type
+        BROADPHASE_TYPE
       };
 
       /// \brief Constructor
@@ -150,6 +157,12 @@ namespace gazebo
       // Documentation inherited
       public: virtual void SetSeed(uint32_t _seed);
 
+      // Documentation inherited
+      public: virtual void Snapshot(common::SnapshotBuffer &_buffer);
+
+      // Documentation inherited
+      public: virtual bool Restore(common::SnapshotBuffer &_buffer);
+
       /// \brief Register a joint with the dynamics world
       public: btDynamicsWorld *GetDynamicsWorld() const
               {return this->dynamicsWorld;}
@@ -174,16 +187,22 @@ namespace gazebo
       /// \return The value of the parameter
       public: virtual boost::any GetParam(BulletParam _param) const;
 
+      /// \brief Replace the broadphase. The collision objects are moved to
+      /// the new one with their collision filters.
+      /// \param[in] _type dbvt, or axis_sweep within the world bounds of
+      /// the <broadphase> element.
+      /// \return False if the type is unknown.
+      private: bool SetBroadphase(const std::string &_type);
+
       private: btBroadphaseInterface *broadPhase;
       private: btDefaultCollisionConfiguration *collisionConfig;
       private: btCollisionDispatcher *dispatcher;
-      private: btSequentialImpulseConstraintSolver *solver;
-      private: btDiscreteDynamicsWorld *dynamicsWorld;
+      private: BulletDynamicsWorld *dynamicsWorld;
 
-      private: common::Time lastUpdateTime;
+      /// \brief Filters the pairs found by the broadphase.
+      private: btOverlapFilterCallback *filterCallback;
 
-      /// \brief The type of the solver.
-      private: std::string solverType;
+      private: common::Time lastUpdateTime;
     };
 
   /// \}
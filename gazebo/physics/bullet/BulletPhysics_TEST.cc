@@ -125,6 +125,31 @@ TEST_F(BulletPhysics_TEST, PhysicsParam)
   value = bulletPhysics->GetParam("contact_surface_layer");
   contactSurfaceLayerRet = boost::any_cast<double>(value);
   EXPECT_DOUBLE_EQ(contactSurfaceLayer, contactSurfaceLayerRet);
+
+  // Solve islands in parallel, and sweep and prune the bounding boxes
+  bulletPhysics->SetParam("threads", 4);
+  bulletPhysics->SetParam("broadphase", std::string("axis_sweep"));
+  value = bulletPhysics->GetParam("threads");
+  EXPECT_EQ(boost::any_cast<int>(value), 4);
+  value = bulletPhysics->GetParam("broadphase");
+  EXPECT_EQ(boost::any_cast<std::string>(value), "axis_sweep");
+
+  // Unknown types leave the current ones
+  bulletPhysics->SetParam("broadphase", std::string("unknown"));
+  value = bulletPhysics->GetParam(BulletPhysics::BROADPHASE_TYPE);
+  EXPECT_EQ(boost::any_cast<std::string>(value), "axis_sweep");
+  bulletPhysics->SetParam(BulletPhysics::SOLVER_TYPE, std::string("unknown"));
+  value = bulletPhysics->GetParam(BulletPhysics::SOLVER_TYPE);
+  EXPECT_EQ(boost::any_cast<std::string>(value), type);
+
+  // The world still steps after the broadphase changed
+  world->StepWorld(10);
+  bulletPhysics->SetParam(BulletPhysics::BROADPHASE_TYPE,
+      std::string("dbvt"));
+  bulletPhysics->SetParam(BulletPhysics::SOLVER_THREADS, 0);
+  world->StepWorld(10);
+  EXPECT_EQ(boost::any_cast<std::string>(
+        bulletPhysics->GetParam("broadphase")), "dbvt");
 }
 
 /////////////////////////////////////////////////
@@ -19,6 +19,12 @@
  * Date: 21 May 2009
  */
 
+#include <map>
+#include <string>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/weak_ptr.hpp>
+
 #include "common/Mesh.hh"
 
 #include "physics/bullet/BulletTypes.hh"
@@ -29,6 +35,29 @@
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Triangle data that is in use, indexed by mesh key. Only weak
+/// pointers are held, so the data is freed when the last shape using it is
+/// destroyed.
+static std::map<std::string, boost::weak_ptr<BulletTrimeshData> >
+  trimeshData;
+
+/// \brief Mutex that protects trimeshData.
+static boost::mutex trimeshDataMutex;
+
+//////////////////////////////////////////////////
+BulletTrimeshData::BulletTrimeshData()
+{
+  this->triMesh = NULL;
+  this->shape = NULL;
+}
+
+//////////////////////////////////////////////////
+BulletTrimeshData::~BulletTrimeshData()
+{
+  delete this->shape;
+  delete this->triMesh;
+}
+
 //////////////////////////////////////////////////
 BulletTrimeshShape::BulletTrimeshShape(CollisionPtr _parent)
   : TrimeshShape(_parent)
@@ -55,47 +84,76 @@ void BulletTrimeshShape::Init()
   BulletCollisionPtr bParent =
     boost::static_pointer_cast<BulletCollision>(this->collisionParent);
 
-  float *vertices = NULL;
-  int *indices = NULL;
+  std::string key = this->GetMeshKey();
 
-  btTriangleMesh *mTriMesh = new btTriangleMesh();
+  boost::mutex::scoped_lock lock(trimeshDataMutex);
 
-  unsigned int numVertices = this->mesh->GetVertexCount();
-  unsigned int numIndices = this->mesh->GetIndexCount();
+  // Reuse the collision shape of another trimesh with the same mesh and
+  // scale. Bullet collision shapes can be shared by any number of
+  // collision objects.
+  BulletTrimeshDataPtr sharedData = trimeshData[key].lock();
+  if (!sharedData)
+  {
+    sharedData.reset(new BulletTrimeshData());
 
-  // Get all the vertex and index data
-  this->mesh->FillArrays(&vertices, &indices);
+    float *vertices = NULL;
+    int *indices = NULL;
 
-  // Scale the vertex data
-  for (unsigned int j = 0;  j < numVertices; j++)
-  {
-    vertices[j*3+0] = vertices[j*3+0] * this->sdf->GetValueVector3("scale").x;
-    vertices[j*3+1] = vertices[j*3+1] * this->sdf->GetValueVector3("scale").y;
-    vertices[j*3+2] = vertices[j*3+2] * this->sdf->GetValueVector3("scale").z;
-  }
+    sharedData->triMesh = new btTriangleMesh();
 
-  // Create the Bullet trimesh
-  for (unsigned int j = 0; j < numIndices; j += 3)
-  {
-    btVector3 bv0(vertices[indices[j]*3+0],
-                  vertices[indices[j]*3+1],
-                  vertices[indices[j]*3+2]);
+    unsigned int numVertices = this->mesh->GetVertexCount();
+    unsigned int numIndices = this->mesh->GetIndexCount();
+
+    // Get all the vertex and index data
+    this->mesh->FillArrays(&vertices, &indices);
+
+    // Scale the vertex data
+    math::Vector3 scale = this->sdf->GetValueVector3("scale");
+    for (unsigned int j = 0;  j < numVertices; j++)
+    {
+      vertices[j*3+0] = vertices[j*3+0] * scale.x;
+      vertices[j*3+1] = vertices[j*3+1] * scale.y;
+      vertices[j*3+2] = vertices[j*3+2] * scale.z;
+    }
 
-    btVector3 bv1(vertices[indices[j+1]*3+0],
-                  vertices[indices[j+1]*3+1],
-                  vertices[indices[j+1]*3+2]);
+    // Create the Bullet trimesh
+    for (unsigned int j = 0; j < numIndices; j += 3)
+    {
+      btVector3 bv0(vertices[indices[j]*3+0],
+                    vertices[indices[j]*3+1],
+                    vertices[indices[j]*3+2]);
 
-    btVector3 bv2(vertices[indices[j+2]*3+0],
-                  vertices[indices[j+2]*3+1],
-                  vertices[indices[j+2]*3+2]);
+      btVector3 bv1(vertices[indices[j+1]*3+0],
+                    vertices[indices[j+1]*3+1],
+                    vertices[indices[j+1]*3+2]);
 
-    mTriMesh->addTriangle(bv0, bv1, bv2);
+      btVector3 bv2(vertices[indices[j+2]*3+0],
+                    vertices[indices[j+2]*3+1],
+                    vertices[indices[j+2]*3+2]);
+
+      sharedData->triMesh->addTriangle(bv0, bv1, bv2);
+    }
+
+    sharedData->shape =
+      new btConvexTriangleMeshShape(sharedData->triMesh, true);
+    sharedData->shape->setMargin(0.001f);
+
+    delete [] vertices;
+    delete [] indices;
+
+    trimeshData[key] = sharedData;
   }
 
-  btConvexShape* convexShape = new btConvexTriangleMeshShape(mTriMesh, true);
-  convexShape->setMargin(0.001f);
-  bParent->SetCollisionShape(convexShape);
+  // Remove entries whose data has been freed
+  std::map<std::string, boost::weak_ptr<BulletTrimeshData> >::iterator iter;
+  for (iter = trimeshData.begin(); iter != trimeshData.end();)
+  {
+    if (iter->second.expired())
+      trimeshData.erase(iter++);
+    else
+      ++iter;
+  }
 
-  delete [] vertices;
-  delete [] indices;
+  this->data = sharedData;
+  bParent->SetCollisionShape(this->data->shape);
 }
@@ -22,8 +22,13 @@
 #ifndef _BULLETTRIMESHSHAPE_HH_
 #define _BULLETTRIMESHSHAPE_HH_
 
+#include <boost/shared_ptr.hpp>
+
 #include "physics/TrimeshShape.hh"
 
+class btTriangleMesh;
+class btConvexShape;
+
 namespace gazebo
 {
   namespace physics
@@ -32,6 +37,28 @@ namespace gazebo
     /// \addtogroup gazebo_physics_bullet Bullet Physics
     /// \{
 
+    /// \brief Triangles and collision shape of a mesh. It is shared by all
+    /// the BulletTrimeshShapes that use the same mesh and scale, and is
+    /// destroyed along with the last of them.
+    class BulletTrimeshData
+    {
+      /// \brief Constructor.
+      public: BulletTrimeshData();
+
+      /// \brief Destructor.
+      public: virtual ~BulletTrimeshData();
+
+      /// \brief Scaled triangles of the mesh.
+      public: btTriangleMesh *triMesh;
+
+      /// \brief Collision shape built from triMesh.
+      public: btConvexShape *shape;
+    };
+
+    /// \def BulletTrimeshDataPtr
+    /// \brief Boost shared pointer to a BulletTrimeshData object.
+    typedef boost::shared_ptr<BulletTrimeshData> BulletTrimeshDataPtr;
+
     /// \brief Triangle mesh collision
     class BulletTrimeshShape : public TrimeshShape
     {
@@ -45,6 +72,10 @@ namespace gazebo
       public: virtual void Load(sdf::ElementPtr _sdf);
 
       protected: virtual void Init();
+
+      /// \brief Triangle data, shared with other shapes that use the same
+      /// mesh and scale.
+      private: BulletTrimeshDataPtr data;
     };
 
     /// \}
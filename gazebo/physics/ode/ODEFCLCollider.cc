@@ -0,0 +1,228 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <fcl/BVH_model.h>
+#include <fcl/broad_phase_collision.h>
+#include <fcl/collision.h>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/physics/Contact.hh"
+#include "gazebo/physics/ode/ODECollision.hh"
+#include "gazebo/physics/ode/ODEPhysics.hh"
+#include "gazebo/physics/ode/ODEFCLCollider.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+//////////////////////////////////////////////////
+ODEFCLCollider::ODEFCLCollider(ODEPhysics *_physics)
+  : physics(_physics)
+{
+  this->manager = new fcl::SaPCollisionManager();
+  this->contactGeoms.resize(MAX_COLLIDE_RETURNS);
+}
+
+//////////////////////////////////////////////////
+ODEFCLCollider::~ODEFCLCollider()
+{
+  delete this->manager;
+
+  for (std::map<ODECollision*, fcl::BVHModel<fcl::OBB>*>::iterator iter =
+       this->models.begin(); iter != this->models.end(); ++iter)
+  {
+    delete iter->second;
+  }
+  this->models.clear();
+  this->collisions.clear();
+}
+
+//////////////////////////////////////////////////
+fcl::BVHModel<fcl::OBB> *ODEFCLCollider::BuildModel(
+    const float *_vertices, unsigned int _vertexCount,
+    const int *_indices, unsigned int _indexCount)
+{
+  if (_indexCount < 3)
+    return NULL;
+
+  std::vector<fcl::Vec3f> points(_vertexCount);
+  for (unsigned int i = 0; i < _vertexCount; ++i)
+  {
+    points[i] = fcl::Vec3f(_vertices[i*3+0], _vertices[i*3+1],
+                           _vertices[i*3+2]);
+  }
+
+  std::vector<fcl::Triangle> triangles(_indexCount / 3);
+  for (unsigned int i = 0; i < triangles.size(); ++i)
+  {
+    triangles[i] = fcl::Triangle(_indices[i*3+0], _indices[i*3+1],
+                                 _indices[i*3+2]);
+  }
+
+  fcl::BVHModel<fcl::OBB> *model = new fcl::BVHModel<fcl::OBB>();
+  model->beginModel(triangles.size(), points.size());
+  model->addSubModel(points, triangles);
+  model->endModel();
+
+  // The broad phase uses the bounding sphere of the local box
+  model->computeLocalAABB();
+
+  return model;
+}
+
+//////////////////////////////////////////////////
+void ODEFCLCollider::DeleteModel(fcl::BVHModel<fcl::OBB> *_model)
+{
+  delete _model;
+}
+
+//////////////////////////////////////////////////
+void ODEFCLCollider::AddMesh(ODECollision *_collision,
+                             const fcl::BVHModel<fcl::OBB> *_model)
+{
+  this->RemoveMesh(_collision);
+
+  if (!_model)
+    return;
+
+  fcl::BVHModel<fcl::OBB> *model = new fcl::BVHModel<fcl::OBB>(*_model);
+  model->computeAABB();
+
+  this->models[_collision] = model;
+  this->collisions[model] = _collision;
+  this->manager->registerObject(model);
+}
+
+//////////////////////////////////////////////////
+void ODEFCLCollider::RemoveMesh(ODECollision *_collision)
+{
+  std::map<ODECollision*, fcl::BVHModel<fcl::OBB>*>::iterator iter =
+    this->models.find(_collision);
+  if (iter == this->models.end())
+    return;
+
+  this->manager->unregisterObject(iter->second);
+  this->collisions.erase(iter->second);
+  delete iter->second;
+  this->models.erase(iter);
+}
+
+//////////////////////////////////////////////////
+bool ODEFCLCollider::HasMesh(ODECollision *_collision) const
+{
+  return this->models.find(_collision) != this->models.end();
+}
+
+//////////////////////////////////////////////////
+void ODEFCLCollider::Collide()
+{
+  if (this->models.size() < 2)
+    return;
+
+  // Move the FCL models to the pose of their geoms
+  for (std::map<ODECollision*, fcl::BVHModel<fcl::OBB>*>::iterator iter =
+       this->models.begin(); iter != this->models.end(); ++iter)
+  {
+    dGeomID geom = iter->first->GetCollisionId();
+    const dReal *pos = dGeomGetPosition(geom);
+    const dReal *rot = dGeomGetRotation(geom);
+
+    fcl::Vec3f R[3] = {fcl::Vec3f(rot[0], rot[1], rot[2]),
+                       fcl::Vec3f(rot[4], rot[5], rot[6]),
+                       fcl::Vec3f(rot[8], rot[9], rot[10])};
+    iter->second->setTransform(R, fcl::Vec3f(pos[0], pos[1], pos[2]));
+    iter->second->computeAABB();
+  }
+
+  this->manager->update();
+  this->manager->collide(this, &ODEFCLCollider::CollisionCallback);
+}
+
+//////////////////////////////////////////////////
+bool ODEFCLCollider::CollisionCallback(fcl::CollisionObject *_o1,
+    fcl::CollisionObject *_o2, void *_data)
+{
+  ODEFCLCollider *self = static_cast<ODEFCLCollider*>(_data);
+
+  std::map<fcl::CollisionObject*, ODECollision*>::iterator iter1 =
+    self->collisions.find(_o1);
+  std::map<fcl::CollisionObject*, ODECollision*>::iterator iter2 =
+    self->collisions.find(_o2);
+
+  if (iter1 != self->collisions.end() && iter2 != self->collisions.end())
+    self->Collide(iter1->second, _o1, iter2->second, _o2);
+
+  return false;
+}
+
+//////////////////////////////////////////////////
+void ODEFCLCollider::Collide(ODECollision *_collision1,
+    fcl::CollisionObject *_o1, ODECollision *_collision2,
+    fcl::CollisionObject *_o2)
+{
+  dGeomID g1 = _collision1->GetCollisionId();
+  dGeomID g2 = _collision2->GetCollisionId();
+
+  // Apply the same filters as the ODE space collision
+  if (!(dGeomGetCategoryBits(g1) & dGeomGetCollideBits(g2)) &&
+      !(dGeomGetCategoryBits(g2) & dGeomGetCollideBits(g1)))
+  {
+    return;
+  }
+
+  dBodyID b1 = dGeomGetBody(g1);
+  dBodyID b2 = dGeomGetBody(g2);
+
+  if (b1 == b2)
+    return;
+
+  if (b1 && b2 && dAreConnectedExcluding(b1, b2, dJointTypeContact))
+    return;
+
+  if ((!b1 || !dBodyIsEnabled(b1)) && (!b2 || !dBodyIsEnabled(b2)))
+    return;
+
+  std::vector<fcl::Contact> contacts;
+  int numc = fcl::collide(_o1, _o2, MAX_COLLIDE_RETURNS, false, true,
+                          contacts);
+  if (numc <= 0)
+    return;
+
+  for (int i = 0; i < numc; ++i)
+  {
+    const fcl::Contact &c = contacts[i];
+    dContactGeom &geom = this->contactGeoms[i];
+
+    // The normal points from the second object to the first, like ODE
+    double sign = c.o1 == _o1 ? 1.0 : -1.0;
+
+    geom.pos[0] = c.pos[0];
+    geom.pos[1] = c.pos[1];
+    geom.pos[2] = c.pos[2];
+    geom.pos[3] = 0;
+    geom.normal[0] = sign * c.normal[0];
+    geom.normal[1] = sign * c.normal[1];
+    geom.normal[2] = sign * c.normal[2];
+    geom.normal[3] = 0;
+    geom.depth = c.penetration_depth;
+    geom.g1 = g1;
+    geom.g2 = g2;
+    geom.side1 = c.o1 == _o1 ? c.b1 : c.b2;
+    geom.side2 = c.o1 == _o1 ? c.b2 : c.b1;
+  }
+
+  this->physics->AddContacts(_collision1, _collision2,
+                             &this->contactGeoms[0], numc);
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _ODEFCLCOLLIDER_HH_
+#define _ODEFCLCOLLIDER_HH_
+
+#include <map>
+#include <vector>
+
+#include "gazebo/physics/ode/ode_inc.h"
+#include "gazebo/physics/ode/ODETypes.hh"
+
+namespace fcl
+{
+  class CollisionObject;
+  class OBB;
+  class SaPCollisionManager;
+  template<typename BV> class BVHModel;
+}
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief Triangle mesh collision detection with FCL, used by an ODE
+    /// world in place of OPCODE when <collision_detector> is "fcl".
+    ///
+    /// Each registered mesh has its own copy of an FCL OBB tree, since
+    /// FCL stores the pose in the model. Pairs of registered meshes are
+    /// found by a sweep and prune broad phase, tested by FCL, and their
+    /// contacts are turned into contact joints by ODEPhysics.
+    class ODEFCLCollider
+    {
+      /// \brief Constructor.
+      /// \param[in] _physics ODE physics engine that receives the contacts.
+      public: explicit ODEFCLCollider(ODEPhysics *_physics);
+
+      /// \brief Destructor.
+      public: virtual ~ODEFCLCollider();
+
+      /// \brief Build the OBB tree of a triangle mesh. The tree is used as
+      /// a prototype by AddMesh.
+      /// \param[in] _vertices Array of x, y, z vertex values.
+      /// \param[in] _vertexCount Number of vertices.
+      /// \param[in] _indices Array of vertex indices, three per triangle.
+      /// \param[in] _indexCount Number of indices.
+      /// \return The new model, NULL if the mesh has no triangles.
+      public: static fcl::BVHModel<fcl::OBB> *BuildModel(
+                  const float *_vertices, unsigned int _vertexCount,
+                  const int *_indices, unsigned int _indexCount);
+
+      /// \brief Delete a model returned by BuildModel.
+      /// \param[in] _model The model to delete.
+      public: static void DeleteModel(fcl::BVHModel<fcl::OBB> *_model);
+
+      /// \brief Add a triangle mesh collision, or replace its model.
+      /// \param[in] _collision The collision, which has a trimesh shape.
+      /// \param[in] _model Model of the mesh, copied by this function.
+      public: void AddMesh(ODECollision *_collision,
+                           const fcl::BVHModel<fcl::OBB> *_model);
+
+      /// \brief Remove a triangle mesh collision.
+      /// \param[in] _collision The collision given to AddMesh.
+      public: void RemoveMesh(ODECollision *_collision);
+
+      /// \brief Get whether a collision was added with AddMesh.
+      /// \param[in] _collision The collision to look for.
+      /// \return True if the collision is handled by this collider.
+      public: bool HasMesh(ODECollision *_collision) const;
+
+      /// \brief Find the contacts between all the meshes, and add contact
+      /// joints for them.
+      public: void Collide();
+
+      /// \brief Broad phase callback.
+      /// \param[in] _o1 First FCL object of an overlapping pair.
+      /// \param[in] _o2 Second FCL object.
+      /// \param[in] _data Pointer to this collider.
+      /// \return False, to keep going through the pairs.
+      private: static bool CollisionCallback(fcl::CollisionObject *_o1,
+                   fcl::CollisionObject *_o2, void *_data);
+
+      /// \brief Test a pair of meshes and add contact joints.
+      /// \param[in] _collision1 First collision.
+      /// \param[in] _o1 FCL object of the first collision.
+      /// \param[in] _collision2 Second collision.
+      /// \param[in] _o2 FCL object of the second collision.
+      private: void Collide(ODECollision *_collision1,
+                            fcl::CollisionObject *_o1,
+                            ODECollision *_collision2,
+                            fcl::CollisionObject *_o2);
+
+      /// \brief Physics engine that owns this collider.
+      private: ODEPhysics *physics;
+
+      /// \brief Sweep and prune broad phase.
+      private: fcl::SaPCollisionManager *manager;
+
+      /// \brief FCL model of each collision.
+      private: std::map<ODECollision*, fcl::BVHModel<fcl::OBB>*> models;
+
+      /// \brief Collision of each FCL object, for the broad phase callback.
+      private: std::map<fcl::CollisionObject*, ODECollision*> collisions;
+
+      /// \brief Contacts of the pair being tested, in ODE format.
+      private: std::vector<dContactGeom> contactGeoms;
+    };
+  }
+}
+#endif
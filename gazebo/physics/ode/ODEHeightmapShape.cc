@@ -30,18 +30,37 @@ using namespace physics;
 ODEHeightmapShape::ODEHeightmapShape(CollisionPtr _parent)
     : HeightmapShape(_parent)
 {
+  this->odeData = NULL;
+  this->tileSpace = NULL;
 }
 
 //////////////////////////////////////////////////
 ODEHeightmapShape::~ODEHeightmapShape()
 {
+  for (std::map<unsigned int, HeightmapTile*>::iterator iter =
+       this->tiles.begin(); iter != this->tiles.end(); ++iter)
+  {
+    this->OnTileUnloaded(iter->second);
+  }
 }
 
 //////////////////////////////////////////////////
-dReal ODEHeightmapShape::GetHeightCallback(void *_data, int _x, int _y)
+void ODEHeightmapShape::GetOrientation(dQuaternion _q) const
 {
-  // Return the height at a specific vertex
-  return static_cast<ODEHeightmapShape*>(_data)->GetHeight(_x, _y);
+  // Rotate so Z is up, not Y (which is the default orientation)
+  math::Quaternion quat;
+  math::Pose pose = this->collisionParent->GetWorldPose();
+
+  // TODO: FIXME:  double check this, if Y is up,
+  // rotating by roll of 90 deg will put Z-down.
+  quat.SetFromEuler(math::Vector3(GZ_DTOR(90), 0, 0));
+
+  pose.rot = pose.rot * quat;
+
+  _q[0] = pose.rot.w;
+  _q[1] = pose.rot.x;
+  _q[2] = pose.rot.y;
+  _q[3] = pose.rot.z;
 }
 
 //////////////////////////////////////////////////
@@ -52,14 +71,26 @@ void ODEHeightmapShape::Init()
   ODECollisionPtr oParent =
     boost::static_pointer_cast<ODECollision>(this->collisionParent);
 
+  if (this->IsTiled())
+  {
+    // Each tile gets its own heightfield geom, which is added to this
+    // space when the tile is loaded. The geoms are owned by this shape,
+    // not the space.
+    this->tileSpace = dSimpleSpaceCreate(oParent->GetSpaceId());
+    dSpaceSetCleanup(this->tileSpace, 0);
+    oParent->SetCollision(reinterpret_cast<dGeomID>(this->tileSpace), false);
+    oParent->SetStatic(true);
+    return;
+  }
+
   // Step 2: Create the ODE heightfield collision
   this->odeData = dGeomHeightfieldDataCreate();
 
-  // Step 3: Setup a callback method for ODE
-  dGeomHeightfieldDataBuildCallback(
+  // Step 3: Point ODE to the height data, which is used in place
+  dGeomHeightfieldDataBuildSingle(
       this->odeData,
-      this,
-      ODEHeightmapShape::GetHeightCallback,
+      &this->heights[0],
+      0,  // don't copy the heights
       this->GetSize().x,  // in meters
       this->GetSize().y,  // in meters
       this->vertSize,  // width sampling size
@@ -70,27 +101,67 @@ void ODEHeightmapShape::Init()
       0);  // wrap mode
 
   // Step 4: Restrict the bounds of the AABB to improve efficiency
-  dGeomHeightfieldDataSetBounds(this->odeData, 0, this->GetSize().z);
+  dGeomHeightfieldDataSetBounds(this->odeData, this->GetMinHeight(),
+                                this->GetMaxHeight());
 
   oParent->SetCollision(dCreateHeightfield(0, this->odeData, 1), false);
   oParent->SetStatic(true);
 
-  // Rotate so Z is up, not Y (which is the default orientation)
-  math::Quaternion quat;
-  math::Pose pose = oParent->GetWorldPose();
+  dQuaternion q;
+  this->GetOrientation(q);
+  dGeomSetQuaternion(oParent->GetCollisionId(), q);
+}
 
-  // TODO: FIXME:  double check this, if Y is up,
-  // rotating by roll of 90 deg will put Z-down.
-  quat.SetFromEuler(math::Vector3(GZ_DTOR(90), 0, 0));
+//////////////////////////////////////////////////
+void ODEHeightmapShape::OnTileLoaded(HeightmapTile *_tile)
+{
+  ODECollisionPtr oParent =
+    boost::static_pointer_cast<ODECollision>(this->collisionParent);
 
-  pose.rot = pose.rot * quat;
-  // this->body->SetPose(pose);
+  math::Vector3 size = this->GetSize();
+  unsigned int tilesPerSide =
+    (this->vertSize - 1) / (this->GetTileSize() - 1);
+
+  dHeightfieldDataID data = dGeomHeightfieldDataCreate();
+  dGeomHeightfieldDataBuildSingle(
+      data,
+      &_tile->heights[0],
+      0,  // don't copy the heights
+      size.x / tilesPerSide,  // in meters
+      size.y / tilesPerSide,  // in meters
+      this->GetTileSize(),  // width sampling size
+      this->GetTileSize(),  // depth sampling size
+      1.0,  // vertical (z-axis) scaling
+      this->GetPos().z,  // vertical (z-axis) offset
+      1.0,  // vertical thickness for closing the height map mesh
+      0);  // wrap mode
+  dGeomHeightfieldDataSetBounds(data, _tile->minHeight, _tile->maxHeight);
+
+  dGeomID geom = dCreateHeightfield(this->tileSpace, data, 1);
+
+  // Contacts with the tile are reported against the heightmap collision
+  dGeomSetData(geom, oParent.get());
+
+  math::Vector3 pos = oParent->GetWorldPose().pos + this->GetPos() +
+    _tile->center;
+  dGeomSetPosition(geom, pos.x, pos.y, oParent->GetWorldPose().pos.z);
 
   dQuaternion q;
-  q[0] = pose.rot.w;
-  q[1] = pose.rot.x;
-  q[2] = pose.rot.y;
-  q[3] = pose.rot.z;
+  this->GetOrientation(q);
+  dGeomSetQuaternion(geom, q);
 
-  dGeomSetQuaternion(oParent->GetCollisionId(), q);
+  this->tileGeoms[_tile] = std::make_pair(geom, data);
+}
+
+//////////////////////////////////////////////////
+void ODEHeightmapShape::OnTileUnloaded(HeightmapTile *_tile)
+{
+  std::map<HeightmapTile*, std::pair<dGeomID, dHeightfieldDataID> >::iterator
+    iter = this->tileGeoms.find(_tile);
+  if (iter == this->tileGeoms.end())
+    return;
+
+  dGeomDestroy(iter->second.first);
+  dGeomHeightfieldDataDestroy(iter->second.second);
+  this->tileGeoms.erase(iter);
 }
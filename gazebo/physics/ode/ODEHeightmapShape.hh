@@ -22,6 +22,8 @@
 #ifndef _ODEHEIGHTMAPSHAPE_HH_
 #define _ODEHEIGHTMAPSHAPE_HH_
 
+#include <map>
+#include <utility>
 #include <vector>
 
 #include "gazebo/physics/HeightmapShape.hh"
@@ -45,14 +47,25 @@ namespace gazebo
       // Documentation inerited.
       public: virtual void Init();
 
-      /// \brief Called by ODE to get the height at a vertex.
-      /// \param[in] _data Pointer to the heightmap data.
-      /// \param[in] _x X location.
-      /// \param[in] _y Y location.
-      private: static dReal GetHeightCallback(void *_data, int _x, int _y);
+      // Documentation inherited.
+      protected: virtual void OnTileLoaded(HeightmapTile *_tile);
+
+      // Documentation inherited.
+      protected: virtual void OnTileUnloaded(HeightmapTile *_tile);
+
+      /// \brief Get the orientation of the ODE heightfield geoms.
+      /// \param[out] _q Orientation, rotated so that Z is up.
+      private: void GetOrientation(dQuaternion _q) const;
 
       /// \brief The heightmap data.
       private: dHeightfieldDataID odeData;
+
+      /// \brief Space that holds the geoms of the loaded tiles.
+      private: dSpaceID tileSpace;
+
+      /// \brief Heightfield geom and data of each loaded tile.
+      private: std::map<HeightmapTile*,
+               std::pair<dGeomID, dHeightfieldDataID> > tileGeoms;
     };
   }
 }
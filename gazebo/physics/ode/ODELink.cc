@@ -20,6 +20,7 @@
  */
 
 #include <math.h>
+#include <algorithm>
 #include <sstream>
 
 #include "gazebo/common/Assert.hh"
@@ -151,6 +152,22 @@ void ODELink::Init()
   {
     dBodySetMovedCallback(this->linkId, MoveCallback);
     dBodySetDisabledCallback(this->linkId, DisabledCallback);
+
+    // Sweep the motion of fast links so they don't pass through thin
+    // objects
+    if (this->sdf->HasElement("ccd"))
+    {
+      sdf::ElementPtr ccdElem = this->sdf->GetElement("ccd");
+      double radius = ccdElem->GetValueDouble("swept_sphere_radius");
+      if (radius <= 0)
+      {
+        math::Vector3 size = this->GetBoundingBox().GetSize();
+        radius = 0.5 * std::min(size.x, std::min(size.y, size.z));
+      }
+
+      this->odePhysics->AddCCDLink(this,
+          ccdElem->GetValueDouble("velocity_threshold"), radius);
+    }
   }
   else
   {
@@ -195,6 +212,8 @@ void ODELink::MoveCallback(dBodyID _id)
 //////////////////////////////////////////////////
 void ODELink::Fini()
 {
+  if (this->odePhysics)
+    this->odePhysics->RemoveCCDLink(this);
   Link::Fini();
   if (this->linkId)
     dBodyDestroy(this->linkId);
@@ -22,7 +22,6 @@
 #include <tbb/blocked_range.h>
 
 #include "gazebo/gazebo_config.h"
-#include "gazebo/util/Diagnostics.hh"
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
@@ -30,6 +29,7 @@
 #include "gazebo/math/Rand.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/common/Timer.hh"
+#include "gazebo/common/Trace.hh"
 
 #include "gazebo/transport/Publisher.hh"
 
@@ -44,6 +44,7 @@
 #include "gazebo/physics/ContactManager.hh"
 
 #include "gazebo/physics/ode/ODECollision.hh"
+#include "gazebo/physics/ode/ODEFCLCollider.hh"
 #include "gazebo/physics/ode/ODELink.hh"
 #include "gazebo/physics/ode/ODEScrewJoint.hh"
 #include "gazebo/physics/ode/ODEHingeJoint.hh"
@@ -131,6 +132,15 @@ ODEPhysics::ODEPhysics(WorldPtr _world)
 
   this->colliders.resize(100);
 
+  this->fclCollider = NULL;
+
+  // The ray is in no space, and is only collided by SweepCCDLinks
+  this->ccdRay = dCreateRay(0, 1.0);
+  dGeomRaySetParams(this->ccdRay, 0, 0);
+  dGeomRaySetClosestHit(this->ccdRay, 1);
+  this->ccdBody = NULL;
+  this->ccdDepth = 0;
+
   // Set random seed for physics engine based on gazebo's random seed.
   // Note: this was moved from physics::PhysicsEngine constructor.
   this->SetSeed(math::Rand::GetSeed());
@@ -139,6 +149,12 @@ ODEPhysics::ODEPhysics(WorldPtr _world)
 //////////////////////////////////////////////////
 ODEPhysics::~ODEPhysics()
 {
+  delete this->fclCollider;
+  this->fclCollider = NULL;
+
+  dGeomDestroy(this->ccdRay);
+  this->ccdRay = NULL;
+
   dCloseODE();
 
   dJointGroupDestroy(this->contactGroup);
@@ -215,6 +231,30 @@ void ODEPhysics::Load(sdf::ElementPtr _sdf)
   dWorldSetQuickStepNumIterations(this->worldId, this->GetSORPGSIters());
   dWorldSetQuickStepW(this->worldId, this->GetSORPGSW());
 
+  // Graph colored rows give the same result with any number of threads
+  if (solverElem->HasElement("threads"))
+  {
+    dWorldSetQuickStepColoredThreads(this->worldId,
+        solverElem->GetValueInt("threads"));
+  }
+
+  // Triangle meshes are collided by OPCODE inside ODE unless FCL is
+  // selected. The choice is made before any mesh is loaded.
+  std::string detector = "ode";
+  if (odeElem->HasElement("collision_detector"))
+    detector = odeElem->GetValueString("collision_detector");
+
+  if (detector == "fcl")
+  {
+    if (!this->fclCollider)
+      this->fclCollider = new ODEFCLCollider(this);
+  }
+  else if (detector != "ode")
+  {
+    gzerr << "Invalid collision detector[" << detector
+          << "], using ode\n";
+  }
+
   // Set the physics update function
   if (this->stepType == "quick")
     this->physicsStepFunc = &dWorldQuickStep;
@@ -351,7 +391,7 @@ void ODEPhysics::InitForThread()
 //////////////////////////////////////////////////
 void ODEPhysics::UpdateCollision()
 {
-  DIAG_TIMER_START("ODEPhysics::UpdateCollision");
+  GZ_TRACE_SCOPE("ODEPhysics::UpdateCollision");
 
   boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
   dJointGroupEmpty(this->contactGroup);
@@ -365,41 +405,67 @@ void ODEPhysics::UpdateCollision()
   this->contactManager->ResetCount();
 
   // Do collision detection; this will add contacts to the contact group
+  GZ_TRACE_BEGIN("ODEPhysics::dSpaceCollide");
   dSpaceCollide(this->spaceId, this, CollisionCallback);
-  DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "dSpaceCollide");
+  GZ_TRACE_END("ODEPhysics::dSpaceCollide");
 
   // Generate non-trimesh collisions.
+  GZ_TRACE_BEGIN("ODEPhysics::collideShapes");
   for (i = 0; i < this->collidersCount; ++i)
   {
     this->Collide(this->colliders[i].first,
         this->colliders[i].second, this->contactCollisions);
   }
-  DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "collideShapes");
+  GZ_TRACE_END("ODEPhysics::collideShapes");
 
   // Generate trimesh collision.
   // This must happen in this thread sequentially
+  GZ_TRACE_BEGIN("ODEPhysics::collideTrimeshes");
   for (i = 0; i < this->trimeshCollidersCount; ++i)
   {
     ODECollision *collision1 = this->trimeshColliders[i].first;
     ODECollision *collision2 = this->trimeshColliders[i].second;
     this->Collide(collision1, collision2, this->contactCollisions);
   }
-  DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "collideTrimeshes");
+  GZ_TRACE_END("ODEPhysics::collideTrimeshes");
 
-  DIAG_TIMER_STOP("ODEPhysics::UpdateCollision");
+  // Generate the contacts between meshes collided by FCL
+  if (this->fclCollider)
+  {
+    GZ_TRACE_BEGIN("ODEPhysics::collideFCL");
+    this->fclCollider->Collide();
+    GZ_TRACE_END("ODEPhysics::collideFCL");
+  }
 }
 
 //////////////////////////////////////////////////
 void ODEPhysics::UpdatePhysics()
 {
-  DIAG_TIMER_START("ODEPhysics::UpdatePhysics");
+  GZ_TRACE_SCOPE("ODEPhysics::UpdatePhysics");
 
   // need to lock, otherwise might conflict with world resetting
   {
     boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
 
+    // Remember where the swept links start
+    for (std::vector<ODECCDLink>::iterator iter = this->ccdLinks.begin();
+         iter != this->ccdLinks.end(); ++iter)
+    {
+      const dReal *pos = dBodyGetPosition(iter->link->GetODEId());
+      dCopyVector3(iter->start, pos);
+    }
+
     // Update the dynamical model
+    GZ_TRACE_BEGIN("ODEPhysics::step");
     (*physicsStepFunc)(this->worldId, this->maxStepSize);
+    GZ_TRACE_END("ODEPhysics::step");
+
+    if (!this->ccdLinks.empty())
+    {
+      GZ_TRACE_BEGIN("ODEPhysics::sweepCCDLinks");
+      this->SweepCCDLinks();
+      GZ_TRACE_END("ODEPhysics::sweepCCDLinks");
+    }
 
     math::Vector3 f1, f2, t1, t2;
 
@@ -433,8 +499,6 @@ void ODEPhysics::UpdatePhysics()
       }
     }
   }
-
-  DIAG_TIMER_STOP("ODEPhysics::UpdatePhysics");
 }
 
 //////////////////////////////////////////////////
@@ -781,6 +845,11 @@ void ODEPhysics::CollisionCallback(void *_data, dGeomID _o1, dGeomID _o2)
     // Make sure both collision pointers are valid.
     if (collision1 && collision2)
     {
+      // Pairs of meshes are found by the FCL broad phase
+      if (self->fclCollider && self->fclCollider->HasMesh(collision1) &&
+          self->fclCollider->HasMesh(collision2))
+        return;
+
       // Add either a tri-mesh collider or a regular collider.
       if (collision1->HasType(Base::TRIMESH_SHAPE) ||
           collision2->HasType(Base::TRIMESH_SHAPE))
@@ -798,7 +867,20 @@ void ODEPhysics::CollisionCallback(void *_data, dGeomID _o1, dGeomID _o2)
 void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
                          dContactGeom *_contactCollisions)
 {
-  int numc = 0;
+  // Generate the contacts
+  int numc = dCollide(_collision1->GetCollisionId(),
+      _collision2->GetCollisionId(), MAX_COLLIDE_RETURNS, _contactCollisions,
+      sizeof(_contactCollisions[0]));
+
+  this->AddContacts(_collision1, _collision2, _contactCollisions, numc);
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::AddContacts(ODECollision *_collision1,
+                             ODECollision *_collision2,
+                             dContactGeom *_contactCollisions, int _count)
+{
+  int numc = _count;
   dContact contact;
 
   // maxCollide must less than the size of this->indices. Check the header
@@ -806,10 +888,6 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
   if (this->GetMaxContacts() < MAX_CONTACT_JOINTS)
     maxCollide = this->GetMaxContacts();
 
-  // Generate the contacts
-  numc = dCollide(_collision1->GetCollisionId(), _collision2->GetCollisionId(),
-      MAX_COLLIDE_RETURNS, _contactCollisions, sizeof(_contactCollisions[0]));
-
   // Return if no contacts.
   if (numc <= 0)
     return;
@@ -992,6 +1070,144 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
   }
 }
 
+/////////////////////////////////////////////////
+void ODEPhysics::AddCCDLink(ODELink *_link, double _velocityThreshold,
+                            double _radius)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  if (!_link->GetODEId())
+    return;
+
+  this->RemoveCCDLink(_link);
+
+  ODECCDLink ccdLink;
+  ccdLink.link = _link;
+  ccdLink.velocityThreshold = _velocityThreshold;
+  ccdLink.radius = _radius;
+  dCopyVector3(ccdLink.start, dBodyGetPosition(_link->GetODEId()));
+  this->ccdLinks.push_back(ccdLink);
+}
+
+/////////////////////////////////////////////////
+void ODEPhysics::RemoveCCDLink(ODELink *_link)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  for (std::vector<ODECCDLink>::iterator iter = this->ccdLinks.begin();
+       iter != this->ccdLinks.end(); ++iter)
+  {
+    if (iter->link == _link)
+    {
+      this->ccdLinks.erase(iter);
+      return;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void ODEPhysics::SweepCCDLinks()
+{
+  for (std::vector<ODECCDLink>::iterator iter = this->ccdLinks.begin();
+       iter != this->ccdLinks.end(); ++iter)
+  {
+    dBodyID body = iter->link->GetODEId();
+    if (!dBodyIsEnabled(body))
+      continue;
+
+    const dReal *pos = dBodyGetPosition(body);
+    math::Vector3 start(iter->start[0], iter->start[1], iter->start[2]);
+    math::Vector3 motion = math::Vector3(pos[0], pos[1], pos[2]) - start;
+    double distance = motion.GetLength();
+
+    if (distance <= 1e-9 ||
+        distance <= iter->velocityThreshold * this->maxStepSize)
+      continue;
+
+    // Cast a ray along the motion of the center, far enough for the
+    // front of the sphere
+    math::Vector3 dir = motion / distance;
+    dGeomRaySet(this->ccdRay, start.x, start.y, start.z, dir.x, dir.y, dir.z);
+    dGeomRaySetLength(this->ccdRay, distance + iter->radius);
+
+    // Only hit what the link collides with
+    dGeomID geom = dBodyGetFirstGeom(body);
+    if (geom)
+    {
+      dGeomSetCategoryBits(this->ccdRay, dGeomGetCategoryBits(geom));
+      dGeomSetCollideBits(this->ccdRay, dGeomGetCollideBits(geom));
+    }
+
+    this->ccdBody = body;
+    this->ccdDepth = distance + iter->radius;
+    this->ccdNormal = math::Vector3::Zero;
+    dSpaceCollide2(this->ccdRay, reinterpret_cast<dGeomID>(this->spaceId),
+                   this, &CCDCallback);
+
+    // Nothing in the way, or the sphere only touches it at the end
+    double allowed = std::max(0.0, this->ccdDepth - iter->radius);
+    if (this->ccdNormal == math::Vector3::Zero || allowed >= distance)
+      continue;
+
+    math::Vector3 stop = start + dir * allowed;
+    dBodySetPosition(body, stop.x, stop.y, stop.z);
+
+    // Remove the velocity into the surface, and leave the rest to the
+    // contacts of the next step
+    math::Vector3 normal = this->ccdNormal;
+    if (normal.Dot(dir) > 0)
+      normal = -normal;
+
+    const dReal *v = dBodyGetLinearVel(body);
+    math::Vector3 vel(v[0], v[1], v[2]);
+    double normalVel = vel.Dot(normal);
+    if (normalVel < 0)
+    {
+      vel -= normal * normalVel;
+      dBodySetLinearVel(body, vel.x, vel.y, vel.z);
+    }
+
+    ODELink::MoveCallback(body);
+  }
+}
+
+/////////////////////////////////////////////////
+void ODEPhysics::CCDCallback(void *_data, dGeomID _o1, dGeomID _o2)
+{
+  ODEPhysics *self = static_cast<ODEPhysics*>(_data);
+
+  if (dGeomIsSpace(_o1) || dGeomIsSpace(_o2))
+  {
+    dSpaceCollide2(_o1, _o2, self, &CCDCallback);
+    return;
+  }
+
+  dGeomID hit = _o1 == self->ccdRay ? _o2 : _o1;
+  if (dGeomGetClass(hit) == dRayClass)
+    return;
+
+  // Skip the link itself, and the links it is jointed to
+  dBodyID hitBody = dGeomGetBody(hit);
+  if (hitBody == self->ccdBody || (hitBody &&
+      dAreConnectedExcluding(self->ccdBody, hitBody, dJointTypeContact)))
+    return;
+
+  dContactGeom contact;
+  if (dCollide(self->ccdRay, hit, 1, &contact, sizeof(contact)) > 0 &&
+      contact.depth < self->ccdDepth)
+  {
+    self->ccdDepth = contact.depth;
+    self->ccdNormal.Set(contact.normal[0], contact.normal[1],
+                        contact.normal[2]);
+  }
+}
+
+/////////////////////////////////////////////////
+ODEFCLCollider *ODEPhysics::GetFCLCollider() const
+{
+  return this->fclCollider;
+}
+
 /////////////////////////////////////////////////
 void ODEPhysics::AddTrimeshCollider(ODECollision *_collision1,
                                     ODECollision *_collision2)
@@ -1073,6 +1289,26 @@ void ODEPhysics::SetSeed(uint32_t _seed)
   dRandSetSeed(_seed);
 }
 
+//////////////////////////////////////////////////
+void ODEPhysics::Snapshot(common::SnapshotBuffer &_buffer)
+{
+  // The quickstep solver draws from this to reorder the constraints
+  _buffer.Write(static_cast<uint64_t>(dRandGetSeed()));
+}
+
+//////////////////////////////////////////////////
+bool ODEPhysics::Restore(common::SnapshotBuffer &_buffer)
+{
+  uint64_t seed = 0;
+  if (!_buffer.Read(seed))
+    return false;
+
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+  dRandSetSeed(seed);
+  dJointGroupEmpty(this->contactGroup);
+  return true;
+}
+
 //////////////////////////////////////////////////
 void ODEPhysics::SetParam(ODEParam _param, const boost::any &_value)
 {
@@ -1219,6 +1455,21 @@ void ODEPhysics::SetParam(ODEParam _param, const boost::any &_value)
       odeElem->GetElement("solver")->GetElement("min_step_size")->Set(value);
       break;
     }
+    case SOLVER_THREADS:
+    {
+      int value;
+      try
+      {
+        value = boost::any_cast<int>(_value);
+      }
+      catch(boost::bad_any_cast &e)
+      {
+        value = boost::any_cast<unsigned int>(_value);
+      }
+      odeElem->GetElement("solver")->GetElement("threads")->Set(value);
+      dWorldSetQuickStepColoredThreads(this->worldId, value);
+      break;
+    }
     default:
     {
       gzwarn << "Param not supported in ode" << std::endl;
@@ -1252,6 +1503,8 @@ void ODEPhysics::SetParam(const std::string &_key, const boost::any &_value)
     param = MAX_CONTACTS;
   else if (_key == "min_step_size")
     param = MIN_STEP_SIZE;
+  else if (_key == "threads")
+    param = SOLVER_THREADS;
   else
   {
     gzwarn << _key << " is not supported in ode" << std::endl;
@@ -1321,6 +1574,11 @@ boost::any ODEPhysics::GetParam(ODEParam _param) const
       value = odeElem->GetElement("solver")->GetValueDouble("min_step_size");
       break;
     }
+    case SOLVER_THREADS:
+    {
+      value = odeElem->GetElement("solver")->GetValueInt("threads");
+      break;
+    }
     default:
     {
       gzwarn << "Attribute not supported in bullet" << std::endl;
@@ -1355,6 +1613,8 @@ boost::any ODEPhysics::GetParam(const std::string &_key) const
     param = MAX_CONTACTS;
   else if (_key == "min_step_size")
     param = MIN_STEP_SIZE;
+  else if (_key == "threads")
+    param = SOLVER_THREADS;
   else
   {
     gzwarn << _key << " is not supported in ode" << std::endl;
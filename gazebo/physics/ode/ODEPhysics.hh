@@ -57,6 +57,23 @@ namespace gazebo
       public: dJointFeedback feedbacks[MAX_CONTACT_JOINTS];
     };
 
+    /// \brief A link whose motion is swept by continuous collision
+    /// detection.
+    class ODECCDLink
+    {
+      /// \brief The link.
+      public: ODELink *link;
+
+      /// \brief Speed above which the motion is swept.
+      public: double velocityThreshold;
+
+      /// \brief Radius of the swept sphere.
+      public: double radius;
+
+      /// \brief Position of the body before the step.
+      public: dVector3 start;
+    };
+
     /// \brief ODE physics engine.
     class ODEPhysics : public PhysicsEngine
     {
@@ -92,7 +109,10 @@ namespace gazebo
         MAX_CONTACTS,
 
         /// \brief Minimum step size
-        MIN_STEP_SIZE
+        MIN_STEP_SIZE,
+
+        /// \brief Number of threads solving graph colored constraint rows
+        SOLVER_THREADS
       };
 
       /// \brief Constructor.
@@ -199,6 +219,12 @@ namespace gazebo
       // Documentation inherited
       public: virtual void SetSeed(uint32_t _seed);
 
+      // Documentation inherited
+      public: virtual void Snapshot(common::SnapshotBuffer &_buffer);
+
+      // Documentation inherited
+      public: virtual bool Restore(common::SnapshotBuffer &_buffer);
+
       /// \brief Set a parameter of the bullet physics engine
       /// \param[in] _param A parameter listed in the ODEParam enum
       /// \param[in] _value The value to set to
@@ -252,6 +278,33 @@ namespace gazebo
       public: void Collide(ODECollision *_collision1, ODECollision *_collision2,
                            dContactGeom *_contactCollisions);
 
+      /// \brief Create contact joints between two collision objects.
+      /// \param[in] _collision1 First collision object.
+      /// \param[in] _collision2 Second collision object.
+      /// \param[in] _contactCollisions Contacts between the objects, with
+      /// normals pointing toward the first object.
+      /// \param[in] _count Number of contacts.
+      public: void AddContacts(ODECollision *_collision1,
+                               ODECollision *_collision2,
+                               dContactGeom *_contactCollisions, int _count);
+
+      /// \brief Sweep the motion of a link at each step, and stop it at the
+      /// first object in its way.
+      /// \param[in] _link Link that has an ODE body.
+      /// \param[in] _velocityThreshold Speed above which the motion is
+      /// swept.
+      /// \param[in] _radius Radius of the swept sphere.
+      public: void AddCCDLink(ODELink *_link, double _velocityThreshold,
+                              double _radius);
+
+      /// \brief Stop sweeping the motion of a link.
+      /// \param[in] _link Link given to AddCCDLink.
+      public: void RemoveCCDLink(ODELink *_link);
+
+      /// \brief Get the FCL triangle mesh collider.
+      /// \return The collider, NULL unless <collision_detector> is "fcl".
+      public: ODEFCLCollider *GetFCLCollider() const;
+
       /// \brief process joint feedbacks.
       /// \param[in] _feedback ODE Joint Contact feedback information.
       public: void ProcessJointFeedback(ODEJointFeedback *_feedback);
@@ -268,6 +321,17 @@ namespace gazebo
                                              dGeomID _o2);
 
 
+      /// \brief Move the links that went through an object during the last
+      /// step back to where they first touched it.
+      private: void SweepCCDLinks();
+
+      /// \brief Collision callback of the continuous collision ray.
+      /// \param[in] _data Pointer to the physics engine.
+      /// \param[in] _o1 First geom to check for collisions.
+      /// \param[in] _o2 Second geom to check for collisions.
+      private: static void CCDCallback(void *_data, dGeomID _o1,
+                                       dGeomID _o2);
+
       /// \brief Create a triangle mesh object collider.
       /// \param[in] _collision1 The first collision object.
       /// \param[in] _collision2 The second collision object.
@@ -322,6 +386,25 @@ namespace gazebo
 
       /// \brief Indices used during creation of contact joints.
       private: int indices[MAX_CONTACT_JOINTS];
+
+      /// \brief Collides triangle meshes when FCL is the collision
+      /// detector, NULL otherwise.
+      private: ODEFCLCollider *fclCollider;
+
+      /// \brief Links with continuous collision detection.
+      private: std::vector<ODECCDLink> ccdLinks;
+
+      /// \brief Ray cast along the motion of a link.
+      private: dGeomID ccdRay;
+
+      /// \brief Body of the link being swept.
+      private: dBodyID ccdBody;
+
+      /// \brief Distance to the closest hit of the ray.
+      private: dReal ccdDepth;
+
+      /// \brief Normal at the closest hit of the ray.
+      private: math::Vector3 ccdNormal;
     };
   }
 }
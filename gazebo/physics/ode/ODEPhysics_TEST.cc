@@ -168,6 +168,16 @@ TEST_F(ODEPhysics_TEST, PhysicsParam)
   EXPECT_DOUBLE_EQ(contactMaxCorrectingVel,
       odePhysics->GetContactMaxCorrectingVel());
   EXPECT_DOUBLE_EQ(contactSurfaceLayer, odePhysics->GetContactSurfaceLayer());
+
+  // Graph colored solver threads
+  int threads = 3;
+  odePhysics->SetParam("threads", threads);
+  value = odePhysics->GetParam("threads");
+  EXPECT_EQ(threads, boost::any_cast<int>(value));
+  value = odePhysics->GetParam(ODEPhysics::SOLVER_THREADS);
+  EXPECT_EQ(threads, boost::any_cast<int>(value));
+  odePhysics->SetParam(ODEPhysics::SOLVER_THREADS, 0);
+  EXPECT_EQ(0, boost::any_cast<int>(odePhysics->GetParam("threads")));
 }
 
 /////////////////////////////////////////////////
@@ -256,6 +266,111 @@ TEST_F(ODEPhysics_TEST, PhysicsMsgParam)
   PhysicsMsgParam();
 }
 
+/////////////////////////////////////////////////
+/// \brief World and contact group used by coloredNearCallback
+static dWorldID coloredWorld;
+static dJointGroupID coloredContacts;
+
+/////////////////////////////////////////////////
+/// \brief Create the contact joints of two colliding geoms
+static void coloredNearCallback(void * /*_data*/, dGeomID _g1, dGeomID _g2)
+{
+  dContact contacts[4];
+  int count = dCollide(_g1, _g2, 4, &contacts[0].geom, sizeof(dContact));
+  for (int i = 0; i < count; ++i)
+  {
+    contacts[i].surface.mode = dContactApprox1;
+    contacts[i].surface.mu = 0.8;
+    dJointID joint = dJointCreateContact(coloredWorld, coloredContacts,
+                                         &contacts[i]);
+    dJointAttach(joint, dGeomGetBody(contacts[i].geom.g1),
+                 dGeomGetBody(contacts[i].geom.g2));
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Step 100 boxes resting on one dynamic plate with the graph
+/// colored solver. The rows of the plate need more colors than the solver
+/// has, so some of them, and their friction rows, are in the overflow
+/// color.
+/// \param[in] _threads Number of solver threads.
+/// \return Final position of every body.
+static std::vector<double> stepColoredPlate(int _threads)
+{
+  coloredWorld = dWorldCreate();
+  dSpaceID space = dHashSpaceCreate(0);
+  coloredContacts = dJointGroupCreate(0);
+  dWorldSetGravity(coloredWorld, 0, 0, -9.8);
+  dWorldSetQuickStepNumIterations(coloredWorld, 50);
+  dWorldSetQuickStepColoredThreads(coloredWorld, _threads);
+  dCreatePlane(space, 0, 0, 1, 0);
+
+  std::vector<dBodyID> bodies;
+  dMass mass;
+  dBodyID plate = dBodyCreate(coloredWorld);
+  dMassSetBox(&mass, 1, 6, 6, 0.2);
+  dBodySetMass(plate, &mass);
+  dBodySetPosition(plate, 2.25, 2.25, 0.1);
+  dGeomSetBody(dCreateBox(space, 6, 6, 0.2), plate);
+  bodies.push_back(plate);
+
+  for (int x = 0; x < 10; ++x)
+  {
+    for (int y = 0; y < 10; ++y)
+    {
+      dBodyID box = dBodyCreate(coloredWorld);
+      dMassSetBox(&mass, 1, 0.4, 0.4, 0.4);
+      dBodySetMass(box, &mass);
+      dBodySetPosition(box, x * 0.5, y * 0.5, 0.4);
+      dGeomSetBody(dCreateBox(space, 0.4, 0.4, 0.4), box);
+      bodies.push_back(box);
+    }
+  }
+
+  for (int i = 0; i < 100; ++i)
+  {
+    dSpaceCollide(space, 0, coloredNearCallback);
+    dWorldQuickStep(coloredWorld, 0.005);
+    dJointGroupEmpty(coloredContacts);
+  }
+
+  std::vector<double> positions;
+  for (unsigned int i = 0; i < bodies.size(); ++i)
+  {
+    const dReal *pos = dBodyGetPosition(bodies[i]);
+    positions.insert(positions.end(), pos, pos + 3);
+  }
+
+  dJointGroupDestroy(coloredContacts);
+  dSpaceDestroy(space);
+  dWorldDestroy(coloredWorld);
+  return positions;
+}
+
+/////////////////////////////////////////////////
+/// Test that the graph colored solver gives the same result with any
+/// number of threads, overflow color included
+TEST(ODEColoredSolver_TEST, SameResultForAnyThreadCount)
+{
+  dInitODE2(0);
+
+  std::vector<double> single = stepColoredPlate(1);
+  std::vector<double> three = stepColoredPlate(3);
+  std::vector<double> four = stepColoredPlate(4);
+
+  ASSERT_EQ(single.size(), three.size());
+  ASSERT_EQ(single.size(), four.size());
+  for (unsigned int i = 0; i < single.size(); ++i)
+  {
+    EXPECT_DOUBLE_EQ(single[i], three[i]);
+    EXPECT_DOUBLE_EQ(single[i], four[i]);
+  }
+
+  // The boxes rest on the plate
+  EXPECT_NEAR(single[2], 0.1, 0.01);
+  EXPECT_NEAR(single[5], 0.4, 0.01);
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
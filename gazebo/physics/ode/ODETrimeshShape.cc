@@ -19,32 +19,69 @@
  * Date: 16 Oct 2009
  */
 
+#include <map>
+#include <string>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/weak_ptr.hpp>
+
 #include "common/Mesh.hh"
 #include "common/Exception.hh"
 #include "common/Console.hh"
 
+#include "physics/World.hh"
 #include "physics/ode/ODECollision.hh"
+#include "physics/ode/ODEFCLCollider.hh"
 #include "physics/ode/ODEPhysics.hh"
 #include "physics/ode/ODETrimeshShape.hh"
 
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Triangle data that is in use, indexed by mesh key. Only weak
+/// pointers are held, so the data is freed when the last shape using it is
+/// destroyed.
+static std::map<std::string, boost::weak_ptr<ODETrimeshData> > trimeshData;
+
+/// \brief Mutex that protects trimeshData.
+static boost::mutex trimeshDataMutex;
 
 //////////////////////////////////////////////////
-ODETrimeshShape::ODETrimeshShape(CollisionPtr _parent) : TrimeshShape(_parent)
+ODETrimeshData::ODETrimeshData()
 {
-  this->odeData = NULL;
   this->vertices = NULL;
   this->indices = NULL;
+  this->odeData = NULL;
+  this->vertexCount = 0;
+  this->indexCount = 0;
+  this->fclModel = NULL;
 }
 
 //////////////////////////////////////////////////
-ODETrimeshShape::~ODETrimeshShape()
+ODETrimeshData::~ODETrimeshData()
 {
+  if (this->odeData)
+    dGeomTriMeshDataDestroy(this->odeData);
+  ODEFCLCollider::DeleteModel(this->fclModel);
   delete [] this->vertices;
   delete [] this->indices;
-  dGeomTriMeshDataDestroy(this->odeData);
+}
+
+//////////////////////////////////////////////////
+ODETrimeshShape::ODETrimeshShape(CollisionPtr _parent) : TrimeshShape(_parent)
+{
+}
+
+//////////////////////////////////////////////////
+ODETrimeshShape::~ODETrimeshShape()
+{
+  if (this->fclPhysics && this->fclPhysics->GetFCLCollider())
+  {
+    this->fclPhysics->GetFCLCollider()->RemoveMesh(
+        static_cast<ODECollision*>(this->collisionParent.get()));
+  }
+
+  this->data.reset();
 }
 
 //////////////////////////////////////////////////
@@ -104,52 +141,98 @@ void ODETrimeshShape::Init()
   ODECollisionPtr pcollision =
     boost::static_pointer_cast<ODECollision>(this->collisionParent);
 
-  /// This will hold the vertex data of the triangle mesh
-  if (this->odeData == NULL)
-    this->odeData = dGeomTriMeshDataCreate();
-
-  unsigned int numVertices = this->submesh ? this->submesh->GetVertexCount() :
-    this->mesh->GetVertexCount();
-
-  unsigned int numIndices = this->submesh ? this->submesh->GetIndexCount() :
-    this->mesh->GetIndexCount();
+  ODEPhysicsPtr physics = boost::dynamic_pointer_cast<ODEPhysics>(
+      this->collisionParent->GetWorld()->GetPhysicsEngine());
+  ODEFCLCollider *fclCollider = physics ? physics->GetFCLCollider() : NULL;
 
-  this->vertices = NULL;
-  this->indices = NULL;
+  std::string key = this->GetMeshKey();
 
-  // Get all the vertex and index data
-  if (!this->submesh)
-    this->mesh->FillArrays(&this->vertices, &this->indices);
-  else
-    this->submesh->FillArrays(&this->vertices, &this->indices);
+  // Keeps the previous data alive until the geom points to the new data
+  ODETrimeshDataPtr previousData = this->data;
 
-  // Scale the vertex data
-  for (unsigned int j = 0;  j < numVertices; j++)
   {
-    this->vertices[j*3+0] = this->vertices[j*3+0] *
-      this->sdf->GetValueVector3("scale").x;
-    this->vertices[j*3+1] = this->vertices[j*3+1] *
-      this->sdf->GetValueVector3("scale").y;
-    this->vertices[j*3+2] = this->vertices[j*3+2] *
-      this->sdf->GetValueVector3("scale").z;
+    boost::mutex::scoped_lock lock(trimeshDataMutex);
+
+    // Reuse the triangle data of another shape with the same mesh and
+    // scale. The ODE trimesh data can be shared by any number of geoms.
+    ODETrimeshDataPtr sharedData = trimeshData[key].lock();
+    if (!sharedData)
+    {
+      sharedData.reset(new ODETrimeshData());
+
+      unsigned int numVertices = this->submesh ?
+        this->submesh->GetVertexCount() : this->mesh->GetVertexCount();
+
+      unsigned int numIndices = this->submesh ?
+        this->submesh->GetIndexCount() : this->mesh->GetIndexCount();
+
+      // Get all the vertex and index data
+      if (!this->submesh)
+        this->mesh->FillArrays(&sharedData->vertices, &sharedData->indices);
+      else
+        this->submesh->FillArrays(&sharedData->vertices,
+                                  &sharedData->indices);
+
+      // Scale the vertex data
+      math::Vector3 scale = this->sdf->GetValueVector3("scale");
+      for (unsigned int j = 0;  j < numVertices; j++)
+      {
+        sharedData->vertices[j*3+0] *= scale.x;
+        sharedData->vertices[j*3+1] *= scale.y;
+        sharedData->vertices[j*3+2] *= scale.z;
+      }
+
+      // Build the ODE triangle mesh
+      sharedData->odeData = dGeomTriMeshDataCreate();
+      dGeomTriMeshDataBuildSingle(sharedData->odeData,
+          sharedData->vertices, 3*sizeof(sharedData->vertices[0]),
+          numVertices, sharedData->indices, numIndices,
+          3*sizeof(sharedData->indices[0]));
+
+      sharedData->vertexCount = numVertices;
+      sharedData->indexCount = numIndices;
+
+      trimeshData[key] = sharedData;
+    }
+
+    // The FCL model is built once, and copied by each shape
+    if (fclCollider && !sharedData->fclModel)
+    {
+      sharedData->fclModel = ODEFCLCollider::BuildModel(
+          sharedData->vertices, sharedData->vertexCount,
+          sharedData->indices, sharedData->indexCount);
+    }
+
+    // Remove entries whose data has been freed
+    std::map<std::string, boost::weak_ptr<ODETrimeshData> >::iterator iter;
+    for (iter = trimeshData.begin(); iter != trimeshData.end();)
+    {
+      if (iter->second.expired())
+        trimeshData.erase(iter++);
+      else
+        ++iter;
+    }
+
+    this->data = sharedData;
   }
 
-  // Build the ODE triangle mesh
-  dGeomTriMeshDataBuildSingle(this->odeData,
-      this->vertices, 3*sizeof(this->vertices[0]), numVertices,
-      this->indices, numIndices, 3*sizeof(this->indices[0]));
-
   if (pcollision->GetCollisionId() == NULL)
   {
     pcollision->SetSpaceId(dSimpleSpaceCreate(pcollision->GetSpaceId()));
     pcollision->SetCollision(dCreateTriMesh(pcollision->GetSpaceId(),
-          this->odeData, 0, 0, 0), true);
+          this->data->odeData, 0, 0, 0), true);
   }
   else
   {
-    dGeomTriMeshSetData(pcollision->GetCollisionId(), this->odeData);
+    dGeomTriMeshSetData(pcollision->GetCollisionId(), this->data->odeData);
   }
 
   memset(this->transform, 0, 32*sizeof(dReal));
   this->transformIndex = 0;
+
+  if (fclCollider)
+  {
+    fclCollider->AddMesh(pcollision.get(), this->data->fclModel);
+    this->fclPhysics = physics;
+  }
 }
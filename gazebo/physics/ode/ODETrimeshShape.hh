@@ -22,12 +22,57 @@
 #ifndef _ODETRIMESHSHAPE_HH_
 #define _ODETRIMESHSHAPE_HH_
 
+#include <boost/shared_ptr.hpp>
+
+#include "gazebo/physics/ode/ode_inc.h"
+#include "gazebo/physics/ode/ODETypes.hh"
 #include "gazebo/physics/TrimeshShape.hh"
 
+namespace fcl
+{
+  class OBB;
+  template<typename BV> class BVHModel;
+}
+
 namespace gazebo
 {
   namespace physics
   {
+    /// \brief Triangle data and collision structure of a mesh. It is
+    /// shared by all the ODETrimeshShapes that use the same mesh and
+    /// scale, and is destroyed along with the last of them.
+    class ODETrimeshData
+    {
+      /// \brief Constructor.
+      public: ODETrimeshData();
+
+      /// \brief Destructor.
+      public: virtual ~ODETrimeshData();
+
+      /// \brief Array of scaled vertex values.
+      public: float *vertices;
+
+      /// \brief Array of index values.
+      public: int *indices;
+
+      /// \brief ODE trimesh data.
+      public: dTriMeshDataID odeData;
+
+      /// \brief Number of vertices.
+      public: unsigned int vertexCount;
+
+      /// \brief Number of indices.
+      public: unsigned int indexCount;
+
+      /// \brief FCL model of the mesh, built when the first shape is added
+      /// to an FCL collider. Each shape collides a copy of it.
+      public: fcl::BVHModel<fcl::OBB> *fclModel;
+    };
+
+    /// \def ODETrimeshDataPtr
+    /// \brief Boost shared pointer to an ODETrimeshData object.
+    typedef boost::shared_ptr<ODETrimeshData> ODETrimeshDataPtr;
+
     /// \brief Triangle mesh collision.
     class ODETrimeshShape : public TrimeshShape
     {
@@ -53,14 +98,13 @@ namespace gazebo
       /// \brief Transform matrix index.
       private: int transformIndex;
 
-      /// \brief Array of vertex values.
-      private: float *vertices;
+      /// \brief Triangle data, shared with other shapes that use the same
+      /// mesh and scale.
+      private: ODETrimeshDataPtr data;
 
-      /// \brief Array of index values.
-      private: int *indices;
-
-      /// \brief ODE trimesh data.
-      private: dTriMeshDataID odeData;
+      /// \brief Physics engine whose FCL collider has this shape, NULL if
+      /// the mesh is collided by OPCODE.
+      private: ODEPhysicsPtr fclPhysics;
     };
   }
 }
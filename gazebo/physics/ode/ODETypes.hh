@@ -24,6 +24,7 @@ namespace gazebo
   namespace physics
   {
     class ODECollision;
+    class ODEFCLCollider;
     class ODELink;
     class ODERayShape;
     class ODESurfaceParams;
@@ -34,6 +34,7 @@
 #include "gazebo/common/Exception.hh"
 #include "gazebo/math/Pose.hh"
 #include "gazebo/math/Rand.hh"
+#include "gazebo/math/RandStream.hh"
 
 #include "gazebo/rendering/ogre_gazebo.h"
 #include "gazebo/rendering/RTShaderSystem.hh"
@@ -59,8 +60,12 @@ class GaussianNoiseCompositorListener
   : public Ogre::CompositorInstance::Listener
 {
   /// \brief Constructor, setting mean and standard deviation.
-  public: GaussianNoiseCompositorListener(double _mean, double _stddev):
-      mean(_mean), stddev(_stddev) {}
+  /// \param[in] _mean Mean of the noise.
+  /// \param[in] _stddev Standard deviation of the noise.
+  /// \param[in] _stream Stream of the offsets, one draw per render call.
+  public: GaussianNoiseCompositorListener(double _mean, double _stddev,
+                                          const math::RandStream &_stream):
+      mean(_mean), stddev(_stddev), stream(_stream), draw(0) {}
 
   /// \brief Callback that OGRE will invoke for us on each render call
   public: virtual void notifyMaterialRender(unsigned int _pass_id,
@@ -71,10 +76,12 @@ class GaussianNoiseCompositorListener
 
     // Sample three values within the range [0,1.0] and set them for use in
     // the fragment shader, which will interpret them as offsets from (0,0)
-    // to use when computing pseudo-random values.
-    Ogre::Vector3 offsets(math::Rand::GetDblUniform(0.0, 1.0),
-                          math::Rand::GetDblUniform(0.0, 1.0),
-                          math::Rand::GetDblUniform(0.0, 1.0));
+    // to use when computing pseudo-random values. They come from the
+    // stream of the camera, so the noise of each frame only depends on
+    // the seed and on the number of frames rendered by the camera.
+    double values[3];
+    this->stream.GetUniform(this->draw++, values, 3);
+    Ogre::Vector3 offsets(values[0], values[1], values[2]);
     // These calls are setting parameters that are declared in two places:
     // 1. media/materials/scripts/gazebo.material, in
     //    fragment_program Gazebo/GaussianCameraNoiseFS
@@ -95,6 +102,12 @@ class GaussianNoiseCompositorListener
   /// \brief Standard deviation that we'll pass down to the GLSL fragment
   /// shader.
   private: double stddev;
+
+  /// \brief Stream of the offsets.
+  private: math::RandStream stream;
+
+  /// \brief Next draw of the stream.
+  private: uint64_t draw;
 };
 }  // namespace rendering
 }  // namespace gazebo
@@ -239,7 +252,8 @@ void Camera::Load()
       this->noiseStdDev = noiseElem->GetValueDouble("stddev");
       this->noiseActive = true;
       this->gaussianNoiseCompositorListener.reset(new
-        GaussianNoiseCompositorListener(this->noiseMean, this->noiseStdDev));
+        GaussianNoiseCompositorListener(this->noiseMean, this->noiseStdDev,
+          math::RandStream(math::Rand::GetSeed(), this->GetName())));
       gzlog << "applying Gaussian noise model with mean " << this->noiseMean <<
         " and stddev " << this->noiseStdDev << std::endl;
     }
@@ -14,6 +14,7 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
 #include <boost/lexical_cast.hpp>
 
 #include "gazebo/rendering/skyx/include/SkyX.h"
@@ -113,7 +114,8 @@ Scene::Scene(const std::string &_name, bool _enableVisualizations)
 
   this->lightSub = this->node->Subscribe("~/light", &Scene::OnLightMsg, this);
 
-  this->poseSub = this->node->Subscribe("~/pose/info", &Scene::OnPoseMsg, this);
+  this->poseSub = this->node->Subscribe("~/pose/compact",
+      &Scene::OnCompactPoseMsg, this);
   this->jointSub = this->node->Subscribe("~/joint", &Scene::OnJointMsg, this);
   this->skeletonPoseSub = this->node->Subscribe("~/skeleton_pose/info",
           &Scene::OnSkeletonPoseMsg, this);
@@ -150,6 +152,8 @@ void Scene::Clear()
   this->visualMsgs.clear();
   this->lightMsgs.clear();
   this->poseMsgs.clear();
+  this->poseNames.clear();
+  this->unnamedPoses.clear();
   this->sceneMsgs.clear();
   this->jointMsgs.clear();
   this->linkMsgs.clear();
@@ -2055,27 +2059,70 @@ bool Scene::ProcessVisualMsg(ConstVisualPtr &_msg)
 }
 
 /////////////////////////////////////////////////
-void Scene::OnPoseMsg(ConstPose_VPtr &_msg)
+void Scene::OnCompactPoseMsg(ConstCompactPosesPtr &_msg)
 {
   boost::mutex::scoped_lock lock(*this->receiveMutex);
-  PoseMsgs_L::iterator iter;
 
-  for (int i = 0; i < _msg->pose_size(); ++i)
+  if (_msg->key_frame())
+    this->poseNames.clear();
+
+  for (int i = 0; i < _msg->name_id_size() && i < _msg->name_size(); ++i)
   {
-    // Find an old model message, and remove them
-    for (iter = this->poseMsgs.begin(); iter != this->poseMsgs.end(); ++iter)
+    this->poseNames[_msg->name_id(i)] = _msg->name(i);
+
+    // Apply a pose that arrived before the name
+    std::map<unsigned int, msgs::Pose>::iterator iter =
+      this->unnamedPoses.find(_msg->name_id(i));
+    if (iter != this->unnamedPoses.end())
     {
-      if ((*iter).name() == _msg->pose(i).name())
-      {
-        this->poseMsgs.erase(iter);
-        break;
-      }
+      iter->second.set_name(_msg->name(i));
+      this->AddPoseMsg(iter->second);
+      this->unnamedPoses.erase(iter);
+    }
+  }
+
+  // A key frame names every entity, so the remaining poses are of
+  // entities that no longer exist
+  if (_msg->key_frame())
+    this->unnamedPoses.clear();
+
+  int count = std::min(_msg->id_size(),
+      std::min(_msg->position_size(), _msg->orientation_size()) / 3);
+  for (int i = 0; i < count; ++i)
+  {
+    msgs::Pose pose;
+    msgs::Set(&pose, msgs::Convert(*_msg, i));
+
+    std::map<unsigned int, std::string>::iterator iter =
+      this->poseNames.find(_msg->id(i));
+    if (iter == this->poseNames.end())
+    {
+      this->unnamedPoses[_msg->id(i)] = pose;
+      continue;
     }
 
-    this->poseMsgs.push_back(_msg->pose(i));
+    pose.set_name(iter->second);
+    this->AddPoseMsg(pose);
   }
 }
 
+/////////////////////////////////////////////////
+void Scene::AddPoseMsg(const msgs::Pose &_pose)
+{
+  // Find an old model message, and remove them
+  PoseMsgs_L::iterator iter;
+  for (iter = this->poseMsgs.begin(); iter != this->poseMsgs.end(); ++iter)
+  {
+    if ((*iter).name() == _pose.name())
+    {
+      this->poseMsgs.erase(iter);
+      break;
+    }
+  }
+
+  this->poseMsgs.push_back(_pose);
+}
+
 /////////////////////////////////////////////////
 void Scene::OnSkeletonPoseMsg(ConstPoseAnimationPtr &_msg)
 {
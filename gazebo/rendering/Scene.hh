@@ -508,9 +508,14 @@ namespace gazebo
       /// \param[in] _msg The message data.
       private: void OnModelMsg(ConstModelPtr &_msg);
 
-      /// \brief Pose message callback.
+      /// \brief Compact pose message callback. Rebuilds the full poses
+      /// from the entity ids and the quantized values.
       /// \param[in] _msg The message data.
-      private: void OnPoseMsg(ConstPose_VPtr &_msg);
+      private: void OnCompactPoseMsg(ConstCompactPosesPtr &_msg);
+
+      /// \brief Queue a pose, replacing an older pose of the same entity.
+      /// \param[in] _pose Pose with the scoped name of the entity.
+      private: void AddPoseMsg(const msgs::Pose &_pose);
 
       /// \brief Skeleton animation callback.
       /// \param[in] _msg The message data.
@@ -578,6 +583,13 @@ namespace gazebo
       /// \brief List of pose message to process.
       private: PoseMsgs_L poseMsgs;
 
+      /// \brief Scoped names of the entities in compact pose messages,
+      /// by id.
+      private: std::map<unsigned int, std::string> poseNames;
+
+      /// \brief Compact poses received before the name of their entity.
+      private: std::map<unsigned int, msgs::Pose> unnamedPoses;
+
       /// \def SceneMsgs_L
       /// \brief List of scene messages.
       typedef std::list<boost::shared_ptr<msgs::Scene const> > SceneMsgs_L;
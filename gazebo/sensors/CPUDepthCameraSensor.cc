@@ -0,0 +1,364 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <math.h>
+#include <algorithm>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <boost/algorithm/string/replace.hpp>
+
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/Entity.hh"
+#include "gazebo/physics/RayTracer.hh"
+
+#include "gazebo/common/Assert.hh"
+#include "gazebo/common/Exception.hh"
+#include "gazebo/common/Image.hh"
+
+#include "gazebo/math/Helpers.hh"
+
+#include "gazebo/transport/Node.hh"
+#include "gazebo/transport/Publisher.hh"
+#include "gazebo/msgs/msgs.hh"
+
+#include "gazebo/sensors/Noise.hh"
+#include "gazebo/sensors/SensorFactory.hh"
+#include "gazebo/sensors/CPUDepthCameraSensor.hh"
+
+using namespace gazebo;
+using namespace sensors;
+
+GZ_REGISTER_STATIC_SENSOR("cpu_depth", CPUDepthCameraSensor)
+
+/// \brief Traces a range of image rows.
+class DepthRows_TBB
+{
+  /// \brief Constructor.
+  /// \param[in] _tracer Traces the shapes.
+  /// \param[in] _pose World pose of the sensor.
+  /// \param[in] _width Image width.
+  /// \param[in] _rays Unit ray direction of each pixel, sensor frame.
+  /// \param[in] _near Near clip distance.
+  /// \param[in] _far Far clip distance.
+  /// \param[in] _noise Noise model of the depths, NULL for none.
+  /// \param[in] _draw Draw of the noise of the first row, the next rows
+  /// use the next draws.
+  /// \param[out] _depths Depth of each pixel.
+  /// \param[out] _points Point of each pixel, NULL for none.
+  public: DepthRows_TBB(const physics::RayTracer *_tracer,
+              const math::Pose &_pose, unsigned int _width,
+              const double *_rays, double _near, double _far,
+              const Noise *_noise, uint64_t _draw, float *_depths,
+              float *_points)
+          : tracer(_tracer), pose(_pose), width(_width), rays(_rays),
+            nearClip(_near), farClip(_far), noise(_noise), draw(_draw),
+            depths(_depths), points(_points)
+          {}
+
+  /// \brief Trace the rows.
+  /// \param[in] _r Range of rows.
+  public: void operator() (const tbb::blocked_range<size_t> &_r) const
+          {
+            double origin[3] = {this->pose.pos.x, this->pose.pos.y,
+                                this->pose.pos.z};
+            double dirs[12], minDist[4], dist[4];
+            for (size_t row = _r.begin(); row != _r.end(); ++row)
+            {
+              size_t first = row * this->width;
+              size_t last = first + this->width;
+
+              // Neighbor pixels are traced together, four at a time
+              for (size_t i = first; i < last; i += 4)
+              {
+                size_t count = std::min(last - i, static_cast<size_t>(4));
+                for (size_t j = 0; j < count; ++j)
+                {
+                  const double *ray = this->rays + (i + j) * 3;
+                  math::Vector3 world = this->pose.rot.RotateVector(
+                      math::Vector3(ray[0], ray[1], ray[2]));
+                  dirs[j * 3] = world.x;
+                  dirs[j * 3 + 1] = world.y;
+                  dirs[j * 3 + 2] = world.z;
+
+                  // Clip planes are perpendicular to the optical axis, so
+                  // the distances along the ray grow with the angle to it
+                  minDist[j] = this->nearClip / ray[0];
+                  dist[j] = this->farClip / ray[0];
+                }
+
+                if (count == 4)
+                  this->tracer->IntersectPacket(origin, dirs, minDist, dist);
+                else
+                {
+                  for (size_t j = 0; j < count; ++j)
+                  {
+                    this->tracer->Intersect(origin, dirs + j * 3, minDist[j],
+                                            dist[j]);
+                  }
+                }
+
+                for (size_t j = 0; j < count; ++j)
+                  this->depths[i + j] = dist[j] * this->rays[(i + j) * 3];
+              }
+
+              // One draw per row, so the noise doesn't depend on how the
+              // rows are split between the threads
+              if (this->noise)
+              {
+                this->noise->ApplyAt(this->draw + row, this->depths + first,
+                                     this->width);
+                for (size_t i = first; i < last; ++i)
+                {
+                  this->depths[i] = math::clamp(this->depths[i],
+                      static_cast<float>(this->nearClip),
+                      static_cast<float>(this->farClip));
+                }
+              }
+
+              if (this->points)
+              {
+                for (size_t i = first; i < last; ++i)
+                {
+                  const double *ray = this->rays + i * 3;
+                  double dist = this->depths[i] / ray[0];
+                  float *point = this->points + i * 4;
+                  point[0] = this->depths[i];
+                  point[1] = dist * ray[1];
+                  point[2] = dist * ray[2];
+                  point[3] = 0;
+                }
+              }
+            }
+          }
+
+  /// \brief Traces the shapes.
+  private: const physics::RayTracer *tracer;
+
+  /// \brief World pose of the sensor.
+  private: math::Pose pose;
+
+  /// \brief Image width.
+  private: unsigned int width;
+
+  /// \brief Unit ray direction of each pixel in the sensor frame.
+  private: const double *rays;
+
+  /// \brief Near clip distance.
+  private: double nearClip;
+
+  /// \brief Far clip distance.
+  private: double farClip;
+
+  /// \brief Noise model of the depths.
+  private: const Noise *noise;
+
+  /// \brief Draw of the noise of the first row.
+  private: uint64_t draw;
+
+  /// \brief Depth of each pixel.
+  private: float *depths;
+
+  /// \brief Point of each pixel.
+  private: float *points;
+};
+
+//////////////////////////////////////////////////
+CPUDepthCameraSensor::CPUDepthCameraSensor()
+    : Sensor(sensors::RAY), tracer(NULL), width(0), height(0),
+      nearClip(0), farClip(0), outputPoints(false), frameCount(0)
+{
+}
+
+//////////////////////////////////////////////////
+CPUDepthCameraSensor::~CPUDepthCameraSensor()
+{
+  delete this->tracer;
+  this->tracer = NULL;
+}
+
+//////////////////////////////////////////////////
+std::string CPUDepthCameraSensor::GetTopic() const
+{
+  std::string topicName = "~/";
+  topicName += this->parentName + "/" + this->GetName() + "/image";
+  boost::replace_all(topicName, "::", "/");
+
+  return topicName;
+}
+
+//////////////////////////////////////////////////
+void CPUDepthCameraSensor::Load(const std::string &_worldName)
+{
+  Sensor::Load(_worldName);
+
+  GZ_ASSERT(this->world != NULL,
+      "CPUDepthCameraSensor did not get a valid World pointer");
+
+  this->imagePub = this->node->Advertise<msgs::ImageStamped>(
+      this->GetTopic());
+
+  sdf::ElementPtr cameraElem = this->sdf->GetElement("camera");
+  sdf::ElementPtr imageElem = cameraElem->GetElement("image");
+  this->width = imageElem->GetValueInt("width");
+  this->height = imageElem->GetValueInt("height");
+
+  if (this->width == 0 || this->height == 0)
+    gzthrow("image has zero size");
+
+  sdf::ElementPtr clipElem = cameraElem->GetElement("clip");
+  this->nearClip = clipElem->GetValueDouble("near");
+  this->farClip = clipElem->GetValueDouble("far");
+
+  this->outputPoints = cameraElem->HasElement("depth_camera") &&
+    cameraElem->GetElement("depth_camera")->GetValueString("output") ==
+    "points";
+
+  this->noise.reset();
+  if (cameraElem->HasElement("noise"))
+  {
+    sdf::ElementPtr noiseElem = cameraElem->GetElement("noise");
+    this->noise.reset(new Noise());
+    this->noise->Load(noiseElem, noiseElem->GetValueString("type"),
+                      this->GetScopedName());
+  }
+
+  // Pinhole camera looking along x, with y to the left and z up, like
+  // the other sensors. Rays go through the center of the pixels.
+  double hfov = cameraElem->GetValueDouble("horizontal_fov");
+  double focal = 0.5 * this->width / tan(0.5 * hfov);
+
+  this->rays.resize(this->width * this->height * 3);
+  for (unsigned int v = 0; v < this->height; ++v)
+  {
+    for (unsigned int u = 0; u < this->width; ++u)
+    {
+      math::Vector3 ray(focal, 0.5 * this->width - (u + 0.5),
+                        0.5 * this->height - (v + 0.5));
+      ray.Normalize();
+
+      double *dst = &this->rays[(v * this->width + u) * 3];
+      dst[0] = ray.x;
+      dst[1] = ray.y;
+      dst[2] = ray.z;
+    }
+  }
+
+  this->depths.assign(this->width * this->height, this->farClip);
+  if (this->outputPoints)
+    this->points.assign(this->width * this->height * 4, 0.0f);
+
+  this->parentEntity = this->world->GetEntity(this->parentName);
+
+  GZ_ASSERT(this->parentEntity != NULL,
+      "Unable to get the parent entity.");
+}
+
+//////////////////////////////////////////////////
+void CPUDepthCameraSensor::Init()
+{
+  Sensor::Init();
+
+  this->tracer = new physics::RayTracer(this->world);
+
+  msgs::Image *image = this->imageMsg.mutable_image();
+  image->set_width(this->width);
+  image->set_height(this->height);
+  image->set_pixel_format(common::Image::R_FLOAT32);
+  image->set_step(this->width * sizeof(float));
+}
+
+//////////////////////////////////////////////////
+void CPUDepthCameraSensor::Fini()
+{
+  Sensor::Fini();
+
+  delete this->tracer;
+  this->tracer = NULL;
+  this->parentEntity.reset();
+}
+
+//////////////////////////////////////////////////
+unsigned int CPUDepthCameraSensor::GetImageWidth() const
+{
+  return this->width;
+}
+
+//////////////////////////////////////////////////
+unsigned int CPUDepthCameraSensor::GetImageHeight() const
+{
+  return this->height;
+}
+
+//////////////////////////////////////////////////
+const float *CPUDepthCameraSensor::GetDepthData() const
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+  return this->depths.empty() ? NULL : &this->depths[0];
+}
+
+//////////////////////////////////////////////////
+void CPUDepthCameraSensor::UpdateImpl(bool /*_force*/)
+{
+  if (!this->tracer || this->depths.empty())
+    return;
+
+  // Copying the shapes is the only part that reads the world, the rays
+  // are then cast against the copy
+  this->tracer->Update();
+  common::Time prevMeasurementTime = this->lastMeasurementTime;
+  this->lastMeasurementTime = this->world->GetSimTime();
+  math::Pose worldPose = this->pose + this->parentEntity->GetWorldPose();
+
+  boost::mutex::scoped_lock lock(this->mutex);
+
+  if (this->noise)
+  {
+    this->noise->UpdateBias(
+        (this->lastMeasurementTime - prevMeasurementTime).Double());
+  }
+
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, this->height, 1),
+      DepthRows_TBB(this->tracer, worldPose, this->width, &this->rays[0],
+        this->nearClip, this->farClip, this->noise.get(),
+        this->frameCount * this->height, &this->depths[0],
+        this->outputPoints ? &this->points[0] : NULL));
+  ++this->frameCount;
+
+  this->newDepthFrame(&this->depths[0], this->width, this->height, 1,
+                      "FLOAT32");
+  if (this->outputPoints)
+  {
+    this->newRGBPointCloud(&this->points[0], this->width, this->height, 1,
+                           "RGBPOINTS");
+  }
+
+  if (this->imagePub && this->imagePub->HasConnections())
+  {
+    msgs::Set(this->imageMsg.mutable_time(), this->lastMeasurementTime);
+    this->imageMsg.mutable_image()->set_data(&this->depths[0],
+        this->depths.size() * sizeof(float));
+    this->imagePub->Publish(this->imageMsg);
+  }
+}
+
+//////////////////////////////////////////////////
+bool CPUDepthCameraSensor::IsActive()
+{
+  return Sensor::IsActive() ||
+    (this->imagePub && this->imagePub->HasConnections());
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _CPUDEPTHCAMERASENSOR_HH_
+#define _CPUDEPTHCAMERASENSOR_HH_
+
+#include <string>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+#include "gazebo/common/Event.hh"
+#include "gazebo/msgs/MessageTypes.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/transport/TransportTypes.hh"
+#include "gazebo/sensors/Sensor.hh"
+#include "gazebo/sensors/SensorTypes.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    class RayTracer;
+  }
+
+  namespace sensors
+  {
+    /// \addtogroup gazebo_sensors
+    /// \{
+
+    /// \class CPUDepthCameraSensor CPUDepthCameraSensor.hh sensors/sensors.hh
+    /// \brief Depth camera that casts rays against the collision shapes
+    /// of the world on the CPU, so it needs no rendering.
+    ///
+    /// The sensor is loaded with the same <camera> element as the depth
+    /// sensor, and gives the same depth frames and point clouds, with the
+    /// depth measured along the optical axis. Pixels that hit nothing are
+    /// set to the far clip distance. Rows of the image are traced in
+    /// parallel. The noise element of the camera, if any, is applied to
+    /// the depths, with one draw per row.
+    class CPUDepthCameraSensor : public Sensor
+    {
+      /// \brief Constructor
+      public: CPUDepthCameraSensor();
+
+      /// \brief Destructor
+      public: virtual ~CPUDepthCameraSensor();
+
+      /// \brief Load the sensor with default parameters
+      /// \param[in] _worldName Name of world to load from
+      public: virtual void Load(const std::string &_worldName);
+
+      /// \brief Initialize the sensor
+      public: virtual void Init();
+
+      /// \brief Finalize the sensor
+      public: virtual void Fini();
+
+      // Documentation inherited
+      public: virtual std::string GetTopic() const;
+
+      /// \brief Get the image width.
+      /// \return Width in pixels.
+      public: unsigned int GetImageWidth() const;
+
+      /// \brief Get the image height.
+      /// \return Height in pixels.
+      public: unsigned int GetImageHeight() const;
+
+      /// \brief Get the depths of the last image, row by row.
+      /// \return Pointer to width * height depths.
+      public: const float *GetDepthData() const;
+
+      /// \brief Connect to the new depth image signal
+      /// \param[in] _subscriber Subscriber callback function
+      /// \return Pointer to the new Connection. This must be kept in scope
+      public: template<typename T>
+              event::ConnectionPtr ConnectNewDepthFrame(T _subscriber)
+              { return newDepthFrame.Connect(_subscriber); }
+
+      /// \brief Disconnect from the new depth image signal
+      /// \param[in] _c The connection to disconnect
+      public: void DisconnectNewDepthFrame(event::ConnectionPtr &_c)
+              { newDepthFrame.Disconnect(_c); }
+
+      /// \brief Connect to the new point cloud signal
+      /// \param[in] _subscriber Subscriber callback function
+      /// \return Pointer to the new Connection. This must be kept in scope
+      public: template<typename T>
+              event::ConnectionPtr ConnectNewRGBPointCloud(T _subscriber)
+              { return newRGBPointCloud.Connect(_subscriber); }
+
+      /// \brief Disconnect from the new point cloud signal
+      /// \param[in] _c The connection to disconnect
+      public: void DisconnectNewRGBPointCloud(event::ConnectionPtr &_c)
+              { newRGBPointCloud.Disconnect(_c); }
+
+      // Documentation inherited
+      public: virtual bool IsActive();
+
+      /// \brief Trace the image and publish it
+      /// \param[in] _force True if update is forced, false if not
+      protected: virtual void UpdateImpl(bool _force);
+
+      /// \brief Traces the shapes.
+      private: physics::RayTracer *tracer;
+
+      /// \brief Entity the sensor is attached to.
+      private: physics::EntityPtr parentEntity;
+
+      /// \brief Image width.
+      private: unsigned int width;
+
+      /// \brief Image height.
+      private: unsigned int height;
+
+      /// \brief Near clip distance.
+      private: double nearClip;
+
+      /// \brief Far clip distance.
+      private: double farClip;
+
+      /// \brief True to compute a point cloud as well as depths.
+      private: bool outputPoints;
+
+      /// \brief Noise model of the depths, NULL for none.
+      private: NoisePtr noise;
+
+      /// \brief Number of frames traced, to get the draws of the noise.
+      private: uint64_t frameCount;
+
+      /// \brief Unit ray direction of each pixel in the sensor frame,
+      /// x, y, z values.
+      private: std::vector<double> rays;
+
+      /// \brief Depth of each pixel.
+      private: std::vector<float> depths;
+
+      /// \brief x, y, z, rgb values of each pixel, in the sensor frame.
+      private: std::vector<float> points;
+
+      /// \brief Message with the depths.
+      private: msgs::ImageStamped imageMsg;
+
+      /// \brief Publisher of the depth images.
+      private: transport::PublisherPtr imagePub;
+
+      /// \brief Protects the depths and point cloud.
+      private: mutable boost::mutex mutex;
+
+      /// \brief Event used to signal depth data
+      private: event::EventT<void(const float *, unsigned int, unsigned int,
+                   unsigned int, const std::string &)> newDepthFrame;
+
+      /// \brief Event used to signal point cloud data
+      private: event::EventT<void(const float *, unsigned int, unsigned int,
+                   unsigned int, const std::string &)> newRGBPointCloud;
+    };
+    /// \}
+  }
+}
+#endif
@@ -25,12 +25,12 @@
 
 #include "gazebo/math/Vector3.hh"
 #include "gazebo/math/Pose.hh"
-#include "gazebo/math/Rand.hh"
 
 #include "gazebo/physics/Link.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 
+#include "gazebo/sensors/Noise.hh"
 #include "gazebo/sensors/SensorFactory.hh"
 #include "gazebo/sensors/ImuSensor.hh"
 
@@ -73,63 +73,25 @@ void ImuSensor::Load(const std::string &_worldName, sdf::ElementPtr _sdf)
   }
 
   // Handle noise model settings.
-  this->noiseActive = false;
+  this->rateNoise.reset();
+  this->accelNoise.reset();
   sdf::ElementPtr imuElem = this->sdf->GetElement("imu");
   if (imuElem->HasElement("noise"))
   {
     sdf::ElementPtr noiseElem = imuElem->GetElement("noise");
     std::string type = noiseElem->GetValueString("type");
-    if (type == "gaussian")
+    if (noiseElem->HasElement("rate"))
     {
-      this->noiseActive = true;
-      this->noiseType = GAUSSIAN;
-      this->rateNoiseMean = 0.0;
-      this->rateNoiseStdDev = 0.0;
-      this->rateBias = 0.0;
-      this->accelNoiseMean = 0.0;
-      this->accelNoiseStdDev = 0.0;
-      this->accelBias = 0.0;
-      if (noiseElem->HasElement("rate"))
-      {
-        sdf::ElementPtr rateElem = noiseElem->GetElement("rate");
-        this->rateNoiseMean = rateElem->GetValueDouble("mean");
-        this->rateNoiseStdDev = rateElem->GetValueDouble("stddev");
-        double rateBiasMean = rateElem->GetValueDouble("bias_mean");
-        double rateBiasStddev = rateElem->GetValueDouble("bias_stddev");
-        // Sample the bias that we'll use later
-        this->rateBias = math::Rand::GetDblNormal(rateBiasMean, rateBiasStddev);
-        // With equal probability, we pick a negative bias (by convention,
-        // rateBiasMean should be positive, though it would work fine if
-        // negative).
-        if (math::Rand::GetDblUniform() < 0.5)
-          this->rateBias = -this->rateBias;
-        gzlog << "applying Gaussian noise model to rate with mean " <<
-          this->rateNoiseMean << " and stddev " << this->rateNoiseStdDev <<
-          ", bias " << this->rateBias << std::endl;
-      }
-      if (noiseElem->HasElement("accel"))
-      {
-        sdf::ElementPtr accelElem = noiseElem->GetElement("accel");
-        this->accelNoiseMean = accelElem->GetValueDouble("mean");
-        this->accelNoiseStdDev = accelElem->GetValueDouble("stddev");
-        double accelBiasMean = accelElem->GetValueDouble("bias_mean");
-        double accelBiasStddev = accelElem->GetValueDouble("bias_stddev");
-        // Sample the bias that we'll use later
-        this->accelBias = math::Rand::GetDblNormal(accelBiasMean,
-                                                   accelBiasStddev);
-        // With equal probability, we pick a negative bias (by convention,
-        // accelBiasMean should be positive, though it would work fine if
-        // negative).
-        if (math::Rand::GetDblUniform() < 0.5)
-          this->accelBias = -this->accelBias;
-        gzlog << "applying Gaussian noise model to accel with mean " <<
-          this->accelNoiseMean << " and stddev " << this->accelNoiseStdDev <<
-          ", bias " << this->accelBias << std::endl;
-      }
+      this->rateNoise.reset(new Noise());
+      this->rateNoise->Load(noiseElem->GetElement("rate"), type,
+                            this->GetScopedName() + "::rate");
+    }
+    if (noiseElem->HasElement("accel"))
+    {
+      this->accelNoise.reset(new Noise());
+      this->accelNoise->Load(noiseElem->GetElement("accel"), type,
+                             this->GetScopedName() + "::accel");
     }
-    else
-      gzwarn << "ignoring unknown noise model type \"" << type << "\"" <<
-        std::endl;
   }
 }
 
@@ -240,41 +202,26 @@ void ImuSensor::UpdateImpl(bool /*_force*/)
 
     msgs::Set(this->imuMsg.mutable_linear_acceleration(), this->linearAcc);
 
-    if (this->noiseActive)
+    // Add noise + bias to each rate and each acceleration
+    // TODO: add noise to orientation
+    if (this->rateNoise)
+    {
+      math::Vector3 rate = msgs::Convert(this->imuMsg.angular_velocity());
+      double values[3] = {rate.x, rate.y, rate.z};
+      this->rateNoise->UpdateBias(dt);
+      this->rateNoise->Apply(values, 3);
+      msgs::Set(this->imuMsg.mutable_angular_velocity(),
+                math::Vector3(values[0], values[1], values[2]));
+    }
+
+    if (this->accelNoise)
     {
-      switch (this->noiseType)
-      {
-        case GAUSSIAN:
-          // Add Gaussian noise + fixed bias to each rate
-          this->imuMsg.mutable_angular_velocity()->set_x(
-            this->imuMsg.angular_velocity().x() + this->rateBias +
-            math::Rand::GetDblNormal(this->rateNoiseMean, this->rateNoiseStdDev));
-          this->imuMsg.mutable_angular_velocity()->set_y(
-            this->imuMsg.angular_velocity().y() + this->rateBias +
-            math::Rand::GetDblNormal(this->rateNoiseMean, this->rateNoiseStdDev));
-          this->imuMsg.mutable_angular_velocity()->set_z(
-            this->imuMsg.angular_velocity().z() + this->rateBias +
-            math::Rand::GetDblNormal(this->rateNoiseMean, this->rateNoiseStdDev));
-
-          // Add Gaussian noise + fixed bias to each acceleration
-          this->imuMsg.mutable_linear_acceleration()->set_x(
-            this->imuMsg.linear_acceleration().x() + this->accelBias +
-            math::Rand::GetDblNormal(this->accelNoiseMean,
-                                     this->accelNoiseStdDev));
-          this->imuMsg.mutable_linear_acceleration()->set_y(
-            this->imuMsg.linear_acceleration().y() + this->accelBias +
-            math::Rand::GetDblNormal(this->accelNoiseMean,
-                                     this->accelNoiseStdDev));
-          this->imuMsg.mutable_linear_acceleration()->set_z(
-            this->imuMsg.linear_acceleration().z() + this->accelBias +
-            math::Rand::GetDblNormal(this->accelNoiseMean,
-                                     this->accelNoiseStdDev));
-
-          // TODO: add noise to orientation
-          break;
-        default:
-          GZ_ASSERT(false, "Invalid noise model type");
-      }
+      double values[3] = {this->linearAcc.x, this->linearAcc.y,
+                          this->linearAcc.z};
+      this->accelNoise->UpdateBias(dt);
+      this->accelNoise->Apply(values, 3);
+      msgs::Set(this->imuMsg.mutable_linear_acceleration(),
+                math::Vector3(values[0], values[1], values[2]));
     }
   }
 
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <math.h>
+#include <vector>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/math/Helpers.hh"
+#include "gazebo/math/Rand.hh"
+#include "gazebo/sensors/Noise.hh"
+
+using namespace gazebo;
+using namespace sensors;
+
+//////////////////////////////////////////////////
+Noise::Noise()
+  : type(NONE), mean(0), stdDev(0), bias(0), dynamicBiasStdDev(0),
+    dynamicBiasCorrelationTime(0), dynamicBias(0), precision(0), draw(0),
+    biasDraw(0)
+{
+}
+
+//////////////////////////////////////////////////
+Noise::~Noise()
+{
+}
+
+//////////////////////////////////////////////////
+void Noise::Load(sdf::ElementPtr _sdf, const std::string &_type,
+                 const std::string &_name)
+{
+  this->type = NONE;
+  this->mean = 0;
+  this->stdDev = 0;
+  this->bias = 0;
+  this->dynamicBiasStdDev = 0;
+  this->dynamicBiasCorrelationTime = 0;
+  this->dynamicBias = 0;
+  this->precision = 0;
+
+  if (_type != "gaussian")
+  {
+    gzwarn << "ignoring unknown noise model type \"" << _type << "\"" <<
+      std::endl;
+    return;
+  }
+
+  this->type = GAUSSIAN;
+  this->mean = _sdf->GetValueDouble("mean");
+  this->stdDev = _sdf->GetValueDouble("stddev");
+  this->dynamicBiasStdDev = _sdf->GetValueDouble("dynamic_bias_stddev");
+  this->dynamicBiasCorrelationTime =
+    _sdf->GetValueDouble("dynamic_bias_correlation_time");
+  this->precision = _sdf->GetValueDouble("precision");
+
+  uint32_t seed = math::Rand::GetSeed();
+  this->stream = math::RandStream(seed, _name);
+  this->biasStream = math::RandStream(seed, _name + "::bias");
+  this->draw = 0;
+
+  // The first draw of the bias stream gives the bias, the next ones its
+  // drift
+  this->biasDraw = 1;
+  double biasMean = _sdf->GetValueDouble("bias_mean");
+  double biasStdDev = _sdf->GetValueDouble("bias_stddev");
+  if (!math::equal(biasMean, 0.0) || !math::equal(biasStdDev, 0.0))
+  {
+    double samples[2];
+    this->biasStream.GetNormal(0, samples, 2);
+    this->bias = biasMean + biasStdDev * samples[0];
+
+    // With equal probability, we pick a negative bias (by convention,
+    // biasMean should be positive, though it would work fine if
+    // negative).
+    if (samples[1] < 0)
+      this->bias = -this->bias;
+  }
+
+  gzlog << "applying Gaussian noise model to " << _name << " with mean " <<
+    this->mean << ", stddev " << this->stdDev << " and bias " <<
+    this->bias << std::endl;
+}
+
+//////////////////////////////////////////////////
+Noise::NoiseType Noise::GetNoiseType() const
+{
+  return this->type;
+}
+
+//////////////////////////////////////////////////
+double Noise::GetMean() const
+{
+  return this->mean;
+}
+
+//////////////////////////////////////////////////
+double Noise::GetStdDev() const
+{
+  return this->stdDev;
+}
+
+//////////////////////////////////////////////////
+double Noise::GetBias() const
+{
+  return this->bias + this->dynamicBias;
+}
+
+//////////////////////////////////////////////////
+double Noise::GetPrecision() const
+{
+  return this->precision;
+}
+
+//////////////////////////////////////////////////
+void Noise::UpdateBias(double _dt)
+{
+  if (this->type == NONE || _dt <= 0 || this->dynamicBiasStdDev <= 0 ||
+      this->dynamicBiasCorrelationTime <= 0)
+  {
+    return;
+  }
+
+  // Discrete Gauss-Markov process, whose stationary standard deviation is
+  // dynamicBiasStdDev whatever the time step
+  double phi = exp(-_dt / this->dynamicBiasCorrelationTime);
+  this->dynamicBias = phi * this->dynamicBias +
+    this->dynamicBiasStdDev * sqrt(1.0 - phi * phi) *
+    this->biasStream.GetDblNormal(this->biasDraw++);
+}
+
+//////////////////////////////////////////////////
+double Noise::Apply(double _value)
+{
+  this->Add(this->draw++, &_value, 1);
+  return _value;
+}
+
+//////////////////////////////////////////////////
+void Noise::Apply(double *_values, unsigned int _count)
+{
+  this->Add(this->draw++, _values, _count);
+}
+
+//////////////////////////////////////////////////
+void Noise::Apply(float *_values, unsigned int _count)
+{
+  this->Add(this->draw++, _values, _count);
+}
+
+//////////////////////////////////////////////////
+void Noise::ApplyAt(uint64_t _draw, double *_values,
+                    unsigned int _count) const
+{
+  this->Add(_draw, _values, _count);
+}
+
+//////////////////////////////////////////////////
+void Noise::ApplyAt(uint64_t _draw, float *_values,
+                    unsigned int _count) const
+{
+  this->Add(_draw, _values, _count);
+}
+
+//////////////////////////////////////////////////
+template<typename T>
+void Noise::Add(uint64_t _draw, T *_values, unsigned int _count) const
+{
+  if (this->type == NONE || _count == 0)
+    return;
+
+  double offset = this->mean + this->bias + this->dynamicBias;
+  if (this->stdDev > 0)
+  {
+    std::vector<double> samples(_count);
+    this->stream.GetNormal(_draw, &samples[0], _count, offset,
+                           this->stdDev);
+    for (unsigned int i = 0; i < _count; ++i)
+      _values[i] = static_cast<T>(_values[i] + samples[i]);
+  }
+  else if (!math::equal(offset, 0.0))
+  {
+    for (unsigned int i = 0; i < _count; ++i)
+      _values[i] = static_cast<T>(_values[i] + offset);
+  }
+
+  if (this->precision > 0)
+  {
+    for (unsigned int i = 0; i < _count; ++i)
+    {
+      _values[i] = static_cast<T>(this->precision *
+          floor(_values[i] / this->precision + 0.5));
+    }
+  }
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _NOISE_HH_
+#define _NOISE_HH_
+
+#include <string>
+
+#include "gazebo/sdf/sdf.hh"
+#include "gazebo/math/RandStream.hh"
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    /// \addtogroup gazebo_sensors
+    /// \{
+
+    /// \class Noise Noise.hh sensors/sensors.hh
+    /// \brief Noise model of the values measured by a sensor.
+    ///
+    /// The "gaussian" model adds to each value a sample of a normal
+    /// distribution and a bias. The bias is drawn once, and can drift
+    /// as a first order Gauss-Markov process. Noisy values can then be
+    /// rounded to the precision of the sensor.
+    ///
+    /// Samples come from a math::RandStream named after the sensor, with
+    /// one counter per draw, so the noise of a sensor only depends on the
+    /// seed and on how many times the sensor was updated, not on the
+    /// other sensors or on the threads they run in.
+    class Noise
+    {
+      /// \brief Noise models.
+      public: enum NoiseType
+              {
+                /// \brief Values are left as they are.
+                NONE,
+
+                /// \brief Normal distribution, bias and precision.
+                GAUSSIAN
+              };
+
+      /// \brief Constructor, with no noise.
+      public: Noise();
+
+      /// \brief Destructor.
+      public: virtual ~Noise();
+
+      /// \brief Load the parameters.
+      /// \param[in] _sdf Element with the parameters: mean, stddev, and
+      /// optionally bias_mean, bias_stddev, dynamic_bias_stddev,
+      /// dynamic_bias_correlation_time and precision.
+      /// \param[in] _type Name of the model, "gaussian".
+      /// \param[in] _name Name of the random stream, unique in the world,
+      /// usually the scoped name of the sensor.
+      public: void Load(sdf::ElementPtr _sdf, const std::string &_type,
+                        const std::string &_name);
+
+      /// \brief Get the noise model.
+      /// \return The noise model.
+      public: NoiseType GetNoiseType() const;
+
+      /// \brief Get the mean of the normal distribution.
+      /// \return The mean.
+      public: double GetMean() const;
+
+      /// \brief Get the standard deviation of the normal distribution.
+      /// \return The standard deviation.
+      public: double GetStdDev() const;
+
+      /// \brief Get the bias added to the values, with its drift.
+      /// \return The bias.
+      public: double GetBias() const;
+
+      /// \brief Get the precision of the values.
+      /// \return The precision, 0 for none.
+      public: double GetPrecision() const;
+
+      /// \brief Let the bias drift.
+      /// \param[in] _dt Time since the last call, in seconds.
+      public: void UpdateBias(double _dt);
+
+      /// \brief Apply the noise to one value, with the next draw.
+      /// \param[in] _value The value.
+      /// \return The noisy value.
+      public: double Apply(double _value);
+
+      /// \brief Apply the noise to values, with the next draw.
+      /// \param[in,out] _values The values.
+      /// \param[in] _count Number of values.
+      public: void Apply(double *_values, unsigned int _count);
+
+      /// \brief Apply the noise to values, with the next draw.
+      /// \param[in,out] _values The values.
+      /// \param[in] _count Number of values.
+      public: void Apply(float *_values, unsigned int _count);
+
+      /// \brief Apply the noise to values, with a given draw. Can be
+      /// called from several threads, with different draws.
+      /// \param[in] _draw The draw.
+      /// \param[in,out] _values The values.
+      /// \param[in] _count Number of values.
+      public: void ApplyAt(uint64_t _draw, double *_values,
+                           unsigned int _count) const;
+
+      /// \brief Apply the noise to values, with a given draw. Can be
+      /// called from several threads, with different draws.
+      /// \param[in] _draw The draw.
+      /// \param[in,out] _values The values.
+      /// \param[in] _count Number of values.
+      public: void ApplyAt(uint64_t _draw, float *_values,
+                           unsigned int _count) const;
+
+      /// \brief Add the noise to values.
+      /// \param[in] _draw The draw.
+      /// \param[in,out] _values The values.
+      /// \param[in] _count Number of values.
+      private: template<typename T>
+               void Add(uint64_t _draw, T *_values,
+                        unsigned int _count) const;
+
+      /// \brief The noise model.
+      private: NoiseType type;
+
+      /// \brief Mean of the normal distribution.
+      private: double mean;
+
+      /// \brief Standard deviation of the normal distribution.
+      private: double stdDev;
+
+      /// \brief Bias drawn when loading.
+      private: double bias;
+
+      /// \brief Standard deviation of the drift of the bias.
+      private: double dynamicBiasStdDev;
+
+      /// \brief Correlation time of the drift of the bias, in seconds.
+      private: double dynamicBiasCorrelationTime;
+
+      /// \brief Current drift of the bias.
+      private: double dynamicBias;
+
+      /// \brief Values are rounded to multiples of it, if not 0.
+      private: double precision;
+
+      /// \brief Stream of the noise.
+      private: math::RandStream stream;
+
+      /// \brief Stream of the bias and its drift.
+      private: math::RandStream biasStream;
+
+      /// \brief Next draw of the noise.
+      private: uint64_t draw;
+
+      /// \brief Next draw of the drift.
+      private: uint64_t biasDraw;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "gazebo/sdf/sdf.hh"
+#include "gazebo/math/Helpers.hh"
+#include "gazebo/math/Rand.hh"
+#include "gazebo/sensors/Noise.hh"
+
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+/// \brief Get the noise element of a ray
+/// \param[in] _noise Children of the noise element
+/// \return The noise element
+static sdf::ElementPtr noiseElement(const std::string &_noise)
+{
+  sdf::ElementPtr sdf(new sdf::Element());
+  sdf::initFile("ray.sdf", sdf);
+  sdf::readString(
+      "<sdf version='" SDF_VERSION "'>"
+      "  <ray>"
+      "    <scan>"
+      "      <horizontal>"
+      "        <samples>640</samples>"
+      "        <min_angle>-2.2689</min_angle>"
+      "        <max_angle>2.2689</max_angle>"
+      "      </horizontal>"
+      "    </scan>"
+      "    <range>"
+      "      <min>0.08</min>"
+      "      <max>10.0</max>"
+      "    </range>"
+      "    <noise>"
+      "      <type>gaussian</type>" + _noise +
+      "    </noise>"
+      "  </ray>"
+      "</sdf>", sdf);
+  return sdf->GetElement("noise");
+}
+
+/////////////////////////////////////////////////
+TEST(NoiseTest, None)
+{
+  sensors::Noise noise;
+  EXPECT_EQ(noise.GetNoiseType(), sensors::Noise::NONE);
+  EXPECT_DOUBLE_EQ(noise.Apply(1.5), 1.5);
+
+  noise.Load(noiseElement("<mean>1</mean>"), "unknown", "sensor");
+  EXPECT_EQ(noise.GetNoiseType(), sensors::Noise::NONE);
+  EXPECT_DOUBLE_EQ(noise.Apply(1.5), 1.5);
+}
+
+/////////////////////////////////////////////////
+TEST(NoiseTest, Gaussian)
+{
+  math::Rand::SetSeed(1001);
+  sensors::Noise noise;
+  noise.Load(noiseElement("<mean>0.5</mean><stddev>0.2</stddev>"),
+             "gaussian", "sensor");
+  EXPECT_EQ(noise.GetNoiseType(), sensors::Noise::GAUSSIAN);
+  EXPECT_DOUBLE_EQ(noise.GetMean(), 0.5);
+  EXPECT_DOUBLE_EQ(noise.GetStdDev(), 0.2);
+  EXPECT_DOUBLE_EQ(noise.GetBias(), 0.0);
+
+  const unsigned int count = 100000;
+  std::vector<double> values(count, 1.0);
+  noise.Apply(&values[0], count);
+
+  double sum = 0;
+  double sumSq = 0;
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    sum += values[i];
+    sumSq += values[i] * values[i];
+  }
+  double mean = sum / count;
+  EXPECT_NEAR(mean, 1.5, 0.005);
+  EXPECT_NEAR(sqrt(sumSq / count - mean * mean), 0.2, 0.005);
+}
+
+/////////////////////////////////////////////////
+TEST(NoiseTest, Reproducible)
+{
+  math::Rand::SetSeed(1001);
+  sdf::ElementPtr elem = noiseElement("<stddev>1</stddev>");
+  sensors::Noise a, b, c;
+  a.Load(elem, "gaussian", "sensor");
+  b.Load(elem, "gaussian", "sensor");
+  c.Load(elem, "gaussian", "other");
+
+  std::vector<double> first(10, 0.0), second(10, 0.0), other(10, 0.0);
+  for (unsigned int draw = 0; draw < 3; ++draw)
+  {
+    std::fill(first.begin(), first.end(), 0.0);
+    std::fill(second.begin(), second.end(), 0.0);
+    std::fill(other.begin(), other.end(), 0.0);
+    a.Apply(&first[0], first.size());
+    b.ApplyAt(draw, &second[0], second.size());
+    c.Apply(&other[0], other.size());
+
+    for (unsigned int i = 0; i < first.size(); ++i)
+    {
+      EXPECT_DOUBLE_EQ(first[i], second[i]);
+      EXPECT_NE(first[i], other[i]);
+    }
+  }
+
+  // Float values get the same noise
+  std::vector<float> floats(10, 0.0f);
+  b.ApplyAt(2, &floats[0], floats.size());
+  for (unsigned int i = 0; i < floats.size(); ++i)
+    EXPECT_FLOAT_EQ(floats[i], first[i]);
+
+  // Another seed gives other values
+  math::Rand::SetSeed(1002);
+  b.Load(elem, "gaussian", "sensor");
+  std::fill(second.begin(), second.end(), 0.0);
+  b.ApplyAt(2, &second[0], second.size());
+  EXPECT_NE(first[0], second[0]);
+}
+
+/////////////////////////////////////////////////
+TEST(NoiseTest, BiasAndPrecision)
+{
+  math::Rand::SetSeed(1001);
+  sensors::Noise noise;
+  noise.Load(noiseElement(
+        "<bias_mean>0.25</bias_mean><precision>0.1</precision>"),
+      "gaussian", "sensor");
+  EXPECT_NEAR(fabs(noise.GetBias()), 0.25, 1e-9);
+  EXPECT_DOUBLE_EQ(noise.GetPrecision(), 0.1);
+
+  // Only the bias, then rounding
+  EXPECT_NEAR(noise.Apply(1.0), 1.0 + noise.GetBias(), 0.05 + 1e-9);
+
+  noise.Load(noiseElement(
+        "<stddev>0.3</stddev><precision>0.1</precision>"),
+      "gaussian", "sensor");
+  std::vector<double> values(100, 2.0);
+  noise.Apply(&values[0], values.size());
+  for (unsigned int i = 0; i < values.size(); ++i)
+  {
+    double steps = values[i] / 0.1;
+    EXPECT_NEAR(steps, floor(steps + 0.5), 1e-6);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(NoiseTest, BiasDrift)
+{
+  math::Rand::SetSeed(1001);
+  sensors::Noise noise;
+  noise.Load(noiseElement(
+        "<dynamic_bias_stddev>0.1</dynamic_bias_stddev>"
+        "<dynamic_bias_correlation_time>2</dynamic_bias_correlation_time>"),
+      "gaussian", "sensor");
+  EXPECT_DOUBLE_EQ(noise.GetBias(), 0.0);
+
+  // Weakly correlated steps, whose deviation is the stationary one
+  const unsigned int count = 20000;
+  double sum = 0;
+  double sumSq = 0;
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    noise.UpdateBias(2.0);
+    sum += noise.GetBias();
+    sumSq += noise.GetBias() * noise.GetBias();
+  }
+  double mean = sum / count;
+  EXPECT_NEAR(mean, 0.0, 0.01);
+  EXPECT_NEAR(sqrt(sumSq / count - mean * mean), 0.1, 0.005);
+
+  // The values follow the bias
+  double bias = noise.GetBias();
+  EXPECT_DOUBLE_EQ(noise.Apply(1.0), 1.0 + bias);
+}
@@ -21,6 +21,7 @@
 
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/Entity.hh"
+#include "gazebo/physics/SpatialIndex.hh"
 
 #include "gazebo/common/Exception.hh"
 
@@ -40,6 +41,9 @@ using namespace sensors;
 
 GZ_REGISTER_STATIC_SENSOR("rfid", RFIDSensor)
 
+/// \brief Distance within which tags are detected.
+static const double RFIDSensorRange = 5.0;
+
 /////////////////////////////////////////////////
 RFIDSensor::RFIDSensor()
   : Sensor(sensors::OTHER)
@@ -74,6 +78,15 @@ void RFIDSensor::Load(const std::string &_worldName)
 
   this->entity = this->world->GetEntity(this->parentName);
 
+  // The index is shared by the world, so the last sensor loaded sets it
+  physics::SpatialIndexPtr index = this->world->GetSpatialIndex();
+  if (index && this->sdf->HasElement("rfid") &&
+      this->sdf->GetElement("rfid")->HasElement("index_period"))
+  {
+    index->SetRebuildPeriod(
+        this->sdf->GetElement("rfid")->GetValueDouble("index_period"));
+  }
+
   // this->sdf->PrintDescription("something");
   /*std::cout << " setup ray" << std::endl;
   physics::PhysicsEnginePtr physicsEngine = world->GetPhysicsEngine();
@@ -139,18 +152,43 @@ void RFIDSensor::UpdateImpl(bool /*_force*/)
 //////////////////////////////////////////////////
 void RFIDSensor::EvaluateTags()
 {
-  std::vector<RFIDTag*>::const_iterator ci;
+  std::vector<RFIDTag*> detected;
+
+  // Only the links near the sensor are looked at, instead of every tag
+  physics::SpatialIndexPtr index = this->world->GetSpatialIndex();
+  if (index && !this->linkTags.empty())
+  {
+    physics::Link_V links;
+    index->GetLinksInRadius(this->entity->GetWorldPose().pos,
+                            RFIDSensorRange, links);
+
+    for (physics::Link_V::iterator iter = links.begin();
+         iter != links.end(); ++iter)
+    {
+      std::map<physics::Entity*, std::vector<RFIDTag*> >::iterator tagIter =
+        this->linkTags.find(iter->get());
+      if (tagIter == this->linkTags.end())
+        continue;
+
+      for (std::vector<RFIDTag*>::iterator ti = tagIter->second.begin();
+           ti != tagIter->second.end(); ++ti)
+      {
+        if (this->CheckTagRange((*ti)->GetTagPose()))
+          detected.push_back(*ti);
+      }
+    }
+  }
 
-  // iterate through the tags contained given rfid tag manager
-  for (ci = this->tags.begin(); ci != this->tags.end(); ++ci)
+  std::vector<RFIDTag*> &unindexed = index ? this->otherTags : this->tags;
+  for (std::vector<RFIDTag*>::const_iterator ci = unindexed.begin();
+       ci != unindexed.end(); ++ci)
   {
-    math::Pose pos = (*ci)->GetTagPose();
-    // std::cout << "link: " << tagModelPtr->GetName() << std::endl;
-    // std::cout << "link pos: x" << pos.pos.x
-    //     << " y:" << pos.pos.y
-    //     << " z:" << pos.pos.z << std::endl;
-    this->CheckTagRange(pos);
+    if (this->CheckTagRange((*ci)->GetTagPose()))
+      detected.push_back(*ci);
   }
+
+  boost::mutex::scoped_lock lock(this->mutex);
+  this->detectedTags.swap(detected);
 }
 
 //////////////////////////////////////////////////
@@ -162,7 +200,7 @@ bool RFIDSensor::CheckTagRange(const math::Pose &_pose)
 
   // std::cout << v.GetLength() << std::endl;
 
-  if (v.GetLength() <= 5.0)
+  if (v.GetLength() <= RFIDSensorRange)
   {
     // std::cout << "detected " <<  v.GetLength() << std::endl;
     return true;
@@ -176,6 +214,19 @@ bool RFIDSensor::CheckTagRange(const math::Pose &_pose)
 void RFIDSensor::AddTag(RFIDTag *_tag)
 {
   this->tags.push_back(_tag);
+
+  physics::EntityPtr tagEntity = _tag->GetTagEntity();
+  if (tagEntity && tagEntity->HasType(physics::Base::LINK))
+    this->linkTags[tagEntity.get()].push_back(_tag);
+  else
+    this->otherTags.push_back(_tag);
+}
+
+//////////////////////////////////////////////////
+std::vector<RFIDTag*> RFIDSensor::GetDetectedTags() const
+{
+  boost::mutex::scoped_lock lock(this->mutex);
+  return this->detectedTags;
 }
 
 //////////////////////////////////////////////////
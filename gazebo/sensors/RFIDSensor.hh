@@ -22,9 +22,12 @@
 #ifndef _RFIDSENSOR_HH_
 #define _RFIDSENSOR_HH_
 
+#include <map>
 #include <vector>
 #include <string>
 
+#include <boost/thread/mutex.hpp>
+
 #include "gazebo/physics/PhysicsTypes.hh"
 
 #include "gazebo/transport/TransportTypes.hh"
@@ -67,13 +70,17 @@ namespace gazebo
       // Documentation inherited
       public: void AddTag(RFIDTag *_tag);
 
+      /// \brief Get the tags found in range by the last update.
+      /// \return The tags.
+      public: std::vector<RFIDTag*> GetDetectedTags() const;
+
       protected: virtual void UpdateImpl(bool _force);
 
       // Documentation inherited
       public: virtual void Fini();
 
-      /// \brief Iterates through all the RFID tags, and finds the ones which
-      /// are in range of the sensor.
+      /// \brief Finds the RFID tags which are in range of the sensor. Tags
+      /// on links are looked up in the spatial index of the world.
       private: void EvaluateTags();
 
       /// \brief Check the range for one RFID tag.
@@ -100,6 +107,18 @@ namespace gazebo
 
       /// \brief All the RFID tags.
       private: std::vector<RFIDTag*> tags;
+
+      /// \brief Tags on links, by link.
+      private: std::map<physics::Entity*, std::vector<RFIDTag*> > linkTags;
+
+      /// \brief Tags on other entities, checked one by one.
+      private: std::vector<RFIDTag*> otherTags;
+
+      /// \brief Tags found in range by the last update.
+      private: std::vector<RFIDTag*> detectedTags;
+
+      /// \brief Protects detectedTags.
+      private: mutable boost::mutex mutex;
     };
     /// \}
   }
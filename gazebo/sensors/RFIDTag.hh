@@ -68,6 +68,11 @@ namespace gazebo
       public: math::Pose GetTagPose() const
               {return entity->GetWorldPose();}
 
+      /// \brief Returns the entity that has the RFID tag.
+      /// \return The entity.
+      public: physics::EntityPtr GetTagEntity() const
+              {return this->entity;}
+
       /// \brief Pointer the entity that has the RFID tag.
       private: physics::EntityPtr entity;
 
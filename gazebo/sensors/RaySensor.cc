@@ -34,9 +34,10 @@
 #include "gazebo/transport/Publisher.hh"
 #include "gazebo/msgs/msgs.hh"
 
+#include "gazebo/math/Helpers.hh"
 #include "gazebo/math/Vector3.hh"
-#include "gazebo/math/Rand.hh"
 
+#include "gazebo/sensors/Noise.hh"
 #include "gazebo/sensors/SensorFactory.hh"
 #include "gazebo/sensors/RaySensor.hh"
 
@@ -106,24 +107,14 @@ void RaySensor::Load(const std::string &_worldName)
   this->laserShape->Init();
 
   // Handle noise model settings.
-  this->noiseActive = false;
+  this->noise.reset();
   sdf::ElementPtr rayElem = this->sdf->GetElement("ray");
   if (rayElem->HasElement("noise"))
   {
     sdf::ElementPtr noiseElem = rayElem->GetElement("noise");
-    std::string type = noiseElem->GetValueString("type");
-    if (type == "gaussian")
-    {
-      this->noiseType = GAUSSIAN;
-      this->noiseMean = noiseElem->GetValueDouble("mean");
-      this->noiseStdDev = noiseElem->GetValueDouble("stddev");
-      this->noiseActive = true;
-      gzlog << "applying Gaussian noise model with mean " << this->noiseMean <<
-        " and stddev " << this->noiseStdDev << std::endl;
-    }
-    else
-      gzwarn << "ignoring unknown noise model type \"" << type << "\"" <<
-        std::endl;
+    this->noise.reset(new Noise());
+    this->noise->Load(noiseElem, noiseElem->GetValueString("type"),
+                      this->GetScopedName());
   }
 
   this->parentEntity = this->world->GetEntity(this->parentName);
@@ -273,6 +264,7 @@ void RaySensor::UpdateImpl(bool /*_force*/)
   // need to move mutex lock after this? or make the OnNewLaserScan connection
   // call somewhere else?
   this->laserShape->Update();
+  common::Time prevMeasurementTime = this->lastMeasurementTime;
   this->lastMeasurementTime = this->world->GetSimTime();
 
   // moving this behind laserShape update
@@ -295,28 +287,31 @@ void RaySensor::UpdateImpl(bool /*_force*/)
   scan->clear_ranges();
   scan->clear_intensities();
 
-  // todo: add loop for vertical range count
-  for (unsigned int j = 0; j < (unsigned int)this->GetVerticalRayCount(); j++)
-  for (unsigned int i = 0; i < (unsigned int)this->GetRayCount(); i++)
+  unsigned int rangeCount = this->GetRayCount() * this->GetVerticalRayCount();
+  std::vector<double> ranges(rangeCount);
+  for (unsigned int i = 0; i < rangeCount; ++i)
+    ranges[i] = this->laserShape->GetRange(i);
+
+  if (this->noise && rangeCount > 0)
   {
-    double range = this->laserShape->GetRange(j * this->GetRayCount() + i);
-    if (this->noiseActive)
+    this->noise->UpdateBias(
+        (this->lastMeasurementTime - prevMeasurementTime).Double());
+
+    // Add independent (uncorrelated) noise to each beam, all in one draw
+    this->noise->Apply(&ranges[0], rangeCount);
+
+    // No real laser would return a range outside its stated limits.
+    for (unsigned int i = 0; i < rangeCount; ++i)
     {
-      switch (this->noiseType)
-      {
-        case GAUSSIAN:
-          // Add independent (uncorrelated) Gaussian noise to each beam.
-          range += math::Rand::GetDblNormal(this->noiseMean, this->noiseStdDev);
-          // No real laser would return a range outside its stated limits.
-          range = math::clamp(range, this->GetRangeMin(), this->GetRangeMax());
-          break;
-        default:
-          GZ_ASSERT(false, "Invalid noise model type");
-      }
+      ranges[i] = math::clamp(ranges[i], this->GetRangeMin(),
+                              this->GetRangeMax());
     }
-    scan->add_ranges(range);
-    scan->add_intensities(
-        this->laserShape->GetRetro(j * this->GetRayCount() + i));
+  }
+
+  for (unsigned int i = 0; i < rangeCount; ++i)
+  {
+    scan->add_ranges(ranges[i]);
+    scan->add_intensities(this->laserShape->GetRetro(i));
   }
 
   if (this->scanPub)
@@ -29,6 +29,7 @@
 #include "math/Pose.hh"
 #include "transport/TransportTypes.hh"
 #include "sensors/Sensor.hh"
+#include "sensors/SensorTypes.hh"
 
 namespace gazebo
 {
@@ -173,22 +174,8 @@ namespace gazebo
       private: boost::mutex mutex;
       private: msgs::LaserScanStamped laserMsg;
 
-      // Which noise type we support
-      private: enum NoiseModelType
-      {
-        NONE,
-        GAUSSIAN
-      };
-      // If true, apply the noise model specified by other noise parameters
-      private: bool noiseActive;
-      // Which type of noise we're applying
-      private: enum NoiseModelType noiseType;
-      // If noiseType==GAUSSIAN, noiseMean is the mean of the distibution
-      // from which we sample
-      private: double noiseMean;
-      // If noiseType==GAUSSIAN, noiseStdDev is the standard devation of
-      // the distibution from which we sample
-      private: double noiseStdDev;
+      /// \brief Noise model of the ranges.
+      private: NoisePtr noise;
     };
     /// \}
   }
@@ -29,6 +29,7 @@
 #include "common/Console.hh"
 #include "common/Exception.hh"
 #include "common/Plugin.hh"
+#include "common/Trace.hh"
 
 #include "sensors/CameraSensor.hh"
 
@@ -132,6 +133,7 @@ void Sensor::Update(bool _force)
     if (this->world->GetSimTime() - this->lastUpdateTime >= this->updatePeriod
         || _force)
     {
+      GZ_TRACE_SCOPE("Sensor::Update");
       this->lastUpdateTime = this->world->GetSimTime();
       this->UpdateImpl(_force);
       this->updated();
@@ -21,6 +21,7 @@
  */
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Time.hh"
+#include "gazebo/common/Trace.hh"
 
 #include "gazebo/physics/Physics.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
@@ -428,17 +429,14 @@ void SensorManager::SensorContainer::Stop()
 //////////////////////////////////////////////////
 void SensorManager::SensorContainer::RunLoop()
 {
+  common::Trace::SetThreadName("sensors");
   this->stop = false;
 
-  physics::WorldPtr world = physics::get_world();
-  GZ_ASSERT(world != NULL, "Pointer to World is NULL");
+  // The sensors may belong to several worlds, each with its own sim time
+  World_M worlds;
+  std::map<std::string, common::Time> startTimes;
 
-  physics::PhysicsEnginePtr engine = world->GetPhysicsEngine();
-  GZ_ASSERT(engine != NULL, "Pointer to PhysicsEngine is NULL");
-
-  engine->InitForThread();
-
-  common::Time sleepTime, startTime, eventTime, diffTime;
+  common::Time sleepTime, eventTime, diffTime;
   double maxUpdateRate = 0;
 
   boost::mutex tmpMutex;
@@ -474,15 +472,28 @@ void SensorManager::SensorContainer::RunLoop()
     if (this->sensors.size() == 0)
       this->runCondition.wait(lock2);
 
-    // Get the start time of the update.
-    startTime = world->GetSimTime();
+    this->UpdateWorlds(worlds);
+
+    // Get the start time of the update in each world.
+    for (World_M::iterator iter = worlds.begin(); iter != worlds.end();
+         ++iter)
+    {
+      startTimes[iter->first] = iter->second->GetSimTime();
+    }
 
     this->Update(false);
 
-    // Compute the time it took to update the sensors.
+    // Compute the time it took to update the sensors, in the world that
+    // advanced the most.
     // It's possible that the world time was reset during the Update. This
     // would case a negative diffTime. Instead, just use a event time of zero
-    diffTime = std::max(common::Time::Zero, world->GetSimTime() - startTime);
+    diffTime = common::Time::Zero;
+    for (World_M::iterator iter = worlds.begin(); iter != worlds.end();
+         ++iter)
+    {
+      diffTime = std::max(diffTime,
+          iter->second->GetSimTime() - startTimes[iter->first]);
+    }
 
     // Set the default sleep time
     eventTime = std::max(common::Time::Zero, sleepTime - diffTime);
@@ -497,14 +508,55 @@ void SensorManager::SensorContainer::RunLoop()
     boost::mutex::scoped_lock timingLock(SensorManager::sensorTimingMutex);
 
     // Add an event to trigger when the appropriate simulation time has been
-    // reached.
-    SimTimeEventHandler::Instance()->AddRelativeEvent(eventTime,
-        &this->runCondition);
+    // reached in any of the worlds.
+    for (World_M::iterator iter = worlds.begin(); iter != worlds.end();
+         ++iter)
+    {
+      SimTimeEventHandler::Instance()->AddRelativeEvent(eventTime,
+          &this->runCondition, iter->second);
+    }
 
     this->runCondition.wait(timingLock);
   }
 }
 
+//////////////////////////////////////////////////
+void SensorManager::SensorContainer::UpdateWorlds(World_M &_worlds)
+{
+  World_M worlds;
+
+  boost::recursive_mutex::scoped_lock lock(this->mutex);
+
+  for (Sensor_V::iterator iter = this->sensors.begin();
+       iter != this->sensors.end(); ++iter)
+  {
+    GZ_ASSERT((*iter) != NULL, "Sensor is NULL");
+
+    std::string worldName = (*iter)->GetWorldName();
+    if (worlds.find(worldName) != worlds.end())
+      continue;
+
+    World_M::iterator worldIter = _worlds.find(worldName);
+    if (worldIter != _worlds.end())
+    {
+      worlds[worldName] = worldIter->second;
+      continue;
+    }
+
+    // A world that this thread hasn't seen before
+    physics::WorldPtr world = physics::get_world(worldName);
+    GZ_ASSERT(world != NULL, "Pointer to World is NULL");
+
+    physics::PhysicsEnginePtr engine = world->GetPhysicsEngine();
+    GZ_ASSERT(engine != NULL, "Pointer to PhysicsEngine is NULL");
+
+    engine->InitForThread();
+    worlds[worldName] = world;
+  }
+
+  _worlds.swap(worlds);
+}
+
 //////////////////////////////////////////////////
 void SensorManager::SensorContainer::Update(bool _force)
 {
@@ -636,9 +688,6 @@ void SensorManager::ImageSensorContainer::Update(bool _force)
 /////////////////////////////////////////////////
 SimTimeEventHandler::SimTimeEventHandler()
 {
-  this->world = physics::get_world();
-  GZ_ASSERT(this->world != NULL, "World pointer is NULL");
-
   this->updateConnection = event::Events::ConnectWorldUpdateBegin(
       boost::bind(&SimTimeEventHandler::OnUpdate, this, _1));
 }
@@ -658,24 +707,39 @@ SimTimeEventHandler::~SimTimeEventHandler()
 
 /////////////////////////////////////////////////
 void SimTimeEventHandler::AddRelativeEvent(const common::Time &_time,
-                                           boost::condition_variable *_var)
+                                           boost::condition_variable *_var,
+                                           physics::WorldPtr _world)
 {
+  GZ_ASSERT(_world != NULL, "World pointer is NULL");
+
   boost::mutex::scoped_lock lock(this->mutex);
 
-  // Create the new event.
-  SimTimeEvent *event = new SimTimeEvent;
-  event->time = this->world->GetSimTime() + _time;
-  event->condition = _var;
+  // Reuse the event that is still waiting on the condition in this world,
+  // if any, so that worlds which don't advance don't pile up events.
+  SimTimeEvent *event = NULL;
+  for (std::list<SimTimeEvent*>::iterator iter = this->events.begin();
+      iter != this->events.end() && !event; ++iter)
+  {
+    GZ_ASSERT(*iter != NULL, "SimTimeEvent is NULL");
+    if ((*iter)->condition == _var && (*iter)->worldName == _world->GetName())
+      event = *iter;
+  }
 
-  // Add the event to the list.
-  this->events.push_back(event);
+  // Create the new event, and add it to the list.
+  if (!event)
+  {
+    event = new SimTimeEvent;
+    event->condition = _var;
+    event->worldName = _world->GetName();
+    this->events.push_back(event);
+  }
+
+  event->time = _world->GetSimTime() + _time;
 }
 
 /////////////////////////////////////////////////
 void SimTimeEventHandler::OnUpdate(const common::UpdateInfo &_info)
 {
-  GZ_ASSERT(this->world != NULL, "World pointer is NULL");
-
   boost::mutex::scoped_lock timingLock(SensorManager::sensorTimingMutex);
   boost::mutex::scoped_lock lock(this->mutex);
 
@@ -685,9 +749,10 @@ void SimTimeEventHandler::OnUpdate(const common::UpdateInfo &_info)
   {
     GZ_ASSERT(*iter != NULL, "SimTimeEvent is NULL");
 
-    // Find events that have a time less than or equal to simulation
-    // time.
-    if ((*iter)->time <= _info.simTime)
+    // Find events of the updated world that have a time less than or
+    // equal to its simulation time.
+    if ((*iter)->worldName == _info.worldName &&
+        (*iter)->time <= _info.simTime)
     {
       // Notify the event by triggering its condition.
       (*iter)->condition->notify_all();
@@ -27,6 +27,7 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <map>
 
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/common/SingletonT.hh"
@@ -47,12 +48,15 @@ namespace gazebo
       /// \brief The time at which to trigger the condition.
       public: common::Time time;
 
+      /// \brief Name of the world whose simulation time is watched.
+      public: std::string worldName;
+
       /// \brief The condition to notify.
       public: boost::condition_variable *condition;
     };
 
     /// \brief Monitors simulation time, and notifies conditions when
-    /// a specified time has been reached.
+    /// a specified time has been reached in a world.
     class SimTimeEventHandler : public SingletonT<SimTimeEventHandler>
     {
       /// \brief Constructor
@@ -61,13 +65,16 @@ namespace gazebo
       /// \brief Destructor
       public: virtual ~SimTimeEventHandler();
 
-      /// \brief Add a new event to the handler.
-      /// \param[in] _time Time of the new event. The current sim time will
-      /// be add to this time.
+      /// \brief Add a new event to the handler. An event already waiting
+      /// on the same condition and world is replaced.
+      /// \param[in] _time Time of the new event. The current sim time of
+      /// the world will be add to this time.
       /// \param[in] _var Condition to notify when the time has been
       /// reached.
+      /// \param[in] _world World whose sim time is watched.
       public: void AddRelativeEvent(const common::Time &_time,
-                  boost::condition_variable *_var);
+                  boost::condition_variable *_var,
+                  physics::WorldPtr _world);
 
       /// \brief Called when the world is updated.
       /// \param[in] _info Update timing information.
@@ -79,9 +86,6 @@ namespace gazebo
       /// \brief The list of events to handle.
       private: std::list<SimTimeEvent*> events;
 
-      /// \brief Get sim time from the world.
-      private: physics::WorldPtr world;
-
       /// \brief This is a singleton class.
       private: friend class SingletonT<SimTimeEventHandler>;
 
@@ -227,6 +231,15 @@ namespace gazebo
                  /// runThread.
                  private: void RunLoop();
 
+                 /// \brief Map of world names to worlds.
+                 private: typedef std::map<std::string, physics::WorldPtr>
+                          World_M;
+
+                 /// \brief Update the worlds of the sensors, and prepare
+                 /// the physics engine of new worlds for the calling thread.
+                 /// \param[in,out] _worlds The worlds of the sensors.
+                 private: void UpdateWorlds(World_M &_worlds);
+
                  /// \brief The set of sensors to maintain.
                  public: Sensor_V sensors;
 
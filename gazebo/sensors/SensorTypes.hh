@@ -33,11 +33,13 @@ namespace gazebo
     class RaySensor;
     class CameraSensor;
     class DepthCameraSensor;
+    class CPUDepthCameraSensor;
     class ContactSensor;
     class ImuSensor;
     class GpuRaySensor;
     class RFIDSensor;
     class RFIDTag;
+    class Noise;
 
     /// \def SensorPtr
     /// \brief Shared pointer to Sensor
@@ -55,6 +57,10 @@ namespace gazebo
     /// \brief Shared pointer to DepthCameraSensor
     typedef boost::shared_ptr<DepthCameraSensor> DepthCameraSensorPtr;
 
+    /// \def CPUDepthCameraSensorPtr
+    /// \brief Shared pointer to CPUDepthCameraSensor
+    typedef boost::shared_ptr<CPUDepthCameraSensor> CPUDepthCameraSensorPtr;
+
     /// \def ContactSensorPtr
     /// \brief Shared pointer to ContactSensor
     typedef boost::shared_ptr<ContactSensor> ContactSensorPtr;
@@ -75,6 +81,10 @@ namespace gazebo
     /// \brief Shared pointer to RFIDTag
     typedef boost::shared_ptr<RFIDTag> RFIDTagPtr;
 
+    /// \def NoisePtr
+    /// \brief Shared pointer to Noise
+    typedef boost::shared_ptr<Noise> NoisePtr;
+
     /// \def Sensor_V
     /// \brief Vector of Sensor shared pointers
     typedef std::vector<SensorPtr> Sensor_V;
@@ -26,6 +26,7 @@
 #include <boost/lexical_cast.hpp>
 
 #include "common/Console.hh"
+#include "common/Trace.hh"
 #include "msgs/msgs.hh"
 
 #include "transport/IOManager.hh"
@@ -274,6 +275,8 @@ void Connection::EnqueueMsg(const std::string &_buffer, bool _force)
 /////////////////////////////////////////////////
 void Connection::ProcessWriteQueue(bool _blocking)
 {
+  GZ_TRACE_SCOPE("Connection::ProcessWriteQueue");
+
   if (!this->IsOpen())
   {
     return;
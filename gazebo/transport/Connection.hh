@@ -36,6 +36,7 @@
 #include "common/Event.hh"
 #include "common/Console.hh"
 #include "common/Exception.hh"
+#include "common/Trace.hh"
 
 #define HEADER_LENGTH 8
 
@@ -70,6 +71,7 @@ namespace gazebo
       /// callback.
       public: tbb::task *execute()
               {
+                GZ_TRACE_SCOPE("Connection::Read");
                 this->func(this->data);
                 return NULL;
               }
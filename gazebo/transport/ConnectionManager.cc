@@ -15,8 +15,12 @@
  *
 */
 
+#include <set>
+#include <sstream>
+
 #include "msgs/msgs.hh"
 #include "common/Events.hh"
+#include "common/Trace.hh"
 #include "transport/TopicManager.hh"
 #include "transport/ConnectionManager.hh"
 
@@ -36,6 +40,17 @@ class TopicManagerProcessTask : public tbb::task
           }
 };
 
+//////////////////////////////////////////////////
+/// \brief Get a key that identifies a publisher.
+/// \param[in] _pub The publisher.
+/// \return Topic, host and port of the publisher.
+static std::string publisherKey(const msgs::Publish &_pub)
+{
+  std::ostringstream key;
+  key << _pub.topic() << " " << _pub.host() << ":" << _pub.port();
+  return key.str();
+}
+
 //////////////////////////////////////////////////
 ConnectionManager::ConnectionManager()
 {
@@ -163,6 +178,12 @@ bool ConnectionManager::Init(const std::string &_masterHost,
   this->masterConn->AsyncRead(
       boost::bind(&ConnectionManager::OnMasterRead, this, _1));
 
+  // Ask for the publisher and namespace changes in batches. Older masters
+  // ignore the request, and keep sending one message per change.
+  msgs::Request *request = msgs::CreateRequest("enable_batch_updates");
+  this->masterConn->EnqueueMsg(msgs::Package("request", *request));
+  delete request;
+
   this->initialized = true;
 
   // Tell the user what address will be publicized to other nodes.
@@ -206,6 +227,8 @@ void ConnectionManager::Stop()
 //////////////////////////////////////////////////
 void ConnectionManager::RunUpdate()
 {
+  GZ_TRACE_SCOPE("ConnectionManager::RunUpdate");
+
   std::list<ConnectionPtr>::iterator iter;
   std::list<ConnectionPtr>::iterator endIter;
   unsigned int msize = 0;
@@ -259,6 +282,8 @@ void ConnectionManager::RunUpdate()
 //////////////////////////////////////////////////
 void ConnectionManager::Run()
 {
+  common::Trace::SetThreadName("transport");
+
   this->stopped = false;
   while (!this->stop)
   {
@@ -300,23 +325,28 @@ void ConnectionManager::ProcessMessage(const std::string &_data)
   msgs::Packet packet;
   packet.ParseFromString(_data);
 
+  // The master sends the publishers and namespaces that changed while it
+  // processed a batch of messages. Older masters send one message per
+  // change.
   if (packet.type() == "publisher_add")
   {
     msgs::Publish result;
     result.ParseFromString(packet.serialized_data());
+
+    boost::recursive_mutex::scoped_lock lock(*this->listMutex);
     this->publishers.push_back(result);
   }
   else if (packet.type() == "publisher_del")
   {
     msgs::Publish result;
     result.ParseFromString(packet.serialized_data());
+    std::string removed = publisherKey(result);
 
+    boost::recursive_mutex::scoped_lock lock(*this->listMutex);
     std::list<msgs::Publish>::iterator iter = this->publishers.begin();
     while (iter != this->publishers.end())
     {
-      if ((*iter).topic() == result.topic() &&
-          (*iter).host() == result.host() &&
-          (*iter).port() == result.port())
+      if (publisherKey(*iter) == removed)
         iter = this->publishers.erase(iter);
       else
         ++iter;
@@ -331,6 +361,44 @@ void ConnectionManager::ProcessMessage(const std::string &_data)
     this->namespaces.push_back(std::string(result.data()));
     this->namespaceCondition.notify_all();
   }
+  else if (packet.type() == "publishers_add")
+  {
+    msgs::Publishers result;
+    result.ParseFromString(packet.serialized_data());
+
+    boost::recursive_mutex::scoped_lock lock(*this->listMutex);
+    for (int i = 0; i < result.publisher_size(); ++i)
+      this->publishers.push_back(result.publisher(i));
+  }
+  else if (packet.type() == "publishers_del")
+  {
+    msgs::Publishers result;
+    result.ParseFromString(packet.serialized_data());
+
+    std::set<std::string> removed;
+    for (int i = 0; i < result.publisher_size(); ++i)
+      removed.insert(publisherKey(result.publisher(i)));
+
+    boost::recursive_mutex::scoped_lock lock(*this->listMutex);
+    std::list<msgs::Publish>::iterator iter = this->publishers.begin();
+    while (iter != this->publishers.end())
+    {
+      if (removed.find(publisherKey(*iter)) != removed.end())
+        iter = this->publishers.erase(iter);
+      else
+        ++iter;
+    }
+  }
+  else if (packet.type() == "topic_namespaces_add")
+  {
+    msgs::GzString_V result;
+    result.ParseFromString(packet.serialized_data());
+
+    boost::mutex::scoped_lock lock(this->namespaceMutex);
+    for (int i = 0; i < result.data_size(); ++i)
+      this->namespaces.push_back(result.data(i));
+    this->namespaceCondition.notify_all();
+  }
 
   // Publisher_update. This occurs when we try to subscribe to a topic, and
   // the master informs us of a remote host that is publishing on our
@@ -409,6 +477,13 @@ void ConnectionManager::OnRead(const ConnectionPtr &_connection,
     SubscriptionTransportPtr subLink(new SubscriptionTransport());
     subLink->Init(_connection, sub.latching());
 
+    // Use the shared memory ring of a subscriber on the same host
+    if (sub.has_shm_name())
+      subLink->InitShm(sub.shm_name(), sub.shm_key());
+
+    if (sub.has_max_rate())
+      subLink->SetMaxRate(sub.max_rate());
+
     // Connect the publisher to this transport mechanism
     TopicManager::Instance()->ConnectPubToSub(sub.topic(), subLink);
   }
@@ -15,6 +15,8 @@
  *
 */
 
+#include <algorithm>
+#include <set>
 #include <boost/algorithm/string.hpp>
 #include "gazebo/transport/Transport.hh"
 #include "gazebo/transport/Node.hh"
@@ -51,6 +53,8 @@ void Node::Fini()
   {
     boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
     this->callbacks.clear();
+    this->callbackLimits.clear();
+    this->topicLimits.clear();
   }
 }
 
@@ -132,7 +136,9 @@ void Node::ProcessPublishers()
 bool Node::HandleData(const std::string &_topic, const std::string &_msg)
 {
   boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-  this->incomingMsgs[_topic].push_back(_msg);
+  std::list<std::string> &msgs = this->incomingMsgs[_topic];
+  msgs.push_back(_msg);
+  this->TrimIncoming(_topic, msgs);
   return true;
 }
 
@@ -140,7 +146,9 @@ bool Node::HandleData(const std::string &_topic, const std::string &_msg)
 bool Node::HandleMessage(const std::string &_topic, MessagePtr _msg)
 {
   boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-  this->incomingMsgsLocal[_topic].push_back(_msg);
+  std::list<MessagePtr> &msgs = this->incomingMsgsLocal[_topic];
+  msgs.push_back(_msg);
+  this->TrimIncoming(_topic, msgs);
   return true;
 }
 
@@ -152,6 +160,32 @@ void Node::ProcessIncoming()
   Callback_M::iterator cbIter;
   Callback_L::iterator liter;
 
+  // Rate limited topics wait until their period has elapsed
+  std::set<std::string> delayed;
+  if (!this->topicLimits.empty())
+  {
+    common::Time now = common::Time::GetWallTime();
+    for (std::map<std::string, Limits>::iterator iter =
+         this->topicLimits.begin(); iter != this->topicLimits.end(); ++iter)
+    {
+      if (iter->second.maxRate <= 0 ||
+          (this->incomingMsgs.find(iter->first) == this->incomingMsgs.end() &&
+           this->incomingMsgsLocal.find(iter->first) ==
+           this->incomingMsgsLocal.end()))
+      {
+        continue;
+      }
+
+      if ((now - iter->second.lastDelivery).Double() <
+          1.0 / iter->second.maxRate)
+      {
+        delayed.insert(iter->first);
+      }
+      else
+        iter->second.lastDelivery = now;
+    }
+  }
+
   // For each topic
   {
     std::list<std::string>::iterator msgIter;
@@ -160,8 +194,14 @@ void Node::ProcessIncoming()
     inIter = this->incomingMsgs.begin();
     endIter = this->incomingMsgs.end();
 
-    for (; inIter != endIter; ++inIter)
+    while (inIter != endIter)
     {
+      if (delayed.find(inIter->first) != delayed.end())
+      {
+        ++inIter;
+        continue;
+      }
+
       // Find the callbacks for the topic
       cbIter = this->callbacks.find(inIter->first);
       if (cbIter != this->callbacks.end())
@@ -178,8 +218,8 @@ void Node::ProcessIncoming()
           }
         }
       }
+      this->incomingMsgs.erase(inIter++);
     }
-    this->incomingMsgs.clear();
   }
 
   {
@@ -189,8 +229,14 @@ void Node::ProcessIncoming()
     inIter = this->incomingMsgsLocal.begin();
     endIter = this->incomingMsgsLocal.end();
 
-    for (; inIter != endIter; ++inIter)
+    while (inIter != endIter)
     {
+      if (delayed.find(inIter->first) != delayed.end())
+      {
+        ++inIter;
+        continue;
+      }
+
       // Find the callbacks for the topic
       cbIter = this->callbacks.find(inIter->first);
       if (cbIter != this->callbacks.end())
@@ -207,8 +253,8 @@ void Node::ProcessIncoming()
           }
         }
       }
+      this->incomingMsgsLocal.erase(inIter++);
     }
-    this->incomingMsgsLocal.clear();
   }
 }
 
@@ -290,5 +336,87 @@ void Node::RemoveCallback(const std::string &_topic, unsigned int _id)
         break;
       }
     }
+
+    this->callbackLimits.erase(_id);
+    this->UpdateTopicLimits(_topic);
+  }
+}
+
+/////////////////////////////////////////////////
+double Node::GetMaxRate(const std::string &_topic)
+{
+  boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+
+  std::map<std::string, Limits>::iterator iter =
+    this->topicLimits.find(_topic);
+  if (iter == this->topicLimits.end())
+    return 0;
+
+  return iter->second.maxRate;
+}
+
+/////////////////////////////////////////////////
+void Node::AddLimits(const std::string &_topic, unsigned int _id,
+                     const SubscribeOptions &_options)
+{
+  if (_options.GetMaxRate() > 0 || _options.GetQueueDepth() > 0)
+  {
+    Limits &limits = this->callbackLimits[_id];
+    limits.maxRate = _options.GetMaxRate();
+    limits.queueDepth = _options.GetQueueDepth();
+  }
+
+  this->UpdateTopicLimits(_topic);
+}
+
+/////////////////////////////////////////////////
+void Node::UpdateTopicLimits(const std::string &_topic)
+{
+  Callback_M::iterator iter = this->callbacks.find(_topic);
+  if (iter == this->callbacks.end() || iter->second.empty())
+  {
+    this->topicLimits.erase(_topic);
+    return;
+  }
+
+  // Each limit only applies if every callback sets it
+  bool limitRate = true;
+  bool limitDepth = true;
+  Limits combined;
+  for (Callback_L::iterator liter = iter->second.begin();
+       liter != iter->second.end(); ++liter)
+  {
+    std::map<unsigned int, Limits>::iterator limits =
+      this->callbackLimits.find((*liter)->GetId());
+    if (limits == this->callbackLimits.end())
+    {
+      limitRate = limitDepth = false;
+      break;
+    }
+
+    if (limits->second.maxRate <= 0)
+      limitRate = false;
+    if (limits->second.queueDepth == 0)
+      limitDepth = false;
+
+    combined.maxRate = std::max(combined.maxRate, limits->second.maxRate);
+    combined.queueDepth = std::max(combined.queueDepth,
+                                   limits->second.queueDepth);
   }
+
+  if (!limitRate)
+    combined.maxRate = 0;
+  if (!limitDepth)
+    combined.queueDepth = 0;
+
+  if (combined.maxRate <= 0 && combined.queueDepth == 0)
+  {
+    this->topicLimits.erase(_topic);
+    return;
+  }
+
+  // Keep the time of the last delivery
+  Limits &limits = this->topicLimits[_topic];
+  limits.maxRate = combined.maxRate;
+  limits.queueDepth = combined.queueDepth;
 }
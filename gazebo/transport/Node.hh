@@ -25,6 +25,7 @@
 #include <string>
 #include <vector>
 
+#include "common/Time.hh"
 #include "transport/TransportTypes.hh"
 #include "transport/TopicManager.hh"
 
@@ -175,13 +176,35 @@ namespace gazebo
           bool _latching = false)
       {
         SubscribeOptions ops;
+        ops.SetLatching(_latching);
+        return this->Subscribe(_topic, _fp, _obj, ops);
+      }
+
+      /// \brief Subscribe to a topic using a class method as the callback,
+      /// with delivery limits.
+      /// \param[in] _topic The topic to subscribe to
+      /// \param[in] _fp Class method to be called on receipt of new message
+      /// \param[in] _obj Class instance to be used on receipt of new message
+      /// \param[in] _options Latching and delivery limits. The topic, node
+      /// and message type of the options are ignored.
+      /// \return Pointer to new Subscriber object
+      public: template<typename M, typename T>
+      SubscriberPtr Subscribe(const std::string &_topic,
+          void(T::*_fp)(const boost::shared_ptr<M const> &), T *_obj,
+          const SubscribeOptions &_options)
+      {
+        SubscribeOptions ops = _options;
         std::string decodedTopic = this->DecodeTopicName(_topic);
-        ops.template Init<M>(decodedTopic, shared_from_this(), _latching);
+        ops.template Init<M>(decodedTopic, shared_from_this(),
+                             _options.GetLatching());
 
         {
           boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
           this->callbacks[decodedTopic].push_back(CallbackHelperPtr(
-                new CallbackHelperT<M>(boost::bind(_fp, _obj, _1), _latching)));
+                new CallbackHelperT<M>(boost::bind(_fp, _obj, _1),
+                                       _options.GetLatching())));
+          this->AddLimits(decodedTopic,
+              this->callbacks[decodedTopic].back()->GetId(), ops);
         }
 
         SubscriberPtr result =
@@ -234,13 +257,33 @@ namespace gazebo
           bool _latching = false)
       {
         SubscribeOptions ops;
+        ops.SetLatching(_latching);
+        return this->Subscribe(_topic, _fp, _obj, ops);
+      }
+
+      /// \brief Subscribe to a topic using a class method as the callback,
+      /// with delivery limits.
+      /// \param[in] _topic The topic to subscribe to
+      /// \param[in] _fp Class method to be called on receipt of new message
+      /// \param[in] _obj Class instance to be used on receipt of new message
+      /// \param[in] _options Latching and delivery limits. The topic, node
+      /// and message type of the options are ignored.
+      /// \return Pointer to new Subscriber object
+      template<typename T>
+      SubscriberPtr Subscribe(const std::string &_topic,
+          void(T::*_fp)(const std::string &), T *_obj,
+          const SubscribeOptions &_options)
+      {
+        SubscribeOptions ops = _options;
         std::string decodedTopic = this->DecodeTopicName(_topic);
-        ops.Init(decodedTopic, shared_from_this(), _latching);
+        ops.Init(decodedTopic, shared_from_this(), _options.GetLatching());
 
         {
           boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
           this->callbacks[decodedTopic].push_back(CallbackHelperPtr(
                 new RawCallbackHelper(boost::bind(_fp, _obj, _1))));
+          this->AddLimits(decodedTopic,
+              this->callbacks[decodedTopic].back()->GetId(), ops);
         }
 
         SubscriberPtr result =
@@ -322,6 +365,44 @@ namespace gazebo
       /// \param[in] _id Id of the callback.
       public: void RemoveCallback(const std::string &_topic, unsigned int _id);
 
+      /// \brief Get the maximum rate at which the callbacks of a topic
+      /// need messages.
+      /// \param[in] _topic Name of the topic.
+      /// \return Messages per second, 0 if a callback has no limit.
+      public: double GetMaxRate(const std::string &_topic);
+
+      /// \brief Store the delivery limits of a callback. The incomingMutex
+      /// must be locked.
+      /// \param[in] _topic Name of the topic.
+      /// \param[in] _id Id of the callback.
+      /// \param[in] _options Options with the limits.
+      private: void AddLimits(const std::string &_topic, unsigned int _id,
+                              const SubscribeOptions &_options);
+
+      /// \brief Combine the limits of the callbacks of a topic. A topic is
+      /// only limited if all of its callbacks are.
+      /// \param[in] _topic Name of the topic.
+      private: void UpdateTopicLimits(const std::string &_topic);
+
+      /// \brief Drop the oldest waiting messages of a topic beyond its
+      /// queue depth.
+      /// \param[in] _topic Name of the topic.
+      /// \param[in,out] _msgs Waiting messages.
+      private: template<typename T>
+               void TrimIncoming(const std::string &_topic, std::list<T> &_msgs)
+               {
+                 std::map<std::string, Limits>::iterator iter =
+                   this->topicLimits.find(_topic);
+                 if (iter == this->topicLimits.end())
+                   return;
+
+                 // A rate limited topic only delivers its newest message
+                 unsigned int depth = iter->second.maxRate > 0 ? 1 :
+                   iter->second.queueDepth;
+                 while (depth > 0 && _msgs.size() > depth)
+                   _msgs.pop_front();
+               }
+
       private: std::string topicNamespace;
       private: std::vector<PublisherPtr> publishers;
       private: std::vector<PublisherPtr>::iterator publishersIter;
@@ -337,6 +418,30 @@ namespace gazebo
       /// \brief List of newly arrive messages
       private: std::map<std::string, std::list<MessagePtr> > incomingMsgsLocal;
 
+      /// \brief Delivery limits.
+      private: class Limits
+               {
+                 /// \brief Constructor
+                 public: Limits() : maxRate(0), queueDepth(0) {}
+
+                 /// \brief Maximum delivery rate, 0 for no limit.
+                 public: double maxRate;
+
+                 /// \brief Maximum number of waiting messages, 0 for no
+                 /// limit.
+                 public: unsigned int queueDepth;
+
+                 /// \brief Time of the last delivery.
+                 public: common::Time lastDelivery;
+               };
+
+      /// \brief Limits of the callbacks that have any, indexed by callback
+      /// id.
+      private: std::map<unsigned int, Limits> callbackLimits;
+
+      /// \brief Combined limits of the topics that are limited.
+      private: std::map<std::string, Limits> topicLimits;
+
       private: boost::recursive_mutex publisherMutex;
       private: boost::recursive_mutex incomingMutex;
 
@@ -155,6 +155,24 @@ void Publication::RemoveTransport(const std::string &host_, unsigned int port_)
   }
 }
 
+//////////////////////////////////////////////////
+void Publication::RemoveThrottledTransports(double _maxRate)
+{
+  std::list<PublicationTransportPtr>::iterator iter;
+  iter = this->transports.begin();
+  while (iter != this->transports.end())
+  {
+    double rate = (*iter)->GetMaxRate();
+    if (rate > 0 && (_maxRate <= 0 || _maxRate > rate))
+    {
+      (*iter)->Fini();
+      this->transports.erase(iter++);
+    }
+    else
+      ++iter;
+  }
+}
+
 //////////////////////////////////////////////////
 void Publication::RemoveSubscription(const NodePtr &_node)
 {
@@ -78,6 +78,12 @@ namespace gazebo
       public: void RemoveTransport(const std::string &_host, unsigned
                                    int _port);
 
+      /// \brief Remove the transports that receive messages at a lower
+      /// rate than now needed, so they are connected again.
+      /// \param[in] _maxRate Rate in Hz needed by the local subscribers,
+      /// 0 for every message.
+      public: void RemoveThrottledTransports(double _maxRate);
+
       /// \brief Get the number of transports
       /// \return The number of transports
       public: unsigned int GetTransportCount() const;
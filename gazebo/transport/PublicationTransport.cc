@@ -15,6 +15,12 @@
  *
 */
 
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <sstream>
+
+#include "common/Trace.hh"
 #include "transport/TopicManager.hh"
 #include "transport/ConnectionManager.hh"
 #include "transport/PublicationTransport.hh"
@@ -24,10 +30,32 @@ using namespace transport;
 
 int PublicationTransport::counter = 0;
 
+/// \brief Size of the shared memory rings. Larger messages are sent
+/// over the connection.
+static const uint32_t ShmRingCapacity = 8 * 1024 * 1024;
+
+//////////////////////////////////////////////////
+/// \brief Check whether messages of a type should use shared memory.
+/// Rings are only worth their memory for large messages. Set the
+/// GAZEBO_SHM_TRANSPORT environment variable to 0 to disable them.
+/// \param[in] _msgType Message type of a topic.
+/// \return True to use a shared memory ring.
+static bool useShm(const std::string &_msgType)
+{
+  const char *env = getenv("GAZEBO_SHM_TRANSPORT");
+  if (env && std::string(env) == "0")
+    return false;
+
+  return _msgType == "gazebo.msgs.ImageStamped" ||
+         _msgType == "gazebo.msgs.ImagesStamped" ||
+         _msgType == "gazebo.msgs.LaserScanStamped";
+}
+
 /////////////////////////////////////////////////
 PublicationTransport::PublicationTransport(const std::string &_topic,
                                            const std::string &_msgType)
-: topic(_topic), msgType(_msgType)
+: topic(_topic), msgType(_msgType), shmRing(NULL), shmThread(NULL),
+  shmStop(false), maxRate(0)
 {
   this->id = counter++;
   TopicManager::Instance()->UpdatePublications(this->topic, this->msgType);
@@ -36,6 +64,8 @@ PublicationTransport::PublicationTransport(const std::string &_topic,
 /////////////////////////////////////////////////
 PublicationTransport::~PublicationTransport()
 {
+  this->FiniShm();
+
   if (this->connection)
   {
     this->connection->DisconnectShutdown(this->shutdownConnectionPtr);
@@ -55,15 +85,25 @@ PublicationTransport::~PublicationTransport()
 }
 
 /////////////////////////////////////////////////
-void PublicationTransport::Init(const ConnectionPtr &_conn, bool _latched)
+void PublicationTransport::Init(const ConnectionPtr &_conn, bool _latched,
+                                double _maxRate)
 {
   this->connection = _conn;
+  this->maxRate = _maxRate;
   msgs::Subscribe sub;
   sub.set_topic(this->topic);
   sub.set_msg_type(this->msgType);
   sub.set_host(this->connection->GetLocalAddress());
   sub.set_port(this->connection->GetLocalPort());
   sub.set_latching(_latched);
+  if (this->maxRate > 0)
+    sub.set_max_rate(this->maxRate);
+
+  if (this->InitShm())
+  {
+    sub.set_shm_name(this->shmRing->GetName());
+    sub.set_shm_key(this->shmRing->GetKey());
+  }
 
   this->connection->EnqueueMsg(msgs::Package("sub", sub));
 
@@ -76,6 +116,84 @@ void PublicationTransport::Init(const ConnectionPtr &_conn, bool _latched)
       boost::bind(&PublicationTransport::OnConnectionShutdown, this));
 }
 
+/////////////////////////////////////////////////
+bool PublicationTransport::InitShm()
+{
+  if (!useShm(this->msgType))
+    return false;
+
+  // Only a publisher on the same host can open the ring
+  std::string remote = this->connection->GetRemoteAddress();
+  if (remote.find("127.") != 0 &&
+      remote != this->connection->GetLocalAddress())
+  {
+    return false;
+  }
+
+  std::ostringstream name;
+  name << "/gazebo_" << getpid() << "_" << this->id;
+
+  this->shmRing = new ShmRing();
+  if (!this->shmRing->Create(name.str(), ShmRingCapacity))
+  {
+    delete this->shmRing;
+    this->shmRing = NULL;
+    return false;
+  }
+
+  this->shmStop = false;
+  this->shmThread = new boost::thread(
+      boost::bind(&PublicationTransport::RunShm, this));
+  return true;
+}
+
+/////////////////////////////////////////////////
+void PublicationTransport::RunShm()
+{
+  common::Trace::SetThreadName("shm " + this->topic);
+
+  while (!this->shmStop)
+  {
+    {
+      boost::mutex::scoped_lock lock(this->shmMutex);
+      this->ReadShm();
+    }
+
+    this->shmRing->Wait(100);
+  }
+}
+
+/////////////////////////////////////////////////
+void PublicationTransport::ReadShm()
+{
+  if (!this->shmRing)
+    return;
+
+  std::string data;
+  while (!this->shmStop && this->shmRing->Read(data))
+  {
+    if (this->callback && !data.empty())
+      (this->callback)(data);
+  }
+}
+
+/////////////////////////////////////////////////
+void PublicationTransport::FiniShm()
+{
+  if (this->shmThread)
+  {
+    this->shmStop = true;
+    this->shmRing->Notify();
+    this->shmThread->join();
+    delete this->shmThread;
+    this->shmThread = NULL;
+  }
+
+  boost::mutex::scoped_lock lock(this->shmMutex);
+  delete this->shmRing;
+  this->shmRing = NULL;
+}
+
 /////////////////////////////////////////////////
 void PublicationTransport::OnConnectionShutdown()
 {
@@ -98,6 +216,11 @@ void PublicationTransport::OnPublish(const std::string &_data)
 
     if (!_data.empty())
     {
+      // The advertiser switches to the connection for good when a message
+      // doesn't fit in the ring, without waiting for the ring to drain.
+      // Messages it wrote to the ring before are passed on first.
+      boost::mutex::scoped_lock lock(this->shmMutex);
+      this->ReadShm();
       if (this->callback)
         (this->callback)(_data);
     }
@@ -122,9 +245,17 @@ std::string PublicationTransport::GetMsgType() const
   return this->msgType;
 }
 
+/////////////////////////////////////////////////
+double PublicationTransport::GetMaxRate() const
+{
+  return this->maxRate;
+}
+
 /////////////////////////////////////////////////
 void PublicationTransport::Fini()
 {
+  this->FiniShm();
+
   /// Cancel all async operatiopns.
   if (this->connection)
   {
@@ -19,9 +19,11 @@
 #define _PUBLICATIONTRANSPORT_HH_
 
 #include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
 #include <string>
 
 #include "transport/Connection.hh"
+#include "transport/ShmRing.hh"
 #include "common/Event.hh"
 
 namespace gazebo
@@ -35,6 +37,12 @@ namespace gazebo
     /// transport/transport.hh
     /// \brief Reads data from a remote advertiser, and passes the data
     /// along to local subscribers
+    ///
+    /// When the advertiser runs on the same host, large messages are
+    /// received through a shared memory ring instead of the connection.
+    /// The ring is offered to the advertiser when subscribing, and
+    /// messages keep arriving on the connection if the advertiser can't
+    /// open it.
     class PublicationTransport
     {
       /// \brief Constructor
@@ -50,7 +58,10 @@ namespace gazebo
       /// \param[in] _conn The underlying connection.
       /// \param[in] _latched True to grab the last message sent on the
       /// topic.
-      public: void Init(const ConnectionPtr &_conn, bool _latched);
+      /// \param[in] _maxRate Maximum rate in Hz to receive messages at,
+      /// 0 for every message.
+      public: void Init(const ConnectionPtr &_conn, bool _latched,
+                        double _maxRate = 0);
 
       /// \brief Finalize the transport
       public: void Fini();
@@ -72,6 +83,10 @@ namespace gazebo
       /// \return The topic type
       public: std::string GetMsgType() const;
 
+      /// \brief Get the rate requested from the remote advertiser.
+      /// \return Maximum rate in Hz, 0 if every message is received.
+      public: double GetMaxRate() const;
+
       /// \brief Called when connection is shutdown.
       private: void OnConnectionShutdown();
 
@@ -79,6 +94,21 @@ namespace gazebo
       /// \param[in] _data Data to be published.
       private: void OnPublish(const std::string &_data);
 
+      /// \brief Create the shared memory ring, if the messages of the topic
+      /// are large and the connection is to the same host.
+      /// \return True if the ring was created.
+      private: bool InitShm();
+
+      /// \brief Read messages from the shared memory ring until stopped.
+      private: void RunShm();
+
+      /// \brief Pass the messages waiting in the shared memory ring to the
+      /// callback. The shmMutex must be locked.
+      private: void ReadShm();
+
+      /// \brief Stop reading the shared memory ring and remove it.
+      private: void FiniShm();
+
       /// \brief The topic for this publication transport.
       private: std::string topic;
 
@@ -99,6 +129,22 @@ namespace gazebo
 
       /// \brief The unique id for the publication transport.
       private: int id;
+
+      /// \brief Ring that the advertiser may write to, NULL if not used.
+      private: ShmRing *shmRing;
+
+      /// \brief Thread that reads the shared memory ring.
+      private: boost::thread *shmThread;
+
+      /// \brief True to stop the shared memory thread.
+      private: bool shmStop;
+
+      /// \brief Serializes the messages read from the ring and from the
+      /// connection, so that they are passed on in order.
+      private: boost::mutex shmMutex;
+
+      /// \brief Maximum rate in Hz requested from the advertiser.
+      private: double maxRate;
     };
     /// \}
   }
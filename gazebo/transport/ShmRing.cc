@@ -0,0 +1,391 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <errno.h>
+#include <fcntl.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/transport/ShmRing.hh"
+
+using namespace gazebo;
+using namespace transport;
+
+/// \brief Marks an initialized ring.
+static const uint32_t ShmRingMagic = 0x475a5352;
+
+/// \brief Size of a record that tells the reader to go back to the start
+/// of the storage.
+static const uint32_t ShmRingWrap = 0xffffffff;
+
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \brief Layout of the start of a shared memory ring. The head and
+    /// the tail are on separate cache lines, since they are written by
+    /// different processes.
+    struct ShmRingHeader
+    {
+      /// \brief ShmRingMagic once the ring is initialized.
+      volatile uint32_t magic;
+
+      /// \brief Size of the message storage in bytes.
+      uint32_t capacity;
+
+      /// \brief Random key of the ring.
+      uint64_t key;
+
+      /// \brief Posted when messages are written.
+      sem_t dataReady;
+
+      /// \brief Number of bytes ever written. Only the writer modifies it.
+      volatile uint64_t head __attribute__((aligned(64)));
+
+      /// \brief Number of bytes ever read. Only the reader modifies it.
+      volatile uint64_t tail __attribute__((aligned(64)));
+    } __attribute__((aligned(64)));
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the space used by a record.
+/// \param[in] _size Size of the message.
+/// \return Size of the record, a multiple of 8.
+static uint64_t recordSize(uint32_t _size)
+{
+  return (sizeof(uint32_t) + static_cast<uint64_t>(_size) + 7) & ~7ull;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get a random ring key.
+/// \return A non zero key.
+static uint64_t randomKey()
+{
+  uint64_t key = 0;
+
+  FILE *urandom = fopen("/dev/urandom", "rb");
+  if (urandom)
+  {
+    if (fread(&key, sizeof(key), 1, urandom) != 1)
+      key = 0;
+    fclose(urandom);
+  }
+
+  if (key == 0)
+  {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    key = (static_cast<uint64_t>(ts.tv_sec) << 32) ^ ts.tv_nsec ^
+      (static_cast<uint64_t>(getpid()) << 16) ^ 1;
+  }
+
+  return key;
+}
+
+//////////////////////////////////////////////////
+ShmRing::ShmRing()
+  : header(NULL), data(NULL), mappedSize(0), owner(false), pendingHead(0)
+{
+}
+
+//////////////////////////////////////////////////
+ShmRing::~ShmRing()
+{
+  this->Close();
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::Create(const std::string &_name, uint32_t _capacity)
+{
+  this->Close();
+
+  if (_capacity < 64 || (_capacity & (_capacity - 1)) != 0)
+  {
+    gzerr << "Shared memory ring capacity[" << _capacity
+          << "] must be a power of two of at least 64\n";
+    return false;
+  }
+
+  int fd = shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0)
+  {
+    gzwarn << "Unable to create shared memory[" << _name << "]: "
+           << strerror(errno) << "\n";
+    return false;
+  }
+
+  size_t size = sizeof(ShmRingHeader) + _capacity;
+  void *addr = MAP_FAILED;
+  if (ftruncate(fd, size) == 0)
+    addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (addr == MAP_FAILED)
+  {
+    gzwarn << "Unable to map shared memory[" << _name << "]: "
+           << strerror(errno) << "\n";
+    shm_unlink(_name.c_str());
+    return false;
+  }
+
+  this->name = _name;
+  this->header = static_cast<ShmRingHeader*>(addr);
+  this->data = static_cast<char*>(addr) + sizeof(ShmRingHeader);
+  this->mappedSize = size;
+  this->owner = true;
+
+  this->header->capacity = _capacity;
+  this->header->key = randomKey();
+  this->header->head = 0;
+  this->header->tail = 0;
+  sem_init(&this->header->dataReady, 1, 0);
+
+  // A writer can only use the ring once everything above is visible
+  __sync_synchronize();
+  this->header->magic = ShmRingMagic;
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::Open(const std::string &_name, uint64_t _key)
+{
+  this->Close();
+
+  int fd = shm_open(_name.c_str(), O_RDWR, 0);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  void *addr = MAP_FAILED;
+  if (fstat(fd, &st) == 0 &&
+      static_cast<size_t>(st.st_size) > sizeof(ShmRingHeader))
+  {
+    addr = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+
+  if (addr == MAP_FAILED)
+    return false;
+
+  this->name = _name;
+  this->header = static_cast<ShmRingHeader*>(addr);
+  this->data = static_cast<char*>(addr) + sizeof(ShmRingHeader);
+  this->mappedSize = st.st_size;
+  this->owner = false;
+
+  bool valid = this->header->magic == ShmRingMagic;
+  __sync_synchronize();
+  valid = valid && this->header->key == _key &&
+    sizeof(ShmRingHeader) + this->header->capacity == this->mappedSize;
+
+  if (!valid)
+  {
+    this->Close();
+    return false;
+  }
+
+  this->pendingHead = this->header->head;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void ShmRing::Close()
+{
+  if (!this->header)
+    return;
+
+  if (this->owner)
+    sem_destroy(&this->header->dataReady);
+
+  munmap(this->header, this->mappedSize);
+
+  if (this->owner)
+    shm_unlink(this->name.c_str());
+
+  this->header = NULL;
+  this->data = NULL;
+  this->mappedSize = 0;
+  this->owner = false;
+}
+
+//////////////////////////////////////////////////
+std::string ShmRing::GetName() const
+{
+  return this->name;
+}
+
+//////////////////////////////////////////////////
+uint64_t ShmRing::GetKey() const
+{
+  return this->header ? this->header->key : 0;
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::Fits(uint32_t _size) const
+{
+  return this->header && recordSize(_size) <= this->header->capacity;
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::IsEmpty() const
+{
+  return !this->header || this->header->tail == this->header->head;
+}
+
+//////////////////////////////////////////////////
+char *ShmRing::BeginWrite(uint32_t _size)
+{
+  if (!this->header)
+    return NULL;
+
+  uint64_t capacity = this->header->capacity;
+  uint64_t need = recordSize(_size);
+  if (need > capacity)
+    return NULL;
+
+  uint64_t head = this->header->head;
+  uint64_t tail = this->header->tail;
+
+  // Records are contiguous, so skip the end of the storage if the
+  // record doesn't fit there.
+  uint64_t offset = head & (capacity - 1);
+  uint64_t skip = offset + need > capacity ? capacity - offset : 0;
+  if (capacity - (head - tail) < skip + need)
+    return NULL;
+
+  // Don't write before the reader is done with the space
+  __sync_synchronize();
+
+  if (skip > 0)
+  {
+    *reinterpret_cast<uint32_t*>(this->data + offset) = ShmRingWrap;
+    head += skip;
+    offset = 0;
+  }
+
+  *reinterpret_cast<uint32_t*>(this->data + offset) = _size;
+  this->pendingHead = head + need;
+
+  return this->data + offset + sizeof(uint32_t);
+}
+
+//////////////////////////////////////////////////
+void ShmRing::EndWrite()
+{
+  if (!this->header)
+    return;
+
+  // Make the message visible before it is counted
+  __sync_synchronize();
+  this->header->head = this->pendingHead;
+
+  // The reader drains the whole ring when it wakes up, so one pending
+  // post is enough.
+  int value = 0;
+  sem_getvalue(&this->header->dataReady, &value);
+  if (value <= 0)
+    sem_post(&this->header->dataReady);
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::Write(const std::string &_data)
+{
+  char *dest = this->BeginWrite(_data.size());
+  if (!dest)
+    return false;
+
+  memcpy(dest, _data.data(), _data.size());
+  this->EndWrite();
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::Read(std::string &_data)
+{
+  if (!this->header)
+    return false;
+
+  uint64_t capacity = this->header->capacity;
+  uint64_t head = this->header->head;
+  __sync_synchronize();
+  uint64_t tail = this->header->tail;
+
+  bool result = false;
+  while (tail != head)
+  {
+    uint64_t offset = tail & (capacity - 1);
+    uint32_t size = *reinterpret_cast<uint32_t*>(this->data + offset);
+
+    if (size == ShmRingWrap)
+    {
+      tail += capacity - offset;
+      continue;
+    }
+
+    // Drop everything if the writer wrote garbage
+    if (offset + recordSize(size) > capacity)
+    {
+      gzerr << "Corrupt shared memory ring[" << this->name << "]\n";
+      tail = head;
+      break;
+    }
+
+    _data.assign(this->data + offset + sizeof(uint32_t), size);
+    tail += recordSize(size);
+    result = true;
+    break;
+  }
+
+  // Release the space only once the message is copied
+  __sync_synchronize();
+  this->header->tail = tail;
+
+  return result;
+}
+
+//////////////////////////////////////////////////
+void ShmRing::Wait(unsigned int _timeout)
+{
+  if (!this->header)
+    return;
+
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  ts.tv_sec += _timeout / 1000;
+  ts.tv_nsec += (_timeout % 1000) * 1000000l;
+  if (ts.tv_nsec >= 1000000000l)
+  {
+    ts.tv_sec++;
+    ts.tv_nsec -= 1000000000l;
+  }
+
+  sem_timedwait(&this->header->dataReady, &ts);
+}
+
+//////////////////////////////////////////////////
+void ShmRing::Notify()
+{
+  if (this->header)
+    sem_post(&this->header->dataReady);
+}
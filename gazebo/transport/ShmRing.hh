@@ -0,0 +1,134 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _SHMRING_HH_
+#define _SHMRING_HH_
+
+#include <stdint.h>
+#include <string>
+
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    /// \brief Layout of the start of a shared memory ring.
+    struct ShmRingHeader;
+
+    /// \class ShmRing ShmRing.hh transport/transport.hh
+    /// \brief Ring buffer of messages in POSIX shared memory, with one
+    /// writer process and one reader process.
+    ///
+    /// The reader creates the ring and removes it when it is destroyed.
+    /// The writer opens it by name, and must give the key of the ring,
+    /// so a ring with the same name on another host is never used by
+    /// mistake. Writing and reading take no lock. The reader sleeps on a
+    /// process shared semaphore while the ring is empty.
+    class ShmRing
+    {
+      /// \brief Constructor
+      public: ShmRing();
+
+      /// \brief Destructor. Unmaps the ring, and removes it if it was
+      /// created by this object.
+      public: virtual ~ShmRing();
+
+      /// \brief Create a ring, to read from it.
+      /// \param[in] _name Name of the shared memory object, starting with
+      /// '/'.
+      /// \param[in] _capacity Size of the message storage in bytes, a
+      /// power of two.
+      /// \return True on success.
+      public: bool Create(const std::string &_name, uint32_t _capacity);
+
+      /// \brief Open a ring created by another process, to write to it.
+      /// \param[in] _name Name of the shared memory object.
+      /// \param[in] _key Key of the ring, see GetKey.
+      /// \return True if the ring exists and has the key.
+      public: bool Open(const std::string &_name, uint64_t _key);
+
+      /// \brief Get the name of the shared memory object.
+      /// \return Name given to Create or Open.
+      public: std::string GetName() const;
+
+      /// \brief Get the random key chosen when the ring was created.
+      /// \return Key of the ring, 0 if the ring isn't mapped.
+      public: uint64_t GetKey() const;
+
+      /// \brief Check whether a message fits in the ring when it is
+      /// empty.
+      /// \param[in] _size Size of the message in bytes.
+      /// \return False if the message is too large for the ring.
+      public: bool Fits(uint32_t _size) const;
+
+      /// \brief Check whether the reader has read every message.
+      /// \return True if the ring is empty, or isn't mapped.
+      public: bool IsEmpty() const;
+
+      /// \brief Reserve space for a message. The message is visible to
+      /// the reader after EndWrite.
+      /// \param[in] _size Size of the message in bytes.
+      /// \return Where to write the message, NULL if it doesn't fit.
+      public: char *BeginWrite(uint32_t _size);
+
+      /// \brief Publish the message reserved by the last BeginWrite, and
+      /// wake the reader.
+      public: void EndWrite();
+
+      /// \brief Write a message.
+      /// \param[in] _data The message.
+      /// \return False if the message doesn't fit.
+      public: bool Write(const std::string &_data);
+
+      /// \brief Read the oldest message, without waiting.
+      /// \param[out] _data The message.
+      /// \return False if the ring is empty.
+      public: bool Read(std::string &_data);
+
+      /// \brief Wait until a message may be available.
+      /// \param[in] _timeout Maximum time to wait in milliseconds.
+      public: void Wait(unsigned int _timeout);
+
+      /// \brief Wake the reader from Wait.
+      public: void Notify();
+
+      /// \brief Unmap the ring.
+      private: void Close();
+
+      /// \brief Name of the shared memory object.
+      private: std::string name;
+
+      /// \brief Mapped ring, NULL if not mapped.
+      private: ShmRingHeader *header;
+
+      /// \brief Start of the message storage.
+      private: char *data;
+
+      /// \brief Size of the mapping in bytes.
+      private: size_t mappedSize;
+
+      /// \brief True if this object created the ring.
+      private: bool owner;
+
+      /// \brief Write position after the message being written.
+      private: uint64_t pendingHead;
+    };
+    /// \}
+  }
+}
+#endif
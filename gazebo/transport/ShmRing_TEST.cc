@@ -0,0 +1,140 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <sstream>
+#include <boost/thread.hpp>
+
+#include "gazebo/transport/ShmRing.hh"
+
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+/// \brief Get a shared memory name unique to the test process
+static std::string ringName(const std::string &_suffix)
+{
+  std::ostringstream name;
+  name << "/gazebo_test_" << getpid() << "_" << _suffix;
+  return name.str();
+}
+
+/////////////////////////////////////////////////
+TEST(ShmRingTest, OpenRequiresKey)
+{
+  transport::ShmRing reader, writer;
+  EXPECT_FALSE(reader.Create(ringName("bad"), 100));
+  ASSERT_TRUE(reader.Create(ringName("key"), 1024));
+  EXPECT_NE(0u, reader.GetKey());
+
+  EXPECT_FALSE(writer.Open(ringName("key"), reader.GetKey() + 1));
+  EXPECT_FALSE(writer.Open(ringName("missing"), reader.GetKey()));
+  EXPECT_TRUE(writer.Open(ringName("key"), reader.GetKey()));
+
+  // Names are exclusive
+  transport::ShmRing other;
+  EXPECT_FALSE(other.Create(ringName("key"), 1024));
+}
+
+/////////////////////////////////////////////////
+TEST(ShmRingTest, WrapAround)
+{
+  transport::ShmRing reader, writer;
+  ASSERT_TRUE(reader.Create(ringName("wrap"), 256));
+  ASSERT_TRUE(writer.Open(ringName("wrap"), reader.GetKey()));
+
+  std::string data;
+  EXPECT_FALSE(reader.Read(data));
+
+  // Too large for the ring
+  EXPECT_FALSE(writer.Fits(300));
+  EXPECT_TRUE(writer.Fits(200));
+  EXPECT_FALSE(writer.Write(std::string(300, 'x')));
+
+  // Messages of varying sizes cross the end of the storage many times
+  for (int i = 0; i < 100; ++i)
+  {
+    std::string msg(i % 90, static_cast<char>('a' + i % 26));
+    ASSERT_TRUE(writer.Write(msg));
+    EXPECT_FALSE(writer.IsEmpty());
+    ASSERT_TRUE(reader.Read(data));
+    EXPECT_EQ(msg, data);
+    EXPECT_TRUE(writer.IsEmpty());
+  }
+  EXPECT_FALSE(reader.Read(data));
+
+  // The writer fails when the ring is full
+  int count = 0;
+  while (writer.Write(std::string(20, 'f')))
+    ++count;
+  EXPECT_GT(count, 5);
+  EXPECT_LT(count, 11);
+
+  ASSERT_TRUE(reader.Read(data));
+  EXPECT_TRUE(writer.Write(std::string(20, 'g')));
+}
+
+/////////////////////////////////////////////////
+/// \brief Write numbered messages, retrying while the ring is full
+static void writeNumbers(transport::ShmRing *_ring, int _count)
+{
+  for (int i = 0; i < _count; ++i)
+  {
+    std::ostringstream msg;
+    msg << i << std::string(i % 50, ' ');
+    while (!_ring->Write(msg.str()))
+      boost::this_thread::yield();
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(ShmRingTest, Threads)
+{
+  transport::ShmRing reader, writer;
+  ASSERT_TRUE(reader.Create(ringName("threads"), 4096));
+  ASSERT_TRUE(writer.Open(ringName("threads"), reader.GetKey()));
+
+  const int count = 20000;
+  boost::thread thread(boost::bind(&writeNumbers, &writer, count));
+
+  std::string data;
+  for (int i = 0; i < count;)
+  {
+    if (!reader.Read(data))
+    {
+      reader.Wait(100);
+      continue;
+    }
+
+    int value = -1;
+    std::istringstream(data) >> value;
+    ASSERT_EQ(i, value);
+    EXPECT_EQ(i % 50 + 1 + (i > 9) + (i > 99) + (i > 999) + (i > 9999),
+              static_cast<int>(data.size()));
+    ++i;
+  }
+
+  thread.join();
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -31,11 +31,15 @@ namespace gazebo
 
     /// \class SubscribeOptions SubscribeOptions.hh transport/transport.hh
     /// \brief Options for a subscription
+    ///
+    /// Besides latching, a subscription can limit how messages are
+    /// delivered to its callback. Limits are applied to the serialized
+    /// messages, so dropped messages are never parsed.
     class SubscribeOptions
     {
       /// \brief Constructor
       public: SubscribeOptions()
-              : latching(false)
+              : latching(false), maxRate(0), queueDepth(0)
               {}
 
       /// \brief Initialize the options
@@ -102,10 +106,71 @@ namespace gazebo
                 return this->latching;
               }
 
+      /// \brief Set whether to latch the latest message.
+      /// \param[in] _latching True to latch the latest message.
+      public: void SetLatching(bool _latching)
+              {
+                this->latching = _latching;
+              }
+
+      /// \brief Limit the rate at which messages are delivered. Only the
+      /// newest message is kept between two deliveries. Remote publishers
+      /// skip the messages that would arrive too early, like
+      /// Publisher's own rate limit.
+      /// \param[in] _hz Maximum number of messages per second, 0 for no
+      /// limit.
+      public: void SetMaxRate(double _hz)
+              {
+                this->maxRate = _hz > 0 ? _hz : 0;
+              }
+
+      /// \brief Get the maximum delivery rate.
+      /// \return Maximum number of messages per second, 0 for no limit.
+      public: double GetMaxRate() const
+              {
+                return this->maxRate;
+              }
+
+      /// \brief Limit the number of messages waiting to be delivered. The
+      /// oldest messages are dropped.
+      /// \param[in] _depth Maximum number of messages, 0 for no limit.
+      public: void SetQueueDepth(unsigned int _depth)
+              {
+                this->queueDepth = _depth;
+              }
+
+      /// \brief Get the maximum number of waiting messages.
+      /// \return Maximum number of messages, 0 for no limit.
+      public: unsigned int GetQueueDepth() const
+              {
+                return this->queueDepth;
+              }
+
+      /// \brief Only deliver the newest message. Same as a queue depth of
+      /// one.
+      /// \param[in] _keepLatest True to only keep the newest message.
+      public: void SetKeepLatest(bool _keepLatest)
+              {
+                this->queueDepth = _keepLatest ? 1 : 0;
+              }
+
+      /// \brief Get whether only the newest message is delivered.
+      /// \return True if the queue depth is one.
+      public: bool GetKeepLatest() const
+              {
+                return this->queueDepth == 1;
+              }
+
       private: std::string topic;
       private: std::string msgType;
       private: NodePtr node;
       private: bool latching;
+
+      /// \brief Maximum delivery rate, 0 for no limit.
+      private: double maxRate;
+
+      /// \brief Maximum number of waiting messages, 0 for no limit.
+      private: unsigned int queueDepth;
     };
     /// \}
   }
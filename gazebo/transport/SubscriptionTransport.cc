@@ -14,6 +14,9 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+
+#include "common/Console.hh"
 #include "transport/ConnectionManager.hh"
 #include "transport/SubscriptionTransport.hh"
 
@@ -22,6 +25,7 @@ using namespace transport;
 
 //////////////////////////////////////////////////
 SubscriptionTransport::SubscriptionTransport()
+  : shmRing(NULL), maxRate(0), droppedCount(0)
 {
 }
 
@@ -29,6 +33,7 @@ SubscriptionTransport::SubscriptionTransport()
 SubscriptionTransport::~SubscriptionTransport()
 {
   ConnectionManager::Instance()->RemoveConnection(this->connection);
+  delete this->shmRing;
 }
 
 //////////////////////////////////////////////////
@@ -38,21 +43,91 @@ void SubscriptionTransport::Init(const ConnectionPtr &_conn, bool _latching)
   this->latching = _latching;
 }
 
+//////////////////////////////////////////////////
+bool SubscriptionTransport::InitShm(const std::string &_name, uint64_t _key)
+{
+  delete this->shmRing;
+  this->shmRing = new ShmRing();
+  if (!this->shmRing->Open(_name, _key))
+  {
+    delete this->shmRing;
+    this->shmRing = NULL;
+    return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SubscriptionTransport::SetMaxRate(double _rate)
+{
+  this->maxRate = std::max(0.0, _rate);
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionTransport::IsThrottled()
+{
+  if (this->maxRate <= 0)
+    return false;
+
+  common::Time now = common::Time::GetWallTime();
+  if ((now - this->lastSend).Double() < 1.0 / this->maxRate)
+    return true;
+
+  this->lastSend = now;
+  return false;
+}
+
 //////////////////////////////////////////////////
 bool SubscriptionTransport::HandleMessage(MessagePtr _newMsg)
 {
+  // Skipped messages count as handled, so the subscription is kept
+  if (this->IsThrottled())
+    return this->connection->IsOpen();
+
+  // Serialize straight into shared memory when possible
+  if (this->shmRing && this->connection->IsOpen())
+  {
+    int size = _newMsg->ByteSize();
+    if (this->UseShm(size))
+    {
+      char *dest = this->shmRing->BeginWrite(size);
+      if (dest)
+      {
+        _newMsg->SerializeWithCachedSizesToArray(
+            reinterpret_cast<google::protobuf::uint8*>(dest));
+        this->shmRing->EndWrite();
+      }
+      else
+        this->DropMessage();
+      return true;
+    }
+  }
+
   std::string data;
   _newMsg->SerializeToString(&data);
-  return this->HandleData(data);
+  return this->Send(data);
 }
 
 //////////////////////////////////////////////////
-bool SubscriptionTransport::HandleData(const std::string &newdata)
+bool SubscriptionTransport::HandleData(const std::string &_newdata)
+{
+  if (this->IsThrottled())
+    return this->connection->IsOpen();
+
+  return this->Send(_newdata);
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionTransport::Send(const std::string &newdata)
 {
   bool result = false;
   if (this->connection->IsOpen())
   {
-    this->connection->EnqueueMsg(newdata);
+    if (!this->UseShm(newdata.size()))
+      this->connection->EnqueueMsg(newdata);
+    else if (!this->shmRing->Write(newdata))
+      this->DropMessage();
     result = true;
   }
   else
@@ -61,6 +136,47 @@ bool SubscriptionTransport::HandleData(const std::string &newdata)
   return result;
 }
 
+//////////////////////////////////////////////////
+bool SubscriptionTransport::UseShm(uint32_t _size)
+{
+  if (!this->shmRing)
+    return false;
+
+  if (this->shmRing->Fits(_size))
+    return true;
+
+  // The message can never go through the ring, so it and all the
+  // following messages go over the connection. The subscriber empties the
+  // ring before passing on a message from the connection, so they stay in
+  // order without waiting here.
+  gzwarn << "Message of " << _size << " bytes is too large for the shared "
+         << "memory ring[" << this->shmRing->GetName() << "], using TCP "
+         << "from now on\n";
+
+  delete this->shmRing;
+  this->shmRing = NULL;
+  return false;
+}
+
+//////////////////////////////////////////////////
+void SubscriptionTransport::DropMessage()
+{
+  // Sending the message over the connection instead would let it overtake
+  // the messages in the ring
+  if (this->droppedCount++ == 0)
+  {
+    gzwarn << "Shared memory ring[" << this->shmRing->GetName()
+           << "] is full, dropping messages until the subscriber catches "
+           << "up\n";
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int SubscriptionTransport::GetDroppedCount() const
+{
+  return this->droppedCount;
+}
+
 //////////////////////////////////////////////////
 const ConnectionPtr &SubscriptionTransport::GetConnection() const
 {
@@ -20,8 +20,10 @@
 #include <boost/shared_ptr.hpp>
 #include <string>
 
+#include "common/Time.hh"
 #include "Connection.hh"
 #include "CallbackHelper.hh"
+#include "ShmRing.hh"
 
 namespace gazebo
 {
@@ -48,6 +50,23 @@ namespace gazebo
       /// don't latch
       public: void Init(const ConnectionPtr &_conn, bool _latching);
 
+      /// \brief Write messages to a shared memory ring offered by the
+      /// subscriber, instead of the connection. To keep the messages in
+      /// order, messages are dropped while the ring is full, see
+      /// GetDroppedCount. A message too large for the ring switches the
+      /// subscription to the connection for good.
+      /// \param[in] _name Name of the ring.
+      /// \param[in] _key Key of the ring.
+      /// \return False if the ring can't be opened, which is the case
+      /// when the subscriber is on another host.
+      public: bool InitShm(const std::string &_name, uint64_t _key);
+
+      /// \brief Limit the rate of messages sent to the subscriber.
+      /// Messages that arrive sooner than 1/_rate seconds after the last
+      /// sent message are skipped.
+      /// \param[in] _rate Maximum rate in Hz, 0 for no limit.
+      public: void SetMaxRate(double _rate);
+
       /// \brief Output a message to a connection
       /// \param[in] _newdata The message to be handled
       /// \return true if the message was handled successfully, false otherwise
@@ -56,6 +75,11 @@ namespace gazebo
       // Documentation inherited
       public: virtual bool HandleMessage(MessagePtr _newMsg);
 
+      /// \brief Get the number of messages dropped because the shared
+      /// memory ring was full.
+      /// \return Number of dropped messages.
+      public: unsigned int GetDroppedCount() const;
+
       /// \brief Get the connection we're using
       /// \return Pointer to the connection we're using
       public: const ConnectionPtr &GetConnection() const;
@@ -65,7 +89,38 @@ namespace gazebo
       /// is tied to a  remote connection
       public: virtual bool IsLocal() const;
 
+      /// \brief Check whether a message should be skipped because of the
+      /// rate limit. Updates the time of the last sent message otherwise.
+      /// \return True to skip the message.
+      private: bool IsThrottled();
+
+      /// \brief Check whether a message goes through the shared memory
+      /// ring. Stops using the ring if the message is too large for it.
+      /// \param[in] _size Size of the message in bytes.
+      /// \return True to write the message to the ring.
+      private: bool UseShm(uint32_t _size);
+
+      /// \brief Count a message dropped because the ring was full.
+      private: void DropMessage();
+
+      /// \brief Send serialized data to the subscriber.
+      /// \param[in] _data The data to send.
+      /// \return False if the connection is closed.
+      private: bool Send(const std::string &_data);
+
       private: ConnectionPtr connection;
+
+      /// \brief Shared memory ring to the subscriber, NULL if not used.
+      private: ShmRing *shmRing;
+
+      /// \brief Maximum rate in Hz, 0 for no limit.
+      private: double maxRate;
+
+      /// \brief Wall time of the last sent message.
+      private: common::Time lastSend;
+
+      /// \brief Number of messages dropped because the ring was full.
+      private: unsigned int droppedCount;
     };
     /// \}
   }
@@ -15,9 +15,12 @@
  *
 */
 
+#include <algorithm>
+
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range.h>
 
+#include "gazebo/common/Trace.hh"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/Publication.hh"
@@ -136,6 +139,8 @@ void TopicManager::RemoveNode(unsigned int _id)
 //////////////////////////////////////////////////
 void TopicManager::ProcessNodes(bool _onlyOut)
 {
+  GZ_TRACE_SCOPE("TopicManager::ProcessNodes");
+
   std::vector<NodePtr>::iterator iter;
   int s;
 
@@ -203,8 +208,15 @@ SubscriberPtr TopicManager::Subscribe(const SubscribeOptions &_ops)
 
   // If the publication exits, just add the subscription to it
   if (pub)
+  {
     pub->AddSubscription(_ops.GetNode());
 
+    // Reconnect to remote publishers that skip messages this subscriber
+    // needs. The master sends the publishers again for the subscribe
+    // request below.
+    pub->RemoveThrottledTransports(this->GetMaxRate(_ops.GetTopic()));
+  }
+
   // Use this to find other remote publishers
   ConnectionManager::Instance()->Subscribe(_ops.GetTopic(), _ops.GetMsgType(),
                                            _ops.GetLatching());
@@ -315,7 +327,7 @@ void TopicManager::ConnectSubToPub(const msgs::Publish &_pub)
         }
       }
 
-      publink->Init(conn, latched);
+      publink->Init(conn, latched, this->GetMaxRate(_pub.topic()));
 
       publication->AddTransport(publink);
     }
@@ -324,6 +336,26 @@ void TopicManager::ConnectSubToPub(const msgs::Publish &_pub)
   this->ConnectSubscribers(_pub.topic());
 }
 
+//////////////////////////////////////////////////
+double TopicManager::GetMaxRate(const std::string &_topic)
+{
+  SubNodeMap::iterator nodeIter = this->subscribedNodes.find(_topic);
+  if (nodeIter == this->subscribedNodes.end() || nodeIter->second.empty())
+    return 0;
+
+  // Every message is needed if any node is not rate limited
+  double rate = 0;
+  std::list<NodePtr>::iterator iter;
+  for (iter = nodeIter->second.begin(); iter != nodeIter->second.end(); ++iter)
+  {
+    double nodeRate = (*iter)->GetMaxRate(_topic);
+    if (nodeRate <= 0)
+      return 0;
+    rate = std::max(rate, nodeRate);
+  }
+
+  return rate;
+}
 
 //////////////////////////////////////////////////
 PublicationPtr TopicManager::UpdatePublications(const std::string &topic,
@@ -225,6 +225,12 @@ namespace gazebo
       /// \param[in] _pause If true pause processing; otherwse unpause
       public: void PauseIncoming(bool _pause);
 
+      /// \brief Get the rate to receive messages from remote publishers
+      /// at, which is the highest rate of the local subscribers.
+      /// \param[in] _topic Name of the topic.
+      /// \return Rate in Hz, 0 if every message is needed.
+      private: double GetMaxRate(const std::string &_topic);
+
       /// \brief A map of string->list of Node pointers
       typedef std::map<std::string, std::list<NodePtr> > SubNodeMap;
 
@@ -61,14 +61,20 @@ DiagnosticManager::~DiagnosticManager()
 //////////////////////////////////////////////////
 void DiagnosticManager::Init(const std::string &_worldName)
 {
-  this->node.reset(new transport::Node());
+  transport::NodePtr node(new transport::Node());
+  node->Init(_worldName);
 
-  this->node->Init(_worldName);
+  boost::mutex::scoped_lock lock(this->mutex);
 
-  this->pub = this->node->Advertise<msgs::Diagnostics>("~/diagnostics");
+  this->nodes[_worldName] = node;
+  this->pubs[_worldName] =
+    node->Advertise<msgs::Diagnostics>("~/diagnostics");
 
-  this->updateConnection = event::Events::ConnectWorldUpdateBegin(
-      boost::bind(&DiagnosticManager::Update, this, _1));
+  if (!this->updateConnection)
+  {
+    this->updateConnection = event::Events::ConnectWorldUpdateBegin(
+        boost::bind(&DiagnosticManager::Update, this, _1));
+  }
 }
 
 //////////////////////////////////////////////////
@@ -80,6 +86,14 @@ boost::filesystem::path DiagnosticManager::GetLogPath() const
 //////////////////////////////////////////////////
 void DiagnosticManager::Update(const common::UpdateInfo &_info)
 {
+  boost::mutex::scoped_lock lock(this->mutex);
+
+  // Only worlds that were initialized are timed
+  std::map<std::string, transport::PublisherPtr>::iterator iter =
+    this->pubs.find(_info.worldName);
+  if (iter == this->pubs.end() || !iter->second)
+    return;
+
   if (_info.realTime > common::Time::Zero)
     this->msg.set_real_time_factor((_info.simTime / _info.realTime).Double());
   else
@@ -88,8 +102,7 @@ void DiagnosticManager::Update(const common::UpdateInfo &_info)
   msgs::Set(this->msg.mutable_real_time(), _info.realTime);
   msgs::Set(this->msg.mutable_sim_time(), _info.simTime);
 
-  if (this->pub)
-    this->pub->Publish(this->msg);
+  iter->second->Publish(this->msg);
 
   this->msg.clear_time();
 }
@@ -98,6 +111,8 @@ void DiagnosticManager::Update(const common::UpdateInfo &_info)
 void DiagnosticManager::AddTime(const std::string &_name,
     common::Time &_wallTime, common::Time &_elapsedTime)
 {
+  boost::mutex::scoped_lock lock(this->mutex);
+
   msgs::Diagnostics::DiagTime *time = this->msg.add_time();
   time->set_name(_name);
   msgs::Set(time->mutable_elapsed(), _elapsedTime);
@@ -23,6 +23,8 @@
 #define _DIAGNOSTICMANAGER_HH_
 
 #include <boost/unordered_map.hpp>
+#include <boost/thread/mutex.hpp>
+#include <map>
 #include <string>
 #include <boost/filesystem.hpp>
 
@@ -80,7 +82,9 @@ namespace gazebo
       /// \brief Destructor
       private: virtual ~DiagnosticManager();
 
-      /// \brief Initialize to report diagnostics about a world.
+      /// \brief Initialize to report diagnostics about a world. Each world
+      /// publishes its own diagnostics, and the timer times are published
+      /// with the next diagnostics of any world.
       /// \param[in] _worldName Name of the world.
       public: void Init(const std::string &_worldName);
 
@@ -145,15 +149,18 @@ namespace gazebo
       /// \brief Path in which to store timing logs.
       private: boost::filesystem::path logPath;
 
-      /// \brief Node for publishing diagnostic data.
-      private: transport::NodePtr node;
+      /// \brief Nodes for publishing diagnostic data, by world name.
+      private: std::map<std::string, transport::NodePtr> nodes;
 
-      /// \brief Publisher of diagnostic data.
-      private: transport::PublisherPtr pub;
+      /// \brief Publishers of diagnostic data, by world name.
+      private: std::map<std::string, transport::PublisherPtr> pubs;
 
       /// \brief The message to output
       private: msgs::Diagnostics msg;
 
+      /// \brief Protects the publishers and the message.
+      private: boost::mutex mutex;
+
       /// \brief Pointer to the update event connection
       private: event::ConnectionPtr updateConnection;
 
@@ -204,18 +204,16 @@ class ServerFixture : public testing::Test
                  ASSERT_NO_THROW(this->server->LoadFile(_worldFilename));
                ASSERT_NO_THROW(this->server->Init());
 
-               if (!rendering::get_scene(
-                     gazebo::physics::get_world()->GetName()))
-               {
-                 rendering::create_scene(
-                     gazebo::physics::get_world()->GetName(), false);
-               }
+               // A test may load more worlds while the server runs
+               std::string worldName = gazebo::physics::get_world()->GetName();
+               if (!rendering::get_scene(worldName))
+                 rendering::create_scene(worldName, false);
 
                this->SetPause(_paused);
 
                this->server->Run();
 
-               rendering::remove_scene(gazebo::physics::get_world()->GetName());
+               rendering::remove_scene(worldName);
 
                ASSERT_NO_THROW(this->server->Fini());
                delete this->server;
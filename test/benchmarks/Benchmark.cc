@@ -0,0 +1,302 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <time.h>
+
+#include <sstream>
+
+#include "gazebo/common/Exception.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/Physics.hh"
+#include "gazebo/sensors/Sensor.hh"
+#include "gazebo/sensors/SensorManager.hh"
+#include "gazebo/sensors/Sensors.hh"
+#include "gazebo/sdf/sdf.hh"
+#include "gazebo/Server.hh"
+
+#include "Benchmark.hh"
+
+using namespace gazebo;
+using namespace benchmark;
+
+/// \brief Factor applied to the step and message counts.
+static double g_benchmarkScale = 1.0;
+
+/// \brief Server started by load_world.
+static Server *g_server = NULL;
+
+/////////////////////////////////////////////////
+/// \brief Get the benchmark registry.
+/// \return Functions by name.
+static std::map<std::string, BenchmarkFunc> &getRegistry()
+{
+  static std::map<std::string, BenchmarkFunc> registry;
+  return registry;
+}
+
+/////////////////////////////////////////////////
+/// \brief Write a string as a JSON string.
+/// \param[in] _out Stream to write to.
+/// \param[in] _str The string.
+static void writeJSONString(std::ostream &_out, const std::string &_str)
+{
+  _out << '"';
+  for (std::string::const_iterator iter = _str.begin(); iter != _str.end();
+       ++iter)
+  {
+    if (*iter == '"' || *iter == '\\')
+      _out << '\\' << *iter;
+    else if (static_cast<unsigned char>(*iter) < 0x20)
+      _out << ' ';
+    else
+      _out << *iter;
+  }
+  _out << '"';
+}
+
+/////////////////////////////////////////////////
+Result::Result(const std::string &_name)
+  : name(_name)
+{
+}
+
+/////////////////////////////////////////////////
+void Result::SetValue(const std::string &_key, double _value)
+{
+  this->values[_key] = _value;
+}
+
+/////////////////////////////////////////////////
+void Result::SetTiming(const std::string &_key,
+                       const common::Histogram &_histogram)
+{
+  this->timings[_key] = _histogram;
+}
+
+/////////////////////////////////////////////////
+void Result::WriteJSON(std::ostream &_out) const
+{
+  std::ostringstream stream;
+  stream.precision(9);
+
+  stream << "    {\n      \"name\": ";
+  writeJSONString(stream, this->name);
+
+  for (std::map<std::string, double>::const_iterator iter =
+       this->values.begin(); iter != this->values.end(); ++iter)
+  {
+    stream << ",\n      ";
+    writeJSONString(stream, iter->first);
+    stream << ": " << iter->second;
+  }
+
+  // Timings in seconds, like the world statistics
+  stream << ",\n      \"timings\": {";
+  for (std::map<std::string, common::Histogram>::const_iterator iter =
+       this->timings.begin(); iter != this->timings.end(); ++iter)
+  {
+    const common::Histogram &hist = iter->second;
+    stream << (iter == this->timings.begin() ? "\n" : ",\n") << "        ";
+    writeJSONString(stream, iter->first);
+    stream << ": {\"count\": " << hist.GetCount()
+           << ", \"mean\": " << hist.GetMean() * 1e-9
+           << ", \"min\": " << hist.GetMin() * 1e-9
+           << ", \"p50\": " << hist.GetPercentile(50) * 1e-9
+           << ", \"p95\": " << hist.GetPercentile(95) * 1e-9
+           << ", \"p99\": " << hist.GetPercentile(99) * 1e-9
+           << ", \"max\": " << hist.GetMax() * 1e-9 << "}";
+  }
+  stream << (this->timings.empty() ? "}" : "\n      }") << "\n    }";
+
+  _out << stream.str();
+}
+
+/////////////////////////////////////////////////
+void benchmark::register_benchmark(const std::string &_name,
+                                   BenchmarkFunc _func)
+{
+  getRegistry()[_name] = _func;
+}
+
+/////////////////////////////////////////////////
+const std::map<std::string, BenchmarkFunc> &benchmark::get_benchmarks()
+{
+  return getRegistry();
+}
+
+/////////////////////////////////////////////////
+void benchmark::set_scale(double _scale)
+{
+  g_benchmarkScale = _scale;
+}
+
+/////////////////////////////////////////////////
+double benchmark::get_scale()
+{
+  return g_benchmarkScale;
+}
+
+/////////////////////////////////////////////////
+unsigned int benchmark::scaled(unsigned int _count)
+{
+  double count = _count * g_benchmarkScale;
+  return count < 1.0 ? 1 : static_cast<unsigned int>(count);
+}
+
+/////////////////////////////////////////////////
+uint64_t benchmark::get_time()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+/////////////////////////////////////////////////
+std::string benchmark::world_sdf(const std::string &_models,
+                                 const std::string &_collisionDetector)
+{
+  std::ostringstream stream;
+  stream << "<sdf version='" << SDF_VERSION << "'>"
+    << "<world name='default'>"
+    << "<physics type='ode'>"
+    << "  <gravity>0 0 -9.8</gravity>"
+    << "  <ode>"
+    << "    <solver>"
+    << "      <type>quick</type>"
+    << "      <dt>0.001</dt>"
+    << "      <iters>50</iters>"
+    << "      <sor>1.3</sor>"
+    << "    </solver>"
+    << "    <collision_detector>" << _collisionDetector
+    << "</collision_detector>"
+    << "  </ode>"
+    << "</physics>"
+    << "<model name='ground_plane'>"
+    << "  <static>true</static>"
+    << "  <link name='link'>"
+    << "    <collision name='collision'>"
+    << "      <geometry>"
+    << "        <plane><normal>0 0 1</normal><size>100 100</size></plane>"
+    << "      </geometry>"
+    << "    </collision>"
+    << "  </link>"
+    << "</model>"
+    << _models
+    << "</world>"
+    << "</sdf>";
+
+  return stream.str();
+}
+
+/////////////////////////////////////////////////
+physics::WorldPtr benchmark::load_world(const std::string &_sdf,
+                                        Result &_result)
+{
+  physics::WorldPtr world;
+  if (g_server)
+  {
+    gzerr << "A world is already loaded\n";
+    return world;
+  }
+
+  uint64_t start = get_time();
+
+  g_server = new Server();
+  if (!g_server->LoadString(_sdf))
+    return world;
+  g_server->Init();
+
+  // Initialize the sensors, as Server::Run does before the worlds start
+  sensors::run_once(true);
+
+  world = physics::get_world();
+  _result.SetValue("load_time", (get_time() - start) * 1e-9);
+
+  return world;
+}
+
+/////////////////////////////////////////////////
+void benchmark::step_world(physics::WorldPtr _world, unsigned int _warmup,
+                           unsigned int _steps, Result &_result,
+                           const StepCallback &_callback)
+{
+  // Cameras need a renderer, the other sensors are updated here at
+  // their own rate instead of in the sensor threads
+  sensors::Sensor_V sensorList;
+  sensors::Sensor_V all = sensors::SensorManager::Instance()->GetSensors();
+  for (sensors::Sensor_V::iterator iter = all.begin(); iter != all.end();
+       ++iter)
+  {
+    if ((*iter)->GetCategory() != sensors::IMAGE)
+      sensorList.push_back(*iter);
+  }
+
+  for (unsigned int i = 0; i < _warmup; ++i)
+  {
+    _world->RunBatch(1);
+    for (sensors::Sensor_V::iterator iter = sensorList.begin();
+         iter != sensorList.end(); ++iter)
+    {
+      (*iter)->Update(false);
+    }
+  }
+
+  _world->ResetPhaseTimes();
+
+  common::Histogram stepTimes;
+  common::Histogram sensorTimes;
+  uint64_t start = get_time();
+  for (unsigned int i = 0; i < _steps; ++i)
+  {
+    if (_callback)
+      _callback(i);
+
+    uint64_t stepStart = get_time();
+    if (!_world->RunBatch(1))
+      gzthrow("Unable to step the world");
+    uint64_t stepEnd = get_time();
+
+    for (sensors::Sensor_V::iterator iter = sensorList.begin();
+         iter != sensorList.end(); ++iter)
+    {
+      (*iter)->Update(false);
+    }
+
+    stepTimes.Add(stepEnd - stepStart);
+    if (!sensorList.empty())
+      sensorTimes.Add(get_time() - stepEnd);
+  }
+  double wallTime = (get_time() - start) * 1e-9;
+
+  double stepSize = _world->GetPhysicsEngine()->GetMaxStepSize();
+  _result.SetValue("steps", _steps);
+  _result.SetValue("wall_time", wallTime);
+  _result.SetValue("steps_per_sec", wallTime > 0 ? _steps / wallTime : 0);
+  _result.SetValue("real_time_factor",
+      wallTime > 0 ? _steps * stepSize / wallTime : 0);
+  _result.SetTiming("step", stepTimes);
+  if (!sensorList.empty())
+    _result.SetTiming("sensors", sensorTimes);
+
+  std::map<std::string, common::Histogram> phases;
+  _world->GetPhaseTimes(phases);
+  for (std::map<std::string, common::Histogram>::iterator iter =
+       phases.begin(); iter != phases.end(); ++iter)
+  {
+    _result.SetTiming("phase." + iter->first, iter->second);
+  }
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _BENCHMARK_HH_
+#define _BENCHMARK_HH_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include <boost/function.hpp>
+
+#include "gazebo/common/Histogram.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  /// \brief Headless benchmarks of the simulator.
+  namespace benchmark
+  {
+    /// \brief Measurements of one benchmark.
+    class Result
+    {
+      /// \brief Constructor.
+      /// \param[in] _name Name of the benchmark.
+      public: explicit Result(const std::string &_name);
+
+      /// \brief Set a value.
+      /// \param[in] _key Name of the value.
+      /// \param[in] _value The value.
+      public: void SetValue(const std::string &_key, double _value);
+
+      /// \brief Set a timing.
+      /// \param[in] _key Name of the timing.
+      /// \param[in] _histogram Durations in nanoseconds.
+      public: void SetTiming(const std::string &_key,
+                             const common::Histogram &_histogram);
+
+      /// \brief Write the result as a JSON object.
+      /// \param[in] _out Stream to write to.
+      public: void WriteJSON(std::ostream &_out) const;
+
+      /// \brief Name of the benchmark.
+      public: std::string name;
+
+      /// \brief Values, by name.
+      public: std::map<std::string, double> values;
+
+      /// \brief Timings in nanoseconds, by name.
+      public: std::map<std::string, common::Histogram> timings;
+    };
+
+    /// \brief Function that runs a benchmark.
+    typedef void (*BenchmarkFunc)(Result &_result);
+
+    /// \brief Add a benchmark to the suite.
+    /// \param[in] _name Unique name of the benchmark.
+    /// \param[in] _func Function that runs it.
+    void register_benchmark(const std::string &_name, BenchmarkFunc _func);
+
+    /// \brief Get the benchmarks, sorted by name.
+    /// \return Functions by name.
+    const std::map<std::string, BenchmarkFunc> &get_benchmarks();
+
+    /// \brief Set the factor the benchmarks multiply their step and
+    /// message counts by.
+    /// \param[in] _scale The factor.
+    void set_scale(double _scale);
+
+    /// \brief Get the factor set by set_scale, 1 by default.
+    /// \return The factor.
+    double get_scale();
+
+    /// \brief Scale a count by get_scale, keeping at least one.
+    /// \param[in] _count Count at a scale of 1.
+    /// \return The scaled count.
+    unsigned int scaled(unsigned int _count);
+
+    /// \brief Wrap models in a world with a ground plane and a fixed step
+    /// size, so results don't depend on the defaults of the release.
+    /// \param[in] _models SDF of the models.
+    /// \param[in] _collisionDetector ODE collision detector.
+    /// \return SDF of the world.
+    std::string world_sdf(const std::string &_models,
+                          const std::string &_collisionDetector = "ode");
+
+    /// \brief Start a server without rendering and load a world in it. The
+    /// world is not run in its own thread, see step_world. Sets the
+    /// "load_time" value. Only one world can be loaded per process.
+    /// \param[in] _sdf SDF of the world.
+    /// \param[out] _result Result of the benchmark.
+    /// \return The world, NULL on error.
+    physics::WorldPtr load_world(const std::string &_sdf, Result &_result);
+
+    /// \brief Called before each timed step with the step index.
+    typedef boost::function<void (unsigned int)> StepCallback;
+
+    /// \brief Step the world in the calling thread as fast as possible,
+    /// with its non-rendering sensors updated at their own rate.
+    ///
+    /// Sets the "steps", "wall_time", "steps_per_sec" and
+    /// "real_time_factor" values, the "step" and "sensors" timings, and a
+    /// timing per step phase, prefixed with "phase.".
+    /// \param[in] _world World returned by load_world.
+    /// \param[in] _warmup Steps taken first and not measured.
+    /// \param[in] _steps Steps to measure.
+    /// \param[out] _result Result of the benchmark.
+    /// \param[in] _callback Called before each step, may be NULL.
+    void step_world(physics::WorldPtr _world, unsigned int _warmup,
+                    unsigned int _steps, Result &_result,
+                    const StepCallback &_callback = StepCallback());
+
+    /// \brief Get a monotonic wall time.
+    /// \return Time in nanoseconds.
+    uint64_t get_time();
+
+    /// \brief Registers a benchmark when the program starts.
+    class Registrar
+    {
+      /// \brief Constructor.
+      /// \param[in] _name Unique name of the benchmark.
+      /// \param[in] _func Function that runs it.
+      public: Registrar(const std::string &_name, BenchmarkFunc _func)
+              {
+                register_benchmark(_name, _func);
+              }
+    };
+  }
+}
+
+/// \brief Add a function to the benchmark suite.
+/// \param[in] name Name of the benchmark, an identifier.
+/// \param[in] func Function that runs it.
+#define GZ_REGISTER_BENCHMARK(name, func) \
+  static gazebo::benchmark::Registrar Benchmark_##name(#name, func);
+
+#endif
@@ -0,0 +1,284 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <boost/thread.hpp>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Exception.hh"
+#include "gazebo/common/SystemPaths.hh"
+#include "gazebo/common/Time.hh"
+#include "gazebo/gazebo_config.h"
+
+#include "test_config.h"
+#include "Benchmark.hh"
+
+namespace po = boost::program_options;
+
+using namespace gazebo;
+using namespace benchmark;
+
+/////////////////////////////////////////////////
+/// \brief Run a benchmark in this process, which must be a child that
+/// exits when the benchmark is done.
+/// \param[in] _name Name of the benchmark.
+/// \param[in] _func Function that runs it.
+/// \param[in] _fd Pipe the JSON result is written to.
+static void runChild(const std::string &_name, BenchmarkFunc _func, int _fd)
+{
+  // Use a master of its own, so a running gzserver is never joined and
+  // the benchmarks don't wait for each other's port
+  std::ostringstream uri;
+  uri << "http://localhost:" << 11500 + getpid() % 1000;
+  setenv("GAZEBO_MASTER_URI", uri.str().c_str(), 1);
+
+  Result result(_name);
+  int status = 0;
+  try
+  {
+    _func(result);
+  }
+  catch(common::Exception &_e)
+  {
+    std::cerr << _name << " failed: " << _e << "\n";
+    status = 1;
+  }
+
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+    result.SetValue("peak_rss_kb", usage.ru_maxrss);
+
+  if (status == 0)
+  {
+    std::ostringstream stream;
+    result.WriteJSON(stream);
+    std::string json = stream.str();
+
+    const char *data = json.c_str();
+    size_t size = json.size();
+    while (size > 0)
+    {
+      ssize_t written = write(_fd, data, size);
+      if (written < 0 && errno == EINTR)
+        continue;
+      if (written <= 0)
+      {
+        status = 1;
+        break;
+      }
+      data += written;
+      size -= written;
+    }
+  }
+  close(_fd);
+
+  // Skip the destructors of the singletons, a benchmark leaves its server
+  // and threads running
+  _exit(status);
+}
+
+/////////////////////////////////////////////////
+/// \brief Run a benchmark in a child process, so it starts from a clean
+/// state and its peak memory is its own.
+/// \param[in] _name Name of the benchmark.
+/// \param[in] _func Function that runs it.
+/// \param[out] _json The JSON result.
+/// \return True if the benchmark succeeded.
+static bool runBenchmark(const std::string &_name, BenchmarkFunc _func,
+                         std::string &_json)
+{
+  int fds[2];
+  if (pipe(fds) != 0)
+  {
+    std::cerr << "Unable to create a pipe\n";
+    return false;
+  }
+
+  std::cout.flush();
+  std::cerr.flush();
+
+  pid_t pid = fork();
+  if (pid < 0)
+  {
+    std::cerr << "Unable to fork\n";
+    close(fds[0]);
+    close(fds[1]);
+    return false;
+  }
+
+  if (pid == 0)
+  {
+    close(fds[0]);
+    runChild(_name, _func, fds[1]);
+  }
+
+  close(fds[1]);
+
+  _json.clear();
+  char buffer[4096];
+  ssize_t count;
+  while ((count = read(fds[0], buffer, sizeof(buffer))) != 0)
+  {
+    if (count < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+    _json.append(buffer, count);
+  }
+  close(fds[0]);
+
+  int status = 0;
+  while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+    continue;
+
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0 && !_json.empty();
+}
+
+/////////////////////////////////////////////////
+int main(int _argc, char **_argv)
+{
+  po::options_description desc("Options");
+  desc.add_options()
+    ("help,h", "Produce this help message.")
+    ("list,l", "List the benchmarks.")
+    ("filter,f", po::value<std::string>(),
+     "Only run the benchmarks with names containing this string.")
+    ("scale,s", po::value<double>()->default_value(1.0),
+     "Multiply the step and message counts by this factor.")
+    ("output,o",
+     po::value<std::string>()->default_value("benchmarks.json"),
+     "File the JSON results are written to.");
+
+  po::variables_map vm;
+  try
+  {
+    po::store(po::parse_command_line(_argc, _argv, desc), vm);
+    po::notify(vm);
+  }
+  catch(po::error &_e)
+  {
+    std::cerr << "Error. Invalid arguments\n" << desc << "\n";
+    return -1;
+  }
+
+  if (vm.count("help"))
+  {
+    std::cout << "gzbenchmark -- Run headless benchmarks of gazebo\n\n"
+      << "`gzbenchmark` [options]\n\n" << desc << "\n";
+    return 0;
+  }
+
+  const std::map<std::string, BenchmarkFunc> &benchmarks = get_benchmarks();
+  if (vm.count("list"))
+  {
+    for (std::map<std::string, BenchmarkFunc>::const_iterator iter =
+         benchmarks.begin(); iter != benchmarks.end(); ++iter)
+    {
+      std::cout << iter->first << "\n";
+    }
+    return 0;
+  }
+
+  std::string filter;
+  if (vm.count("filter"))
+    filter = vm["filter"].as<std::string>();
+
+  set_scale(vm["scale"].as<double>());
+  if (get_scale() <= 0)
+  {
+    std::cerr << "The scale must be positive\n";
+    return -1;
+  }
+
+  common::Console::Instance()->Init("benchmark.log");
+  common::Console::Instance()->SetQuiet(true);
+
+  // Find the models, media and sdf descriptions of the source tree
+  common::SystemPaths::Instance()->AddGazeboPaths(PROJECT_SOURCE_PATH);
+  common::SystemPaths::Instance()->AddGazeboPaths(
+      std::string(PROJECT_SOURCE_PATH) + "/sdf");
+  common::SystemPaths::Instance()->AddGazeboPaths(
+      std::string(PROJECT_SOURCE_PATH) + "/gazebo");
+  common::SystemPaths::Instance()->AddPluginPaths(
+      std::string(PROJECT_SOURCE_PATH) + "/build/plugins");
+  common::SystemPaths::Instance()->AddGazeboPaths(TEST_PATH);
+
+  std::ostringstream stream;
+  char hostname[256] = "";
+  gethostname(hostname, sizeof(hostname) - 1);
+  stream << "{\n"
+    << "  \"version\": \"" << GAZEBO_VERSION_FULL << "\",\n"
+    << "  \"time\": \"" << common::Time::GetWallTimeAsISOString() << "\",\n"
+    << "  \"host\": \"" << hostname << "\",\n"
+    << "  \"hardware_threads\": " << boost::thread::hardware_concurrency()
+    << ",\n"
+    << "  \"scale\": " << get_scale() << ",\n"
+    << "  \"benchmarks\": [";
+
+  int result = 0;
+  unsigned int count = 0;
+  for (std::map<std::string, BenchmarkFunc>::const_iterator iter =
+       benchmarks.begin(); iter != benchmarks.end(); ++iter)
+  {
+    if (!filter.empty() && iter->first.find(filter) == std::string::npos)
+      continue;
+
+    std::cout << "Running " << iter->first << "..." << std::endl;
+
+    std::string json;
+    if (!runBenchmark(iter->first, iter->second, json))
+    {
+      std::cerr << iter->first << " failed\n";
+      json = "    {\n      \"name\": \"" + iter->first +
+        "\",\n      \"error\": true\n    }";
+      result = 1;
+    }
+
+    stream << (count == 0 ? "\n" : ",\n") << json;
+    ++count;
+  }
+  stream << (count == 0 ? "]" : "\n  ]") << "\n}\n";
+
+  std::string output = vm["output"].as<std::string>();
+  boost::filesystem::path outputDir =
+    boost::filesystem::path(output).parent_path();
+  if (!outputDir.empty() && !boost::filesystem::exists(outputDir))
+    boost::filesystem::create_directories(outputDir);
+
+  std::ofstream out(output.c_str());
+  if (!out)
+  {
+    std::cerr << "Unable to write " << output << "\n";
+    return 1;
+  }
+  out << stream.str();
+  std::cout << "Wrote " << count << " results to " << output << "\n";
+
+  return result;
+}
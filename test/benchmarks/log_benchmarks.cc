@@ -0,0 +1,114 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/Exception.hh"
+#include "gazebo/common/LogPlay.hh"
+#include "gazebo/common/LogRecord.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/WorldState.hh"
+#include "gazebo/sdf/sdf.hh"
+
+#include "Benchmark.hh"
+
+using namespace gazebo;
+using namespace benchmark;
+
+/////////////////////////////////////////////////
+/// \brief Record the state of a world with moving models, then play the
+/// log back into the same world.
+static void logRecordPlayback(Result &_result)
+{
+  boost::filesystem::path basePath =
+    boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("gzbenchmark-%%%%-%%%%");
+
+  // The world adds its log when it is loaded
+  common::LogRecord::Instance()->Init("gzbenchmark");
+  common::LogRecord::Instance()->SetBasePath(basePath.string());
+
+  std::ostringstream models;
+  for (unsigned int i = 0; i < 100; ++i)
+  {
+    models << "<model name='sphere_" << i << "'>"
+      << "<pose>" << (i % 10) * 0.3 << " " << (i / 10) * 0.3 << " "
+      << 0.5 + (i % 3) * 0.25 << " 0 0 0</pose>"
+      << "<link name='link'>"
+      << "  <collision name='collision'>"
+      << "    <geometry><sphere><radius>0.1</radius></sphere></geometry>"
+      << "  </collision>"
+      << "</link>"
+      << "</model>";
+  }
+
+  physics::WorldPtr world = load_world(world_sdf(models.str()), _result);
+  if (!world)
+    gzthrow("Unable to load the world");
+
+  // Record, with the cost of logging in the "phase.logging" timing
+  if (!common::LogRecord::Instance()->Start("bz2"))
+    gzthrow("Unable to start recording");
+  step_world(world, 0, scaled(1000), _result);
+
+  std::string filename =
+    common::LogRecord::Instance()->GetFilename(world->GetName());
+  common::LogRecord::Instance()->Stop();
+
+  if (filename.empty() || !boost::filesystem::exists(filename))
+    gzthrow("The log was not written");
+  _result.SetValue("log_bytes", boost::filesystem::file_size(filename));
+
+  // Play back, the way World::LogStep does, without the insertions and
+  // deletions which this log doesn't have
+  uint64_t start = get_time();
+  common::LogPlay::Instance()->Open(filename);
+
+  // The first chunk is the world description
+  std::string data;
+  common::LogPlay::Instance()->Step(data);
+
+  sdf::ElementPtr stateElem(new sdf::Element);
+  sdf::initFile("state.sdf", stateElem);
+
+  common::Histogram chunkTimes;
+  physics::WorldState state;
+  uint64_t chunkStart = get_time();
+  while (common::LogPlay::Instance()->Step(data))
+  {
+    stateElem->ClearElements();
+    sdf::readString(data, stateElem);
+    state.Load(stateElem);
+    world->SetState(physics::WorldState(world) + state);
+
+    uint64_t chunkEnd = get_time();
+    chunkTimes.Add(chunkEnd - chunkStart);
+    chunkStart = chunkEnd;
+  }
+  double wallTime = (get_time() - start) * 1e-9;
+
+  _result.SetValue("chunks", chunkTimes.GetCount());
+  _result.SetValue("playback_time", wallTime);
+  _result.SetValue("chunks_per_sec",
+      wallTime > 0 ? chunkTimes.GetCount() / wallTime : 0);
+  _result.SetTiming("playback_chunk", chunkTimes);
+
+  boost::system::error_code ec;
+  boost::filesystem::remove_all(basePath, ec);
+}
+GZ_REGISTER_BENCHMARK(log_record_playback, logRecordPlayback)
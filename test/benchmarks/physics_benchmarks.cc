@@ -0,0 +1,476 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <math.h>
+
+#include <sstream>
+
+#include <boost/bind.hpp>
+
+#include "gazebo/common/Exception.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/Joint.hh"
+#include "gazebo/physics/ode/ODEPhysics.hh"
+#include "gazebo/sensors/Sensor.hh"
+#include "gazebo/sensors/SensorManager.hh"
+#include "gazebo/sdf/sdf.hh"
+
+#include "test_config.h"
+#include "Benchmark.hh"
+
+using namespace gazebo;
+using namespace benchmark;
+
+/////////////////////////////////////////////////
+/// \brief Get the SDF of a model with one link.
+/// \param[in] _name Name of the model.
+/// \param[in] _pose Pose of the model.
+/// \param[in] _geometry SDF of the geometry of the link.
+/// \param[in] _static True for a static model.
+/// \return SDF of the model.
+static std::string linkModel(const std::string &_name,
+                             const math::Pose &_pose,
+                             const std::string &_geometry,
+                             bool _static = false)
+{
+  std::ostringstream stream;
+  stream << "<model name='" << _name << "'>"
+    << "<static>" << (_static ? "true" : "false") << "</static>"
+    << "<pose>" << _pose << "</pose>"
+    << "<link name='link'>"
+    << "  <collision name='collision'>"
+    << "    <geometry>" << _geometry << "</geometry>"
+    << "  </collision>"
+    << "</link>"
+    << "</model>";
+  return stream.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the SDF of a model name with an index.
+/// \param[in] _prefix Start of the name.
+/// \param[in] _index Index of the model.
+/// \return The name.
+static std::string modelName(const std::string &_prefix, unsigned int _index)
+{
+  std::ostringstream stream;
+  stream << _prefix << "_" << _index;
+  return stream.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the SDF of objects dropped from a grid of columns.
+/// \param[in] _count Number of objects.
+/// \param[in] _spacing Distance between objects.
+/// \param[in] _geometry SDF of the geometry of the objects.
+/// \return SDF of the models.
+static std::string dropGrid(unsigned int _count, double _spacing,
+                            const std::string &_geometry)
+{
+  // Square layers of objects stacked up, with the same layout for every
+  // run so the number of contacts over time is repeatable
+  unsigned int side = static_cast<unsigned int>(ceil(sqrt(_count / 4.0)));
+  std::string models;
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    unsigned int layer = i / (side * side);
+    unsigned int x = i % side;
+    unsigned int y = (i / side) % side;
+
+    // Shift odd layers, so objects don't land exactly on top of others
+    double shift = (layer % 2) * 0.25 * _spacing;
+    math::Pose pose((x - 0.5 * side) * _spacing + shift,
+                    (y - 0.5 * side) * _spacing + shift,
+                    0.5 + layer * _spacing, 0, 0, 0);
+    models += linkModel(modelName("object", i), pose, _geometry);
+  }
+  return models;
+}
+
+/////////////////////////////////////////////////
+/// \brief Drop spheres on the ground.
+/// \param[in] _count Number of spheres.
+/// \param[in] _steps Steps to measure, at a scale of 1.
+/// \param[out] _result Result of the benchmark.
+static void sphereDrop(unsigned int _count, unsigned int _steps,
+                       Result &_result)
+{
+  physics::WorldPtr world = load_world(world_sdf(dropGrid(_count, 0.25,
+      "<sphere><radius>0.1</radius></sphere>")), _result);
+  if (!world)
+    gzthrow("Unable to load the world");
+
+  _result.SetValue("models", _count);
+  step_world(world, 10, scaled(_steps), _result);
+}
+
+/////////////////////////////////////////////////
+static void sphereDrop100(Result &_result)
+{
+  sphereDrop(100, 2000, _result);
+}
+GZ_REGISTER_BENCHMARK(sphere_drop_100, sphereDrop100)
+
+/////////////////////////////////////////////////
+static void sphereDrop1000(Result &_result)
+{
+  sphereDrop(1000, 500, _result);
+}
+GZ_REGISTER_BENCHMARK(sphere_drop_1000, sphereDrop1000)
+
+/////////////////////////////////////////////////
+static void sphereDrop5000(Result &_result)
+{
+  sphereDrop(5000, 100, _result);
+}
+GZ_REGISTER_BENCHMARK(sphere_drop_5000, sphereDrop5000)
+
+/////////////////////////////////////////////////
+/// \brief Stacks of boxes resting on each other, which stresses the
+/// solver more than the collision detection.
+/// \param[in] _threads Threads of the graph colored quickstep solver, or
+/// 0 for the default solver.
+/// \param[out] _result Result of the benchmark.
+static void boxStacks(int _threads, Result &_result)
+{
+  const unsigned int stacks = 10;
+  const unsigned int height = 10;
+  std::string models;
+  for (unsigned int i = 0; i < stacks; ++i)
+  {
+    for (unsigned int j = 0; j < height; ++j)
+    {
+      math::Pose pose(i * 2.0, 0, 0.25 + j * 0.5, 0, 0, 0);
+      models += linkModel(modelName("box", i * height + j), pose,
+          "<box><size>0.5 0.5 0.5</size></box>");
+    }
+  }
+
+  physics::WorldPtr world = load_world(world_sdf(models), _result);
+  if (!world)
+    gzthrow("Unable to load the world");
+
+  physics::ODEPhysicsPtr odePhysics =
+    boost::dynamic_pointer_cast<physics::ODEPhysics>(
+        world->GetPhysicsEngine());
+  if (!odePhysics)
+    gzthrow("The box stacks benchmark needs the ode engine");
+  odePhysics->SetParam("threads", _threads);
+
+  _result.SetValue("models", stacks * height);
+  _result.SetValue("threads", _threads);
+  step_world(world, 10, scaled(2000), _result);
+}
+
+/////////////////////////////////////////////////
+static void boxStacksDefault(Result &_result)
+{
+  boxStacks(0, _result);
+}
+GZ_REGISTER_BENCHMARK(box_stacks, boxStacksDefault)
+
+/////////////////////////////////////////////////
+static void boxStacksColored1(Result &_result)
+{
+  boxStacks(1, _result);
+}
+GZ_REGISTER_BENCHMARK(box_stacks_colored_1, boxStacksColored1)
+
+/////////////////////////////////////////////////
+static void boxStacksColored2(Result &_result)
+{
+  boxStacks(2, _result);
+}
+GZ_REGISTER_BENCHMARK(box_stacks_colored_2, boxStacksColored2)
+
+/////////////////////////////////////////////////
+static void boxStacksColored4(Result &_result)
+{
+  boxStacks(4, _result);
+}
+GZ_REGISTER_BENCHMARK(box_stacks_colored_4, boxStacksColored4)
+
+/////////////////////////////////////////////////
+/// \brief Triangle mesh cubes dropped in a pile.
+static void trimeshPile(Result &_result)
+{
+  const unsigned int count = 200;
+
+  // The mesh is a cube from -1 to 1
+  std::string geometry = std::string("<mesh><uri>file://") + TEST_PATH +
+    "/data/box.dae</uri><scale>0.1 0.1 0.1</scale></mesh>";
+
+  physics::WorldPtr world = load_world(world_sdf(
+      dropGrid(count, 0.3, geometry)), _result);
+  if (!world)
+    gzthrow("Unable to load the world");
+
+  _result.SetValue("models", count);
+  step_world(world, 10, scaled(1000), _result);
+}
+GZ_REGISTER_BENCHMARK(trimesh_pile, trimeshPile)
+
+/////////////////////////////////////////////////
+/// \brief A long chain of links joined by revolute joints, hanging from
+/// the world and swinging.
+static void articulatedChain(Result &_result)
+{
+  const unsigned int links = 100;
+  const double length = 0.1;
+
+  std::ostringstream stream;
+  stream << "<model name='chain'>"
+    << "<pose>0 0 " << links * length + 1.0 << " 0 0 0</pose>";
+  for (unsigned int i = 0; i < links; ++i)
+  {
+    // Horizontal at the start, so the chain swings down
+    stream << "<link name='link_" << i << "'>"
+      << "  <pose>" << (i + 0.5) * length << " 0 0 0 1.5707 0</pose>"
+      << "  <collision name='collision'>"
+      << "    <geometry><cylinder><radius>0.01</radius>"
+      << "      <length>" << length * 0.9 << "</length></cylinder>"
+      << "    </geometry>"
+      << "  </collision>"
+      << "</link>"
+      << "<joint name='joint_" << i << "' type='revolute'>"
+      << "  <parent>" << (i == 0 ? std::string("world") :
+                         modelName("link", i - 1)) << "</parent>"
+      << "  <child>link_" << i << "</child>"
+      << "  <pose>0 0 " << -0.5 * length << " 0 0 0</pose>"
+      << "  <axis><xyz>0 1 0</xyz></axis>"
+      << "</joint>";
+  }
+  stream << "</model>";
+
+  physics::WorldPtr world = load_world(world_sdf(stream.str()), _result);
+  if (!world)
+    gzthrow("Unable to load the world");
+
+  _result.SetValue("links", links);
+  step_world(world, 10, scaled(2000), _result);
+}
+GZ_REGISTER_BENCHMARK(articulated_chain, articulatedChain)
+
+/////////////////////////////////////////////////
+/// \brief Drive the wheels of the robots.
+/// \param[in] _joints Wheel joints.
+/// \param[in] _step Index of the step.
+static void driveRobots(physics::Joint_V *_joints, unsigned int _step)
+{
+  // Turn in place every few seconds, so robots run into each other
+  double turn = (_step / 2000) % 2 ? -1.0 : 1.0;
+  for (unsigned int i = 0; i < _joints->size(); ++i)
+    (*_joints)[i]->SetForce(0, i % 2 ? 0.1 : 0.1 * turn);
+}
+
+/////////////////////////////////////////////////
+/// \brief Many small wheeled robots driving around.
+static void manyRobots(Result &_result)
+{
+  const unsigned int count = 100;
+  const unsigned int side = 10;
+
+  std::ostringstream stream;
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    math::Pose pose((i % side) * 1.0, (i / side) * 1.0, 0.06,
+                    0, 0, 0.3 * i);
+    stream << "<model name='" << modelName("robot", i) << "'>"
+      << "<pose>" << pose << "</pose>"
+      << "<link name='chassis'>"
+      << "  <pose>0 0 0.02 0 0 0</pose>"
+      << "  <collision name='collision'>"
+      << "    <geometry><box><size>0.3 0.2 0.05</size></box></geometry>"
+      << "  </collision>"
+      << "  <collision name='caster'>"
+      << "    <pose>-0.12 0 -0.03 0 0 0</pose>"
+      << "    <geometry><sphere><radius>0.02</radius></sphere></geometry>"
+      << "    <surface><friction><ode><mu>0</mu><mu2>0</mu2></ode>"
+      << "    </friction></surface>"
+      << "  </collision>"
+      << "</link>";
+
+    for (int side2 = 0; side2 < 2; ++side2)
+    {
+      std::string wheel = side2 ? "left_wheel" : "right_wheel";
+      stream << "<link name='" << wheel << "'>"
+        << "  <pose>0.05 " << (side2 ? 0.13 : -0.13) << " 0 1.5707 0 0"
+        << "</pose>"
+        << "  <collision name='collision'>"
+        << "    <geometry><cylinder><radius>0.05</radius>"
+        << "      <length>0.02</length></cylinder></geometry>"
+        << "  </collision>"
+        << "</link>"
+        << "<joint name='" << wheel << "_joint' type='revolute'>"
+        << "  <parent>chassis</parent>"
+        << "  <child>" << wheel << "</child>"
+        << "  <axis><xyz>0 1 0</xyz></axis>"
+        << "</joint>";
+    }
+    stream << "</model>";
+  }
+
+  physics::WorldPtr world = load_world(world_sdf(stream.str()), _result);
+  if (!world)
+    gzthrow("Unable to load the world");
+
+  physics::Joint_V joints;
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    physics::ModelPtr model = world->GetModel(modelName("robot", i));
+    if (!model)
+      gzthrow("Missing robot model");
+    joints.push_back(model->GetJoint("right_wheel_joint"));
+    joints.push_back(model->GetJoint("left_wheel_joint"));
+  }
+
+  _result.SetValue("models", count);
+  step_world(world, 10, scaled(2000), _result,
+             boost::bind(&driveRobots, &joints, _1));
+}
+GZ_REGISTER_BENCHMARK(many_robots, manyRobots)
+
+/////////////////////////////////////////////////
+/// \brief Get a field of static boxes and cylinders, 2 m apart, on a
+/// square of 20 m centered on the origin.
+/// \param[in] _count Number of obstacles.
+/// \return SDF of the models.
+static std::string obstacleField(unsigned int _count)
+{
+  std::string models;
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    math::Pose pose((i % 10) * 2.0 - 9.0, (i / 10) * 2.0 - 9.0, 0.5,
+                    0, 0, 0.1 * i);
+    models += linkModel(modelName("obstacle", i), pose,
+        i % 2 ? "<box><size>0.5 0.5 1</size></box>" :
+        "<cylinder><radius>0.25</radius><length>1</length></cylinder>",
+        true);
+  }
+  return models;
+}
+
+/////////////////////////////////////////////////
+/// \brief Lidars scanning a field of static obstacles.
+static void lidarWorld(Result &_result)
+{
+  const unsigned int lidars = 16;
+
+  std::ostringstream stream;
+  stream << obstacleField(100);
+
+  for (unsigned int i = 0; i < lidars; ++i)
+  {
+    math::Pose pose((i % 4) * 4.0 - 7.0, (i / 4) * 4.0 - 7.0, 0.5,
+                    0, 0, 0.4 * i);
+    stream << "<model name='" << modelName("lidar", i) << "'>"
+      << "<static>true</static>"
+      << "<pose>" << pose << "</pose>"
+      << "<link name='link'>"
+      << "  <sensor name='" << modelName("lidar_sensor", i) << "' type='ray'>"
+      << "    <always_on>true</always_on>"
+      << "    <update_rate>20</update_rate>"
+      << "    <ray>"
+      << "      <scan>"
+      << "        <horizontal>"
+      << "          <samples>640</samples>"
+      << "          <resolution>1</resolution>"
+      << "          <min_angle>-2.2</min_angle>"
+      << "          <max_angle>2.2</max_angle>"
+      << "        </horizontal>"
+      << "      </scan>"
+      << "      <range>"
+      << "        <min>0.1</min>"
+      << "        <max>30</max>"
+      << "        <resolution>0.01</resolution>"
+      << "      </range>"
+      << "    </ray>"
+      << "  </sensor>"
+      << "</link>"
+      << "</model>";
+  }
+
+  physics::WorldPtr world = load_world(world_sdf(stream.str()), _result);
+  if (!world)
+    gzthrow("Unable to load the world");
+
+  _result.SetValue("lidars", lidars);
+  _result.SetValue("rays_per_lidar", 640);
+  step_world(world, 10, scaled(2000), _result);
+}
+GZ_REGISTER_BENCHMARK(lidar_world, lidarWorld)
+
+/////////////////////////////////////////////////
+/// \brief A CPU depth camera looking across a field of static obstacles.
+/// Frames are traced one after the other, without stepping the world.
+static void cpuDepthCamera(Result &_result)
+{
+  const unsigned int width = 320;
+  const unsigned int height = 240;
+
+  std::ostringstream stream;
+  stream << obstacleField(100)
+    << "<model name='camera'>"
+    << "<static>true</static>"
+    << "<pose>-12 0 0.5 0 0 0</pose>"
+    << "<link name='link'>"
+    << "  <sensor name='camera_sensor' type='cpu_depth'>"
+    << "    <camera>"
+    << "      <horizontal_fov>1.047</horizontal_fov>"
+    << "      <image>"
+    << "        <width>" << width << "</width>"
+    << "        <height>" << height << "</height>"
+    << "      </image>"
+    << "      <clip>"
+    << "        <near>0.1</near>"
+    << "        <far>30</far>"
+    << "      </clip>"
+    << "    </camera>"
+    << "  </sensor>"
+    << "</link>"
+    << "</model>";
+
+  physics::WorldPtr world = load_world(world_sdf(stream.str()), _result);
+  if (!world)
+    gzthrow("Unable to load the world");
+
+  sensors::SensorPtr sensor =
+    sensors::SensorManager::Instance()->GetSensor("camera_sensor");
+  if (!sensor)
+    gzthrow("Unable to find the camera");
+
+  // The first frame copies the shapes
+  sensor->Update(true);
+
+  unsigned int frames = scaled(100);
+  common::Histogram frameTimes;
+  uint64_t start = get_time();
+  for (unsigned int i = 0; i < frames; ++i)
+  {
+    uint64_t frameStart = get_time();
+    sensor->Update(true);
+    frameTimes.Add(get_time() - frameStart);
+  }
+  double wallTime = (get_time() - start) * 1e-9;
+
+  _result.SetValue("width", width);
+  _result.SetValue("height", height);
+  _result.SetValue("frames", frames);
+  _result.SetValue("frames_per_sec", wallTime > 0 ? frames / wallTime : 0);
+  _result.SetTiming("frame", frameTimes);
+}
+GZ_REGISTER_BENCHMARK(cpu_depth_camera, cpuDepthCamera)
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+
+#include "gazebo/common/Exception.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/transport/Node.hh"
+#include "gazebo/transport/Publisher.hh"
+#include "gazebo/transport/Subscriber.hh"
+
+#include "Benchmark.hh"
+
+using namespace gazebo;
+using namespace benchmark;
+
+/// \brief Publishes messages to a subscriber of the same process, and
+/// records when each one arrives.
+class PubSubLoop
+{
+  /// \brief Constructor.
+  /// \param[in] _count Number of messages.
+  public: explicit PubSubLoop(unsigned int _count)
+          : sent(_count, 0), arrived(_count, 0), received(0)
+          {}
+
+  /// \brief Publish the messages in bursts, waiting for each burst to
+  /// arrive before the next one.
+  /// \param[in] _burst Messages per burst.
+  /// \param[out] _result Result of the benchmark.
+  public: void Run(unsigned int _burst, Result &_result)
+          {
+            transport::NodePtr node(new transport::Node());
+            node->Init();
+
+            transport::SubscriberPtr sub = node->Subscribe(
+                "~/benchmark/pubsub", &PubSubLoop::OnMsg, this);
+            transport::PublisherPtr pub =
+              node->Advertise<msgs::Int>("~/benchmark/pubsub");
+            pub->WaitForConnection();
+
+            common::Histogram latencies;
+            msgs::Int msg;
+            uint64_t start = get_time();
+            for (unsigned int i = 0; i < this->sent.size(); i += _burst)
+            {
+              unsigned int end = std::min(i + _burst,
+                  static_cast<unsigned int>(this->sent.size()));
+
+              boost::mutex::scoped_lock lock(this->mutex);
+              for (unsigned int j = i; j < end; ++j)
+              {
+                this->sent[j] = get_time();
+                msg.set_data(j);
+                pub->Publish(msg);
+              }
+
+              while (this->received < end)
+              {
+                if (!this->condition.timed_wait(lock,
+                      boost::posix_time::seconds(5)))
+                {
+                  gzthrow("Timeout waiting for messages");
+                }
+              }
+
+              for (unsigned int j = i; j < end; ++j)
+                latencies.Add(this->arrived[j] - this->sent[j]);
+            }
+            double wallTime = (get_time() - start) * 1e-9;
+
+            _result.SetValue("messages", this->sent.size());
+            _result.SetValue("wall_time", wallTime);
+            _result.SetValue("msgs_per_sec",
+                wallTime > 0 ? this->sent.size() / wallTime : 0);
+            _result.SetTiming("latency", latencies);
+
+            node->Fini();
+          }
+
+  /// \brief Record the arrival of a message.
+  /// \param[in] _msg The message.
+  private: void OnMsg(ConstIntPtr &_msg)
+           {
+             uint64_t now = get_time();
+             boost::mutex::scoped_lock lock(this->mutex);
+             if (_msg->data() >= 0 &&
+                 static_cast<size_t>(_msg->data()) < this->arrived.size())
+             {
+               this->arrived[_msg->data()] = now;
+             }
+             this->received++;
+             this->condition.notify_all();
+           }
+
+  /// \brief Time each message was published.
+  private: std::vector<uint64_t> sent;
+
+  /// \brief Time each message arrived.
+  private: std::vector<uint64_t> arrived;
+
+  /// \brief Number of messages that arrived.
+  private: unsigned int received;
+
+  /// \brief Protects the arrival times.
+  private: boost::mutex mutex;
+
+  /// \brief Signals the arrival of a message.
+  private: boost::condition condition;
+};
+
+/////////////////////////////////////////////////
+/// \brief Messages published and received by one process, through the
+/// same queues and callbacks as the messages of plugins.
+static void pubsubLoop(Result &_result)
+{
+  // The world starts the master and the transport
+  physics::WorldPtr world = load_world(world_sdf(""), _result);
+  if (!world)
+    gzthrow("Unable to load the world");
+
+  PubSubLoop loop(scaled(10000));
+  loop.Run(100, _result);
+}
+GZ_REGISTER_BENCHMARK(pubsub_loop, pubsubLoop)
@@ -81,6 +81,69 @@ TEST_F(BandwidthTest, Bandwidth)
   }
 }
 
+unsigned int g_fullBytes = 0;
+unsigned int g_compactBytes = 0;
+
+void FullPoseMsg(const std::string &_msg)
+{
+  boost::mutex::scoped_lock lock(g_mutex);
+  g_fullBytes += _msg.size();
+}
+
+void CompactPoseMsg(const std::string &_msg)
+{
+  boost::mutex::scoped_lock lock(g_mutex);
+  g_compactBytes += _msg.size();
+}
+
+/////////////////////////////////////////////////
+// Compare the bandwidth of the full and the compact pose streams while
+// 300 spheres fall from different heights.
+TEST_F(BandwidthTest, CompactPoses)
+{
+  Load("worlds/empty.world", true);
+
+  for (int i = 0; i < 300; ++i)
+  {
+    std::ostringstream name;
+    name << "sphere_" << i;
+    SpawnSphere(name.str(),
+        math::Vector3((i % 20) * 1.5, (i / 20) * 1.5, 1 + (i % 7) * 2),
+        math::Vector3(0, 0, 0), i == 299);
+  }
+
+  transport::NodePtr node(new transport::Node());
+  node->Init("default");
+
+  transport::SubscriberPtr fullSub =
+    node->Subscribe("/gazebo/default/pose/info", FullPoseMsg);
+  transport::SubscriberPtr compactSub =
+    node->Subscribe("/gazebo/default/pose/compact", CompactPoseMsg);
+
+  common::Time::MSleep(500);
+  {
+    boost::mutex::scoped_lock lock(g_mutex);
+    g_fullBytes = 0;
+    g_compactBytes = 0;
+  }
+
+  physics::WorldPtr world = physics::get_world("default");
+  world->SetPaused(false);
+  common::Time start = common::Time::GetWallTime();
+  common::Time::MSleep(2000);
+  double dt = (common::Time::GetWallTime() - start).Double();
+
+  {
+    boost::mutex::scoped_lock lock(g_mutex);
+    printf("Pose bandwidth with 300 models:\n");
+    printf("  Full[%8.2f B/s] Compact[%8.2f B/s]\n",
+           g_fullBytes / dt, g_compactBytes / dt);
+
+    EXPECT_GT(g_compactBytes, 0u);
+    EXPECT_LT(g_compactBytes, g_fullBytes);
+  }
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include "ServerFixture.hh"
+#include "sensors/sensors.hh"
+#include "common/common.hh"
+#include "physics/RayTracer.hh"
+
+#define DEPTH_TOL 1e-4
+
+using namespace gazebo;
+class CPUDepthCameraTest : public ServerFixture
+{
+  public: void SpawnCPUDepthCamera(const std::string &_modelName,
+              const std::string &_sensorName, const math::Vector3 &_pos,
+              unsigned int _width, unsigned int _height, double _far);
+};
+
+/////////////////////////////////////////////////
+void CPUDepthCameraTest::SpawnCPUDepthCamera(const std::string &_modelName,
+    const std::string &_sensorName, const math::Vector3 &_pos,
+    unsigned int _width, unsigned int _height, double _far)
+{
+  // The link has no collision, so the camera doesn't see itself
+  std::ostringstream newModelStr;
+  newModelStr << "<sdf version='" << SDF_VERSION << "'>"
+    << "<model name ='" << _modelName << "'>"
+    << "<static>true</static>"
+    << "<pose>" << _pos << " 0 0 0</pose>"
+    << "<link name ='body'>"
+    << "  <sensor name ='" << _sensorName << "' type ='cpu_depth'>"
+    << "    <camera>"
+    << "      <horizontal_fov>1.047</horizontal_fov>"
+    << "      <image>"
+    << "        <width>" << _width << "</width>"
+    << "        <height>" << _height << "</height>"
+    << "      </image>"
+    << "      <clip>"
+    << "        <near>0.1</near>"
+    << "        <far>" << _far << "</far>"
+    << "      </clip>"
+    << "    </camera>"
+    << "  </sensor>"
+    << "</link>"
+    << "</model>"
+    << "</sdf>";
+
+  SpawnSDF(newModelStr.str());
+}
+
+/////////////////////////////////////////////////
+TEST_F(CPUDepthCameraTest, Box)
+{
+  Load("worlds/empty.world", true);
+
+  unsigned int width = 320;
+  unsigned int height = 240;
+  double far = 20.0;
+  SpawnCPUDepthCamera("camera_model", "cpu_depth_sensor",
+      math::Vector3(0, 0, 0.5), width, height, far);
+  SpawnBox("box", math::Vector3(1, 1, 1), math::Vector3(2, 0, 0.5),
+      math::Vector3(0, 0, 0), true);
+
+  sensors::CPUDepthCameraSensorPtr sensor =
+    boost::static_pointer_cast<sensors::CPUDepthCameraSensor>(
+        sensors::SensorManager::Instance()->GetSensor("cpu_depth_sensor"));
+  ASSERT_TRUE(sensor);
+  sensor->Init();
+
+  // The frame time is measured by the cpu_depth_camera benchmark
+  sensor->Update(true);
+
+  ASSERT_EQ(sensor->GetImageWidth(), width);
+  ASSERT_EQ(sensor->GetImageHeight(), height);
+  const float *depths = sensor->GetDepthData();
+  ASSERT_TRUE(depths != NULL);
+
+  // The front face of the box is 1.5 m ahead, and the depth is measured
+  // along the optical axis, so it is the same over the whole face
+  EXPECT_NEAR(depths[(height / 2) * width + width / 2], 1.5, DEPTH_TOL);
+  EXPECT_NEAR(depths[(height / 2 - 10) * width + width / 2 - 10], 1.5,
+              DEPTH_TOL);
+
+  // The sky is at the far clip distance
+  EXPECT_NEAR(depths[0], far, DEPTH_TOL);
+
+  // The bottom row sees the ground plane in front of the box
+  double focal = 0.5 * width / tan(0.5 * 1.047);
+  double slope = (0.5 * height - 0.5) / focal;
+  EXPECT_NEAR(depths[(height - 1) * width + width / 2], 0.5 / slope, 1e-3);
+}
+
+/////////////////////////////////////////////////
+TEST_F(CPUDepthCameraTest, Packets)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  SpawnBox("box", math::Vector3(1, 1, 1), math::Vector3(2, 0, 0.5),
+      math::Vector3(0, 0, 0), true);
+  SpawnSphere("sphere", math::Vector3(3, 1.5, 0.5), math::Vector3(0, 0, 0),
+      true, true);
+  SpawnCylinder("cylinder", math::Vector3(3, -1.5, 0.5),
+      math::Vector3(0, 0, 0), true);
+
+  physics::RayTracer tracer(world);
+  tracer.Update();
+
+  // Fans of four rays from one origin, over the edges of the shapes
+  double origin[3] = {0, 0, 0.5};
+  for (int fan = 0; fan < 50; ++fan)
+  {
+    double dirs[12], minDist[4], dist[4];
+    for (int i = 0; i < 4; ++i)
+    {
+      double yaw = -0.8 + 0.008 * (fan * 4 + i);
+      double pitch = -0.3 + 0.01 * fan;
+      dirs[i * 3] = cos(pitch) * cos(yaw);
+      dirs[i * 3 + 1] = cos(pitch) * sin(yaw);
+      dirs[i * 3 + 2] = sin(pitch);
+      minDist[i] = 0.1;
+      dist[i] = 20;
+    }
+    tracer.IntersectPacket(origin, dirs, minDist, dist);
+
+    for (int i = 0; i < 4; ++i)
+    {
+      double single = 20;
+      tracer.Intersect(origin, dirs + i * 3, 0.1, single);
+      EXPECT_DOUBLE_EQ(dist[i], single);
+    }
+  }
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "ServerFixture.hh"
+#include "physics/physics.hh"
+#include "physics/ode/ODEPhysics.hh"
+
+using namespace gazebo;
+
+class FCLTrimeshTest : public ServerFixture
+{
+};
+
+////////////////////////////////////////////////////////////////////////
+// DropOnMesh:
+// Drop a mesh cube on a static mesh slab in a world that collides
+// meshes with FCL, and check that the cube comes to rest on top of it.
+////////////////////////////////////////////////////////////////////////
+TEST_F(FCLTrimeshTest, DropOnMesh)
+{
+  Load("worlds/fcl_trimesh.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  physics::ODEPhysicsPtr physics =
+    boost::dynamic_pointer_cast<physics::ODEPhysics>(
+        world->GetPhysicsEngine());
+  ASSERT_TRUE(physics != NULL);
+  EXPECT_TRUE(physics->GetFCLCollider() != NULL);
+
+  // The mesh is a cube from -1 to 1
+  std::string uri = std::string("file://") + TEST_PATH + "/data/box.dae";
+
+  // Slab with its top at z = 0
+  SpawnTrimesh("slab", uri, math::Vector3(5, 5, 0.5),
+      math::Vector3(0, 0, -0.5), math::Vector3(0, 0, 0), true);
+
+  // Cube with a half size of 0.25
+  SpawnTrimesh("cube", uri, math::Vector3(0.25, 0.25, 0.25),
+      math::Vector3(0, 0, 1), math::Vector3(0, 0, 0));
+
+  physics::ModelPtr cube = world->GetModel("cube");
+  ASSERT_TRUE(cube != NULL);
+
+  world->StepWorld(3000);
+
+  math::Pose pose = cube->GetWorldPose();
+  EXPECT_NEAR(pose.pos.z, 0.25, 0.02);
+  EXPECT_NEAR(pose.pos.x, 0.0, 0.02);
+  EXPECT_NEAR(pose.pos.y, 0.0, 0.02);
+  EXPECT_LT(cube->GetWorldLinearVel().GetLength(), 0.05);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ServerFixture.hh"
+#include "physics/physics.hh"
+
+using namespace gazebo;
+class JointControllerTest : public ServerFixture
+{
+  /// \brief Spawn a box on a vertical revolute joint, which gravity
+  /// doesn't turn.
+  /// \param[in] _name Name of the model.
+  /// \param[in] _y Position of the model along the y axis.
+  public: void SpawnArm(const std::string &_name, double _y);
+};
+
+/////////////////////////////////////////////////
+void JointControllerTest::SpawnArm(const std::string &_name, double _y)
+{
+  std::ostringstream modelStr;
+  modelStr
+    << "<gazebo version='" << SDF_VERSION << "'>\n"
+    << "  <model name='" << _name << "'>\n"
+    << "    <pose>0 " << _y << " 0.5 0 0 0</pose>\n"
+    << "    <link name='link'>\n"
+    << "      <inertial>\n"
+    << "        <mass>1</mass>\n"
+    << "        <inertia>\n"
+    << "          <ixx>1</ixx>\n"
+    << "          <ixy>0</ixy>\n"
+    << "          <ixz>0</ixz>\n"
+    << "          <iyy>1</iyy>\n"
+    << "          <iyz>0</iyz>\n"
+    << "          <izz>1</izz>\n"
+    << "        </inertia>\n"
+    << "      </inertial>\n"
+    << "      <collision name='collision'>\n"
+    << "        <geometry>\n"
+    << "          <box><size>0.5 0.1 0.1</size></box>\n"
+    << "        </geometry>\n"
+    << "      </collision>\n"
+    << "    </link>\n"
+    << "    <joint name='joint' type='revolute'>\n"
+    << "      <parent>world</parent>\n"
+    << "      <child>link</child>\n"
+    << "      <axis>\n"
+    << "        <xyz>0 0 1</xyz>\n"
+    << "      </axis>\n"
+    << "    </joint>\n"
+    << "  </model>\n"
+    << "</gazebo>\n";
+  SpawnSDF(modelStr.str());
+}
+
+/////////////////////////////////////////////////
+TEST_F(JointControllerTest, JointIndex)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  SpawnArm("arm", 0);
+  physics::ModelPtr model = world->GetModel("arm");
+  ASSERT_TRUE(model != NULL);
+  physics::JointControllerPtr controller = model->GetJointController();
+  ASSERT_TRUE(controller != NULL);
+
+  EXPECT_EQ(controller->GetJointCount(), 1u);
+  EXPECT_EQ(controller->GetJointIndex("arm::joint"), 0);
+  EXPECT_EQ(controller->GetJointIndex("joint"), -1);
+  EXPECT_EQ(controller->GetJointIndex("arm::missing"), -1);
+  EXPECT_TRUE(controller->GetJoint(0) == model->GetJoint("joint"));
+  EXPECT_TRUE(controller->GetJoint(1) == NULL);
+
+  // Invalid indices are ignored
+  controller->SetForce(1, 1.0);
+  controller->SetPositionTarget(1, 1.0);
+  controller->SetVelocityTarget(1, 1.0);
+  controller->ClearCommands(1);
+  world->StepWorld(10);
+  EXPECT_NEAR(model->GetJoint("joint")->GetVelocity(0), 0.0, 1e-6);
+}
+
+/////////////////////////////////////////////////
+TEST_F(JointControllerTest, SumOfCommands)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  // The same arm driven by a force, a velocity PID, and both
+  SpawnArm("force", 0);
+  SpawnArm("velocity", 2);
+  SpawnArm("both", 4);
+
+  std::vector<physics::ModelPtr> models;
+  models.push_back(world->GetModel("force"));
+  models.push_back(world->GetModel("velocity"));
+  models.push_back(world->GetModel("both"));
+  for (unsigned int i = 0; i < models.size(); ++i)
+    ASSERT_TRUE(models[i] != NULL);
+
+  physics::JointControllerPtr force = models[0]->GetJointController();
+  physics::JointControllerPtr velocity = models[1]->GetJointController();
+  physics::JointControllerPtr both = models[2]->GetJointController();
+
+  force->SetForce(force->GetJointIndex("force::joint"), 2.0);
+  velocity->SetVelocityTarget(
+      velocity->GetJointIndex("velocity::joint"), 0.0);
+  int index = both->GetJointIndex("both::joint");
+  both->SetForce(index, 2.0);
+  both->SetVelocityTarget(index, 0.0);
+
+  world->StepWorld(1000);
+
+  double forceVel = models[0]->GetJoint("joint")->GetVelocity(0);
+  double velocityVel = models[1]->GetJoint("joint")->GetVelocity(0);
+  double bothVel = models[2]->GetJoint("joint")->GetVelocity(0);
+
+  // A torque of 2 accelerates the arm to 2 rad/s in one second
+  EXPECT_NEAR(forceVel, 2.0, 0.1);
+  EXPECT_NEAR(velocityVel, 0.0, 1e-6);
+
+  // The PID holds the arm back, but doesn't cancel the force
+  EXPECT_GT(bothVel, velocityVel + 0.1);
+  EXPECT_LT(bothVel, forceVel - 0.1);
+
+  // Without commands, nothing slows the arm down
+  both->ClearCommands(index);
+  world->StepWorld(100);
+  EXPECT_NEAR(models[2]->GetJoint("joint")->GetVelocity(0), bothVel, 0.01);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
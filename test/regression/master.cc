@@ -0,0 +1,348 @@
+/*
+ * Copyright 2013 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <boost/thread.hpp>
+
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/transport/Connection.hh"
+#include "gazebo/Master.hh"
+
+using namespace gazebo;
+
+/// \brief Port of the master under test, away from the default port.
+static const unsigned int g_masterPort = 11399;
+
+/// \brief Stand-in for the ConnectionManager of a gazebo process. It
+/// counts the messages that the master sends.
+class MasterClient
+{
+  /// \brief Constructor
+  /// \param[in] _batch True to ask for batched updates, false to behave
+  /// like an older client.
+  public: explicit MasterClient(bool _batch = true)
+          : conn(new transport::Connection()), batch(_batch),
+            publishersAdded(0), publishersRemoved(0), publisherUpdates(0),
+            namespaces(0), listSize(-1)
+          {
+          }
+
+  /// \brief Connect to the master and read the initial state.
+  /// \return True on success.
+  public: bool Connect()
+          {
+            if (!this->conn->Connect("localhost", g_masterPort))
+              return false;
+
+            std::string version, namespacesInit, publishersInit;
+            this->conn->Read(version);
+            this->conn->Read(namespacesInit);
+            this->conn->Read(publishersInit);
+
+            msgs::Packet packet;
+            packet.ParseFromString(publishersInit);
+            if (packet.type() != "publishers_init")
+              return false;
+
+            this->conn->AsyncRead(
+                boost::bind(&MasterClient::OnRead, this, _1));
+
+            if (this->batch)
+            {
+              msgs::Request *request =
+                msgs::CreateRequest("enable_batch_updates");
+              this->Send("request", *request);
+              delete request;
+            }
+            return true;
+          }
+
+  /// \brief Send a message to the master.
+  /// \param[in] _type Type of the message.
+  /// \param[in] _msg The message.
+  public: void Send(const std::string &_type,
+                    const google::protobuf::Message &_msg)
+          {
+            this->conn->EnqueueMsg(msgs::Package(_type, _msg), true);
+          }
+
+  /// \brief Topic name used by the test.
+  /// \param[in] _index Index of the topic.
+  /// \return Name of the topic.
+  public: static std::string Topic(int _index)
+          {
+            std::ostringstream topic;
+            topic << "/gazebo/default/test_" << _index;
+            return topic.str();
+          }
+
+  /// \brief Advertise a topic from this client.
+  /// \param[in] _index Index of the topic.
+  /// \param[in] _type Type of the message, advertise or unadvertise.
+  public: void Advertise(int _index, const std::string &_type = "advertise")
+          {
+            msgs::Publish pub;
+            pub.set_topic(Topic(_index));
+            pub.set_msg_type("gazebo.msgs.Pose");
+            pub.set_host(this->conn->GetLocalAddress());
+            pub.set_port(20000 + _index % 1000);
+            this->Send(_type, pub);
+          }
+
+  /// \brief Subscribe to a topic from this client.
+  /// \param[in] _index Index of the topic.
+  public: void Subscribe(int _index)
+          {
+            msgs::Subscribe sub;
+            sub.set_topic(Topic(_index));
+            sub.set_msg_type("gazebo.msgs.Pose");
+            sub.set_host(this->conn->GetLocalAddress());
+            sub.set_port(30000 + _index % 1000);
+            this->Send("subscribe", sub);
+          }
+
+  /// \brief Wait until a condition on the counters holds.
+  /// \param[in] _added Expected number of publishers added.
+  /// \param[in] _removed Expected number of publishers removed.
+  /// \param[in] _updates Expected number of publisher updates.
+  /// \return True if the counters were reached within ten seconds.
+  public: bool WaitFor(int _added, int _removed, int _updates)
+          {
+            for (int i = 0; i < 1000; ++i)
+            {
+              {
+                boost::mutex::scoped_lock lock(this->mutex);
+                if (this->publishersAdded >= _added &&
+                    this->publishersRemoved >= _removed &&
+                    this->publisherUpdates >= _updates)
+                {
+                  return true;
+                }
+              }
+              common::Time::MSleep(10);
+            }
+            return false;
+          }
+
+  /// \brief Count a message from the master.
+  /// \param[in] _data The message.
+  private: void OnRead(const std::string &_data)
+           {
+             if (this->conn->IsOpen())
+             {
+               this->conn->AsyncRead(
+                   boost::bind(&MasterClient::OnRead, this, _1));
+             }
+
+             msgs::Packet packet;
+             packet.ParseFromString(_data);
+
+             boost::mutex::scoped_lock lock(this->mutex);
+             ++this->messages[packet.type()];
+
+             if (packet.type() == "publishers_add" ||
+                 packet.type() == "publishers_del" ||
+                 packet.type() == "publisher_list")
+             {
+               msgs::Publishers pubs;
+               pubs.ParseFromString(packet.serialized_data());
+               if (packet.type() == "publishers_add")
+                 this->publishersAdded += pubs.publisher_size();
+               else if (packet.type() == "publishers_del")
+                 this->publishersRemoved += pubs.publisher_size();
+               else
+                 this->listSize = pubs.publisher_size();
+             }
+             else if (packet.type() == "publisher_add")
+               ++this->publishersAdded;
+             else if (packet.type() == "publisher_del")
+               ++this->publishersRemoved;
+             else if (packet.type() == "publisher_update")
+               ++this->publisherUpdates;
+             else if (packet.type() == "topic_namespaces_add" ||
+                      packet.type() == "topic_namespace_add")
+             {
+               ++this->namespaces;
+             }
+           }
+
+  /// \brief Connection to the master.
+  public: transport::ConnectionPtr conn;
+
+  /// \brief True if the client asked for batched updates.
+  public: bool batch;
+
+  /// \brief Protects the counters.
+  public: boost::mutex mutex;
+
+  /// \brief Number of messages of each type.
+  public: std::map<std::string, int> messages;
+
+  /// \brief Number of publishers added, one per publisher_add message or
+  /// several per publishers_add message.
+  public: int publishersAdded;
+
+  /// \brief Number of publishers removed, one per publisher_del message
+  /// or several per publishers_del message.
+  public: int publishersRemoved;
+
+  /// \brief Number of publisher_update messages.
+  public: int publisherUpdates;
+
+  /// \brief Number of topic_namespaces_add and topic_namespace_add
+  /// messages.
+  public: int namespaces;
+
+  /// \brief Size of the last publisher list, -1 if none was received.
+  public: int listSize;
+};
+
+/////////////////////////////////////////////////
+// Simulate the startup of many processes that advertise and subscribe to
+// thousands of topics.
+TEST(MasterTest, ManyTopics)
+{
+  Master *master = new Master();
+  master->Init(g_masterPort);
+  master->RunThread();
+
+  MasterClient publisher, subscriber;
+  ASSERT_TRUE(publisher.Connect());
+  ASSERT_TRUE(subscriber.Connect());
+
+  const int count = 5000;
+  common::Time start = common::Time::GetWallTime();
+
+  msgs::GzString ns;
+  ns.set_data("default");
+  publisher.Send("register_topic_namespace", ns);
+
+  // Subscribe to half of the topics before they are advertised, and to
+  // the other half after
+  for (int i = 0; i < count; i += 2)
+    subscriber.Subscribe(i);
+  for (int i = 0; i < count; ++i)
+    publisher.Advertise(i);
+  for (int i = 1; i < count; i += 2)
+    subscriber.Subscribe(i);
+
+  // Every publisher is announced to both clients, and every subscription
+  // gets its publisher
+  EXPECT_TRUE(publisher.WaitFor(count, 0, 0));
+  EXPECT_TRUE(subscriber.WaitFor(count, 0, count));
+
+  std::cout << "Processed " << count * 2 << " advertise and subscribe "
+            << "messages in " << common::Time::GetWallTime() - start
+            << " seconds\n";
+
+  {
+    boost::mutex::scoped_lock lock(subscriber.mutex);
+    EXPECT_EQ(count, subscriber.publishersAdded);
+    EXPECT_EQ(count, subscriber.publisherUpdates);
+
+    // Changes are sent in batches, not one message per publisher
+    EXPECT_LT(subscriber.messages["publishers_add"], count / 10);
+    EXPECT_EQ(1, subscriber.namespaces);
+  }
+
+  // Remove half of the publishers
+  for (int i = 0; i < count; i += 2)
+    publisher.Advertise(i, "unadvertise");
+  EXPECT_TRUE(subscriber.WaitFor(count, count / 2, count));
+
+  {
+    boost::mutex::scoped_lock lock(subscriber.mutex);
+    EXPECT_EQ(count / 2, subscriber.messages["unadvertise"]);
+  }
+
+  // The master only knows about the remaining publishers
+  msgs::Request *request = msgs::CreateRequest("get_publishers");
+  subscriber.Send("request", *request);
+  delete request;
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    boost::mutex::scoped_lock lock(subscriber.mutex);
+    if (subscriber.listSize >= 0)
+      break;
+    lock.unlock();
+    common::Time::MSleep(10);
+  }
+  EXPECT_EQ(count / 2, subscriber.listSize);
+
+  publisher.conn->Shutdown();
+  subscriber.conn->Shutdown();
+  master->Fini();
+  delete master;
+}
+
+/////////////////////////////////////////////////
+// Clients that don't ask for batched updates get one message per change.
+TEST(MasterTest, OlderClients)
+{
+  Master *master = new Master();
+  master->Init(g_masterPort);
+  master->RunThread();
+
+  MasterClient publisher(false), older(false), newer;
+  ASSERT_TRUE(publisher.Connect());
+  ASSERT_TRUE(older.Connect());
+  ASSERT_TRUE(newer.Connect());
+
+  msgs::GzString ns;
+  ns.set_data("default");
+  publisher.Send("register_topic_namespace", ns);
+
+  const int count = 100;
+  for (int i = 0; i < count; ++i)
+    publisher.Advertise(i);
+  for (int i = 0; i < count; i += 2)
+    publisher.Advertise(i, "unadvertise");
+
+  EXPECT_TRUE(older.WaitFor(count, count / 2, 0));
+  EXPECT_TRUE(newer.WaitFor(count, count / 2, 0));
+
+  {
+    boost::mutex::scoped_lock lock(older.mutex);
+    EXPECT_EQ(count, older.messages["publisher_add"]);
+    EXPECT_EQ(count / 2, older.messages["publisher_del"]);
+    EXPECT_EQ(1, older.messages["topic_namespace_add"]);
+    EXPECT_EQ(0, older.messages["publishers_add"]);
+    EXPECT_EQ(0, older.messages["topic_namespaces_add"]);
+  }
+
+  {
+    boost::mutex::scoped_lock lock(newer.mutex);
+    EXPECT_EQ(count, newer.publishersAdded);
+    EXPECT_EQ(count / 2, newer.publishersRemoved);
+    EXPECT_EQ(0, newer.messages["publisher_add"]);
+    EXPECT_EQ(1, newer.namespaces);
+  }
+
+  publisher.conn->Shutdown();
+  older.conn->Shutdown();
+  newer.conn->Shutdown();
+  master->Fini();
+  delete master;
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -31,6 +31,7 @@ class PhysicsTest : public ServerFixture
   public: void RevoluteJoint(const std::string &_physicsEngine);
   public: void SimplePendulum(const std::string &_physicsEngine);
   public: void CollisionFiltering(const std::string &_physicsEngine);
+  public: void ContinuousCollision(const std::string &_physicsEngine);
 };
 
 ////////////////////////////////////////////////////////////////////////
@@ -1524,6 +1525,313 @@ TEST_F(PhysicsTest, CollisionFilteringBullet)
 }
 #endif  // HAVE_BULLET
 
+////////////////////////////////////////////////////////////////////////
+// ContinuousCollision:
+// Throw a small sphere at 100 m/s toward a 1 cm thick wall. It moves
+// further than its own size in each step, so it only stops at the wall if
+// its motion is swept.
+////////////////////////////////////////////////////////////////////////
+void PhysicsTest::ContinuousCollision(const std::string &_physicsEngine)
+{
+  Load("worlds/empty.world", true, _physicsEngine);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  std::ostringstream wallStr;
+  wallStr << "<sdf version='" << SDF_VERSION << "'>"
+          << "<model name ='wall'>"
+          << "<static>true</static>"
+          << "<pose>1 0 1 0 0 0</pose>"
+          << "<link name ='link'>"
+          << "  <collision name ='geom'>"
+          << "    <geometry><box><size>0.01 2 2</size></box></geometry>"
+          << "  </collision>"
+          << "</link>"
+          << "</model>"
+          << "</sdf>";
+  SpawnSDF(wallStr.str());
+
+  std::ostringstream sphereStr;
+  sphereStr << "<sdf version='" << SDF_VERSION << "'>"
+            << "<model name ='sphere'>"
+            << "<pose>0.05 0 1 0 0 0</pose>"
+            << "<link name ='link'>"
+            << "  <gravity>false</gravity>"
+            << "  <ccd>"
+            << "    <velocity_threshold>1.0</velocity_threshold>"
+            << "    <swept_sphere_radius>0.02</swept_sphere_radius>"
+            << "  </ccd>"
+            << "  <collision name ='geom'>"
+            << "    <geometry><sphere><radius>0.02</radius></sphere></geometry>"
+            << "  </collision>"
+            << "</link>"
+            << "</model>"
+            << "</sdf>";
+  SpawnSDF(sphereStr.str());
+
+  physics::ModelPtr sphere = world->GetModel("sphere");
+  ASSERT_TRUE(sphere != NULL);
+  ASSERT_NEAR(world->GetPhysicsEngine()->GetMaxStepSize(), 0.001, 1e-9);
+
+  sphere->GetLink("link")->SetLinearVel(math::Vector3(100, 0, 0));
+  world->StepWorld(50);
+
+  // The sphere stays in front of the wall
+  EXPECT_LT(sphere->GetWorldPose().pos.x, 1.0);
+  EXPECT_GT(sphere->GetWorldPose().pos.x, 0.9);
+}
+
+TEST_F(PhysicsTest, ContinuousCollisionODE)
+{
+  ContinuousCollision("ode");
+}
+
+#ifdef HAVE_BULLET
+TEST_F(PhysicsTest, ContinuousCollisionBullet)
+{
+  ContinuousCollision("bullet");
+}
+#endif  // HAVE_BULLET
+
+////////////////////////////////////////////////////////////////////////
+// BatchWorlds:
+// Load several copies of a world with a falling box in one process, and
+// step all of them in parallel.
+////////////////////////////////////////////////////////////////////////
+TEST_F(PhysicsTest, BatchWorlds)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr defaultWorld = physics::get_world("default");
+  ASSERT_TRUE(defaultWorld != NULL);
+
+  // Worlds running in their own threads can't be stepped in a batch
+  EXPECT_FALSE(physics::step_worlds(1));
+  // Stop the thread of the default world, so it is stepped in the batch
+  defaultWorld->Stop();
+
+  const int worldCount = 4;
+  std::vector<physics::WorldPtr> worlds;
+  for (int i = 0; i < worldCount; ++i)
+  {
+    std::ostringstream worldStr;
+    worldStr << "<sdf version='" << SDF_VERSION << "'>"
+             << "<world name='batch_" << i << "'>"
+             << "<model name='box'>"
+             << "<pose>0 0 " << 10 + i << " 0 0 0</pose>"
+             << "<link name='link'>"
+             << "  <collision name='geom'>"
+             << "    <geometry><box><size>1 1 1</size></box></geometry>"
+             << "  </collision>"
+             << "</link>"
+             << "</model>"
+             << "</world>"
+             << "</sdf>";
+
+    sdf::SDFPtr worldSDF(new sdf::SDF);
+    sdf::init(worldSDF);
+    ASSERT_TRUE(sdf::readString(worldStr.str(), worldSDF));
+
+    physics::WorldPtr world = physics::create_world();
+    physics::load_world(world, worldSDF->root->GetElement("world"));
+    physics::init_world(world);
+    worlds.push_back(world);
+  }
+
+  uint64_t defaultIterations = defaultWorld->GetIterations();
+  EXPECT_TRUE(physics::step_worlds(100));
+  EXPECT_TRUE(physics::step_worlds(100));
+  EXPECT_EQ(defaultIterations + 200, defaultWorld->GetIterations());
+
+  // All the boxes fall the same distance
+  double dt = worlds[0]->GetPhysicsEngine()->GetMaxStepSize();
+  for (int i = 0; i < worldCount; ++i)
+  {
+    EXPECT_EQ(200u, worlds[i]->GetIterations());
+    EXPECT_NEAR(200 * dt, worlds[i]->GetSimTime().Double(), 1e-9);
+
+    physics::ModelPtr box = worlds[i]->GetModel("box");
+    ASSERT_TRUE(box != NULL);
+    EXPECT_NEAR(box->GetWorldPose().pos.z - (10 + i),
+                worlds[0]->GetModel("box")->GetWorldPose().pos.z - 10, 1e-9);
+    EXPECT_LT(box->GetWorldPose().pos.z, 10 + i - 0.1);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+// BatchWorldsSensors:
+// Step worlds with different step sizes in batches, and check that the
+// sensors of each world follow the sim time of their own world.
+////////////////////////////////////////////////////////////////////////
+TEST_F(PhysicsTest, BatchWorldsSensors)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr defaultWorld = physics::get_world("default");
+  ASSERT_TRUE(defaultWorld != NULL);
+  defaultWorld->Stop();
+
+  const int worldCount = 3;
+  std::vector<physics::WorldPtr> worlds;
+  std::vector<std::string> sensorNames;
+  for (int i = 0; i < worldCount; ++i)
+  {
+    std::ostringstream worldName;
+    worldName << "batch_sensors_" << i;
+
+    std::ostringstream worldStr;
+    worldStr << "<sdf version='" << SDF_VERSION << "'>"
+             << "<world name='" << worldName.str() << "'>"
+             << "<physics type='ode'>"
+             << "  <max_step_size>" << 0.001 * (i + 1) << "</max_step_size>"
+             << "</physics>"
+             << "<model name='model'>"
+             << "<static>true</static>"
+             << "<link name='link'>"
+             << "  <sensor name='imu' type='imu'>"
+             << "    <always_on>true</always_on>"
+             << "    <update_rate>100</update_rate>"
+             << "    <imu></imu>"
+             << "  </sensor>"
+             << "</link>"
+             << "</model>"
+             << "</world>"
+             << "</sdf>";
+
+    sdf::SDFPtr worldSDF(new sdf::SDF);
+    sdf::init(worldSDF);
+    ASSERT_TRUE(sdf::readString(worldStr.str(), worldSDF));
+
+    physics::WorldPtr world = physics::create_world();
+    physics::load_world(world, worldSDF->root->GetElement("world"));
+    physics::init_world(world);
+    worlds.push_back(world);
+    sensorNames.push_back(worldName.str() + "::model::link::imu");
+  }
+
+  // Without a name, the world to get is ambiguous
+  EXPECT_THROW(physics::get_world(), common::Exception);
+
+  // Wait for the server to initialize the sensors
+  std::vector<sensors::SensorPtr> imus;
+  for (int i = 0; i < worldCount; ++i)
+  {
+    sensors::SensorPtr imu = sensors::get_sensor(sensorNames[i]);
+    for (int j = 0; j < 500 && !imu; ++j)
+    {
+      common::Time::MSleep(10);
+      imu = sensors::get_sensor(sensorNames[i]);
+    }
+    ASSERT_TRUE(imu != NULL);
+    EXPECT_EQ(imu->GetWorldName(), worlds[i]->GetName());
+    imus.push_back(imu);
+  }
+
+  // Step in small batches, so that the sensor thread keeps up
+  for (int i = 0; i < 200; ++i)
+  {
+    EXPECT_TRUE(physics::step_worlds(1));
+    common::Time::MSleep(1);
+  }
+
+  // Each world advanced by its own step size, and its sensor followed
+  for (int i = 0; i < worldCount; ++i)
+  {
+    double simTime = 0.2 * (i + 1);
+    EXPECT_NEAR(worlds[i]->GetSimTime().Double(), simTime, 1e-9);
+
+    for (int j = 0; j < 100 &&
+         imus[i]->GetLastUpdateTime().Double() < simTime - 0.025; ++j)
+    {
+      common::Time::MSleep(10);
+    }
+    EXPECT_GT(imus[i]->GetLastUpdateTime().Double(), simTime - 0.025);
+    EXPECT_LE(imus[i]->GetLastUpdateTime().Double(), simTime + 1e-9);
+  }
+
+  // Only the first world steps, so only its sensor advances
+  common::Time lastUpdate = imus[1]->GetLastUpdateTime();
+  for (int i = 0; i < 100; ++i)
+  {
+    EXPECT_TRUE(worlds[0]->RunBatch(1));
+    common::Time::MSleep(1);
+  }
+
+  EXPECT_NEAR(worlds[0]->GetSimTime().Double(), 0.3, 1e-9);
+  for (int j = 0; j < 100 &&
+       imus[0]->GetLastUpdateTime().Double() < 0.3 - 0.025; ++j)
+  {
+    common::Time::MSleep(10);
+  }
+  EXPECT_GT(imus[0]->GetLastUpdateTime().Double(), 0.3 - 0.025);
+  EXPECT_EQ(imus[1]->GetLastUpdateTime(), lastUpdate);
+  EXPECT_NEAR(worlds[1]->GetSimTime().Double(), 0.4, 1e-9);
+}
+
+////////////////////////////////////////////////////////////////////////
+// SnapshotRestore:
+// Drop tumbling boxes, snapshot the world, and check that stepping from
+// the restored snapshot repeats the same motion.
+////////////////////////////////////////////////////////////////////////
+TEST_F(PhysicsTest, SnapshotRestore)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  SpawnBox("box_0", math::Vector3(1, 1, 1), math::Vector3(0, 0, 1),
+           math::Vector3(0.3, 0.2, 0.1));
+  SpawnBox("box_1", math::Vector3(0.5, 0.5, 0.5), math::Vector3(0.2, 0, 2),
+           math::Vector3(0, 0.7, 0));
+  SpawnSphere("sphere", math::Vector3(-0.1, 0.1, 3), math::Vector3(0, 0, 0));
+
+  std::vector<physics::ModelPtr> models;
+  models.push_back(world->GetModel("box_0"));
+  models.push_back(world->GetModel("box_1"));
+  models.push_back(world->GetModel("sphere"));
+  for (unsigned int i = 0; i < models.size(); ++i)
+    ASSERT_TRUE(models[i] != NULL);
+
+  world->StepWorld(100);
+
+  common::SnapshotBuffer snapshot;
+  world->Snapshot(snapshot);
+  common::Time snapshotTime = world->GetSimTime();
+  uint64_t snapshotIterations = world->GetIterations();
+
+  // Run twice from the snapshot
+  std::vector<math::Pose> poses[2];
+  std::vector<math::Vector3> vels[2];
+  double random[2];
+  for (int run = 0; run < 2; ++run)
+  {
+    EXPECT_TRUE(world->Restore(snapshot));
+    EXPECT_EQ(snapshotTime, world->GetSimTime());
+    EXPECT_EQ(snapshotIterations, world->GetIterations());
+    random[run] = math::Rand::GetDblUniform();
+
+    world->StepWorld(500);
+    for (unsigned int i = 0; i < models.size(); ++i)
+    {
+      poses[run].push_back(models[i]->GetWorldPose());
+      vels[run].push_back(models[i]->GetWorldLinearVel());
+    }
+  }
+
+  EXPECT_DOUBLE_EQ(random[0], random[1]);
+  for (unsigned int i = 0; i < models.size(); ++i)
+  {
+    EXPECT_EQ(poses[0][i], poses[1][i]);
+    EXPECT_EQ(vels[0][i], vels[1][i]);
+  }
+
+  // The boxes moved after the snapshot, and are back where they were
+  EXPECT_TRUE(world->Restore(snapshot));
+  EXPECT_NE(poses[0][1], models[1]->GetWorldPose());
+
+  // Snapshots don't apply once models are added
+  SpawnSphere("sphere_2", math::Vector3(3, 0, 1), math::Vector3(0, 0, 0));
+  EXPECT_FALSE(world->Restore(snapshot));
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -16,7 +16,11 @@
 */
 
 #include <unistd.h>
+#include <string>
+#include <vector>
+
 #include "ServerFixture.hh"
+#include "gazebo/transport/SubscriptionTransport.hh"
 
 using namespace gazebo;
 
@@ -53,6 +57,40 @@ void ReceiveWorldStatsDebugMsg(ConstGzStringPtr &/*_data*/)
   g_worldStatsDebugMsg = true;
 }
 
+/// \brief Records the messages delivered to a subscription with limits.
+class LimitsReceiver
+{
+  /// \brief Callback of the subscription.
+  /// \param[in] _msg The delivered message.
+  public: void OnMsg(ConstGzStringPtr &_msg)
+          {
+            this->received.push_back(_msg->data());
+          }
+
+  /// \brief Data of the delivered messages, in order.
+  public: std::vector<std::string> received;
+};
+
+/// \brief Connection accepted by the publisher side of a test.
+transport::ConnectionPtr g_acceptedConn;
+
+void OnAccept(const transport::ConnectionPtr &_conn)
+{
+  g_acceptedConn = _conn;
+}
+
+/// \brief Serialize a string message.
+/// \param[in] _data Data of the message.
+/// \return The serialized message.
+std::string SerializedString(const std::string &_data)
+{
+  msgs::GzString msg;
+  msg.set_data(_data);
+  std::string result;
+  msg.SerializeToString(&result);
+  return result;
+}
+
 
 TEST_F(TransportTest, Load)
 {
@@ -163,6 +201,172 @@ TEST_F(TransportTest, Errors)
   testNode.reset();
 }
 
+/////////////////////////////////////////////////
+TEST_F(TransportTest, QueueDepth)
+{
+  Load("worlds/empty.world");
+  transport::NodePtr node(new transport::Node());
+  node->Init("default");
+  std::string topic = node->DecodeTopicName("~/queue_depth");
+
+  LimitsReceiver limited, latest;
+  transport::SubscribeOptions ops;
+  ops.SetQueueDepth(3);
+  EXPECT_EQ(ops.GetQueueDepth(), 3u);
+  EXPECT_FALSE(ops.GetKeepLatest());
+  transport::SubscriberPtr sub = node->Subscribe("~/queue_depth",
+      &LimitsReceiver::OnMsg, &limited, ops);
+
+  // Messages are delivered by the test only
+  transport::pause_incoming(true);
+  common::Time::MSleep(100);
+
+  // Only the newest messages of a remote publisher are kept
+  for (int i = 0; i < 10; ++i)
+  {
+    std::ostringstream data;
+    data << i;
+    node->HandleData(topic, SerializedString(data.str()));
+  }
+  node->ProcessIncoming();
+  ASSERT_EQ(limited.received.size(), 3u);
+  EXPECT_EQ(limited.received[0], "7");
+  EXPECT_EQ(limited.received[2], "9");
+
+  // Keep-latest is a depth of one, and local messages are trimmed too
+  limited.received.clear();
+  sub.reset();
+  ops.SetKeepLatest(true);
+  EXPECT_TRUE(ops.GetKeepLatest());
+  EXPECT_EQ(ops.GetQueueDepth(), 1u);
+  sub = node->Subscribe("~/queue_depth", &LimitsReceiver::OnMsg, &latest,
+      ops);
+  for (int i = 0; i < 10; ++i)
+  {
+    boost::shared_ptr<msgs::GzString> msg(new msgs::GzString);
+    std::ostringstream data;
+    data << i;
+    msg->set_data(data.str());
+    node->HandleMessage(topic, msg);
+  }
+  node->ProcessIncoming();
+  ASSERT_EQ(latest.received.size(), 1u);
+  EXPECT_EQ(latest.received[0], "9");
+  EXPECT_TRUE(limited.received.empty());
+
+  // A callback without limits gets every message
+  LimitsReceiver all;
+  transport::SubscriberPtr allSub = node->Subscribe("~/queue_depth",
+      &LimitsReceiver::OnMsg, &all, transport::SubscribeOptions());
+  latest.received.clear();
+  for (int i = 0; i < 10; ++i)
+    node->HandleData(topic, SerializedString("data"));
+  node->ProcessIncoming();
+  EXPECT_EQ(all.received.size(), 10u);
+  EXPECT_EQ(latest.received.size(), 10u);
+
+  transport::pause_incoming(false);
+  sub.reset();
+  allSub.reset();
+  node.reset();
+}
+
+/////////////////////////////////////////////////
+TEST_F(TransportTest, MaxRate)
+{
+  Load("worlds/empty.world");
+  transport::NodePtr node(new transport::Node());
+  node->Init("default");
+  std::string topic = node->DecodeTopicName("~/max_rate");
+
+  LimitsReceiver receiver;
+  transport::SubscribeOptions ops;
+  ops.SetMaxRate(10);
+  EXPECT_DOUBLE_EQ(ops.GetMaxRate(), 10);
+  transport::SubscriberPtr sub = node->Subscribe("~/max_rate",
+      &LimitsReceiver::OnMsg, &receiver, ops);
+  EXPECT_DOUBLE_EQ(node->GetMaxRate(topic), 10);
+
+  transport::pause_incoming(true);
+  common::Time::MSleep(100);
+
+  // The first message goes through
+  node->HandleData(topic, SerializedString("0"));
+  node->ProcessIncoming();
+  ASSERT_EQ(receiver.received.size(), 1u);
+
+  // The next ones wait for the period, and only the newest is delivered
+  node->HandleData(topic, SerializedString("1"));
+  node->HandleData(topic, SerializedString("2"));
+  node->ProcessIncoming();
+  EXPECT_EQ(receiver.received.size(), 1u);
+
+  common::Time::MSleep(150);
+  node->ProcessIncoming();
+  ASSERT_EQ(receiver.received.size(), 2u);
+  EXPECT_EQ(receiver.received[1], "2");
+
+  // A callback without a rate lifts the limit of the topic
+  LimitsReceiver all;
+  transport::SubscriberPtr allSub = node->Subscribe("~/max_rate",
+      &LimitsReceiver::OnMsg, &all, transport::SubscribeOptions());
+  EXPECT_DOUBLE_EQ(node->GetMaxRate(topic), 0);
+  allSub.reset();
+  EXPECT_DOUBLE_EQ(node->GetMaxRate(topic), 10);
+
+  transport::pause_incoming(false);
+  sub.reset();
+  node.reset();
+}
+
+/////////////////////////////////////////////////
+TEST_F(TransportTest, PublisherThrottling)
+{
+  Load("worlds/empty.world");
+
+  // Publisher side of a remote subscription
+  transport::ConnectionPtr server(new transport::Connection());
+  server->Listen(11397, &OnAccept);
+  transport::ConnectionPtr client(new transport::Connection());
+  ASSERT_TRUE(client->Connect("localhost", 11397));
+  for (int i = 0; i < 100 && !g_acceptedConn; ++i)
+    common::Time::MSleep(10);
+  ASSERT_TRUE(g_acceptedConn != NULL);
+
+  transport::SubscriptionTransportPtr subTransport(
+      new transport::SubscriptionTransport());
+  subTransport->Init(g_acceptedConn, false);
+  subTransport->SetMaxRate(10);
+
+  // Messages sent within the period are skipped, but still handled
+  for (int i = 0; i < 20; ++i)
+  {
+    std::ostringstream data;
+    data << i;
+    EXPECT_TRUE(subTransport->HandleData(SerializedString(data.str())));
+  }
+  g_acceptedConn->ProcessWriteQueue(true);
+
+  common::Time::MSleep(150);
+  EXPECT_TRUE(subTransport->HandleData(SerializedString("late")));
+  g_acceptedConn->ProcessWriteQueue(true);
+
+  // Only the first and the late message crossed the connection
+  std::string data;
+  msgs::GzString msg;
+  ASSERT_TRUE(client->Read(data));
+  msg.ParseFromString(data);
+  EXPECT_EQ(msg.data(), "0");
+  ASSERT_TRUE(client->Read(data));
+  msg.ParseFromString(data);
+  EXPECT_EQ(msg.data(), "late");
+
+  subTransport.reset();
+  g_acceptedConn.reset();
+  client.reset();
+  server.reset();
+}
+
 // This test creates a child process to test interprocess communication
 // TODO: This test needs to be fixed
 /*TEST_F(TransportTest, Processes)
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2012 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <stdint.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+
+#include "ServerFixture.hh"
+#include "common/Common.hh"
+#include "common/Mesh.hh"
+#include "common/MeshManager.hh"
+#include "physics/physics.hh"
+
+using namespace gazebo;
+
+class TrimeshMemoryTest : public ServerFixture
+{
+  public: void ManyInstances(const std::string &_physicsEngine);
+};
+
+/////////////////////////////////////////////////
+// Get the resident set size of this process in bytes, or 0 if it is not
+// available.
+static uint64_t getResidentMemory()
+{
+  std::ifstream statm("/proc/self/statm");
+  uint64_t size = 0, resident = 0;
+  if (!(statm >> size >> resident))
+    return 0;
+  return resident * sysconf(_SC_PAGESIZE);
+}
+
+/////////////////////////////////////////////////
+// Write a binary STL file that holds a wavy grid with _rows * _cols * 2
+// triangles.
+static void writeGridSTL(const std::string &_filename, unsigned int _rows,
+                         unsigned int _cols)
+{
+  FILE *file = fopen(_filename.c_str(), "wb");
+  ASSERT_TRUE(file != NULL);
+
+  char header[80] = {0};
+  fwrite(header, 1, sizeof(header), file);
+
+  uint32_t triCount = _rows * _cols * 2;
+  fwrite(&triCount, sizeof(triCount), 1, file);
+
+  for (unsigned int r = 0; r < _rows; ++r)
+  {
+    for (unsigned int c = 0; c < _cols; ++c)
+    {
+      float x0 = static_cast<float>(c) / _cols;
+      float x1 = static_cast<float>(c + 1) / _cols;
+      float y0 = static_cast<float>(r) / _rows;
+      float y1 = static_cast<float>(r + 1) / _rows;
+
+      float tris[2][12] = {
+        {0, 0, 1, x0, y0, 0.01f * ((r + c) % 2), x1, y0, 0, x1, y1, 0},
+        {0, 0, 1, x0, y0, 0.01f * ((r + c) % 2), x1, y1, 0, x0, y1, 0}};
+
+      uint16_t attribute = 0;
+      for (int i = 0; i < 2; ++i)
+      {
+        fwrite(tris[i], sizeof(float), 12, file);
+        fwrite(&attribute, sizeof(attribute), 1, file);
+      }
+    }
+  }
+
+  fclose(file);
+}
+
+////////////////////////////////////////////////////////////////////////
+// ManyInstances:
+// Spawn 1000 static models that all use the same 50k triangle mesh, and
+// measure the memory used. The triangle data is shared by all the
+// instances, so each additional instance must cost less than one copy of
+// the vertex and index arrays.
+////////////////////////////////////////////////////////////////////////
+void TrimeshMemoryTest::ManyInstances(const std::string &_physicsEngine)
+{
+  std::string meshFilename = "/tmp/gazebo_trimesh_memory_test.stl";
+  writeGridSTL(meshFilename, 125, 200);
+
+  Load("worlds/empty.world", true, _physicsEngine);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  std::string uri = "file://" + meshFilename;
+  uint64_t startMemory = getResidentMemory();
+
+  common::Time startTime = common::Time::GetWallTime();
+  SpawnTrimesh("trimesh_0", uri, math::Vector3(1, 1, 1),
+      math::Vector3(0, 0, 0), math::Vector3(0, 0, 0), true);
+  common::Time firstTime = common::Time::GetWallTime() - startTime;
+  uint64_t firstMemory = getResidentMemory();
+
+  const int instanceCount = 1000;
+  startTime = common::Time::GetWallTime();
+  for (int i = 1; i < instanceCount; ++i)
+  {
+    SpawnTrimesh("trimesh_" + boost::lexical_cast<std::string>(i), uri,
+        math::Vector3(1, 1, 1), math::Vector3((i % 32) * 2, (i / 32) * 2, 0),
+        math::Vector3(0, 0, 0), true);
+  }
+  common::Time restTime = common::Time::GetWallTime() - startTime;
+  uint64_t endMemory = getResidentMemory();
+
+  world->StepWorld(10);
+
+  const common::Mesh *mesh = common::MeshManager::Instance()->GetMesh(
+      common::find_file(uri));
+  ASSERT_TRUE(mesh != NULL);
+  uint64_t arrayBytes = mesh->GetVertexCount() * 3 * sizeof(float) +
+    mesh->GetIndexCount() * sizeof(int);
+
+  if (startMemory == 0)
+  {
+    std::cout << "Unable to measure memory usage\n";
+    return;
+  }
+
+  double perInstance = static_cast<double>(endMemory - firstMemory) /
+    (instanceCount - 1);
+
+  std::cout << "Trimesh[" << _physicsEngine << "] triangles["
+            << mesh->GetIndexCount() / 3 << "] first instance["
+            << (firstMemory - startMemory) / 1024 << " KiB, "
+            << firstTime.Double() << " s] per additional instance["
+            << perInstance / 1024 << " KiB, "
+            << restTime.Double() / (instanceCount - 1) << " s] vertex and "
+            << "index arrays[" << arrayBytes / 1024 << " KiB]\n";
+
+  EXPECT_LT(perInstance, static_cast<double>(arrayBytes));
+}
+
+TEST_F(TrimeshMemoryTest, ManyInstancesODE)
+{
+  ManyInstances("ode");
+}
+
+#ifdef HAVE_BULLET
+TEST_F(TrimeshMemoryTest, ManyInstancesBullet)
+{
+  ManyInstances("bullet");
+}
+#endif  // HAVE_BULLET
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
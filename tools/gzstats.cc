@@ -37,6 +37,16 @@ boost::mutex mutex;
 boost::condition_variable condition;
 
 bool g_plot;
+bool g_phases;
+
+/////////////////////////////////////////////////
+/// \brief Print a step timing in milliseconds
+void printTiming(const msgs::WorldStatistics::Timing &_timing)
+{
+  printf("%-10s p50[%7.3f] p95[%7.3f] p99[%7.3f] max[%7.3f] ms\n",
+      _timing.name().c_str(), _timing.p50() * 1e3, _timing.p95() * 1e3,
+      _timing.p99() * 1e3, _timing.max() * 1e3);
+}
 
 /////////////////////////////////////////////////
 void cb(ConstWorldStatisticsPtr &_msg)
@@ -89,16 +99,43 @@ void cb(ConstWorldStatisticsPtr &_msg)
     if (first)
     {
       printf("# real-time factor (percent), simtime (sec), realtime (sec), "
-             "paused (T or F)\n");
+             "paused (T or F), step p50 (ms), step p99 (ms), "
+             "step max (ms), step overruns\n");
       first = false;
     }
-    printf("%4.2f, %16.6f, %16.6f, %c\n",
-        percent, simTime.Double(), realTime.Double(), paused);
+    printf("%4.2f, %16.6f, %16.6f, %c, %8.4f, %8.4f, %8.4f, %llu\n",
+        percent, simTime.Double(), realTime.Double(), paused,
+        _msg->step_time().p50() * 1e3, _msg->step_time().p99() * 1e3,
+        _msg->step_time().max() * 1e3,
+        static_cast<unsigned long long>(_msg->step_overruns()));
     fflush(stdout);
   }
   else
+  {
     printf("Factor[%4.2f] SimTime[%4.2f] RealTime[%4.2f] Paused[%c]\n",
         percent, simTime.Double(), realTime.Double(), paused);
+
+    if (_msg->has_step_time() && _msg->step_time().count() > 0)
+    {
+      printf("  Steps[%llu] Overruns[%llu] Factor p50[%4.2f] p5[%4.2f]\n",
+          static_cast<unsigned long long>(_msg->step_time().count()),
+          static_cast<unsigned long long>(_msg->step_overruns()),
+          _msg->real_time_factor_p50(), _msg->real_time_factor_p5());
+      printf("  ");
+      printTiming(_msg->step_time());
+      printf("  ");
+      printTiming(_msg->step_period());
+
+      if (g_phases)
+      {
+        for (int i = 0; i < _msg->phase_size(); ++i)
+        {
+          printf("    ");
+          printTiming(_msg->phase(i));
+        }
+      }
+    }
+  }
 }
 
 //////////////////////////////////////////////////
@@ -125,6 +162,7 @@ int main(int argc, char **argv)
     ("help,h", "print help message")
     ("plot,p", "output comma-separated values, useful for processing and "
                "plotting")
+    ("phases", "display the time spent in each phase of the steps")
     ("world-name,w", po::value<std::string>(), "the Gazebo world to monitor");
   po::variables_map vm;
 
@@ -159,6 +197,11 @@ int main(int argc, char **argv)
     g_plot = true;
   }
 
+  if (vm.count("phases"))
+  {
+    g_phases = true;
+  }
+
   transport::init();
 
   transport::NodePtr node(new transport::Node());